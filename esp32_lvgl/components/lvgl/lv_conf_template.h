@@ -94,12 +94,34 @@ typedef int16_t lv_coord_t;
 
 /* Automatically defrag. on free. Defrag. means joining the adjacent free cells. */
 #  define LV_MEM_AUTO_DEFRAG  1
+
+/* 1: Use a TLSF (two level segregated fit) allocator with O(1) allocation and free.
+ * The free cells are joined immediately so `LV_MEM_AUTO_DEFRAG` is not used.
+ * Needs a few hundred bytes of RAM for the lists of the size classes. */
+#  define LV_MEM_TLSF         0
 #else       /*LV_MEM_CUSTOM*/
 #  define LV_MEM_CUSTOM_INCLUDE <stdlib.h>   /*Header for the dynamic memory function*/
 #  define LV_MEM_CUSTOM_ALLOC   malloc       /*Wrapper to malloc*/
 #  define LV_MEM_CUSTOM_FREE    free         /*Wrapper to free*/
 #endif     /*LV_MEM_CUSTOM*/
 
+/* Size of a separate memory for slabs in bytes (0: not used).
+ * The small memories (objects, `ext_attr`s, style lists, texts) are allocated here in fixed size blocks
+ * and the freed blocks are reused by their size class without going through the heap.
+ * The objects and the `ext_attr`s get their own size classes. Not used with `LV_ENABLE_GC`. */
+#define LV_MEM_SLAB_SIZE   0
+
+/* Size of an arena for the temporary buffers of drawing (`_lv_mem_buf_get()`) in bytes (0: not used).
+ * The buffers are bump allocated from here and the arena is reset after every refresh.
+ * If it's full the buffers are allocated from the heap.
+ * `lv_mem_buf_get_max_used()` tells the required size. */
+#define LV_MEM_BUF_ARENA_SIZE   0
+
+/* 1: Tag the allocations of `lv_mem_alloc()` and `lv_mem_realloc()` with the file and line of the call
+ * to find leaks with `lv_mem_trace_get_tags()` and to see the heap with `lv_mem_trace_frag_map()`.
+ * Every allocation needs a few pointers more. Not used with `LV_ENABLE_GC`. */
+#define LV_MEM_TRACE    0
+
 /* Use the standard memcpy and memset instead of LVGL's own functions.
  * The standard functions might or might not be faster depending on their implementation. */
 #define LV_MEMCPY_MEMSET_STD    0
@@ -154,6 +176,11 @@ typedef int16_t lv_coord_t;
 /*Declare the type of the user data of animations (can be e.g. `void *`, `int`, `struct`)*/
 typedef void * lv_anim_user_data_t;
 
+/* Number of finished style transitions kept to be reused by the next transitions.
+ * A transition animates all the changed properties of an object's part.
+ * Costs about 90 bytes RAM per transition. 0: free the transitions when they are ready*/
+#define LV_STYLE_TRANS_POOL_SIZE    16
+
 #endif
 
 /* 1: Enable shadow drawing on rectangles*/
@@ -181,6 +208,17 @@ typedef void * lv_anim_user_data_t;
 /* 1: Use the `opa_scale` style property to set the opacity of an object and its children at once*/
 #define LV_USE_OPA_SCALE        1
 
+/* Number of object parts whose resolved style properties are cached.
+ * The value of a property is looked up in the style lists only once then read from the cache
+ * until the styles or the state of the object change.
+ * Costs about 300 bytes RAM per entry. 0: disable the cache*/
+#define LV_STYLE_CACHE_SIZE     16
+
+/* Convert a style to the indexed storage when it gets this many properties with `lv_style_set_...()`.
+ * The properties of an indexed style are found without searching but it needs about 40 bytes more RAM.
+ * 0: index the styles only with `lv_style_index()` and `lv_style_build()`*/
+#define LV_STYLE_INDEX_PROP_CNT 0
+
 /* 1: Use image zoom and rotation*/
 #define LV_USE_IMG_TRANSFORM    1
 
@@ -237,6 +275,9 @@ typedef void * lv_fs_drv_user_data_t;
 /* 1: Enable alpha indexed images */
 #define LV_IMG_CF_ALPHA         1
 
+/* 1: Enable RLE and LZ4 compressed images (`LV_IMG_CF_RLE`, `LV_IMG_CF_LZ4`) */
+#define LV_IMG_CF_COMPRESSED    1
+
 /* Default image cache size. Image caching keeps the images opened.
  * If only the built-in image formats are used there is no real advantage of caching.
  * (I.e. no new image decoder is added)
@@ -245,6 +286,46 @@ typedef void * lv_fs_drv_user_data_t;
  * Set it to 0 to disable caching */
 #define LV_IMG_CACHE_DEF_SIZE       1
 
+/* Default memory budget of the image cache in bytes.
+ * The decoded images kept open by the cache are counted (e.g. the buffer of a decoded PNG).
+ * If the budget is exceeded the images least worth keeping (cheap to open but large) are closed.
+ * Set it to 0 to limit only the number of cached images */
+#define LV_IMG_CACHE_DEF_MEM_SIZE   0
+
+/* Memory budget in bytes for the rotated/zoomed copies of the cached images.
+ * Images drawn with the same angle, zoom and pivot again and again are transformed only once
+ * and then drawn like not transformed images. Requires `LV_USE_IMG_TRANSFORM 1`.
+ * Set it to 0 to transform the images on every redraw */
+#define LV_IMG_CACHE_VARIANT_MEM_SIZE   0
+
+/* After this many transformed copies created for an image without being used again
+ * the image is considered animated and it's transformed on every redraw again */
+#define LV_IMG_CACHE_VARIANT_MAX_KEYS   8
+
+/* Time budget in ms of one run of the task decoding the images preloaded with `lv_img_cache_preload()`.
+ * Images read line-by-line (e.g. files) are decoded into the cache in more steps to keep the display responsive */
+#define LV_IMG_CACHE_PRELOAD_TIME   5
+
+/* Size of the strips in bytes in which the images not available as a whole (e.g. files) are decoded.
+ * The built-in decoder also reads ahead from image files with a buffer of this size.
+ * Larger strips need less file system calls but more RAM.
+ * Set it to 0 to decode line-by-line without reading ahead */
+#define LV_IMG_DECODER_STRIP_SIZE   1024
+
+/* Compressed true color images not larger than this (in bytes, decompressed) are decompressed
+ * at once when opened so the image cache keeps them ready to draw (see `LV_IMG_CACHE_DEF_SIZE`).
+ * The larger ones are decompressed block-by-block while drawing.
+ * Set it to 0 to always decompress while drawing */
+#define LV_IMG_DECODER_COMPR_CACHE_SIZE 0
+
+/* 1: Enable the PNG decoder. It uses libpng so link the application with it.
+ * Register it with `lv_img_png_init()` */
+#define LV_USE_PNG              0
+
+/* 1: Enable the JPEG decoder. It uses libjpeg (or libjpeg-turbo) so link the application with it.
+ * Register it with `lv_img_jpg_init()` */
+#define LV_USE_JPG              0
+
 /*Declare the type of the user data of image decoder (can be e.g. `void *`, `int`, `struct`)*/
 typedef void * lv_img_decoder_user_data_t;
 
@@ -525,6 +606,10 @@ typedef void * lv_font_user_data_t;
  * `LV_BIDI_DIR_RTL` Right-to-Left
  * `LV_BIDI_DIR_AUTO` detect texts base direction */
 #define LV_BIDI_BASE_DIR_DEF  LV_BIDI_DIR_AUTO
+
+/* Size of the cache (in bytes) keeping the processed (visual order) lines of texts.
+ * Saves running the bidi algorithm on every redraw. 0: to disable caching */
+#define LV_BIDI_CACHE_SIZE    2048
 #endif
 
 /* Enable Arabic/Persian processing
@@ -568,6 +653,12 @@ typedef void * lv_obj_user_data_t;
  */
 #define LV_USE_EXT_CLICK_AREA  LV_EXT_CLICK_AREA_TINY
 
+/* 1: Use a compact object layout to save RAM with many objects.
+ * The children are linked directly in the objects instead of an `lv_ll_t`.
+ * The realign, full extra click area, group and user data of an object are allocated only when set.
+ * (`lv_obj_align()` sets the realign data, `LV_USER_DATA_FREE` should use `lv_obj_get_user_data()`)*/
+#define LV_USE_OBJ_COMPACT      0
+
 /*==================
  *  LV OBJ X USAGE
  *================*/
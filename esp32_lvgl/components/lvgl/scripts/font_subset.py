@@ -0,0 +1,1016 @@
+#!/usr/bin/env python3
+
+'''
+Create subsets of fonts in LVGL's C format (generated by lv_font_conv) which contain only the glyphs
+used by an application.
+
+The characters are collected from the string literals of the given C sources, from the LV_SYMBOL_...
+macros they use and from the extra characters/ranges given in the command line.
+For every font a new C file is written with
+  - only the used glyphs, renumbered by code point,
+  - the cheapest combination of FORMAT0_TINY, FORMAT0_FULL and SPARSE_TINY character maps
+    (FORMAT0_FULL covers a range with holes if its glyph ids fit in 1 byte),
+  - the lowest bpp which keeps every pixel's opacity and the smaller of the plain and compressed bitmaps,
+  - the kerning classes of the used glyphs only.
+
+The result is verified by decoding every used glyph and kerning pair from both fonts.
+
+Example:
+  ./font_subset.py --src ../../../main --symbols "0123456789/:-APM" \\
+                   --font ../src/lv_font/lv_font_montserrat_12.c ../src/lv_font/lv_font_montserrat_20.c \\
+                   --out-dir ../../../main
+'''
+
+import argparse
+from argparse import RawTextHelpFormatter
+import math
+import os
+import re
+import sys
+
+if sys.version_info < (3, 6, 0):
+    print("Python >=3.6 is required", file=sys.stderr)
+    exit(1)
+
+SYMBOL_DEF = os.path.join(os.path.dirname(os.path.abspath(__file__)), "../src/lv_font/lv_symbol_def.h")
+
+# Size of `lv_font_fmt_txt_cmap_t` and `lv_font_fmt_txt_glyph_dsc_t` on 32 bit MCUs
+CMAP_SIZE = 20
+GLYPH_DSC_SIZE = 8
+
+CMAP_FORMAT0_FULL = "LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL"
+CMAP_SPARSE_FULL = "LV_FONT_FMT_TXT_CMAP_SPARSE_FULL"
+CMAP_FORMAT0_TINY = "LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY"
+CMAP_SPARSE_TINY = "LV_FONT_FMT_TXT_CMAP_SPARSE_TINY"
+
+# Calls whose string arguments never reach the display
+SKIP_CALLS = {"printf", "puts", "fprintf", "perror",
+              "ESP_LOGE", "ESP_LOGW", "ESP_LOGI", "ESP_LOGD", "ESP_LOGV",
+              "LV_LOG_ERROR", "LV_LOG_WARN", "LV_LOG_INFO", "LV_LOG_TRACE", "LV_LOG_USER",
+              "lv_fs_open", "lv_font_load", "lv_font_load_paged"}
+
+# Characters a printf conversion can produce
+FMT_CHARS = {
+    "d": "0123456789-", "i": "0123456789-", "u": "0123456789",
+    "f": "0123456789.-", "F": "0123456789.-", "e": "0123456789.-+e", "E": "0123456789.-+E",
+    "g": "0123456789.-+e", "G": "0123456789.-+E",
+    "x": "0123456789abcdef", "X": "0123456789ABCDEF", "o": "01234567",
+    "p": "0123456789abcdefx",
+}
+
+# Opacity of the pixel values as in `_lv_bppX_opa_table`
+OPA_TABLES = {
+    1: [0, 255],
+    2: [0, 85, 170, 255],
+    4: [0, 17, 34, 51, 68, 85, 102, 119, 136, 153, 170, 187, 204, 221, 238, 255],
+    8: list(range(256)),
+}
+
+
+class FontError(Exception):
+    pass
+
+
+# ------------------------------------------------------------------------
+# Collecting the used characters
+# ------------------------------------------------------------------------
+
+def unescape_c_string(body):
+    '''Convert the body of a C string literal to bytes'''
+    out = bytearray()
+    i = 0
+    simple = {"n": 10, "t": 9, "r": 13, "0": 0, "a": 7, "b": 8, "f": 12, "v": 11,
+              "\\": 92, "'": 39, '"': 34, "?": 63}
+    while i < len(body):
+        c = body[i]
+        if c != "\\":
+            out += c.encode("utf-8")
+            i += 1
+            continue
+
+        i += 1
+        c = body[i]
+        if c == "x":
+            m = re.match(r"[0-9a-fA-F]+", body[i + 1:])
+            out.append(int(m.group(0), 16) & 0xFF)
+            i += 1 + len(m.group(0))
+        elif c in "01234567":
+            m = re.match(r"[0-7]{1,3}", body[i:])
+            out.append(int(m.group(0), 8) & 0xFF)
+            i += len(m.group(0))
+        elif c in "uU":
+            n = 4 if c == "u" else 8
+            out += chr(int(body[i + 1:i + 1 + n], 16)).encode("utf-8")
+            i += 1 + n
+        else:
+            out.append(simple.get(c, ord(c)))
+            i += 1
+    return bytes(out)
+
+
+def load_symbols():
+    '''Map the LV_SYMBOL_... names to their text'''
+    symbols = {}
+    with open(SYMBOL_DEF, encoding="utf-8") as f:
+        for line in f:
+            m = re.match(r'\s*#define\s+(LV_SYMBOL_\w+)\s+"((?:[^"\\]|\\.)*)"', line)
+            if m:
+                symbols[m.group(1)] = unescape_c_string(m.group(2)).decode("utf-8")
+    return symbols
+
+
+def expand_format(text):
+    '''Return the literal text of a printf format and the characters its conversions can produce'''
+    literal = []
+    extra = set()
+    unknown = []
+    i = 0
+    while i < len(text):
+        if text[i] != "%":
+            literal.append(text[i])
+            i += 1
+            continue
+        m = re.match(r"%([-+ #0]*)(\*|\d+)?(\.(\*|\d+))?(hh|h|ll|l|L|z|j|t)?([diouxXfFeEgGcspn%])", text[i:])
+        if not m:
+            literal.append(text[i])
+            i += 1
+            continue
+        conv = m.group(6)
+        if conv == "%":
+            literal.append("%")
+        elif conv in FMT_CHARS:
+            extra.update(FMT_CHARS[conv])
+            if "+" in m.group(1):
+                extra.add("+")
+            if " " in m.group(1) or (m.group(2) and m.group(2) != "*"):
+                extra.add(" ")
+        elif conv in "sc":
+            unknown.append(m.group(0))
+        i += len(m.group(0))
+    return "".join(literal), extra, unknown
+
+
+def scan_source(path, symbols, chars, warnings):
+    '''Add the characters of the displayed string literals of a C source to `chars`'''
+    with open(path, encoding="utf-8", errors="replace") as f:
+        src = f.read()
+
+    token_re = re.compile(r'''
+        (?P<comment>//[^\n]*|/\*.*?\*/) |
+        (?P<include>\#\s*include[^\n]*) |
+        (?P<string>(?:L|u8|u|U)?"(?:[^"\\\n]|\\.)*") |
+        (?P<char>'(?:[^'\\\n]|\\.)+') |
+        (?P<ident>[A-Za-z_]\w*) |
+        (?P<open>\() |
+        (?P<close>\)) |
+        (?P<other>.)
+    ''', re.S | re.X)
+
+    calls = []              # Stack of the function names of the open parentheses
+    last_ident = None
+    pending = []            # Adjacent string literals are concatenated by the compiler
+    pending_call = None
+
+    def flush():
+        nonlocal pending
+        if not pending:
+            return
+        text = b"".join(pending).decode("utf-8", errors="replace")
+        pending = []
+        call = pending_call or ""
+        if call in SKIP_CALLS:
+            return
+        if "printf" in call or call.endswith("_fmt"):
+            text, extra, unknown = expand_format(text)
+            chars.update(extra)
+            for u in unknown:
+                warnings.append("{}: the characters of '{}' in {}(\"...\") are not known".format(path, u, call))
+        chars.update(text)
+
+    for m in token_re.finditer(src):
+        kind = m.lastgroup
+        if kind == "string":
+            if not pending:
+                pending_call = calls[-1] if calls else None
+            body = m.group(0)
+            body = body[body.index('"') + 1:-1]
+            pending.append(unescape_c_string(body))
+            continue
+        if kind == "ident" and m.group(0) in symbols:
+            if not pending:
+                pending_call = calls[-1] if calls else None
+            pending.append(symbols[m.group(0)].encode("utf-8"))
+            continue
+        if kind in ("comment", "include") or (kind == "other" and m.group(0).isspace()):
+            continue
+
+        flush()
+        if kind == "ident":
+            last_ident = m.group(0)
+            continue
+        if kind == "open":
+            calls.append(last_ident)
+        elif kind == "close" and calls:
+            calls.pop()
+        last_ident = None
+    flush()
+
+
+def parse_ranges(ranges):
+    '''Parse "0x20-0x7F,0xB0,176" like lists'''
+    cps = set()
+    for r in ranges:
+        for part in r.split(","):
+            part = part.strip()
+            if not part:
+                continue
+            if "-" in part[1:]:
+                idx = part.index("-", 1)
+                start, end = int(part[:idx], 0), int(part[idx + 1:], 0)
+                cps.update(range(start, end + 1))
+            else:
+                cps.add(int(part, 0))
+    return cps
+
+
+def collect_code_points(args):
+    symbols = load_symbols()
+    chars = set()
+    warnings = []
+
+    for src in args.src:
+        if os.path.isdir(src):
+            for root, _, files in os.walk(src):
+                for fn in sorted(files):
+                    if fn.endswith((".c", ".h", ".cpp")):
+                        scan_source(os.path.join(root, fn), symbols, chars, warnings)
+        else:
+            scan_source(src, symbols, chars, warnings)
+
+    for fn in args.strings:
+        with open(fn, encoding="utf-8") as f:
+            chars.update(f.read())
+
+    chars.update("".join(args.symbols))
+
+    cps = set(ord(c) for c in chars)
+    cps |= parse_ranges(args.range)
+    if 9 in cps:
+        cps.add(0x20)           # Tabs are drawn with the space glyph
+    cps = set(c for c in cps if c >= 0x20)
+
+    return sorted(cps), warnings
+
+
+# ------------------------------------------------------------------------
+# Reading fonts
+# ------------------------------------------------------------------------
+
+def parse_int_array(src, name):
+    m = re.search(r"\b" + re.escape(name) + r"\[\]\s*=\s*\{(.*?)\};", src, re.S)
+    if not m:
+        return None
+    body = re.sub(r"/\*.*?\*/", "", m.group(1), flags=re.S)
+    return [int(v, 0) for v in re.findall(r"-?(?:0x[0-9a-fA-F]+|\d+)", body)]
+
+
+def parse_field(src, name, default=None):
+    m = re.search(r"\." + re.escape(name) + r"\s*=\s*([^,\n}]+)", src)
+    if not m:
+        if default is None:
+            raise FontError("'.{}' not found".format(name))
+        return default
+    v = m.group(1).strip()
+    try:
+        return int(v, 0)
+    except ValueError:
+        return v
+
+
+class Font:
+    def __init__(self):
+        self.name = ""
+        self.guard = ""
+        self.size_comment = ""
+        self.bpp = 4
+        self.compressed = False
+        self.prefilter = False
+        self.line_height = 0
+        self.base_line = 0
+        self.subpx = "LV_FONT_SUBPX_NONE"
+        self.underline_position = 0
+        self.underline_thickness = 0
+        self.kern_scale = 0
+        # code point -> dict(adv_w, box_w, box_h, ofs_x, ofs_y, pixels)
+        self.glyphs = {}
+        # Kerning classes per code point and the class values
+        self.kern_left = {}
+        self.kern_right = {}
+        self.kern_values = []
+        self.kern_right_cnt = 0
+        # Tables as stored in the C file (for the flash and lookup statistics)
+        self.cmaps = []
+        self.bitmap_size = 0
+        self.glyph_cnt = 0
+        self.kern_size = 0
+
+    def pixels(self, cp):
+        return self.glyphs[cp]["pixels"]
+
+    def kern(self, left, right):
+        lc = self.kern_left.get(left, 0)
+        rc = self.kern_right.get(right, 0)
+        if lc == 0 or rc == 0:
+            return 0
+        return self.kern_values[(lc - 1) * self.kern_right_cnt + (rc - 1)]
+
+    def opa(self, cp):
+        table = OPA_TABLES[self.bpp]
+        return [table[p] for p in self.pixels(cp)]
+
+    def flash_size(self):
+        size = self.bitmap_size + self.glyph_cnt * GLYPH_DSC_SIZE + self.kern_size
+        for c in self.cmaps:
+            size += CMAP_SIZE + 2 * len(c["unicode_list"] or []) + \
+                    (len(c["glyph_id_ofs_list"] or []) * (1 if c["type"] == CMAP_FORMAT0_FULL else 2))
+        return size
+
+    def lookup_steps(self, cp):
+        '''Number of comparisons `get_glyph_dsc_id()` needs to find a code point'''
+        steps = 0
+        for c in self.cmaps:
+            steps += 1
+            rcp = cp - c["range_start"]
+            if rcp < 0 or rcp > c["range_length"]:
+                continue
+            if c["type"] in (CMAP_SPARSE_TINY, CMAP_SPARSE_FULL):
+                steps += int(math.log2(c["list_length"])) + 1
+            return steps
+        return steps
+
+
+def read_bits(data, bit_pos, n):
+    v = 0
+    for _ in range(n):
+        v = (v << 1) | ((data[bit_pos >> 3] >> (7 - (bit_pos & 7))) & 1)
+        bit_pos += 1
+    return v
+
+
+def decompress(data, w, h, bpp, prefilter):
+    '''Port of `decompress()` of lv_font_fmt_txt.c'''
+    pos = 0
+    state = "single"
+    prev = 0
+    cnt = 0
+
+    def rd(n):
+        nonlocal pos
+        # Compressed streams can be read a few bits past their end
+        v = read_bits(data + b"\0\0", pos, n)
+        pos += n
+        return v
+
+    out = []
+    line_prev = None
+    for _ in range(h):
+        line = []
+        for _ in range(w):
+            if state == "single":
+                ret = rd(bpp)
+                if pos != bpp and prev == ret:
+                    cnt = 0
+                    state = "repeat"
+                prev = ret
+            elif state == "repeat":
+                v = rd(1)
+                cnt += 1
+                if v == 1:
+                    ret = prev
+                    if cnt == 11:
+                        cnt = rd(6)
+                        if cnt != 0:
+                            state = "counter"
+                        else:
+                            ret = rd(bpp)
+                            prev = ret
+                            state = "single"
+                else:
+                    ret = rd(bpp)
+                    prev = ret
+                    state = "single"
+            else:
+                ret = prev
+                cnt -= 1
+                if cnt == 0:
+                    ret = rd(bpp)
+                    prev = ret
+                    state = "single"
+            line.append(ret)
+        if prefilter and line_prev is not None:
+            line = [a ^ b for a, b in zip(line, line_prev)]
+        line_prev = line
+        out += line
+    return out
+
+
+def read_font(path):
+    with open(path, encoding="utf-8") as f:
+        src = f.read()
+
+    font = Font()
+    m = re.search(r"lv_font_t\s+(\w+)\s*=\s*\{", src)
+    if not m:
+        raise FontError("no `lv_font_t` found")
+    font.name = m.group(1)
+    m = re.search(r"#ifndef\s+(\w+)\s*\n#define\s+\1\s+1", src)
+    font.guard = m.group(1) if m else font.name.upper()
+    m = re.search(r"\* Size: (\d+) px", src)
+    font.size_comment = m.group(1) if m else "?"
+
+    font_dsc = src[src.index("font_dsc = {"):]
+    font.bpp = parse_field(font_dsc, "bpp")
+    font.kern_scale = parse_field(font_dsc, "kern_scale")
+    bitmap_format = parse_field(font_dsc, "bitmap_format")
+    kern_classes = parse_field(font_dsc, "kern_classes")
+    font.compressed = bitmap_format != 0
+    # `lv_font_get_bitmap_fmt_txt()` always applies the prefilter on compressed fonts
+    font.prefilter = font.compressed
+    if font.bpp not in (1, 2, 4, 8):
+        raise FontError("{} bpp fonts are not supported".format(font.bpp))
+
+    pub = src[src.index(font.name + " = {"):]
+    font.line_height = parse_field(pub, "line_height")
+    font.base_line = parse_field(pub, "base_line")
+    font.subpx = parse_field(pub, "subpx", "LV_FONT_SUBPX_NONE")
+    font.underline_position = parse_field(pub, "underline_position", 0)
+    font.underline_thickness = parse_field(pub, "underline_thickness", 0)
+
+    bitmap = bytes(parse_int_array(src, "gylph_bitmap") or parse_int_array(src, "glyph_bitmap"))
+    font.bitmap_size = len(bitmap)
+
+    gdsc_re = re.compile(r"\{\.bitmap_index = (\d+), \.adv_w = (\d+), \.box_w = (\d+), \.box_h = (\d+), "
+                         r"\.ofs_x = (-?\d+), \.ofs_y = (-?\d+)\}")
+    gdsc = [tuple(int(v) for v in g) for g in gdsc_re.findall(src)]
+    font.glyph_cnt = len(gdsc)
+
+    cmap_re = re.compile(r"\.range_start = (\d+), \.range_length = (\d+), \.glyph_id_start = (\d+),\s*"
+                         r"\.unicode_list = (\w+), \.glyph_id_ofs_list = (\w+), \.list_length = (\d+), \.type = (\w+)")
+    gid_of_cp = {}
+    for c in cmap_re.findall(src):
+        cmap = {
+            "range_start": int(c[0]), "range_length": int(c[1]), "glyph_id_start": int(c[2]),
+            "unicode_list": None if c[3] == "NULL" else parse_int_array(src, c[3]),
+            "glyph_id_ofs_list": None if c[4] == "NULL" else parse_int_array(src, c[4]),
+            "list_length": int(c[5]), "type": c[6],
+        }
+        font.cmaps.append(cmap)
+        start = cmap["range_start"]
+        if cmap["type"] == CMAP_FORMAT0_TINY:
+            for i in range(cmap["range_length"]):
+                gid_of_cp[start + i] = cmap["glyph_id_start"] + i
+        elif cmap["type"] == CMAP_FORMAT0_FULL:
+            for i in range(cmap["range_length"]):
+                gid = cmap["glyph_id_start"] + cmap["glyph_id_ofs_list"][i]
+                if gid:
+                    gid_of_cp[start + i] = gid
+        elif cmap["type"] == CMAP_SPARSE_TINY:
+            for i, u in enumerate(cmap["unicode_list"]):
+                gid_of_cp[start + u] = cmap["glyph_id_start"] + i
+        else:
+            for i, u in enumerate(cmap["unicode_list"]):
+                gid_of_cp[start + u] = cmap["glyph_id_start"] + cmap["glyph_id_ofs_list"][i]
+
+    if kern_classes == 1:
+        left = parse_int_array(src, "kern_left_class_mapping")
+        right = parse_int_array(src, "kern_right_class_mapping")
+        font.kern_values = parse_int_array(src, "kern_class_values")
+        font.kern_right_cnt = parse_field(src[src.index("kern_classes ="):], "right_class_cnt")
+        font.kern_size = len(left) + len(right) + len(font.kern_values)
+    elif "kern_pair_glyph_ids" in src:
+        raise FontError("kerning pairs are not supported, use `lv_font_conv --force-fast-kern-format`")
+
+    for cp, gid in gid_of_cp.items():
+        idx, adv_w, box_w, box_h, ofs_x, ofs_y = gdsc[gid]
+        px_cnt = box_w * box_h
+        if px_cnt == 0:
+            pixels = []
+        elif font.compressed:
+            end = gdsc[gid + 1][0] if gid + 1 < len(gdsc) else len(bitmap)
+            pixels = decompress(bitmap[idx:end], box_w, box_h, font.bpp, font.prefilter)
+        else:
+            pixels = [read_bits(bitmap, idx * 8 + i * font.bpp, font.bpp) for i in range(px_cnt)]
+        font.glyphs[cp] = {"adv_w": adv_w, "box_w": box_w, "box_h": box_h,
+                           "ofs_x": ofs_x, "ofs_y": ofs_y, "pixels": pixels}
+        if kern_classes == 1:
+            font.kern_left[cp] = left[gid]
+            font.kern_right[cp] = right[gid]
+
+    return font
+
+
+# ------------------------------------------------------------------------
+# Creating the subset
+# ------------------------------------------------------------------------
+
+def write_bits(out, bit_pos, v, n):
+    for i in range(n):
+        if (v >> (n - 1 - i)) & 1:
+            out[(bit_pos + i) >> 3] |= 0x80 >> ((bit_pos + i) & 7)
+
+
+def pack_plain(pixels, bpp):
+    out = bytearray((len(pixels) * bpp + 7) // 8)
+    for i, p in enumerate(pixels):
+        write_bits(out, i * bpp, p, bpp)
+    return bytes(out)
+
+
+def compress(pixels, w, bpp, prefilter):
+    '''The inverse of `decompress()`: RLE with optional XOR of the lines'''
+    if prefilter:
+        src = pixels[:w] + [pixels[i] ^ pixels[i - w] for i in range(w, len(pixels))]
+    else:
+        src = pixels
+
+    bits = []
+
+    def emit(v, n):
+        bits.append((v, n))
+
+    n = len(src)
+    i = 0
+    prev = None
+    while i < n:
+        # Single state
+        emit(src[i], bpp)
+        repeat = prev is not None and src[i] == prev
+        prev = src[i]
+        i += 1
+        if not repeat:
+            continue
+
+        # Repeat state
+        cnt = 0
+        while i < n:
+            cnt += 1
+            if src[i] != prev:
+                emit(0, 1)
+                emit(src[i], bpp)
+                prev = src[i]
+                i += 1
+                break
+
+            emit(1, 1)
+            if cnt < 11:
+                i += 1
+                continue
+
+            # Counter state: `c - 1` more repeated pixels, then a new value
+            r = 0
+            while i + 1 + r < n and src[i + 1 + r] == prev and r < 62:
+                r += 1
+            c = r + 1
+            emit(c, 6)
+            i += c
+            if i < n:
+                emit(src[i], bpp)
+                prev = src[i]
+                i += 1
+            break
+
+    total = sum(b[1] for b in bits)
+    out = bytearray((total + 7) // 8)
+    pos = 0
+    for v, nb in bits:
+        write_bits(out, pos, v, nb)
+        pos += nb
+    return bytes(out)
+
+
+def best_bpp(font, cps):
+    '''The lowest bpp which gives the same opacity for every pixel of the used glyphs'''
+    src_table = OPA_TABLES[font.bpp]
+    used_opa = set()
+    for cp in cps:
+        used_opa.update(src_table[p] for p in font.pixels(cp))
+    for bpp in (1, 2, 4, 8):
+        if bpp > font.bpp:
+            break
+        if used_opa <= set(OPA_TABLES[bpp]):
+            return bpp
+    return font.bpp
+
+
+def plan_cmaps(cps, lookup_weight, start_gid=1):
+    '''
+    Split the sorted code points to character maps.
+    The cost of a map is its size in bytes plus `lookup_weight` bytes for every comparison needed to find its glyphs.
+      - FORMAT0_TINY: contiguous code points, 1 comparison
+      - FORMAT0_FULL: code points with holes, 1 comparison, glyph ids up to 255 and 1 byte per code point
+      - SPARSE_TINY: any code points, 2 bytes and 1 + log2(n) comparisons per glyph
+    Adjacent code points are never split because `get_glyph_dsc_id()` matches
+    `range_start + range_length` too.
+    '''
+    n = len(cps)
+    inf = float("inf")
+    best = [inf] * (n + 1)
+    choice = [None] * (n + 1)
+    best[0] = 0
+    for j in range(1, n + 1):
+        if j < n and cps[j] == cps[j - 1] + 1:
+            continue
+        # Segment cps[i:j]
+        for i in range(j - 1, -1, -1):
+            span = cps[j - 1] - cps[i] + 1
+            if span > 0xFFFF:
+                break
+            if i > 0 and cps[i] == cps[i - 1] + 1:
+                continue
+            cnt = j - i
+            options = []
+            if span == cnt:
+                options.append((CMAP_SIZE + lookup_weight * cnt, CMAP_FORMAT0_TINY))
+            else:
+                if start_gid + j - 1 <= 255:
+                    # +1 byte as `range_start + range_length` is looked up too
+                    options.append((CMAP_SIZE + span + 1 + lookup_weight * cnt, CMAP_FORMAT0_FULL))
+                steps = 1 + int(math.log2(cnt)) + 1
+                options.append((CMAP_SIZE + 2 * cnt + lookup_weight * steps * cnt, CMAP_SPARSE_TINY))
+            cost, cmap_type = min(options)
+            # Every further map is one more comparison for the glyphs of the maps after it
+            cost += lookup_weight * 0.5 * n
+            if best[i] + cost < best[j]:
+                best[j] = best[i] + cost
+                choice[j] = (i, cmap_type)
+
+    segs = []
+    j = n
+    while j > 0:
+        i, cmap_type = choice[j]
+        segs.append((i, j, cmap_type))
+        j = i
+
+    cmaps = []
+    for i, j, cmap_type in segs:
+        start = cps[i]
+        cmap = {
+            "range_start": start, "range_length": cps[j - 1] - start + 1, "glyph_id_start": start_gid + i,
+            "unicode_list": None, "glyph_id_ofs_list": None, "list_length": 0, "type": cmap_type,
+        }
+        if cmap_type == CMAP_FORMAT0_FULL:
+            # The glyph ids are stored directly to map the holes to the reserved glyph 0
+            ofs = [0] * (cmap["range_length"] + 1)
+            for k in range(i, j):
+                ofs[cps[k] - start] = start_gid + k
+            cmap["glyph_id_start"] = 0
+            cmap["glyph_id_ofs_list"] = ofs
+            cmap["list_length"] = len(ofs)
+        elif cmap_type == CMAP_SPARSE_TINY:
+            cmap["unicode_list"] = [c - start for c in cps[i:j]]
+            cmap["list_length"] = j - i
+        cmaps.append(cmap)
+
+    # The maps are searched linearly so put the largest ones first
+    cmaps.sort(key=lambda c: -(c["list_length"] if c["type"] == CMAP_SPARSE_TINY else c["range_length"]))
+    return cmaps
+
+
+def make_subset(font, cps, name, compression, lookup_weight):
+    sub = Font()
+    sub.name = name
+    sub.guard = name.upper()
+    sub.size_comment = font.size_comment
+    sub.line_height = font.line_height
+    sub.base_line = font.base_line
+    sub.subpx = font.subpx
+    sub.underline_position = font.underline_position
+    sub.underline_thickness = font.underline_thickness
+    sub.kern_scale = font.kern_scale
+
+    sub.bpp = best_bpp(font, cps)
+    src_table = OPA_TABLES[font.bpp]
+    to_sub = {opa: i for i, opa in enumerate(OPA_TABLES[sub.bpp])}
+    for cp in cps:
+        g = dict(font.glyphs[cp])
+        g["pixels"] = [to_sub[src_table[p]] for p in g["pixels"]]
+        sub.glyphs[cp] = g
+
+    plain = [pack_plain(sub.pixels(cp), sub.bpp) for cp in cps]
+    # The decompressor handles up to 4 bpp
+    if compression == "off" or sub.bpp > 4:
+        sub.compressed = False
+    else:
+        compr = [compress(sub.pixels(cp), sub.glyphs[cp]["box_w"], sub.bpp, True) if sub.pixels(cp) else b""
+                 for cp in cps]
+        plain_size = sum(len(b) for b in plain)
+        compr_size = sum(len(b) for b in compr)
+        # Decompression costs time on every draw so require a considerable gain
+        sub.compressed = compression == "on" or compr_size < plain_size * 0.75
+    sub.prefilter = sub.compressed
+    sub.bitmaps = compr if sub.compressed else plain
+    sub.bitmap_size = sum(len(b) for b in sub.bitmaps)
+    sub.glyph_cnt = len(cps) + 1
+
+    sub.cmaps = plan_cmaps(cps, lookup_weight)
+
+    # Keep only the kerning classes of the used glyphs
+    left_used = sorted(set(font.kern_left.get(cp, 0) for cp in cps) - {0})
+    right_used = sorted(set(font.kern_right.get(cp, 0) for cp in cps) - {0})
+    values = [font.kern_values[(lc - 1) * font.kern_right_cnt + (rc - 1)] for lc in left_used for rc in right_used]
+    if any(values):
+        lmap = {c: i + 1 for i, c in enumerate(left_used)}
+        rmap = {c: i + 1 for i, c in enumerate(right_used)}
+        for cp in cps:
+            sub.kern_left[cp] = lmap.get(font.kern_left.get(cp, 0), 0)
+            sub.kern_right[cp] = rmap.get(font.kern_right.get(cp, 0), 0)
+        sub.kern_values = values
+        sub.kern_left_cnt = len(left_used)
+        sub.kern_right_cnt = len(right_used)
+        sub.kern_size = 2 * (len(cps) + 1) + len(values)
+    else:
+        sub.kern_left_cnt = 0
+        sub.kern_right_cnt = 0
+        sub.kern_scale = 0
+
+    return sub
+
+
+def c_char_comment(cp):
+    c = chr(cp)
+    if c == '"':
+        return '"\\""'
+    if c == "\\":
+        return '"\\\\"'
+    if c == "/" or cp >= 0xE000:
+        return '""' if cp >= 0xE000 else '"/"'
+    return '"{}"'.format(c)
+
+
+def c_array(values, indent="    ", per_line=8):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append(indent + ", ".join(str(v) for v in values[i:i + per_line]))
+    return ",\n".join(lines)
+
+
+def write_font(sub, cps, path, source_name, args_info):
+    out = []
+    w = out.append
+    w("/*******************************************************************************")
+    w(" * Size: {} px".format(sub.size_comment))
+    w(" * Bpp: {}".format(sub.bpp))
+    w(" * Subset of {} generated by font_subset.py with {} glyphs".format(source_name, len(cps)))
+    w(" * {}".format(args_info))
+    w(" ******************************************************************************/")
+    w("")
+    w("#ifdef LV_LVGL_H_INCLUDE_SIMPLE")
+    w('#include "lvgl.h"')
+    w("#else")
+    w('#include "lvgl/lvgl.h"')
+    w("#endif")
+    w("")
+    w("#ifndef {}".format(sub.guard))
+    w("#define {} 1".format(sub.guard))
+    w("#endif")
+    w("")
+    w("#if {}".format(sub.guard))
+    w("")
+    w("/*-----------------")
+    w(" *    BITMAPS")
+    w(" *----------------*/")
+    w("")
+    w("/*Store the image of the glyphs*/")
+    w("static LV_ATTRIBUTE_LARGE_CONST const uint8_t gylph_bitmap[] = {")
+    for cp, bmp in zip(cps, sub.bitmaps):
+        w("    /* U+{:X} {} */".format(cp, c_char_comment(cp)))
+        if bmp:
+            w(c_array(["0x{:x}".format(b) for b in bmp]) + ",")
+        w("")
+    w("};")
+    w("")
+    w("")
+    w("/*---------------------")
+    w(" *  GLYPH DESCRIPTION")
+    w(" *--------------------*/")
+    w("")
+    w("static const lv_font_fmt_txt_glyph_dsc_t glyph_dsc[] = {")
+    lines = ["    {.bitmap_index = 0, .adv_w = 0, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0} /* id = 0 reserved */"]
+    idx = 0
+    for cp, bmp in zip(cps, sub.bitmaps):
+        g = sub.glyphs[cp]
+        lines.append("    {{.bitmap_index = {}, .adv_w = {}, .box_w = {}, .box_h = {}, .ofs_x = {}, .ofs_y = {}}}".format(
+            idx, g["adv_w"], g["box_w"], g["box_h"], g["ofs_x"], g["ofs_y"]))
+        idx += len(bmp)
+    w(",\n".join(lines))
+    w("};")
+    w("")
+    w("/*---------------------")
+    w(" *  CHARACTER MAPPING")
+    w(" *--------------------*/")
+    w("")
+    for i, c in enumerate(sub.cmaps):
+        if c["unicode_list"]:
+            c["unicode_list_name"] = "unicode_list_{}".format(i)
+            w("static const uint16_t {}[] = {{".format(c["unicode_list_name"]))
+            w(c_array(["0x{:x}".format(u) for u in c["unicode_list"]]))
+            w("};")
+            w("")
+        if c["glyph_id_ofs_list"]:
+            c["glyph_id_ofs_list_name"] = "glyph_id_ofs_list_{}".format(i)
+            w("static const uint8_t {}[] = {{".format(c["glyph_id_ofs_list_name"]))
+            w(c_array(c["glyph_id_ofs_list"], per_line=16))
+            w("};")
+            w("")
+    w("/*Collect the unicode lists and glyph_id offsets*/")
+    w("static const lv_font_fmt_txt_cmap_t cmaps[] =")
+    w("{")
+    entries = []
+    for c in sub.cmaps:
+        entries.append("    {{\n        .range_start = {}, .range_length = {}, .glyph_id_start = {},\n"
+                       "        .unicode_list = {}, .glyph_id_ofs_list = {}, .list_length = {}, .type = {}\n    }}".format(
+                           c["range_start"], c["range_length"], c["glyph_id_start"],
+                           c.get("unicode_list_name", "NULL"), c.get("glyph_id_ofs_list_name", "NULL"),
+                           c["list_length"], c["type"]))
+    w(",\n".join(entries))
+    w("};")
+    w("")
+    if sub.kern_values:
+        w("/*-----------------")
+        w(" *    KERNING")
+        w(" *----------------*/")
+        w("")
+        w("")
+        w("/*Map glyph_ids to kern left classes*/")
+        w("static const uint8_t kern_left_class_mapping[] =")
+        w("{")
+        w(c_array([0] + [sub.kern_left[cp] for cp in cps]))
+        w("};")
+        w("")
+        w("/*Map glyph_ids to kern right classes*/")
+        w("static const uint8_t kern_right_class_mapping[] =")
+        w("{")
+        w(c_array([0] + [sub.kern_right[cp] for cp in cps]))
+        w("};")
+        w("")
+        w("/*Kern values between classes*/")
+        w("static const int8_t kern_class_values[] =")
+        w("{")
+        w(c_array(sub.kern_values))
+        w("};")
+        w("")
+        w("")
+        w("/*Collect the kern class' data in one place*/")
+        w("static const lv_font_fmt_txt_kern_classes_t kern_classes =")
+        w("{")
+        w("    .class_pair_values   = kern_class_values,")
+        w("    .left_class_mapping  = kern_left_class_mapping,")
+        w("    .right_class_mapping = kern_right_class_mapping,")
+        w("    .left_class_cnt      = {},".format(sub.kern_left_cnt))
+        w("    .right_class_cnt     = {},".format(sub.kern_right_cnt))
+        w("};")
+        w("")
+    w("/*--------------------")
+    w(" *  ALL CUSTOM DATA")
+    w(" *--------------------*/")
+    w("")
+    w("/*Store all the custom data of the font*/")
+    w("static lv_font_fmt_txt_dsc_t font_dsc = {")
+    w("    .glyph_bitmap = gylph_bitmap,")
+    w("    .glyph_dsc = glyph_dsc,")
+    w("    .cmaps = cmaps,")
+    w("    .kern_dsc = {},".format("&kern_classes" if sub.kern_values else "NULL"))
+    w("    .kern_scale = {},".format(sub.kern_scale))
+    w("    .cmap_num = {},".format(len(sub.cmaps)))
+    w("    .bpp = {},".format(sub.bpp))
+    w("    .kern_classes = {},".format(1 if sub.kern_values else 0))
+    w("    .bitmap_format = {}".format(1 if sub.compressed else 0))
+    w("};")
+    w("")
+    w("")
+    w("/*-----------------")
+    w(" *  PUBLIC FONT")
+    w(" *----------------*/")
+    w("")
+    w("/*Initialize a public general font descriptor*/")
+    w("lv_font_t {} = {{".format(sub.name))
+    w("    .get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt,    /*Function pointer to get glyph's data*/")
+    w("    .get_glyph_bitmap = lv_font_get_bitmap_fmt_txt,    /*Function pointer to get glyph's bitmap*/")
+    w("    .line_height = {},          /*The maximum line height required by the font*/".format(sub.line_height))
+    w("    .base_line = {},             /*Baseline measured from the bottom of the line*/".format(sub.base_line))
+    w("#if !(LVGL_VERSION_MAJOR == 6 && LVGL_VERSION_MINOR == 0)")
+    w("    .subpx = {},".format(sub.subpx))
+    w("#endif")
+    w("#if LV_VERSION_CHECK(7, 4, 0)")
+    w("    .underline_position = {},".format(sub.underline_position))
+    w("    .underline_thickness = {},".format(sub.underline_thickness))
+    w("#endif")
+    w("    .dsc = &font_dsc           /*The custom font data. Will be accessed by `get_glyph_bitmap/dsc` */")
+    w("};")
+    w("")
+    w("")
+    w("")
+    w("#endif /*#if {}*/".format(sub.guard))
+    w("")
+
+    with open(path, "w", encoding="utf-8") as f:
+        f.write("\n".join(out))
+
+
+def verify(font, sub_path, cps):
+    '''Read back the written subset and compare every used glyph and kerning pair with the original font'''
+    sub = read_font(sub_path)
+    for cp in cps:
+        if cp not in sub.glyphs:
+            raise FontError("U+{:X} is missing from the subset".format(cp))
+        a = font.glyphs[cp]
+        b = sub.glyphs[cp]
+        for k in ("adv_w", "box_w", "box_h", "ofs_x", "ofs_y"):
+            if a[k] != b[k]:
+                raise FontError("U+{:X} has different {}".format(cp, k))
+        if font.opa(cp) != sub.opa(cp):
+            raise FontError("U+{:X} renders differently".format(cp))
+    pairs = 0
+    for l in cps:
+        for r in cps:
+            if font.kern(l, r) * font.kern_scale != sub.kern(l, r) * sub.kern_scale:
+                raise FontError("kerning of U+{:X} U+{:X} differs".format(l, r))
+            pairs += 1
+    return sub, pairs
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=RawTextHelpFormatter)
+    parser.add_argument("--font", nargs="+", required=True, metavar="file",
+                        help="C files of the fonts to subset (generated by lv_font_conv)")
+    parser.add_argument("--src", nargs="*", default=[], metavar="path",
+                        help="C sources or directories to scan for string literals")
+    parser.add_argument("--strings", nargs="*", default=[], metavar="file",
+                        help="UTF-8 text files with further strings (e.g. translations)")
+    parser.add_argument("--symbols", nargs="*", default=[], metavar="chars",
+                        help="Further characters to include, e.g. the characters of runtime texts")
+    parser.add_argument("-r", "--range", nargs="*", default=[], metavar="start-end",
+                        help="Further code points to include. E.g. -r 0x20-0x7F,0xB0")
+    parser.add_argument("--out-dir", default=".", metavar="dir", help="Directory of the created C files")
+    parser.add_argument("--suffix", default="_subset", help="Added to the name of the fonts. Default: _subset")
+    parser.add_argument("--lookup-weight", type=float, default=4, metavar="bytes",
+                        help="Bytes of flash worth one less comparison per glyph when looking up characters. Default: 4")
+    parser.add_argument("--compression", choices=["auto", "on", "off"], default="auto",
+                        help="auto: compress the bitmaps if it saves at least 25%% of their size")
+    args = parser.parse_args()
+
+    cps, warnings = collect_code_points(args)
+    for wrn in warnings:
+        print("Warning: " + wrn, file=sys.stderr)
+    if not cps:
+        print("No characters found", file=sys.stderr)
+        exit(1)
+
+    for font_path in args.font:
+        try:
+            font = read_font(font_path)
+        except (FontError, ValueError) as e:
+            print("Error reading {}: {}".format(font_path, e), file=sys.stderr)
+            exit(1)
+
+        used = [cp for cp in cps if cp in font.glyphs]
+        missing = [cp for cp in cps if cp not in font.glyphs]
+        if missing:
+            print("Warning: {} has no glyph for {}".format(
+                font.name, ", ".join("U+{:X}".format(cp) for cp in missing)), file=sys.stderr)
+
+        name = font.name + args.suffix
+        out_path = os.path.join(args.out_dir, name + ".c")
+        sub = make_subset(font, used, name, args.compression, args.lookup_weight)
+        write_font(sub, used, out_path, os.path.basename(font_path),
+                   "Characters: " + "".join(chr(cp) if cp < 0xE000 else "" for cp in used).replace("*/", "* /"))
+
+        try:
+            sub, pairs = verify(font, out_path, used)
+        except FontError as e:
+            print("Error: verification of {} failed: {}".format(out_path, e), file=sys.stderr)
+            exit(1)
+
+        flash_old = font.flash_size()
+        flash_new = sub.flash_size()
+        steps_old = sum(font.lookup_steps(cp) for cp in used) / max(len(used), 1)
+        steps_new = sum(sub.lookup_steps(cp) for cp in used) / max(len(used), 1)
+        types = {}
+        for c in sub.cmaps:
+            types[c["type"]] = types.get(c["type"], 0) + 1
+
+        print("{} -> {}".format(font.name, out_path))
+        print("  glyphs:      {} -> {}".format(font.glyph_cnt - 1, len(used)))
+        print("  cmaps:       {} -> {} ({})".format(len(font.cmaps), len(sub.cmaps), ", ".join(
+            "{}: {}".format(t.replace("LV_FONT_FMT_TXT_CMAP_", ""), n) for t, n in sorted(types.items()))))
+        print("  bitmaps:     {} bpp{} -> {} bpp{}".format(font.bpp, ", compressed" if font.compressed else "",
+                                                        sub.bpp, ", compressed" if sub.compressed else ""))
+        print("  flash:       {} -> {} bytes (saved {} bytes, {:.0f}%)".format(
+            flash_old, flash_new, flash_old - flash_new, 100 * (flash_old - flash_new) / flash_old))
+        print("  lookup:      {:.2f} -> {:.2f} comparisons/character (speedup {:.2f}x)".format(
+            steps_old, steps_new, steps_old / steps_new if steps_new else 0))
+        print("  verified:    {} glyphs and {} kerning pairs are identical".format(len(used), pairs))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,222 @@
+#!/usr/bin/env python3
+
+'''
+Pack images of LVGL's image converter into one image atlas (sprite sheet).
+
+The input is C files created by the image converter with LV_IMG_CF_TRUE_COLOR, LV_IMG_CF_TRUE_COLOR_ALPHA or
+LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED color format. The images should be converted for the same color depths.
+The output is a C file with the atlas image, the area of every sprite and an `lv_img_atlas_t` variable,
+and a header with the IDs of the sprites.
+Use the sprites with `lv_img_set_src_atlas(img, &name, NAME_ID_...)`.
+
+The atlas is LV_IMG_CF_TRUE_COLOR_ALPHA if any image has alpha. Opaque images get an opaque alpha byte then.
+The sprites are separated by transparent padding to avoid bleeding of the neighbors when zoomed with anti-aliasing.
+
+Example:
+  ./img_atlas.py ../../lv_examples/lv_examples/src/assets/img_cogwheel_*.c -n img_cogwheels -o img_cogwheels.c
+'''
+
+import argparse
+from argparse import RawTextHelpFormatter
+import os
+import re
+import sys
+
+from img_compress import CImage, ImgError, CF_NAMES
+
+if sys.version_info < (3, 6, 0):
+    print("Python >=3.6 is required", file=sys.stderr)
+    exit(1)
+
+CF_TRUE_COLOR = 4
+CF_TRUE_COLOR_ALPHA = 5
+CF_TRUE_COLOR_CHROMA_KEYED = 6
+MAX_SIZE = 2047         # Limited by `lv_img_header_t`
+
+
+def pack(sizes, max_w, padding):
+    '''Place the rectangles with a shelf algorithm, the highest first.
+    Return the position of every rectangle and the size of the atlas.'''
+    order = sorted(range(len(sizes)), key=lambda i: (-sizes[i][1], -sizes[i][0]))
+    pos = [None] * len(sizes)
+    x = 0
+    y = 0
+    shelf_h = 0
+    atlas_w = 0
+    for i in order:
+        w, h = sizes[i]
+        if w > max_w:
+            raise ImgError("a {}x{} image is wider than the atlas".format(w, h))
+        if x + w > max_w:
+            x = 0
+            y += shelf_h + padding
+            shelf_h = 0
+        pos[i] = (x, y)
+        x += w + padding
+        shelf_h = max(shelf_h, h)
+        atlas_w = max(atlas_w, x - padding)
+    return pos, atlas_w, y + shelf_h
+
+
+def alpha_px_size(px):
+    '''Pixel size with alpha byte. 32 bit colors have an alpha channel anyway.'''
+    return px if px == 4 else px + 1
+
+
+def blit(atlas, atlas_w, px, data, w, h, x, y, opaque):
+    '''Copy the pixels of an image into the atlas. Make them opaque if the atlas has alpha but the image doesn't.'''
+    src_px = len(data) // (w * h)
+    for row in range(h):
+        src = data[row * w * src_px:(row + 1) * w * src_px]
+        dst = (y + row) * atlas_w * px + x * px
+        if opaque:
+            line = bytearray()
+            for i in range(0, len(src), src_px):
+                line.extend(src[i:i + px - 1])
+                line.append(0xFF)
+            src = line
+        atlas[dst:dst + w * px] = src
+
+
+def c_name(path):
+    name = os.path.splitext(os.path.basename(path))[0]
+    return re.sub(r"\W", "_", name)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=RawTextHelpFormatter)
+    parser.add_argument("input", nargs="+", help="C files of the image converter")
+    parser.add_argument("-n", "--name", required=True, help="Name of the atlas variable")
+    parser.add_argument("-o", "--output", metavar="file", help="The C file of the atlas. Default: <name>.c")
+    parser.add_argument("--max-width", type=int, default=512, metavar="px",
+                        help="Maximal width of the atlas. Default: 512")
+    parser.add_argument("--padding", type=int, default=1, metavar="px",
+                        help="Transparent space between the sprites. Default: 1")
+    args = parser.parse_args()
+
+    imgs = []
+    for path in args.input:
+        try:
+            img = CImage(path)
+        except (ImgError, OSError, ValueError) as e:
+            print("Can't read {}: {}".format(path, e), file=sys.stderr)
+            exit(1)
+        if img.cf not in (CF_TRUE_COLOR, CF_TRUE_COLOR_ALPHA, CF_TRUE_COLOR_CHROMA_KEYED):
+            print("{}: {} can't be packed".format(path, CF_NAMES[img.cf]), file=sys.stderr)
+            exit(1)
+        imgs.append((c_name(path), img))
+
+    cfs = set(img.cf for _, img in imgs)
+    if CF_TRUE_COLOR_CHROMA_KEYED in cfs and len(cfs) > 1:
+        print("Chroma keyed images can't be packed with other color formats", file=sys.stderr)
+        exit(1)
+    cf = CF_TRUE_COLOR_ALPHA if CF_TRUE_COLOR_ALPHA in cfs else cfs.pop()
+
+    conds = [cond for cond, _ in imgs[0][1].blocks]
+    for name, img in imgs:
+        if [cond for cond, _ in img.blocks] != conds:
+            print("{} is converted for other color depths".format(name), file=sys.stderr)
+            exit(1)
+
+    try:
+        pos, atlas_w, atlas_h = pack([(img.w, img.h) for _, img in imgs], args.max_width, args.padding)
+    except ImgError as e:
+        print(e, file=sys.stderr)
+        exit(1)
+    if atlas_w > MAX_SIZE or atlas_h > MAX_SIZE:
+        print("The atlas is too large: {}x{}".format(atlas_w, atlas_h), file=sys.stderr)
+        exit(1)
+
+    # Build the atlas for every color depth
+    blocks = []
+    for b, cond in enumerate(conds):
+        px = None
+        for _, img in imgs:
+            data = img.blocks[b][1]
+            img_px = len(data) // (img.w * img.h)
+            if img.cf != CF_TRUE_COLOR_ALPHA and cf == CF_TRUE_COLOR_ALPHA:
+                img_px = alpha_px_size(img_px)
+            if px is None:
+                px = img_px
+            elif px != img_px:
+                print("The pixel sizes don't match in {}".format(cond or "the images"), file=sys.stderr)
+                exit(1)
+
+        atlas = bytearray(atlas_w * atlas_h * px)
+        for (_, img), (x, y) in zip(imgs, pos):
+            opaque = img.cf != CF_TRUE_COLOR_ALPHA and cf == CF_TRUE_COLOR_ALPHA
+            blit(atlas, atlas_w, px, img.blocks[b][1], img.w, img.h, x, y, opaque)
+        blocks.append((cond, atlas))
+
+    name = args.name
+    out_path = args.output or name + ".c"
+    hdr_path = os.path.splitext(out_path)[0] + ".h"
+    guard = re.sub(r"\W", "_", os.path.basename(hdr_path)).upper()
+
+    hdr = []
+    hdr.append("/*Generated by img_atlas.py from {} images*/".format(len(imgs)))
+    hdr.append("")
+    hdr.append("#ifndef {}".format(guard))
+    hdr.append("#define {}".format(guard))
+    hdr.append("")
+    hdr.append("#include \"lvgl/lvgl.h\"")
+    hdr.append("")
+    hdr.append("/*IDs of the sprites*/")
+    hdr.append("enum {")
+    for img_name, _ in imgs:
+        hdr.append("    {}_ID_{},".format(name.upper(), img_name.upper()))
+    hdr.append("};")
+    hdr.append("")
+    hdr.append("LV_IMG_ATLAS_DECLARE({})".format(name))
+    hdr.append("")
+    hdr.append("#endif /*{}*/".format(guard))
+
+    lines = []
+    lines.append("/*Generated by img_atlas.py from {} images*/".format(len(imgs)))
+    lines.append("")
+    lines.append("#include \"{}\"".format(os.path.basename(hdr_path)))
+    lines.append("")
+    lines.append("static const uint8_t {}_map[] = {{".format(name))
+    for cond, data in blocks:
+        if cond:
+            lines.append(cond)
+        for i in range(0, len(data), 16):
+            lines.append("  " + " ".join("0x{:02x},".format(v) for v in data[i:i + 16]))
+        if cond:
+            lines.append("#endif")
+    lines.append("};")
+    lines.append("")
+    lines.append("static const lv_img_dsc_t {}_img = {{".format(name))
+    lines.append("  .header.always_zero = 0,")
+    lines.append("  .header.w = {},".format(atlas_w))
+    lines.append("  .header.h = {},".format(atlas_h))
+    lines.append("  .data_size = sizeof({}_map),".format(name))
+    lines.append("  .header.cf = {},".format(CF_NAMES[cf]))
+    lines.append("  .data = {}_map,".format(name))
+    lines.append("};")
+    lines.append("")
+    lines.append("static const lv_area_t {}_rects[] = {{".format(name))
+    for (img_name, img), (x, y) in zip(imgs, pos):
+        lines.append("  {{{}, {}, {}, {}}},    /*{}*/".format(x, y, x + img.w - 1, y + img.h - 1, img_name))
+    lines.append("};")
+    lines.append("")
+    lines.append("const lv_img_atlas_t {} = {{".format(name))
+    lines.append("  .src = &{}_img,".format(name))
+    lines.append("  .rects = {}_rects,".format(name))
+    lines.append("  .rect_cnt = {},".format(len(imgs)))
+    lines.append("  .w = {},".format(atlas_w))
+    lines.append("  .h = {},".format(atlas_h))
+    lines.append("};")
+
+    with open(out_path, "w") as f:
+        f.write("\n".join(lines) + "\n")
+    with open(hdr_path, "w") as f:
+        f.write("\n".join(hdr) + "\n")
+
+    area = sum(img.w * img.h for _, img in imgs)
+    print("{} images -> {}x{} {} atlas ({:.0f}% used)".format(len(imgs), atlas_w, atlas_h, CF_NAMES[cf],
+                                                              100 * area / (atlas_w * atlas_h)))
+
+
+if __name__ == '__main__':
+    main()
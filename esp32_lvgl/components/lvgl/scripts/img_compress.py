@@ -0,0 +1,431 @@
+#!/usr/bin/env python3
+
+'''
+Compress images of LVGL's image converter to LV_IMG_CF_RLE or LV_IMG_CF_LZ4 images.
+
+The input is a C file or a binary (*.bin) file created by the image converter in any built-in color format.
+The C files are converted for every color depth they contain and keep the names of the variables so
+they can replace the original files.
+RLE suits images with large areas of the same color (icons, UI art), LZ4 suits images with repeating
+patterns (photos, gradients, anti-aliased art). "auto" selects the smaller one per image.
+
+The image is compressed in blocks of lines to decompress only the required blocks while drawing.
+Larger blocks compress better but take more RAM and time to reach a line when drawing.
+
+Without an output only the sizes are reported, e.g. to see the flash savings of a set of images.
+Every compressed image is verified by decompressing it.
+
+Example:
+  ./img_compress.py ../../../main/img_logo.c -m auto -o ../../../main/img_logo_compr.c
+  ./img_compress.py ../../lv_examples/lv_examples/src/assets/*.c
+'''
+
+import argparse
+from argparse import RawTextHelpFormatter
+import re
+import sys
+
+if sys.version_info < (3, 6, 0):
+    print("Python >=3.6 is required", file=sys.stderr)
+    exit(1)
+
+CF_NAMES = {
+    4: "LV_IMG_CF_TRUE_COLOR",
+    5: "LV_IMG_CF_TRUE_COLOR_ALPHA",
+    6: "LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED",
+    7: "LV_IMG_CF_INDEXED_1BIT",
+    8: "LV_IMG_CF_INDEXED_2BIT",
+    9: "LV_IMG_CF_INDEXED_4BIT",
+    10: "LV_IMG_CF_INDEXED_8BIT",
+    11: "LV_IMG_CF_ALPHA_1BIT",
+    12: "LV_IMG_CF_ALPHA_2BIT",
+    13: "LV_IMG_CF_ALPHA_4BIT",
+    14: "LV_IMG_CF_ALPHA_8BIT",
+}
+CF_VALUES = {name: cf for cf, name in CF_NAMES.items()}
+CF_RLE = 15
+CF_LZ4 = 16
+METHODS = {"rle": CF_RLE, "lz4": CF_LZ4}
+
+RLE_MAX = 127
+LZ4_MIN_MATCH = 4
+LZ4_MAX_DIST = 65535
+LZ4_LAST_LITERALS = 5   # The last 5 bytes are always literals
+LZ4_MF_LIMIT = 12       # No match can start in the last 12 bytes
+
+
+class ImgError(Exception):
+    pass
+
+
+def is_true_color(cf):
+    return 4 <= cf <= 6
+
+
+def bpp_of(cf):
+    return {7: 1, 8: 2, 9: 4, 10: 8, 11: 1, 12: 2, 13: 4, 14: 8}[cf]
+
+
+def palette_size(cf):
+    return 4 << bpp_of(cf) if 7 <= cf <= 10 else 0
+
+
+def layout(cf, w, h, data):
+    '''Return the size of the palette, a line and a pixel of the RLE in bytes'''
+    pal = palette_size(cf)
+    if is_true_color(cf):
+        if w * h == 0 or len(data) % (w * h):
+            raise ImgError("{} bytes don't match a {}x{} true color image".format(len(data), w, h))
+        px = len(data) // (w * h)
+        return pal, w * px, px
+
+    line = (w * bpp_of(cf) + 7) // 8
+    if len(data) < pal + line * h:
+        raise ImgError("{} bytes are too few for a {}x{} {} image".format(len(data), w, h, CF_NAMES[cf]))
+    return pal, line, 1
+
+
+def rle_compress(data, px):
+    out = bytearray()
+    lit = bytearray()
+    n = len(data) // px
+    i = 0
+
+    def flush_lit():
+        while lit:
+            cnt = min(len(lit) // px, RLE_MAX)
+            out.append(0x80 | cnt)
+            out.extend(lit[:cnt * px])
+            del lit[:cnt * px]
+
+    while i < n:
+        unit = data[i * px:(i + 1) * px]
+        run = 1
+        while i + run < n and run < RLE_MAX and data[(i + run) * px:(i + run + 1) * px] == unit:
+            run += 1
+
+        # A repeated single byte is worth only from 3 bytes
+        if run >= (3 if px == 1 else 2):
+            flush_lit()
+            out.append(run)
+            out.extend(unit)
+            i += run
+        else:
+            lit.extend(unit)
+            i += 1
+    flush_lit()
+    return bytes(out)
+
+
+def rle_decompress(data, size, px):
+    out = bytearray()
+    i = 0
+    while len(out) < size:
+        ctrl = data[i]
+        i += 1
+        cnt = (ctrl & 0x7F) * px
+        if ctrl & 0x80:
+            out.extend(data[i:i + cnt])
+            i += cnt
+        else:
+            out.extend(data[i:i + px] * (ctrl & 0x7F))
+            i += px
+    if i != len(data) or len(out) != size:
+        raise ImgError("RLE verification failed")
+    return bytes(out)
+
+
+def lz4_write_len(out, n):
+    while n >= 255:
+        out.append(255)
+        n -= 255
+    out.append(n)
+
+
+def lz4_sequence(out, lit, dist=0, match=0):
+    ll = len(lit)
+    ml = match - LZ4_MIN_MATCH
+    out.append((min(ll, 15) << 4) | (min(ml, 15) if dist else 0))
+    if ll >= 15:
+        lz4_write_len(out, ll - 15)
+    out.extend(lit)
+    if dist:
+        out.extend(dist.to_bytes(2, "little"))
+        if ml >= 15:
+            lz4_write_len(out, ml - 15)
+
+
+def lz4_compress(data):
+    '''Greedy LZ4 block compression with a hash table of the last positions of 4 byte sequences'''
+    n = len(data)
+    out = bytearray()
+    table = {}
+    anchor = 0
+    i = 0
+    while i < n - LZ4_MF_LIMIT:
+        key = data[i:i + LZ4_MIN_MATCH]
+        cand = table.get(key)
+        table[key] = i
+        if cand is None or i - cand > LZ4_MAX_DIST:
+            i += 1
+            continue
+
+        match = LZ4_MIN_MATCH
+        limit = n - LZ4_LAST_LITERALS
+        while i + match < limit and data[cand + match] == data[i + match]:
+            match += 1
+
+        lz4_sequence(out, data[anchor:i], i - cand, match)
+        i += match
+        anchor = i
+        table[data[i - 2:i + 2]] = i - 2
+
+    lz4_sequence(out, data[anchor:])
+    return bytes(out)
+
+
+def lz4_decompress(data, size):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        token = data[i]
+        i += 1
+        ll = token >> 4
+        if ll == 15:
+            while True:
+                ll += data[i]
+                i += 1
+                if data[i - 1] != 255:
+                    break
+        out.extend(data[i:i + ll])
+        i += ll
+        if i == len(data):
+            break
+        dist = data[i] | (data[i + 1] << 8)
+        i += 2
+        ml = token & 0xF
+        if ml == 15:
+            while True:
+                ml += data[i]
+                i += 1
+                if data[i - 1] != 255:
+                    break
+        ml += LZ4_MIN_MATCH
+        if dist == 0 or dist > len(out):
+            raise ImgError("LZ4 verification failed")
+        for _ in range(ml):
+            out.append(out[-dist])
+    if len(out) != size:
+        raise ImgError("LZ4 verification failed")
+    return bytes(out)
+
+
+def compress(cf, w, h, data, method, block_size):
+    '''Return the data of an LV_IMG_CF_RLE or LV_IMG_CF_LZ4 image as described at `lv_img_compr_header_t`'''
+    pal, line, px = layout(cf, w, h, data)
+    block_h = max(1, min(h, block_size // line, 0xFFFF))
+    blocks = []
+    for y in range(0, h, block_h):
+        raw = data[pal + y * line:pal + min(y + block_h, h) * line]
+        blocks.append(rle_compress(raw, px) if method == CF_RLE else lz4_compress(raw))
+
+    out = bytearray([cf, 0]) + block_h.to_bytes(2, "little")
+    ofs = 0
+    for b in blocks + [b""]:
+        out.extend(ofs.to_bytes(4, "little"))
+        ofs += len(b)
+    out.extend(data[:pal])
+    for b in blocks:
+        out.extend(b)
+    return bytes(out)
+
+
+def decompress(method, cf, w, h, data, line, px):
+    block_h = data[2] | (data[3] << 8)
+    block_cnt = (h + block_h - 1) // block_h
+    ofs = [int.from_bytes(data[4 + i * 4:8 + i * 4], "little") for i in range(block_cnt + 1)]
+    pos = 4 + (block_cnt + 1) * 4
+    pal = palette_size(cf)
+    out = bytearray(data[pos:pos + pal])
+    pos += pal
+    for i in range(block_cnt):
+        size = min(block_h, h - i * block_h) * line
+        block = data[pos + ofs[i]:pos + ofs[i + 1]]
+        out.extend(rle_decompress(block, size, px) if method == CF_RLE else lz4_decompress(block, size))
+    if data[0] != cf or pos + ofs[-1] != len(data):
+        raise ImgError("verification failed")
+    return bytes(out)
+
+
+def compress_verified(cf, w, h, data, method, block_size):
+    """Compress with the given method or with the better one for "auto" and verify the result"""
+    methods = [CF_RLE, CF_LZ4] if method == "auto" else [METHODS[method]]
+    pal, line, px = layout(cf, w, h, data)
+    data = data[:pal + line * h]
+    best = None
+    for m in methods:
+        compr = compress(cf, w, h, data, m, block_size)
+        if decompress(m, cf, w, h, compr, line, px) != data:
+            raise ImgError("verification failed")
+        if best is None or len(compr) < len(best[1]):
+            best = (m, compr)
+    return best
+
+
+class CImage:
+    """An image in a C file of the image converter: one data block for every color depth"""
+
+    def __init__(self, path):
+        with open(path, "r") as f:
+            self.src = f.read()
+
+        m = re.search(r"lv_img_dsc_t\s+(\w+)\s*=\s*\{(.*?)\};", self.src, re.S)
+        if m is None:
+            raise ImgError("no lv_img_dsc_t found")
+        self.name = m.group(1)
+        dsc = m.group(2)
+        try:
+            self.w = int(re.search(r"\.header\.w\s*=\s*(\d+)", dsc).group(1))
+            self.h = int(re.search(r"\.header\.h\s*=\s*(\d+)", dsc).group(1))
+            cf_name = re.search(r"\.header\.cf\s*=\s*(\w+)", dsc).group(1)
+            map_name = re.search(r"\.data\s*=\s*(\w+)", dsc).group(1)
+        except AttributeError:
+            raise ImgError("incomplete lv_img_dsc_t")
+        if cf_name not in CF_VALUES:
+            raise ImgError("{} can't be compressed".format(cf_name))
+        self.cf = CF_VALUES[cf_name]
+
+        m = re.search(r"^([^\n]*\b" + map_name + r"\[\]\s*=\s*\{[^\n]*\n)(.*?)^\};", self.src, re.S | re.M)
+        if m is None:
+            raise ImgError("{} not found".format(map_name))
+        self.map_start = m.start(2)
+        self.map_end = m.end(2)
+
+        # The `#if LV_COLOR_DEPTH ...` conditions with their data. `None` if there is no condition.
+        self.blocks = []
+        cond = None
+        data = bytearray()
+        for line in m.group(2).splitlines():
+            s = line.strip()
+            if s.startswith("#if"):
+                cond = s
+                data = bytearray()
+            elif s.startswith("#endif"):
+                self.blocks.append((cond, bytes(data)))
+                cond = None
+                data = bytearray()
+            else:
+                code = re.sub(r"/\*.*?\*/", "", s)
+                data.extend(int(v, 16) for v in re.findall(r"0x([0-9a-fA-F]{2})", code))
+        if data:
+            self.blocks.append((None, bytes(data)))
+
+    def write(self, path, method, blocks):
+        lines = []
+        for cond, data in blocks:
+            if cond:
+                lines.append(cond)
+            for i in range(0, len(data), 16):
+                lines.append("  " + " ".join("0x{:02x},".format(b) for b in data[i:i + 16]))
+            if cond:
+                lines.append("#endif")
+
+        dsc_start = self.src.index(self.name, self.map_end)
+        dsc = self.src[dsc_start:]
+        dsc = re.sub(r"(\.header\.cf\s*=\s*)\w+", r"\g<1>" + ("LV_IMG_CF_RLE" if method == CF_RLE else "LV_IMG_CF_LZ4"),
+                     dsc, 1)
+        map_name = re.search(r"\.data\s*=\s*(\w+)", dsc).group(1)
+        dsc = re.sub(r"(\.data_size\s*=\s*)[^,]*", r"\g<1>sizeof(" + map_name + ")", dsc, 1)
+
+        with open(path, "w") as f:
+            f.write(self.src[:self.map_start])
+            f.write("\n".join(lines) + "\n")
+            f.write(self.src[self.map_end:dsc_start])
+            f.write(dsc)
+
+
+class BinImage:
+    """An image in a binary file of the image converter"""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            raw = f.read()
+        if len(raw) < 4:
+            raise ImgError("too short")
+        header = int.from_bytes(raw[:4], "little")
+        self.header = header
+        self.cf = header & 0x1F
+        self.w = (header >> 10) & 0x7FF
+        self.h = (header >> 21) & 0x7FF
+        self.name = path
+        if self.cf not in CF_NAMES:
+            raise ImgError("color format {} can't be compressed".format(self.cf))
+        self.blocks = [(None, raw[4:])]
+
+    def write(self, path, method, blocks):
+        header = (self.header & ~0x1F) | method
+        with open(path, "wb") as f:
+            f.write(header.to_bytes(4, "little"))
+            f.write(blocks[0][1])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=RawTextHelpFormatter)
+    parser.add_argument("input", nargs="+", help="C or *.bin files of the image converter")
+    parser.add_argument("-m", "--method", choices=["rle", "lz4", "auto"], default="auto",
+                        help="Compression method. Default: auto")
+    parser.add_argument("--block-size", type=int, default=4096, metavar="bytes",
+                        help="Decompressed size of the blocks. Default: 4096")
+    parser.add_argument("-o", "--output", metavar="file",
+                        help="The compressed C or *.bin file (only with one input)")
+    args = parser.parse_args()
+
+    if args.output and len(args.input) != 1:
+        print("Only one input can be written to an output", file=sys.stderr)
+        exit(1)
+
+    total_raw = 0
+    total_compr = 0
+    for path in args.input:
+        try:
+            img = BinImage(path) if path.endswith(".bin") else CImage(path)
+            results = []
+            for cond, data in img.blocks:
+                results.append((cond, data, compress_verified(img.cf, img.w, img.h, data, args.method,
+                                                              args.block_size)))
+        except (ImgError, OSError, ValueError) as e:
+            print("Skip {}: {}".format(path, e), file=sys.stderr)
+            continue
+
+        # All color depths need to use the same method as they share the descriptor
+        method = results[0][2][0]
+        if args.method == "auto" and len(results) > 1:
+            size = {m: sum(len(compress(img.cf, img.w, img.h, d, m, args.block_size)) for _, d, _ in results)
+                    for m in (CF_RLE, CF_LZ4)}
+            method = min(size, key=size.get)
+        blocks = []
+        for cond, data, (m, compr) in results:
+            if m != method:
+                compr = compress(img.cf, img.w, img.h, data, method, args.block_size)
+            blocks.append((cond, compr, data))
+
+        print("{} ({}x{} {}) -> {}".format(img.name, img.w, img.h, CF_NAMES[img.cf],
+                                           "LV_IMG_CF_RLE" if method == CF_RLE else "LV_IMG_CF_LZ4"))
+        for cond, compr, data in blocks:
+            pal, line, px = layout(img.cf, img.w, img.h, data)
+            raw_size = pal + line * img.h
+            print("  {:<50} {:>7} -> {:>7} bytes (saved {:.0f}%)".format(
+                cond or "", raw_size, len(compr), 100 * (raw_size - len(compr)) / raw_size))
+            total_raw += raw_size
+            total_compr += len(compr)
+
+        if args.output:
+            img.write(args.output, method, [(cond, compr) for cond, compr, _ in blocks])
+
+    if total_raw:
+        print("Total: {} -> {} bytes (saved {} bytes, {:.0f}%)".format(
+            total_raw, total_compr, total_raw - total_compr, 100 * (total_raw - total_compr) / total_raw))
+
+
+if __name__ == "__main__":
+    main()
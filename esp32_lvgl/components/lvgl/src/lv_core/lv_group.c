@@ -90,7 +90,7 @@ void lv_group_del(lv_group_t * group)
     /*Remove the objects from the group*/
     lv_obj_t ** obj;
     _LV_LL_READ(group->obj_ll, obj) {
-        (*obj)->group_p = NULL;
+        _lv_obj_set_group(*obj, NULL);
     }
 
     _lv_ll_clear(&(group->obj_ll));
@@ -116,15 +116,16 @@ void lv_group_add_obj(lv_group_t * group, lv_obj_t * obj)
     }
 
     /*If the object is already in a group and focused then defocus it*/
-    if(obj->group_p) {
+    lv_group_t * group_ori = lv_obj_get_group(obj);
+    if(group_ori) {
         if(lv_obj_is_focused(obj)) {
-            lv_group_refocus(obj->group_p);
+            lv_group_refocus(group_ori);
 
             LV_LOG_INFO("lv_group_add_obj: assign object to an other group");
         }
     }
 
-    obj->group_p     = group;
+    _lv_obj_set_group(obj, group);
     lv_obj_t ** next = _lv_ll_ins_tail(&group->obj_ll);
     LV_ASSERT_MEM(next);
     if(next == NULL) return;
@@ -143,7 +144,7 @@ void lv_group_add_obj(lv_group_t * group, lv_obj_t * obj)
  */
 void lv_group_remove_obj(lv_obj_t * obj)
 {
-    lv_group_t * g = obj->group_p;
+    lv_group_t * g = lv_obj_get_group(obj);
     if(g == NULL) return;
 
     /*Focus on the next object*/
@@ -173,7 +174,7 @@ void lv_group_remove_obj(lv_obj_t * obj)
         if(*i == obj) {
             _lv_ll_remove(&g->obj_ll, i);
             lv_mem_free(i);
-            obj->group_p = NULL;
+            _lv_obj_set_group(obj, NULL);
             break;
         }
     }
@@ -195,7 +196,7 @@ void lv_group_remove_all_objs(lv_group_t * group)
     /*Remove the objects from the group*/
     lv_obj_t ** obj;
     _LV_LL_READ(group->obj_ll, obj) {
-        (*obj)->group_p = NULL;
+        _lv_obj_set_group(*obj, NULL);
     }
 
     _lv_ll_clear(&(group->obj_ll));
@@ -208,7 +209,7 @@ void lv_group_remove_all_objs(lv_group_t * group)
 void lv_group_focus_obj(lv_obj_t * obj)
 {
     if(obj == NULL) return;
-    lv_group_t * g = obj->group_p;
+    lv_group_t * g = lv_obj_get_group(obj);
     if(g == NULL) return;
 
     if(g->frozen != 0) return;
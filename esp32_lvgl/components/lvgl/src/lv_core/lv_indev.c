@@ -1152,7 +1152,7 @@ lv_obj_t * lv_indev_search_obj(lv_obj_t * obj, lv_point_t * point)
     if(lv_obj_hittest(obj, point)) {
         lv_obj_t * i;
 
-        _LV_LL_READ(obj->child_ll, i) {
+        _LV_OBJ_CHILD_READ(obj, i) {
             found_p = lv_indev_search_obj(i, point);
 
             /*If a child was found then break*/
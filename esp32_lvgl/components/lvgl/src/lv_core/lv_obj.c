@@ -46,6 +46,29 @@
 #define LV_OBJX_NAME "lv_obj"
 #define LV_OBJ_DEF_WIDTH    (LV_DPX(100))
 #define LV_OBJ_DEF_HEIGHT   (LV_DPX(50))
+#define LAYOUT_SUSPEND_MAX  8   /*Objects with suspended layout at the same time*/
+
+#if LV_STYLE_CACHE_SIZE
+/*Number of the style properties by type*/
+#define STYLE_CACHE_INT_NUM     62
+#define STYLE_CACHE_COLOR_NUM   14
+#define STYLE_CACHE_OPA_NUM     12
+#define STYLE_CACHE_PTR_NUM     5
+
+/*The bits of the properties in the `resolved` map*/
+#define STYLE_CACHE_INT_BIT     0
+#define STYLE_CACHE_COLOR_BIT   (STYLE_CACHE_INT_BIT + STYLE_CACHE_INT_NUM)
+#define STYLE_CACHE_OPA_BIT     (STYLE_CACHE_COLOR_BIT + STYLE_CACHE_COLOR_NUM)
+#define STYLE_CACHE_PTR_BIT     (STYLE_CACHE_OPA_BIT + STYLE_CACHE_OPA_NUM)
+#define STYLE_CACHE_PROP_NUM    (STYLE_CACHE_PTR_BIT + STYLE_CACHE_PTR_NUM)
+
+#define STYLE_CACHE_NONE        0xFF
+#define STYLE_CACHE_GROUP_NUM   13
+
+/*An object part can be cached in any entry of a set*/
+#define STYLE_CACHE_WAYS        (LV_STYLE_CACHE_SIZE >= 8 ? 8 : LV_STYLE_CACHE_SIZE)
+#define STYLE_CACHE_SETS        (LV_STYLE_CACHE_SIZE / STYLE_CACHE_WAYS)
+#endif
 
 /**********************
  *      TYPEDEFS
@@ -57,9 +80,7 @@ typedef struct _lv_event_temp_data {
 } lv_event_temp_data_t;
 
 typedef struct {
-    lv_obj_t * obj;
     lv_style_property_t prop;
-    uint8_t part;
     union {
         lv_color_t _color;
         lv_style_int_t _int;
@@ -72,6 +93,14 @@ typedef struct {
         lv_opa_t _opa;
         const void * _ptr;
     } end_value;
+} lv_style_trans_prop_t;
+
+/*The transition of all the changed properties of an object's part. Animated by one animation.*/
+typedef struct {
+    lv_obj_t * obj;
+    uint8_t part;
+    uint8_t prop_cnt;
+    lv_style_trans_prop_t props[LV_STYLE_TRANS_NUM_MAX];
 } lv_style_trans_t;
 
 typedef struct {
@@ -104,6 +133,24 @@ typedef struct {
     uint32_t border_post : 1;
 } style_snapshot_t;
 
+#if LV_STYLE_CACHE_SIZE
+/*The resolved style properties of an object's part in a state*/
+typedef struct {
+    const lv_obj_t * obj;
+    uint32_t gen;                   /*The value of `style_cache_gen` when the entry was filled*/
+    uint32_t used;                  /*The value of `style_cache_tick` when the entry was used last time*/
+    uint8_t part;
+    lv_state_t state;
+    uint8_t rect_valid;             /*1: `rect` is initialized*/
+    uint32_t resolved[(STYLE_CACHE_PROP_NUM + 31) / 32];   /*1 bit for every property: the value is resolved*/
+    lv_style_int_t ints[STYLE_CACHE_INT_NUM];
+    lv_color_t colors[STYLE_CACHE_COLOR_NUM];
+    lv_opa_t opas[STYLE_CACHE_OPA_NUM];
+    const void * ptrs[STYLE_CACHE_PTR_NUM];
+    lv_draw_rect_dsc_t rect;        /*Initialized from `lv_draw_rect_dsc_init()`'s defaults*/
+} style_cache_t;
+#endif
+
 typedef enum {
     STYLE_COMPARE_SAME,
     STYLE_COMPARE_VISUAL_DIFF,
@@ -124,10 +171,15 @@ static void obj_align_core(lv_obj_t * obj, const lv_obj_t * base, lv_align_t ali
 static void obj_align_mid_core(lv_obj_t * obj, const lv_obj_t * base, lv_align_t align,  bool x_set, bool y_set,
                                lv_coord_t x_ofs, lv_coord_t y_ofs);
 #if LV_USE_ANIMATION
-static lv_style_trans_t * trans_create(lv_obj_t * obj, lv_style_property_t prop, uint8_t part, lv_state_t prev_state,
-                                       lv_state_t new_state);
+static lv_style_trans_t * trans_create(lv_obj_t * obj, uint8_t part, const lv_style_property_t props[],
+                                       lv_state_t prev_state, lv_state_t new_state);
+static bool trans_prop_init(lv_obj_t * obj, uint8_t part, lv_style_trans_prop_t * tr_prop, lv_state_t prev_state,
+                            lv_state_t new_state);
+static lv_style_trans_t * trans_alloc(void);
+static void trans_free(lv_style_trans_t * tr);
 static void trans_del(lv_obj_t * obj, uint8_t part, lv_style_property_t prop, lv_style_trans_t * tr_limit);
 static void trans_anim_cb(lv_style_trans_t * tr, lv_anim_value_t v);
+static void trans_refresh(lv_style_trans_t * tr);
 static void trans_anim_start_cb(lv_anim_t * a);
 static void trans_anim_ready_cb(lv_anim_t * a);
 static void opa_scale_anim(lv_obj_t * obj, lv_anim_value_t v);
@@ -137,11 +189,41 @@ static void lv_event_mark_deleted(lv_obj_t * obj);
 static bool obj_valid_child(const lv_obj_t * parent, const lv_obj_t * obj_to_find);
 static void lv_obj_del_async_cb(void * obj);
 static void obj_del_core(lv_obj_t * obj);
+static int32_t layout_suspend_find(const lv_obj_t * obj);
+static bool layout_is_suspended(const lv_obj_t * obj);
+static bool layout_flush(lv_obj_t * obj);
+#if LV_USE_OBJ_COMPACT
+static void child_link(lv_obj_t * parent, lv_obj_t * obj, bool head);
+static void child_unlink(lv_obj_t * parent, lv_obj_t * obj);
+#endif
+#if _LV_OBJ_SPEC_ATTR
+static lv_obj_spec_attr_t * spec_attr_get(lv_obj_t * obj);
+#endif
+#if LV_USE_OBJ_REALIGN
+static lv_realign_t * realign_get(const lv_obj_t * obj, bool alloc);
+#endif
+#if LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_FULL
+static const lv_area_t * ext_click_pad_get(const lv_obj_t * obj);
+#endif
 static void update_style_cache(lv_obj_t * obj, uint8_t part, uint16_t prop);
 static void update_style_cache_children(lv_obj_t * obj);
-static void invalidate_style_cache(lv_obj_t * obj, uint8_t part, lv_style_property_t prop);
+static void invalidate_style_cache(lv_obj_t * obj, uint8_t part, bool cacheble, bool inherit);
+static bool style_prop_needs_refr(lv_style_property_t prop);
+static bool style_prop_is_cacheble(lv_style_property_t prop);
+static bool style_prop_is_inherited(lv_style_property_t prop);
 static void style_snapshot(lv_obj_t * obj, uint8_t part, style_snapshot_t * shot);
 static style_snapshot_res_t style_snapshot_compare(style_snapshot_t * shot1, style_snapshot_t * shot2);
+static lv_style_int_t get_style_int(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop);
+static lv_color_t get_style_color(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop);
+static lv_opa_t get_style_opa(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop);
+static const void * get_style_ptr(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop);
+static void init_draw_rect_dsc(lv_obj_t * obj, uint8_t part, lv_draw_rect_dsc_t * draw_dsc);
+static void style_cache_invalidate(void);
+static void style_cache_invalidate_obj(const lv_obj_t * obj, uint8_t part, bool children);
+#if LV_STYLE_CACHE_SIZE
+static style_cache_t * style_cache_get(const lv_obj_t * obj, uint8_t part);
+static bool style_cache_is_for(const style_cache_t * cache, const lv_obj_t * obj, uint8_t part, uint32_t gen);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -149,10 +231,49 @@ static style_snapshot_res_t style_snapshot_compare(style_snapshot_t * shot1, sty
 static bool lv_initialized = false;
 static lv_event_temp_data_t * event_temp_data_head;
 static const void * event_act_data;
+static lv_style_cache_stats_t style_cache_stats;
+/*Objects with suspended layout. Only a few are suspended at once so it's not stored in every object*/
+static lv_obj_t * layout_suspend_objs[LAYOUT_SUSPEND_MAX];
+static uint32_t layout_suspend_cnt;
+static lv_obj_t * layout_flush_obj;     /*Its postponed `LV_SIGNAL_CHILD_CHG` is being sent*/
+
+#if LV_STYLE_CACHE_SIZE
+static style_cache_t style_cache[STYLE_CACHE_SETS * STYLE_CACHE_WAYS];
+static uint32_t style_cache_tick;
+static uint32_t style_cache_gen = 1;
+static lv_draw_rect_dsc_t rect_dsc_def;
+
+/*Index of the style properties in `style_cache_t`'s arrays of their type.
+ *Rows: the groups of the properties, columns: the IDs of the properties in the group*/
+#define XX STYLE_CACHE_NONE
+static const uint8_t style_cache_idx[STYLE_CACHE_GROUP_NUM][16] = {
+    {XX,  0,  1,  2,  3,  4,  5,  6, XX, XX, XX, XX,  0, XX, XX, XX},     /*Mixed*/
+    { 7,  8,  9, 10, 11, 12, 13, 14, 15, XX, XX, XX, XX, XX, XX, XX},     /*Padding, margin*/
+    {16, 17, 18, 19, XX, XX, XX, XX, XX,  0,  1, XX,  1, XX, XX, XX},     /*Background*/
+    {20, 21, 22, 23, XX, XX, XX, XX, XX,  2, XX, XX,  2, XX, XX, XX},     /*Border*/
+    {24, 25, 26, XX, XX, XX, XX, XX, XX,  3, XX, XX,  3, XX, XX, XX},     /*Outline*/
+    {27, 28, 29, 30, 31, XX, XX, XX, XX,  4, XX, XX,  4, XX, XX, XX},     /*Shadow*/
+    {32, 33, XX, XX, XX, XX, XX, XX, XX,  5, XX, XX,  5,  6,  0, XX},     /*Pattern*/
+    {34, 35, 36, 37, 38, 39, XX, XX, XX,  6, XX, XX,  7, XX,  1,  2},     /*Value*/
+    {40, 41, 42, 43, XX, XX, XX, XX, XX,  7,  8,  9,  8, XX,  3, XX},     /*Text*/
+    {44, 45, 46, 47, 48, XX, XX, XX, XX, 10, XX, XX,  9, XX, XX, XX},     /*Line*/
+    {49, XX, XX, XX, XX, XX, XX, XX, XX, 11, XX, XX, 10, 11, XX, XX},     /*Image*/
+    {50, 51, 52, 53, 54, 55, 56, 57, XX, XX, XX, XX, XX, XX,  4, XX},     /*Transition*/
+    {58, 59, 60, 61, XX, XX, XX, XX, XX, 12, 13, XX, XX, XX, XX, XX},     /*Scale*/
+};
+#undef XX
+#endif
 
 /**********************
  *      MACROS
  **********************/
+#if LV_STYLE_CACHE_SIZE
+#define STYLE_CACHE_IDX(prop) \
+    (((prop) & LV_STYLE_STATE_MASK) || ((prop) & 0xFF) >= (STYLE_CACHE_GROUP_NUM << 4) ? \
+     STYLE_CACHE_NONE : style_cache_idx[((prop) >> 4) & 0xF][(prop) & 0xF])
+#define STYLE_CACHE_IS_RESOLVED(cache, bit) ((cache)->resolved[(bit) >> 5] & ((uint32_t)1 << ((bit) & 0x1F)))
+#define STYLE_CACHE_SET_RESOLVED(cache, bit) ((cache)->resolved[(bit) >> 5] |= ((uint32_t)1 << ((bit) & 0x1F)))
+#endif
 
 /**********************
  *   GLOBAL FUNCTIONS
@@ -173,6 +294,14 @@ void lv_init(void)
 
     /*Initialize the lv_misc modules*/
     _lv_mem_init();
+
+    /*Slab size class for the objects*/
+#if LV_USE_OBJ_COMPACT
+    _lv_mem_slab_add(sizeof(lv_obj_t));
+#else
+    _lv_mem_slab_add(sizeof(lv_obj_t) + 2 * sizeof(lv_ll_node_t *)); /*A node of `child_ll`*/
+#endif
+
     _lv_task_core_init();
 
 #if LV_USE_FILESYSTEM
@@ -200,6 +329,10 @@ void lv_init(void)
 #endif
 
     _lv_ll_init(&LV_GC_ROOT(_lv_obj_style_trans_ll), sizeof(lv_style_trans_t));
+    _lv_ll_init(&LV_GC_ROOT(_lv_obj_style_trans_pool_ll), sizeof(lv_style_trans_t));
+#if LV_STYLE_CACHE_SIZE
+    lv_draw_rect_dsc_init(&rect_dsc_def);
+#endif
 
     _lv_ll_init(&LV_GC_ROOT(_lv_disp_ll), sizeof(lv_disp_t));
     _lv_ll_init(&LV_GC_ROOT(_lv_indev_ll), sizeof(lv_indev_t));
@@ -218,7 +351,14 @@ void lv_init(void)
     _lv_img_decoder_init();
 #if LV_IMG_CACHE_DEF_SIZE
     lv_img_cache_set_size(LV_IMG_CACHE_DEF_SIZE);
+    lv_img_cache_set_mem_size(LV_IMG_CACHE_DEF_MEM_SIZE);
+    lv_img_cache_set_variant_mem_size(LV_IMG_CACHE_VARIANT_MEM_SIZE);
+#endif
+
+#if LV_USE_BIDI
+    _lv_bidi_cache_init();
 #endif
+
     /*Test if the IDE has UTF-8 encoding*/
     char * txt = "Á";
 
@@ -243,6 +383,7 @@ void lv_deinit(void)
 
     lv_disp_set_default(NULL);
     _lv_mem_deinit();
+    style_cache_invalidate();
     lv_initialized = false;
 
     LV_LOG_INFO("lv_deinit done");
@@ -305,13 +446,20 @@ lv_obj_t * lv_obj_create(lv_obj_t * parent, const lv_obj_t * copy)
         LV_LOG_TRACE("Object create started");
         LV_ASSERT_OBJ(parent, LV_OBJX_NAME);
 
+#if LV_USE_OBJ_COMPACT
+        new_obj = lv_mem_alloc(sizeof(lv_obj_t));
+#else
         new_obj = _lv_ll_ins_head(&parent->child_ll);
+#endif
         LV_ASSERT_MEM(new_obj);
         if(new_obj == NULL) return NULL;
 
         _lv_memset_00(new_obj, sizeof(lv_obj_t));
 
         new_obj->parent = parent;
+#if LV_USE_OBJ_COMPACT
+        child_link(parent, new_obj, true);
+#endif
 
 #if LV_USE_BIDI
         new_obj->base_dir     = LV_BIDI_DIR_INHERIT;
@@ -336,11 +484,14 @@ lv_obj_t * lv_obj_create(lv_obj_t * parent, const lv_obj_t * copy)
         }
     }
 
+    /*With `LV_USE_OBJ_COMPACT` the children and the rarely used attributes are already cleared above*/
+#if LV_USE_OBJ_COMPACT == 0
     _lv_ll_init(&(new_obj->child_ll), sizeof(lv_obj_t));
+#endif
 
     new_obj->ext_draw_pad = 0;
 
-#if LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_FULL
+#if LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_FULL && LV_USE_OBJ_COMPACT == 0
     _lv_memset_00(&new_obj->ext_click_pad, sizeof(new_obj->ext_click_pad));
 #elif LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_TINY
     new_obj->ext_click_pad_hor = 0;
@@ -348,7 +499,7 @@ lv_obj_t * lv_obj_create(lv_obj_t * parent, const lv_obj_t * copy)
 #endif
 
     /*Init realign*/
-#if LV_USE_OBJ_REALIGN
+#if LV_USE_OBJ_REALIGN && LV_USE_OBJ_COMPACT == 0
     new_obj->realign.align        = LV_ALIGN_CENTER;
     new_obj->realign.xofs         = 0;
     new_obj->realign.yofs         = 0;
@@ -357,11 +508,11 @@ lv_obj_t * lv_obj_create(lv_obj_t * parent, const lv_obj_t * copy)
 #endif
 
     /*Init. user date*/
-#if LV_USE_USER_DATA
+#if LV_USE_USER_DATA && LV_USE_OBJ_COMPACT == 0
     _lv_memset_00(&new_obj->user_data, sizeof(lv_obj_user_data_t));
 #endif
 
-#if LV_USE_GROUP
+#if LV_USE_GROUP && LV_USE_OBJ_COMPACT == 0
     new_obj->group_p = NULL;
 #endif
 
@@ -395,7 +546,7 @@ lv_obj_t * lv_obj_create(lv_obj_t * parent, const lv_obj_t * copy)
         lv_area_copy(&new_obj->coords, &copy->coords);
         new_obj->ext_draw_pad = copy->ext_draw_pad;
 
-#if LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_FULL
+#if LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_FULL && LV_USE_OBJ_COMPACT == 0
         lv_area_copy(&new_obj->ext_click_pad, &copy->ext_click_pad);
 #elif LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_TINY
         new_obj->ext_click_pad_hor = copy->ext_click_pad_hor;
@@ -403,14 +554,27 @@ lv_obj_t * lv_obj_create(lv_obj_t * parent, const lv_obj_t * copy)
 #endif
 
         /*Set user data*/
-#if LV_USE_USER_DATA
+#if LV_USE_USER_DATA && LV_USE_OBJ_COMPACT == 0
         _lv_memcpy(&new_obj->user_data, &copy->user_data, sizeof(lv_obj_user_data_t));
 #endif
 
         new_obj->base_dir = copy->base_dir;
 
+#if _LV_OBJ_SPEC_ATTR
+        /*Copy the rarely used attributes. The group will be set by `lv_group_add_obj`*/
+        if(copy->spec_attr) {
+            lv_obj_spec_attr_t * attr = spec_attr_get(new_obj);
+            if(attr) {
+                _lv_memcpy(attr, copy->spec_attr, sizeof(lv_obj_spec_attr_t));
+#if LV_USE_GROUP
+                attr->group_p = NULL;
+#endif
+            }
+        }
+#endif
+
         /*Copy realign*/
-#if LV_USE_OBJ_REALIGN
+#if LV_USE_OBJ_REALIGN && LV_USE_OBJ_COMPACT == 0
         new_obj->realign.align        = copy->realign.align;
         new_obj->realign.xofs         = copy->realign.xofs;
         new_obj->realign.yofs         = copy->realign.yofs;
@@ -439,8 +603,9 @@ lv_obj_t * lv_obj_create(lv_obj_t * parent, const lv_obj_t * copy)
 
 #if LV_USE_GROUP
         /*Add to the same group*/
-        if(copy->group_p != NULL) {
-            lv_group_add_obj(copy->group_p, new_obj);
+        lv_group_t * group = lv_obj_get_group(copy);
+        if(group != NULL) {
+            lv_group_add_obj(group, new_obj);
         }
 #endif
 
@@ -521,17 +686,75 @@ void lv_obj_del_async(lv_obj_t * obj)
 }
 
 /**
- * Delete all children of an object
+ * Delete all children of an object.
+ * The object is invalidated and gets `LV_SIGNAL_CHILD_CHG` only once.
  * @param obj pointer to an object
  */
 void lv_obj_clean(lv_obj_t * obj)
 {
     LV_ASSERT_OBJ(obj, LV_OBJX_NAME);
     lv_obj_t * child = lv_obj_get_child(obj, NULL);
+    if(child == NULL) return;
+
+    bool suspended = layout_suspend_find(obj) >= 0;
+    if(!suspended) lv_obj_suspend_layout(obj);
+
     while(child) {
         lv_obj_del(child);
         child = lv_obj_get_child(obj, NULL);    /*Get the new first child*/
     }
+
+    if(!suspended) lv_obj_resume_layout(obj);
+}
+
+/**
+ * Suspend the layout of an object and its children, e.g. to create or delete many children.
+ * Until `lv_obj_resume_layout()` the objects don't get `LV_SIGNAL_CHILD_CHG`
+ * and the children are not invalidated. So the position and size of the children might be not up to date.
+ * At most 8 objects can be suspended at the same time.
+ * @param obj pointer to an object
+ */
+void lv_obj_suspend_layout(lv_obj_t * obj)
+{
+    LV_ASSERT_OBJ(obj, LV_OBJX_NAME);
+
+    if(layout_suspend_find(obj) >= 0) return;
+    if(layout_suspend_cnt >= LAYOUT_SUSPEND_MAX) {
+        LV_LOG_WARN("lv_obj_suspend_layout: too many suspended objects");
+        return;
+    }
+
+    layout_suspend_objs[layout_suspend_cnt] = obj;
+    layout_suspend_cnt++;
+}
+
+/**
+ * Resume the layout of an object suspended by `lv_obj_suspend_layout()`.
+ * The objects which got new or deleted children get one `LV_SIGNAL_CHILD_CHG` (the children first)
+ * and the object is invalidated.
+ * @param obj pointer to an object
+ */
+void lv_obj_resume_layout(lv_obj_t * obj)
+{
+    LV_ASSERT_OBJ(obj, LV_OBJX_NAME);
+
+    int32_t idx = layout_suspend_find(obj);
+    if(idx < 0) return;
+
+    /*If an ancestor is still suspended it will send the signals*/
+    if(obj->parent == NULL || layout_is_suspended(obj->parent) == false) {
+        /*The signals might postpone new signals (e.g. a child's size changed by its layout) so repeat*/
+        while(layout_flush(obj));
+    }
+
+    /*The signals might have suspended or resumed other objects, even this one*/
+    idx = layout_suspend_find(obj);
+    if(idx < 0) return;
+
+    layout_suspend_cnt--;
+    layout_suspend_objs[idx] = layout_suspend_objs[layout_suspend_cnt];
+
+    lv_obj_invalidate(obj);
 }
 
 /**
@@ -544,6 +767,9 @@ void lv_obj_invalidate_area(const lv_obj_t * obj, const lv_area_t * area)
 {
     LV_ASSERT_OBJ(obj, LV_OBJX_NAME);
 
+    /*The suspended ancestor will be invalidated when its layout is resumed*/
+    if(obj->parent && layout_is_suspended(obj->parent)) return;
+
     lv_area_t area_tmp;
     lv_area_copy(&area_tmp, area);
     bool visible = lv_obj_area_is_visible(obj, &area_tmp);
@@ -682,9 +908,17 @@ void lv_obj_set_parent(lv_obj_t * obj, lv_obj_t * parent)
         old_pos.x = old_par->coords.x2 - obj->coords.x2;
     }
 
+#if LV_USE_OBJ_COMPACT
+    child_unlink(old_par, obj);
+    child_link(parent, obj, true);
+#else
     _lv_ll_chg_list(&obj->parent->child_ll, &parent->child_ll, obj, true);
+#endif
     obj->parent = parent;
 
+    /*The inherited style properties might be different*/
+    style_cache_invalidate_obj(obj, LV_OBJ_PART_ALL, true);
+
     if(new_base_dir != LV_BIDI_DIR_RTL) {
         lv_obj_set_pos(obj, old_pos.x, old_pos.y);
     }
@@ -714,11 +948,16 @@ void lv_obj_move_foreground(lv_obj_t * obj)
     lv_obj_t * parent = lv_obj_get_parent(obj);
 
     /*Do nothing of already in the foreground*/
-    if(_lv_ll_get_head(&parent->child_ll) == obj) return;
+    if(_lv_obj_get_child_next(parent, NULL) == obj) return;
 
     lv_obj_invalidate(parent);
 
+#if LV_USE_OBJ_COMPACT
+    child_unlink(parent, obj);
+    child_link(parent, obj, true);
+#else
     _lv_ll_chg_list(&parent->child_ll, &parent->child_ll, obj, true);
+#endif
 
     /*Notify the new parent about the child*/
     parent->signal_cb(parent, LV_SIGNAL_CHILD_CHG, obj);
@@ -737,11 +976,16 @@ void lv_obj_move_background(lv_obj_t * obj)
     lv_obj_t * parent = lv_obj_get_parent(obj);
 
     /*Do nothing of already in the background*/
-    if(_lv_ll_get_tail(&parent->child_ll) == obj) return;
+    if(_lv_obj_get_child_prev(parent, NULL) == obj) return;
 
     lv_obj_invalidate(parent);
 
+#if LV_USE_OBJ_COMPACT
+    child_unlink(parent, obj);
+    child_link(parent, obj, false);
+#else
     _lv_ll_chg_list(&parent->child_ll, &parent->child_ll, obj, false);
+#endif
 
     /*Notify the new parent about the child*/
     parent->signal_cb(parent, LV_SIGNAL_CHILD_CHG, obj);
@@ -871,7 +1115,7 @@ void lv_obj_set_size(lv_obj_t * obj, lv_coord_t w, lv_coord_t h)
 
     /*Tell the children the parent's size has changed*/
     lv_obj_t * i;
-    _LV_LL_READ(obj->child_ll, i) {
+    _LV_OBJ_CHILD_READ(obj, i) {
         i->signal_cb(i, LV_SIGNAL_PARENT_SIZE_CHG,  &ori);
     }
 
@@ -880,7 +1124,7 @@ void lv_obj_set_size(lv_obj_t * obj, lv_coord_t w, lv_coord_t h)
 
     /*Automatically realign the object if required*/
 #if LV_USE_OBJ_REALIGN
-    if(obj->realign.auto_realign) lv_obj_realign(obj);
+    if(lv_obj_get_auto_realign(obj)) lv_obj_realign(obj);
 #endif
 }
 
@@ -982,11 +1226,13 @@ void lv_obj_align(lv_obj_t * obj, const lv_obj_t * base, lv_align_t align, lv_co
 
 #if LV_USE_OBJ_REALIGN
     /*Save the last align parameters to use them in `lv_obj_realign`*/
-    obj->realign.align       = align;
-    obj->realign.xofs        = x_ofs;
-    obj->realign.yofs        = y_ofs;
-    obj->realign.base        = base;
-    obj->realign.mid_align = 0;
+    lv_realign_t * realign = realign_get(obj, true);
+    if(realign == NULL) return;
+    realign->align       = align;
+    realign->xofs        = x_ofs;
+    realign->yofs        = y_ofs;
+    realign->base        = base;
+    realign->mid_align = 0;
 #endif
 }
 
@@ -1048,11 +1294,13 @@ void lv_obj_align_mid(lv_obj_t * obj, const lv_obj_t * base, lv_align_t align, l
 
 #if LV_USE_OBJ_REALIGN
     /*Save the last align parameters to use them in `lv_obj_realign`*/
-    obj->realign.align       = align;
-    obj->realign.xofs        = x_ofs;
-    obj->realign.yofs        = y_ofs;
-    obj->realign.base        = base;
-    obj->realign.mid_align = 1;
+    lv_realign_t * realign = realign_get(obj, true);
+    if(realign == NULL) return;
+    realign->align       = align;
+    realign->xofs        = x_ofs;
+    realign->yofs        = y_ofs;
+    realign->base        = base;
+    realign->mid_align = 1;
 #endif
 }
 
@@ -1105,10 +1353,15 @@ void lv_obj_realign(lv_obj_t * obj)
     LV_ASSERT_OBJ(obj, LV_OBJX_NAME);
 
 #if LV_USE_OBJ_REALIGN
-    if(obj->realign.mid_align)
-        lv_obj_align_mid(obj, obj->realign.base, obj->realign.align, obj->realign.xofs, obj->realign.yofs);
+    lv_realign_t * realign = realign_get(obj, true);
+    if(realign == NULL) return;
+
+    /*Copy the parameters because they are overwritten while aligning*/
+    lv_realign_t realign_tmp = *realign;
+    if(realign_tmp.mid_align)
+        lv_obj_align_mid(obj, realign_tmp.base, realign_tmp.align, realign_tmp.xofs, realign_tmp.yofs);
     else
-        lv_obj_align(obj, obj->realign.base, obj->realign.align, obj->realign.xofs, obj->realign.yofs);
+        lv_obj_align(obj, realign_tmp.base, realign_tmp.align, realign_tmp.xofs, realign_tmp.yofs);
 #else
     (void)obj;
     LV_LOG_WARN("lv_obj_realign: no effect because LV_USE_OBJ_REALIGN = 0");
@@ -1126,7 +1379,8 @@ void lv_obj_set_auto_realign(lv_obj_t * obj, bool en)
     LV_ASSERT_OBJ(obj, LV_OBJX_NAME);
 
 #if LV_USE_OBJ_REALIGN
-    obj->realign.auto_realign = en ? 1 : 0;
+    lv_realign_t * realign = realign_get(obj, en);
+    if(realign) realign->auto_realign = en ? 1 : 0;
 #else
     (void)obj;
     (void)en;
@@ -1149,10 +1403,17 @@ void lv_obj_set_ext_click_area(lv_obj_t * obj, lv_coord_t left, lv_coord_t right
     LV_ASSERT_OBJ(obj, LV_OBJX_NAME);
 
 #if LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_FULL
-    obj->ext_click_pad.x1 = left;
-    obj->ext_click_pad.x2 = right;
-    obj->ext_click_pad.y1 = top;
-    obj->ext_click_pad.y2 = bottom;
+#if LV_USE_OBJ_COMPACT
+    lv_obj_spec_attr_t * attr = spec_attr_get(obj);
+    if(attr == NULL) return;
+    lv_area_t * pad = &attr->ext_click_pad;
+#else
+    lv_area_t * pad = &obj->ext_click_pad;
+#endif
+    pad->x1 = left;
+    pad->x2 = right;
+    pad->y1 = top;
+    pad->y2 = bottom;
 #elif LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_TINY
     obj->ext_click_pad_hor = LV_MATH_MAX(left, right);
     obj->ext_click_pad_ver = LV_MATH_MAX(top, bottom);
@@ -1176,7 +1437,7 @@ void lv_obj_set_ext_click_area(lv_obj_t * obj, lv_coord_t left, lv_coord_t right
  * E.g. `LV_OBJ_PART_MAIN`, `LV_BTN_PART_MAIN`, `LV_SLIDER_PART_KNOB`
  * @param style pointer to a style to add (Only its pointer will be saved)
  */
-void lv_obj_add_style(lv_obj_t * obj, uint8_t part, lv_style_t * style)
+void lv_obj_add_style(lv_obj_t * obj, uint8_t part, const lv_style_t * style)
 {
     if(style == NULL) return;
 
@@ -1200,7 +1461,7 @@ void lv_obj_add_style(lv_obj_t * obj, uint8_t part, lv_style_t * style)
  * E.g. `LV_OBJ_PART_MAIN`, `LV_BTN_PART_MAIN`, `LV_SLIDER_PART_KNOB`
  * @param style pointer to a style to remove
  */
-void lv_obj_remove_style(lv_obj_t * obj, uint8_t part, lv_style_t * style)
+void lv_obj_remove_style(lv_obj_t * obj, uint8_t part, const lv_style_t * style)
 {
     if(style == NULL) return;
 
@@ -1237,6 +1498,7 @@ void lv_obj_clean_style_list(lv_obj_t * obj, uint8_t part)
 #if LV_USE_ANIMATION
     trans_del(obj, part, 0xFF, NULL);
 #endif
+    style_cache_invalidate_obj(obj, part, true);
 }
 
 /**
@@ -1371,52 +1633,10 @@ void lv_obj_refresh_style(lv_obj_t * obj, uint8_t part, lv_style_property_t prop
 {
     LV_ASSERT_OBJ(obj, LV_OBJX_NAME);
 
-    invalidate_style_cache(obj, part, prop);
+    invalidate_style_cache(obj, part, style_prop_is_cacheble(prop), style_prop_is_inherited(prop));
 
     /*If a real style refresh is required*/
-    bool real_refr = false;
-    switch(prop) {
-        case LV_STYLE_PROP_ALL:
-        case LV_STYLE_CLIP_CORNER:
-        case LV_STYLE_SIZE:
-        case LV_STYLE_TRANSFORM_WIDTH:
-        case LV_STYLE_TRANSFORM_HEIGHT:
-        case LV_STYLE_TRANSFORM_ANGLE:
-        case LV_STYLE_TRANSFORM_ZOOM:
-        case LV_STYLE_PAD_TOP:
-        case LV_STYLE_PAD_BOTTOM:
-        case LV_STYLE_PAD_LEFT:
-        case LV_STYLE_PAD_RIGHT:
-        case LV_STYLE_PAD_INNER:
-        case LV_STYLE_MARGIN_TOP:
-        case LV_STYLE_MARGIN_BOTTOM:
-        case LV_STYLE_MARGIN_LEFT:
-        case LV_STYLE_MARGIN_RIGHT:
-        case LV_STYLE_OUTLINE_WIDTH:
-        case LV_STYLE_OUTLINE_PAD:
-        case LV_STYLE_OUTLINE_OPA:
-        case LV_STYLE_SHADOW_WIDTH:
-        case LV_STYLE_SHADOW_OPA:
-        case LV_STYLE_SHADOW_OFS_X:
-        case LV_STYLE_SHADOW_OFS_Y:
-        case LV_STYLE_SHADOW_SPREAD:
-        case LV_STYLE_VALUE_LETTER_SPACE:
-        case LV_STYLE_VALUE_LINE_SPACE:
-        case LV_STYLE_VALUE_OFS_X:
-        case LV_STYLE_VALUE_OFS_Y:
-        case LV_STYLE_VALUE_ALIGN:
-        case LV_STYLE_VALUE_STR:
-        case LV_STYLE_VALUE_FONT:
-        case LV_STYLE_VALUE_OPA:
-        case LV_STYLE_TEXT_LETTER_SPACE:
-        case LV_STYLE_TEXT_LINE_SPACE:
-        case LV_STYLE_TEXT_FONT:
-        case LV_STYLE_LINE_WIDTH:
-            real_refr = true;
-            break;
-        default:
-            real_refr = false;
-    }
+    bool real_refr = style_prop_needs_refr(prop);
 
     if(real_refr) {
         lv_obj_invalidate(obj);
@@ -1449,6 +1669,9 @@ void lv_obj_refresh_style(lv_obj_t * obj, uint8_t part, lv_style_property_t prop
  */
 void lv_obj_report_style_mod(lv_style_t * style)
 {
+    /*All objects are refreshed so it's faster to drop the whole style cache at once*/
+    if(style == NULL) style_cache_invalidate();
+
     lv_disp_t * d = lv_disp_get_next(NULL);
 
     while(d) {
@@ -1464,6 +1687,7 @@ void lv_obj_report_style_mod(lv_style_t * style)
  * Enable/disable the use of style cache for an object
  * @param obj pointer to an object
  * @param dis true: disable; false: enable (re-enable)
+ * @note while disabled the object's state can be changed temporarily to get its style properties in other states
  */
 void _lv_obj_disable_style_caching(lv_obj_t * obj, bool dis)
 {
@@ -1480,6 +1704,23 @@ void _lv_obj_disable_style_caching(lv_obj_t * obj, bool dis)
     }
 }
 
+/**
+ * Get the statistics of the style cache
+ * @param stats store the statistics here
+ */
+void lv_obj_get_style_cache_stats(lv_style_cache_stats_t * stats)
+{
+    *stats = style_cache_stats;
+}
+
+/**
+ * Reset the counters of the style cache
+ */
+void lv_obj_reset_style_cache_stats(void)
+{
+    _lv_memset_00(&style_cache_stats, sizeof(lv_style_cache_stats_t));
+}
+
 /*-----------------
  * Attribute set
  *----------------*/
@@ -1726,6 +1967,9 @@ void lv_obj_set_state(lv_obj_t * obj, lv_state_t new_state)
 
     obj->state = new_state;
 
+    /*The children might inherit properties from the new state*/
+    style_cache_invalidate_obj(obj, LV_OBJ_PART_ALL, true);
+
     if(cmp_res == STYLE_COMPARE_SAME) {
         return;
     }
@@ -1735,6 +1979,11 @@ void lv_obj_set_state(lv_obj_t * obj, lv_state_t new_state)
     else if(cmp_res == STYLE_COMPARE_VISUAL_DIFF) lv_obj_refresh_style(obj, LV_OBJ_PART_ALL, LV_STYLE_PROP_ALL);
 #else
 
+    /*The transitions get the properties in the previous state and without the transition style.
+     *Don't let the style cache see them.*/
+    bool cache_ori = obj->style_list.ignore_cache;
+    obj->style_list.ignore_cache = 1;
+
     for(part = 0; part < _LV_OBJ_PART_REAL_LAST; part++) {
         lv_style_list_t * style_list = lv_obj_get_style_list(obj, part);
         if(style_list == NULL) break;   /*No more style lists*/
@@ -1751,42 +2000,31 @@ void lv_obj_set_state(lv_obj_t * obj, lv_state_t new_state)
         props[4] = lv_obj_get_style_transition_prop_5(obj, part);
         props[5] = lv_obj_get_style_transition_prop_6(obj, part);
 
-        uint8_t i;
-        for(i = 0; i < LV_STYLE_TRANS_NUM_MAX; i++) {
-            if(props[i] != 0) {
-                _lv_style_list_add_trans_style(style_list);
-
-                lv_style_trans_t * tr = trans_create(obj, props[i], part, prev_state, new_state);
-
-                /*If there is a pending anim for this property remove it*/
-                if(tr) {
-                    tr->obj = obj;
-                    tr->prop = props[i];
-                    tr->part = part;
-
-                    lv_anim_t a;
-                    lv_anim_init(&a);
-                    lv_anim_set_var(&a, tr);
-                    lv_anim_set_exec_cb(&a, (lv_anim_exec_xcb_t)trans_anim_cb);
-                    lv_anim_set_start_cb(&a, trans_anim_start_cb);
-                    lv_anim_set_ready_cb(&a, trans_anim_ready_cb);
-                    lv_anim_set_values(&a, 0x00, 0xFF);
-                    lv_anim_set_time(&a, time);
-                    lv_anim_set_delay(&a, delay);
-                    lv_anim_set_path(&a, path);
-                    a.early_apply = 0;
-                    lv_anim_start(&a);
-                }
-
-            }
+        /*One animation for all the changed properties of the part*/
+        lv_style_trans_t * tr = trans_create(obj, part, props, prev_state, new_state);
+        if(tr) {
+            lv_anim_t a;
+            lv_anim_init(&a);
+            lv_anim_set_var(&a, tr);
+            lv_anim_set_exec_cb(&a, (lv_anim_exec_xcb_t)trans_anim_cb);
+            lv_anim_set_start_cb(&a, trans_anim_start_cb);
+            lv_anim_set_ready_cb(&a, trans_anim_ready_cb);
+            lv_anim_set_values(&a, 0x00, 0xFF);
+            lv_anim_set_time(&a, time);
+            lv_anim_set_delay(&a, delay);
+            lv_anim_set_path(&a, path);
+            a.early_apply = 0;
+            lv_anim_start(&a);
         }
         if(cmp_res == STYLE_COMPARE_DIFF) lv_obj_refresh_style(obj, part, LV_STYLE_PROP_ALL);
 
         if(cmp_res == STYLE_COMPARE_VISUAL_DIFF) {
-            invalidate_style_cache(obj, part, LV_STYLE_PROP_ALL);
+            invalidate_style_cache(obj, part, true, true);
         }
     }
 
+    obj->style_list.ignore_cache = cache_ori;
+
     if(cmp_res == STYLE_COMPARE_VISUAL_DIFF) {
         lv_obj_invalidate(obj);
     }
@@ -2054,6 +2292,10 @@ void * lv_obj_allocate_ext_attr(lv_obj_t * obj, uint16_t ext_size)
 {
     LV_ASSERT_OBJ(obj, LV_OBJX_NAME);
 
+    /*The objects of a type are created many times so allocate their `ext_attr` in its own slab size class.
+     *It's added again after `lv_deinit()` and `lv_init()` and costs only a lookup if it exists.*/
+    _lv_mem_slab_add(ext_size);
+
     void * new_ext = lv_mem_realloc(obj->ext_attr, ext_size);
     if(new_ext == NULL) return NULL;
 
@@ -2154,16 +2396,7 @@ lv_obj_t * lv_obj_get_child(const lv_obj_t * obj, const lv_obj_t * child)
 {
     LV_ASSERT_OBJ(obj, LV_OBJX_NAME);
 
-    lv_obj_t * result = NULL;
-
-    if(child == NULL) {
-        result = _lv_ll_get_head(&obj->child_ll);
-    }
-    else {
-        result = _lv_ll_get_next(&obj->child_ll, child);
-    }
-
-    return result;
+    return _lv_obj_get_child_next(obj, child);
 }
 
 /**
@@ -2177,16 +2410,7 @@ lv_obj_t * lv_obj_get_child_back(const lv_obj_t * obj, const lv_obj_t * child)
 {
     LV_ASSERT_OBJ(obj, LV_OBJX_NAME);
 
-    lv_obj_t * result = NULL;
-
-    if(child == NULL) {
-        result = _lv_ll_get_tail(&obj->child_ll);
-    }
-    else {
-        result = _lv_ll_get_prev(&obj->child_ll, child);
-    }
-
-    return result;
+    return _lv_obj_get_child_prev(obj, child);
 }
 
 /**
@@ -2201,7 +2425,7 @@ uint16_t lv_obj_count_children(const lv_obj_t * obj)
     lv_obj_t * i;
     uint16_t cnt = 0;
 
-    _LV_LL_READ(obj->child_ll, i) cnt++;
+    _LV_OBJ_CHILD_READ(obj, i) cnt++;
 
     return cnt;
 }
@@ -2217,7 +2441,7 @@ uint16_t lv_obj_count_children_recursive(const lv_obj_t * obj)
     lv_obj_t * i;
     uint16_t cnt = 0;
 
-    _LV_LL_READ(obj->child_ll, i) {
+    _LV_OBJ_CHILD_READ(obj, i) {
         cnt++;                                     /*Count the child*/
         cnt += lv_obj_count_children_recursive(i); /*recursively count children's children*/
     }
@@ -2436,7 +2660,8 @@ bool lv_obj_get_auto_realign(const lv_obj_t * obj)
     LV_ASSERT_OBJ(obj, LV_OBJX_NAME);
 
 #if LV_USE_OBJ_REALIGN
-    return obj->realign.auto_realign ? true : false;
+    const lv_realign_t * realign = realign_get(obj, false);
+    return realign && realign->auto_realign ? true : false;
 #else
     (void)obj;
     return false;
@@ -2455,7 +2680,7 @@ lv_coord_t lv_obj_get_ext_click_pad_left(const lv_obj_t * obj)
 #if LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_TINY
     return obj->ext_click_pad_hor;
 #elif LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_FULL
-    return obj->ext_click_pad.x1;
+    return ext_click_pad_get(obj)->x1;
 #else
     (void)obj;    /*Unused*/
     return 0;
@@ -2474,7 +2699,7 @@ lv_coord_t lv_obj_get_ext_click_pad_right(const lv_obj_t * obj)
 #if LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_TINY
     return obj->ext_click_pad_hor;
 #elif LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_FULL
-    return obj->ext_click_pad.x2;
+    return ext_click_pad_get(obj)->x2;
 #else
     (void)obj; /*Unused*/
     return 0;
@@ -2493,7 +2718,7 @@ lv_coord_t lv_obj_get_ext_click_pad_top(const lv_obj_t * obj)
 #if LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_TINY
     return obj->ext_click_pad_ver;
 #elif LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_FULL
-    return obj->ext_click_pad.y1;
+    return ext_click_pad_get(obj)->y1;
 #else
     (void)obj; /*Unused*/
     return 0;
@@ -2512,7 +2737,7 @@ lv_coord_t lv_obj_get_ext_click_pad_bottom(const lv_obj_t * obj)
 #if LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_TINY
     return obj->ext_click_pad_ver;
 #elif LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_FULL
-    return obj->ext_click_pad.y2;
+    return ext_click_pad_get(obj)->y2;
 #else
     (void)obj; /*Unused*/
     return 0;
@@ -2567,176 +2792,67 @@ lv_style_list_t * lv_obj_get_style_list(const lv_obj_t * obj, uint8_t part)
  */
 lv_style_int_t _lv_obj_get_style_int(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop)
 {
-    lv_style_property_t prop_ori = prop;
-
-    lv_style_attr_t attr;
-    attr = prop_ori >> 8;
-
-    lv_style_int_t value_act;
-    lv_res_t res = LV_RES_INV;
-    const lv_obj_t * parent = obj;
-    while(parent) {
-        lv_style_list_t * list = lv_obj_get_style_list(parent, part);
-        if(!list->ignore_cache && list->style_cnt > 0) {
-            if(!list->valid_cache) update_style_cache((lv_obj_t *)parent, part, prop  & (~LV_STYLE_STATE_MASK));
+    style_cache_stats.lookup_cnt++;
+
+#if LV_STYLE_CACHE_SIZE
+    uint8_t idx = STYLE_CACHE_IDX(prop);
+    style_cache_t * cache = idx != STYLE_CACHE_NONE ? style_cache_get(obj, part) : NULL;
+    if(cache) {
+        uint8_t bit = STYLE_CACHE_INT_BIT + idx;
+        if(STYLE_CACHE_IS_RESOLVED(cache, bit)) return cache->ints[idx];
+
+        uint32_t gen = style_cache_gen;
+        lv_style_int_t value = get_style_int(obj, part, prop);
+        /*Getting the value might have reused the entry for an other object*/
+        if(style_cache_is_for(cache, obj, part, gen)) {
+            cache->ints[idx] = value;
+            STYLE_CACHE_SET_RESOLVED(cache, bit);
+        }
+        return value;
+    }
+#endif
 
-            bool def = false;
-            switch(prop  & (~LV_STYLE_STATE_MASK)) {
-                case LV_STYLE_CLIP_CORNER:
-                    if(list->clip_corner_off) def = true;
-                    break;
-                case LV_STYLE_TEXT_LETTER_SPACE:
-                case LV_STYLE_TEXT_LINE_SPACE:
-                    if(list->text_space_zero) def = true;
-                    break;
-                case LV_STYLE_TRANSFORM_ANGLE:
-                case LV_STYLE_TRANSFORM_WIDTH:
-                case LV_STYLE_TRANSFORM_HEIGHT:
-                case LV_STYLE_TRANSFORM_ZOOM:
-                    if(list->transform_all_zero) def = true;
-                    break;
-                case LV_STYLE_BORDER_WIDTH:
-                    if(list->border_width_zero) def = true;
-                    break;
-                case LV_STYLE_BORDER_SIDE:
-                    if(list->border_side_full) def = true;
-                    break;
-                case LV_STYLE_BORDER_POST:
-                    if(list->border_post_off) def = true;
-                    break;
-                case LV_STYLE_OUTLINE_WIDTH:
-                    if(list->outline_width_zero) def = true;
-                    break;
-                case LV_STYLE_RADIUS:
-                    if(list->radius_zero) def = true;
-                    break;
-                case LV_STYLE_SHADOW_WIDTH:
-                    if(list->shadow_width_zero) def = true;
-                    break;
-                case LV_STYLE_PAD_TOP:
-                case LV_STYLE_PAD_BOTTOM:
-                case LV_STYLE_PAD_LEFT:
-                case LV_STYLE_PAD_RIGHT:
-                    if(list->pad_all_zero) def = true;
-                    break;
-                case LV_STYLE_MARGIN_TOP:
-                case LV_STYLE_MARGIN_BOTTOM:
-                case LV_STYLE_MARGIN_LEFT:
-                case LV_STYLE_MARGIN_RIGHT:
-                    if(list->margin_all_zero) def = true;
-                    break;
-                case LV_STYLE_BG_BLEND_MODE:
-                case LV_STYLE_BORDER_BLEND_MODE:
-                case LV_STYLE_IMAGE_BLEND_MODE:
-                case LV_STYLE_LINE_BLEND_MODE:
-                case LV_STYLE_OUTLINE_BLEND_MODE:
-                case LV_STYLE_PATTERN_BLEND_MODE:
-                case LV_STYLE_SHADOW_BLEND_MODE:
-                case LV_STYLE_TEXT_BLEND_MODE:
-                case LV_STYLE_VALUE_BLEND_MODE:
-                    if(list->blend_mode_all_normal) def = true;
-                    break;
-                case LV_STYLE_TEXT_DECOR:
-                    if(list->text_decor_none) def = true;
-                    break;
-            }
+    return get_style_int(obj, part, prop);
+}
 
-            if(def) {
-                break;
-            }
+/**
+ * Get a style property of a part of an object in the object's current state.
+ * If there is a running transitions it is taken into account
+ * @param obj pointer to an object
+ * @param part the part of the object which style property should be get.
+ * E.g. `LV_OBJ_PART_MAIN`, `LV_BTN_PART_MAIN`, `LV_SLIDER_PART_KNOB`
+ * @param prop the property to get. E.g. `LV_STYLE_BORDER_COLOR`.
+ *  The state of the object will be added internally
+ * @return the value of the property of the given part in the current state.
+ * If the property is not found a default value will be returned.
+ * @note shouldn't be used directly. Use the specific property get functions instead.
+ *       For example: `lv_obj_style_get_border_color()`
+ * @note for performance reasons it's not checked if the property really has color type
+ */
+lv_color_t _lv_obj_get_style_color(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop)
+{
+    style_cache_stats.lookup_cnt++;
+
+#if LV_STYLE_CACHE_SIZE
+    uint8_t idx = STYLE_CACHE_IDX(prop);
+    style_cache_t * cache = idx != STYLE_CACHE_NONE ? style_cache_get(obj, part) : NULL;
+    if(cache) {
+        uint8_t bit = STYLE_CACHE_COLOR_BIT + idx;
+        if(STYLE_CACHE_IS_RESOLVED(cache, bit)) return cache->colors[idx];
+
+        uint32_t gen = style_cache_gen;
+        lv_color_t value = get_style_color(obj, part, prop);
+        /*Getting the value might have reused the entry for an other object*/
+        if(style_cache_is_for(cache, obj, part, gen)) {
+            cache->colors[idx] = value;
+            STYLE_CACHE_SET_RESOLVED(cache, bit);
         }
+        return value;
+    }
+#endif
 
-        lv_state_t state = lv_obj_get_state(parent, part);
-        prop = (uint16_t)prop_ori + ((uint16_t)state << LV_STYLE_STATE_POS);
-
-        res = _lv_style_list_get_int(list, prop, &value_act);
-        if(res == LV_RES_OK) return value_act;
-
-        if(LV_STYLE_ATTR_GET_INHERIT(attr) == 0) break;
-
-        /*If not found, check the `MAIN` style first*/
-        if(part != LV_OBJ_PART_MAIN) {
-            part = LV_OBJ_PART_MAIN;
-            continue;
-        }
-
-        /*Check the parent too.*/
-        parent = lv_obj_get_parent(parent);
-    }
-
-    /*Handle unset values*/
-    prop = prop & (~LV_STYLE_STATE_MASK);
-    switch(prop) {
-        case LV_STYLE_BORDER_SIDE:
-            return LV_BORDER_SIDE_FULL;
-        case LV_STYLE_SIZE:
-            return LV_DPI / 20;
-        case LV_STYLE_SCALE_WIDTH:
-            return LV_DPI / 8;
-        case LV_STYLE_BG_GRAD_STOP:
-            return 255;
-        case LV_STYLE_TRANSFORM_ZOOM:
-            return LV_IMG_ZOOM_NONE;
-    }
-
-    return 0;
-}
-
-/**
- * Get a style property of a part of an object in the object's current state.
- * If there is a running transitions it is taken into account
- * @param obj pointer to an object
- * @param part the part of the object which style property should be get.
- * E.g. `LV_OBJ_PART_MAIN`, `LV_BTN_PART_MAIN`, `LV_SLIDER_PART_KNOB`
- * @param prop the property to get. E.g. `LV_STYLE_BORDER_COLOR`.
- *  The state of the object will be added internally
- * @return the value of the property of the given part in the current state.
- * If the property is not found a default value will be returned.
- * @note shouldn't be used directly. Use the specific property get functions instead.
- *       For example: `lv_obj_style_get_border_color()`
- * @note for performance reasons it's not checked if the property really has color type
- */
-lv_color_t _lv_obj_get_style_color(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop)
-{
-    lv_style_property_t prop_ori = prop;
-
-    lv_style_attr_t attr;
-    attr = prop_ori >> 8;
-
-    lv_color_t value_act;
-    lv_res_t res = LV_RES_INV;
-    const lv_obj_t * parent = obj;
-    while(parent) {
-        lv_style_list_t * list = lv_obj_get_style_list(parent, part);
-
-        lv_state_t state = lv_obj_get_state(parent, part);
-        prop = (uint16_t)prop_ori + ((uint16_t)state << LV_STYLE_STATE_POS);
-
-        res = _lv_style_list_get_color(list, prop, &value_act);
-        if(res == LV_RES_OK) return value_act;
-
-        if(LV_STYLE_ATTR_GET_INHERIT(attr) == 0) break;
-
-        /*If not found, check the `MAIN` style first*/
-        if(part != LV_OBJ_PART_MAIN) {
-            part = LV_OBJ_PART_MAIN;
-            continue;
-        }
-
-        /*Check the parent too.*/
-        parent = lv_obj_get_parent(parent);
-    }
-
-    /*Handle unset values*/
-    prop = prop & (~LV_STYLE_STATE_MASK);
-    switch(prop) {
-        case LV_STYLE_BG_COLOR:
-        case LV_STYLE_BG_GRAD_COLOR:
-            return LV_COLOR_WHITE;
-    }
-
-    return LV_COLOR_BLACK;
-}
+    return get_style_color(obj, part, prop);
+}
 
 /**
  * Get a style property of a part of an object in the object's current state.
@@ -2754,66 +2870,27 @@ lv_color_t _lv_obj_get_style_color(const lv_obj_t * obj, uint8_t part, lv_style_
  */
 lv_opa_t _lv_obj_get_style_opa(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop)
 {
-    lv_style_property_t prop_ori = prop;
-
-    lv_style_attr_t attr;
-    attr = prop_ori >> 8;
-
-    lv_opa_t value_act;
-    lv_res_t res = LV_RES_INV;
-    const lv_obj_t * parent = obj;
-    while(parent) {
-        lv_style_list_t * list = lv_obj_get_style_list(parent, part);
-
-        if(!list->ignore_cache && list->style_cnt > 0) {
-            if(!list->valid_cache) update_style_cache((lv_obj_t *)parent, part, prop  & (~LV_STYLE_STATE_MASK));
-            bool def = false;
-            switch(prop & (~LV_STYLE_STATE_MASK)) {
-                case LV_STYLE_OPA_SCALE:
-                    if(list->opa_scale_cover) def = true;
-                    break;
-                case LV_STYLE_BG_OPA:
-                    if(list->bg_opa_cover) return LV_OPA_COVER;     /*Special case, not the default value is used*/
-                    if(list->bg_opa_transp) def = true;
-                    break;
-                case LV_STYLE_IMAGE_RECOLOR_OPA:
-                    if(list->img_recolor_opa_transp) def = true;
-                    break;
-            }
-
-            if(def) {
-                break;
-            }
-        }
-
-        lv_state_t state = lv_obj_get_state(parent, part);
-        prop = (uint16_t)prop_ori + ((uint16_t)state << LV_STYLE_STATE_POS);
-
-        res = _lv_style_list_get_opa(list, prop, &value_act);
-        if(res == LV_RES_OK) return value_act;
-
-        if(LV_STYLE_ATTR_GET_INHERIT(attr) == 0) break;
-
-        /*If not found, check the `MAIN` style first*/
-        if(part != LV_OBJ_PART_MAIN) {
-            part = LV_OBJ_PART_MAIN;
-            continue;
+    style_cache_stats.lookup_cnt++;
+
+#if LV_STYLE_CACHE_SIZE
+    uint8_t idx = STYLE_CACHE_IDX(prop);
+    style_cache_t * cache = idx != STYLE_CACHE_NONE ? style_cache_get(obj, part) : NULL;
+    if(cache) {
+        uint8_t bit = STYLE_CACHE_OPA_BIT + idx;
+        if(STYLE_CACHE_IS_RESOLVED(cache, bit)) return cache->opas[idx];
+
+        uint32_t gen = style_cache_gen;
+        lv_opa_t value = get_style_opa(obj, part, prop);
+        /*Getting the value might have reused the entry for an other object*/
+        if(style_cache_is_for(cache, obj, part, gen)) {
+            cache->opas[idx] = value;
+            STYLE_CACHE_SET_RESOLVED(cache, bit);
         }
-
-        /*Check the parent too.*/
-        parent = lv_obj_get_parent(parent);
-    }
-
-    /*Handle unset values*/
-    prop = prop & (~LV_STYLE_STATE_MASK);
-    switch(prop) {
-        case LV_STYLE_BG_OPA:
-        case LV_STYLE_IMAGE_RECOLOR_OPA:
-        case LV_STYLE_PATTERN_RECOLOR_OPA:
-            return LV_OPA_TRANSP;
+        return value;
     }
+#endif
 
-    return LV_OPA_COVER;
+    return get_style_opa(obj, part, prop);
 }
 
 /**
@@ -2832,68 +2909,27 @@ lv_opa_t _lv_obj_get_style_opa(const lv_obj_t * obj, uint8_t part, lv_style_prop
  */
 const void * _lv_obj_get_style_ptr(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop)
 {
-    lv_style_property_t prop_ori = prop;
-
-    lv_style_attr_t attr;
-    attr = prop_ori >> 8;
-
-    const void * value_act;
-    lv_res_t res = LV_RES_INV;
-    const lv_obj_t * parent = obj;
-    while(parent) {
-        lv_style_list_t * list = lv_obj_get_style_list(parent, part);
-
-        if(!list->ignore_cache && list->style_cnt > 0) {
-            if(!list->valid_cache) update_style_cache((lv_obj_t *)parent, part, prop  & (~LV_STYLE_STATE_MASK));
-            bool def = false;
-            switch(prop  & (~LV_STYLE_STATE_MASK)) {
-                case LV_STYLE_VALUE_STR:
-                    if(list->value_txt_str) def = true;
-                    break;
-                case LV_STYLE_PATTERN_IMAGE:
-                    if(list->pattern_img_null) def = true;
-                    break;
-                case LV_STYLE_TEXT_FONT:
-                    if(list->text_font_normal) def = true;
-                    break;
-            }
-
-            if(def) {
-                break;
-            }
-        }
-
-        lv_state_t state = lv_obj_get_state(parent, part);
-        prop = (uint16_t)prop_ori + ((uint16_t)state << LV_STYLE_STATE_POS);
-
-        res = _lv_style_list_get_ptr(list, prop, &value_act);
-        if(res == LV_RES_OK)  return value_act;
-
-        if(LV_STYLE_ATTR_GET_INHERIT(attr) == 0) break;
-
-        /*If not found, check the `MAIN` style first*/
-        if(part != LV_OBJ_PART_MAIN) {
-            part = LV_OBJ_PART_MAIN;
-            continue;
+    style_cache_stats.lookup_cnt++;
+
+#if LV_STYLE_CACHE_SIZE
+    uint8_t idx = STYLE_CACHE_IDX(prop);
+    style_cache_t * cache = idx != STYLE_CACHE_NONE ? style_cache_get(obj, part) : NULL;
+    if(cache) {
+        uint8_t bit = STYLE_CACHE_PTR_BIT + idx;
+        if(STYLE_CACHE_IS_RESOLVED(cache, bit)) return cache->ptrs[idx];
+
+        uint32_t gen = style_cache_gen;
+        const void * value = get_style_ptr(obj, part, prop);
+        /*Getting the value might have reused the entry for an other object*/
+        if(style_cache_is_for(cache, obj, part, gen)) {
+            cache->ptrs[idx] = value;
+            STYLE_CACHE_SET_RESOLVED(cache, bit);
         }
-
-        /*Check the parent too.*/
-        parent = lv_obj_get_parent(parent);
+        return value;
     }
-
-    /*Handle unset values*/
-    prop = prop & (~LV_STYLE_STATE_MASK);
-    switch(prop) {
-        case LV_STYLE_TEXT_FONT:
-        case LV_STYLE_VALUE_FONT:
-            return lv_theme_get_font_normal();
-#if LV_USE_ANIMATION
-        case LV_STYLE_TRANSITION_PATH:
-            return &lv_anim_path_def;
 #endif
-    }
 
-    return NULL;
+    return get_style_ptr(obj, part, prop);
 }
 
 /**
@@ -3085,6 +3121,34 @@ bool lv_obj_is_protected(const lv_obj_t * obj, uint8_t prot)
     return (obj->protect & prot) == 0 ? false : true;
 }
 
+/**
+ * Tell whether the layout of an object or one of its ancestors is suspended by `lv_obj_suspend_layout()`
+ * @param obj pointer to an object
+ * @return true: the layout is suspended
+ */
+bool lv_obj_is_layout_suspended(const lv_obj_t * obj)
+{
+    LV_ASSERT_OBJ(obj, LV_OBJX_NAME);
+
+    return layout_is_suspended(obj);
+}
+
+/**
+ * Postpone the layout refresh of an object if its layout is suspended.
+ * It will get `LV_SIGNAL_CHILD_CHG` when the layout is resumed.
+ * Used by the object types with layout not related to the children (e.g. the table's size).
+ * @param obj pointer to an object
+ * @return true: postponed, the layout shouldn't be refreshed now; false: refresh the layout now
+ */
+bool _lv_obj_postpone_layout(lv_obj_t * obj)
+{
+    if(obj == layout_flush_obj) return false;
+    if(layout_is_suspended(obj) == false) return false;
+
+    obj->layout_pending = 1;
+    return true;
+}
+
 lv_state_t lv_obj_get_state(const lv_obj_t * obj, uint8_t part)
 {
     LV_ASSERT_OBJ(obj, LV_OBJX_NAME);
@@ -3197,7 +3261,16 @@ lv_obj_user_data_t lv_obj_get_user_data(const lv_obj_t * obj)
 {
     LV_ASSERT_OBJ(obj, LV_OBJX_NAME);
 
+#if LV_USE_OBJ_COMPACT
+    if(obj->spec_attr == NULL) {
+        lv_obj_user_data_t user_data;
+        _lv_memset_00(&user_data, sizeof(lv_obj_user_data_t));
+        return user_data;
+    }
+    return obj->spec_attr->user_data;
+#else
     return obj->user_data;
+#endif
 }
 
 /**
@@ -3209,7 +3282,13 @@ lv_obj_user_data_t * lv_obj_get_user_data_ptr(const lv_obj_t * obj)
 {
     LV_ASSERT_OBJ(obj, LV_OBJX_NAME);
 
+#if LV_USE_OBJ_COMPACT
+    /*The user data might be written via the pointer so allocate it*/
+    lv_obj_spec_attr_t * attr = spec_attr_get((lv_obj_t *)obj);
+    return attr ? &attr->user_data : NULL;
+#else
     return (lv_obj_user_data_t *)&obj->user_data;
+#endif
 }
 
 /**
@@ -3221,7 +3300,13 @@ void lv_obj_set_user_data(lv_obj_t * obj, lv_obj_user_data_t data)
 {
     LV_ASSERT_OBJ(obj, LV_OBJX_NAME);
 
+#if LV_USE_OBJ_COMPACT
+    lv_obj_spec_attr_t * attr = spec_attr_get(obj);
+    if(attr == NULL) return;
+    _lv_memcpy(&attr->user_data, &data, sizeof(lv_obj_user_data_t));
+#else
     _lv_memcpy(&obj->user_data, &data, sizeof(lv_obj_user_data_t));
+#endif
 }
 #endif
 
@@ -3234,7 +3319,9 @@ void * lv_obj_get_group(const lv_obj_t * obj)
 {
     LV_ASSERT_OBJ(obj, LV_OBJX_NAME);
 
-#if LV_USE_GROUP
+#if LV_USE_GROUP && LV_USE_OBJ_COMPACT
+    return obj->spec_attr ? obj->spec_attr->group_p : NULL;
+#elif LV_USE_GROUP
     return obj->group_p;
 #else
     LV_UNUSED(obj);
@@ -3242,6 +3329,25 @@ void * lv_obj_get_group(const lv_obj_t * obj)
 #endif
 }
 
+#if LV_USE_GROUP
+/**
+ * Set the group of an object. Used by the groups when an object is added or removed.
+ * @param obj pointer to an object
+ * @param group pointer to a group or NULL to remove the object from its group
+ */
+void _lv_obj_set_group(lv_obj_t * obj, void * group)
+{
+#if LV_USE_OBJ_COMPACT
+    if(group == NULL && obj->spec_attr == NULL) return;
+
+    lv_obj_spec_attr_t * attr = spec_attr_get(obj);
+    if(attr) attr->group_p = group;
+#else
+    obj->group_p = group;
+#endif
+}
+#endif
+
 /**
  * Tell whether the object is the focused object of a group or not.
  * @param obj pointer to an object
@@ -3252,8 +3358,9 @@ bool lv_obj_is_focused(const lv_obj_t * obj)
     LV_ASSERT_OBJ(obj, LV_OBJX_NAME);
 
 #if LV_USE_GROUP
-    if(obj->group_p) {
-        if(lv_group_get_focused(obj->group_p) == obj) return true;
+    lv_group_t * group = lv_obj_get_group(obj);
+    if(group) {
+        if(lv_group_get_focused(group) == obj) return true;
     }
     return false;
 #else
@@ -3285,11 +3392,12 @@ bool lv_obj_is_point_on_coords(lv_obj_t * obj, const lv_point_t * point)
 
     if(!_lv_area_is_point_on(&ext_area, point, 0)) {
 #elif LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_FULL
+    const lv_area_t * pad = ext_click_pad_get(obj);
     lv_area_t ext_area;
-    ext_area.x1 = obj->coords.x1 - obj->ext_click_pad.x1;
-    ext_area.x2 = obj->coords.x2 + obj->ext_click_pad.x2;
-    ext_area.y1 = obj->coords.y1 - obj->ext_click_pad.y1;
-    ext_area.y2 = obj->coords.y2 + obj->ext_click_pad.y2;
+    ext_area.x1 = obj->coords.x1 - pad->x1;
+    ext_area.x2 = obj->coords.x2 + pad->x2;
+    ext_area.y1 = obj->coords.y1 - pad->y1;
+    ext_area.y2 = obj->coords.y2 + pad->y2;
 
     if(!_lv_area_is_point_on(&ext_area, point, 0)) {
 #else
@@ -3347,138 +3455,27 @@ lv_res_t lv_obj_handle_get_type_signal(lv_obj_type_t * buf, const char * name)
  */
 void lv_obj_init_draw_rect_dsc(lv_obj_t * obj, uint8_t part, lv_draw_rect_dsc_t * draw_dsc)
 {
-    draw_dsc->radius = lv_obj_get_style_radius(obj, part);
+#if LV_STYLE_CACHE_SIZE
+    /*A descriptor initialized only by `lv_draw_rect_dsc_init()` is the copy of the cached one*/
+    style_cache_t * cache = style_cache_get(obj, part);
+    if(cache && memcmp(draw_dsc, &rect_dsc_def, sizeof(lv_draw_rect_dsc_t)) == 0) {
+        if(cache->rect_valid) {
+            *draw_dsc = cache->rect;
+            style_cache_stats.rect_copy_cnt++;
+            return;
+        }
 
-#if LV_USE_OPA_SCALE
-    lv_opa_t opa_scale = lv_obj_get_style_opa_scale(obj, part);
-    if(opa_scale <= LV_OPA_MIN) {
-        draw_dsc->bg_opa = LV_OPA_TRANSP;
-        draw_dsc->border_opa = LV_OPA_TRANSP;
-        draw_dsc->shadow_opa = LV_OPA_TRANSP;
-        draw_dsc->pattern_opa = LV_OPA_TRANSP;
-        draw_dsc->value_opa = LV_OPA_TRANSP;
+        uint32_t gen = style_cache_gen;
+        init_draw_rect_dsc(obj, part, draw_dsc);
+        if(style_cache_is_for(cache, obj, part, gen)) {
+            cache->rect = *draw_dsc;
+            cache->rect_valid = 1;
+        }
         return;
     }
 #endif
 
-    if(draw_dsc->bg_opa != LV_OPA_TRANSP) {
-        draw_dsc->bg_opa = lv_obj_get_style_bg_opa(obj, part);
-        if(draw_dsc->bg_opa > LV_OPA_MIN) {
-            draw_dsc->bg_color = lv_obj_get_style_bg_color(obj, part);
-            draw_dsc->bg_grad_dir =  lv_obj_get_style_bg_grad_dir(obj, part);
-            if(draw_dsc->bg_grad_dir != LV_GRAD_DIR_NONE) {
-                draw_dsc->bg_grad_color = lv_obj_get_style_bg_grad_color(obj, part);
-                draw_dsc->bg_main_color_stop =  lv_obj_get_style_bg_main_stop(obj, part);
-                draw_dsc->bg_grad_color_stop =  lv_obj_get_style_bg_grad_stop(obj, part);
-            }
-
-#if LV_USE_BLEND_MODES
-            draw_dsc->bg_blend_mode = lv_obj_get_style_bg_blend_mode(obj, part);
-#endif
-        }
-    }
-
-    draw_dsc->border_width = lv_obj_get_style_border_width(obj, part);
-    if(draw_dsc->border_width) {
-        if(draw_dsc->border_opa != LV_OPA_TRANSP) {
-            draw_dsc->border_opa = lv_obj_get_style_border_opa(obj, part);
-            if(draw_dsc->border_opa > LV_OPA_MIN) {
-                draw_dsc->border_side = lv_obj_get_style_border_side(obj, part);
-                draw_dsc->border_color = lv_obj_get_style_border_color(obj, part);
-            }
-#if LV_USE_BLEND_MODES
-            draw_dsc->border_blend_mode = lv_obj_get_style_border_blend_mode(obj, part);
-#endif
-        }
-    }
-
-#if LV_USE_OUTLINE
-    draw_dsc->outline_width = lv_obj_get_style_outline_width(obj, part);
-    if(draw_dsc->outline_width) {
-        if(draw_dsc->outline_opa != LV_OPA_TRANSP) {
-            draw_dsc->outline_opa = lv_obj_get_style_outline_opa(obj, part);
-            if(draw_dsc->outline_opa > LV_OPA_MIN) {
-                draw_dsc->outline_pad = lv_obj_get_style_outline_pad(obj, part);
-                draw_dsc->outline_color = lv_obj_get_style_outline_color(obj, part);
-            }
-#if LV_USE_BLEND_MODES
-            draw_dsc->outline_blend_mode = lv_obj_get_style_outline_blend_mode(obj, part);
-#endif
-        }
-    }
-#endif
-
-#if LV_USE_PATTERN
-    draw_dsc->pattern_image = lv_obj_get_style_pattern_image(obj, part);
-    if(draw_dsc->pattern_image) {
-        if(draw_dsc->pattern_opa != LV_OPA_TRANSP) {
-            draw_dsc->pattern_opa = lv_obj_get_style_pattern_opa(obj, part);
-            if(draw_dsc->pattern_opa > LV_OPA_MIN) {
-                draw_dsc->pattern_recolor_opa = lv_obj_get_style_pattern_recolor_opa(obj, part);
-                draw_dsc->pattern_repeat = lv_obj_get_style_pattern_repeat(obj, part);
-                if(lv_img_src_get_type(draw_dsc->pattern_image) == LV_IMG_SRC_SYMBOL) {
-                    draw_dsc->pattern_recolor = lv_obj_get_style_pattern_recolor(obj, part);
-                    draw_dsc->pattern_font = lv_obj_get_style_text_font(obj, part);
-                }
-                else if(draw_dsc->pattern_recolor_opa > LV_OPA_MIN) {
-                    draw_dsc->pattern_recolor = lv_obj_get_style_pattern_recolor(obj, part);
-                }
-#if LV_USE_BLEND_MODES
-                draw_dsc->pattern_blend_mode = lv_obj_get_style_pattern_blend_mode(obj, part);
-#endif
-            }
-        }
-    }
-#endif
-
-#if LV_USE_SHADOW
-    draw_dsc->shadow_width = lv_obj_get_style_shadow_width(obj, part);
-    if(draw_dsc->shadow_width) {
-        if(draw_dsc->shadow_opa > LV_OPA_MIN) {
-            draw_dsc->shadow_opa = lv_obj_get_style_shadow_opa(obj, part);
-            if(draw_dsc->shadow_opa > LV_OPA_MIN) {
-                draw_dsc->shadow_ofs_x = lv_obj_get_style_shadow_ofs_x(obj, part);
-                draw_dsc->shadow_ofs_y = lv_obj_get_style_shadow_ofs_y(obj, part);
-                draw_dsc->shadow_spread = lv_obj_get_style_shadow_spread(obj, part);
-                draw_dsc->shadow_color = lv_obj_get_style_shadow_color(obj, part);
-#if LV_USE_BLEND_MODES
-                draw_dsc->shadow_blend_mode = lv_obj_get_style_shadow_blend_mode(obj, part);
-#endif
-            }
-        }
-    }
-#endif
-
-#if LV_USE_VALUE_STR
-    draw_dsc->value_str = lv_obj_get_style_value_str(obj, part);
-    if(draw_dsc->value_str) {
-        if(draw_dsc->value_opa > LV_OPA_MIN) {
-            draw_dsc->value_opa = lv_obj_get_style_value_opa(obj, part);
-            if(draw_dsc->value_opa > LV_OPA_MIN) {
-                draw_dsc->value_ofs_x = lv_obj_get_style_value_ofs_x(obj, part);
-                draw_dsc->value_ofs_y = lv_obj_get_style_value_ofs_y(obj, part);
-                draw_dsc->value_color = lv_obj_get_style_value_color(obj, part);
-                draw_dsc->value_font = lv_obj_get_style_value_font(obj, part);
-                draw_dsc->value_letter_space = lv_obj_get_style_value_letter_space(obj, part);
-                draw_dsc->value_line_space = lv_obj_get_style_value_line_space(obj, part);
-                draw_dsc->value_align = lv_obj_get_style_value_align(obj, part);
-#if LV_USE_BLEND_MODES
-                draw_dsc->value_blend_mode = lv_obj_get_style_value_blend_mode(obj, part);
-#endif
-            }
-        }
-    }
-#endif
-
-#if LV_USE_OPA_SCALE
-    if(opa_scale < LV_OPA_MAX) {
-        draw_dsc->bg_opa = (uint16_t)((uint16_t)draw_dsc->bg_opa * opa_scale) >> 8;
-        draw_dsc->border_opa = (uint16_t)((uint16_t)draw_dsc->border_opa * opa_scale) >> 8;
-        draw_dsc->shadow_opa = (uint16_t)((uint16_t)draw_dsc->shadow_opa * opa_scale) >> 8;
-        draw_dsc->pattern_opa = (uint16_t)((uint16_t)draw_dsc->pattern_opa * opa_scale) >> 8;
-        draw_dsc->value_opa = (uint16_t)((uint16_t)draw_dsc->value_opa * opa_scale) >> 8;
-    }
-#endif
+    init_draw_rect_dsc(obj, part, draw_dsc);
 }
 
 void lv_obj_init_draw_label_dsc(lv_obj_t * obj, uint8_t part, lv_draw_label_dsc_t * draw_dsc)
@@ -3773,13 +3770,13 @@ static void obj_del_core(lv_obj_t * obj)
 
     /*Recursively delete the children*/
     lv_obj_t * i;
-    i = _lv_ll_get_head(&(obj->child_ll));
+    i = _lv_obj_get_child_next(obj, NULL);
     while(i != NULL) {
         /*Call the recursive delete to the child too*/
         obj_del_core(i);
 
         /*Set i to the new head node*/
-        i = _lv_ll_get_head(&(obj->child_ll));
+        i = _lv_obj_get_child_next(obj, NULL);
     }
 
     /*Remove the animations from this object*/
@@ -3812,6 +3809,12 @@ static void obj_del_core(lv_obj_t * obj)
      * Now clean up the object specific data*/
     obj->signal_cb(obj, LV_SIGNAL_CLEANUP, NULL);
 
+    int32_t suspend_idx = layout_suspend_find(obj);
+    if(suspend_idx >= 0) {
+        layout_suspend_cnt--;
+        layout_suspend_objs[suspend_idx] = layout_suspend_objs[layout_suspend_cnt];
+    }
+
     /*Remove the object from parent's children list*/
     lv_obj_t * par = lv_obj_get_parent(obj);
     if(par == NULL) { /*It is a screen*/
@@ -3819,14 +3822,81 @@ static void obj_del_core(lv_obj_t * obj)
         _lv_ll_remove(&d->scr_ll, obj);
     }
     else {
+#if LV_USE_OBJ_COMPACT
+        child_unlink(par, obj);
+#else
         _lv_ll_remove(&(par->child_ll), obj);
+#endif
     }
 
+    /*A new object might be allocated at the same address*/
+    style_cache_invalidate_obj(obj, LV_OBJ_PART_ALL, false);
+
     /*Delete the base objects*/
     if(obj->ext_attr != NULL) lv_mem_free(obj->ext_attr);
+#if _LV_OBJ_SPEC_ATTR
+    if(obj->spec_attr != NULL) lv_mem_free(obj->spec_attr);
+#endif
     lv_mem_free(obj); /*Free the object itself*/
 }
 
+/**
+ * Find an object among the objects with suspended layout
+ * @param obj pointer to an object
+ * @return index in `layout_suspend_objs` or -1 if the object is not suspended
+ */
+static int32_t layout_suspend_find(const lv_obj_t * obj)
+{
+    uint32_t i;
+    for(i = 0; i < layout_suspend_cnt; i++) {
+        if(layout_suspend_objs[i] == obj) return i;
+    }
+
+    return -1;
+}
+
+/**
+ * Tell whether the layout of an object or one of its ancestors is suspended
+ * @param obj pointer to an object
+ * @return true: suspended
+ */
+static bool layout_is_suspended(const lv_obj_t * obj)
+{
+    if(layout_suspend_cnt == 0) return false;
+
+    while(obj) {
+        if(layout_suspend_find(obj) >= 0) return true;
+        obj = obj->parent;
+    }
+
+    return false;
+}
+
+/**
+ * Send the postponed `LV_SIGNAL_CHILD_CHG` signals to an object and its children. The children first.
+ * @param obj pointer to an object
+ * @return true: at least one signal was sent
+ */
+static bool layout_flush(lv_obj_t * obj)
+{
+    bool sent = false;
+    lv_obj_t * child;
+    for(child = _lv_obj_get_child_next(obj, NULL); child != NULL; child = _lv_obj_get_child_next(obj, child)) {
+        if(layout_flush(child)) sent = true;
+    }
+
+    if(obj->layout_pending) {
+        obj->layout_pending = 0;
+        lv_obj_t * flush_obj_prev = layout_flush_obj;
+        layout_flush_obj = obj;
+        obj->signal_cb(obj, LV_SIGNAL_CHILD_CHG, NULL);
+        layout_flush_obj = flush_obj_prev;
+        sent = true;
+    }
+
+    return sent;
+}
+
 /**
  * Handle the drawing related tasks of the base objects.
  * @param obj pointer to an object
@@ -3976,6 +4046,8 @@ static lv_res_t lv_obj_signal(lv_obj_t * obj, lv_signal_t sign, void * param)
     if(sign == LV_SIGNAL_CHILD_CHG) {
         /*Return 'invalid' if the child change signal is not enabled*/
         if(lv_obj_is_protected(obj, LV_PROTECT_CHILD_CHG) != false) res = LV_RES_INV;
+        /*The signal will be sent again when the layout is resumed*/
+        else if(_lv_obj_postpone_layout(obj)) res = LV_RES_INV;
     }
     else if(sign == LV_SIGNAL_REFR_EXT_DRAW_PAD) {
         lv_coord_t d = lv_obj_get_draw_rect_ext_pad_size(obj, LV_OBJ_PART_MAIN);
@@ -3983,7 +4055,7 @@ static lv_res_t lv_obj_signal(lv_obj_t * obj, lv_signal_t sign, void * param)
     }
 #if LV_USE_OBJ_REALIGN
     else if(sign == LV_SIGNAL_PARENT_SIZE_CHG) {
-        if(obj->realign.auto_realign) {
+        if(lv_obj_get_auto_realign(obj)) {
             lv_obj_realign(obj);
         }
     }
@@ -4043,7 +4115,7 @@ static lv_res_t lv_obj_signal(lv_obj_t * obj, lv_signal_t sign, void * param)
 static void refresh_children_position(lv_obj_t * obj, lv_coord_t x_diff, lv_coord_t y_diff)
 {
     lv_obj_t * i;
-    _LV_LL_READ(obj->child_ll, i) {
+    _LV_OBJ_CHILD_READ(obj, i) {
         i->coords.x1 += x_diff;
         i->coords.y1 += y_diff;
         i->coords.x2 += x_diff;
@@ -4270,19 +4342,59 @@ static void obj_align_mid_core(lv_obj_t * obj, const lv_obj_t * base, lv_align_t
 #if LV_USE_ANIMATION
 
 /**
- * Allocate and initialize a transition for a property of an object if the properties value is different in the new state.
+ * Allocate and initialize a transition for the properties of an object's part which are different in the new state.
  * It allocates `lv_style_trans_t` in `_lv_obj_style_trans_ll` and set only `start/end_values`. No animation will be created here.
  * @param obj and object to add the transition
- * @param prop the property to apply the transaction
  * @param part the part of the object to apply the transaction
+ * @param props the properties to apply the transaction. `LV_STYLE_TRANS_NUM_MAX` elements, 0 for unused
  * @param prev_state the previous state of the objects
  * @param new_state the new state of the object
  * @return pointer to the allocated `the transaction` variable or `NULL` if no transition created
  */
-static lv_style_trans_t * trans_create(lv_obj_t * obj, lv_style_property_t prop, uint8_t part, lv_state_t prev_state,
-                                       lv_state_t new_state)
+static lv_style_trans_t * trans_create(lv_obj_t * obj, uint8_t part, const lv_style_property_t props[],
+                                       lv_state_t prev_state, lv_state_t new_state)
 {
-    lv_style_trans_t * tr;
+    /*Collect the changed properties first to allocate only if required*/
+    lv_style_trans_t tr_tmp;
+    tr_tmp.obj = obj;
+    tr_tmp.part = part;
+    tr_tmp.prop_cnt = 0;
+
+    uint8_t i;
+    for(i = 0; i < LV_STYLE_TRANS_NUM_MAX; i++) {
+        if(props[i] == 0) continue;
+
+        _lv_style_list_add_trans_style(lv_obj_get_style_list(obj, part));
+
+        lv_style_trans_prop_t * tr_prop = &tr_tmp.props[tr_tmp.prop_cnt];
+        tr_prop->prop = props[i];
+        if(trans_prop_init(obj, part, tr_prop, prev_state, new_state)) tr_tmp.prop_cnt++;
+    }
+
+    if(tr_tmp.prop_cnt == 0) return NULL;
+
+    lv_style_trans_t * tr = trans_alloc();
+    LV_ASSERT_MEM(tr);
+    if(tr == NULL) return NULL;
+
+    _lv_memcpy(tr, &tr_tmp, sizeof(lv_style_trans_t));
+
+    return tr;
+}
+
+/**
+ * Set the start and end values of a property of a transition if the properties value is different in the new state.
+ * @param obj and object to add the transition
+ * @param part the part of the object to apply the transaction
+ * @param tr_prop the property to initialize. Its `prop` field should be set already.
+ * @param prev_state the previous state of the objects
+ * @param new_state the new state of the object
+ * @return true: the value is changed and `tr_prop` is initialized; false: the value is the same in the new state
+ */
+static bool trans_prop_init(lv_obj_t * obj, uint8_t part, lv_style_trans_prop_t * tr_prop, lv_state_t prev_state,
+                            lv_state_t new_state)
+{
+    lv_style_property_t prop = tr_prop->prop;
     lv_style_list_t * style_list = lv_obj_get_style_list(obj, part);
     lv_style_t * style_trans = _lv_style_list_get_transition_style(style_list);
 
@@ -4299,7 +4411,7 @@ static lv_style_trans_t * trans_create(lv_obj_t * obj, lv_style_property_t prop,
         style_list->skip_trans = 0;
         style_list->ignore_cache = cache_ori;
 
-        if(int1 == int2)  return NULL;
+        if(int1 == int2)  return false;
         obj->state = prev_state;
         int1 = _lv_obj_get_style_int(obj, part, prop);
         obj->state = new_state;
@@ -4314,11 +4426,8 @@ static lv_style_trans_t * trans_create(lv_obj_t * obj, lv_style_property_t prop,
             }
         }
 
-        tr = _lv_ll_ins_head(&LV_GC_ROOT(_lv_obj_style_trans_ll));
-        LV_ASSERT_MEM(tr);
-        if(tr == NULL) return NULL;
-        tr->start_value._int = int1;
-        tr->end_value._int = int2;
+        tr_prop->start_value._int = int1;
+        tr_prop->end_value._int = int2;
     }
     else if((prop & 0xF) < LV_STYLE_ID_OPA) { /*Color*/
         style_list->skip_trans = 1;
@@ -4330,17 +4439,14 @@ static lv_style_trans_t * trans_create(lv_obj_t * obj, lv_style_property_t prop,
         style_list->skip_trans = 0;
         style_list->ignore_cache = cache_ori;
 
-        if(c1.full == c2.full) return NULL;
+        if(c1.full == c2.full) return false;
         obj->state = prev_state;
         c1 = _lv_obj_get_style_color(obj, part, prop);
         obj->state = new_state;
         _lv_style_set_color(style_trans, prop, c1);    /*Be sure `trans_style` has a valid value */
 
-        tr = _lv_ll_ins_head(&LV_GC_ROOT(_lv_obj_style_trans_ll));
-        LV_ASSERT_MEM(tr);
-        if(tr == NULL) return NULL;
-        tr->start_value._color = c1;
-        tr->end_value._color = c2;
+        tr_prop->start_value._color = c1;
+        tr_prop->end_value._color = c2;
     }
     else if((prop & 0xF) < LV_STYLE_ID_PTR) { /*Opa*/
         style_list->skip_trans = 1;
@@ -4352,18 +4458,15 @@ static lv_style_trans_t * trans_create(lv_obj_t * obj, lv_style_property_t prop,
         style_list->skip_trans = 0;
         style_list->ignore_cache = cache_ori;
 
-        if(o1 == o2) return NULL;
+        if(o1 == o2) return false;
 
         obj->state = prev_state;
         o1 = _lv_obj_get_style_opa(obj, part, prop);
         obj->state = new_state;
         _lv_style_set_opa(style_trans, prop, o1);   /*Be sure `trans_style` has a valid value */
 
-        tr = _lv_ll_ins_head(&LV_GC_ROOT(_lv_obj_style_trans_ll));
-        LV_ASSERT_MEM(tr);
-        if(tr == NULL) return NULL;
-        tr->start_value._opa = o1;
-        tr->end_value._opa = o2;
+        tr_prop->start_value._opa = o1;
+        tr_prop->end_value._opa = o2;
     }
     else {      /*Ptr*/
         obj->state = prev_state;
@@ -4375,26 +4478,57 @@ static lv_style_trans_t * trans_create(lv_obj_t * obj, lv_style_property_t prop,
         style_list->skip_trans = 0;
         style_list->ignore_cache = cache_ori;
 
-        if(memcmp(&p1, &p2, sizeof(const void *)) == 0)  return NULL;
+        if(memcmp(&p1, &p2, sizeof(const void *)) == 0)  return false;
         obj->state = prev_state;
         p1 = _lv_obj_get_style_ptr(obj, part, prop);
         obj->state = new_state;
         _lv_style_set_ptr(style_trans, prop, p1);   /*Be sure `trans_style` has a valid value */
 
-        tr = _lv_ll_ins_head(&LV_GC_ROOT(_lv_obj_style_trans_ll));
-        LV_ASSERT_MEM(tr);
-        if(tr == NULL) return NULL;
-        tr->start_value._ptr = p1;
-        tr->end_value._ptr = p2;
+        tr_prop->start_value._ptr = p1;
+        tr_prop->end_value._ptr = p2;
     }
 
-    return tr;
+    return true;
+}
+
+/**
+ * Get a transition from the pool of the finished transitions or allocate a new one.
+ * The transition is added to the head of `_lv_obj_style_trans_ll`.
+ * @return pointer to the transition or `NULL` if out of memory
+ */
+static lv_style_trans_t * trans_alloc(void)
+{
+    lv_style_trans_t * tr = _lv_ll_get_head(&LV_GC_ROOT(_lv_obj_style_trans_pool_ll));
+    if(tr) {
+        _lv_ll_chg_list(&LV_GC_ROOT(_lv_obj_style_trans_pool_ll), &LV_GC_ROOT(_lv_obj_style_trans_ll), tr, true);
+        return tr;
+    }
+
+    return _lv_ll_ins_head(&LV_GC_ROOT(_lv_obj_style_trans_ll));
+}
+
+/**
+ * Remove a transition from `_lv_obj_style_trans_ll` and keep it in the pool or free it if the pool is full.
+ * The animation of the transition should be deleted already.
+ * @param tr pointer to a transition
+ */
+static void trans_free(lv_style_trans_t * tr)
+{
+#if LV_STYLE_TRANS_POOL_SIZE
+    if(_lv_ll_get_len(&LV_GC_ROOT(_lv_obj_style_trans_pool_ll)) < LV_STYLE_TRANS_POOL_SIZE) {
+        _lv_ll_chg_list(&LV_GC_ROOT(_lv_obj_style_trans_ll), &LV_GC_ROOT(_lv_obj_style_trans_pool_ll), tr, true);
+        return;
+    }
+#endif
+
+    _lv_ll_remove(&LV_GC_ROOT(_lv_obj_style_trans_ll), tr);
+    lv_mem_free(tr);
 }
 
 /**
  * Remove the transition from object's part's property.
- * - Remove the transition from `_lv_obj_style_trans_ll` and free it
- * - Delete pending transitions
+ * - Remove the property from the transitions of `_lv_obj_style_trans_ll`
+ * - Delete the transitions without properties and their pending animations
  * @param obj pointer to an object which transition(s) should be removed
  * @param part a part of object or 0xFF to remove from all parts
  * @param prop a property or 0xFF to remove all properties
@@ -4411,16 +4545,30 @@ static void trans_del(lv_obj_t * obj, uint8_t part, lv_style_property_t prop, lv
         /*'tr' might be deleted, so get the next object while 'tr' is valid*/
         tr_prev = _lv_ll_get_prev(&LV_GC_ROOT(_lv_obj_style_trans_ll), tr);
 
-        if(tr->obj == obj && (part == tr->part || part == 0xFF) && (prop == tr->prop || prop == 0xFF)) {
-            /* Remove the transitioned property from trans. style
-             * to allow changing it by normal styles*/
+        if(tr->obj == obj && (part == tr->part || part == 0xFF)) {
             lv_style_list_t * list = lv_obj_get_style_list(tr->obj, tr->part);
             lv_style_t * style_trans = _lv_style_list_get_transition_style(list);
-            lv_style_remove_prop(style_trans, tr->prop);
 
-            lv_anim_del(tr, NULL);
-            _lv_ll_remove(&LV_GC_ROOT(_lv_obj_style_trans_ll), tr);
-            lv_mem_free(tr);
+            uint8_t i = 0;
+            while(i < tr->prop_cnt) {
+                if(prop == tr->props[i].prop || prop == 0xFF) {
+                    /* Remove the transitioned property from trans. style
+                     * to allow changing it by normal styles*/
+                    lv_style_remove_prop(style_trans, tr->props[i].prop);
+
+                    /*Fill the gap with the last property*/
+                    tr->prop_cnt--;
+                    tr->props[i] = tr->props[tr->prop_cnt];
+                }
+                else {
+                    i++;
+                }
+            }
+
+            if(tr->prop_cnt == 0) {
+                lv_anim_del(tr, NULL);
+                trans_free(tr);
+            }
         }
         tr = tr_prev;
     }
@@ -4431,90 +4579,125 @@ static void trans_anim_cb(lv_style_trans_t * tr, lv_anim_value_t v)
     lv_style_list_t * list = lv_obj_get_style_list(tr->obj, tr->part);
     lv_style_t * style = _lv_style_list_get_transition_style(list);
 
-    if((tr->prop & 0xF) < LV_STYLE_ID_COLOR) { /*Value*/
-        lv_style_int_t x;
-        if(v == 0) x = tr->start_value._int;
-        else if(v == 255) x = tr->end_value._int;
-        else x = tr->start_value._int + ((int32_t)((int32_t)(tr->end_value._int - tr->start_value._int) * v) >> 8);
-        _lv_style_set_int(style, tr->prop, x);
-    }
-    else if((tr->prop & 0xF) < LV_STYLE_ID_OPA) { /*Color*/
-        lv_color_t x;
-        if(v <= 0) x = tr->start_value._color;
-        else if(v >= 255) x = tr->end_value._color;
-        else x = lv_color_mix(tr->end_value._color, tr->start_value._color, v);
-        _lv_style_set_color(style, tr->prop, x);
-    }
-    else if((tr->prop & 0xF) < LV_STYLE_ID_PTR) { /*Opa*/
-        lv_opa_t x;
-        if(v <= 0) x = tr->start_value._opa;
-        else if(v >= 255) x = tr->end_value._opa;
-        else x = tr->start_value._opa + (((tr->end_value._opa - tr->start_value._opa) * v) >> 8);
-        _lv_style_set_opa(style, tr->prop, x);
+    uint8_t i;
+    for(i = 0; i < tr->prop_cnt; i++) {
+        lv_style_trans_prop_t * tr_prop = &tr->props[i];
+        if((tr_prop->prop & 0xF) < LV_STYLE_ID_COLOR) { /*Value*/
+            lv_style_int_t x;
+            if(v == 0) x = tr_prop->start_value._int;
+            else if(v == 255) x = tr_prop->end_value._int;
+            else x = tr_prop->start_value._int + ((int32_t)((int32_t)(tr_prop->end_value._int - tr_prop->start_value._int) * v) >> 8);
+            _lv_style_set_int(style, tr_prop->prop, x);
+        }
+        else if((tr_prop->prop & 0xF) < LV_STYLE_ID_OPA) { /*Color*/
+            lv_color_t x;
+            if(v <= 0) x = tr_prop->start_value._color;
+            else if(v >= 255) x = tr_prop->end_value._color;
+            else x = lv_color_mix(tr_prop->end_value._color, tr_prop->start_value._color, v);
+            _lv_style_set_color(style, tr_prop->prop, x);
+        }
+        else if((tr_prop->prop & 0xF) < LV_STYLE_ID_PTR) { /*Opa*/
+            lv_opa_t x;
+            if(v <= 0) x = tr_prop->start_value._opa;
+            else if(v >= 255) x = tr_prop->end_value._opa;
+            else x = tr_prop->start_value._opa + (((tr_prop->end_value._opa - tr_prop->start_value._opa) * v) >> 8);
+            _lv_style_set_opa(style, tr_prop->prop, x);
+        }
+        else {
+            const void * x;
+            if(v < 128) x = tr_prop->start_value._ptr;
+            else x = tr_prop->end_value._ptr;
+            _lv_style_set_ptr(style, tr_prop->prop, x);
+        }
     }
-    else {
-        const void * x;
-        if(v < 128) x = tr->start_value._ptr;
-        else x = tr->end_value._ptr;
-        _lv_style_set_ptr(style, tr->prop, x);
+
+    trans_refresh(tr);
+}
+
+/**
+ * Refresh an object after the properties of its transition are changed.
+ * The properties which need only a redraw invalidate the style cache and the object only once.
+ * @param tr pointer to a transition
+ */
+static void trans_refresh(lv_style_trans_t * tr)
+{
+    bool real_refr = false;
+    bool cacheble = false;
+    bool inherit = false;
+    uint8_t i;
+    for(i = 0; i < tr->prop_cnt; i++) {
+        lv_style_property_t prop = tr->props[i].prop;
+        if(style_prop_needs_refr(prop)) {
+            lv_obj_refresh_style(tr->obj, tr->part, prop);
+            real_refr = true;
+        }
+        else {
+            /*Collect what the other properties need and invalidate only once*/
+            if(style_prop_is_cacheble(prop)) cacheble = true;
+            if(style_prop_is_inherited(prop)) inherit = true;
+        }
     }
-    lv_obj_refresh_style(tr->obj, tr->part, tr->prop);
 
+    /*The real refresh has invalidated the object already but not for the other properties*/
+    if(cacheble || inherit || real_refr == false) invalidate_style_cache(tr->obj, tr->part, cacheble, inherit);
+    if(real_refr == false) lv_obj_invalidate(tr->obj);
 }
 
 static void trans_anim_start_cb(lv_anim_t * a)
 {
     lv_style_trans_t * tr = a->var;
 
-    lv_style_property_t prop_tmp = tr->prop;
-
-    /*Start the animation from the current value*/
-    if((prop_tmp & 0xF) < LV_STYLE_ID_COLOR) { /*Int*/
-        tr->start_value._int = _lv_obj_get_style_int(tr->obj, tr->part, prop_tmp);
-    }
-    else if((prop_tmp & 0xF) < LV_STYLE_ID_OPA) { /*Color*/
-        tr->start_value._color = _lv_obj_get_style_color(tr->obj, tr->part, prop_tmp);
-    }
-    else if((prop_tmp & 0xF) < LV_STYLE_ID_PTR) { /*Opa*/
-        tr->start_value._opa = _lv_obj_get_style_opa(tr->obj, tr->part, prop_tmp);
-    }
-    else {      /*Ptr*/
-        tr->start_value._ptr = _lv_obj_get_style_ptr(tr->obj, tr->part, prop_tmp);
-    }
-
-    /*Init prop to an invalid values to be sure `trans_del` won't delete this added `tr`*/
-    tr->prop = 0;
-    /*Delete the relate transition if any*/
-    trans_del(tr->obj, tr->part, prop_tmp, tr);
+    uint8_t i;
+    for(i = 0; i < tr->prop_cnt; i++) {
+        lv_style_trans_prop_t * tr_prop = &tr->props[i];
+        lv_style_property_t prop = tr_prop->prop;
 
-    tr->prop = prop_tmp;
+        /*Start the animation from the current value*/
+        if((prop & 0xF) < LV_STYLE_ID_COLOR) { /*Int*/
+            tr_prop->start_value._int = _lv_obj_get_style_int(tr->obj, tr->part, prop);
+        }
+        else if((prop & 0xF) < LV_STYLE_ID_OPA) { /*Color*/
+            tr_prop->start_value._color = _lv_obj_get_style_color(tr->obj, tr->part, prop);
+        }
+        else if((prop & 0xF) < LV_STYLE_ID_PTR) { /*Opa*/
+            tr_prop->start_value._opa = _lv_obj_get_style_opa(tr->obj, tr->part, prop);
+        }
+        else {      /*Ptr*/
+            tr_prop->start_value._ptr = _lv_obj_get_style_ptr(tr->obj, tr->part, prop);
+        }
 
+        /*Delete the property from the older transitions if any. `tr` is the limit so it's not deleted*/
+        trans_del(tr->obj, tr->part, prop, tr);
+    }
 }
 
 static void trans_anim_ready_cb(lv_anim_t * a)
 {
     lv_style_trans_t * tr = a->var;
+    lv_style_list_t * list = lv_obj_get_style_list(tr->obj, tr->part);
+    lv_style_t * style_trans = _lv_style_list_get_transition_style(list);
 
-    /* Remove the transitioned property from trans. style
-     * if there no more transitions for this property
-     * It allows changing it by normal styles*/
-
-    bool running = false;
-    lv_style_trans_t * tr_i;
-    _LV_LL_READ(LV_GC_ROOT(_lv_obj_style_trans_ll), tr_i) {
-        if(tr_i != tr && tr_i->obj == tr->obj && tr_i->part == tr->part && tr_i->prop == tr->prop) {
-            running = true;
+    /* Remove the transitioned properties from trans. style
+     * if there no more transitions for them
+     * It allows changing them by normal styles*/
+    uint8_t i;
+    for(i = 0; i < tr->prop_cnt; i++) {
+        lv_style_property_t prop = tr->props[i].prop;
+        bool running = false;
+        lv_style_trans_t * tr_i;
+        _LV_LL_READ(LV_GC_ROOT(_lv_obj_style_trans_ll), tr_i) {
+            if(tr_i == tr || tr_i->obj != tr->obj || tr_i->part != tr->part) continue;
+
+            uint8_t j;
+            for(j = 0; j < tr_i->prop_cnt; j++) {
+                if(tr_i->props[j].prop == prop) running = true;
+            }
         }
-    }
 
-    if(!running) {
-        lv_style_list_t * list = lv_obj_get_style_list(tr->obj, tr->part);
-        lv_style_t * style_trans = _lv_style_list_get_transition_style(list);
-        lv_style_remove_prop(style_trans, tr->prop);
+        if(!running) lv_style_remove_prop(style_trans, prop);
     }
 
-    _lv_ll_remove(&LV_GC_ROOT(_lv_obj_style_trans_ll), tr);
-    lv_mem_free(tr);
+    trans_free(tr);
 }
 
 static void opa_scale_anim(lv_obj_t * obj, lv_anim_value_t v)
@@ -4529,29 +4712,193 @@ static void fade_in_anim_ready(lv_anim_t * a)
 
 #endif
 
-static void lv_event_mark_deleted(lv_obj_t * obj)
+#if LV_USE_OBJ_COMPACT
+/**
+ * Link an object into the children of a parent
+ * @param parent pointer to the parent
+ * @param obj pointer to an object which is not linked anywhere
+ * @param head true: link as the youngest child (foreground); false: link as the oldest child (background)
+ */
+static void child_link(lv_obj_t * parent, lv_obj_t * obj, bool head)
 {
-    lv_event_temp_data_t * t = event_temp_data_head;
+    lv_obj_t * first = parent->child_head;
+    if(first == NULL) {
+        parent->child_head = obj;
+        obj->sib_next = NULL;
+        obj->sib_prev = obj;    /*The youngest child's `sib_prev` is the oldest child*/
+        return;
+    }
 
-    while(t) {
-        if(t->obj == obj) t->deleted = true;
-        t = t->prev;
+    lv_obj_t * last = first->sib_prev;
+    if(head) {
+        obj->sib_next = first;
+        obj->sib_prev = last;
+        first->sib_prev = obj;
+        parent->child_head = obj;
+    }
+    else {
+        obj->sib_next = NULL;
+        obj->sib_prev = last;
+        last->sib_next = obj;
+        first->sib_prev = obj;
     }
 }
 
-static bool obj_valid_child(const lv_obj_t * parent, const lv_obj_t * obj_to_find)
+/**
+ * Unlink an object from the children of its parent
+ * @param parent pointer to the parent
+ * @param obj pointer to a child of `parent`
+ */
+static void child_unlink(lv_obj_t * parent, lv_obj_t * obj)
 {
-    /*Check all children of `parent`*/
-    lv_obj_t * child;
-    _LV_LL_READ(parent->child_ll, child) {
-        if(child == obj_to_find) return true;
+    lv_obj_t * first = parent->child_head;
+    lv_obj_t * next = obj->sib_next;
 
-        /*Check the children*/
-        bool found = obj_valid_child(child, obj_to_find);
-        if(found) return true;
+    if(obj == first) {
+        parent->child_head = next;
+        if(next) next->sib_prev = obj->sib_prev;    /*Keep the link to the oldest child*/
+    }
+    else {
+        obj->sib_prev->sib_next = next;
+        if(next) next->sib_prev = obj->sib_prev;
+        else first->sib_prev = obj->sib_prev;       /*The oldest child is removed*/
     }
 
-    return false;
+    obj->sib_next = NULL;
+    obj->sib_prev = NULL;
+}
+#endif
+
+#if _LV_OBJ_SPEC_ATTR
+/**
+ * Get the rarely used attributes of an object. Allocate them if not allocated yet.
+ * @param obj pointer to an object
+ * @return pointer to the attributes or NULL if out of memory
+ */
+static lv_obj_spec_attr_t * spec_attr_get(lv_obj_t * obj)
+{
+    if(obj->spec_attr == NULL) {
+        obj->spec_attr = lv_mem_alloc(sizeof(lv_obj_spec_attr_t));
+        LV_ASSERT_MEM(obj->spec_attr);
+        if(obj->spec_attr == NULL) return NULL;
+
+        /*0 is the default value of every attribute (`LV_ALIGN_CENTER` too)*/
+        _lv_memset_00(obj->spec_attr, sizeof(lv_obj_spec_attr_t));
+    }
+
+    return obj->spec_attr;
+}
+#endif
+
+#if LV_USE_OBJ_REALIGN
+/**
+ * Get the parameters of the last align of an object
+ * @param obj pointer to an object
+ * @param alloc true: allocate the parameters if they are not allocated yet (only with `LV_USE_OBJ_COMPACT`)
+ * @return pointer to the parameters or NULL if not allocated
+ */
+static lv_realign_t * realign_get(const lv_obj_t * obj, bool alloc)
+{
+#if LV_USE_OBJ_COMPACT
+    lv_obj_spec_attr_t * attr = alloc ? spec_attr_get((lv_obj_t *)obj) : obj->spec_attr;
+    return attr ? &attr->realign : NULL;
+#else
+    LV_UNUSED(alloc);
+    return (lv_realign_t *)&obj->realign;
+#endif
+}
+#endif
+
+#if LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_FULL
+/**
+ * Get the extra click padding of an object
+ * @param obj pointer to an object
+ * @return pointer to the padding. Never NULL.
+ */
+static const lv_area_t * ext_click_pad_get(const lv_obj_t * obj)
+{
+#if LV_USE_OBJ_COMPACT
+    static const lv_area_t pad_none = {0, 0, 0, 0};
+    return obj->spec_attr ? &obj->spec_attr->ext_click_pad : &pad_none;
+#else
+    return &obj->ext_click_pad;
+#endif
+}
+#endif
+
+static void lv_event_mark_deleted(lv_obj_t * obj)
+{
+    lv_event_temp_data_t * t = event_temp_data_head;
+
+    while(t) {
+        if(t->obj == obj) t->deleted = true;
+        t = t->prev;
+    }
+}
+
+static bool obj_valid_child(const lv_obj_t * parent, const lv_obj_t * obj_to_find)
+{
+    /*Check all children of `parent`*/
+    lv_obj_t * child;
+    _LV_OBJ_CHILD_READ(parent, child) {
+        if(child == obj_to_find) return true;
+
+        /*Check the children*/
+        bool found = obj_valid_child(child, obj_to_find);
+        if(found) return true;
+    }
+
+    return false;
+}
+
+/**
+ * Tell whether a property needs a real style refresh (signals, size, children) or only a redraw when it's changed
+ * @param prop an `LV_STYLE_...` property or `LV_STYLE_PROP_ALL`
+ * @return true: real refresh is required
+ */
+static bool style_prop_needs_refr(lv_style_property_t prop)
+{
+    switch(prop) {
+        case LV_STYLE_PROP_ALL:
+        case LV_STYLE_CLIP_CORNER:
+        case LV_STYLE_SIZE:
+        case LV_STYLE_TRANSFORM_WIDTH:
+        case LV_STYLE_TRANSFORM_HEIGHT:
+        case LV_STYLE_TRANSFORM_ANGLE:
+        case LV_STYLE_TRANSFORM_ZOOM:
+        case LV_STYLE_PAD_TOP:
+        case LV_STYLE_PAD_BOTTOM:
+        case LV_STYLE_PAD_LEFT:
+        case LV_STYLE_PAD_RIGHT:
+        case LV_STYLE_PAD_INNER:
+        case LV_STYLE_MARGIN_TOP:
+        case LV_STYLE_MARGIN_BOTTOM:
+        case LV_STYLE_MARGIN_LEFT:
+        case LV_STYLE_MARGIN_RIGHT:
+        case LV_STYLE_OUTLINE_WIDTH:
+        case LV_STYLE_OUTLINE_PAD:
+        case LV_STYLE_OUTLINE_OPA:
+        case LV_STYLE_SHADOW_WIDTH:
+        case LV_STYLE_SHADOW_OPA:
+        case LV_STYLE_SHADOW_OFS_X:
+        case LV_STYLE_SHADOW_OFS_Y:
+        case LV_STYLE_SHADOW_SPREAD:
+        case LV_STYLE_VALUE_LETTER_SPACE:
+        case LV_STYLE_VALUE_LINE_SPACE:
+        case LV_STYLE_VALUE_OFS_X:
+        case LV_STYLE_VALUE_OFS_Y:
+        case LV_STYLE_VALUE_ALIGN:
+        case LV_STYLE_VALUE_STR:
+        case LV_STYLE_VALUE_FONT:
+        case LV_STYLE_VALUE_OPA:
+        case LV_STYLE_TEXT_LETTER_SPACE:
+        case LV_STYLE_TEXT_LINE_SPACE:
+        case LV_STYLE_TEXT_FONT:
+        case LV_STYLE_LINE_WIDTH:
+            return true;
+        default:
+            return false;
+    }
 }
 
 static bool style_prop_is_cacheble(lv_style_property_t prop)
@@ -4602,6 +4949,11 @@ static bool style_prop_is_cacheble(lv_style_property_t prop)
     }
 }
 
+static bool style_prop_is_inherited(lv_style_property_t prop)
+{
+    return prop == LV_STYLE_PROP_ALL || (prop & LV_STYLE_INHERIT_MASK);
+}
+
 /**
  * Update the cache of style list
  * @param obj pointer to an object
@@ -4727,12 +5079,19 @@ static void update_style_cache_children(lv_obj_t * obj)
 
 /**
  * Mark the object and all of it's children's style lists as invalid.
- * The cache will be updated when a cached property asked nest time
+ * The cache will be updated when a cached property asked nest time.
+ * The resolved style properties of the object's part are invalidated too,
+ * and the ones of the children if they might inherit the property.
  * @param obj pointer to an object
+ * @param part the part whose resolved properties changed
+ * @param cacheble true: a property cached in the style lists changed (see `style_prop_is_cacheble()`)
+ * @param inherit true: a property the children might inherit changed
  */
-static void invalidate_style_cache(lv_obj_t * obj, uint8_t part, lv_style_property_t prop)
+static void invalidate_style_cache(lv_obj_t * obj, uint8_t part, bool cacheble, bool inherit)
 {
-    if(style_prop_is_cacheble(prop) == false) return;
+    style_cache_invalidate_obj(obj, part, inherit);
+
+    if(cacheble == false) return;
 
     for(part = 0; part < _LV_OBJ_PART_REAL_FIRST; part++) {
         lv_style_list_t * list = lv_obj_get_style_list(obj, part);
@@ -4831,3 +5190,586 @@ static style_snapshot_res_t style_snapshot_compare(style_snapshot_t * shot1, sty
     /*If not returned earlier its just a visual difference, a simple redraw is enough*/
     return STYLE_COMPARE_VISUAL_DIFF;
 }
+
+/**
+ * Look up an integer style property in the style lists of an object and its parents
+ * @param obj pointer to an object
+ * @param part the part of the object
+ * @param prop the property to get
+ * @return the value of the property or its default value
+ */
+static lv_style_int_t get_style_int(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop)
+{
+    style_cache_stats.resolve_cnt++;
+
+    lv_style_property_t prop_ori = prop;
+
+    lv_style_attr_t attr;
+    attr = prop_ori >> 8;
+
+    lv_style_int_t value_act;
+    lv_res_t res = LV_RES_INV;
+    const lv_obj_t * parent = obj;
+    while(parent) {
+        lv_style_list_t * list = lv_obj_get_style_list(parent, part);
+        if(!list->ignore_cache && list->style_cnt > 0) {
+            if(!list->valid_cache) update_style_cache((lv_obj_t *)parent, part, prop  & (~LV_STYLE_STATE_MASK));
+
+            bool def = false;
+            switch(prop  & (~LV_STYLE_STATE_MASK)) {
+                case LV_STYLE_CLIP_CORNER:
+                    if(list->clip_corner_off) def = true;
+                    break;
+                case LV_STYLE_TEXT_LETTER_SPACE:
+                case LV_STYLE_TEXT_LINE_SPACE:
+                    if(list->text_space_zero) def = true;
+                    break;
+                case LV_STYLE_TRANSFORM_ANGLE:
+                case LV_STYLE_TRANSFORM_WIDTH:
+                case LV_STYLE_TRANSFORM_HEIGHT:
+                case LV_STYLE_TRANSFORM_ZOOM:
+                    if(list->transform_all_zero) def = true;
+                    break;
+                case LV_STYLE_BORDER_WIDTH:
+                    if(list->border_width_zero) def = true;
+                    break;
+                case LV_STYLE_BORDER_SIDE:
+                    if(list->border_side_full) def = true;
+                    break;
+                case LV_STYLE_BORDER_POST:
+                    if(list->border_post_off) def = true;
+                    break;
+                case LV_STYLE_OUTLINE_WIDTH:
+                    if(list->outline_width_zero) def = true;
+                    break;
+                case LV_STYLE_RADIUS:
+                    if(list->radius_zero) def = true;
+                    break;
+                case LV_STYLE_SHADOW_WIDTH:
+                    if(list->shadow_width_zero) def = true;
+                    break;
+                case LV_STYLE_PAD_TOP:
+                case LV_STYLE_PAD_BOTTOM:
+                case LV_STYLE_PAD_LEFT:
+                case LV_STYLE_PAD_RIGHT:
+                    if(list->pad_all_zero) def = true;
+                    break;
+                case LV_STYLE_MARGIN_TOP:
+                case LV_STYLE_MARGIN_BOTTOM:
+                case LV_STYLE_MARGIN_LEFT:
+                case LV_STYLE_MARGIN_RIGHT:
+                    if(list->margin_all_zero) def = true;
+                    break;
+                case LV_STYLE_BG_BLEND_MODE:
+                case LV_STYLE_BORDER_BLEND_MODE:
+                case LV_STYLE_IMAGE_BLEND_MODE:
+                case LV_STYLE_LINE_BLEND_MODE:
+                case LV_STYLE_OUTLINE_BLEND_MODE:
+                case LV_STYLE_PATTERN_BLEND_MODE:
+                case LV_STYLE_SHADOW_BLEND_MODE:
+                case LV_STYLE_TEXT_BLEND_MODE:
+                case LV_STYLE_VALUE_BLEND_MODE:
+                    if(list->blend_mode_all_normal) def = true;
+                    break;
+                case LV_STYLE_TEXT_DECOR:
+                    if(list->text_decor_none) def = true;
+                    break;
+            }
+
+            if(def) {
+                break;
+            }
+        }
+
+        lv_state_t state = lv_obj_get_state(parent, part);
+        prop = (uint16_t)prop_ori + ((uint16_t)state << LV_STYLE_STATE_POS);
+
+        res = _lv_style_list_get_int(list, prop, &value_act);
+        if(res == LV_RES_OK) return value_act;
+
+        if(LV_STYLE_ATTR_GET_INHERIT(attr) == 0) break;
+
+        /*If not found, check the `MAIN` style first*/
+        if(part != LV_OBJ_PART_MAIN) {
+            part = LV_OBJ_PART_MAIN;
+            continue;
+        }
+
+        /*Check the parent too.*/
+        parent = lv_obj_get_parent(parent);
+    }
+
+    /*Handle unset values*/
+    prop = prop & (~LV_STYLE_STATE_MASK);
+    switch(prop) {
+        case LV_STYLE_BORDER_SIDE:
+            return LV_BORDER_SIDE_FULL;
+        case LV_STYLE_SIZE:
+            return LV_DPI / 20;
+        case LV_STYLE_SCALE_WIDTH:
+            return LV_DPI / 8;
+        case LV_STYLE_BG_GRAD_STOP:
+            return 255;
+        case LV_STYLE_TRANSFORM_ZOOM:
+            return LV_IMG_ZOOM_NONE;
+    }
+
+    return 0;
+}
+
+/**
+ * Look up a color style property in the style lists of an object and its parents
+ * @param obj pointer to an object
+ * @param part the part of the object
+ * @param prop the property to get
+ * @return the value of the property or its default value
+ */
+static lv_color_t get_style_color(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop)
+{
+    style_cache_stats.resolve_cnt++;
+
+    lv_style_property_t prop_ori = prop;
+
+    lv_style_attr_t attr;
+    attr = prop_ori >> 8;
+
+    lv_color_t value_act;
+    lv_res_t res = LV_RES_INV;
+    const lv_obj_t * parent = obj;
+    while(parent) {
+        lv_style_list_t * list = lv_obj_get_style_list(parent, part);
+
+        lv_state_t state = lv_obj_get_state(parent, part);
+        prop = (uint16_t)prop_ori + ((uint16_t)state << LV_STYLE_STATE_POS);
+
+        res = _lv_style_list_get_color(list, prop, &value_act);
+        if(res == LV_RES_OK) return value_act;
+
+        if(LV_STYLE_ATTR_GET_INHERIT(attr) == 0) break;
+
+        /*If not found, check the `MAIN` style first*/
+        if(part != LV_OBJ_PART_MAIN) {
+            part = LV_OBJ_PART_MAIN;
+            continue;
+        }
+
+        /*Check the parent too.*/
+        parent = lv_obj_get_parent(parent);
+    }
+
+    /*Handle unset values*/
+    prop = prop & (~LV_STYLE_STATE_MASK);
+    switch(prop) {
+        case LV_STYLE_BG_COLOR:
+        case LV_STYLE_BG_GRAD_COLOR:
+            return LV_COLOR_WHITE;
+    }
+
+    return LV_COLOR_BLACK;
+}
+
+/**
+ * Look up an opacity style property in the style lists of an object and its parents
+ * @param obj pointer to an object
+ * @param part the part of the object
+ * @param prop the property to get
+ * @return the value of the property or its default value
+ */
+static lv_opa_t get_style_opa(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop)
+{
+    style_cache_stats.resolve_cnt++;
+
+    lv_style_property_t prop_ori = prop;
+
+    lv_style_attr_t attr;
+    attr = prop_ori >> 8;
+
+    lv_opa_t value_act;
+    lv_res_t res = LV_RES_INV;
+    const lv_obj_t * parent = obj;
+    while(parent) {
+        lv_style_list_t * list = lv_obj_get_style_list(parent, part);
+
+        if(!list->ignore_cache && list->style_cnt > 0) {
+            if(!list->valid_cache) update_style_cache((lv_obj_t *)parent, part, prop  & (~LV_STYLE_STATE_MASK));
+            bool def = false;
+            switch(prop & (~LV_STYLE_STATE_MASK)) {
+                case LV_STYLE_OPA_SCALE:
+                    if(list->opa_scale_cover) def = true;
+                    break;
+                case LV_STYLE_BG_OPA:
+                    if(list->bg_opa_cover) return LV_OPA_COVER;     /*Special case, not the default value is used*/
+                    if(list->bg_opa_transp) def = true;
+                    break;
+                case LV_STYLE_IMAGE_RECOLOR_OPA:
+                    if(list->img_recolor_opa_transp) def = true;
+                    break;
+            }
+
+            if(def) {
+                break;
+            }
+        }
+
+        lv_state_t state = lv_obj_get_state(parent, part);
+        prop = (uint16_t)prop_ori + ((uint16_t)state << LV_STYLE_STATE_POS);
+
+        res = _lv_style_list_get_opa(list, prop, &value_act);
+        if(res == LV_RES_OK) return value_act;
+
+        if(LV_STYLE_ATTR_GET_INHERIT(attr) == 0) break;
+
+        /*If not found, check the `MAIN` style first*/
+        if(part != LV_OBJ_PART_MAIN) {
+            part = LV_OBJ_PART_MAIN;
+            continue;
+        }
+
+        /*Check the parent too.*/
+        parent = lv_obj_get_parent(parent);
+    }
+
+    /*Handle unset values*/
+    prop = prop & (~LV_STYLE_STATE_MASK);
+    switch(prop) {
+        case LV_STYLE_BG_OPA:
+        case LV_STYLE_IMAGE_RECOLOR_OPA:
+        case LV_STYLE_PATTERN_RECOLOR_OPA:
+            return LV_OPA_TRANSP;
+    }
+
+    return LV_OPA_COVER;
+}
+
+/**
+ * Look up a pointer style property in the style lists of an object and its parents
+ * @param obj pointer to an object
+ * @param part the part of the object
+ * @param prop the property to get
+ * @return the value of the property or its default value
+ */
+static const void * get_style_ptr(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop)
+{
+    style_cache_stats.resolve_cnt++;
+
+    lv_style_property_t prop_ori = prop;
+
+    lv_style_attr_t attr;
+    attr = prop_ori >> 8;
+
+    const void * value_act;
+    lv_res_t res = LV_RES_INV;
+    const lv_obj_t * parent = obj;
+    while(parent) {
+        lv_style_list_t * list = lv_obj_get_style_list(parent, part);
+
+        if(!list->ignore_cache && list->style_cnt > 0) {
+            if(!list->valid_cache) update_style_cache((lv_obj_t *)parent, part, prop  & (~LV_STYLE_STATE_MASK));
+            bool def = false;
+            switch(prop  & (~LV_STYLE_STATE_MASK)) {
+                case LV_STYLE_VALUE_STR:
+                    if(list->value_txt_str) def = true;
+                    break;
+                case LV_STYLE_PATTERN_IMAGE:
+                    if(list->pattern_img_null) def = true;
+                    break;
+                case LV_STYLE_TEXT_FONT:
+                    if(list->text_font_normal) def = true;
+                    break;
+            }
+
+            if(def) {
+                break;
+            }
+        }
+
+        lv_state_t state = lv_obj_get_state(parent, part);
+        prop = (uint16_t)prop_ori + ((uint16_t)state << LV_STYLE_STATE_POS);
+
+        res = _lv_style_list_get_ptr(list, prop, &value_act);
+        if(res == LV_RES_OK)  return value_act;
+
+        if(LV_STYLE_ATTR_GET_INHERIT(attr) == 0) break;
+
+        /*If not found, check the `MAIN` style first*/
+        if(part != LV_OBJ_PART_MAIN) {
+            part = LV_OBJ_PART_MAIN;
+            continue;
+        }
+
+        /*Check the parent too.*/
+        parent = lv_obj_get_parent(parent);
+    }
+
+    /*Handle unset values*/
+    prop = prop & (~LV_STYLE_STATE_MASK);
+    switch(prop) {
+        case LV_STYLE_TEXT_FONT:
+        case LV_STYLE_VALUE_FONT:
+            return lv_theme_get_font_normal();
+#if LV_USE_ANIMATION
+        case LV_STYLE_TRANSITION_PATH:
+            return &lv_anim_path_def;
+#endif
+    }
+
+    return NULL;
+}
+
+/**
+ * Initialize a rectangle descriptor from an object's styles without the style cache's copy
+ * @param obj pointer to an object
+ * @param part the part of the object
+ * @param draw_dsc the descriptor the initialize
+ */
+static void init_draw_rect_dsc(lv_obj_t * obj, uint8_t part, lv_draw_rect_dsc_t * draw_dsc)
+{
+    draw_dsc->radius = lv_obj_get_style_radius(obj, part);
+
+#if LV_USE_OPA_SCALE
+    lv_opa_t opa_scale = lv_obj_get_style_opa_scale(obj, part);
+    if(opa_scale <= LV_OPA_MIN) {
+        draw_dsc->bg_opa = LV_OPA_TRANSP;
+        draw_dsc->border_opa = LV_OPA_TRANSP;
+        draw_dsc->shadow_opa = LV_OPA_TRANSP;
+        draw_dsc->pattern_opa = LV_OPA_TRANSP;
+        draw_dsc->value_opa = LV_OPA_TRANSP;
+        return;
+    }
+#endif
+
+    if(draw_dsc->bg_opa != LV_OPA_TRANSP) {
+        draw_dsc->bg_opa = lv_obj_get_style_bg_opa(obj, part);
+        if(draw_dsc->bg_opa > LV_OPA_MIN) {
+            draw_dsc->bg_color = lv_obj_get_style_bg_color(obj, part);
+            draw_dsc->bg_grad_dir =  lv_obj_get_style_bg_grad_dir(obj, part);
+            if(draw_dsc->bg_grad_dir != LV_GRAD_DIR_NONE) {
+                draw_dsc->bg_grad_color = lv_obj_get_style_bg_grad_color(obj, part);
+                draw_dsc->bg_main_color_stop =  lv_obj_get_style_bg_main_stop(obj, part);
+                draw_dsc->bg_grad_color_stop =  lv_obj_get_style_bg_grad_stop(obj, part);
+            }
+
+#if LV_USE_BLEND_MODES
+            draw_dsc->bg_blend_mode = lv_obj_get_style_bg_blend_mode(obj, part);
+#endif
+        }
+    }
+
+    draw_dsc->border_width = lv_obj_get_style_border_width(obj, part);
+    if(draw_dsc->border_width) {
+        if(draw_dsc->border_opa != LV_OPA_TRANSP) {
+            draw_dsc->border_opa = lv_obj_get_style_border_opa(obj, part);
+            if(draw_dsc->border_opa > LV_OPA_MIN) {
+                draw_dsc->border_side = lv_obj_get_style_border_side(obj, part);
+                draw_dsc->border_color = lv_obj_get_style_border_color(obj, part);
+            }
+#if LV_USE_BLEND_MODES
+            draw_dsc->border_blend_mode = lv_obj_get_style_border_blend_mode(obj, part);
+#endif
+        }
+    }
+
+#if LV_USE_OUTLINE
+    draw_dsc->outline_width = lv_obj_get_style_outline_width(obj, part);
+    if(draw_dsc->outline_width) {
+        if(draw_dsc->outline_opa != LV_OPA_TRANSP) {
+            draw_dsc->outline_opa = lv_obj_get_style_outline_opa(obj, part);
+            if(draw_dsc->outline_opa > LV_OPA_MIN) {
+                draw_dsc->outline_pad = lv_obj_get_style_outline_pad(obj, part);
+                draw_dsc->outline_color = lv_obj_get_style_outline_color(obj, part);
+            }
+#if LV_USE_BLEND_MODES
+            draw_dsc->outline_blend_mode = lv_obj_get_style_outline_blend_mode(obj, part);
+#endif
+        }
+    }
+#endif
+
+#if LV_USE_PATTERN
+    draw_dsc->pattern_image = lv_obj_get_style_pattern_image(obj, part);
+    if(draw_dsc->pattern_image) {
+        if(draw_dsc->pattern_opa != LV_OPA_TRANSP) {
+            draw_dsc->pattern_opa = lv_obj_get_style_pattern_opa(obj, part);
+            if(draw_dsc->pattern_opa > LV_OPA_MIN) {
+                draw_dsc->pattern_recolor_opa = lv_obj_get_style_pattern_recolor_opa(obj, part);
+                draw_dsc->pattern_repeat = lv_obj_get_style_pattern_repeat(obj, part);
+                if(lv_img_src_get_type(draw_dsc->pattern_image) == LV_IMG_SRC_SYMBOL) {
+                    draw_dsc->pattern_recolor = lv_obj_get_style_pattern_recolor(obj, part);
+                    draw_dsc->pattern_font = lv_obj_get_style_text_font(obj, part);
+                }
+                else if(draw_dsc->pattern_recolor_opa > LV_OPA_MIN) {
+                    draw_dsc->pattern_recolor = lv_obj_get_style_pattern_recolor(obj, part);
+                }
+#if LV_USE_BLEND_MODES
+                draw_dsc->pattern_blend_mode = lv_obj_get_style_pattern_blend_mode(obj, part);
+#endif
+            }
+        }
+    }
+#endif
+
+#if LV_USE_SHADOW
+    draw_dsc->shadow_width = lv_obj_get_style_shadow_width(obj, part);
+    if(draw_dsc->shadow_width) {
+        if(draw_dsc->shadow_opa > LV_OPA_MIN) {
+            draw_dsc->shadow_opa = lv_obj_get_style_shadow_opa(obj, part);
+            if(draw_dsc->shadow_opa > LV_OPA_MIN) {
+                draw_dsc->shadow_ofs_x = lv_obj_get_style_shadow_ofs_x(obj, part);
+                draw_dsc->shadow_ofs_y = lv_obj_get_style_shadow_ofs_y(obj, part);
+                draw_dsc->shadow_spread = lv_obj_get_style_shadow_spread(obj, part);
+                draw_dsc->shadow_color = lv_obj_get_style_shadow_color(obj, part);
+#if LV_USE_BLEND_MODES
+                draw_dsc->shadow_blend_mode = lv_obj_get_style_shadow_blend_mode(obj, part);
+#endif
+            }
+        }
+    }
+#endif
+
+#if LV_USE_VALUE_STR
+    draw_dsc->value_str = lv_obj_get_style_value_str(obj, part);
+    if(draw_dsc->value_str) {
+        if(draw_dsc->value_opa > LV_OPA_MIN) {
+            draw_dsc->value_opa = lv_obj_get_style_value_opa(obj, part);
+            if(draw_dsc->value_opa > LV_OPA_MIN) {
+                draw_dsc->value_ofs_x = lv_obj_get_style_value_ofs_x(obj, part);
+                draw_dsc->value_ofs_y = lv_obj_get_style_value_ofs_y(obj, part);
+                draw_dsc->value_color = lv_obj_get_style_value_color(obj, part);
+                draw_dsc->value_font = lv_obj_get_style_value_font(obj, part);
+                draw_dsc->value_letter_space = lv_obj_get_style_value_letter_space(obj, part);
+                draw_dsc->value_line_space = lv_obj_get_style_value_line_space(obj, part);
+                draw_dsc->value_align = lv_obj_get_style_value_align(obj, part);
+#if LV_USE_BLEND_MODES
+                draw_dsc->value_blend_mode = lv_obj_get_style_value_blend_mode(obj, part);
+#endif
+            }
+        }
+    }
+#endif
+
+#if LV_USE_OPA_SCALE
+    if(opa_scale < LV_OPA_MAX) {
+        draw_dsc->bg_opa = (uint16_t)((uint16_t)draw_dsc->bg_opa * opa_scale) >> 8;
+        draw_dsc->border_opa = (uint16_t)((uint16_t)draw_dsc->border_opa * opa_scale) >> 8;
+        draw_dsc->shadow_opa = (uint16_t)((uint16_t)draw_dsc->shadow_opa * opa_scale) >> 8;
+        draw_dsc->pattern_opa = (uint16_t)((uint16_t)draw_dsc->pattern_opa * opa_scale) >> 8;
+        draw_dsc->value_opa = (uint16_t)((uint16_t)draw_dsc->value_opa * opa_scale) >> 8;
+    }
+#endif
+}
+
+/**
+ * Invalidate the resolved style properties of all objects
+ */
+static void style_cache_invalidate(void)
+{
+#if LV_STYLE_CACHE_SIZE
+    style_cache_gen++;
+    if(style_cache_gen == 0) style_cache_gen = 1;   /*0 is used by the never filled entries*/
+#endif
+}
+
+/**
+ * Invalidate the resolved style properties of an object's part
+ * @param obj pointer to an object
+ * @param part the part of the object. `LV_OBJ_PART_ALL` or a real part: all parts of the object
+ * @param children true: invalidate the descendants of the object too
+ */
+static void style_cache_invalidate_obj(const lv_obj_t * obj, uint8_t part, bool children)
+{
+#if LV_STYLE_CACHE_SIZE
+    /*The real parts are other objects, i.e. children*/
+    if(part >= _LV_OBJ_PART_REAL_FIRST) {
+        part = LV_OBJ_PART_ALL;
+        children = true;
+    }
+
+    uint32_t i;
+    for(i = 0; i < sizeof(style_cache) / sizeof(style_cache[0]); i++) {
+        style_cache_t * cache = &style_cache[i];
+        /*The outdated entries are not used and they might refer to deleted objects*/
+        if(cache->gen != style_cache_gen) continue;
+
+        if(cache->obj == obj) {
+            if(part == LV_OBJ_PART_ALL || cache->part == part) cache->gen = 0;
+        }
+        else if(children) {
+            const lv_obj_t * par = cache->obj->parent;
+            while(par && par != obj) par = par->parent;
+            if(par) cache->gen = 0;
+        }
+    }
+#else
+    (void)obj;      /*Unused*/
+    (void)part;     /*Unused*/
+    (void)children; /*Unused*/
+#endif
+}
+
+#if LV_STYLE_CACHE_SIZE
+/**
+ * Get the entry of the style cache for an object's part in the current state.
+ * The entry of an other object or state is reused.
+ * @param obj pointer to an object
+ * @param part the part of the object
+ * @return the cache entry or NULL if the style properties of the object can't be cached now
+ */
+static style_cache_t * style_cache_get(const lv_obj_t * obj, uint8_t part)
+{
+    /*The real parts are other objects with their own state*/
+    if(part >= _LV_OBJ_PART_REAL_FIRST) return NULL;
+
+    /*The state might be changed temporarily, or transitions are being created*/
+    if(obj->style_list.ignore_cache) return NULL;
+
+    /*Multiplicative hash: the upper bits depend on all bits of the address*/
+    uint32_t h = ((uint32_t)((lv_uintptr_t)obj >> 3) ^ part) * 2654435761U;
+    uint32_t set = (h >> 16) % STYLE_CACHE_SETS;
+    style_cache_t * ways = &style_cache[set * STYLE_CACHE_WAYS];
+    uint8_t w;
+    style_cache_tick++;
+    for(w = 0; w < STYLE_CACHE_WAYS; w++) {
+        if(style_cache_is_for(&ways[w], obj, part, style_cache_gen)) {
+            ways[w].used = style_cache_tick;
+            return &ways[w];
+        }
+    }
+
+    /* Reuse an outdated entry or the most recently used one.
+     * The objects are drawn in the same order in every frame so the least recently used entry would be needed soon.
+     * Replacing always the same entry keeps the others when the scene doesn't fit into the cache.*/
+    uint8_t victim = 0;
+    for(w = 0; w < STYLE_CACHE_WAYS; w++) {
+        if(ways[w].gen != style_cache_gen) {
+            victim = w;
+            break;
+        }
+        if(style_cache_tick - ways[w].used < style_cache_tick - ways[victim].used) victim = w;
+    }
+
+    style_cache_t * cache = &ways[victim];
+    cache->used = style_cache_tick;
+    cache->obj = obj;
+    cache->part = part;
+    cache->state = obj->state;
+    cache->gen = style_cache_gen;
+    cache->rect_valid = 0;
+    _lv_memset_00(cache->resolved, sizeof(cache->resolved));
+
+    return cache;
+}
+
+/**
+ * Tell whether a cache entry stores the style properties of an object's part in the current state
+ * @param cache pointer to a cache entry
+ * @param obj pointer to an object
+ * @param part the part of the object
+ * @param gen the value of `style_cache_gen` when the entry was got
+ * @return true: the entry is for the object's part
+ */
+static bool style_cache_is_for(const style_cache_t * cache, const lv_obj_t * obj, uint8_t part, uint32_t gen)
+{
+    return cache->obj == obj && cache->part == part && cache->state == obj->state &&
+           cache->gen == gen && gen == style_cache_gen;
+}
+#endif
@@ -166,6 +166,31 @@ typedef struct {
 } lv_realign_t;
 #endif
 
+/*Store the rarely used attributes of the objects in a separately allocated `lv_obj_spec_attr_t`*/
+#define _LV_OBJ_SPEC_ATTR   (LV_USE_OBJ_COMPACT && (LV_USE_GROUP || LV_USE_OBJ_REALIGN || LV_USE_USER_DATA || \
+                                                    LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_FULL))
+
+#if _LV_OBJ_SPEC_ATTR
+/** The rarely used attributes of an object. Allocated only when one of them is set. */
+typedef struct {
+#if LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_FULL
+    lv_area_t ext_click_pad;   /**< Extra click padding area. */
+#endif
+
+#if LV_USE_GROUP
+    void * group_p;
+#endif
+
+#if LV_USE_OBJ_REALIGN
+    lv_realign_t realign;       /**< Information about the last call to ::lv_obj_align. */
+#endif
+
+#if LV_USE_USER_DATA
+    lv_obj_user_data_t user_data; /**< Custom user data for object. */
+#endif
+} lv_obj_spec_attr_t;
+#endif
+
 /*Protect some attributes (max. 8 bit)*/
 enum {
     LV_PROTECT_NONE      = 0x00,
@@ -195,7 +220,13 @@ typedef uint8_t lv_state_t;
 
 typedef struct _lv_obj_t {
     struct _lv_obj_t * parent; /**< Pointer to the parent object*/
+#if LV_USE_OBJ_COMPACT
+    struct _lv_obj_t * child_head;  /**< The youngest child. Its `sib_prev` is the oldest child*/
+    struct _lv_obj_t * sib_next;    /**< The next older sibling or NULL*/
+    struct _lv_obj_t * sib_prev;    /**< The next younger sibling. The oldest sibling if this is the youngest*/
+#else
     lv_ll_t child_ll;       /**< Linked list to store the children objects*/
+#endif
 
     lv_area_t coords; /**< Coordinates of the object (x1, y1, x2, y2)*/
 
@@ -209,7 +240,7 @@ typedef struct _lv_obj_t {
 #if LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_TINY
     uint8_t ext_click_pad_hor; /**< Extra click padding in horizontal direction */
     uint8_t ext_click_pad_ver; /**< Extra click padding in vertical direction */
-#elif LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_FULL
+#elif LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_FULL && LV_USE_OBJ_COMPACT == 0
     lv_area_t ext_click_pad;   /**< Extra click padding area. */
 #endif
 
@@ -229,8 +260,9 @@ typedef struct _lv_obj_t {
 
     lv_drag_dir_t drag_dir  : 3; /**<  Which directions the object can be dragged in */
     lv_bidi_dir_t base_dir  : 2; /**< Base direction of texts related to this object */
+    uint8_t layout_pending  : 1;  /**< 1: `LV_SIGNAL_CHILD_CHG` is postponed until the layout is resumed*/
 
-#if LV_USE_GROUP != 0
+#if LV_USE_GROUP != 0 && LV_USE_OBJ_COMPACT == 0
     void * group_p;
 #endif
 
@@ -238,6 +270,9 @@ typedef struct _lv_obj_t {
                                      'OR'ed values from `lv_protect_t`*/
     lv_state_t state;
 
+#if _LV_OBJ_SPEC_ATTR
+    lv_obj_spec_attr_t * spec_attr; /**< Rarely used attributes. NULL until one of them is set*/
+#elif LV_USE_OBJ_COMPACT == 0
 #if LV_USE_OBJ_REALIGN
     lv_realign_t realign;       /**< Information about the last call to ::lv_obj_align. */
 #endif
@@ -245,6 +280,7 @@ typedef struct _lv_obj_t {
 #if LV_USE_USER_DATA
     lv_obj_user_data_t user_data; /**< Custom user data for object. */
 #endif
+#endif
 
 } lv_obj_t;
 
@@ -278,6 +314,13 @@ typedef struct {
     lv_state_t result;
 } lv_get_state_info_t;
 
+/** Statistics of the style cache. See `LV_STYLE_CACHE_SIZE`*/
+typedef struct {
+    uint32_t lookup_cnt;        /**< Number of style properties asked*/
+    uint32_t resolve_cnt;       /**< Number of style properties looked up in the style lists*/
+    uint32_t rect_copy_cnt;     /**< Number of rectangle descriptors copied from the cache*/
+} lv_style_cache_stats_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -332,11 +375,29 @@ void lv_obj_del_anim_ready_cb(lv_anim_t * a);
 void lv_obj_del_async(struct _lv_obj_t * obj);
 
 /**
- * Delete all children of an object
+ * Delete all children of an object.
+ * The object is invalidated and gets `LV_SIGNAL_CHILD_CHG` only once.
  * @param obj pointer to an object
  */
 void lv_obj_clean(lv_obj_t * obj);
 
+/**
+ * Suspend the layout of an object and its children, e.g. to create or delete many children.
+ * Until `lv_obj_resume_layout()` the objects don't get `LV_SIGNAL_CHILD_CHG`
+ * and the children are not invalidated. So the position and size of the children might be not up to date.
+ * At most 8 objects can be suspended at the same time.
+ * @param obj pointer to an object
+ */
+void lv_obj_suspend_layout(lv_obj_t * obj);
+
+/**
+ * Resume the layout of an object suspended by `lv_obj_suspend_layout()`.
+ * The objects which got new or deleted children get one `LV_SIGNAL_CHILD_CHG` (the children first)
+ * and the object is invalidated.
+ * @param obj pointer to an object
+ */
+void lv_obj_resume_layout(lv_obj_t * obj);
+
 /**
  * Mark an area of an object as invalid.
  * This area will be redrawn by 'lv_refr_task'
@@ -562,7 +623,7 @@ void lv_obj_set_ext_click_area(lv_obj_t * obj, lv_coord_t left, lv_coord_t right
  * E.g. `LV_OBJ_PART_MAIN`, `LV_BTN_PART_MAIN`, `LV_SLIDER_PART_KNOB`
  * @param style pointer to a style to add (Only its pointer will be saved)
  */
-void lv_obj_add_style(lv_obj_t * obj, uint8_t part, lv_style_t * style);
+void lv_obj_add_style(lv_obj_t * obj, uint8_t part, const lv_style_t * style);
 
 /**
  * Remove a style from the style list of an object.
@@ -571,7 +632,7 @@ void lv_obj_add_style(lv_obj_t * obj, uint8_t part, lv_style_t * style);
  * E.g. `LV_OBJ_PART_MAIN`, `LV_BTN_PART_MAIN`, `LV_SLIDER_PART_KNOB`
  * @param style pointer to a style to remove
  */
-void lv_obj_remove_style(lv_obj_t * obj, uint8_t part, lv_style_t * style);
+void lv_obj_remove_style(lv_obj_t * obj, uint8_t part, const lv_style_t * style);
 
 /**
  * Reset a style to the default (empty) state.
@@ -680,9 +741,21 @@ bool lv_obj_remove_style_local_prop(lv_obj_t * obj, uint8_t part, lv_style_prope
  * Enable/disable the use of style cache for an object
  * @param obj pointer to an object
  * @param dis true: disable; false: enable (re-enable)
+ * @note while disabled the object's state can be changed temporarily to get its style properties in other states
  */
 void _lv_obj_disable_style_caching(lv_obj_t * obj, bool dis);
 
+/**
+ * Get the statistics of the style cache
+ * @param stats store the statistics here
+ */
+void lv_obj_get_style_cache_stats(lv_style_cache_stats_t * stats);
+
+/**
+ * Reset the counters of the style cache
+ */
+void lv_obj_reset_style_cache_stats(void);
+
 /*-----------------
  * Attribute set
  *----------------*/
@@ -975,6 +1048,39 @@ uint16_t lv_obj_count_children(const lv_obj_t * obj);
  */
 uint16_t lv_obj_count_children_recursive(const lv_obj_t * obj);
 
+/**
+ * Get the next older child of an object. Same as `lv_obj_get_child()` but can be inlined.
+ * @param parent pointer to an object
+ * @param child NULL to get the youngest child or the previous return value
+ * @return the next child or NULL if no more child
+ */
+static inline lv_obj_t * _lv_obj_get_child_next(const lv_obj_t * parent, const lv_obj_t * child)
+{
+#if LV_USE_OBJ_COMPACT
+    return child == NULL ? parent->child_head : child->sib_next;
+#else
+    if(child == NULL) return (lv_obj_t *)_lv_ll_get_head(&parent->child_ll);
+    else return (lv_obj_t *)_lv_ll_get_next(&parent->child_ll, child);
+#endif
+}
+
+/**
+ * Get the next younger child of an object. Same as `lv_obj_get_child_back()` but can be inlined.
+ * @param parent pointer to an object
+ * @param child NULL to get the oldest child or the previous return value
+ * @return the next child or NULL if no more child
+ */
+static inline lv_obj_t * _lv_obj_get_child_prev(const lv_obj_t * parent, const lv_obj_t * child)
+{
+#if LV_USE_OBJ_COMPACT
+    if(child == NULL) return parent->child_head ? parent->child_head->sib_prev : NULL;
+    else return child == parent->child_head ? NULL : child->sib_prev;
+#else
+    if(child == NULL) return (lv_obj_t *)_lv_ll_get_tail(&parent->child_ll);
+    else return (lv_obj_t *)_lv_ll_get_prev(&parent->child_ll, child);
+#endif
+}
+
 /*---------------------
  * Coordinate get
  *--------------------*/
@@ -1305,6 +1411,22 @@ uint8_t lv_obj_get_protect(const lv_obj_t * obj);
  */
 bool lv_obj_is_protected(const lv_obj_t * obj, uint8_t prot);
 
+/**
+ * Tell whether the layout of an object or one of its ancestors is suspended by `lv_obj_suspend_layout()`
+ * @param obj pointer to an object
+ * @return true: the layout is suspended
+ */
+bool lv_obj_is_layout_suspended(const lv_obj_t * obj);
+
+/**
+ * Postpone the layout refresh of an object if its layout is suspended.
+ * It will get `LV_SIGNAL_CHILD_CHG` when the layout is resumed.
+ * Used by the object types with layout not related to the children (e.g. the table's size).
+ * @param obj pointer to an object
+ * @return true: postponed, the layout shouldn't be refreshed now; false: refresh the layout now
+ */
+bool _lv_obj_postpone_layout(lv_obj_t * obj);
+
 lv_state_t lv_obj_get_state(const lv_obj_t * obj, uint8_t part);
 
 /**
@@ -1397,6 +1519,15 @@ void lv_obj_set_user_data(lv_obj_t * obj, lv_obj_user_data_t data);
  */
 void * lv_obj_get_group(const lv_obj_t * obj);
 
+#if LV_USE_GROUP
+/**
+ * Set the group of an object. Used by the groups when an object is added or removed.
+ * @param obj pointer to an object
+ * @param group pointer to a group or NULL to remove the object from its group
+ */
+void _lv_obj_set_group(lv_obj_t * obj, void * group);
+#endif
+
 /**
  * Tell whether the object is the focused object of a group or not.
  * @param obj pointer to an object
@@ -1498,6 +1629,22 @@ bool lv_debug_check_obj_valid(const lv_obj_t * obj);
  */
 #define LV_EVENT_CB_DECLARE(name) static void name(lv_obj_t * obj, lv_event_t e)
 
+/**
+ * Iterate through the children of an object from the youngest to the oldest
+ * @param parent pointer to an object
+ * @param child pointer to an object to use as iterator
+ */
+#define _LV_OBJ_CHILD_READ(parent, child) \
+    for(child = _lv_obj_get_child_next(parent, NULL); child != NULL; child = _lv_obj_get_child_next(parent, child))
+
+/**
+ * Iterate through the children of an object from the oldest to the youngest
+ * @param parent pointer to an object
+ * @param child pointer to an object to use as iterator
+ */
+#define _LV_OBJ_CHILD_READ_BACK(parent, child) \
+    for(child = _lv_obj_get_child_prev(parent, NULL); child != NULL; child = _lv_obj_get_child_prev(parent, child))
+
 #if LV_USE_DEBUG
 
 # ifndef LV_DEBUG_IS_OBJ
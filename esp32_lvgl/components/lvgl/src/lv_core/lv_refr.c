@@ -508,6 +508,10 @@ static void lv_refr_area_part(const lv_area_t * area_p)
         }
     }
 
+    /*The temporary buffers of the drawing are not needed after this part.
+     *Releasing them per part (not per frame) lets the next part reuse the same memory*/
+    uint32_t buf_mark = _lv_mem_buf_mark();
+
     lv_obj_t * top_act_scr = NULL;
     lv_obj_t * top_prev_scr = NULL;
 
@@ -570,6 +574,8 @@ static void lv_refr_area_part(const lv_area_t * area_p)
     lv_refr_obj_and_children(lv_disp_get_layer_top(disp_refr), &start_mask);
     lv_refr_obj_and_children(lv_disp_get_layer_sys(disp_refr), &start_mask);
 
+    _lv_mem_buf_release_to(buf_mark);
+
     /* In true double buffered mode flush only once when all areas were rendered.
      * In normal mode flush after every area */
     if(lv_disp_is_true_double_buf(disp_refr) == false) {
@@ -599,7 +605,7 @@ static lv_obj_t * lv_refr_get_top_obj(const lv_area_t * area_p, lv_obj_t * obj)
 #endif
 
         lv_obj_t * i;
-        _LV_LL_READ(obj->child_ll, i) {
+        _LV_OBJ_CHILD_READ(obj, i) {
             found_p = lv_refr_get_top_obj(area_p, i);
 
             /*If a children is ok then break*/
@@ -644,12 +650,12 @@ static void lv_refr_obj_and_children(lv_obj_t * top_p, const lv_area_t * mask_p)
     /*Do until not reach the screen*/
     while(par != NULL) {
         /*object before border_p has to be redrawn*/
-        lv_obj_t * i = _lv_ll_get_prev(&(par->child_ll), border_p);
+        lv_obj_t * i = _lv_obj_get_child_prev(par, border_p);
 
         while(i != NULL) {
             /*Refresh the objects*/
             lv_refr_obj(i, mask_p);
-            i = _lv_ll_get_prev(&(par->child_ll), i);
+            i = _lv_obj_get_child_prev(par, i);
         }
 
         /*Call the post draw design function of the parents of the to object*/
@@ -717,7 +723,7 @@ static void lv_refr_obj(lv_obj_t * obj, const lv_area_t * mask_ori_p)
             lv_area_t mask_child; /*Mask from obj and its child*/
             lv_obj_t * child_p;
             lv_area_t child_area;
-            _LV_LL_READ_BACK(obj->child_ll, child_p) {
+            _LV_OBJ_CHILD_READ_BACK(obj, child_p) {
                 lv_obj_get_coords(child_p, &child_area);
                 ext_size = child_p->ext_draw_pad;
                 child_area.x1 -= ext_size;
@@ -12,11 +12,27 @@
 /*********************
  *      DEFINES
  *********************/
+/*The first property ID of an indexed style instead of a real property*/
+#define STYLE_INDEXED_MARK      0xFE
+
+/*Number of property IDs: 13 groups with 16 IDs*/
+#define STYLE_INDEXED_ID_NUM    0xD0
+#define STYLE_INDEXED_WORDS     ((STYLE_INDEXED_ID_NUM + 31) / 32)
 
 /**********************
  *      TYPEDEFS
  **********************/
 
+/* Header of the indexed storage of the properties.
+ * It's followed by `id_cnt + 1` `uint16_t` indices of the first property with every ID,
+ * then the properties sorted by ID like in the byte map, closed by `_LV_STYLE_CLOSING_PROP`.*/
+typedef struct {
+    lv_style_property_t mark;               /*`STYLE_INDEXED_MARK` to tell it from the byte map*/
+    uint8_t id_cnt;                         /*Number of different property IDs*/
+    uint8_t rank[STYLE_INDEXED_WORDS];      /*Number of IDs in the previous words of `has`*/
+    uint32_t has[STYLE_INDEXED_WORDS];      /*1 bit for every property ID found in the style*/
+} style_indexed_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
@@ -28,6 +44,16 @@ static inline uint8_t get_style_prop_id(const lv_style_t * style, size_t idx);
 static inline uint8_t get_style_prop_attr(const lv_style_t * style, size_t idx);
 static inline size_t get_prop_size(uint8_t prop_id);
 static inline size_t get_next_prop_index(uint8_t prop_id, size_t id);
+static inline bool is_indexed(const lv_style_t * style);
+static inline bool is_const(const lv_style_t * style);
+static bool is_writable(const lv_style_t * style);
+static inline int16_t get_state_weight(lv_style_attr_t attr_prop, lv_style_attr_t attr_goal);
+static inline size_t get_first_prop_index(const lv_style_t * style);
+static inline uint32_t get_id_rank(const style_indexed_t * indexed, uint8_t prop_id);
+static inline uint32_t count_bits(uint32_t v);
+static void add_prop(lv_style_t * style, lv_style_property_t prop, const void * value, size_t value_size);
+static uint8_t * index_props(const lv_style_t * style, const uint8_t * new_prop, int32_t removed);
+static size_t index_prop(const uint8_t * prop_p, uint8_t pass, style_indexed_t * indexed, uint8_t * map);
 
 /**********************
  *  GLOBAL VARIABLES
@@ -65,6 +91,13 @@ void lv_style_init(lv_style_t * style)
 void lv_style_copy(lv_style_t * style_dest, const lv_style_t * style_src)
 {
     LV_ASSERT_STYLE(style_dest);
+    if(!is_writable(style_dest)) return;
+
+    if(style_src && is_const(style_src)) {
+        const lv_style_const_map_t * const_map = (const lv_style_const_map_t *)style_src->map;
+        lv_style_build(style_dest, const_map->values, const_map->value_cnt);
+        return;
+    }
 
     uint16_t size = _lv_style_get_mem_size(style_src);
     if(size == 0) return;
@@ -83,6 +116,8 @@ void lv_style_copy(lv_style_t * style_dest, const lv_style_t * style_src)
  */
 bool lv_style_remove_prop(lv_style_t * style, lv_style_property_t prop)
 {
+    if(!is_writable(style)) return false;
+
     int32_t id = get_property_index(style, prop);
     /*The property exists but not sure it's state is the same*/
     if(id >= 0) {
@@ -93,6 +128,14 @@ bool lv_style_remove_prop(lv_style_t * style, lv_style_property_t prop)
         attr_goal = (prop >> 8) & 0xFFU;
 
         if(LV_STYLE_ATTR_GET_STATE(attr_found) == LV_STYLE_ATTR_GET_STATE(attr_goal)) {
+            if(is_indexed(style)) {
+                uint8_t * new_map = index_props(style, NULL, id);
+                if(new_map == NULL) return false;
+                lv_mem_free(style->map);
+                style->map = new_map;
+                return true;
+            }
+
             uint32_t map_size = _lv_style_get_mem_size(style);
             uint8_t prop_size = get_prop_size(prop);
 
@@ -111,6 +154,83 @@ bool lv_style_remove_prop(lv_style_t * style, lv_style_property_t prop)
     return false;
 }
 
+/**
+ * Set all properties of a style at once in the indexed storage.
+ * The properties are allocated in one block and can be looked up without searching through all of them.
+ * The earlier properties of the style are removed.
+ * @param style pointer to an initialized style
+ * @param values array of properties with their values. Every property should be listed only once in a state.
+ * @param value_cnt number of elements in `values`
+ * @return true: success; false: out of memory, the style is not changed
+ */
+bool lv_style_build(lv_style_t * style, const lv_style_value_t values[], uint16_t value_cnt)
+{
+    LV_ASSERT_STYLE(style);
+    if(!is_writable(style)) return false;
+
+    /*Pack the properties like in the byte map temporarily*/
+    size_t size = sizeof(lv_style_property_t);
+    uint16_t i;
+    for(i = 0; i < value_cnt; i++) size += get_prop_size(values[i].prop & 0xFF);
+
+    uint8_t * packed_map = _lv_mem_buf_get(size);
+    if(packed_map == NULL) return false;
+
+    size_t idx = 0;
+    for(i = 0; i < value_cnt; i++) {
+        size_t value_size = get_prop_size(values[i].prop & 0xFF) - sizeof(lv_style_property_t);
+        _lv_memcpy_small(packed_map + idx, &values[i].prop, sizeof(lv_style_property_t));
+        _lv_memcpy_small(packed_map + idx + sizeof(lv_style_property_t), &values[i].value, value_size);
+        idx += sizeof(lv_style_property_t) + value_size;
+    }
+    lv_style_property_t end_mark = _LV_STYLE_CLOSING_PROP;
+    _lv_memcpy_small(packed_map + idx, &end_mark, sizeof(end_mark));
+
+    lv_style_t packed;
+    lv_style_init(&packed);
+    packed.map = packed_map;
+    uint8_t * new_map = index_props(&packed, NULL, -1);
+    _lv_mem_buf_release(packed_map);
+    if(new_map == NULL) return false;
+
+    lv_mem_free(style->map);
+    style->map = new_map;
+    return true;
+}
+
+/**
+ * Convert the properties of a style to the indexed storage.
+ * The next `lv_style_set_...()` and `lv_style_remove_prop()` calls keep the style indexed.
+ * @param style pointer to a style
+ * @return true: success; false: out of memory, the style is not changed
+ */
+bool lv_style_index(lv_style_t * style)
+{
+    LV_ASSERT_STYLE(style);
+    if(!is_writable(style)) return false;
+
+    if(is_indexed(style)) return true;
+
+    uint8_t * new_map = index_props(style, NULL, -1);
+    if(new_map == NULL) return false;
+
+    lv_mem_free(style->map);
+    style->map = new_map;
+    return true;
+}
+
+/**
+ * Tell whether a style was created by `LV_STYLE_CONST_INIT()`
+ * @param style pointer to a style
+ * @return true: the style is constant and can't be modified
+ */
+bool lv_style_is_const(const lv_style_t * style)
+{
+    LV_ASSERT_STYLE(style);
+
+    return style != NULL && is_const(style);
+}
+
 /**
  * Initialize a style list
  * @param list a style list to initialize
@@ -183,7 +303,7 @@ void lv_style_list_copy(lv_style_list_t * list_dest, const lv_style_list_t * lis
  * @param list pointer to a style list
  * @param style pointer to a style to add
  */
-void _lv_style_list_add_style(lv_style_list_t * list, lv_style_t * style)
+void _lv_style_list_add_style(lv_style_list_t * list, const lv_style_t * style)
 {
     LV_ASSERT_STYLE_LIST(list);
     LV_ASSERT_STYLE(style);
@@ -211,7 +331,8 @@ void _lv_style_list_add_style(lv_style_list_t * list, lv_style_t * style)
         new_styles[i] = new_styles[i - 1];
     }
 
-    new_styles[first_style] = style;
+    /*Constant styles are stored too. The setters never write them, see `lv_style_is_const()`*/
+    new_styles[first_style] = (lv_style_t *)style;
     list->style_cnt++;
     list->style_list = new_styles;
 }
@@ -221,7 +342,7 @@ void _lv_style_list_add_style(lv_style_list_t * list, lv_style_t * style)
  * @param style_list pointer to a style list
  * @param style pointer to a style to remove
  */
-void _lv_style_list_remove_style(lv_style_list_t * list, lv_style_t * style)
+void _lv_style_list_remove_style(lv_style_list_t * list, const lv_style_t * style)
 {
     LV_ASSERT_STYLE_LIST(list);
     LV_ASSERT_STYLE(style);
@@ -309,6 +430,8 @@ void _lv_style_list_reset(lv_style_list_t * list)
  */
 void lv_style_reset(lv_style_t * style)
 {
+    if(!is_writable(style)) return;
+
     lv_mem_free(style->map);
     lv_style_init(style);
 }
@@ -324,7 +447,10 @@ uint16_t _lv_style_get_mem_size(const lv_style_t * style)
 
     if(style == NULL || style->map == NULL) return 0;
 
-    size_t i = 0;
+    /*Constant styles use no RAM*/
+    if(is_const(style)) return 0;
+
+    size_t i = get_first_prop_index(style);
     uint8_t prop_id;
     while((prop_id = get_style_prop_id(style, i)) != _LV_STYLE_CLOSING_PROP) {
         i = get_next_prop_index(prop_id, i);
@@ -345,6 +471,8 @@ uint16_t _lv_style_get_mem_size(const lv_style_t * style)
  */
 void _lv_style_set_int(lv_style_t * style, lv_style_property_t prop, lv_style_int_t value)
 {
+    if(!is_writable(style)) return;
+
     int32_t id = get_property_index(style, prop);
     /*The property already exists but not sure it's state is the same*/
     if(id >= 0) {
@@ -361,19 +489,7 @@ void _lv_style_set_int(lv_style_t * style, lv_style_property_t prop, lv_style_in
     }
 
     /*Add new property if not exists yet*/
-    uint8_t new_prop_size = sizeof(lv_style_property_t) + sizeof(lv_style_int_t);
-    lv_style_property_t end_mark = _LV_STYLE_CLOSING_PROP;
-    uint8_t end_mark_size = sizeof(end_mark);
-
-    uint16_t size = _lv_style_get_mem_size(style);
-    if(size == 0) size += end_mark_size;
-
-    size += new_prop_size;
-    if(!style_resize(style, size)) return;
-
-    _lv_memcpy_small(style->map + size - new_prop_size - end_mark_size, &prop, sizeof(lv_style_property_t));
-    _lv_memcpy_small(style->map + size - sizeof(lv_style_int_t) - end_mark_size, &value, sizeof(lv_style_int_t));
-    _lv_memcpy_small(style->map + size - end_mark_size, &end_mark, sizeof(end_mark));
+    add_prop(style, prop, &value, sizeof(lv_style_int_t));
 }
 
 /**
@@ -388,6 +504,8 @@ void _lv_style_set_int(lv_style_t * style, lv_style_property_t prop, lv_style_in
  */
 void _lv_style_set_color(lv_style_t * style, lv_style_property_t prop, lv_color_t color)
 {
+    if(!is_writable(style)) return;
+
     int32_t id = get_property_index(style, prop);
     /*The property already exists but not sure it's state is the same*/
     if(id >= 0) {
@@ -404,19 +522,7 @@ void _lv_style_set_color(lv_style_t * style, lv_style_property_t prop, lv_color_
     }
 
     /*Add new property if not exists yet*/
-    uint8_t new_prop_size = sizeof(lv_style_property_t) + sizeof(lv_color_t);
-    lv_style_property_t end_mark = _LV_STYLE_CLOSING_PROP;
-    uint8_t end_mark_size = sizeof(end_mark);
-
-    uint16_t size = _lv_style_get_mem_size(style);
-    if(size == 0) size += end_mark_size;
-
-    size += new_prop_size;
-    if(!style_resize(style, size)) return;
-
-    _lv_memcpy_small(style->map + size - new_prop_size - end_mark_size, &prop, sizeof(lv_style_property_t));
-    _lv_memcpy_small(style->map + size - sizeof(lv_color_t) - end_mark_size, &color, sizeof(lv_color_t));
-    _lv_memcpy_small(style->map + size - end_mark_size, &end_mark, sizeof(end_mark));
+    add_prop(style, prop, &color, sizeof(lv_color_t));
 }
 
 /**
@@ -431,6 +537,8 @@ void _lv_style_set_color(lv_style_t * style, lv_style_property_t prop, lv_color_
  */
 void _lv_style_set_opa(lv_style_t * style, lv_style_property_t prop, lv_opa_t opa)
 {
+    if(!is_writable(style)) return;
+
     int32_t id = get_property_index(style, prop);
     /*The property already exists but not sure it's state is the same*/
     if(id >= 0) {
@@ -447,19 +555,7 @@ void _lv_style_set_opa(lv_style_t * style, lv_style_property_t prop, lv_opa_t op
     }
 
     /*Add new property if not exists yet*/
-    uint8_t new_prop_size = sizeof(lv_style_property_t) + sizeof(lv_opa_t);
-    lv_style_property_t end_mark = _LV_STYLE_CLOSING_PROP;
-    uint8_t end_mark_size = sizeof(end_mark);
-
-    uint16_t size = _lv_style_get_mem_size(style);
-    if(size == 0) size += end_mark_size;
-
-    size += new_prop_size;
-    if(!style_resize(style, size)) return;
-
-    _lv_memcpy_small(style->map + size - new_prop_size - end_mark_size, &prop, sizeof(lv_style_property_t));
-    _lv_memcpy_small(style->map + size - sizeof(lv_opa_t) - end_mark_size, &opa, sizeof(lv_opa_t));
-    _lv_memcpy_small(style->map + size - end_mark_size, &end_mark, sizeof(end_mark));
+    add_prop(style, prop, &opa, sizeof(lv_opa_t));
 }
 
 /**
@@ -474,6 +570,8 @@ void _lv_style_set_opa(lv_style_t * style, lv_style_property_t prop, lv_opa_t op
  */
 void _lv_style_set_ptr(lv_style_t * style, lv_style_property_t prop, const void * p)
 {
+    if(!is_writable(style)) return;
+
     int32_t id = get_property_index(style, prop);
     /*The property already exists but not sure it's state is the same*/
     if(id >= 0) {
@@ -490,19 +588,7 @@ void _lv_style_set_ptr(lv_style_t * style, lv_style_property_t prop, const void
     }
 
     /*Add new property if not exists yet*/
-    uint8_t new_prop_size = sizeof(lv_style_property_t) + sizeof(const void *);
-    lv_style_property_t end_mark = _LV_STYLE_CLOSING_PROP;
-    uint8_t end_mark_size = sizeof(end_mark);
-
-    uint16_t size = _lv_style_get_mem_size(style);
-    if(size == 0) size += end_mark_size;
-
-    size += new_prop_size;
-    if(!style_resize(style, size)) return;
-
-    _lv_memcpy_small(style->map + size - new_prop_size - end_mark_size, &prop, sizeof(lv_style_property_t));
-    _lv_memcpy_small(style->map + size - sizeof(const void *) - end_mark_size, &p, sizeof(const void *));
-    _lv_memcpy_small(style->map + size - end_mark_size, &end_mark, sizeof(end_mark));
+    add_prop(style, prop, &p, sizeof(const void *));
 }
 
 /**
@@ -521,6 +607,11 @@ int16_t _lv_style_get_int(const lv_style_t * style, lv_style_property_t prop, lv
     if(id < 0) {
         return -1;
     }
+    else if(is_const(style)) {
+        const lv_style_value_t * v = &((const lv_style_const_map_t *)style->map)->values[id];
+        *res = v->value.num;
+        return LV_STYLE_ATTR_GET_STATE(v->prop >> 8);
+    }
     else {
         _lv_memcpy_small(res, &style->map[id + sizeof(lv_style_property_t)], sizeof(lv_style_int_t));
         lv_style_attr_t attr_act;
@@ -549,6 +640,11 @@ int16_t _lv_style_get_opa(const lv_style_t * style, lv_style_property_t prop, lv
     if(id < 0) {
         return -1;
     }
+    else if(is_const(style)) {
+        const lv_style_value_t * v = &((const lv_style_const_map_t *)style->map)->values[id];
+        *res = v->value.opa;
+        return LV_STYLE_ATTR_GET_STATE(v->prop >> 8);
+    }
     else {
         _lv_memcpy_small(res, &style->map[id + sizeof(lv_style_property_t)], sizeof(lv_opa_t));
         lv_style_attr_t attr_act;
@@ -577,6 +673,11 @@ int16_t _lv_style_get_color(const lv_style_t * style, lv_style_property_t prop,
     if(id < 0) {
         return -1;
     }
+    else if(is_const(style)) {
+        const lv_style_value_t * v = &((const lv_style_const_map_t *)style->map)->values[id];
+        *res = v->value.color;
+        return LV_STYLE_ATTR_GET_STATE(v->prop >> 8);
+    }
     else {
         _lv_memcpy_small(res, &style->map[id + sizeof(lv_style_property_t)], sizeof(lv_color_t));
         lv_style_attr_t attr_act;
@@ -605,6 +706,11 @@ int16_t _lv_style_get_ptr(const lv_style_t * style, lv_style_property_t prop, co
     if(id < 0) {
         return -1;
     }
+    else if(is_const(style)) {
+        const lv_style_value_t * v = &((const lv_style_const_map_t *)style->map)->values[id];
+        *res = v->value.ptr;
+        return LV_STYLE_ATTR_GET_STATE(v->prop >> 8);
+    }
     else {
         _lv_memcpy_small(res, &style->map[id + sizeof(lv_style_property_t)], sizeof(const void *));
         lv_style_attr_t attr_act;
@@ -976,6 +1082,18 @@ bool lv_debug_check_style_list(const lv_style_list_t * list)
     return true;
 }
 
+/**
+ * Check whether a style can be modified (not a constant style)
+ * @param style pointer to a style
+ * @return true: can be modified
+ */
+bool lv_debug_check_style_writable(const lv_style_t * style)
+{
+    if(style == NULL) return true;
+
+    return !is_const(style);
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -1002,27 +1120,50 @@ LV_ATTRIBUTE_FAST_MEM static inline int32_t get_property_index(const lv_style_t
     int16_t weight = -1;
     int16_t id_guess = -1;
 
+    /*In constant styles the index of the `lv_style_value_t` is returned*/
+    if(is_const(style)) {
+        const lv_style_const_map_t * const_map = (const lv_style_const_map_t *)style->map;
+        uint16_t v;
+        for(v = 0; v < const_map->value_cnt; v++) {
+            lv_style_property_t prop_v = const_map->values[v].prop;
+            if((prop_v & 0xFF) != id_to_find) continue;
+
+            int16_t weight_v = get_state_weight((prop_v >> 8) & 0xFF, attr);
+            if(weight_v == INT16_MAX) return v;
+            if(weight_v > weight) {
+                weight = weight_v;
+                id_guess = v;
+            }
+        }
+        return id_guess;
+    }
+
+    /*The byte map is searched until `_LV_STYLE_CLOSING_PROP`*/
     size_t i = 0;
+    size_t end = UINT16_MAX;
+
+    /*In indexed styles only the properties with the same ID are checked*/
+    if(is_indexed(style)) {
+        const style_indexed_t * indexed = (const style_indexed_t *)style->map;
+        if(id_to_find >= STYLE_INDEXED_ID_NUM) return -1;
+        if((indexed->has[id_to_find >> 5] & ((uint32_t)1 << (id_to_find & 0x1F))) == 0) return -1;
+
+        const uint16_t * start = (const uint16_t *)(style->map + sizeof(style_indexed_t));
+        uint32_t rank = get_id_rank(indexed, id_to_find);
+        i = start[rank];
+        end = start[rank + 1];
+    }
 
     uint8_t prop_id;
-    while((prop_id = get_style_prop_id(style, i)) != _LV_STYLE_CLOSING_PROP) {
+    while(i < end && (prop_id = get_style_prop_id(style, i)) != _LV_STYLE_CLOSING_PROP) {
         if(prop_id == id_to_find) {
-            lv_style_attr_t attr_i;
-            attr_i = get_style_prop_attr(style, i);
-
-            /*If the state perfectly matches return this property*/
-            if(LV_STYLE_ATTR_GET_STATE(attr_i) == LV_STYLE_ATTR_GET_STATE(attr)) {
-                return i;
-            }
-            /* Be sure the property not specifies other state than the requested.
-             * E.g. For HOVER+PRESS, HOVER only is OK, but HOVER+FOCUS not*/
-            else if((LV_STYLE_ATTR_GET_STATE(attr_i) & (~LV_STYLE_ATTR_GET_STATE(attr))) == 0) {
-                /* Use this property if it describes better the requested state than the current candidate.
-                 * E.g. for HOVER+FOCUS+PRESS prefer HOVER+FOCUS over FOCUS*/
-                if(LV_STYLE_ATTR_GET_STATE(attr_i) > weight) {
-                    weight = LV_STYLE_ATTR_GET_STATE(attr_i);
-                    id_guess = i;
-                }
+            int16_t weight_i = get_state_weight(get_style_prop_attr(style, i), attr);
+            if(weight_i == INT16_MAX) return i;
+            /* Use this property if it describes better the requested state than the current candidate.
+             * E.g. for HOVER+FOCUS+PRESS prefer HOVER+FOCUS over FOCUS*/
+            if(weight_i > weight) {
+                weight = weight_i;
+                id_guess = i;
             }
         }
 
@@ -1132,3 +1273,244 @@ static inline size_t get_next_prop_index(uint8_t prop_id, size_t idx)
 {
     return idx + get_prop_size(prop_id);
 }
+
+/**
+ * Tell whether a style uses the indexed storage
+ * @param style pointer to style
+ * @return true: `style->map` starts with `style_indexed_t`
+ */
+static inline bool is_indexed(const lv_style_t * style)
+{
+    return style->map != NULL && get_style_prop_id(style, 0) == STYLE_INDEXED_MARK;
+}
+
+/**
+ * Tell whether a style was created by `LV_STYLE_CONST_INIT()`
+ * @param style pointer to style
+ * @return true: `style->map` points to a `lv_style_const_map_t`
+ */
+static inline bool is_const(const lv_style_t * style)
+{
+    return style->map != NULL && get_style_prop_id(style, 0) == _LV_STYLE_CONST_MARK;
+}
+
+/**
+ * Check if a style can be modified. Writing a constant style is an error caught by `LV_USE_ASSERT_STYLE`.
+ * @param style pointer to style
+ * @return true: not a constant style
+ */
+static bool is_writable(const lv_style_t * style)
+{
+    LV_ASSERT_STYLE_WRITABLE(style);
+
+    if(style != NULL && is_const(style)) {
+        LV_LOG_WARN("Constant styles can't be modified");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Tell how well the state of a property fits to the requested state
+ * @param attr_prop attribute of the property in the style
+ * @param attr_goal attribute of the requested property
+ * @return `INT16_MAX`: the state perfectly matches;
+ *         -1: the property specifies other states than requested (e.g. for HOVER+PRESS HOVER+FOCUS is not OK);
+ *         else the state of the property. Higher value describes the requested state better.
+ */
+static inline int16_t get_state_weight(lv_style_attr_t attr_prop, lv_style_attr_t attr_goal)
+{
+    lv_style_attr_t state_prop = LV_STYLE_ATTR_GET_STATE(attr_prop);
+    lv_style_attr_t state_goal = LV_STYLE_ATTR_GET_STATE(attr_goal);
+
+    if(state_prop == state_goal) return INT16_MAX;
+    if((state_prop & (~state_goal)) != 0) return -1;
+    return state_prop;
+}
+
+/**
+ * Get the index of the first property in a style
+ * @param style pointer to style
+ * @return index of the first property in style->map
+ */
+static inline size_t get_first_prop_index(const lv_style_t * style)
+{
+    if(!is_indexed(style)) return 0;
+
+    const style_indexed_t * indexed = (const style_indexed_t *)style->map;
+    return sizeof(style_indexed_t) + (indexed->id_cnt + 1) * sizeof(uint16_t);
+}
+
+/**
+ * Get the number of property IDs smaller than an ID in an indexed style
+ * @param indexed pointer to the header of an indexed style
+ * @param prop_id property id
+ * @return the index of `prop_id`'s first property in the `start` array
+ */
+static inline uint32_t get_id_rank(const style_indexed_t * indexed, uint8_t prop_id)
+{
+    uint32_t lower_mask = ((uint32_t)1 << (prop_id & 0x1F)) - 1;
+    return indexed->rank[prop_id >> 5] + count_bits(indexed->has[prop_id >> 5] & lower_mask);
+}
+
+/**
+ * Count the set bits
+ * @param v a value
+ * @return number of 1 bits in `v`
+ */
+static inline uint32_t count_bits(uint32_t v)
+{
+#if defined(__GNUC__)
+    return __builtin_popcount(v);
+#else
+    v = v - ((v >> 1) & 0x55555555);
+    v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+    return (((v + (v >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+#endif
+}
+
+/**
+ * Add a new property to a style
+ * @param style pointer to style
+ * @param prop a style property ORed with a state. It shouldn't be in the style yet.
+ * @param value pointer to the value
+ * @param value_size size of the value
+ */
+static void add_prop(lv_style_t * style, lv_style_property_t prop, const void * value, size_t value_size)
+{
+    uint8_t new_prop[sizeof(lv_style_value_t)];
+    uint8_t new_prop_size = sizeof(lv_style_property_t) + value_size;
+    _lv_memcpy_small(new_prop, &prop, sizeof(lv_style_property_t));
+    _lv_memcpy_small(new_prop + sizeof(lv_style_property_t), value, value_size);
+
+    if(is_indexed(style)) {
+        uint8_t * new_map = index_props(style, new_prop, -1);
+        if(new_map == NULL) return;
+        lv_mem_free(style->map);
+        style->map = new_map;
+        return;
+    }
+
+    lv_style_property_t end_mark = _LV_STYLE_CLOSING_PROP;
+    uint8_t end_mark_size = sizeof(end_mark);
+
+    uint16_t size = _lv_style_get_mem_size(style);
+    if(size == 0) size += end_mark_size;
+
+    size += new_prop_size;
+    if(!style_resize(style, size)) return;
+
+    _lv_memcpy_small(style->map + size - new_prop_size - end_mark_size, new_prop, new_prop_size);
+    _lv_memcpy_small(style->map + size - end_mark_size, &end_mark, sizeof(end_mark));
+
+#if LV_STYLE_INDEX_PROP_CNT
+    /*Index the style if it has many properties*/
+    uint32_t prop_cnt = 0;
+    size_t i = 0;
+    uint8_t prop_id;
+    while((prop_id = get_style_prop_id(style, i)) != _LV_STYLE_CLOSING_PROP) {
+        prop_cnt++;
+        i = get_next_prop_index(prop_id, i);
+    }
+    if(prop_cnt >= LV_STYLE_INDEX_PROP_CNT) lv_style_index(style);
+#endif
+}
+
+/**
+ * Create the indexed storage of the properties of a style
+ * @param style pointer to a style with byte map or indexed storage
+ * @param new_prop a property with its value to add (packed like in the byte map) or `NULL`
+ * @param removed index of a property in `style->map` to leave out or -1
+ * @return the new map allocated in one block or `NULL` if out of memory
+ */
+static uint8_t * index_props(const lv_style_t * style, const uint8_t * new_prop, int32_t removed)
+{
+    style_indexed_t indexed;
+    _lv_memset_00(&indexed, sizeof(indexed));
+    indexed.mark = STYLE_INDEXED_MARK;
+
+    uint8_t * map = NULL;
+    uint16_t * start = NULL;
+    size_t head_size = 0;
+    uint8_t pass;
+    for(pass = 0; pass < 3; pass++) {
+        size_t data_size = 0;
+        if(style->map) {
+            size_t i = get_first_prop_index(style);
+            uint8_t prop_id;
+            while((prop_id = get_style_prop_id(style, i)) != _LV_STYLE_CLOSING_PROP) {
+                if((int32_t)i != removed) data_size += index_prop(&style->map[i], pass, &indexed, map);
+                i = get_next_prop_index(prop_id, i);
+            }
+        }
+        if(new_prop) data_size += index_prop(new_prop, pass, &indexed, map);
+
+        uint32_t r;
+        if(pass == 0) {
+            /*The IDs are known: allocate the map*/
+            for(r = 0; r < STYLE_INDEXED_WORDS; r++) {
+                indexed.rank[r] = indexed.id_cnt;
+                indexed.id_cnt += count_bits(indexed.has[r]);
+            }
+
+            head_size = sizeof(style_indexed_t) + (indexed.id_cnt + 1) * sizeof(uint16_t);
+            map = lv_mem_alloc(head_size + data_size + sizeof(lv_style_property_t));
+            LV_ASSERT_MEM(map);
+            if(map == NULL) return NULL;
+
+            _lv_memcpy(map, &indexed, sizeof(style_indexed_t));
+            start = (uint16_t *)(map + sizeof(style_indexed_t));
+            _lv_memset_00(start, (indexed.id_cnt + 1) * sizeof(uint16_t));
+        }
+        else if(pass == 1) {
+            /*`start[r + 1]` has the size of the properties with the r-th ID: make them indices*/
+            start[0] = head_size;
+            for(r = 1; r <= indexed.id_cnt; r++) start[r] += start[r - 1];
+        }
+        else {
+            /*The properties were copied to `start[r]` which points to the next ID now*/
+            for(r = indexed.id_cnt; r > 0; r--) start[r] = start[r - 1];
+            start[0] = head_size;
+
+            lv_style_property_t end_mark = _LV_STYLE_CLOSING_PROP;
+            _lv_memcpy_small(map + head_size + data_size, &end_mark, sizeof(end_mark));
+        }
+    }
+
+    return map;
+}
+
+/**
+ * Process a property while creating the indexed storage
+ * @param prop_p pointer to a property with its value
+ * @param pass 0: collect the IDs; 1: sum the size of the properties with the same ID; 2: copy the property
+ * @param indexed the header of the indexed storage. `rank` and `id_cnt` are valid after the first pass.
+ * @param map the new map allocated after the first pass
+ * @return size of the property with its value. 0 if the property is invalid and left out.
+ */
+static size_t index_prop(const uint8_t * prop_p, uint8_t pass, style_indexed_t * indexed, uint8_t * map)
+{
+    lv_style_property_t prop;
+    _lv_memcpy_small(&prop, prop_p, sizeof(lv_style_property_t));
+    uint8_t prop_id = prop & 0xFF;
+    if(prop_id >= STYLE_INDEXED_ID_NUM) return 0;
+
+    size_t size = get_prop_size(prop_id);
+    if(pass == 0) {
+        indexed->has[prop_id >> 5] |= (uint32_t)1 << (prop_id & 0x1F);
+    }
+    else {
+        uint16_t * start = (uint16_t *)(map + sizeof(style_indexed_t));
+        uint32_t rank = get_id_rank(indexed, prop_id);
+        if(pass == 1) {
+            start[rank + 1] += size;
+        }
+        else {
+            _lv_memcpy_small(map + start[rank], prop_p, size);
+            start[rank] += size;
+        }
+    }
+
+    return size;
+}
@@ -40,6 +40,7 @@ LV_EXPORT_CONST_INT(LV_RADIUS_CIRCLE);
 #define LV_STYLE_ATTR_INHERIT       (1 << 7)
 
 #define _LV_STYLE_CLOSING_PROP     0xFF
+#define _LV_STYLE_CONST_MARK       0xFD   /*The first property ID of a constant style's map*/
 
 #define LV_STYLE_TRANS_NUM_MAX      6
 
@@ -217,6 +218,31 @@ typedef struct {
 
 typedef int16_t lv_style_int_t;
 
+/** A style property with its value to build a style with `lv_style_build()`*/
+typedef struct {
+    lv_style_property_t prop;       /**< A style property ORed with a state*/
+    union {
+        lv_style_int_t num;
+        lv_color_t color;
+        lv_opa_t opa;
+        const void * ptr;
+    } value;
+} lv_style_value_t;
+
+/*Initializers of `lv_style_value_t`. E.g. `LV_STYLE_VALUE_INT(LV_STYLE_RADIUS, 5)`
+ *In `static const` arrays use `LV_COLOR_INIT(r, g, b)` for the colors instead of `LV_COLOR_MAKE()`*/
+#define LV_STYLE_VALUE_INT(prop, v)     {(prop), {.num = (v)}}
+#define LV_STYLE_VALUE_COLOR(prop, v)   {(prop), {.color = v}}
+#define LV_STYLE_VALUE_OPA(prop, v)     {(prop), {.opa = (v)}}
+#define LV_STYLE_VALUE_PTR(prop, v)     {(prop), {.ptr = (v)}}
+
+/** The map of a constant style. Created by `LV_STYLE_CONST_INIT()`*/
+typedef struct {
+    lv_style_property_t mark;           /**< `_LV_STYLE_CONST_MARK` to tell it from the byte map*/
+    uint16_t value_cnt;
+    const lv_style_value_t * values;
+} lv_style_const_map_t;
+
 typedef struct {
     lv_style_t ** style_list;
 #if LV_USE_ASSERT_STYLE
@@ -292,14 +318,14 @@ void lv_style_list_copy(lv_style_list_t * list_dest, const lv_style_list_t * lis
  * @param list pointer to a style list
  * @param style pointer to a style to add
  */
-void _lv_style_list_add_style(lv_style_list_t * list, lv_style_t * style);
+void _lv_style_list_add_style(lv_style_list_t * list, const lv_style_t * style);
 
 /**
  * Remove a style from a style list
  * @param style_list pointer to a style list
  * @param style pointer to a style to remove
  */
-void _lv_style_list_remove_style(lv_style_list_t * list, lv_style_t * style);
+void _lv_style_list_remove_style(lv_style_list_t * list, const lv_style_t * style);
 
 /**
  * Remove all styles added from style list, clear the local style, transition style and free all allocated memories.
@@ -344,6 +370,34 @@ void lv_style_copy(lv_style_t * dest, const lv_style_t * src);
  */
 bool lv_style_remove_prop(lv_style_t * style, lv_style_property_t prop);
 
+/**
+ * Set all properties of a style at once in the indexed storage.
+ * The properties are allocated in one block and can be looked up without searching through all of them.
+ * The earlier properties of the style are removed.
+ * @param style pointer to an initialized style
+ * @param values array of properties with their values. Every property should be listed only once in a state.
+ * @param value_cnt number of elements in `values`
+ * @return true: success; false: out of memory, the style is not changed
+ */
+bool lv_style_build(lv_style_t * style, const lv_style_value_t values[], uint16_t value_cnt);
+
+/**
+ * Convert the properties of a style to the indexed storage.
+ * The next `lv_style_set_...()` and `lv_style_remove_prop()` calls keep the style indexed.
+ * @param style pointer to a style
+ * @return true: success; false: out of memory, the style is not changed
+ * @note the indexed storage needs about 40 bytes more RAM but the time of getting a property
+ *       doesn't depend on the number of properties. It's worth to use for styles with many properties.
+ */
+bool lv_style_index(lv_style_t * style);
+
+/**
+ * Tell whether a style was created by `LV_STYLE_CONST_INIT()`
+ * @param style pointer to a style
+ * @return true: the style is constant and can't be modified
+ */
+bool lv_style_is_const(const lv_style_t * style);
+
 /**
  * Set an integer typed property in a style.
  * @param style pointer to a style where the property should be set
@@ -579,6 +633,13 @@ bool lv_debug_check_style(const lv_style_t * style);
  */
 bool lv_debug_check_style_list(const lv_style_list_t * list);
 
+/**
+ * Check whether a style can be modified (not a constant style)
+ * @param style pointer to a style
+ * @return true: can be modified
+ */
+bool lv_debug_check_style_writable(const lv_style_t * style);
+
 /*************************
  *    GLOBAL VARIABLES
  *************************/
@@ -598,6 +659,31 @@ bool lv_debug_check_style_list(const lv_style_list_t * list);
  */
 #define LV_STYLE_CREATE(name, copy_p) static lv_style_t name; lv_style_init(&name); lv_style_copy(&name, copy_p)
 
+/**
+ * Define a constant style from a `static const` array of `lv_style_value_t`.
+ * The style and its properties are placed in ROM so they need no RAM and no initialization.
+ * The style can't be modified and it can be added to the objects as `lv_obj_add_style(obj, part, &name)`.
+ * Example:
+ *     static const lv_style_value_t my_style_values[] = {
+ *         LV_STYLE_VALUE_COLOR(LV_STYLE_TEXT_COLOR, LV_COLOR_INIT(0x00, 0x80, 0x00)),
+ *         LV_STYLE_VALUE_PTR(LV_STYLE_TEXT_FONT, &lv_font_montserrat_20),
+ *     };
+ *     static LV_STYLE_CONST_INIT(my_style, my_style_values);
+ */
+#if LV_USE_ASSERT_STYLE
+#define LV_STYLE_CONST_INIT(name, values_array)                                                             \
+    const lv_style_t name = {(uint8_t *) &(const lv_style_const_map_t) {                                    \
+            _LV_STYLE_CONST_MARK, sizeof(values_array) / sizeof((values_array)[0]), values_array            \
+        }, LV_DEBUG_STYLE_SENTINEL_VALUE                                                                    \
+    }
+#else
+#define LV_STYLE_CONST_INIT(name, values_array)                                                             \
+    const lv_style_t name = {(uint8_t *) &(const lv_style_const_map_t) {                                    \
+            _LV_STYLE_CONST_MARK, sizeof(values_array) / sizeof((values_array)[0]), values_array            \
+        }                                                                                                   \
+    }
+#endif
+
 #if LV_USE_DEBUG
 
 # ifndef LV_DEBUG_IS_STYLE
@@ -608,6 +694,10 @@ bool lv_debug_check_style_list(const lv_style_list_t * list);
 #  define LV_DEBUG_IS_STYLE_LIST(list_p) (lv_debug_check_style_list(list_p))
 # endif
 
+# ifndef LV_DEBUG_IS_STYLE_WRITABLE
+#  define LV_DEBUG_IS_STYLE_WRITABLE(style_p) (lv_debug_check_style_writable(style_p))
+# endif
+
 # if LV_USE_ASSERT_STYLE
 #  ifndef LV_ASSERT_STYLE
 #   define LV_ASSERT_STYLE(style_p) LV_DEBUG_ASSERT(LV_DEBUG_IS_STYLE(style_p), "Invalid style", style_p);
@@ -615,14 +705,19 @@ bool lv_debug_check_style_list(const lv_style_list_t * list);
 #  ifndef LV_ASSERT_STYLE_LIST
 #   define LV_ASSERT_STYLE_LIST(list_p) LV_DEBUG_ASSERT(LV_DEBUG_IS_STYLE_LIST(list_p), "Invalid style list", list_p);
 #  endif
+#  ifndef LV_ASSERT_STYLE_WRITABLE
+#   define LV_ASSERT_STYLE_WRITABLE(style_p) LV_DEBUG_ASSERT(LV_DEBUG_IS_STYLE_WRITABLE(style_p), "Constant style is modified", style_p);
+#  endif
 # else
 #   define LV_ASSERT_STYLE(style_p)
 #   define LV_ASSERT_STYLE_LIST(list_p)
+#   define LV_ASSERT_STYLE_WRITABLE(style_p)
 # endif
 
 #else
 # define LV_ASSERT_STYLE(p)
 # define LV_ASSERT_STYLE_LIST(p)
+# define LV_ASSERT_STYLE_WRITABLE(p)
 #endif
 
 #ifdef __cplusplus
@@ -27,6 +27,8 @@ extern "C" {
 #include "lv_draw_arc.h"
 #include "lv_draw_blend.h"
 #include "lv_draw_mask.h"
+#include "lv_img_png.h"
+#include "lv_img_jpg.h"
 
 /*********************
  *      DEFINES
@@ -8,6 +8,7 @@
  *********************/
 #include "lv_draw_img.h"
 #include "lv_img_cache.h"
+#include "lv_draw_mask.h"
 #include "../lv_hal/lv_hal_disp.h"
 #include "../lv_misc/lv_log.h"
 #include "../lv_core/lv_refr.h"
@@ -32,15 +33,25 @@
  **********************/
 LV_ATTRIBUTE_FAST_MEM static lv_res_t lv_img_draw_core(const lv_area_t * coords, const lv_area_t * clip_area,
                                                        const void * src,
-                                                       const lv_draw_img_dsc_t * draw_dsc);
+                                                       const lv_draw_img_dsc_t * draw_dsc, bool sub_img);
 
 LV_ATTRIBUTE_FAST_MEM static void lv_draw_map(const lv_area_t * map_area, const lv_area_t * clip_area,
                                               const uint8_t * map_p,
                                               const lv_draw_img_dsc_t * draw_dsc,
                                               bool chroma_key, bool alpha_byte);
 
+LV_ATTRIBUTE_FAST_MEM static bool span_chroma_key(lv_color_t * dst, lv_opa_t * mask, const lv_color_t * src,
+                                                 int32_t len);
+LV_ATTRIBUTE_FAST_MEM static void span_recolor(lv_color_t * dst, const lv_color_t * src, int32_t len,
+                                               uint16_t * recolor_premult, lv_opa_t recolor_opa_inv);
+LV_ATTRIBUTE_FAST_MEM static void span_recolor_argb(lv_color_t * dst, lv_opa_t * mask, const uint8_t * src, int32_t len,
+                                                    uint16_t * recolor_premult, lv_opa_t recolor_opa_inv);
 static void show_error(const lv_area_t * coords, const lv_area_t * clip_area, const char * msg);
 static void draw_cleanup(lv_img_cache_entry_t * cache);
+#if LV_USE_IMG_TRANSFORM
+static bool sprite_masks_add(lv_draw_mask_line_param_t * params, int16_t * ids, const lv_area_t * coords,
+                             lv_coord_t w, lv_coord_t h, const lv_draw_img_dsc_t * dsc);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -82,7 +93,7 @@ void lv_draw_img(const lv_area_t * coords, const lv_area_t * mask, const void *
     if(dsc->opa <= LV_OPA_MIN) return;
 
     lv_res_t res;
-    res = lv_img_draw_core(coords, mask, src, dsc);
+    res = lv_img_draw_core(coords, mask, src, dsc, false);
 
     if(res == LV_RES_INV) {
         LV_LOG_WARN("Image draw error");
@@ -91,6 +102,99 @@ void lv_draw_img(const lv_area_t * coords, const lv_area_t * mask, const void *
     }
 }
 
+/**
+ * Draw a sprite of an image atlas. The pixels are read directly from the atlas without copying the sprite.
+ * @param coords the coordinates of the sprite. Only its top left corner is used, the size comes from the atlas.
+ * @param mask the sprite will be drawn only in this area
+ * @param atlas pointer to an image atlas
+ * @param id ID of the sprite (index in `atlas->rects`)
+ * @param dsc pointer to an initialized `lv_draw_img_dsc_t` variable. The pivot is relative to the sprite.
+ */
+void lv_draw_img_atlas(const lv_area_t * coords, const lv_area_t * mask, const lv_img_atlas_t * atlas, uint16_t id,
+                       const lv_draw_img_dsc_t * dsc)
+{
+    if(atlas == NULL || atlas->src == NULL || id >= atlas->rect_cnt) {
+        LV_LOG_WARN("Image draw: invalid atlas or sprite ID");
+        show_error(coords, mask, "No\ndata");
+        return;
+    }
+
+    if(dsc->opa <= LV_OPA_MIN || dsc->zoom == 0) return;
+
+    const lv_area_t * rect = &atlas->rects[id];
+    lv_coord_t w = lv_area_get_width(rect);
+    lv_coord_t h = lv_area_get_height(rect);
+
+    lv_area_t sprite_coords;
+    sprite_coords.x1 = coords->x1;
+    sprite_coords.y1 = coords->y1;
+    sprite_coords.x2 = coords->x1 + w - 1;
+    sprite_coords.y2 = coords->y1 + h - 1;
+
+    /*Draw the whole atlas positioned to have the sprite on `coords` and clip it to the sprite.
+     *Only the visible pixels of the sprite are read from the atlas.*/
+    lv_area_t atlas_coords;
+    atlas_coords.x1 = coords->x1 - rect->x1;
+    atlas_coords.y1 = coords->y1 - rect->y1;
+    atlas_coords.x2 = atlas_coords.x1 + atlas->w - 1;
+    atlas_coords.y2 = atlas_coords.y1 + atlas->h - 1;
+
+    lv_draw_img_dsc_t atlas_dsc = *dsc;
+    lv_area_t clip;
+    lv_res_t res;
+    if(dsc->angle == 0 && dsc->zoom == LV_IMG_ZOOM_NONE) {
+        if(_lv_area_intersect(&clip, mask, &sprite_coords) == false) return;
+        res = lv_img_draw_core(&atlas_coords, &clip, atlas->src, &atlas_dsc, true);
+    }
+    else {
+#if LV_USE_IMG_TRANSFORM
+        /*Transform around the sprite's pivot*/
+        atlas_dsc.pivot.x += rect->x1;
+        atlas_dsc.pivot.y += rect->y1;
+
+        if(dsc->angle == 0) {
+            /*The zoomed sprite is a rectangle*/
+            _lv_img_buf_get_zoomed_area(&clip, w, h, dsc->zoom, &dsc->pivot);
+            clip.x1 += coords->x1;
+            clip.y1 += coords->y1;
+            clip.x2 += coords->x1;
+            clip.y2 += coords->y1;
+            if(_lv_area_intersect(&clip, mask, &clip) == false) return;
+            res = lv_img_draw_core(&atlas_coords, &clip, atlas->src, &atlas_dsc, true);
+        }
+        else {
+            /*Cut the neighbor sprites from the bounding box of the rotated sprite*/
+            _lv_img_buf_get_transformed_area(&clip, w, h, dsc->angle, dsc->zoom, &dsc->pivot);
+            clip.x1 += coords->x1;
+            clip.y1 += coords->y1;
+            clip.x2 += coords->x1;
+            clip.y2 += coords->y1;
+            if(_lv_area_intersect(&clip, mask, &clip) == false) return;
+
+            lv_draw_mask_line_param_t mask_params[4];
+            int16_t mask_ids[4];
+            if(sprite_masks_add(mask_params, mask_ids, coords, w, h, dsc) == false) {
+                /*Without all the masks the neighbor sprites would be drawn too*/
+                LV_LOG_WARN("Image draw: no free mask for a rotated sprite");
+                return;
+            }
+            res = lv_img_draw_core(&atlas_coords, &clip, atlas->src, &atlas_dsc, true);
+
+            uint32_t i;
+            for(i = 0; i < 4; i++) lv_draw_mask_remove_id(mask_ids[i]);
+        }
+#else
+        if(_lv_area_intersect(&clip, mask, &sprite_coords) == false) return;
+        res = lv_img_draw_core(&atlas_coords, &clip, atlas->src, &atlas_dsc, true);
+#endif
+    }
+
+    if(res == LV_RES_INV) {
+        LV_LOG_WARN("Image draw error");
+        show_error(&sprite_coords, mask, "No\ndata");
+    }
+}
+
 /**
  * Get the pixel size of a color format in bits
  * @param cf a color format (`LV_IMG_CF_...`)
@@ -232,9 +336,12 @@ lv_img_src_t lv_img_src_get_type(const void * src)
 
 LV_ATTRIBUTE_FAST_MEM static lv_res_t lv_img_draw_core(const lv_area_t * coords, const lv_area_t * clip_area,
                                                        const void * src,
-                                                       const lv_draw_img_dsc_t * draw_dsc)
+                                                       const lv_draw_img_dsc_t * draw_dsc, bool sub_img)
 {
     if(draw_dsc->opa <= LV_OPA_MIN) return LV_RES_OK;
+#if LV_USE_IMG_TRANSFORM == 0
+    LV_UNUSED(sub_img);
+#endif
 
     lv_img_cache_entry_t * cdsc = _lv_img_cache_open(src, draw_dsc->recolor);
 
@@ -251,6 +358,32 @@ LV_ATTRIBUTE_FAST_MEM static lv_res_t lv_img_draw_core(const lv_area_t * coords,
     /* The decoder could open the image and gave the entire uncompressed image.
      * Just draw it!*/
     else if(cdsc->dec_dsc.img_data) {
+#if LV_USE_IMG_TRANSFORM
+        /*Draw the cached transformed copy of the image like a not transformed image with alpha.
+         *Don't transform the whole image if only a part of it (e.g. a sprite) is drawn.*/
+        if(!sub_img && (draw_dsc->angle || draw_dsc->zoom != LV_IMG_ZOOM_NONE)) {
+            lv_img_cache_variant_t * variant = _lv_img_cache_get_variant(cdsc, draw_dsc->angle, draw_dsc->zoom,
+                                                                         &draw_dsc->pivot, draw_dsc->antialias);
+            if(variant) {
+                lv_area_t variant_coords;
+                variant_coords.x1 = coords->x1 + variant->area.x1;
+                variant_coords.y1 = coords->y1 + variant->area.y1;
+                variant_coords.x2 = coords->x1 + variant->area.x2;
+                variant_coords.y2 = coords->y1 + variant->area.y2;
+
+                lv_area_t mask_com;
+                if(_lv_area_intersect(&mask_com, clip_area, &variant_coords)) {
+                    lv_draw_img_dsc_t variant_dsc = *draw_dsc;
+                    variant_dsc.angle = 0;
+                    variant_dsc.zoom = LV_IMG_ZOOM_NONE;
+                    lv_draw_map(&variant_coords, &mask_com, variant->data, &variant_dsc, false, true);
+                }
+
+                draw_cleanup(cdsc);
+                return LV_RES_OK;
+            }
+        }
+#endif
         lv_area_t map_area_rot;
         lv_area_copy(&map_area_rot, coords);
         if(draw_dsc->angle || draw_dsc->zoom != LV_IMG_ZOOM_NONE) {
@@ -288,35 +421,51 @@ LV_ATTRIBUTE_FAST_MEM static lv_res_t lv_img_draw_core(const lv_area_t * coords,
         }
 
         int32_t width = lv_area_get_width(&mask_com);
+        int32_t height = lv_area_get_height(&mask_com);
+
+        /* Decode more lines at once to read the source in larger blocks.
+         * Transformed images are drawn line-by-line to transform each line as before*/
+        int32_t px_bytes = alpha_byte ? LV_IMG_PX_SIZE_ALPHA_BYTE : sizeof(lv_color_t);
+        int32_t strip_h = 1;
+        if(draw_dsc->angle == 0 && draw_dsc->zoom == LV_IMG_ZOOM_NONE) {
+            strip_h = LV_IMG_DECODER_STRIP_SIZE / (width * px_bytes);
+            if(strip_h > height) strip_h = height;
+            if(strip_h < 1) strip_h = 1;
+        }
 
-        uint8_t  * buf = _lv_mem_buf_get(lv_area_get_width(&mask_com) *
-                                         LV_IMG_PX_SIZE_ALPHA_BYTE);  /*+1 because of the possible alpha byte*/
+        uint8_t  * buf = _lv_mem_buf_get(width * strip_h * LV_IMG_PX_SIZE_ALPHA_BYTE);  /*+1 because of the possible alpha byte*/
+        if(buf == NULL && strip_h > 1) {
+            strip_h = 1;
+            buf = _lv_mem_buf_get(width * LV_IMG_PX_SIZE_ALPHA_BYTE);
+        }
+        if(buf == NULL) {
+            draw_cleanup(cdsc);
+            return LV_RES_INV;
+        }
 
-        lv_area_t line;
-        lv_area_copy(&line, &mask_com);
-        lv_area_set_height(&line, 1);
+        lv_area_t strip;
+        lv_area_copy(&strip, &mask_com);
         int32_t x = mask_com.x1 - coords->x1;
         int32_t y = mask_com.y1 - coords->y1;
         int32_t row;
         lv_res_t read_res;
-        for(row = mask_com.y1; row <= mask_com.y2; row++) {
-            lv_area_t mask_line;
-            union_ok = _lv_area_intersect(&mask_line, clip_area, &line);
-            if(union_ok == false) continue;
+        for(row = mask_com.y1; row <= mask_com.y2; row += strip_h) {
+            if(row + strip_h - 1 > mask_com.y2) strip_h = mask_com.y2 - row + 1;
+            strip.y1 = row;
+            strip.y2 = row + strip_h - 1;
 
-            read_res = lv_img_decoder_read_line(&cdsc->dec_dsc, x, y, width, buf);
+            read_res = lv_img_decoder_read_area(&cdsc->dec_dsc, x, y, width, strip_h, buf);
             if(read_res != LV_RES_OK) {
-                lv_img_decoder_close(&cdsc->dec_dsc);
                 LV_LOG_WARN("Image draw can't read the line");
                 _lv_mem_buf_release(buf);
+                /*Close the image. Don't leave it in the cache as a closed but used entry*/
+                lv_img_cache_invalidate_src(src);
                 draw_cleanup(cdsc);
                 return LV_RES_INV;
             }
 
-            lv_draw_map(&line, &mask_line, buf, draw_dsc, chroma_keyed, alpha_byte);
-            line.y1++;
-            line.y2++;
-            y++;
+            lv_draw_map(&strip, &strip, buf, draw_dsc, chroma_keyed, alpha_byte);
+            y += strip_h;
         }
         _lv_mem_buf_release(buf);
     }
@@ -471,6 +620,63 @@ LV_ATTRIBUTE_FAST_MEM static void lv_draw_map(const lv_area_t * map_area, const
             _lv_mem_buf_release(mask_buf);
             _lv_mem_buf_release(map2);
         }
+        /*Chroma keyed or recolored image without transformation and other masks.
+         *Convert whole lines with the span functions instead of checking every pixel for every feature.*/
+        else if(other_mask_cnt == 0 && !transform) {
+            uint32_t hor_res = (uint32_t) lv_disp_get_hor_res(disp);
+            uint32_t mask_buf_size = lv_area_get_size(&draw_area) > (uint32_t) hor_res ? hor_res : lv_area_get_size(&draw_area);
+            lv_color_t * map2 = _lv_mem_buf_get(mask_buf_size * sizeof(lv_color_t));
+            lv_opa_t * mask_buf = NULL;
+            if(alpha_byte || chroma_key) mask_buf = _lv_mem_buf_get(mask_buf_size);
+
+            bool recolor = draw_dsc->recolor_opa != LV_OPA_TRANSP ? true : false;
+            uint16_t recolor_premult[3] = {0};
+            lv_opa_t recolor_opa_inv = 255 - draw_dsc->recolor_opa;
+            if(recolor) {
+                lv_color_premult(draw_dsc->recolor, draw_dsc->recolor_opa, recolor_premult);
+            }
+
+            /*Use the mask only if there are transparent pixels*/
+            lv_draw_mask_res_t mask_res = alpha_byte ? LV_DRAW_MASK_RES_CHANGED : LV_DRAW_MASK_RES_FULL_COVER;
+
+            int32_t y;
+            for(y = 0; y < draw_area_h; y++) {
+                if(alpha_byte) {
+                    span_recolor_argb(&map2[px_i], &mask_buf[px_i], map_buf_tmp, draw_area_w, recolor_premult, recolor_opa_inv);
+                }
+                else {
+                    const lv_color_t * src = (const lv_color_t *)map_buf_tmp;
+                    if(chroma_key) {
+                        if(span_chroma_key(&map2[px_i], &mask_buf[px_i], src, draw_area_w)) mask_res = LV_DRAW_MASK_RES_CHANGED;
+                        src = &map2[px_i];
+                    }
+                    if(recolor) span_recolor(&map2[px_i], src, draw_area_w, recolor_premult, recolor_opa_inv);
+                }
+                px_i += draw_area_w;
+
+                map_buf_tmp += map_w * px_size_byte;
+                if(px_i + lv_area_get_width(&draw_area) < mask_buf_size) {
+                    blend_area.y2 ++;
+                }
+                else {
+                    _lv_blend_map(clip_area, &blend_area, map2, mask_buf, mask_res, draw_dsc->opa, draw_dsc->blend_mode);
+
+                    blend_area.y1 = blend_area.y2 + 1;
+                    blend_area.y2 = blend_area.y1;
+
+                    px_i = 0;
+                    mask_res = alpha_byte ? LV_DRAW_MASK_RES_CHANGED : LV_DRAW_MASK_RES_FULL_COVER;
+                }
+            }
+            /*Flush the last part*/
+            if(blend_area.y1 != blend_area.y2) {
+                blend_area.y2--;
+                _lv_blend_map(clip_area, &blend_area, map2, mask_buf, mask_res, draw_dsc->opa, draw_dsc->blend_mode);
+            }
+
+            if(mask_buf) _lv_mem_buf_release(mask_buf);
+            _lv_mem_buf_release(map2);
+        }
         /*Most complicated case: transform or other mask or chroma keyed*/
         else {
             /*Build the image and a mask line-by-line*/
@@ -526,61 +732,54 @@ LV_ATTRIBUTE_FAST_MEM static void lv_draw_map(const lv_area_t * map_area, const
                 uint32_t px_i_start = px_i;
 
 #if LV_USE_IMG_TRANSFORM
-                int32_t rot_x = disp_area->x1 + draw_area.x1 - map_area->x1;
-#endif
-                for(x = 0; x < draw_area_w; x++, map_px += px_size_byte, px_i++) {
-
-#if LV_USE_IMG_TRANSFORM
-                    if(transform) {
-
-                        /*Transform*/
-                        bool ret;
-                        ret = _lv_img_buf_transform(&trans_dsc, rot_x + x, rot_y + y);
-                        if(ret == false) {
-                            mask_buf[px_i] = LV_OPA_TRANSP;
-                            continue;
-                        }
-                        else {
-                            mask_buf[px_i] = trans_dsc.res.opa;
-                            c.full = trans_dsc.res.color.full;
+                if(transform) {
+                    /*Transform the whole line at once*/
+                    int32_t rot_x = disp_area->x1 + draw_area.x1 - map_area->x1;
+                    _lv_img_buf_transform_line(&trans_dsc, rot_x, rot_y + y, draw_area_w, &map2[px_i], &mask_buf[px_i]);
+                    if(draw_dsc->recolor_opa != 0) {
+                        for(x = 0; x < draw_area_w; x++) {
+                            if(mask_buf[px_i + x]) {
+                                map2[px_i + x] = lv_color_mix_premult(recolor_premult, map2[px_i + x], recolor_opa_inv);
+                            }
                         }
                     }
-                    /*No transform*/
-                    else
+                    px_i += draw_area_w;
+                }
+                /*No transform*/
+                else
 #endif
-                    {
-                        if(alpha_byte) {
-                            lv_opa_t px_opa = map_px[LV_IMG_PX_SIZE_ALPHA_BYTE - 1];
-                            mask_buf[px_i] = px_opa;
-                            if(px_opa == 0) {
+                for(x = 0; x < draw_area_w; x++, map_px += px_size_byte, px_i++) {
+                    if(alpha_byte) {
+                        lv_opa_t px_opa = map_px[LV_IMG_PX_SIZE_ALPHA_BYTE - 1];
+                        mask_buf[px_i] = px_opa;
+                        if(px_opa == 0) {
 #if LV_COLOR_DEPTH == 32
-                                map2[px_i].full = 0;
+                            map2[px_i].full = 0;
 #endif
-                                continue;
-                            }
-                        }
-                        else {
-                            mask_buf[px_i] = 0xFF;
+                            continue;
                         }
+                    }
+                    else {
+                        mask_buf[px_i] = 0xFF;
+                    }
 
 #if LV_COLOR_DEPTH == 1
-                        c.full = map_px[0];
+                    c.full = map_px[0];
 #elif LV_COLOR_DEPTH == 8
-                        c.full =  map_px[0];
+                    c.full =  map_px[0];
 #elif LV_COLOR_DEPTH == 16
-                        c.full =  map_px[0] + (map_px[1] << 8);
+                    c.full =  map_px[0] + (map_px[1] << 8);
 #elif LV_COLOR_DEPTH == 32
-                        c.full =  *((uint32_t *)map_px);
-                        c.ch.alpha = 0xFF;
+                    c.full =  *((uint32_t *)map_px);
+                    c.ch.alpha = 0xFF;
 #endif
-                        if(chroma_key) {
-                            if(c.full == chroma_keyed_color.full) {
-                                mask_buf[px_i] = LV_OPA_TRANSP;
+                    if(chroma_key) {
+                        if(c.full == chroma_keyed_color.full) {
+                            mask_buf[px_i] = LV_OPA_TRANSP;
 #if LV_COLOR_DEPTH == 32
-                                map2[px_i].full = 0;
+                            map2[px_i].full = 0;
 #endif
-                                continue;
-                            }
+                            continue;
                         }
                     }
 
@@ -639,6 +838,163 @@ LV_ATTRIBUTE_FAST_MEM static void lv_draw_map(const lv_area_t * map_area, const
     }
 }
 
+/**
+ * Copy true color pixels and make the chroma keyed ones transparent
+ * @param dst store the colors here
+ * @param mask store the opacity of the pixels here
+ * @param src the pixels of the image
+ * @param len number of pixels
+ * @return true: there was at least one chroma keyed pixel
+ */
+LV_ATTRIBUTE_FAST_MEM static bool span_chroma_key(lv_color_t * dst, lv_opa_t * mask, const lv_color_t * src,
+                                                 int32_t len)
+{
+    const lv_color_t key = LV_COLOR_TRANSP;
+    bool keyed = false;
+    int32_t i = 0;
+
+#if LV_COLOR_DEPTH == 32
+    for(; i < len; i++) {
+        uint32_t px = src[i].full | 0xFF000000;
+        if(px == key.full) {
+            dst[i].full = 0;
+            mask[i] = LV_OPA_TRANSP;
+            keyed = true;
+        }
+        else {
+            dst[i].full = px;
+            mask[i] = LV_OPA_COVER;
+        }
+    }
+#elif LV_COLOR_DEPTH == 16 || LV_COLOR_DEPTH == 8
+#if LV_COLOR_DEPTH == 16
+    const uint32_t lanes = 2;
+    const uint32_t key_word = key.full * 0x00010001U;
+    const uint32_t ones = 0x00010001U;
+    const uint32_t highs = 0x80008000U;
+#else
+    const uint32_t lanes = 4;
+    const uint32_t key_word = key.full * 0x01010101U;
+    const uint32_t ones = 0x01010101U;
+    const uint32_t highs = 0x80808080U;
+#endif
+    /*Go to a word boundary pixel-by-pixel*/
+    while(i < len && ((lv_uintptr_t)&src[i] & 0x3)) {
+        dst[i] = src[i];
+        mask[i] = src[i].full == key.full ? LV_OPA_TRANSP : LV_OPA_COVER;
+        if(mask[i] == LV_OPA_TRANSP) keyed = true;
+        i++;
+    }
+
+    /*Compare a word of pixels at once with the key. A pixel equal to the key becomes a zero lane.*/
+    for(; i + (int32_t)lanes <= len; i += lanes) {
+        uint32_t v = *((const uint32_t *)&src[i]) ^ key_word;
+        if(((v - ones) & ~v & highs) == 0) {
+            uint32_t j;
+            for(j = 0; j < lanes; j++) {
+                dst[i + j] = src[i + j];
+                mask[i + j] = LV_OPA_COVER;
+            }
+        }
+        else {
+            uint32_t j;
+            for(j = 0; j < lanes; j++) {
+                dst[i + j] = src[i + j];
+                mask[i + j] = src[i + j].full == key.full ? LV_OPA_TRANSP : LV_OPA_COVER;
+            }
+            keyed = true;
+        }
+    }
+#endif
+
+    /*The remaining pixels*/
+    for(; i < len; i++) {
+        dst[i] = src[i];
+        mask[i] = src[i].full == key.full ? LV_OPA_TRANSP : LV_OPA_COVER;
+        if(mask[i] == LV_OPA_TRANSP) keyed = true;
+    }
+
+    return keyed;
+}
+
+/**
+ * Recolor true color pixels. `dst` and `src` can be the same.
+ * @param dst store the colors here
+ * @param src the pixels of the image
+ * @param len number of pixels
+ * @param recolor_premult the recolor pre-multiplied with `lv_color_premult`
+ * @param recolor_opa_inv 255 - opacity of the recolor
+ */
+LV_ATTRIBUTE_FAST_MEM static void span_recolor(lv_color_t * dst, const lv_color_t * src, int32_t len,
+                                               uint16_t * recolor_premult, lv_opa_t recolor_opa_inv)
+{
+    /*Images usually have runs of the same color so mix only if the color changes*/
+    lv_color_t last_src;
+    lv_color_t last_res;
+    last_src.full = ~src[0].full;
+    last_res.full = 0;
+
+    int32_t i;
+    for(i = 0; i < len; i++) {
+        lv_color_t c = src[i];
+#if LV_COLOR_DEPTH == 32
+        c.ch.alpha = 0xFF;
+#endif
+        if(c.full != last_src.full) {
+            last_src = c;
+            last_res = lv_color_mix_premult(recolor_premult, c, recolor_opa_inv);
+        }
+        dst[i] = last_res;
+    }
+}
+
+/**
+ * Recolor the pixels of an image with alpha byte
+ * @param dst store the colors here
+ * @param mask store the opacity of the pixels here
+ * @param src the pixels of the image with alpha byte
+ * @param len number of pixels
+ * @param recolor_premult the recolor pre-multiplied with `lv_color_premult`
+ * @param recolor_opa_inv 255 - opacity of the recolor
+ */
+LV_ATTRIBUTE_FAST_MEM static void span_recolor_argb(lv_color_t * dst, lv_opa_t * mask, const uint8_t * src, int32_t len,
+                                                    uint16_t * recolor_premult, lv_opa_t recolor_opa_inv)
+{
+    lv_color_t last_src;
+    lv_color_t last_res;
+    bool last_valid = false;
+    last_src.full = 0;
+    last_res.full = 0;
+
+    int32_t i;
+    for(i = 0; i < len; i++, src += LV_IMG_PX_SIZE_ALPHA_BYTE) {
+        lv_opa_t px_opa = src[LV_IMG_PX_SIZE_ALPHA_BYTE - 1];
+        mask[i] = px_opa;
+        if(px_opa == 0) {
+#if LV_COLOR_DEPTH == 32
+            dst[i].full = 0;
+#endif
+            continue;
+        }
+
+        lv_color_t c;
+#if LV_COLOR_DEPTH == 8 || LV_COLOR_DEPTH == 1
+        c.full =  src[0];
+#elif LV_COLOR_DEPTH == 16
+        c.full =  src[0] + (src[1] << 8);
+#elif LV_COLOR_DEPTH == 32
+        c.full =  *((uint32_t *)src);
+        c.ch.alpha = 0xFF;
+#endif
+        if(!last_valid || c.full != last_src.full) {
+            last_src = c;
+            last_res = lv_color_mix_premult(recolor_premult, c, recolor_opa_inv);
+            last_valid = true;
+        }
+        dst[i] = last_res;
+    }
+}
+
 static void show_error(const lv_area_t * coords, const lv_area_t * clip_area, const char * msg)
 {
     lv_draw_rect_dsc_t rect_dsc;
@@ -660,3 +1016,86 @@ static void draw_cleanup(lv_img_cache_entry_t * cache)
     LV_UNUSED(cache);
 #endif
 }
+
+#if LV_USE_IMG_TRANSFORM
+/**
+ * Add line masks along the edges of a rotated sprite to keep only the pixels of the sprite.
+ * The edges are rounded inwards to never keep a pixel which is transformed from outside of the sprite.
+ * @param params array of 4 line mask parameters to initialize
+ * @param ids store the IDs of the 4 added masks here
+ * @param coords the coordinates of the sprite
+ * @param w width of the sprite
+ * @param h height of the sprite
+ * @param dsc the angle, zoom and pivot of the sprite
+ * @return true: all the 4 masks are added; false: there were not enough free masks so none is added
+ */
+static bool sprite_masks_add(lv_draw_mask_line_param_t * params, int16_t * ids, const lv_area_t * coords,
+                             lv_coord_t w, lv_coord_t h, const lv_draw_img_dsc_t * dsc)
+{
+    /*Interpolate the sine between the degrees like the transformation*/
+    int32_t angle_low = dsc->angle / 10;
+    int32_t angle_rem = dsc->angle - (angle_low * 10);
+    int32_t sinma = (_lv_trigo_sin(angle_low) * (10 - angle_rem) + _lv_trigo_sin(angle_low + 1) * angle_rem) / 10;
+    int32_t cosma = (_lv_trigo_sin(angle_low + 90) * (10 - angle_rem) + _lv_trigo_sin(angle_low + 91) * angle_rem) / 10;
+
+    /*The corners clockwise in 1/256 pixels*/
+    int32_t xs[4] = {-dsc->pivot.x, w - dsc->pivot.x, w - dsc->pivot.x, -dsc->pivot.x};
+    int32_t ys[4] = {-dsc->pivot.y, -dsc->pivot.y, h - dsc->pivot.y, h - dsc->pivot.y};
+    lv_point_t ofs;
+    ofs.x = coords->x1 + dsc->pivot.x;
+    ofs.y = coords->y1 + dsc->pivot.y;
+    int32_t px[4];
+    int32_t py[4];
+    uint32_t i;
+    for(i = 0; i < 4; i++) {
+        int64_t xt = xs[i] * dsc->zoom;
+        int64_t yt = ys[i] * dsc->zoom;
+        px[i] = (int32_t)((cosma * xt - sinma * yt) >> LV_TRIGO_SHIFT) + (ofs.x << 8);
+        py[i] = (int32_t)((sinma * xt + cosma * yt) >> LV_TRIGO_SHIFT) + (ofs.y << 8);
+    }
+
+    for(i = 0; i < 4; i++) {
+        uint32_t next = (i + 1) & 0x3;
+        int32_t dx = px[next] - px[i];
+        int32_t dy = py[next] - py[i];
+
+        /*The inner side is on the right of the clockwise edges: (-dy, dx).
+         *Round the points inwards with some margin for the rounding errors of the transformation.*/
+        lv_point_t p1;
+        lv_point_t p2;
+        if(dy < 0) {
+            p1.x = (px[i] + 8 + 255) >> 8;
+            p2.x = (px[next] + 8 + 255) >> 8;
+        }
+        else {
+            p1.x = (px[i] - 8) >> 8;
+            p2.x = (px[next] - 8) >> 8;
+        }
+        if(dx > 0) {
+            p1.y = (py[i] + 8 + 255) >> 8;
+            p2.y = (py[next] + 8 + 255) >> 8;
+        }
+        else {
+            p1.y = (py[i] - 8) >> 8;
+            p2.y = (py[next] - 8) >> 8;
+        }
+
+        lv_draw_mask_line_side_t side;
+        if(LV_MATH_ABS(dx) > LV_MATH_ABS(dy)) side = dx > 0 ? LV_DRAW_MASK_LINE_SIDE_BOTTOM : LV_DRAW_MASK_LINE_SIDE_TOP;
+        else side = dy < 0 ? LV_DRAW_MASK_LINE_SIDE_RIGHT : LV_DRAW_MASK_LINE_SIDE_LEFT;
+
+        lv_draw_mask_line_points_init(&params[i], p1.x, p1.y, p2.x, p2.y, side);
+        ids[i] = lv_draw_mask_add(&params[i], NULL);
+        if(ids[i] == LV_MASK_ID_INV) {
+            /*Remove the masks added so far*/
+            while(i > 0) {
+                i--;
+                lv_draw_mask_remove_id(ids[i]);
+            }
+            return false;
+        }
+    }
+
+    return true;
+}
+#endif
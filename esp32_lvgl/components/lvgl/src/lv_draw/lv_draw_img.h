@@ -44,6 +44,18 @@ typedef struct {
     uint8_t antialias       : 1;
 } lv_draw_img_dsc_t;
 
+/**
+ * Images (sprites) packed into one image. All the sprites share one image cache entry and decoded image.
+ * `scripts/img_atlas.py` creates it from the image converter's C files.
+ */
+typedef struct {
+    const void * src;           /**< The image with all the sprites. Pointer to an `lv_img_dsc_t` or a file name*/
+    const lv_area_t * rects;    /**< Area of every sprite in `src`. The index is the sprite's ID*/
+    uint16_t rect_cnt;          /**< Number of sprites*/
+    lv_coord_t w;               /**< Width of `src`*/
+    lv_coord_t h;               /**< Height of `src`*/
+} lv_img_atlas_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -58,6 +70,17 @@ void lv_draw_img_dsc_init(lv_draw_img_dsc_t * dsc);
  */
 void lv_draw_img(const lv_area_t * coords, const lv_area_t * mask, const void * src, const lv_draw_img_dsc_t * dsc);
 
+/**
+ * Draw a sprite of an image atlas. The pixels are read directly from the atlas without copying the sprite.
+ * @param coords the coordinates of the sprite. Only its top left corner is used, the size comes from the atlas.
+ * @param mask the sprite will be drawn only in this area
+ * @param atlas pointer to an image atlas
+ * @param id ID of the sprite (index in `atlas->rects`)
+ * @param dsc pointer to an initialized `lv_draw_img_dsc_t` variable. The pivot is relative to the sprite.
+ */
+void lv_draw_img_atlas(const lv_area_t * coords, const lv_area_t * mask, const lv_img_atlas_t * atlas, uint16_t id,
+                       const lv_draw_img_dsc_t * dsc);
+
 /**
  * Get the type of an image source
  * @param src pointer to an image source:
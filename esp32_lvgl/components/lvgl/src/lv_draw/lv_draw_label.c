@@ -19,6 +19,15 @@
 #define LABEL_RECOLOR_PAR_LENGTH 6
 #define LV_LABEL_HINT_UPDATE_TH 1024 /*Update the "hint" if the label's y coordinates have changed more then this*/
 
+/*Index of the red and blue sub-pixels of a pixel in sub-pixel rendered fonts*/
+#if LV_USE_FONT_SUBPX && LV_FONT_SUBPX_BGR
+    #define SUBPX_R_OFS 2
+    #define SUBPX_B_OFS 0
+#else
+    #define SUBPX_R_OFS 0
+    #define SUBPX_B_OFS 2
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -38,8 +47,15 @@ LV_ATTRIBUTE_FAST_MEM static void lv_draw_letter(const lv_point_t * pos_p, const
 LV_ATTRIBUTE_FAST_MEM static void draw_letter_normal(lv_coord_t pos_x, lv_coord_t pos_y, lv_font_glyph_dsc_t * g,
                                                      const lv_area_t * clip_area,
                                                      const uint8_t * map_p, lv_color_t color, lv_opa_t opa, lv_blend_mode_t blend_mode);
-static void draw_letter_subpx(lv_coord_t pos_x, lv_coord_t pos_y, lv_font_glyph_dsc_t * g, const lv_area_t * clip_area,
-                              const uint8_t * map_p, lv_color_t color, lv_opa_t opa, lv_blend_mode_t blend_mode);
+LV_ATTRIBUTE_FAST_MEM static void draw_letter_subpx(lv_coord_t pos_x, lv_coord_t pos_y, lv_font_glyph_dsc_t * g,
+                                                    const lv_area_t * clip_area,
+                                                    const uint8_t * map_p, lv_color_t color, lv_opa_t opa, lv_blend_mode_t blend_mode);
+#if LV_USE_FONT_SUBPX
+LV_ATTRIBUTE_FAST_MEM static void subpx_unpack(const uint8_t * map_p, uint32_t col_bit, uint32_t bpp, int32_t cnt,
+                                               const lv_opa_t * opa_table, lv_opa_t * out);
+LV_ATTRIBUTE_FAST_MEM static void subpx_mix(const lv_opa_t * subpx, const lv_color_t * bg_buf, lv_color_t * dest,
+                                            lv_opa_t * mask, int32_t px_cnt, lv_color_t color);
+#endif
 
 static uint8_t hex_char_to_num(char hex);
 
@@ -243,8 +259,28 @@ LV_ATTRIBUTE_FAST_MEM void lv_draw_label(const lv_area_t * coords, const lv_area
         cmd_state = CMD_STATE_WAIT;
         i         = 0;
 #if LV_USE_BIDI
-        char * bidi_txt = _lv_mem_buf_get(line_end - line_start + 1);
-        _lv_bidi_process_paragraph(txt + line_start, bidi_txt, line_end - line_start, dsc->bidi_dir, NULL, 0);
+        /*Reuse the processed line from the cache if possible*/
+        const uint16_t * pos_conv = NULL;
+        char * bidi_buf = NULL;
+        uint16_t * pos_conv_buf = NULL;
+        const char * bidi_txt = _lv_bidi_cache_get(txt + line_start, line_end - line_start, dsc->bidi_dir, &pos_conv);
+        if(bidi_txt == NULL) {
+            bidi_buf = _lv_mem_buf_get(line_end - line_start + 1);
+            if(sel_start != 0xFFFF && sel_end != 0xFFFF) {
+                uint32_t pos_conv_len = _lv_txt_encoded_get_char_id(&txt[line_start], line_end - line_start);
+                pos_conv_buf = _lv_mem_buf_get(pos_conv_len * sizeof(uint16_t));
+                _lv_bidi_process_paragraph(txt + line_start, bidi_buf, line_end - line_start, dsc->bidi_dir,
+                                           pos_conv_buf, pos_conv_len);
+                pos_conv = pos_conv_buf;
+            }
+            else {
+                _lv_bidi_process_paragraph(txt + line_start, bidi_buf, line_end - line_start, dsc->bidi_dir, NULL, 0);
+            }
+            bidi_txt = bidi_buf;
+        }
+        uint32_t line_char_start = 0;
+        uint32_t visual_char_pos = 0;
+        if(sel_start != 0xFFFF && sel_end != 0xFFFF) line_char_start = _lv_txt_encoded_get_char_id(txt, line_start);
 #else
         const char * bidi_txt = txt + line_start;
 #endif
@@ -253,15 +289,17 @@ LV_ATTRIBUTE_FAST_MEM void lv_draw_label(const lv_area_t * coords, const lv_area
             uint32_t logical_char_pos = 0;
             if(sel_start != 0xFFFF && sel_end != 0xFFFF) {
 #if LV_USE_BIDI
-                logical_char_pos = _lv_txt_encoded_get_char_id(txt, line_start);
-                uint32_t t = _lv_txt_encoded_get_char_id(bidi_txt, i);
-                logical_char_pos += _lv_bidi_get_logical_pos(bidi_txt, NULL, line_end - line_start, dsc->bidi_dir, t, NULL);
+                /*The highest bit of `pos_conv` tells only whether the character is in RTL context*/
+                logical_char_pos = line_char_start + (pos_conv[visual_char_pos] & 0x7FFF);
 #else
                 logical_char_pos = _lv_txt_encoded_get_char_id(txt, line_start + i);
 #endif
             }
 
             uint32_t letter      = _lv_txt_encoded_next(bidi_txt, &i);
+#if LV_USE_BIDI
+            visual_char_pos++;
+#endif
             uint32_t letter_next = _lv_txt_encoded_next(&bidi_txt[i], NULL);
 
             /*Handle the re-color command*/
@@ -350,8 +388,8 @@ LV_ATTRIBUTE_FAST_MEM void lv_draw_label(const lv_area_t * coords, const lv_area
         }
 
 #if LV_USE_BIDI
-        _lv_mem_buf_release(bidi_txt);
-        bidi_txt = NULL;
+        if(pos_conv_buf) _lv_mem_buf_release(pos_conv_buf);
+        if(bidi_buf) _lv_mem_buf_release(bidi_buf);
 #endif
         /*Go to next line*/
         line_start = line_end;
@@ -602,41 +640,56 @@ LV_ATTRIBUTE_FAST_MEM static void draw_letter_normal(lv_coord_t pos_x, lv_coord_
     _lv_mem_buf_release(mask_buf);
 }
 
-static void draw_letter_subpx(lv_coord_t pos_x, lv_coord_t pos_y, lv_font_glyph_dsc_t * g, const lv_area_t * clip_area,
-                              const uint8_t * map_p, lv_color_t color, lv_opa_t opa, lv_blend_mode_t blend_mode)
+LV_ATTRIBUTE_FAST_MEM static void draw_letter_subpx(lv_coord_t pos_x, lv_coord_t pos_y, lv_font_glyph_dsc_t * g,
+                                                    const lv_area_t * clip_area,
+                                                    const uint8_t * map_p, lv_color_t color, lv_opa_t opa, lv_blend_mode_t blend_mode)
 {
 #if LV_USE_FONT_SUBPX
-    const uint8_t * bpp_opa_table;
-    uint32_t bitmask_init;
-    uint32_t bitmask;
+    const uint8_t * bpp_opa_table_p;
     uint32_t bpp = g->bpp;
+    uint32_t shades;
     if(bpp == 3) bpp = 4;
 
     switch(bpp) {
         case 1:
-            bpp_opa_table = _lv_bpp1_opa_table;
-            bitmask_init  = 0x80;
+            bpp_opa_table_p = _lv_bpp1_opa_table;
+            shades = 2;
             break;
         case 2:
-            bpp_opa_table = _lv_bpp2_opa_table;
-            bitmask_init  = 0xC0;
+            bpp_opa_table_p = _lv_bpp2_opa_table;
+            shades = 4;
             break;
         case 4:
-            bpp_opa_table = _lv_bpp4_opa_table;
-            bitmask_init  = 0xF0;
+            bpp_opa_table_p = _lv_bpp4_opa_table;
+            shades = 16;
             break;
         case 8:
-            bpp_opa_table = _lv_bpp8_opa_table;
-            bitmask_init  = 0xFF;
-            break;       /*No opa table, pixel value will be used directly*/
+            bpp_opa_table_p = _lv_bpp8_opa_table;
+            shades = 256;
+            break;
         default:
             LV_LOG_WARN("lv_draw_letter: invalid bpp not found");
             return; /*Invalid bpp. Can't render the letter*/
     }
 
-    int32_t col, row;
+    /*Coverage of a sub-pixel for every pixel value of the font with `opa` already applied*/
+    static lv_opa_t opa_table[256];
+    static lv_opa_t prev_opa = LV_OPA_TRANSP;
+    static uint32_t prev_bpp = 0;
+    if(opa < LV_OPA_MAX) {
+        if(prev_opa != opa || prev_bpp != bpp) {
+            uint32_t i;
+            for(i = 0; i < shades; i++) {
+                opa_table[i] = bpp_opa_table_p[i] == LV_OPA_COVER ? opa : ((bpp_opa_table_p[i] * opa) >> 8);
+            }
+        }
+        bpp_opa_table_p = opa_table;
+        prev_opa = opa;
+        prev_bpp = bpp;
+    }
 
-    int32_t box_w = g->box_w;
+    int32_t row;
+    int32_t box_w = g->box_w;   /*In sub-pixels*/
     int32_t box_h = g->box_h;
     int32_t width_bit = box_w * bpp; /*Letter width in bits*/
 
@@ -646,20 +699,11 @@ static void draw_letter_subpx(lv_coord_t pos_x, lv_coord_t pos_y, lv_font_glyph_
     int32_t row_start = pos_y >= clip_area->y1 ? 0 : clip_area->y1 - pos_y;
     int32_t row_end   = pos_y + box_h <= clip_area->y2 ? box_h : clip_area->y2 - pos_y + 1;
 
-    /*Move on the map too*/
-    int32_t bit_ofs = (row_start * width_bit) + (col_start * bpp);
-    map_p += bit_ofs >> 3;
-
-    uint8_t letter_px;
-    lv_opa_t px_opa;
-    int32_t col_bit;
-    col_bit = bit_ofs & 0x7; /* "& 0x7" equals to "% 8" just faster */
+    int32_t px_cnt = (col_end - col_start) / 3;
+    if(px_cnt <= 0) return;
 
-    int32_t mask_buf_size = box_w * box_h > LV_HOR_RES_MAX ? LV_HOR_RES_MAX : g->box_w * g->box_h;
-    lv_opa_t * mask_buf = _lv_mem_buf_get(mask_buf_size);
-    int32_t mask_p = 0;
-
-    lv_color_t * color_buf = _lv_mem_buf_get(mask_buf_size * sizeof(lv_color_t));
+    /*Bit offset of the first visible sub-pixel in the map*/
+    uint32_t bit_ofs = (row_start * width_bit) + (col_start * bpp);
 
     lv_disp_t * disp    = _lv_refr_get_disp_refreshing();
     lv_disp_buf_t * vdb = lv_disp_get_buf(disp);
@@ -681,133 +725,168 @@ static void draw_letter_subpx(lv_coord_t pos_x, lv_coord_t pos_y, lv_font_glyph_
 
     uint8_t other_mask_cnt = lv_draw_mask_get_cnt();
 
-    uint8_t font_rgb[3];
-
-#if LV_COLOR_16_SWAP == 0
-    uint8_t txt_rgb[3] = {color.ch.red, color.ch.green, color.ch.blue};
-#else
-    uint8_t txt_rgb[3] = {color.ch.red, (color.ch.green_h << 3) + color.ch.green_l, color.ch.blue};
+    /*If nothing else should be applied on the pixels write the mixed colors directly to the VDB.
+     *Else collect them and blend them as an image.*/
+    bool direct = other_mask_cnt == 0 && opa == LV_OPA_COVER && blend_mode == LV_BLEND_MODE_NORMAL &&
+                  disp->driver.set_px_cb == NULL;
+#if LV_COLOR_SCREEN_TRANSP
+    if(disp->driver.screen_transp) direct = false;
 #endif
 
+    lv_opa_t * subpx_buf = _lv_mem_buf_get(col_end - col_start);
+    lv_opa_t * mask_buf = NULL;
+    lv_color_t * color_buf = NULL;
+    int32_t mask_buf_size = 0;
+    int32_t mask_p = 0;
+    if(!direct) {
+        lv_coord_t hor_res = lv_disp_get_hor_res(disp);
+        mask_buf_size = px_cnt * box_h > hor_res ? hor_res : px_cnt * box_h;
+        mask_buf = _lv_mem_buf_get(mask_buf_size);
+        color_buf = _lv_mem_buf_get(mask_buf_size * sizeof(lv_color_t));
+    }
+
     for(row = row_start ; row < row_end; row++) {
-        uint32_t subpx_cnt = 0;
-        bitmask = bitmask_init >> col_bit;
-        int32_t mask_p_start = mask_p;
+        subpx_unpack(&map_p[bit_ofs >> 3], bit_ofs & 0x7, bpp, col_end - col_start, bpp_opa_table_p, subpx_buf);
 
-        for(col = col_start; col < col_end; col++) {
-            /*Load the pixel's opacity into the mask*/
-            letter_px = (*map_p & bitmask) >> (8 - col_bit - bpp);
-            if(letter_px != 0) {
-                if(opa == LV_OPA_COVER) {
-                    px_opa = bpp == 8 ? letter_px : bpp_opa_table[letter_px];
-                }
-                else {
-                    px_opa = bpp == 8 ? (uint32_t)((uint32_t)letter_px * opa) >> 8
-                             : (uint32_t)((uint32_t)bpp_opa_table[letter_px] * opa) >> 8;
+        if(direct) {
+            subpx_mix(subpx_buf, vdb_buf_tmp, vdb_buf_tmp, NULL, px_cnt, color);
+        }
+        else {
+            subpx_mix(subpx_buf, vdb_buf_tmp, &color_buf[mask_p], &mask_buf[mask_p], px_cnt, color);
+
+            /*Apply masks if any*/
+            if(other_mask_cnt) {
+                lv_draw_mask_res_t mask_res = lv_draw_mask_apply(mask_buf + mask_p, map_area.x1, map_area.y2, px_cnt);
+                if(mask_res == LV_DRAW_MASK_RES_TRANSP) {
+                    _lv_memset_00(mask_buf + mask_p, px_cnt);
                 }
             }
-            else {
-                px_opa = 0;
+            mask_p += px_cnt;
+
+            if(mask_p + px_cnt <= mask_buf_size) {
+                map_area.y2 ++;
             }
+            else {
+                _lv_blend_map(clip_area, &map_area, color_buf, mask_buf, LV_DRAW_MASK_RES_CHANGED, opa, blend_mode);
 
-            font_rgb[subpx_cnt] = px_opa;
+                map_area.y1 = map_area.y2 + 1;
+                map_area.y2 = map_area.y1;
+                mask_p = 0;
+            }
+        }
 
-            subpx_cnt ++;
-            if(subpx_cnt == 3) {
-                subpx_cnt = 0;
+        bit_ofs += width_bit;
 
-                lv_color_t res_color;
-#if LV_COLOR_16_SWAP == 0
-                uint8_t bg_rgb[3] = {vdb_buf_tmp->ch.red, vdb_buf_tmp->ch.green, vdb_buf_tmp->ch.blue};
-#else
-                uint8_t bg_rgb[3] = {vdb_buf_tmp->ch.red,
-                                     (vdb_buf_tmp->ch.green_h << 3) + vdb_buf_tmp->ch.green_l,
-                                     vdb_buf_tmp->ch.blue
-                                    };
-#endif
+        /*Next row in VDB*/
+        vdb_buf_tmp += vdb_width;
+    }
 
-#if LV_FONT_SUBPX_BGR
-                res_color.ch.blue = (uint32_t)((uint32_t)txt_rgb[0] * font_rgb[0] + (bg_rgb[0] * (255 - font_rgb[0]))) >> 8;
-                res_color.ch.red = (uint32_t)((uint32_t)txt_rgb[2] * font_rgb[2] + (bg_rgb[2] * (255 - font_rgb[2]))) >> 8;
-#else
-                res_color.ch.red = (uint32_t)((uint16_t)txt_rgb[0] * font_rgb[0] + (bg_rgb[0] * (255 - font_rgb[0]))) >> 8;
-                res_color.ch.blue = (uint32_t)((uint16_t)txt_rgb[2] * font_rgb[2] + (bg_rgb[2] * (255 - font_rgb[2]))) >> 8;
-#endif
+    /*Flush the last part*/
+    if(!direct && map_area.y1 != map_area.y2) {
+        map_area.y2--;
+        _lv_blend_map(clip_area, &map_area, color_buf, mask_buf, LV_DRAW_MASK_RES_CHANGED, opa, blend_mode);
+    }
 
-#if LV_COLOR_16_SWAP == 0
-                res_color.ch.green = (uint32_t)((uint32_t)txt_rgb[1] * font_rgb[1] + (bg_rgb[1] * (255 - font_rgb[1]))) >> 8;
+    if(!direct) {
+        _lv_mem_buf_release(mask_buf);
+        _lv_mem_buf_release(color_buf);
+    }
+    _lv_mem_buf_release(subpx_buf);
 #else
-                uint8_t green = (uint32_t)((uint32_t)txt_rgb[1] * font_rgb[1] + (bg_rgb[1] * (255 - font_rgb[1]))) >> 8;
-                res_color.ch.green_h = green >> 3;
-                res_color.ch.green_l = green & 0x7;
-#endif
-
-#if LV_COLOR_DEPTH == 32
-                res_color.ch.alpha =  0xff;
+    LV_LOG_WARN("Can't draw sub-pixel rendered letter because LV_USE_FONT_SUBPX == 0 in lv_conf.h");
 #endif
+}
 
-                if(font_rgb[0] == 0 && font_rgb[1] == 0 && font_rgb[2] == 0) mask_buf[mask_p] = LV_OPA_TRANSP;
-                else mask_buf[mask_p] = LV_OPA_COVER;
-                color_buf[mask_p] = res_color;
-
-                /*Next mask byte*/
-                mask_p++;
-                vdb_buf_tmp++;
-            }
-
-            /*Go to the next column*/
-            if(col_bit < (int32_t)(8 - bpp)) {
-                col_bit += bpp;
-                bitmask = bitmask >> bpp;
-            }
-            else {
+#if LV_USE_FONT_SUBPX
+/**
+ * Convert a row of a sub-pixel rendered glyph to coverage values
+ * @param map_p pointer to the byte of the first sub-pixel
+ * @param col_bit bit index of the first sub-pixel in `map_p[0]`
+ * @param bpp bit-per-pixel of the font (1, 2, 4 or 8)
+ * @param cnt number of sub-pixels to convert
+ * @param opa_table coverage for each pixel value
+ * @param out store the coverage of the sub-pixels here
+ */
+LV_ATTRIBUTE_FAST_MEM static void subpx_unpack(const uint8_t * map_p, uint32_t col_bit, uint32_t bpp, int32_t cnt,
+                                               const lv_opa_t * opa_table, lv_opa_t * out)
+{
+    int32_t i = 0;
+    if(bpp == 8) {
+        for(i = 0; i < cnt; i++) out[i] = opa_table[map_p[i]];
+    }
+    else if(bpp == 4) {
+        /*Rows of glyphs with odd width start in the middle of a byte*/
+        if(col_bit) {
+            out[0] = opa_table[*map_p & 0xF];
+            map_p++;
+            i = 1;
+        }
+        for(; i + 1 < cnt; i += 2) {
+            uint8_t v = *map_p;
+            out[i] = opa_table[v >> 4];
+            out[i + 1] = opa_table[v & 0xF];
+            map_p++;
+        }
+        if(i < cnt) out[i] = opa_table[*map_p >> 4];
+    }
+    else {
+        uint32_t bitmask = (1 << bpp) - 1;
+        for(i = 0; i < cnt; i++) {
+            out[i] = opa_table[(*map_p >> (8 - bpp - col_bit)) & bitmask];
+            col_bit += bpp;
+            if(col_bit == 8) {
                 col_bit = 0;
-                bitmask = bitmask_init;
                 map_p++;
             }
         }
+    }
+}
 
-        /*Apply masks if any*/
-        if(other_mask_cnt) {
-            lv_draw_mask_res_t mask_res = lv_draw_mask_apply(mask_buf + mask_p_start, map_area.x1, map_area.y2,
-                                                             lv_area_get_width(&map_area));
-            if(mask_res == LV_DRAW_MASK_RES_TRANSP) {
-                _lv_memset_00(mask_buf + mask_p_start, lv_area_get_width(&map_area));
-            }
+/**
+ * Mix the text color with the background according to the coverage of the sub-pixels
+ * @param subpx coverage of the sub-pixels (3 for each pixel)
+ * @param bg_buf the background colors
+ * @param dest store the result here. Can be the same as `bg_buf`.
+ * @param mask if not `NULL` store the opacity of the pixels here. Else the fully transparent pixels are not written.
+ * @param px_cnt number of pixels
+ * @param color color of the text
+ */
+LV_ATTRIBUTE_FAST_MEM static void subpx_mix(const lv_opa_t * subpx, const lv_color_t * bg_buf, lv_color_t * dest,
+                                            lv_opa_t * mask, int32_t px_cnt, lv_color_t color)
+{
+    uint32_t txt_r = LV_COLOR_GET_R(color);
+    uint32_t txt_g = LV_COLOR_GET_G(color);
+    uint32_t txt_b = LV_COLOR_GET_B(color);
+
+    int32_t i;
+    for(i = 0; i < px_cnt; i++) {
+        uint32_t cov_r = subpx[SUBPX_R_OFS];
+        uint32_t cov_g = subpx[1];
+        uint32_t cov_b = subpx[SUBPX_B_OFS];
+        subpx += 3;
+
+        if((cov_r | cov_g | cov_b) == 0) {
+            if(mask) mask[i] = LV_OPA_TRANSP;
+            continue;
         }
 
-        if((int32_t) mask_p + (col_end - col_start) < mask_buf_size) {
-            map_area.y2 ++;
+        if((cov_r & cov_g & cov_b) == LV_OPA_COVER) {
+            dest[i] = color;
         }
         else {
-            _lv_blend_map(clip_area, &map_area, color_buf, mask_buf, LV_DRAW_MASK_RES_CHANGED, opa, blend_mode);
-
-            map_area.y1 = map_area.y2 + 1;
-            map_area.y2 = map_area.y1;
-            mask_p = 0;
+            lv_color_t bg = bg_buf[i];
+            lv_color_t res;
+            LV_COLOR_SET_R(res, LV_MATH_UDIV255(txt_r * cov_r + LV_COLOR_GET_R(bg) * (255 - cov_r) + LV_COLOR_MIX_ROUND_OFS));
+            LV_COLOR_SET_G(res, LV_MATH_UDIV255(txt_g * cov_g + LV_COLOR_GET_G(bg) * (255 - cov_g) + LV_COLOR_MIX_ROUND_OFS));
+            LV_COLOR_SET_B(res, LV_MATH_UDIV255(txt_b * cov_b + LV_COLOR_GET_B(bg) * (255 - cov_b) + LV_COLOR_MIX_ROUND_OFS));
+            LV_COLOR_SET_A(res, 0xFF);
+            dest[i] = res;
         }
 
-        col_bit += ((box_w - col_end) + col_start) * bpp;
-
-        map_p += (col_bit >> 3);
-        col_bit = col_bit & 0x7;
-
-        /*Next row in VDB*/
-        vdb_buf_tmp += vdb_width - (col_end - col_start) / 3;
-    }
-
-    /*Flush the last part*/
-    if(map_area.y1 != map_area.y2) {
-        map_area.y2--;
-        _lv_blend_map(clip_area, &map_area, color_buf, mask_buf, LV_DRAW_MASK_RES_CHANGED, opa, blend_mode);
+        if(mask) mask[i] = LV_OPA_COVER;
     }
-
-    _lv_mem_buf_release(mask_buf);
-    _lv_mem_buf_release(color_buf);
-#else
-    LV_LOG_WARN("Can't draw sub-pixel rendered letter because LV_USE_FONT_SUBPX == 0 in lv_conf.h");
-#endif
 }
+#endif
 
 /**
  * Convert a hexadecimal characters to a number (0..15)
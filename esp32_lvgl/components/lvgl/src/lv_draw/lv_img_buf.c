@@ -21,10 +21,47 @@
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_USE_IMG_TRANSFORM
+/*Stepper of the source coordinates along a transformed line*/
+typedef struct {
+    uint32_t acc_x;         /*Accumulator of the first pixel. Unsigned to wrap just like the per pixel calculation*/
+    uint32_t acc_y;         /*Not used if both zoomed and rotated*/
+    uint32_t step_x;        /*Added to the accumulators on every pixel*/
+    uint32_t step_y;
+    int32_t rot_x;          /*Line dependent part of the rotation if both zoomed and rotated*/
+    int32_t rot_y;
+    int32_t sinma;
+    int32_t cosma;
+    int32_t pivot_x_256;
+    int32_t pivot_y_256;
+    int32_t src_w;
+    int32_t src_h;
+    uint8_t shift;          /*Shift the accumulators with this to get the coordinates in 1/256 pixels*/
+    uint8_t zoom_rot : 1;   /*1: zoomed and rotated so the zoom is rounded before the rotation*/
+} trans_line_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+#if LV_USE_IMG_TRANSFORM
+static lv_coord_t zoom_edge(lv_coord_t pivot, uint16_t zoom, uint32_t zoom_inv, int32_t limit);
+static int32_t zoom_src(lv_coord_t x, lv_coord_t pivot, uint32_t zoom_inv);
+static void trans_line_init(trans_line_t * line, const lv_img_transform_dsc_t * dsc, lv_coord_t x, lv_coord_t y);
+static inline void trans_line_acc_to_src(const trans_line_t * line, uint32_t acc_x, uint32_t acc_y, int32_t * xs,
+                                         int32_t * ys);
+static int32_t trans_line_get_src(const trans_line_t * line, int32_t i, bool y_axis);
+static bool trans_line_passed(const trans_line_t * line, int32_t i, bool y_axis, int32_t limit, bool inc);
+static int32_t trans_line_find_edge(const trans_line_t * line, bool y_axis, int32_t limit, bool inc, int32_t len,
+                                    int32_t guess);
+static void trans_line_clip(const trans_line_t * line, bool y_axis, int32_t len, int32_t * start, int32_t * end);
+LV_ATTRIBUTE_FAST_MEM static void transform_line_nearest(const lv_img_transform_dsc_t * dsc, const trans_line_t * line,
+                                                         int32_t start, int32_t end, lv_color_t * cbuf, lv_opa_t * abuf);
+LV_ATTRIBUTE_FAST_MEM static void transform_line_zoom(const lv_img_transform_dsc_t * dsc, const trans_line_t * line,
+                                                      int32_t start, int32_t end, lv_color_t * cbuf, lv_opa_t * abuf);
+LV_ATTRIBUTE_FAST_MEM static void transform_line_aa(const lv_img_transform_dsc_t * dsc, const trans_line_t * line,
+                                                    int32_t start, int32_t end, lv_color_t * cbuf, lv_opa_t * abuf);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -557,6 +594,25 @@ void _lv_img_buf_get_transformed_area(lv_area_t * res, lv_coord_t w, lv_coord_t
 }
 
 #if LV_USE_IMG_TRANSFORM
+/**
+ * Get the pixels of a zoomed but not rotated rectangle whose source pixel is inside the rectangle.
+ * Unlike `_lv_img_buf_get_transformed_area` it's exact: it uses the same calculations as the transformation.
+ * @param res store the coordinates here
+ * @param w width of the rectangle to zoom
+ * @param h height of the rectangle to zoom
+ * @param zoom zoom, (256 no zoom)
+ * @param pivot x,y pivot coordinates of zoom
+ */
+void _lv_img_buf_get_zoomed_area(lv_area_t * res, lv_coord_t w, lv_coord_t h, uint16_t zoom, const lv_point_t * pivot)
+{
+    uint32_t zoom_inv = (((256 * 256) << _LV_ZOOM_INV_UPSCALE) + zoom / 2) / zoom;
+
+    res->x1 = zoom_edge(pivot->x, zoom, zoom_inv, 0);
+    res->x2 = zoom_edge(pivot->x, zoom, zoom_inv, w << 8) - 1;
+    res->y1 = zoom_edge(pivot->y, zoom, zoom_inv, 0);
+    res->y2 = zoom_edge(pivot->y, zoom, zoom_inv, h << 8) - 1;
+}
+
 /**
  * Continue transformation by taking the neighbors into account
  * @param dsc pointer to the transformation descriptor
@@ -676,7 +732,494 @@ bool _lv_img_buf_transform_anti_alias(lv_img_transform_dsc_t * dsc)
 
     return true;
 }
+
+/**
+ * Transform a horizontal line at once. The result is the same as calling `_lv_img_buf_transform` on every pixel
+ * but the source coordinates are stepped incrementally and the pixels out of the image are skipped.
+ * @param dsc a descriptor initialized by `_lv_img_buf_transform_init`
+ * @param x the first coordinate of the line (in the same system as `_lv_img_buf_transform`)
+ * @param y the y coordinate of the line
+ * @param len number of pixels to transform
+ * @param cbuf store the colors here (`len` elements). Undefined where `abuf` is `LV_OPA_TRANSP`.
+ * @param abuf store the opacities here (`len` elements). `LV_OPA_TRANSP` where the pixel was out of the image.
+ */
+void _lv_img_buf_transform_line(lv_img_transform_dsc_t * dsc, lv_coord_t x, lv_coord_t y, lv_coord_t len,
+                                lv_color_t * cbuf, lv_opa_t * abuf)
+{
+    if(len <= 0) return;
+
+    /*Indexed and alpha only images are rare here (only canvas uses them) so transform them pixel-by-pixel*/
+    if(dsc->tmp.native_color == 0) {
+        lv_coord_t i;
+        for(i = 0; i < len; i++) {
+            if(_lv_img_buf_transform(dsc, x + i, y)) {
+                cbuf[i] = dsc->res.color;
+                abuf[i] = dsc->res.opa;
+            }
+            else {
+                abuf[i] = LV_OPA_TRANSP;
+            }
+        }
+        return;
+    }
+
+    trans_line_t line;
+    trans_line_init(&line, dsc, x, y);
+
+    /*Only the pixels in [start, end) come from inside the image*/
+    int32_t start = 0;
+    int32_t end = len;
+    trans_line_clip(&line, false, len, &start, &end);
+    trans_line_clip(&line, true, len, &start, &end);
+    if(start >= end) {
+        _lv_memset_00(abuf, len);
+        return;
+    }
+
+    _lv_memset_00(abuf, start);
+    _lv_memset_00(&abuf[end], len - end);
+
+    if(dsc->cfg.antialias) transform_line_aa(dsc, &line, start, end, cbuf, abuf);
+    else if(dsc->cfg.angle == 0) transform_line_zoom(dsc, &line, start, end, cbuf, abuf);
+    else transform_line_nearest(dsc, &line, start, end, cbuf, abuf);
+}
 #endif
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
+
+#if LV_USE_IMG_TRANSFORM
+/**
+ * Prepare stepping the source coordinates along a line.
+ * The calculations are the same as in `_lv_img_buf_transform` to get exactly the same coordinates.
+ * @param line pointer to a line stepper to initialize
+ * @param dsc pointer to an initialized transformation descriptor
+ * @param x the first coordinate of the line
+ * @param y the y coordinate of the line
+ */
+static void trans_line_init(trans_line_t * line, const lv_img_transform_dsc_t * dsc, lv_coord_t x, lv_coord_t y)
+{
+    int32_t xt = x - dsc->cfg.pivot_x;
+    int32_t yt = y - dsc->cfg.pivot_y;
+
+    line->sinma = dsc->tmp.sinma;
+    line->cosma = dsc->tmp.cosma;
+    line->pivot_x_256 = dsc->tmp.pivot_x_256;
+    line->pivot_y_256 = dsc->tmp.pivot_y_256;
+    line->src_w = dsc->cfg.src_w;
+    line->src_h = dsc->cfg.src_h;
+    line->rot_x = 0;
+    line->rot_y = 0;
+    line->zoom_rot = 0;
+
+    if(dsc->cfg.zoom == LV_IMG_ZOOM_NONE) {
+        line->acc_x = (uint32_t)(dsc->tmp.cosma * xt - dsc->tmp.sinma * yt);
+        line->acc_y = (uint32_t)(dsc->tmp.sinma * xt + dsc->tmp.cosma * yt);
+        line->step_x = (uint32_t)dsc->tmp.cosma;
+        line->step_y = (uint32_t)dsc->tmp.sinma;
+        line->shift = _LV_TRANSFORM_TRIGO_SHIFT - 8;
+    }
+    else if(dsc->cfg.angle == 0) {
+        line->acc_x = (uint32_t)xt * dsc->tmp.zoom_inv;
+        line->acc_y = (uint32_t)yt * dsc->tmp.zoom_inv;
+        line->step_x = dsc->tmp.zoom_inv;
+        line->step_y = 0;
+        line->shift = _LV_ZOOM_INV_UPSCALE;
+    }
+    else {
+        int32_t yz = (int32_t)((uint32_t)yt * dsc->tmp.zoom_inv) >> _LV_ZOOM_INV_UPSCALE;
+        line->acc_x = (uint32_t)xt * dsc->tmp.zoom_inv;
+        line->acc_y = 0;
+        line->step_x = dsc->tmp.zoom_inv;
+        line->step_y = 0;
+        line->rot_x = -dsc->tmp.sinma * yz;
+        line->rot_y = dsc->tmp.cosma * yz;
+        line->shift = _LV_ZOOM_INV_UPSCALE;
+        line->zoom_rot = 1;
+    }
+}
+
+/**
+ * Convert the accumulators of a line stepper to source coordinates
+ * @param line pointer to a line stepper
+ * @param acc_x the x accumulator of the pixel
+ * @param acc_y the y accumulator of the pixel
+ * @param xs store the x coordinate in 1/256 pixels here
+ * @param ys store the y coordinate in 1/256 pixels here
+ */
+static inline void trans_line_acc_to_src(const trans_line_t * line, uint32_t acc_x, uint32_t acc_y, int32_t * xs,
+                                         int32_t * ys)
+{
+    if(line->zoom_rot) {
+        int32_t z = (int32_t)acc_x >> _LV_ZOOM_INV_UPSCALE;
+        *xs = ((line->cosma * z + line->rot_x) >> _LV_TRANSFORM_TRIGO_SHIFT) + line->pivot_x_256;
+        *ys = ((line->sinma * z + line->rot_y) >> _LV_TRANSFORM_TRIGO_SHIFT) + line->pivot_y_256;
+    }
+    else {
+        *xs = ((int32_t)acc_x >> line->shift) + line->pivot_x_256;
+        *ys = ((int32_t)acc_y >> line->shift) + line->pivot_y_256;
+    }
+}
+
+/**
+ * Get a source coordinate of any pixel of the line
+ * @param line pointer to a line stepper
+ * @param i index of the pixel in the line
+ * @param y_axis false: get the x coordinate; true: get the y coordinate
+ * @return the source coordinate in 1/256 pixels
+ */
+static int32_t trans_line_get_src(const trans_line_t * line, int32_t i, bool y_axis)
+{
+    int32_t xs;
+    int32_t ys;
+    trans_line_acc_to_src(line, line->acc_x + line->step_x * (uint32_t)i, line->acc_y + line->step_y * (uint32_t)i,
+                          &xs, &ys);
+    return y_axis ? ys : xs;
+}
+
+/**
+ * Tell whether the source coordinate of a pixel has already passed a limit
+ * @param line pointer to a line stepper
+ * @param i index of the pixel in the line
+ * @param y_axis false: check the x coordinate; true: check the y coordinate
+ * @param limit the limit in 1/256 pixels
+ * @param inc true: the coordinate increases along the line; false: it decreases
+ * @return true: `>= limit` if `inc`, else `< limit`
+ */
+static bool trans_line_passed(const trans_line_t * line, int32_t i, bool y_axis, int32_t limit, bool inc)
+{
+    int32_t v = trans_line_get_src(line, i, y_axis);
+    return inc ? v >= limit : v < limit;
+}
+
+/**
+ * Find the first pixel whose source coordinate passed a limit.
+ * Search around an estimated position first and refine it with binary search.
+ * @param line pointer to a line stepper
+ * @param y_axis false: check the x coordinate; true: check the y coordinate
+ * @param limit the limit in 1/256 pixels
+ * @param inc true: the coordinate increases along the line; false: it decreases
+ * @param len length of the line
+ * @param guess the estimated position, in [0, len - 1]
+ * @return index of the first pixel which passed the limit or `len` if none of them
+ */
+static int32_t trans_line_find_edge(const trans_line_t * line, bool y_axis, int32_t limit, bool inc, int32_t len,
+                                    int32_t guess)
+{
+    /*The edge is in [lo, hi]*/
+    int32_t lo;
+    int32_t hi;
+    int32_t step = 1;
+    if(trans_line_passed(line, guess, y_axis, limit, inc)) {
+        hi = guess;
+        lo = guess - 1;
+        while(lo >= 0 && trans_line_passed(line, lo, y_axis, limit, inc)) {
+            hi = lo;
+            step = step << 1;
+            lo -= step;
+        }
+        lo = lo < 0 ? 0 : lo + 1;
+    }
+    else {
+        lo = guess + 1;
+        hi = guess + 1;
+        while(hi < len && !trans_line_passed(line, hi, y_axis, limit, inc)) {
+            lo = hi + 1;
+            step = step << 1;
+            hi += step;
+        }
+        if(hi > len) hi = len;
+    }
+
+    while(lo < hi) {
+        int32_t mid = (lo + hi) >> 1;
+        if(trans_line_passed(line, mid, y_axis, limit, inc)) hi = mid;
+        else lo = mid + 1;
+    }
+
+    return lo;
+}
+
+/**
+ * Narrow `[start, end)` to the pixels whose source coordinate on an axis is inside the image.
+ * The source coordinates change monotonically along the line, so the edges can be estimated
+ * from the two ends of the line and only a few pixels need to be checked around them.
+ * @param line pointer to a line stepper
+ * @param y_axis false: check the x coordinate; true: check the y coordinate
+ * @param len length of the line
+ * @param start pointer to the first valid pixel. Increased if required.
+ * @param end pointer to the pixel after the last valid one. Decreased if required.
+ */
+static void trans_line_clip(const trans_line_t * line, bool y_axis, int32_t len, int32_t * start, int32_t * end)
+{
+    if(*start >= *end) return;
+
+    int32_t limit = (y_axis ? line->src_h : line->src_w) << 8;
+    int32_t first = trans_line_get_src(line, 0, y_axis);
+    int32_t last = trans_line_get_src(line, len - 1, y_axis);
+
+    if(first == last) {
+        if(first < 0 || first >= limit) *end = *start;
+        return;
+    }
+
+    bool inc = last > first;
+    int32_t lim_start = inc ? 0 : limit;
+    int32_t lim_end = inc ? limit : 0;
+
+    int32_t guess_start = (int32_t)(((int64_t)(lim_start - first) * (len - 1)) / (last - first));
+    int32_t guess_end = (int32_t)(((int64_t)(lim_end - first) * (len - 1)) / (last - first));
+    guess_start = LV_MATH_MIN(LV_MATH_MAX(guess_start, 0), len - 1);
+    guess_end = LV_MATH_MIN(LV_MATH_MAX(guess_end, 0), len - 1);
+
+    int32_t s = trans_line_find_edge(line, y_axis, lim_start, inc, len, guess_start);
+    int32_t e = trans_line_find_edge(line, y_axis, lim_end, inc, len, guess_end);
+    if(s > *start) *start = s;
+    if(e < *end) *end = e;
+}
+
+/**
+ * Read the color of a native pixel
+ * @param px pointer to the pixel
+ * @param has_alpha true: the pixel has an alpha byte which shouldn't be the part of the color
+ * @return the color
+ */
+static inline lv_color_t read_color(const uint8_t * px, bool has_alpha)
+{
+    lv_color_t c;
+#if LV_COLOR_DEPTH == 1 || LV_COLOR_DEPTH == 8
+    LV_UNUSED(has_alpha);
+    c.full = px[0];
+#elif LV_COLOR_DEPTH == 16
+    LV_UNUSED(has_alpha);
+    c.full = px[0] + (px[1] << 8);
+#elif LV_COLOR_DEPTH == 32
+    c.full = px[0] + (px[1] << 8) + ((uint32_t)px[2] << 16) + ((uint32_t)px[3] << 24);
+    if(has_alpha) c.ch.alpha = 0xFF;
+#endif
+    return c;
+}
+
+/**
+ * Transform the valid part of a line without anti-aliasing
+ * @param dsc pointer to an initialized transformation descriptor
+ * @param line pointer to the line stepper
+ * @param start index of the first pixel inside the image
+ * @param end index of the pixel after the last one inside the image
+ * @param cbuf store the colors here
+ * @param abuf store the opacities here
+ */
+LV_ATTRIBUTE_FAST_MEM static void transform_line_nearest(const lv_img_transform_dsc_t * dsc, const trans_line_t * line,
+                                                         int32_t start, int32_t end, lv_color_t * cbuf, lv_opa_t * abuf)
+{
+    const uint8_t * src_u8 = dsc->cfg.src;
+    bool has_alpha = dsc->tmp.has_alpha ? true : false;
+    bool chroma_keyed = dsc->tmp.chroma_keyed ? true : false;
+    uint32_t px_size = has_alpha ? LV_IMG_PX_SIZE_ALPHA_BYTE : sizeof(lv_color_t);
+    uint32_t stride = line->src_w * px_size;
+    lv_color_t chroma_color = LV_COLOR_TRANSP;
+
+    uint32_t acc_x = line->acc_x + line->step_x * (uint32_t)start;
+    uint32_t acc_y = line->acc_y + line->step_y * (uint32_t)start;
+    int32_t i;
+    for(i = start; i < end; i++) {
+        int32_t xs;
+        int32_t ys;
+        trans_line_acc_to_src(line, acc_x, acc_y, &xs, &ys);
+        acc_x += line->step_x;
+        acc_y += line->step_y;
+        const uint8_t * px = &src_u8[(ys >> 8) * stride + (xs >> 8) * px_size];
+        cbuf[i] = read_color(px, has_alpha);
+        abuf[i] = has_alpha ? px[px_size - 1] : LV_OPA_COVER;
+        if(chroma_keyed && cbuf[i].full == chroma_color.full) abuf[i] = LV_OPA_TRANSP;
+    }
+}
+
+/**
+ * Transform the valid part of a line without rotation and anti-aliasing.
+ * The source line is the same for every pixel and the source pixels are repeated when zoomed in.
+ * @param dsc pointer to an initialized transformation descriptor
+ * @param line pointer to the line stepper
+ * @param start index of the first pixel inside the image
+ * @param end index of the pixel after the last one inside the image
+ * @param cbuf store the colors here
+ * @param abuf store the opacities here
+ */
+LV_ATTRIBUTE_FAST_MEM static void transform_line_zoom(const lv_img_transform_dsc_t * dsc, const trans_line_t * line,
+                                                      int32_t start, int32_t end, lv_color_t * cbuf, lv_opa_t * abuf)
+{
+    bool has_alpha = dsc->tmp.has_alpha ? true : false;
+    bool chroma_keyed = dsc->tmp.chroma_keyed ? true : false;
+    uint32_t px_size = has_alpha ? LV_IMG_PX_SIZE_ALPHA_BYTE : sizeof(lv_color_t);
+    int32_t ys = trans_line_get_src(line, start, true);
+    const uint8_t * src_line = (const uint8_t *)dsc->cfg.src + (ys >> 8) * line->src_w * px_size;
+    lv_color_t chroma_color = LV_COLOR_TRANSP;
+
+    uint32_t acc_x = line->acc_x + line->step_x * (uint32_t)start;
+    int32_t xs_int_prev = -1;
+    lv_color_t c = chroma_color;
+    lv_opa_t opa = LV_OPA_TRANSP;
+    int32_t i;
+    for(i = start; i < end; i++) {
+        int32_t xs_int = (((int32_t)acc_x >> line->shift) + line->pivot_x_256) >> 8;
+        acc_x += line->step_x;
+        if(xs_int != xs_int_prev) {
+            const uint8_t * px = &src_line[xs_int * px_size];
+            c = read_color(px, has_alpha);
+            opa = has_alpha ? px[px_size - 1] : LV_OPA_COVER;
+            if(chroma_keyed && c.full == chroma_color.full) opa = LV_OPA_TRANSP;
+            xs_int_prev = xs_int;
+        }
+        cbuf[i] = c;
+        abuf[i] = opa;
+    }
+}
+
+/**
+ * Transform the valid part of a line with anti-aliasing.
+ * Mixes the neighbors exactly like `_lv_img_buf_transform_anti_alias` but reads only the required neighbors.
+ * @param dsc pointer to an initialized transformation descriptor
+ * @param line pointer to the line stepper
+ * @param start index of the first pixel inside the image
+ * @param end index of the pixel after the last one inside the image
+ * @param cbuf store the colors here
+ * @param abuf store the opacities here
+ */
+LV_ATTRIBUTE_FAST_MEM static void transform_line_aa(const lv_img_transform_dsc_t * dsc, const trans_line_t * line,
+                                                    int32_t start, int32_t end, lv_color_t * cbuf, lv_opa_t * abuf)
+{
+    const uint8_t * src_u8 = dsc->cfg.src;
+    bool has_alpha = dsc->tmp.has_alpha ? true : false;
+    bool chroma_keyed = dsc->tmp.chroma_keyed ? true : false;
+    int32_t px_size = has_alpha ? LV_IMG_PX_SIZE_ALPHA_BYTE : sizeof(lv_color_t);
+    int32_t stride = line->src_w * px_size;
+    lv_color_t chroma_color = LV_COLOR_TRANSP;
+
+    uint32_t acc_x = line->acc_x + line->step_x * (uint32_t)start;
+    uint32_t acc_y = line->acc_y + line->step_y * (uint32_t)start;
+    int32_t i;
+    for(i = start; i < end; i++) {
+        int32_t xs;
+        int32_t ys;
+        trans_line_acc_to_src(line, acc_x, acc_y, &xs, &ys);
+        acc_x += line->step_x;
+        acc_y += line->step_y;
+        int32_t xs_int = xs >> 8;
+        int32_t ys_int = ys >> 8;
+        const uint8_t * px = &src_u8[ys_int * stride + xs_int * px_size];
+
+        lv_color_t c00 = read_color(px, has_alpha);
+        if(chroma_keyed && c00.full == chroma_color.full) {
+            abuf[i] = LV_OPA_TRANSP;
+            continue;
+        }
+
+        /*Byte offset of the x and y neighbor and their mix ratio*/
+        int32_t xs_fract = xs & 0xff;
+        int32_t xn;
+        lv_opa_t xr;
+        if(xs_fract < 0x70) {
+            xn = xs_int > 0 ? -px_size : 0;
+            xr = xs_fract + 0x80;
+        }
+        else if(xs_fract > 0x90) {
+            xn = xs_int + 1 < line->src_w ? px_size : 0;
+            xr = (0xFF - xs_fract) + 0x80;
+        }
+        else {
+            xn = 0;
+            xr = 0xFF;
+        }
+
+        int32_t ys_fract = ys & 0xff;
+        int32_t yn;
+        lv_opa_t yr;
+        if(ys_fract < 0x70) {
+            yn = ys_int > 0 ? -stride : 0;
+            yr = ys_fract + 0x80;
+        }
+        else if(ys_fract > 0x90) {
+            yn = ys_int + 1 < line->src_h ? stride : 0;
+            yr = (0xFF - ys_fract) + 0x80;
+        }
+        else {
+            yn = 0;
+            yr = 0xFF;
+        }
+
+        lv_opa_t xr0 = xr;
+        lv_opa_t xr1 = xr;
+        if(has_alpha) {
+            lv_opa_t a00 = px[px_size - 1];
+            lv_opa_t a10 = px[xn + px_size - 1];
+            lv_opa_t a01 = px[yn + px_size - 1];
+            lv_opa_t a11 = px[xn + yn + px_size - 1];
+            lv_opa_t a0 = (a00 * xr + (a10 * (255 - xr))) >> 8;
+            lv_opa_t a1 = (a01 * xr + (a11 * (255 - xr))) >> 8;
+            if(a0 <= LV_OPA_MIN && a1 <= LV_OPA_MIN) {
+                abuf[i] = LV_OPA_TRANSP;
+                continue;
+            }
+            abuf[i] = (a0 * yr + (a1 * (255 - yr))) >> 8;
+
+            if(a0 <= LV_OPA_MIN) yr = LV_OPA_TRANSP;
+            if(a1 <= LV_OPA_MIN) yr = LV_OPA_COVER;
+            if(a00 <= LV_OPA_MIN) xr0 = LV_OPA_TRANSP;
+            if(a10 <= LV_OPA_MIN) xr0 = LV_OPA_COVER;
+            if(a01 <= LV_OPA_MIN) xr1 = LV_OPA_TRANSP;
+            if(a11 <= LV_OPA_MIN) xr1 = LV_OPA_COVER;
+        }
+        else {
+            abuf[i] = LV_OPA_COVER;
+        }
+
+        lv_color_t c0 = c00;
+        if(yr != LV_OPA_TRANSP) {
+            if(xr0 == LV_OPA_TRANSP) c0 = read_color(px + xn, has_alpha);
+            else if(xr0 != LV_OPA_COVER) c0 = lv_color_mix(c00, read_color(px + xn, has_alpha), xr0);
+        }
+
+        lv_color_t c1 = c00;
+        if(yr != LV_OPA_COVER) {
+            if(xr1 == LV_OPA_TRANSP) c1 = read_color(px + xn + yn, has_alpha);
+            else if(xr1 == LV_OPA_COVER) c1 = read_color(px + yn, has_alpha);
+            else c1 = lv_color_mix(read_color(px + yn, has_alpha), read_color(px + xn + yn, has_alpha), xr1);
+        }
+
+        if(yr == LV_OPA_TRANSP) cbuf[i] = c1;
+        else if(yr == LV_OPA_COVER) cbuf[i] = c0;
+        else cbuf[i] = lv_color_mix(c0, c1, yr);
+    }
+}
+
+/**
+ * Find the first pixel of a zoomed line whose source coordinate is at least a limit
+ * @param pivot the pivot of the zoom
+ * @param zoom zoom, (256 no zoom)
+ * @param zoom_inv the inverse of the zoom as in `lv_img_transform_dsc_t`
+ * @param limit the limit in 1/256 pixels
+ * @return the coordinate of the pixel
+ */
+static lv_coord_t zoom_edge(lv_coord_t pivot, uint16_t zoom, uint32_t zoom_inv, int32_t limit)
+{
+    /*Estimate the position and correct the rounding errors*/
+    lv_coord_t x = pivot + (((limit - (pivot << 8)) * zoom) >> 16);
+    while(zoom_src(x, pivot, zoom_inv) >= limit) x--;
+    while(zoom_src(x, pivot, zoom_inv) < limit) x++;
+    return x;
+}
+
+/**
+ * Get the source coordinate of a zoomed pixel the same way as `_lv_img_buf_transform`
+ * @param x coordinate of the pixel
+ * @param pivot the pivot of the zoom
+ * @param zoom_inv the inverse of the zoom as in `lv_img_transform_dsc_t`
+ * @return the source coordinate in 1/256 pixels
+ */
+static int32_t zoom_src(lv_coord_t x, lv_coord_t pivot, uint32_t zoom_inv)
+{
+    int32_t xt = x - pivot;
+    return ((int32_t)(xt * zoom_inv) >> _LV_ZOOM_INV_UPSCALE) + (pivot << 8);
+}
+#endif
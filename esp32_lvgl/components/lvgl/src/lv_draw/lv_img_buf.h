@@ -79,8 +79,8 @@ enum {
     LV_IMG_CF_ALPHA_4BIT, /**< Can have one color but 16 different alpha value*/
     LV_IMG_CF_ALPHA_8BIT, /**< Can have one color but 256 different alpha value*/
 
-    LV_IMG_CF_RESERVED_15,              /**< Reserved for further use. */
-    LV_IMG_CF_RESERVED_16,              /**< Reserved for further use. */
+    LV_IMG_CF_RLE,  /**< Run-length encoded image of an other color format. See `lv_img_compr_header_t`*/
+    LV_IMG_CF_LZ4,  /**< LZ4 (block format) compressed image of an other color format. See `lv_img_compr_header_t`*/
     LV_IMG_CF_RESERVED_17,              /**< Reserved for further use. */
     LV_IMG_CF_RESERVED_18,              /**< Reserved for further use. */
     LV_IMG_CF_RESERVED_19,              /**< Reserved for further use. */
@@ -133,6 +133,26 @@ typedef struct {
 } lv_img_header_t;
 #endif
 
+/**
+ * The beginning of the data of `LV_IMG_CF_RLE` and `LV_IMG_CF_LZ4` images (after the `lv_img_header_t` in files).
+ * It's followed by
+ * - `block_cnt + 1` `uint32_t` offsets of the compressed blocks relative to the first block.
+ *   (`block_cnt = (h + block_h - 1) / block_h`, the last offset is the end of the last block)
+ * - the not compressed palette of indexed images
+ * - the compressed blocks. Each contains `block_h` lines (the last block might be shorter)
+ *   stored as in the not compressed color format.
+ * RLE: a control byte with the number of pixels (1..127) in the lower 7 bits.
+ * If the MSB is set that many pixels follow, else one pixel follows to repeat.
+ * A pixel is `px_size / 8` bytes for true color formats and 1 byte for the others.
+ * LZ4: the blocks are independent LZ4 blocks.
+ * Use `scripts/img_compress.py` to create such images.
+ */
+typedef struct {
+    uint8_t cf;         /**< Color format of the decompressed image*/
+    uint8_t reserved;   /**< Always zero*/
+    uint16_t block_h;   /**< Number of lines compressed together*/
+} lv_img_compr_header_t;
+
 /** Image header it is compatible with
  * the result from image converter utility*/
 typedef struct {
@@ -278,6 +298,19 @@ void _lv_img_buf_transform_init(lv_img_transform_dsc_t * dsc);
  */
 bool _lv_img_buf_transform_anti_alias(lv_img_transform_dsc_t * dsc);
 
+/**
+ * Transform a horizontal line at once. The result is the same as calling `_lv_img_buf_transform` on every pixel
+ * but the source coordinates are stepped incrementally and the pixels out of the image are skipped.
+ * @param dsc a descriptor initialized by `_lv_img_buf_transform_init`
+ * @param x the first coordinate of the line (in the same system as `_lv_img_buf_transform`)
+ * @param y the y coordinate of the line
+ * @param len number of pixels to transform
+ * @param cbuf store the colors here (`len` elements). Undefined where `abuf` is `LV_OPA_TRANSP`.
+ * @param abuf store the opacities here (`len` elements). `LV_OPA_TRANSP` where the pixel was out of the image.
+ */
+void _lv_img_buf_transform_line(lv_img_transform_dsc_t * dsc, lv_coord_t x, lv_coord_t y, lv_coord_t len,
+                                lv_color_t * cbuf, lv_opa_t * abuf);
+
 /**
  * Get which color and opa would come to a pixel if it were rotated
  * @param dsc a descriptor initialized by `lv_img_buf_rotate_init`
@@ -379,6 +412,19 @@ static inline bool _lv_img_buf_transform(lv_img_transform_dsc_t * dsc, lv_coord_
 void _lv_img_buf_get_transformed_area(lv_area_t * res, lv_coord_t w, lv_coord_t h, int16_t angle, uint16_t zoom,
                                       const lv_point_t * pivot);
 
+#if LV_USE_IMG_TRANSFORM
+/**
+ * Get the pixels of a zoomed but not rotated rectangle whose source pixel is inside the rectangle.
+ * Unlike `_lv_img_buf_get_transformed_area` it's exact: it uses the same calculations as the transformation.
+ * @param res store the coordinates here
+ * @param w width of the rectangle to zoom
+ * @param h height of the rectangle to zoom
+ * @param zoom zoom, (256 no zoom)
+ * @param pivot x,y pivot coordinates of zoom
+ */
+void _lv_img_buf_get_zoomed_area(lv_area_t * res, lv_coord_t w, lv_coord_t h, uint16_t zoom, const lv_point_t * pivot);
+#endif
+
 /**********************
  *      MACROS
  **********************/
@@ -12,29 +12,70 @@
 #include "lv_draw_img.h"
 #include "../lv_hal/lv_hal_tick.h"
 #include "../lv_misc/lv_gc.h"
+#include "../lv_misc/lv_task.h"
 
 /*********************
  *      DEFINES
  *********************/
-/*Decrement life with this value on every open*/
-#define LV_IMG_CACHE_AGING 1
-
 /*Boost life by this factor (multiply time_to_open with this value)*/
-#define LV_IMG_CACHE_LIFE_GAIN 1
+#define LV_IMG_CACHE_LIFE_GAIN 16
 
-/*Don't let life to be greater than this limit because it would require a lot of time to
- * "die" from very high values */
+/*Don't let life to be greater than the clock + this limit because it would require a lot of
+ * evictions to "die" from very high values */
 #define LV_IMG_CACHE_LIFE_LIMIT 1000
 
+/*Mark the end of a hash chain*/
+#define NO_ENTRY    0xFFFF
+
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_IMG_CACHE_DEF_SIZE
+/*An image being preloaded*/
+typedef struct {
+    const void * src;           /*The source of the image. File paths are copied*/
+    lv_color_t color;
+    uint32_t hash;
+    lv_img_decoder_dsc_t dec_dsc;
+    uint8_t * buf;              /*The image decoded line-by-line. NULL: the image is available as it's opened*/
+    lv_img_cf_t buf_cf;         /*Color format of `buf`*/
+    lv_coord_t y;               /*The next line to decode. -1: not opened yet*/
+    uint32_t time;              /*Time spent with opening and decoding the image [ms]*/
+} lv_img_preload_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 #if LV_IMG_CACHE_DEF_SIZE
 static bool lv_img_cache_match(const void * src1, const void * src2);
+static uint32_t get_hash(const void * src, lv_color_t color);
+static uint32_t get_size(const lv_img_decoder_dsc_t * dsc);
+static void set_life(lv_img_cache_entry_t * entry);
+static lv_img_cache_entry_t * get_weakest(const lv_img_cache_entry_t * skip, bool mem_only);
+static void drop_entry(lv_img_cache_entry_t * entry, bool evict);
+static void link_entry(lv_img_cache_entry_t * entry);
+static void unlink_entry(lv_img_cache_entry_t * entry);
+static void shrink_to_mem_size(const lv_img_cache_entry_t * keep);
+static lv_img_cache_entry_t * find_entry(const void * src, lv_color_t color, uint32_t hash);
+static lv_img_cache_entry_t * reserve_entry(void);
+static void add_entry(lv_img_cache_entry_t * entry, uint32_t hash);
+static void drop_entries(const void * src);
+static lv_img_preload_t * find_job(const void * src, lv_color_t color, uint32_t hash);
+static void preload_task_cb(lv_task_t * task);
+static bool preload_step(lv_img_preload_t * job, uint32_t t_start);
+static void preload_finish(lv_img_preload_t * job);
+static void preload_cancel(lv_img_preload_t * job);
+static void preload_remove(lv_img_preload_t * job);
+static void preloaded_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
+#endif
+
+#if LV_IMG_CACHE_DEF_SIZE && LV_USE_IMG_TRANSFORM
+static uint32_t get_variant_key(int16_t angle, uint16_t zoom, const lv_point_t * pivot, bool antialias);
+static lv_img_cache_variant_t * create_variant(lv_img_cache_entry_t * entry, int16_t angle, uint16_t zoom,
+                                               const lv_point_t * pivot, bool antialias, uint32_t key);
+static void free_variants(lv_img_cache_entry_t * entry);
+static bool drop_oldest_variant(void);
 #endif
 
 #if LV_IMG_CACHE_DEF_SIZE == 0
@@ -46,6 +87,21 @@ static bool lv_img_cache_match(const void * src1, const void * src2);
  **********************/
 #if LV_IMG_CACHE_DEF_SIZE
     static uint16_t entry_cnt;
+    static uint32_t bucket_cnt;     /*Up to 64K for 64K - 1 entries so it doesn't fit in 16 bits*/
+    static uint16_t * buckets;
+    static int32_t life_clock;
+    static uint32_t mem_size;
+    static lv_img_cache_stats_t cache_stats;
+    static lv_task_t * preload_task;
+    static lv_img_cache_preload_cb_t preload_cb;
+
+    /*Closes the images decoded by the preload task*/
+    static lv_img_decoder_t preloaded_decoder;
+#endif
+
+#if LV_IMG_CACHE_DEF_SIZE && LV_USE_IMG_TRANSFORM
+    static uint32_t variant_mem_size;
+    static uint32_t variant_clock;
 #endif
 
 /**********************
@@ -75,49 +131,23 @@ lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color)
         return NULL;
     }
 
-    lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
-
-    /*Decrement all lifes. Make the entries older*/
-    uint16_t i;
-    for(i = 0; i < entry_cnt; i++) {
-        if(cache[i].life > INT32_MIN + LV_IMG_CACHE_AGING) {
-            cache[i].life -= LV_IMG_CACHE_AGING;
-        }
-    }
-
-    for(i = 0; i < entry_cnt; i++) {
-        if(color.full == cache[i].dec_dsc.color.full &&
-           lv_img_cache_match(src, cache[i].dec_dsc.src)) {
-            /* If opened increment its life.
-             * Image difficult to open should live longer to keep avoid frequent their recaching.
-             * Therefore increase `life` with `time_to_open`*/
-            cached_src = &cache[i];
-            cached_src->life += cached_src->dec_dsc.time_to_open * LV_IMG_CACHE_LIFE_GAIN;
-            if(cached_src->life > LV_IMG_CACHE_LIFE_LIMIT) cached_src->life = LV_IMG_CACHE_LIFE_LIMIT;
-            LV_LOG_TRACE("image draw: image found in the cache");
-            break;
-        }
+    uint32_t hash = get_hash(src, color);
+    cached_src = find_entry(src, color, hash);
+    if(cached_src) {
+        /* If opened renew its life.
+         * Image difficult to open should live longer to keep avoid frequent their recaching.
+         * Therefore the life depends on `time_to_open`*/
+        set_life(cached_src);
+        cache_stats.hit_cnt++;
+        LV_LOG_TRACE("image draw: image found in the cache");
+        return cached_src;
     }
 
-    /*The image is not cached then cache it now*/
-    if(cached_src) return cached_src;
-
-    /*Find an entry to reuse. Select the entry with the least life*/
-    cached_src = &cache[0];
-    for(i = 1; i < entry_cnt; i++) {
-        if(cache[i].life < cached_src->life) {
-            cached_src = &cache[i];
-        }
-    }
+    cache_stats.miss_cnt++;
 
-    /*Close the decoder to reuse if it was opened (has a valid source)*/
-    if(cached_src->dec_dsc.src) {
-        lv_img_decoder_close(&cached_src->dec_dsc);
-        LV_LOG_INFO("image draw: cache miss, close and reuse an entry");
-    }
-    else {
-        LV_LOG_INFO("image draw: cache miss, cached to an empty entry");
-    }
+    /*The image is not cached then cache it now.*/
+    cached_src = reserve_entry();
+    if(cached_src == NULL) return NULL;
 #else
     cached_src = &cache_temp;
 #endif
@@ -127,12 +157,9 @@ lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color)
     if(open_res == LV_RES_INV) {
         LV_LOG_WARN("Image draw cannot open the image resource");
         _lv_memset_00(cached_src, sizeof(lv_img_cache_entry_t));
-        cached_src->life = INT32_MIN; /*Make the empty entry very "weak" to force its use  */
         return NULL;
     }
 
-    cached_src->life = 0;
-
     /*If `time_to_open` was not set in the open function set it here*/
     if(cached_src->dec_dsc.time_to_open == 0) {
         cached_src->dec_dsc.time_to_open = lv_tick_elaps(t_start);
@@ -140,9 +167,178 @@ lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color)
 
     if(cached_src->dec_dsc.time_to_open == 0) cached_src->dec_dsc.time_to_open = 1;
 
+#if LV_IMG_CACHE_DEF_SIZE
+    add_entry(cached_src, hash);
+#endif
+
     return cached_src;
 }
 
+/**
+ * Open and decode an image into the cache in the background (with an `lv_task`) to avoid stalling the refresh
+ * when it's drawn first. The images read line-by-line (e.g. files) are decoded in
+ * `LV_IMG_CACHE_PRELOAD_TIME` ms long steps and kept in the cache as a whole.
+ * @param src source of the image. Path to file or pointer to an `lv_img_dsc_t` variable
+ * @param color The color of the image with `LV_IMG_CF_ALPHA_...`
+ * @return LV_RES_OK: the image is cached or being loaded; LV_RES_INV: the cache is disabled or out of memory
+ */
+lv_res_t lv_img_cache_preload(const void * src, lv_color_t color)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    if(entry_cnt == 0) return LV_RES_INV;
+
+    lv_img_src_t src_type = lv_img_src_get_type(src);
+    if(src_type != LV_IMG_SRC_FILE && src_type != LV_IMG_SRC_VARIABLE) return LV_RES_INV;
+
+    uint32_t hash = get_hash(src, color);
+    if(find_entry(src, color, hash) || find_job(src, color, hash)) return LV_RES_OK;
+
+    /*The list is empty without the task*/
+    if(preload_task == NULL) _lv_ll_init(&LV_GC_ROOT(_lv_img_preload_ll), sizeof(lv_img_preload_t));
+
+    lv_img_preload_t * job = _lv_ll_ins_tail(&LV_GC_ROOT(_lv_img_preload_ll));
+    LV_ASSERT_MEM(job);
+    if(job == NULL) return LV_RES_INV;
+
+    _lv_memset_00(job, sizeof(lv_img_preload_t));
+    job->color = color;
+    job->hash = hash;
+    job->y = -1;
+    if(src_type == LV_IMG_SRC_FILE) {
+        job->src = lv_mem_alloc(strlen(src) + 1);
+        LV_ASSERT_MEM(job->src);
+        if(job->src) strcpy((char *)job->src, src);
+    }
+    else {
+        job->src = src;
+    }
+
+    /*Decode the images only if there is nothing else to do*/
+    if(job->src && preload_task == NULL) {
+        preload_task = lv_task_create(preload_task_cb, 0, LV_TASK_PRIO_LOWEST, NULL);
+        LV_ASSERT_MEM(preload_task);
+    }
+
+    if(job->src == NULL || preload_task == NULL) {
+        preload_remove(job);
+        return LV_RES_INV;
+    }
+
+    return LV_RES_OK;
+#else
+    LV_UNUSED(src);
+    LV_UNUSED(color);
+    return LV_RES_INV;
+#endif
+}
+
+/**
+ * Tell whether an image is being preloaded
+ * @param src source of the image. Path to file or pointer to an `lv_img_dsc_t` variable
+ * @param color The color of the image with `LV_IMG_CF_ALPHA_...`
+ * @return true: `lv_img_cache_preload()` was called for the image but it's not in the cache yet
+ */
+bool lv_img_cache_is_loading(const void * src, lv_color_t color)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    if(preload_task == NULL) return false;
+
+    return find_job(src, color, get_hash(src, color)) != NULL;
+#else
+    LV_UNUSED(src);
+    LV_UNUSED(color);
+    return false;
+#endif
+}
+
+/**
+ * Tell whether an image is in the cache (opened) without touching its life or the statistics
+ * @param src source of the image. Path to file or pointer to an `lv_img_dsc_t` variable
+ * @param color The color of the image with `LV_IMG_CF_ALPHA_...`
+ * @return true: the image can be drawn without opening it
+ */
+bool lv_img_cache_is_cached(const void * src, lv_color_t color)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    if(entry_cnt == 0) return false;
+
+    return find_entry(src, color, get_hash(src, color)) != NULL;
+#else
+    LV_UNUSED(src);
+    LV_UNUSED(color);
+    return false;
+#endif
+}
+
+/**
+ * Set a function to call when the preloading of an image is finished or canceled.
+ * Used by the image object to redraw itself.
+ * @param cb the callback function
+ */
+void _lv_img_cache_set_preload_cb(lv_img_cache_preload_cb_t cb)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    preload_cb = cb;
+#else
+    LV_UNUSED(cb);
+#endif
+}
+
+/**
+ * Get a rotated/zoomed copy of a cached image. Create it if it doesn't exist yet.
+ * @param entry pointer to a cache entry returned by `_lv_img_cache_open`
+ * @param angle angle of the rotation (0.1 degree resolution)
+ * @param zoom zoom factor (256: no zoom)
+ * @param pivot pivot of the rotation relative to the image
+ * @param antialias true: transform with anti-aliasing
+ * @return pointer to the transformed copy or NULL if the image should be transformed while drawing
+ *         (the cache is disabled, the image is not available as a whole, it seems animated or no memory)
+ */
+lv_img_cache_variant_t * _lv_img_cache_get_variant(lv_img_cache_entry_t * entry, int16_t angle, uint16_t zoom,
+                                                   const lv_point_t * pivot, bool antialias)
+{
+#if LV_IMG_CACHE_DEF_SIZE && LV_USE_IMG_TRANSFORM
+    if(variant_mem_size == 0) return NULL;
+
+    /*Only the images available as a whole are transformed*/
+    lv_img_cf_t cf = entry->dec_dsc.header.cf;
+    if(entry->dec_dsc.img_data == NULL) return NULL;
+    if(cf != LV_IMG_CF_TRUE_COLOR && cf != LV_IMG_CF_TRUE_COLOR_ALPHA && cf != LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED) {
+        return NULL;
+    }
+
+    uint32_t key = get_variant_key(angle, zoom, pivot, antialias);
+    lv_img_cache_variant_t * v;
+    for(v = entry->variants; v != NULL; v = v->next) {
+        if(v->key == key && v->angle == angle && v->zoom == zoom && v->pivot.x == pivot->x && v->pivot.y == pivot->y &&
+           v->antialias == antialias) {
+            /* An older copy is used again so the image is not animated.
+             * The newest copy is also used when the image is drawn in more parts in the same frame
+             * so it doesn't tell anything.*/
+            if(v != entry->variants) entry->variant_miss_cnt = 0;
+            v->last_used = ++variant_clock;
+            cache_stats.variant_hit_cnt++;
+            return v;
+        }
+    }
+
+    cache_stats.variant_miss_cnt++;
+
+    /*New transformations one after the other: probably animated so don't waste time to cache it*/
+    if(entry->variant_miss_cnt >= LV_IMG_CACHE_VARIANT_MAX_KEYS) return NULL;
+    entry->variant_miss_cnt++;
+
+    return create_variant(entry, angle, zoom, pivot, antialias, key);
+#else
+    LV_UNUSED(entry);
+    LV_UNUSED(angle);
+    LV_UNUSED(zoom);
+    LV_UNUSED(pivot);
+    LV_UNUSED(antialias);
+    return NULL;
+#endif
+}
+
 /**
  * Set the number of images to be cached.
  * More cached images mean more opened image at same time which might mean more memory usage.
@@ -157,44 +353,148 @@ void lv_img_cache_set_size(uint16_t new_entry_cnt)
 #else
     if(LV_GC_ROOT(_lv_img_cache_array) != NULL) {
         /*Clean the cache before free it*/
-        lv_img_cache_invalidate_src(NULL);
+        drop_entries(NULL);
         lv_mem_free(LV_GC_ROOT(_lv_img_cache_array));
     }
 
-    /*Reallocate the cache*/
-    LV_GC_ROOT(_lv_img_cache_array) = lv_mem_alloc(sizeof(lv_img_cache_entry_t) * new_entry_cnt);
+    /*The last index is reserved to mark the end of the chains*/
+    if(new_entry_cnt == NO_ENTRY) new_entry_cnt--;
+
+    /*Use at least as many hash indexes as entries to keep the chains short*/
+    uint32_t new_bucket_cnt = 1;
+    while(new_bucket_cnt < new_entry_cnt) new_bucket_cnt <<= 1;
+
+    /*Reallocate the cache. The hash indexes are stored after the entries*/
+    LV_GC_ROOT(_lv_img_cache_array) = lv_mem_alloc(sizeof(lv_img_cache_entry_t) * new_entry_cnt +
+                                                   sizeof(uint16_t) * new_bucket_cnt);
     LV_ASSERT_MEM(LV_GC_ROOT(_lv_img_cache_array));
     if(LV_GC_ROOT(_lv_img_cache_array) == NULL) {
         entry_cnt = 0;
+        bucket_cnt = 0;
+        buckets = NULL;
         return;
     }
     entry_cnt = new_entry_cnt;
+    bucket_cnt = new_bucket_cnt;
+    buckets = (uint16_t *)&LV_GC_ROOT(_lv_img_cache_array)[entry_cnt];
 
     /*Clean the cache*/
     _lv_memset_00(LV_GC_ROOT(_lv_img_cache_array), entry_cnt * sizeof(lv_img_cache_entry_t));
+    _lv_memset_ff(buckets, bucket_cnt * sizeof(uint16_t));
+    life_clock = 0;
+    cache_stats.mem_used = 0;
+    cache_stats.entry_used = 0;
+#endif
+}
+
+/**
+ * Set the memory budget of the image cache.
+ * The size of the decoded images kept open by the cache are added and if it exceeds the budget
+ * the images least worth keeping (cheap to open but large) are closed.
+ * @param size the budget in bytes. 0: limit only the number of cached images
+ */
+void lv_img_cache_set_mem_size(uint32_t size)
+{
+#if LV_IMG_CACHE_DEF_SIZE == 0
+    LV_UNUSED(size);
+    LV_LOG_WARN("Can't change cache memory size because it's disabled by LV_IMG_CACHE_DEF_SIZE = 0");
+#else
+    mem_size = size;
+    shrink_to_mem_size(NULL);
+#endif
+}
+
+/**
+ * Set the memory budget of the rotated/zoomed copies of the cached images.
+ * If the budget is exceeded the least recently used copies are freed.
+ * @param size the budget in bytes. 0: don't cache the transformed images
+ */
+void lv_img_cache_set_variant_mem_size(uint32_t size)
+{
+#if LV_IMG_CACHE_DEF_SIZE && LV_USE_IMG_TRANSFORM
+    variant_mem_size = size;
+    while(cache_stats.variant_mem_used > variant_mem_size) {
+        if(drop_oldest_variant() == false) break;
+    }
+#else
+    LV_UNUSED(size);
+#endif
+}
+
+/**
+ * Get the statistics of the image cache
+ * @param stats store the statistics here
+ */
+void lv_img_cache_get_stats(lv_img_cache_stats_t * stats)
+{
+#if LV_IMG_CACHE_DEF_SIZE == 0
+    _lv_memset_00(stats, sizeof(lv_img_cache_stats_t));
+#else
+    *stats = cache_stats;
+    stats->mem_size = mem_size;
+    stats->entry_cnt = entry_cnt;
+#if LV_USE_IMG_TRANSFORM
+    stats->variant_mem_size = variant_mem_size;
+#endif
+#endif
+}
+
+/**
+ * Reset the hit, miss and eviction counters of the image cache
+ */
+void lv_img_cache_reset_stats(void)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    cache_stats.hit_cnt = 0;
+    cache_stats.miss_cnt = 0;
+    cache_stats.evict_cnt = 0;
+    cache_stats.variant_hit_cnt = 0;
+    cache_stats.variant_miss_cnt = 0;
+    cache_stats.preload_cnt = 0;
 #endif
 }
 
 /**
  * Invalidate an image source in the cache.
  * Useful if the image source is updated therefore it needs to be cached again.
+ * The preloading of the image is canceled too.
  * @param src an image source path to a file or pointer to an `lv_img_dsc_t` variable.
  */
 void lv_img_cache_invalidate_src(const void * src)
 {
 #if LV_IMG_CACHE_DEF_SIZE
-    lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+    drop_entries(src);
+
+    lv_img_preload_t * job = preload_task ? _lv_ll_get_head(&LV_GC_ROOT(_lv_img_preload_ll)) : NULL;
+    while(job) {
+        lv_img_preload_t * next = _lv_ll_get_next(&LV_GC_ROOT(_lv_img_preload_ll), job);
+        if(src == NULL || lv_img_cache_match(src, job->src)) preload_cancel(job);
+        job = next;
+    }
+#else
+    LV_UNUSED(src);
+#endif
+}
+
+/**
+ * Free the rotated/zoomed copies of an image source but keep the image itself in the cache.
+ * Useful if the pixels of the image are modified in place (e.g. a canvas).
+ * @param src an image source path to a file or pointer to an `lv_img_dsc_t` variable.
+ */
+void lv_img_cache_invalidate_variants(const void * src)
+{
+#if LV_IMG_CACHE_DEF_SIZE && LV_USE_IMG_TRANSFORM
+    /*Called for every modification of a canvas so return quickly if there is nothing to free*/
+    if(cache_stats.variant_mem_used == 0) return;
 
+    lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
     uint16_t i;
     for(i = 0; i < entry_cnt; i++) {
-        if(src == NULL || lv_img_cache_match(src, cache[i].dec_dsc.src)) {
-            if(cache[i].dec_dsc.src != NULL) {
-                lv_img_decoder_close(&cache[i].dec_dsc);
-            }
-
-            _lv_memset_00(&cache[i], sizeof(lv_img_cache_entry_t));
-        }
+        if(cache[i].variants == NULL) continue;
+        if(lv_img_cache_match(src, cache[i].dec_dsc.src)) free_variants(&cache[i]);
     }
+#else
+    LV_UNUSED(src);
 #endif
 }
 
@@ -214,4 +514,619 @@ static bool lv_img_cache_match(const void * src1, const void * src2)
         return false;
     return strcmp(src1, src2) == 0;
 }
+
+/**
+ * Hash the source (the path or the address of the variable) and the color with FNV-1a
+ * @param src the image source
+ * @param color the color of the image
+ * @return the hash
+ */
+static uint32_t get_hash(const void * src, lv_color_t color)
+{
+    uint32_t h = 2166136261u;
+    if(lv_img_src_get_type(src) == LV_IMG_SRC_VARIABLE) {
+        uintptr_t p = (uintptr_t)src;
+        uint32_t i;
+        for(i = 0; i < sizeof(uintptr_t); i++) {
+            h = (h ^ (p & 0xFF)) * 16777619u;
+            p >>= 8;
+        }
+    }
+    else {
+        const uint8_t * c = src;
+        while(*c) {
+            h = (h ^ *c) * 16777619u;
+            c++;
+        }
+    }
+
+    h = (h ^ (uint32_t)color.full) * 16777619u;
+
+    /*Mix the high bits into the low bits used as hash index*/
+    return h ^ (h >> 16);
+}
+
+/**
+ * Estimate how much memory the decoder keeps allocated while the image is open
+ * @param dsc the opened image's decoder descriptor
+ * @return the size in bytes
+ */
+static uint32_t get_size(const lv_img_decoder_dsc_t * dsc)
+{
+    /*Decoded line-by-line, the decoder uses only small line buffers*/
+    if(dsc->img_data == NULL) return 0;
+
+    /*The pixels of the variable are used directly*/
+    if(dsc->src_type == LV_IMG_SRC_VARIABLE && dsc->img_data == ((const lv_img_dsc_t *)dsc->src)->data) return 0;
+
+    return lv_img_buf_get_img_size(dsc->header.w, dsc->header.h, dsc->header.cf);
+}
+
+/**
+ * Give a new life to an entry: the current clock + the gain of the entry.
+ * The gain is proportional to `time_to_open` and inversely to the memory used by the entry
+ * so the images slow to open but small live longer.
+ * @param entry pointer to an opened entry
+ */
+static void set_life(lv_img_cache_entry_t * entry)
+{
+    uint32_t gain = (entry->dec_dsc.time_to_open * LV_IMG_CACHE_LIFE_GAIN) / ((entry->size >> 10) + 1);
+    if(gain > LV_IMG_CACHE_LIFE_LIMIT) gain = LV_IMG_CACHE_LIFE_LIMIT;
+    if(gain == 0) gain = 1;
+
+    entry->life = life_clock + (int32_t)gain;
+}
+
+/**
+ * Find the entry to close first
+ * @param skip don't select this entry (can be NULL)
+ * @param mem_only select only from the opened entries which use memory
+ * @return an empty entry or the entry with the least life. NULL if there is no such entry.
+ */
+static lv_img_cache_entry_t * get_weakest(const lv_img_cache_entry_t * skip, bool mem_only)
+{
+    lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+    lv_img_cache_entry_t * weakest = NULL;
+    uint16_t i;
+    for(i = 0; i < entry_cnt; i++) {
+        if(&cache[i] == skip) continue;
+        if(cache[i].dec_dsc.src == NULL) {
+            if(mem_only) continue;
+            else return &cache[i];
+        }
+        if(mem_only && cache[i].size == 0) continue;
+
+        if(weakest == NULL || cache[i].life < weakest->life) weakest = &cache[i];
+    }
+
+    return weakest;
+}
+
+/**
+ * Close an opened entry and clear it
+ * @param entry pointer to an opened entry
+ * @param evict true: the entry is closed to make room for other images
+ */
+static void drop_entry(lv_img_cache_entry_t * entry, bool evict)
+{
+    if(evict) {
+        /*Age the other entries by raising the clock to the life of the closed entry*/
+        if(entry->life > life_clock) life_clock = entry->life;
+        cache_stats.evict_cnt++;
+
+        /*Rebase the lives before the clock overflows*/
+        if(life_clock > INT32_MAX / 2) {
+            lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+            uint16_t i;
+            for(i = 0; i < entry_cnt; i++) {
+                if(cache[i].dec_dsc.src) cache[i].life -= life_clock;
+            }
+            life_clock = 0;
+        }
+    }
+
+    unlink_entry(entry);
+#if LV_USE_IMG_TRANSFORM
+    free_variants(entry);
+#endif
+    lv_img_decoder_close(&entry->dec_dsc);
+    cache_stats.mem_used -= entry->size;
+    cache_stats.entry_used--;
+
+    _lv_memset_00(entry, sizeof(lv_img_cache_entry_t));
+}
+
+/**
+ * Add an entry to the chain of its hash index
+ * @param entry pointer to an opened entry
+ */
+static void link_entry(lv_img_cache_entry_t * entry)
+{
+    uint16_t * b = &buckets[entry->hash & (bucket_cnt - 1)];
+    entry->next = *b;
+    *b = entry - LV_GC_ROOT(_lv_img_cache_array);
+}
+
+/**
+ * Remove an entry from the chain of its hash index
+ * @param entry pointer to an opened entry
+ */
+static void unlink_entry(lv_img_cache_entry_t * entry)
+{
+    lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+    uint16_t id = entry - cache;
+    uint16_t * p = &buckets[entry->hash & (bucket_cnt - 1)];
+    while(*p != NO_ENTRY) {
+        if(*p == id) {
+            *p = entry->next;
+            return;
+        }
+        p = &cache[*p].next;
+    }
+}
+
+/**
+ * Close entries until the used memory fits into the budget
+ * @param keep don't close this entry (can be NULL)
+ */
+static void shrink_to_mem_size(const lv_img_cache_entry_t * keep)
+{
+    if(mem_size == 0) return;
+
+    while(cache_stats.mem_used > mem_size) {
+        lv_img_cache_entry_t * weakest = get_weakest(keep, true);
+        if(weakest == NULL) break;
+        drop_entry(weakest, true);
+    }
+}
+
+/**
+ * Find an opened entry
+ * @param src the image source
+ * @param color the color of the image
+ * @param hash the hash of `src` and `color`
+ * @return pointer to the entry or NULL if the image is not cached
+ */
+static lv_img_cache_entry_t * find_entry(const void * src, lv_color_t color, uint32_t hash)
+{
+    lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+
+    /*Look up only the entries with the same hash index*/
+    uint16_t i = buckets[hash & (bucket_cnt - 1)];
+    while(i != NO_ENTRY) {
+        if(cache[i].hash == hash && color.full == cache[i].dec_dsc.color.full &&
+           lv_img_cache_match(src, cache[i].dec_dsc.src)) {
+            return &cache[i];
+        }
+        i = cache[i].next;
+    }
+
+    return NULL;
+}
+
+/**
+ * Find an entry to reuse. Select an empty entry or close the entry with the least life
+ * @return pointer to an empty entry or NULL if the cache has no entries
+ */
+static lv_img_cache_entry_t * reserve_entry(void)
+{
+    lv_img_cache_entry_t * entry = get_weakest(NULL, false);
+    if(entry == NULL) return NULL;
+
+    /*Close the decoder to reuse if it was opened (has a valid source)*/
+    if(entry->dec_dsc.src) {
+        drop_entry(entry, true);
+        LV_LOG_INFO("image cache: close and reuse an entry");
+    }
+    else {
+        LV_LOG_INFO("image cache: use an empty entry");
+    }
+
+    return entry;
+}
+
+/**
+ * Register a reserved entry whose image is opened in `dec_dsc`
+ * @param entry pointer to the entry
+ * @param hash the hash of the image's source and color
+ */
+static void add_entry(lv_img_cache_entry_t * entry, uint32_t hash)
+{
+    entry->hash = hash;
+    entry->size = get_size(&entry->dec_dsc);
+    cache_stats.mem_used += entry->size;
+    cache_stats.entry_used++;
+    link_entry(entry);
+    set_life(entry);
+
+    /*Keep the new image even if it alone exceeds the budget because it's required for drawing now*/
+    shrink_to_mem_size(entry);
+}
+
+/**
+ * Close all entries of a source
+ * @param src an image source or NULL to close all entries
+ */
+static void drop_entries(const void * src)
+{
+    lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+
+    /*All colors of the source needs to be closed so scan all the entries*/
+    uint16_t i;
+    for(i = 0; i < entry_cnt; i++) {
+        if(cache[i].dec_dsc.src == NULL) continue;
+        if(src == NULL || lv_img_cache_match(src, cache[i].dec_dsc.src)) {
+            drop_entry(&cache[i], false);
+        }
+    }
+}
+
+/**
+ * Find the preloading of an image
+ * @param src the image source
+ * @param color the color of the image
+ * @param hash the hash of `src` and `color`
+ * @return pointer to the preloaded image or NULL if it's not being preloaded
+ */
+static lv_img_preload_t * find_job(const void * src, lv_color_t color, uint32_t hash)
+{
+    if(preload_task == NULL) return NULL;
+
+    lv_img_preload_t * job;
+    _LV_LL_READ(LV_GC_ROOT(_lv_img_preload_ll), job) {
+        if(job->hash == hash && job->color.full == color.full && lv_img_cache_match(src, job->src)) return job;
+    }
+
+    return NULL;
+}
+
+/**
+ * Decode the preloaded images in the order of `lv_img_cache_preload()` calls
+ * until `LV_IMG_CACHE_PRELOAD_TIME` is spent
+ * @param task pointer to the preload task
+ */
+static void preload_task_cb(lv_task_t * task)
+{
+    LV_UNUSED(task);
+
+    uint32_t t_start = lv_tick_get();
+    lv_img_preload_t * job = _lv_ll_get_head(&LV_GC_ROOT(_lv_img_preload_ll));
+    while(job) {
+        if(preload_step(job, t_start) == false) break;
+
+        /*The task is deleted with the last image*/
+        preload_finish(job);
+        if(preload_task == NULL) break;
+
+        if(lv_tick_elaps(t_start) >= LV_IMG_CACHE_PRELOAD_TIME) break;
+        job = _lv_ll_get_head(&LV_GC_ROOT(_lv_img_preload_ll));
+    }
+}
+
+/**
+ * Open a preloaded image or decode its next lines until the time budget is spent
+ * @param job pointer to a preloaded image
+ * @param t_start the tick when the preload task started to run
+ * @return true: the image is ready (or failed to open); false: there are lines left to decode
+ */
+static bool preload_step(lv_img_preload_t * job, uint32_t t_start)
+{
+    lv_img_decoder_dsc_t * dsc = &job->dec_dsc;
+    uint32_t t_step = lv_tick_get();
+
+    if(job->y < 0) {
+        if(lv_img_decoder_open(dsc, job->src, job->color) != LV_RES_OK) {
+            LV_LOG_WARN("image preload: can't open the image");
+            _lv_memset_00(dsc, sizeof(lv_img_decoder_dsc_t));
+            return true;
+        }
+
+        job->y = 0;
+        job->time = lv_tick_elaps(t_step);
+        t_step = lv_tick_get();
+
+        /*The image is available as a whole or it can't be converted to a plain format*/
+        lv_img_cf_t cf = dsc->header.cf;
+        if(dsc->img_data || dsc->decoder->read_line_cb == NULL || cf == LV_IMG_CF_RAW || cf == LV_IMG_CF_RAW_ALPHA ||
+           cf == LV_IMG_CF_RAW_CHROMA_KEYED) {
+            return true;
+        }
+
+        /*Decode the same pixels which would be drawn after reading them line-by-line*/
+        if(lv_img_cf_has_alpha(cf)) job->buf_cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+        else if(lv_img_cf_is_chroma_keyed(cf)) job->buf_cf = LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED;
+        else job->buf_cf = LV_IMG_CF_TRUE_COLOR;
+
+        /*Keep decoding it line-by-line if it wouldn't fit into the cache anyway*/
+        uint32_t size = lv_img_buf_get_img_size(dsc->header.w, dsc->header.h, job->buf_cf);
+        if(mem_size && size > mem_size) return true;
+
+        job->buf = lv_mem_alloc(size);
+        if(job->buf == NULL) {
+            LV_LOG_WARN("image preload: no memory to decode the image, it will be decoded line-by-line");
+            return true;
+        }
+
+        if(lv_tick_elaps(t_start) >= LV_IMG_CACHE_PRELOAD_TIME) return false;
+    }
+
+    lv_coord_t w = dsc->header.w;
+    uint32_t px_size = job->buf_cf == LV_IMG_CF_TRUE_COLOR_ALPHA ? LV_IMG_PX_SIZE_ALPHA_BYTE : sizeof(lv_color_t);
+    bool key_alpha = job->buf_cf == LV_IMG_CF_TRUE_COLOR_ALPHA && lv_img_cf_is_chroma_keyed(dsc->header.cf);
+    lv_color_t chroma_key = LV_COLOR_TRANSP;
+
+    while(job->y < dsc->header.h) {
+        uint8_t * line = job->buf + (uint32_t)job->y * w * px_size;
+        if(lv_img_decoder_read_line(dsc, 0, job->y, w, line) != LV_RES_OK) {
+            LV_LOG_WARN("image preload: can't read the image, it will be decoded line-by-line");
+            lv_mem_free(job->buf);
+            job->buf = NULL;
+            return true;
+        }
+
+        /*The alpha of the chroma keyed pixels will be used instead of chroma keying*/
+        if(key_alpha) {
+            lv_coord_t x;
+            for(x = 0; x < w; x++) {
+                uint8_t * px = &line[x * LV_IMG_PX_SIZE_ALPHA_BYTE];
+                lv_color_t c;
+                _lv_memcpy_small(&c, px, sizeof(lv_color_t));
+                if(c.full == chroma_key.full) px[LV_IMG_PX_SIZE_ALPHA_BYTE - 1] = LV_OPA_TRANSP;
+            }
+        }
+
+        job->y++;
+        if(lv_tick_elaps(t_start) >= LV_IMG_CACHE_PRELOAD_TIME) break;
+    }
+
+    job->time += lv_tick_elaps(t_step);
+
+    return job->y >= dsc->header.h;
+}
+
+/**
+ * Add a preloaded image to the cache and remove it from the preloaded images
+ * @param job pointer to a preloaded image which is ready
+ */
+static void preload_finish(lv_img_preload_t * job)
+{
+    lv_img_decoder_dsc_t * dsc = &job->dec_dsc;
+
+    /*The image couldn't be opened*/
+    if(dsc->decoder == NULL) {
+        preload_remove(job);
+        return;
+    }
+
+    /*Close the decoder and keep only the decoded image*/
+    if(job->buf) {
+        if(dsc->decoder->close_cb) dsc->decoder->close_cb(dsc->decoder, dsc);
+        preloaded_decoder.close_cb = preloaded_close;
+        dsc->decoder = &preloaded_decoder;
+        dsc->user_data = NULL;
+        dsc->img_data = job->buf;
+        dsc->header.cf = job->buf_cf;
+        job->buf = NULL;
+    }
+
+    if(dsc->time_to_open < job->time) dsc->time_to_open = job->time;
+    if(dsc->time_to_open == 0) dsc->time_to_open = 1;
+
+    /*The image might be drawn (and cached) meanwhile*/
+    lv_img_cache_entry_t * entry = NULL;
+    if(entry_cnt != 0 && find_entry(job->src, job->color, job->hash) == NULL) entry = reserve_entry();
+
+    if(entry == NULL) {
+        lv_img_decoder_close(dsc);
+    }
+    else {
+        entry->dec_dsc = *dsc;
+        add_entry(entry, job->hash);
+        cache_stats.preload_cnt++;
+    }
+
+    preload_remove(job);
+}
+
+/**
+ * Stop preloading an image
+ * @param job pointer to a preloaded image
+ */
+static void preload_cancel(lv_img_preload_t * job)
+{
+    if(job->dec_dsc.decoder) {
+        if(job->buf) lv_mem_free(job->buf);
+        job->buf = NULL;
+        lv_img_decoder_close(&job->dec_dsc);
+    }
+
+    preload_remove(job);
+}
+
+/**
+ * Remove a preloaded image from the list, notify about it and delete the task if there are no more images
+ * @param job pointer to a preloaded image. Its decoder should be already closed or handed over to the cache.
+ */
+static void preload_remove(lv_img_preload_t * job)
+{
+    const void * src = job->src;
+    bool file = src && lv_img_src_get_type(src) == LV_IMG_SRC_FILE;
+    _lv_ll_remove(&LV_GC_ROOT(_lv_img_preload_ll), job);
+    lv_mem_free(job);
+
+    if(src && preload_cb) preload_cb(src);
+    if(file) lv_mem_free(src);
+
+    if(_lv_ll_get_head(&LV_GC_ROOT(_lv_img_preload_ll)) == NULL && preload_task) {
+        lv_task_del(preload_task);
+        preload_task = NULL;
+    }
+}
+
+/**
+ * Close an image decoded by the preload task
+ * @param decoder pointer to the decoder
+ * @param dsc pointer to the decoder descriptor
+ */
+static void preloaded_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(decoder);
+    lv_mem_free(dsc->img_data);
+    dsc->img_data = NULL;
+}
+#endif
+
+#if LV_IMG_CACHE_DEF_SIZE && LV_USE_IMG_TRANSFORM
+/**
+ * Hash the parameters of a transformation with FNV-1a
+ * @param angle angle of the rotation
+ * @param zoom zoom factor
+ * @param pivot pivot of the rotation
+ * @param antialias true: anti-aliased
+ * @return the hash
+ */
+static uint32_t get_variant_key(int16_t angle, uint16_t zoom, const lv_point_t * pivot, bool antialias)
+{
+    uint32_t h = 2166136261u;
+    h = (h ^ (uint16_t)angle) * 16777619u;
+    h = (h ^ zoom) * 16777619u;
+    h = (h ^ (uint16_t)pivot->x) * 16777619u;
+    h = (h ^ (uint16_t)pivot->y) * 16777619u;
+    h = (h ^ (antialias ? 1 : 0)) * 16777619u;
+    return h;
+}
+
+/**
+ * Transform a cached image and add the result to the image's copies
+ * @param entry pointer to an opened entry whose `img_data` is available
+ * @param angle angle of the rotation
+ * @param zoom zoom factor
+ * @param pivot pivot of the rotation
+ * @param antialias true: transform with anti-aliasing
+ * @param key hash of the transformation
+ * @return the new copy or NULL if it doesn't fit into the budget or there is no memory
+ */
+static lv_img_cache_variant_t * create_variant(lv_img_cache_entry_t * entry, int16_t angle, uint16_t zoom,
+                                               const lv_point_t * pivot, bool antialias, uint32_t key)
+{
+    lv_coord_t w = entry->dec_dsc.header.w;
+    lv_coord_t h = entry->dec_dsc.header.h;
+    lv_area_t area;
+    _lv_img_buf_get_transformed_area(&area, w, h, angle, zoom, pivot);
+
+    lv_coord_t area_w = lv_area_get_width(&area);
+    uint32_t size = sizeof(lv_img_cache_variant_t) + lv_area_get_size(&area) * LV_IMG_PX_SIZE_ALPHA_BYTE;
+    if(size > variant_mem_size) return NULL;
+
+    while(cache_stats.variant_mem_used + size > variant_mem_size) {
+        if(drop_oldest_variant() == false) break;
+    }
+
+    lv_img_cache_variant_t * v = lv_mem_alloc(size);
+    if(v == NULL) {
+        LV_LOG_WARN("image cache: no memory for a transformed image");
+        return NULL;
+    }
+
+    lv_color_t * cbuf = _lv_mem_buf_get(area_w * sizeof(lv_color_t));
+    lv_opa_t * abuf = _lv_mem_buf_get(area_w);
+    if(cbuf == NULL || abuf == NULL) {
+        if(cbuf) _lv_mem_buf_release(cbuf);
+        if(abuf) _lv_mem_buf_release(abuf);
+        lv_mem_free(v);
+        return NULL;
+    }
+
+    /*Transform just like `lv_draw_map` would do*/
+    lv_img_cf_t cf = entry->dec_dsc.header.cf;
+    lv_img_transform_dsc_t trans_dsc;
+    _lv_memset_00(&trans_dsc, sizeof(lv_img_transform_dsc_t));
+    trans_dsc.cfg.angle = angle;
+    trans_dsc.cfg.zoom = zoom;
+    trans_dsc.cfg.src = entry->dec_dsc.img_data;
+    trans_dsc.cfg.src_w = w;
+    trans_dsc.cfg.src_h = h;
+    trans_dsc.cfg.cf = cf;
+    trans_dsc.cfg.pivot_x = pivot->x;
+    trans_dsc.cfg.pivot_y = pivot->y;
+    trans_dsc.cfg.color = entry->dec_dsc.color;
+    trans_dsc.cfg.antialias = antialias;
+    _lv_img_buf_transform_init(&trans_dsc);
+
+    uint8_t * px = (uint8_t *)v + sizeof(lv_img_cache_variant_t);
+    v->data = px;
+    lv_coord_t x;
+    lv_coord_t y;
+    for(y = area.y1; y <= area.y2; y++) {
+        _lv_img_buf_transform_line(&trans_dsc, area.x1, y, area_w, cbuf, abuf);
+        for(x = 0; x < area_w; x++) {
+            if(abuf[x]) _lv_memcpy_small(px, &cbuf[x], LV_IMG_PX_SIZE_ALPHA_BYTE - 1);
+            else _lv_memset_00(px, LV_IMG_PX_SIZE_ALPHA_BYTE - 1);
+            px[LV_IMG_PX_SIZE_ALPHA_BYTE - 1] = abuf[x];
+            px += LV_IMG_PX_SIZE_ALPHA_BYTE;
+        }
+    }
+
+    _lv_mem_buf_release(cbuf);
+    _lv_mem_buf_release(abuf);
+
+    lv_area_copy(&v->area, &area);
+    v->size = size;
+    v->key = key;
+    v->angle = angle;
+    v->zoom = zoom;
+    v->pivot = *pivot;
+    v->antialias = antialias ? 1 : 0;
+    v->last_used = ++variant_clock;
+
+    v->next = entry->variants;
+    entry->variants = v;
+    cache_stats.variant_mem_used += size;
+
+    return v;
+}
+
+/**
+ * Free all the transformed copies of an image
+ * @param entry pointer to an entry
+ */
+static void free_variants(lv_img_cache_entry_t * entry)
+{
+    lv_img_cache_variant_t * v = entry->variants;
+    while(v) {
+        lv_img_cache_variant_t * next = v->next;
+        cache_stats.variant_mem_used -= v->size;
+        lv_mem_free(v);
+        v = next;
+    }
+    entry->variants = NULL;
+    entry->variant_miss_cnt = 0;
+}
+
+/**
+ * Free the least recently used transformed copy of all images
+ * @return true: a copy was freed; false: there are no copies
+ */
+static bool drop_oldest_variant(void)
+{
+    lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+    lv_img_cache_variant_t ** oldest = NULL;
+    uint16_t i;
+    for(i = 0; i < entry_cnt; i++) {
+        lv_img_cache_variant_t ** p = &cache[i].variants;
+        while(*p) {
+            /*Compare the ages to handle the overflow of the clock*/
+            if(oldest == NULL || variant_clock - (*p)->last_used > variant_clock - (*oldest)->last_used) oldest = p;
+            p = &(*p)->next;
+        }
+    }
+
+    if(oldest == NULL) return false;
+
+    lv_img_cache_variant_t * v = *oldest;
+    *oldest = v->next;
+    cache_stats.variant_mem_used -= v->size;
+    lv_mem_free(v);
+    return true;
+}
 #endif
@@ -23,6 +23,22 @@ extern "C" {
  *      TYPEDEFS
  **********************/
 
+/**
+ * A rotated/zoomed copy of a cached image
+ */
+typedef struct _lv_img_cache_variant_t {
+    struct _lv_img_cache_variant_t * next;  /**< The next copy of the same image*/
+    const uint8_t * data;   /**< `LV_IMG_CF_TRUE_COLOR_ALPHA` pixels of the copy with the size of `area`*/
+    lv_area_t area;         /**< The area of the transformed image relative to the not transformed image*/
+    uint32_t size;          /**< Memory used by the copy in bytes*/
+    uint32_t last_used;     /**< The value of the copies' clock when this copy was last used*/
+    uint32_t key;           /**< Hash of the transformation (used internally)*/
+    lv_point_t pivot;
+    int16_t angle;
+    uint16_t zoom;
+    uint8_t antialias;
+} lv_img_cache_variant_t;
+
 /**
  * When loading images from the network it can take a long time to download and decode the image.
  *
@@ -31,12 +47,45 @@ extern "C" {
 typedef struct {
     lv_img_decoder_dsc_t dec_dsc; /**< Image information */
 
-    /** Count the cache entries's life. Add `time_to_open` to `life` when the entry is used.
-     * Decrement all lifes by one every in every ::lv_img_cache_open.
-     * If life == 0 the entry can be reused */
+    /** How much worth is to keep the entry. Set to the cache's clock + the entry's gain when the entry is used.
+     * The gain is `time_to_open` per kilobyte of `size`. The clock is raised to the life of the closed entries.
+     * The entry with the smallest life is closed first */
     int32_t life;
+
+    uint32_t size;      /**< Memory used by the opened image in bytes (estimated)*/
+    uint32_t hash;      /**< Hash of the source and color (used internally)*/
+    uint16_t next;      /**< Index of the next entry with the same hash index (used internally)*/
+
+#if LV_USE_IMG_TRANSFORM
+    lv_img_cache_variant_t * variants;  /**< Transformed copies of the image, the newest first (used internally)*/
+    uint8_t variant_miss_cnt;           /**< Copies created since an older copy was used (used internally)*/
+#endif
 } lv_img_cache_entry_t;
 
+/**
+ * Statistics of the image cache
+ */
+typedef struct {
+    uint32_t hit_cnt;       /**< Number of times an image was found in the cache*/
+    uint32_t miss_cnt;      /**< Number of times an image had to be opened*/
+    uint32_t evict_cnt;     /**< Number of images closed to make room for other images*/
+    uint32_t mem_used;      /**< Memory used by the opened images in bytes*/
+    uint32_t mem_size;      /**< Memory budget in bytes. 0: no limit*/
+    uint16_t entry_used;    /**< Number of opened images*/
+    uint16_t entry_cnt;     /**< Maximal number of cached images*/
+    uint32_t variant_hit_cnt;   /**< Number of times a transformed copy of an image was found*/
+    uint32_t variant_miss_cnt;  /**< Number of times a transformed copy was not found*/
+    uint32_t variant_mem_used;  /**< Memory used by the transformed copies in bytes*/
+    uint32_t variant_mem_size;  /**< Memory budget of the transformed copies in bytes. 0: disabled*/
+    uint32_t preload_cnt;       /**< Number of images added to the cache by `lv_img_cache_preload()`*/
+} lv_img_cache_stats_t;
+
+/**
+ * Called when the preloading of an image is finished or canceled
+ * @param src source of the image
+ */
+typedef void (*lv_img_cache_preload_cb_t)(const void * src);
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -51,6 +100,52 @@ typedef struct {
  */
 lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color);
 
+/**
+ * Open and decode an image into the cache in the background (with an `lv_task`) to avoid stalling the refresh
+ * when it's drawn first. The images read line-by-line (e.g. files) are decoded in
+ * `LV_IMG_CACHE_PRELOAD_TIME` ms long steps and kept in the cache as a whole.
+ * @param src source of the image. Path to file or pointer to an `lv_img_dsc_t` variable
+ * @param color The color of the image with `LV_IMG_CF_ALPHA_...`
+ * @return LV_RES_OK: the image is cached or being loaded; LV_RES_INV: the cache is disabled or out of memory
+ */
+lv_res_t lv_img_cache_preload(const void * src, lv_color_t color);
+
+/**
+ * Tell whether an image is being preloaded
+ * @param src source of the image. Path to file or pointer to an `lv_img_dsc_t` variable
+ * @param color The color of the image with `LV_IMG_CF_ALPHA_...`
+ * @return true: `lv_img_cache_preload()` was called for the image but it's not in the cache yet
+ */
+bool lv_img_cache_is_loading(const void * src, lv_color_t color);
+
+/**
+ * Tell whether an image is in the cache (opened) without touching its life or the statistics
+ * @param src source of the image. Path to file or pointer to an `lv_img_dsc_t` variable
+ * @param color The color of the image with `LV_IMG_CF_ALPHA_...`
+ * @return true: the image can be drawn without opening it
+ */
+bool lv_img_cache_is_cached(const void * src, lv_color_t color);
+
+/**
+ * Set a function to call when the preloading of an image is finished or canceled.
+ * Used by the image object to redraw itself.
+ * @param cb the callback function
+ */
+void _lv_img_cache_set_preload_cb(lv_img_cache_preload_cb_t cb);
+
+/**
+ * Get a rotated/zoomed copy of a cached image. Create it if it doesn't exist yet.
+ * @param entry pointer to a cache entry returned by `_lv_img_cache_open`
+ * @param angle angle of the rotation (0.1 degree resolution)
+ * @param zoom zoom factor (256: no zoom)
+ * @param pivot pivot of the rotation relative to the image
+ * @param antialias true: transform with anti-aliasing
+ * @return pointer to the transformed copy or NULL if the image should be transformed while drawing
+ *         (the cache is disabled, the image is not available as a whole, it seems animated or no memory)
+ */
+lv_img_cache_variant_t * _lv_img_cache_get_variant(lv_img_cache_entry_t * entry, int16_t angle, uint16_t zoom,
+                                                   const lv_point_t * pivot, bool antialias);
+
 /**
  * Set the number of images to be cached.
  * More cached images mean more opened image at same time which might mean more memory usage.
@@ -59,13 +154,48 @@ lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color);
  */
 void lv_img_cache_set_size(uint16_t new_slot_num);
 
+/**
+ * Set the memory budget of the image cache.
+ * The size of the decoded images kept open by the cache are added and if it exceeds the budget
+ * the images least worth keeping (cheap to open but large) are closed.
+ * @param size the budget in bytes. 0: limit only the number of cached images
+ */
+void lv_img_cache_set_mem_size(uint32_t size);
+
+/**
+ * Set the memory budget of the rotated/zoomed copies of the cached images.
+ * If the budget is exceeded the least recently used copies are freed.
+ * @param size the budget in bytes. 0: don't cache the transformed images
+ * @note the canvases free the copies of their buffer when drawn only if `LV_IMG_CACHE_VARIANT_MEM_SIZE` is not 0
+ */
+void lv_img_cache_set_variant_mem_size(uint32_t size);
+
+/**
+ * Get the statistics of the image cache
+ * @param stats store the statistics here
+ */
+void lv_img_cache_get_stats(lv_img_cache_stats_t * stats);
+
+/**
+ * Reset the hit, miss and eviction counters of the image cache
+ */
+void lv_img_cache_reset_stats(void);
+
 /**
  * Invalidate an image source in the cache.
  * Useful if the image source is updated therefore it needs to be cached again.
+ * The preloading of the image is canceled too.
  * @param src an image source path to a file or pointer to an `lv_img_dsc_t` variable.
  */
 void lv_img_cache_invalidate_src(const void * src);
 
+/**
+ * Free the rotated/zoomed copies of an image source but keep the image itself in the cache.
+ * Useful if the pixels of the image are modified in place (e.g. a canvas).
+ * @param src an image source path to a file or pointer to an `lv_img_dsc_t` variable.
+ */
+void lv_img_cache_invalidate_variants(const void * src);
+
 /**********************
  *      MACROS
  **********************/
@@ -24,20 +24,51 @@
 typedef struct {
 #if LV_USE_FILESYSTEM
     lv_fs_file_t f;
+    uint8_t * ra_buf;   /*Read ahead buffer*/
+    uint32_t ra_pos;    /*Position of the first byte of `ra_buf` in the file*/
+    uint32_t ra_len;    /*Number of valid bytes in `ra_buf`*/
+    uint32_t f_pos;     /*Position of the file to skip seeking when reading sequentially*/
+#endif
+    uint32_t * palette; /*The colors and opacities of the palette as decoded pixels*/
+#if LV_IMG_CF_COMPRESSED
+    uint8_t * block_buf;    /*The last decompressed block of a compressed image*/
+    uint8_t * img_buf;      /*The whole decompressed image if it was decompressed when opened*/
+    uint32_t * block_ofs;   /*Offsets of the blocks read from a compressed file*/
+    uint32_t blocks_pos;    /*Position of the first block in the image data or file*/
+    int32_t block_id;       /*Index of the block in `block_buf`. -1: none*/
+    uint16_t block_h;       /*Number of lines in a block*/
+    uint8_t compr;          /*`LV_IMG_CF_RLE` or `LV_IMG_CF_LZ4`. 0: not compressed*/
 #endif
-    lv_color_t * palette;
-    lv_opa_t * opa;
 } lv_img_decoder_built_in_data_t;
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
-static lv_res_t lv_img_decoder_built_in_line_true_color(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
-                                                        lv_coord_t len, uint8_t * buf);
-static lv_res_t lv_img_decoder_built_in_line_alpha(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
-                                                   lv_coord_t len, uint8_t * buf);
-static lv_res_t lv_img_decoder_built_in_line_indexed(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
-                                                     lv_coord_t len, uint8_t * buf);
+#if LV_USE_FILESYSTEM
+static lv_res_t fs_seek(lv_img_decoder_built_in_data_t * user_data, uint32_t pos);
+static lv_res_t fs_read_at(lv_img_decoder_built_in_data_t * user_data, uint32_t pos, uint8_t * buf, uint32_t btr);
+#endif
+static lv_res_t lv_img_decoder_built_in_area_true_color(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
+                                                        lv_coord_t len, lv_coord_t line_cnt, uint8_t * buf);
+static lv_res_t lv_img_decoder_built_in_area_alpha(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
+                                                   lv_coord_t len, lv_coord_t line_cnt, uint8_t * buf);
+static lv_res_t lv_img_decoder_built_in_area_indexed(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
+                                                     lv_coord_t len, lv_coord_t line_cnt, uint8_t * buf);
+static lv_res_t lv_img_decoder_built_in_area_compr(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
+                                                   lv_coord_t len, lv_coord_t line_cnt, uint8_t * buf);
+static lv_img_decoder_built_in_data_t * get_user_data(lv_img_decoder_dsc_t * dsc);
+static bool is_compressed(const lv_img_decoder_dsc_t * dsc);
+static const uint8_t * compr_get_data(lv_img_decoder_dsc_t * dsc, uint32_t ofs);
+#if LV_IMG_CF_COMPRESSED
+static lv_res_t compr_open(lv_img_decoder_dsc_t * dsc);
+static lv_res_t compr_decode_block(lv_img_decoder_dsc_t * dsc, uint32_t block_id, uint8_t * buf);
+static lv_res_t rle_decode(const uint8_t * in, uint32_t in_size, uint8_t * out, uint32_t out_size, uint8_t px_bytes);
+static lv_res_t lz4_decode(const uint8_t * in, uint32_t in_size, uint8_t * out, uint32_t out_size);
+#endif
+static uint32_t make_px(lv_color_t color, lv_opa_t opa);
+static inline void px_copy(uint8_t * dst, uint32_t px);
+static void expand_px(const uint8_t * src, uint8_t bpp, int8_t pos, lv_coord_t len, const uint32_t * table,
+                      uint8_t * dst);
 
 /**********************
  *  STATIC VARIABLES
@@ -71,6 +102,7 @@ void _lv_img_decoder_init(void)
     lv_img_decoder_set_info_cb(decoder, lv_img_decoder_built_in_info);
     lv_img_decoder_set_open_cb(decoder, lv_img_decoder_built_in_open);
     lv_img_decoder_set_read_line_cb(decoder, lv_img_decoder_built_in_read_line);
+    lv_img_decoder_set_read_area_cb(decoder, lv_img_decoder_built_in_read_area);
     lv_img_decoder_set_close_cb(decoder, lv_img_decoder_built_in_close);
 }
 
@@ -178,6 +210,38 @@ lv_res_t lv_img_decoder_read_line(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_c
     return res;
 }
 
+/**
+ * Read a strip of lines from an opened image.
+ * The lines are stored after each other in `buf`.
+ * A pixel takes `LV_IMG_PX_SIZE_ALPHA_BYTE` bytes if the color format has alpha, else `sizeof(lv_color_t)`
+ * @param dsc pointer to `lv_img_decoder_dsc_t` used in `lv_img_decoder_open`
+ * @param x start X coordinate (from left)
+ * @param y start Y coordinate (from top) of the first line
+ * @param len number of pixels to read in each line
+ * @param line_cnt number of lines to read
+ * @param buf store the data here
+ * @return LV_RES_OK: success; LV_RES_INV: an error occurred
+ */
+lv_res_t lv_img_decoder_read_area(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y, lv_coord_t len,
+                                  lv_coord_t line_cnt, uint8_t * buf)
+{
+    if(dsc->decoder->read_area_cb) return dsc->decoder->read_area_cb(dsc->decoder, dsc, x, y, len, line_cnt, buf);
+
+    /*Fall back to reading line-by-line*/
+    if(dsc->decoder->read_line_cb == NULL) return LV_RES_INV;
+
+    uint32_t px_bytes = lv_img_cf_has_alpha(dsc->header.cf) ? LV_IMG_PX_SIZE_ALPHA_BYTE : sizeof(lv_color_t);
+    uint32_t line_bytes = len * px_bytes;
+    lv_coord_t l;
+    for(l = 0; l < line_cnt; l++) {
+        lv_res_t res = dsc->decoder->read_line_cb(dsc->decoder, dsc, x, y + l, len, buf);
+        if(res != LV_RES_OK) return res;
+        buf += line_bytes;
+    }
+
+    return LV_RES_OK;
+}
+
 /**
  * Close a decoding session
  * @param dsc pointer to `lv_img_decoder_dsc_t` used in `lv_img_decoder_open`
@@ -250,6 +314,16 @@ void lv_img_decoder_set_read_line_cb(lv_img_decoder_t * decoder, lv_img_decoder_
     decoder->read_line_cb = read_line_cb;
 }
 
+/**
+ * Set a callback to decode more lines of an image at once
+ * @param decoder pointer to an image decoder
+ * @param read_area_cb a function to read a strip of lines of an image
+ */
+void lv_img_decoder_set_read_area_cb(lv_img_decoder_t * decoder, lv_img_decoder_read_area_f_t read_area_cb)
+{
+    decoder->read_area_cb = read_area_cb;
+}
+
 /**
  * Set a callback to close a decoding session. E.g. close files and free other resources.
  * @param decoder pointer to an image decoder
@@ -260,6 +334,25 @@ void lv_img_decoder_set_close_cb(lv_img_decoder_t * decoder, lv_img_decoder_clos
     decoder->close_cb = close_cb;
 }
 
+/**
+ * Estimate the time of decoding pixels from the statistics of a decoder.
+ * Opening small images takes less than a tick so measuring them one-by-one gives 0 or 1 ms.
+ * The average speed of all the decoded pixels is more accurate.
+ * Decoders can use it to set `time_to_open` for the image cache.
+ * @param stats statistics of the decoder
+ * @param px_cnt number of pixels to decode
+ * @return the estimated time in milliseconds, at least 1
+ */
+uint32_t lv_img_decoder_estimate_time(const lv_img_decoder_stats_t * stats, uint32_t px_cnt)
+{
+    if(stats->px_cnt == 0) return 1;
+
+    /*Round up to not say 0 ms for the time consuming but small images*/
+    uint64_t t = ((uint64_t)px_cnt * stats->time + stats->px_cnt - 1) / stats->px_cnt;
+    if(t == 0) return 1;
+    return t > UINT32_MAX ? UINT32_MAX : (uint32_t)t;
+}
+
 /**
  * Get info about a built-in image
  * @param decoder the decoder where this function belongs
@@ -274,11 +367,22 @@ lv_res_t lv_img_decoder_built_in_info(lv_img_decoder_t * decoder, const void * s
     lv_img_src_t src_type = lv_img_src_get_type(src);
     if(src_type == LV_IMG_SRC_VARIABLE) {
         lv_img_cf_t cf = ((lv_img_dsc_t *)src)->header.cf;
+#if LV_IMG_CF_COMPRESSED
+        /*Tell the color format of the decompressed image*/
+        if(cf == LV_IMG_CF_RLE || cf == LV_IMG_CF_LZ4) {
+            const lv_img_dsc_t * img_dsc = src;
+            if(img_dsc->data == NULL || img_dsc->data_size < sizeof(lv_img_compr_header_t)) return LV_RES_INV;
+
+            lv_img_compr_header_t compr_header;
+            _lv_memcpy_small(&compr_header, img_dsc->data, sizeof(lv_img_compr_header_t));
+            cf = compr_header.cf;
+        }
+#endif
         if(cf < CF_BUILT_IN_FIRST || cf > CF_BUILT_IN_LAST) return LV_RES_INV;
 
         header->w  = ((lv_img_dsc_t *)src)->header.w;
         header->h  = ((lv_img_dsc_t *)src)->header.h;
-        header->cf = ((lv_img_dsc_t *)src)->header.cf;
+        header->cf = cf;
     }
 #if LV_USE_FILESYSTEM
     else if(src_type == LV_IMG_SRC_FILE) {
@@ -291,8 +395,18 @@ lv_res_t lv_img_decoder_built_in_info(lv_img_decoder_t * decoder, const void * s
         res = lv_fs_open(&file, src, LV_FS_MODE_RD);
         if(res == LV_FS_RES_OK) {
             res = lv_fs_read(&file, header, sizeof(lv_img_header_t), &rn);
+            bool read_ok = res == LV_FS_RES_OK && rn == sizeof(lv_img_header_t);
+#if LV_IMG_CF_COMPRESSED
+            /*Tell the color format of the decompressed image*/
+            if(read_ok && (header->cf == LV_IMG_CF_RLE || header->cf == LV_IMG_CF_LZ4)) {
+                lv_img_compr_header_t compr_header;
+                res = lv_fs_read(&file, &compr_header, sizeof(lv_img_compr_header_t), &rn);
+                read_ok = res == LV_FS_RES_OK && rn == sizeof(lv_img_compr_header_t);
+                if(read_ok) header->cf = compr_header.cf;
+            }
+#endif
             lv_fs_close(&file);
-            if(res != LV_FS_RES_OK || rn != sizeof(lv_img_header_t)) {
+            if(read_ok == false) {
                 LV_LOG_WARN("Image get info get read file header");
                 return LV_RES_INV;
             }
@@ -339,19 +453,22 @@ lv_res_t lv_img_decoder_built_in_open(lv_img_decoder_t * decoder, lv_img_decoder
         }
 
         /*If the file was open successfully save the file descriptor*/
-        if(dsc->user_data == NULL) {
-            dsc->user_data = lv_mem_alloc(sizeof(lv_img_decoder_built_in_data_t));
-            LV_ASSERT_MEM(dsc->user_data);
-            if(dsc->user_data == NULL) {
-                LV_LOG_ERROR("img_decoder_built_in_open: out of memory");
-                lv_fs_close(&f);
-                return LV_RES_INV;
-            }
-            _lv_memset_00(dsc->user_data, sizeof(lv_img_decoder_built_in_data_t));
+        lv_img_decoder_built_in_data_t * user_data = get_user_data(dsc);
+        if(user_data == NULL) {
+            lv_fs_close(&f);
+            return LV_RES_INV;
         }
 
-        lv_img_decoder_built_in_data_t * user_data = dsc->user_data;
         _lv_memcpy_small(&user_data->f, &f, sizeof(f));
+        user_data->f_pos = 0;
+
+#if LV_IMG_DECODER_STRIP_SIZE
+        /*Without read ahead buffer the file is read directly*/
+        user_data->ra_buf = lv_mem_alloc(LV_IMG_DECODER_STRIP_SIZE);
+        if(user_data->ra_buf == NULL) {
+            LV_LOG_INFO("Built-in image decoder: no memory for the read ahead buffer");
+        }
+#endif
 #else
         LV_LOG_WARN("Image built-in decoder cannot read file because LV_USE_FILESYSTEM = 0");
         return LV_RES_INV;
@@ -364,10 +481,21 @@ lv_res_t lv_img_decoder_built_in_open(lv_img_decoder_t * decoder, lv_img_decoder
         }
     }
 
+#if LV_IMG_CF_COMPRESSED
+    if(compr_open(dsc) != LV_RES_OK) {
+        lv_img_decoder_built_in_close(decoder, dsc);
+        return LV_RES_INV;
+    }
+#endif
+
     lv_img_cf_t cf = dsc->header.cf;
     /*Process true color formats*/
     if(cf == LV_IMG_CF_TRUE_COLOR || cf == LV_IMG_CF_TRUE_COLOR_ALPHA || cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED) {
-        if(dsc->src_type == LV_IMG_SRC_VARIABLE) {
+        if(is_compressed(dsc)) {
+            /*Already decompressed as a whole or it will be decompressed block-by-block while reading*/
+            return LV_RES_OK;
+        }
+        else if(dsc->src_type == LV_IMG_SRC_VARIABLE) {
             /* In case of uncompressed formats the image stored in the ROM/RAM.
              * So simply give its pointer*/
             dsc->img_data = ((lv_img_dsc_t *)dsc->src)->data;
@@ -386,22 +514,19 @@ lv_res_t lv_img_decoder_built_in_open(lv_img_decoder_t * decoder, lv_img_decoder
         uint32_t palette_size = 1 << px_size;
 
         /*Allocate the palette*/
-        if(dsc->user_data == NULL) {
-            dsc->user_data = lv_mem_alloc(sizeof(lv_img_decoder_built_in_data_t));
-            LV_ASSERT_MEM(dsc->user_data);
-            if(dsc->user_data == NULL) {
-                LV_LOG_ERROR("img_decoder_built_in_open: out of memory");
-                return LV_RES_INV;
-            }
-            _lv_memset_00(dsc->user_data, sizeof(lv_img_decoder_built_in_data_t));
-        }
+        lv_img_decoder_built_in_data_t * user_data = get_user_data(dsc);
+        if(user_data == NULL) return LV_RES_INV;
+
+        /*The palette is after the header or after the offsets of the compressed blocks*/
+        uint32_t palette_bytes = palette_size * sizeof(lv_color32_t);
+        uint32_t palette_pos = dsc->src_type == LV_IMG_SRC_FILE ? sizeof(lv_img_header_t) : 0;
+#if LV_IMG_CF_COMPRESSED
+        if(is_compressed(dsc)) palette_pos = user_data->blocks_pos - palette_bytes;
+#endif
 
-        lv_img_decoder_built_in_data_t * user_data = dsc->user_data;
-        user_data->palette                         = lv_mem_alloc(palette_size * sizeof(lv_color_t));
+        user_data->palette                         = lv_mem_alloc(palette_size * sizeof(uint32_t));
         LV_ASSERT_MEM(user_data->palette);
-        user_data->opa                             = lv_mem_alloc(palette_size * sizeof(lv_opa_t));
-        LV_ASSERT_MEM(user_data->opa);
-        if(user_data->palette == NULL || user_data->opa == NULL) {
+        if(user_data->palette == NULL) {
             LV_LOG_ERROR("img_decoder_built_in_open: out of memory");
             lv_img_decoder_built_in_close(decoder, dsc);
             return LV_RES_INV;
@@ -410,27 +535,36 @@ lv_res_t lv_img_decoder_built_in_open(lv_img_decoder_t * decoder, lv_img_decoder
         if(dsc->src_type == LV_IMG_SRC_FILE) {
             /*Read the palette from file*/
 #if LV_USE_FILESYSTEM
-            lv_fs_seek(&user_data->f, 4); /*Skip the header*/
-            lv_color32_t cur_color;
+            /*Read the palette at once*/
+            lv_color32_t * palette_p = _lv_mem_buf_get(palette_bytes);
+            lv_res_t res = palette_p ? fs_read_at(user_data, palette_pos, (uint8_t *)palette_p, palette_bytes) :
+                           LV_RES_INV;
+            if(res != LV_RES_OK) {
+                LV_LOG_WARN("Built-in image decoder can't read the palette");
+                if(palette_p) _lv_mem_buf_release(palette_p);
+                lv_img_decoder_built_in_close(decoder, dsc);
+                return LV_RES_INV;
+            }
+
             uint32_t i;
             for(i = 0; i < palette_size; i++) {
-                lv_fs_read(&user_data->f, &cur_color, sizeof(lv_color32_t), NULL);
-                user_data->palette[i] = lv_color_make(cur_color.ch.red, cur_color.ch.green, cur_color.ch.blue);
-                user_data->opa[i]     = cur_color.ch.alpha;
+                lv_color_t c = lv_color_make(palette_p[i].ch.red, palette_p[i].ch.green, palette_p[i].ch.blue);
+                user_data->palette[i] = make_px(c, palette_p[i].ch.alpha);
             }
+            _lv_mem_buf_release(palette_p);
 #else
             LV_LOG_WARN("Image built-in decoder can read the palette because LV_USE_FILESYSTEM = 0");
             return LV_RES_INV;
 #endif
         }
         else {
-            /*The palette begins in the beginning of the image data. Just point to it.*/
-            lv_color32_t * palette_p = (lv_color32_t *)((lv_img_dsc_t *)dsc->src)->data;
+            /*The palette is in the image data. Just point to it.*/
+            lv_color32_t * palette_p = (lv_color32_t *)(((lv_img_dsc_t *)dsc->src)->data + palette_pos);
 
             uint32_t i;
             for(i = 0; i < palette_size; i++) {
-                user_data->palette[i] = lv_color_make(palette_p[i].ch.red, palette_p[i].ch.green, palette_p[i].ch.blue);
-                user_data->opa[i]     = palette_p[i].ch.alpha;
+                lv_color_t c = lv_color_make(palette_p[i].ch.red, palette_p[i].ch.green, palette_p[i].ch.blue);
+                user_data->palette[i] = make_px(c, palette_p[i].ch.alpha);
             }
         }
 
@@ -475,6 +609,24 @@ lv_res_t lv_img_decoder_built_in_open(lv_img_decoder_t * decoder, lv_img_decoder
  */
 lv_res_t lv_img_decoder_built_in_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x,
                                            lv_coord_t y, lv_coord_t len, uint8_t * buf)
+{
+    return lv_img_decoder_built_in_read_area(decoder, dsc, x, y, len, 1, buf);
+}
+
+/**
+ * Decode `line_cnt` lines of `len` pixels starting from the given `x`, `y` coordinates and store them in `buf`.
+ * Files are read in blocks through a read ahead buffer.
+ * @param decoder pointer to the decoder the function associated with
+ * @param dsc pointer to decoder descriptor
+ * @param x start x coordinate
+ * @param y start y coordinate of the first line
+ * @param len number of pixels to decode in each line
+ * @param line_cnt number of lines to decode
+ * @param buf a buffer to store the decoded pixels
+ * @return LV_RES_OK: ok; LV_RES_INV: failed
+ */
+lv_res_t lv_img_decoder_built_in_read_area(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x,
+                                           lv_coord_t y, lv_coord_t len, lv_coord_t line_cnt, uint8_t * buf)
 {
     (void)decoder; /*Unused*/
 
@@ -482,19 +634,22 @@ lv_res_t lv_img_decoder_built_in_read_line(lv_img_decoder_t * decoder, lv_img_de
 
     if(dsc->header.cf == LV_IMG_CF_TRUE_COLOR || dsc->header.cf == LV_IMG_CF_TRUE_COLOR_ALPHA ||
        dsc->header.cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED) {
-        /* For TRUE_COLOR images read line required only for files.
+        /* For TRUE_COLOR images read line required only for files and compressed images.
          * For variables the image data was returned in `open`*/
-        if(dsc->src_type == LV_IMG_SRC_FILE) {
-            res = lv_img_decoder_built_in_line_true_color(dsc, x, y, len, buf);
+        if(is_compressed(dsc)) {
+            res = lv_img_decoder_built_in_area_compr(dsc, x, y, len, line_cnt, buf);
+        }
+        else if(dsc->src_type == LV_IMG_SRC_FILE) {
+            res = lv_img_decoder_built_in_area_true_color(dsc, x, y, len, line_cnt, buf);
         }
     }
     else if(dsc->header.cf == LV_IMG_CF_ALPHA_1BIT || dsc->header.cf == LV_IMG_CF_ALPHA_2BIT ||
             dsc->header.cf == LV_IMG_CF_ALPHA_4BIT || dsc->header.cf == LV_IMG_CF_ALPHA_8BIT) {
-        res = lv_img_decoder_built_in_line_alpha(dsc, x, y, len, buf);
+        res = lv_img_decoder_built_in_area_alpha(dsc, x, y, len, line_cnt, buf);
     }
     else if(dsc->header.cf == LV_IMG_CF_INDEXED_1BIT || dsc->header.cf == LV_IMG_CF_INDEXED_2BIT ||
             dsc->header.cf == LV_IMG_CF_INDEXED_4BIT || dsc->header.cf == LV_IMG_CF_INDEXED_8BIT) {
-        res = lv_img_decoder_built_in_line_indexed(dsc, x, y, len, buf);
+        res = lv_img_decoder_built_in_area_indexed(dsc, x, y, len, line_cnt, buf);
     }
     else {
         LV_LOG_WARN("Built-in image decoder read not supports the color format");
@@ -518,9 +673,14 @@ void lv_img_decoder_built_in_close(lv_img_decoder_t * decoder, lv_img_decoder_ds
 #if LV_USE_FILESYSTEM
         if(dsc->src_type == LV_IMG_SRC_FILE)
             lv_fs_close(&user_data->f);
+        if(user_data->ra_buf) lv_mem_free(user_data->ra_buf);
 #endif
         if(user_data->palette) lv_mem_free(user_data->palette);
-        if(user_data->opa) lv_mem_free(user_data->opa);
+#if LV_IMG_CF_COMPRESSED
+        if(user_data->block_buf) lv_mem_free(user_data->block_buf);
+        if(user_data->img_buf) lv_mem_free(user_data->img_buf);
+        if(user_data->block_ofs) lv_mem_free(user_data->block_ofs);
+#endif
 
         lv_mem_free(user_data);
         dsc->user_data = NULL;
@@ -531,43 +691,117 @@ void lv_img_decoder_built_in_close(lv_img_decoder_t * decoder, lv_img_decoder_ds
  *   STATIC FUNCTIONS
  **********************/
 
-static lv_res_t lv_img_decoder_built_in_line_true_color(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
-                                                        lv_coord_t len, uint8_t * buf)
-{
 #if LV_USE_FILESYSTEM
-    lv_img_decoder_built_in_data_t * user_data = dsc->user_data;
-    lv_fs_res_t res;
-    uint8_t px_size = lv_img_cf_get_px_size(dsc->header.cf);
+/**
+ * Move the position of an image file if it's not there yet
+ * @param user_data the built-in decoder's data with the opened file
+ * @param pos the new position
+ * @return LV_RES_OK: ok; LV_RES_INV: failed
+ */
+static lv_res_t fs_seek(lv_img_decoder_built_in_data_t * user_data, uint32_t pos)
+{
+    if(user_data->f_pos == pos) return LV_RES_OK;
 
-    uint32_t pos = ((y * dsc->header.w + x) * px_size) >> 3;
-    pos += 4; /*Skip the header*/
-    res = lv_fs_seek(&user_data->f, pos);
+    lv_fs_res_t res = lv_fs_seek(&user_data->f, pos);
     if(res != LV_FS_RES_OK) {
         LV_LOG_WARN("Built-in image decoder seek failed");
+        /*The position is unknown*/
+        user_data->f_pos = UINT32_MAX;
         return LV_RES_INV;
     }
-    uint32_t btr = len * (px_size >> 3);
-    uint32_t br  = 0;
+
+    user_data->f_pos = pos;
+    return LV_RES_OK;
+}
+
+/**
+ * Read bytes from an image file. Small reads are served from the read ahead buffer.
+ * @param user_data the built-in decoder's data with the opened file
+ * @param pos position of the first byte in the file
+ * @param buf store the bytes here
+ * @param btr number of bytes to read
+ * @return LV_RES_OK: ok; LV_RES_INV: failed
+ */
+static lv_res_t fs_read_at(lv_img_decoder_built_in_data_t * user_data, uint32_t pos, uint8_t * buf, uint32_t btr)
+{
+    lv_fs_res_t res;
+    uint32_t br = 0;
+
+#if LV_IMG_DECODER_STRIP_SIZE
+    /*Read ahead only if more reads fit into the buffer*/
+    if(user_data->ra_buf && btr <= LV_IMG_DECODER_STRIP_SIZE / 2) {
+        /*Read a new block if the bytes are not in the buffer*/
+        if(pos < user_data->ra_pos || pos + btr > user_data->ra_pos + user_data->ra_len) {
+            user_data->ra_len = 0;
+            if(fs_seek(user_data, pos) != LV_RES_OK) return LV_RES_INV;
+
+            /*The block might be truncated at the end of the file*/
+            res = lv_fs_read(&user_data->f, user_data->ra_buf, LV_IMG_DECODER_STRIP_SIZE, &br);
+            user_data->f_pos = res == LV_FS_RES_OK ? user_data->f_pos + br : UINT32_MAX;
+            if(res != LV_FS_RES_OK || br < btr) {
+                LV_LOG_WARN("Built-in image decoder read failed");
+                return LV_RES_INV;
+            }
+            user_data->ra_pos = pos;
+            user_data->ra_len = br;
+        }
+
+        _lv_memcpy(buf, &user_data->ra_buf[pos - user_data->ra_pos], btr);
+        return LV_RES_OK;
+    }
+#endif
+
+    /*Read large blocks directly*/
+    if(fs_seek(user_data, pos) != LV_RES_OK) return LV_RES_INV;
+
     res = lv_fs_read(&user_data->f, buf, btr, &br);
+    user_data->f_pos = res == LV_FS_RES_OK ? user_data->f_pos + br : UINT32_MAX;
     if(res != LV_FS_RES_OK || btr != br) {
         LV_LOG_WARN("Built-in image decoder read failed");
         return LV_RES_INV;
     }
 
+    return LV_RES_OK;
+}
+#endif
+
+static lv_res_t lv_img_decoder_built_in_area_true_color(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
+                                                        lv_coord_t len, lv_coord_t line_cnt, uint8_t * buf)
+{
+#if LV_USE_FILESYSTEM
+    lv_img_decoder_built_in_data_t * user_data = dsc->user_data;
+    uint32_t px_bytes = lv_img_cf_get_px_size(dsc->header.cf) >> 3;
+    uint32_t line_bytes = (uint32_t)dsc->header.w * px_bytes;
+
+    uint32_t pos = ((uint32_t)y * dsc->header.w + x) * px_bytes;
+    pos += 4; /*Skip the header*/
+    uint32_t btr = len * px_bytes;
+
+    /*Full width lines are after each other in the file so read them at once*/
+    if(len == dsc->header.w) return fs_read_at(user_data, pos, buf, btr * line_cnt);
+
+    lv_coord_t l;
+    for(l = 0; l < line_cnt; l++) {
+        if(fs_read_at(user_data, pos, buf, btr) != LV_RES_OK) return LV_RES_INV;
+        pos += line_bytes;
+        buf += btr;
+    }
+
     return LV_RES_OK;
 #else
     LV_UNUSED(dsc);
     LV_UNUSED(x);
     LV_UNUSED(y);
     LV_UNUSED(len);
+    LV_UNUSED(line_cnt);
     LV_UNUSED(buf);
     LV_LOG_WARN("Image built-in decoder cannot read file because LV_USE_FILESYSTEM = 0");
     return LV_RES_INV;
 #endif
 }
 
-static lv_res_t lv_img_decoder_built_in_line_alpha(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
-                                                   lv_coord_t len, uint8_t * buf)
+static lv_res_t lv_img_decoder_built_in_area_alpha(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
+                                                   lv_coord_t len, lv_coord_t line_cnt, uint8_t * buf)
 {
 #if LV_IMG_CF_ALPHA
     const lv_opa_t alpha1_opa_table[2]  = {0, 255};          /*Opacity mapping with bpp = 1 (Just for compatibility)*/
@@ -576,94 +810,104 @@ static lv_res_t lv_img_decoder_built_in_line_alpha(lv_img_decoder_dsc_t * dsc, l
                                            68, 85, 102, 119, 136, 153, 170, 187, 204, 221, 238, 255
                                           };
 
-    /*Simply fill the buffer with the color. Later only the alpha value will be modified.*/
-    lv_color_t bg_color = dsc->color;
-    lv_coord_t i;
-    for(i = 0; i < len; i++) {
-#if LV_COLOR_DEPTH == 8 || LV_COLOR_DEPTH == 1
-        buf[i * LV_IMG_PX_SIZE_ALPHA_BYTE] = bg_color.full;
-#elif LV_COLOR_DEPTH == 16
-        /*Because of Alpha byte 16 bit color can start on odd address which can cause crash*/
-        buf[i * LV_IMG_PX_SIZE_ALPHA_BYTE] = bg_color.full & 0xFF;
-        buf[i * LV_IMG_PX_SIZE_ALPHA_BYTE + 1] = (bg_color.full >> 8) & 0xFF;
-#elif LV_COLOR_DEPTH == 32
-        *((uint32_t *)&buf[i * LV_IMG_PX_SIZE_ALPHA_BYTE]) = bg_color.full;
-#else
-#error "Invalid LV_COLOR_DEPTH. Check it in lv_conf.h"
-#endif
-    }
-
     const lv_opa_t * opa_table = NULL;
     uint8_t px_size            = lv_img_cf_get_px_size(dsc->header.cf);
-    uint16_t mask              = (1 << px_size) - 1; /*E.g. px_size = 2; mask = 0x03*/
 
     lv_coord_t w = 0;
     uint32_t ofs = 0;
-    int8_t pos   = 0;
+    int8_t pos_start = 0;
     switch(dsc->header.cf) {
         case LV_IMG_CF_ALPHA_1BIT:
             w = (dsc->header.w + 7) >> 3; /*E.g. w = 20 -> w = 2 + 1*/
             ofs += w * y + (x >> 3); /*First pixel*/
-            pos = 7 - (x & 0x7);
+            pos_start = 7 - (x & 0x7);
             opa_table = alpha1_opa_table;
             break;
         case LV_IMG_CF_ALPHA_2BIT:
             w = (dsc->header.w + 3) >> 2; /*E.g. w = 13 -> w = 3 + 1 (bytes)*/
             ofs += w * y + (x >> 2); /*First pixel*/
-            pos = 6 - (x & 0x3) * 2;
+            pos_start = 6 - (x & 0x3) * 2;
             opa_table = alpha2_opa_table;
             break;
         case LV_IMG_CF_ALPHA_4BIT:
             w = (dsc->header.w + 1) >> 1; /*E.g. w = 13 -> w = 6 + 1 (bytes)*/
             ofs += w * y + (x >> 1); /*First pixel*/
-            pos = 4 - (x & 0x1) * 4;
+            pos_start = 4 - (x & 0x1) * 4;
             opa_table = alpha4_opa_table;
             break;
         case LV_IMG_CF_ALPHA_8BIT:
             w = dsc->header.w; /*E.g. x = 7 -> w = 7 (bytes)*/
             ofs += w * y + x;  /*First pixel*/
-            pos = 0;
+            pos_start = 0;
             break;
     }
 
+    /*The decoded pixels are the color with the opacities*/
+    uint32_t px_table[16];
+    uint32_t i;
+    if(opa_table) {
+        for(i = 0; i < (1U << px_size); i++) px_table[i] = make_px(dsc->color, opa_table[i]);
+    }
+    else {
+        px_table[0] = make_px(dsc->color, LV_OPA_TRANSP);
+    }
+
+    bool compr = is_compressed(dsc);
 #if LV_USE_FILESYSTEM
     lv_img_decoder_built_in_data_t * user_data = dsc->user_data;
-    uint8_t * fs_buf = _lv_mem_buf_get(w);
-    if (fs_buf == NULL) return LV_RES_INV;
+    /*Bytes of a line from the first to the last pixel*/
+    uint32_t btr = (((uint32_t)x + len - 1) * px_size >> 3) - (((uint32_t)x * px_size) >> 3) + 1;
+    uint8_t * fs_buf = NULL;
+    if(dsc->src_type == LV_IMG_SRC_FILE && !compr) {
+        fs_buf = _lv_mem_buf_get(btr);
+        if(fs_buf == NULL) return LV_RES_INV;
+    }
 #endif
 
-    const uint8_t * data_tmp = NULL;
-    if(dsc->src_type == LV_IMG_SRC_VARIABLE) {
-        const lv_img_dsc_t * img_dsc = dsc->src;
+    lv_coord_t l;
+    for(l = 0; l < line_cnt; l++) {
+        const uint8_t * data_tmp = NULL;
+        if(compr) {
+            data_tmp = compr_get_data(dsc, ofs);
+            if(data_tmp == NULL) return LV_RES_INV;
+        }
+        else if(dsc->src_type == LV_IMG_SRC_VARIABLE) {
+            const lv_img_dsc_t * img_dsc = dsc->src;
 
-        data_tmp = img_dsc->data + ofs;
-    }
-    else {
+            data_tmp = img_dsc->data + ofs;
+        }
+        else {
 #if LV_USE_FILESYSTEM
-        lv_fs_seek(&user_data->f, ofs + 4); /*+4 to skip the header*/
-        lv_fs_read(&user_data->f, fs_buf, w, NULL);
-        data_tmp = fs_buf;
+            if(fs_read_at(user_data, ofs + 4, fs_buf, btr) != LV_RES_OK) { /*+4 to skip the header*/
+                _lv_mem_buf_release(fs_buf);
+                return LV_RES_INV;
+            }
+            data_tmp = fs_buf;
 #else
-        LV_LOG_WARN("Image built-in alpha line reader can't read file because LV_USE_FILESYSTEM = 0");
-        data_tmp = NULL; /*To avoid warnings*/
-        return LV_RES_INV;
+            LV_LOG_WARN("Image built-in alpha line reader can't read file because LV_USE_FILESYSTEM = 0");
+            data_tmp = NULL; /*To avoid warnings*/
+            return LV_RES_INV;
 #endif
-    }
-
-    for(i = 0; i < len; i++) {
-        uint8_t val_act = (*data_tmp >> pos) & mask;
-
-        buf[i * LV_IMG_PX_SIZE_ALPHA_BYTE + LV_IMG_PX_SIZE_ALPHA_BYTE - 1] =
-            dsc->header.cf == LV_IMG_CF_ALPHA_8BIT ? val_act : opa_table[val_act];
+        }
 
-        pos -= px_size;
-        if(pos < 0) {
-            pos = 8 - px_size;
-            data_tmp++;
+        uint8_t * buf_line = buf + (uint32_t)l * len * LV_IMG_PX_SIZE_ALPHA_BYTE;
+        if(opa_table) {
+            expand_px(data_tmp, px_size, pos_start, len, px_table, buf_line);
         }
+        else {
+            /*Copy the color and overwrite the opacity*/
+            lv_coord_t j;
+            for(j = 0; j < len; j++) {
+                px_copy(buf_line, px_table[0]);
+                buf_line[LV_IMG_PX_SIZE_ALPHA_BYTE - 1] = data_tmp[j];
+                buf_line += LV_IMG_PX_SIZE_ALPHA_BYTE;
+            }
+        }
+
+        ofs += w;
     }
 #if LV_USE_FILESYSTEM
-    _lv_mem_buf_release(fs_buf);
+    if(fs_buf) _lv_mem_buf_release(fs_buf);
 #endif
     return LV_RES_OK;
 #else
@@ -672,96 +916,624 @@ static lv_res_t lv_img_decoder_built_in_line_alpha(lv_img_decoder_dsc_t * dsc, l
 #endif
 }
 
-static lv_res_t lv_img_decoder_built_in_line_indexed(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
-                                                     lv_coord_t len, uint8_t * buf)
+static lv_res_t lv_img_decoder_built_in_area_indexed(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
+                                                     lv_coord_t len, lv_coord_t line_cnt, uint8_t * buf)
 {
 #if LV_IMG_CF_INDEXED
     uint8_t px_size = lv_img_cf_get_px_size(dsc->header.cf);
-    uint16_t mask   = (1 << px_size) - 1; /*E.g. px_size = 2; mask = 0x03*/
 
     lv_coord_t w = 0;
-    int8_t pos   = 0;
+    int8_t pos_start = 0;
     uint32_t ofs = 0;
     switch(dsc->header.cf) {
         case LV_IMG_CF_INDEXED_1BIT:
             w = (dsc->header.w + 7) >> 3; /*E.g. w = 20 -> w = 2 + 1*/
             ofs += w * y + (x >> 3); /*First pixel*/
             ofs += 8;                /*Skip the palette*/
-            pos = 7 - (x & 0x7);
+            pos_start = 7 - (x & 0x7);
             break;
         case LV_IMG_CF_INDEXED_2BIT:
             w = (dsc->header.w + 3) >> 2; /*E.g. w = 13 -> w = 3 + 1 (bytes)*/
             ofs += w * y + (x >> 2); /*First pixel*/
             ofs += 16;               /*Skip the palette*/
-            pos = 6 - (x & 0x3) * 2;
+            pos_start = 6 - (x & 0x3) * 2;
             break;
         case LV_IMG_CF_INDEXED_4BIT:
             w = (dsc->header.w + 1) >> 1; /*E.g. w = 13 -> w = 6 + 1 (bytes)*/
             ofs += w * y + (x >> 1); /*First pixel*/
             ofs += 64;               /*Skip the palette*/
-            pos = 4 - (x & 0x1) * 4;
+            pos_start = 4 - (x & 0x1) * 4;
             break;
         case LV_IMG_CF_INDEXED_8BIT:
             w = dsc->header.w; /*E.g. x = 7 -> w = 7 (bytes)*/
             ofs += w * y + x;  /*First pixel*/
             ofs += 1024;       /*Skip the palette*/
-            pos = 0;
+            pos_start = 0;
             break;
     }
 
     lv_img_decoder_built_in_data_t * user_data = dsc->user_data;
 
+    bool compr = is_compressed(dsc);
+#if LV_USE_FILESYSTEM
+    /*Bytes of a line from the first to the last pixel*/
+    uint32_t btr = (((uint32_t)x + len - 1) * px_size >> 3) - (((uint32_t)x * px_size) >> 3) + 1;
+    uint8_t * fs_buf = NULL;
+    if(dsc->src_type == LV_IMG_SRC_FILE && !compr) {
+        fs_buf = _lv_mem_buf_get(btr);
+        if(fs_buf == NULL) return LV_RES_INV;
+    }
+#endif
+
+    lv_coord_t l;
+    for(l = 0; l < line_cnt; l++) {
+        const uint8_t * data_tmp = NULL;
+        if(compr) {
+            /*The decompressed data doesn't contain the palette (4 bytes for each color)*/
+            data_tmp = compr_get_data(dsc, ofs - (4U << px_size));
+            if(data_tmp == NULL) return LV_RES_INV;
+        }
+        else if(dsc->src_type == LV_IMG_SRC_VARIABLE) {
+            const lv_img_dsc_t * img_dsc = dsc->src;
+            data_tmp                     = img_dsc->data + ofs;
+        }
+        else {
+#if LV_USE_FILESYSTEM
+            if(fs_read_at(user_data, ofs + 4, fs_buf, btr) != LV_RES_OK) { /*+4 to skip the header*/
+                _lv_mem_buf_release(fs_buf);
+                return LV_RES_INV;
+            }
+            data_tmp = fs_buf;
+#else
+            LV_LOG_WARN("Image built-in indexed line reader can't read file because LV_USE_FILESYSTEM = 0");
+            data_tmp = NULL; /*To avoid warnings*/
+            return LV_RES_INV;
+#endif
+        }
+
+        uint8_t * buf_line = buf + (uint32_t)l * len * LV_IMG_PX_SIZE_ALPHA_BYTE;
+        expand_px(data_tmp, px_size, pos_start, len, user_data->palette, buf_line);
+
+        ofs += w;
+    }
+#if LV_USE_FILESYSTEM
+    if(fs_buf) _lv_mem_buf_release(fs_buf);
+#endif
+    return LV_RES_OK;
+#else
+    LV_LOG_WARN("Image built-in indexed line reader failed because LV_IMG_CF_INDEXED is 0 in lv_conf.h");
+    return LV_RES_INV;
+#endif
+}
+
+static lv_res_t lv_img_decoder_built_in_area_compr(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
+                                                   lv_coord_t len, lv_coord_t line_cnt, uint8_t * buf)
+{
+    uint32_t px_bytes = lv_img_cf_get_px_size(dsc->header.cf) >> 3;
+    uint32_t line_bytes = (uint32_t)dsc->header.w * px_bytes;
+    uint32_t ofs = ((uint32_t)y * dsc->header.w + x) * px_bytes;
+    uint32_t btr = len * px_bytes;
+
+    lv_coord_t l;
+    for(l = 0; l < line_cnt; l++) {
+        const uint8_t * data = compr_get_data(dsc, ofs);
+        if(data == NULL) return LV_RES_INV;
+
+        _lv_memcpy(buf, data, btr);
+        ofs += line_bytes;
+        buf += btr;
+    }
+
+    return LV_RES_OK;
+}
+
+/**
+ * Get the data of the built-in decoder. Allocate it if it doesn't exist yet.
+ * @param dsc pointer to decoder descriptor
+ * @return the data or NULL if there is no memory for it
+ */
+static lv_img_decoder_built_in_data_t * get_user_data(lv_img_decoder_dsc_t * dsc)
+{
+    if(dsc->user_data == NULL) {
+        dsc->user_data = lv_mem_alloc(sizeof(lv_img_decoder_built_in_data_t));
+        LV_ASSERT_MEM(dsc->user_data);
+        if(dsc->user_data == NULL) {
+            LV_LOG_ERROR("img_decoder_built_in_open: out of memory");
+            return NULL;
+        }
+        _lv_memset_00(dsc->user_data, sizeof(lv_img_decoder_built_in_data_t));
+    }
+
+    return dsc->user_data;
+}
+
+/**
+ * Tell whether an opened image is compressed.
+ * @param dsc pointer to decoder descriptor
+ * @return true: the image is `LV_IMG_CF_RLE` or `LV_IMG_CF_LZ4`
+ */
+static bool is_compressed(const lv_img_decoder_dsc_t * dsc)
+{
+#if LV_IMG_CF_COMPRESSED
+    const lv_img_decoder_built_in_data_t * user_data = dsc->user_data;
+    return user_data && user_data->compr;
+#else
+    LV_UNUSED(dsc);
+    return false;
+#endif
+}
+
+/**
+ * Get the decompressed data of a compressed image from the given position.
+ * Decompress the block of the position if it's not decompressed yet.
+ * @param dsc pointer to decoder descriptor of a compressed image
+ * @param ofs position in the decompressed data (without palette). The data is valid until the end of the line.
+ * @return pointer to the data or NULL on error
+ */
+static const uint8_t * compr_get_data(lv_img_decoder_dsc_t * dsc, uint32_t ofs)
+{
+#if LV_IMG_CF_COMPRESSED
+    lv_img_decoder_built_in_data_t * user_data = dsc->user_data;
+    if(user_data->img_buf) return user_data->img_buf + ofs;
+
+    uint32_t line_bytes = ((uint32_t)dsc->header.w * lv_img_cf_get_px_size(dsc->header.cf) + 7) >> 3;
+    uint32_t block_bytes = line_bytes * user_data->block_h;
+    int32_t block_id = ofs / block_bytes;
+    if(block_id != user_data->block_id) {
+        if(compr_decode_block(dsc, block_id, user_data->block_buf) != LV_RES_OK) {
+            user_data->block_id = -1;
+            return NULL;
+        }
+        user_data->block_id = block_id;
+    }
+
+    return user_data->block_buf + ofs - block_id * block_bytes;
+#else
+    LV_UNUSED(dsc);
+    LV_UNUSED(ofs);
+    return NULL;
+#endif
+}
+
+#if LV_IMG_CF_COMPRESSED
+/**
+ * Prepare the decompression if the image is compressed.
+ * Small true color images are decompressed as a whole (see `LV_IMG_DECODER_COMPR_CACHE_SIZE`),
+ * else a buffer is allocated for a block.
+ * @param dsc pointer to decoder descriptor. The header is already set to the decompressed color format.
+ * @return LV_RES_OK: not compressed or ready to decompress; LV_RES_INV: invalid image or out of memory
+ */
+static lv_res_t compr_open(lv_img_decoder_dsc_t * dsc)
+{
+    /*Only the source knows that it's compressed*/
+    lv_img_header_t src_header;
+    if(dsc->src_type == LV_IMG_SRC_VARIABLE) {
+        src_header = ((lv_img_dsc_t *)dsc->src)->header;
+    }
+    else {
 #if LV_USE_FILESYSTEM
-    uint8_t * fs_buf = _lv_mem_buf_get(w);
-    if (fs_buf == NULL) return LV_RES_INV;
+        if(fs_read_at(dsc->user_data, 0, (uint8_t *)&src_header, sizeof(lv_img_header_t)) != LV_RES_OK) {
+            return LV_RES_INV;
+        }
+#else
+        return LV_RES_INV;
 #endif
-    const uint8_t * data_tmp = NULL;
+    }
+
+    if(src_header.cf != LV_IMG_CF_RLE && src_header.cf != LV_IMG_CF_LZ4) return LV_RES_OK;
+
+    lv_img_decoder_built_in_data_t * user_data = get_user_data(dsc);
+    if(user_data == NULL) return LV_RES_INV;
+
+    user_data->compr = src_header.cf;
+    user_data->block_id = -1;
+
+    lv_img_compr_header_t compr_header;
+    lv_coord_t h = dsc->header.h;
+    uint32_t block_cnt;
+    uint32_t ofs_bytes;
     if(dsc->src_type == LV_IMG_SRC_VARIABLE) {
         const lv_img_dsc_t * img_dsc = dsc->src;
-        data_tmp                     = img_dsc->data + ofs;
+        _lv_memcpy_small(&compr_header, img_dsc->data, sizeof(lv_img_compr_header_t));
+        if(compr_header.block_h == 0) return LV_RES_INV;
+
+        /*The offsets are read from the image data when required*/
+        block_cnt = (h + compr_header.block_h - 1) / compr_header.block_h;
+        ofs_bytes = (block_cnt + 1) * sizeof(uint32_t);
+        if(img_dsc->data_size < sizeof(lv_img_compr_header_t) + ofs_bytes) return LV_RES_INV;
+
+        uint32_t end;
+        _lv_memcpy_small(&end, img_dsc->data + sizeof(lv_img_compr_header_t) + block_cnt * sizeof(uint32_t),
+                         sizeof(uint32_t));
+        user_data->blocks_pos = sizeof(lv_img_compr_header_t) + ofs_bytes;
+        if(dsc->header.cf >= LV_IMG_CF_INDEXED_1BIT && dsc->header.cf <= LV_IMG_CF_INDEXED_8BIT) {
+            user_data->blocks_pos += 4U << lv_img_cf_get_px_size(dsc->header.cf);
+        }
+        if(img_dsc->data_size < user_data->blocks_pos + end) return LV_RES_INV;
     }
     else {
 #if LV_USE_FILESYSTEM
-        lv_fs_seek(&user_data->f, ofs + 4); /*+4 to skip the header*/
-        lv_fs_read(&user_data->f, fs_buf, w, NULL);
-        data_tmp = fs_buf;
+        uint32_t pos = sizeof(lv_img_header_t);
+        if(fs_read_at(user_data, pos, (uint8_t *)&compr_header, sizeof(lv_img_compr_header_t)) != LV_RES_OK) {
+            return LV_RES_INV;
+        }
+        if(compr_header.block_h == 0) return LV_RES_INV;
+
+        /*Keep the offsets in the RAM to not read them for every block*/
+        block_cnt = (h + compr_header.block_h - 1) / compr_header.block_h;
+        ofs_bytes = (block_cnt + 1) * sizeof(uint32_t);
+        user_data->block_ofs = lv_mem_alloc(ofs_bytes);
+        if(user_data->block_ofs == NULL) {
+            LV_LOG_WARN("Built-in image decoder: no memory for the offsets of the compressed blocks");
+            return LV_RES_INV;
+        }
+        pos += sizeof(lv_img_compr_header_t);
+        if(fs_read_at(user_data, pos, (uint8_t *)user_data->block_ofs, ofs_bytes) != LV_RES_OK) return LV_RES_INV;
+
+        user_data->blocks_pos = pos + ofs_bytes;
+        if(dsc->header.cf >= LV_IMG_CF_INDEXED_1BIT && dsc->header.cf <= LV_IMG_CF_INDEXED_8BIT) {
+            user_data->blocks_pos += 4U << lv_img_cf_get_px_size(dsc->header.cf);
+        }
 #else
-        LV_LOG_WARN("Image built-in indexed line reader can't read file because LV_USE_FILESYSTEM = 0");
-        data_tmp = NULL; /*To avoid warnings*/
         return LV_RES_INV;
 #endif
     }
 
-    lv_coord_t i;
-    for(i = 0; i < len; i++) {
-        uint8_t val_act = (*data_tmp >> pos) & mask;
+    user_data->block_h = LV_MATH_MIN(compr_header.block_h, h);
+    uint32_t line_bytes = ((uint32_t)dsc->header.w * lv_img_cf_get_px_size(dsc->header.cf) + 7) >> 3;
+
+#if LV_IMG_DECODER_COMPR_CACHE_SIZE
+    /*Decompress small true color images at once to let the image cache keep them ready to draw*/
+    lv_img_cf_t cf = dsc->header.cf;
+    uint32_t img_bytes = line_bytes * h;
+    if((cf == LV_IMG_CF_TRUE_COLOR || cf == LV_IMG_CF_TRUE_COLOR_ALPHA || cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED) &&
+       img_bytes <= LV_IMG_DECODER_COMPR_CACHE_SIZE) {
+        user_data->img_buf = lv_mem_alloc(img_bytes);
+        if(user_data->img_buf) {
+            uint32_t i;
+            for(i = 0; i < block_cnt; i++) {
+                lv_res_t res = compr_decode_block(dsc, i, user_data->img_buf + i * line_bytes * user_data->block_h);
+                if(res != LV_RES_OK) return LV_RES_INV;
+            }
+            dsc->img_data = user_data->img_buf;
+            return LV_RES_OK;
+        }
+
+        LV_LOG_INFO("Built-in image decoder: no memory to decompress the whole image");
+    }
+#endif
+
+    user_data->block_buf = lv_mem_alloc(line_bytes * user_data->block_h);
+    if(user_data->block_buf == NULL) {
+        LV_LOG_WARN("Built-in image decoder: no memory for a decompressed block");
+        return LV_RES_INV;
+    }
+
+    return LV_RES_OK;
+}
 
-        lv_color_t color = user_data->palette[val_act];
+/**
+ * Decompress a block of a compressed image
+ * @param dsc pointer to decoder descriptor of a compressed image
+ * @param block_id index of the block
+ * @param buf store the decompressed lines here
+ * @return LV_RES_OK: ok; LV_RES_INV: read error or invalid data
+ */
+static lv_res_t compr_decode_block(lv_img_decoder_dsc_t * dsc, uint32_t block_id, uint8_t * buf)
+{
+    lv_img_decoder_built_in_data_t * user_data = dsc->user_data;
+
+    uint32_t ofs[2];
+    if(user_data->block_ofs) {
+        ofs[0] = user_data->block_ofs[block_id];
+        ofs[1] = user_data->block_ofs[block_id + 1];
+    }
+    else {
+        const uint8_t * ofs_p = ((lv_img_dsc_t *)dsc->src)->data + sizeof(lv_img_compr_header_t);
+        _lv_memcpy_small(ofs, ofs_p + block_id * sizeof(uint32_t), sizeof(ofs));
+    }
+    if(ofs[1] < ofs[0]) {
+        LV_LOG_WARN("Built-in image decoder: invalid compressed block");
+        return LV_RES_INV;
+    }
+
+    uint8_t px_size = lv_img_cf_get_px_size(dsc->header.cf);
+    uint32_t line_bytes = ((uint32_t)dsc->header.w * px_size + 7) >> 3;
+    uint32_t line_cnt = LV_MATH_MIN(user_data->block_h, dsc->header.h - block_id * user_data->block_h);
+    uint32_t in_size = ofs[1] - ofs[0];
+    const uint8_t * in;
+    uint8_t * fs_buf = NULL;
+    if(dsc->src_type == LV_IMG_SRC_VARIABLE) {
+        const lv_img_dsc_t * img_dsc = dsc->src;
+        if(user_data->blocks_pos + ofs[1] > img_dsc->data_size) {
+            LV_LOG_WARN("Built-in image decoder: invalid compressed block");
+            return LV_RES_INV;
+        }
+        in = img_dsc->data + user_data->blocks_pos + ofs[0];
+    }
+    else {
+#if LV_USE_FILESYSTEM
+        fs_buf = _lv_mem_buf_get(in_size);
+        if(fs_buf == NULL) return LV_RES_INV;
+        if(fs_read_at(user_data, user_data->blocks_pos + ofs[0], fs_buf, in_size) != LV_RES_OK) {
+            _lv_mem_buf_release(fs_buf);
+            return LV_RES_INV;
+        }
+        in = fs_buf;
+#else
+        return LV_RES_INV;
+#endif
+    }
+
+    lv_res_t res;
+    if(user_data->compr == LV_IMG_CF_RLE) {
+        res = rle_decode(in, in_size, buf, line_cnt * line_bytes, px_size >= 8 ? px_size >> 3 : 1);
+    }
+    else {
+        res = lz4_decode(in, in_size, buf, line_cnt * line_bytes);
+    }
+
+    if(fs_buf) _lv_mem_buf_release(fs_buf);
+
+    if(res != LV_RES_OK) {
+        LV_LOG_WARN("Built-in image decoder: invalid compressed block");
+    }
+    return res;
+}
+
+/**
+ * Decompress run-length encoded data. See `lv_img_compr_header_t`.
+ * @param in the compressed data
+ * @param in_size size of the compressed data
+ * @param out store the decompressed data here
+ * @param out_size size of the decompressed data
+ * @param px_bytes size of a pixel to repeat in bytes
+ * @return LV_RES_OK: ok; LV_RES_INV: invalid data
+ */
+LV_ATTRIBUTE_FAST_MEM static lv_res_t rle_decode(const uint8_t * in, uint32_t in_size, uint8_t * out,
+                                                 uint32_t out_size, uint8_t px_bytes)
+{
+    const uint8_t * in_end = in + in_size;
+    uint8_t * out_end = out + out_size;
+
+    while(out < out_end) {
+        if(in == in_end) return LV_RES_INV;
+
+        uint8_t ctrl = *in;
+        in++;
+        uint32_t cnt = (ctrl & 0x7F) * px_bytes;
+        if(cnt > (uint32_t)(out_end - out)) return LV_RES_INV;
+
+        /*Pixels as they are*/
+        if(ctrl & 0x80) {
+            if(cnt > (uint32_t)(in_end - in)) return LV_RES_INV;
+            _lv_memcpy(out, in, cnt);
+            in += cnt;
+            out += cnt;
+        }
+        /*A pixel repeated*/
+        else {
+            if(px_bytes > (uint32_t)(in_end - in)) return LV_RES_INV;
+            if(px_bytes == 1) {
+                _lv_memset(out, *in, cnt);
+            }
+            else if(cnt) {
+                /*Double the already repeated pixels*/
+                _lv_memcpy_small(out, in, px_bytes);
+                uint32_t done = px_bytes;
+                while(done < cnt) {
+                    uint32_t n = LV_MATH_MIN(done, cnt - done);
+                    _lv_memcpy(out + done, out, n);
+                    done += n;
+                }
+            }
+            in += px_bytes;
+            out += cnt;
+        }
+    }
+
+    return in == in_end ? LV_RES_OK : LV_RES_INV;
+}
+
+/**
+ * Decompress an LZ4 block
+ * @param in the compressed data
+ * @param in_size size of the compressed data
+ * @param out store the decompressed data here
+ * @param out_size size of the decompressed data
+ * @return LV_RES_OK: ok; LV_RES_INV: invalid data
+ */
+LV_ATTRIBUTE_FAST_MEM static lv_res_t lz4_decode(const uint8_t * in, uint32_t in_size, uint8_t * out,
+                                                 uint32_t out_size)
+{
+    const uint8_t * in_end = in + in_size;
+    uint8_t * out_start = out;
+    uint8_t * out_end = out + out_size;
+
+    while(in < in_end) {
+        uint8_t token = *in;
+        in++;
+
+        /*Literals*/
+        uint32_t cnt = token >> 4;
+        if(cnt == 15) {
+            uint8_t b;
+            do {
+                if(in == in_end) return LV_RES_INV;
+                b = *in;
+                in++;
+                cnt += b;
+            } while(b == 255);
+        }
+        if(cnt > (uint32_t)(in_end - in) || cnt > (uint32_t)(out_end - out)) return LV_RES_INV;
+        _lv_memcpy(out, in, cnt);
+        in += cnt;
+        out += cnt;
+
+        /*The last sequence has only literals*/
+        if(in == in_end) break;
+
+        /*Match*/
+        if(in_end - in < 2) return LV_RES_INV;
+        uint32_t dist = in[0] | ((uint32_t)in[1] << 8);
+        in += 2;
+        if(dist == 0 || dist > (uint32_t)(out - out_start)) return LV_RES_INV;
+
+        cnt = token & 0xF;
+        if(cnt == 15) {
+            uint8_t b;
+            do {
+                if(in == in_end) return LV_RES_INV;
+                b = *in;
+                in++;
+                cnt += b;
+            } while(b == 255);
+        }
+        cnt += 4;
+        if(cnt > (uint32_t)(out_end - out)) return LV_RES_INV;
+
+        const uint8_t * match = out - dist;
+        if(dist >= cnt) {
+            _lv_memcpy(out, match, cnt);
+            out += cnt;
+        }
+        else {
+            /*Overlapping: repeat the last `dist` bytes*/
+            uint8_t * end = out + cnt;
+            while(out < end) {
+                *out = *match;
+                out++;
+                match++;
+            }
+        }
+    }
+
+    return out == out_end ? LV_RES_OK : LV_RES_INV;
+}
+#endif /*LV_IMG_CF_COMPRESSED*/
+
+/**
+ * Create a decoded pixel of `LV_IMG_PX_SIZE_ALPHA_BYTE` bytes in the lower bytes of an `uint32_t`.
+ * Its bytes are in the same order in the memory as in the decoded image.
+ * @param color the color of the pixel
+ * @param opa the opacity of the pixel
+ * @return the decoded pixel
+ */
+static uint32_t make_px(lv_color_t color, lv_opa_t opa)
+{
+    uint32_t px = 0;
+    uint8_t * px_p = (uint8_t *)&px;
 #if LV_COLOR_DEPTH == 8 || LV_COLOR_DEPTH == 1
-        buf[i * LV_IMG_PX_SIZE_ALPHA_BYTE] = color.full;
+    px_p[0] = color.full;
 #elif LV_COLOR_DEPTH == 16
-        /*Because of Alpha byte 16 bit color can start on odd address which can cause crash*/
-        buf[i * LV_IMG_PX_SIZE_ALPHA_BYTE] = color.full & 0xFF;
-        buf[i * LV_IMG_PX_SIZE_ALPHA_BYTE + 1] = (color.full >> 8) & 0xFF;
+    px_p[0] = color.full & 0xFF;
+    px_p[1] = (color.full >> 8) & 0xFF;
 #elif LV_COLOR_DEPTH == 32
-        *((uint32_t *)&buf[i * LV_IMG_PX_SIZE_ALPHA_BYTE]) = color.full;
+    px = color.full;
 #else
 #error "Invalid LV_COLOR_DEPTH. Check it in lv_conf.h"
 #endif
-        buf[i * LV_IMG_PX_SIZE_ALPHA_BYTE + LV_IMG_PX_SIZE_ALPHA_BYTE - 1] = user_data->opa[val_act];
+    px_p[LV_IMG_PX_SIZE_ALPHA_BYTE - 1] = opa;
+
+    return px;
+}
+
+/**
+ * Store a decoded pixel created by `make_px`
+ * @param dst store the pixel here
+ * @param px the pixel
+ */
+static inline void px_copy(uint8_t * dst, uint32_t px)
+{
+#if LV_IMG_PX_SIZE_ALPHA_BYTE == 4
+    *((uint32_t *)dst) = px;
+#else
+    /*Because of Alpha byte 16 bit color can start on odd address which can cause crash*/
+    const uint8_t * px_p = (const uint8_t *)&px;
+    dst[0] = px_p[0];
+    dst[1] = px_p[1];
+#if LV_IMG_PX_SIZE_ALPHA_BYTE == 3
+    dst[2] = px_p[2];
+#endif
+#endif
+}
+
+/**
+ * Expand the pixels of a 32 bit word
+ * @param word 32 bit of the source, the first pixel is in the most significant bits
+ * @param bpp bit per pixel (1, 2, 4 or 8)
+ * @param table the decoded pixel for every value
+ * @param dst store the 32 / `bpp` pixels here
+ */
+static inline void expand_word(uint32_t word, uint8_t bpp, const uint32_t * table, uint8_t * dst)
+{
+    uint32_t i;
+    for(i = 0; i < 32U / bpp; i++) {
+        px_copy(dst, table[word >> (32 - bpp)]);
+        word <<= bpp;
+        dst += LV_IMG_PX_SIZE_ALPHA_BYTE;
+    }
+}
 
-        pos -= px_size;
+/**
+ * Expand 1, 2, 4 or 8 bit pixels through a table to decoded pixels.
+ * The pixels are processed 32 bit at once.
+ * @param src the byte with the first pixel
+ * @param bpp bit per pixel (1, 2, 4 or 8)
+ * @param pos bit position of the first pixel in `src` (the first pixel of a byte is in the most significant bits)
+ * @param len number of pixels to expand
+ * @param table the decoded pixel for every value
+ * @param dst store the decoded pixels here
+ */
+LV_ATTRIBUTE_FAST_MEM static void expand_px(const uint8_t * src, uint8_t bpp, int8_t pos, lv_coord_t len,
+                                            const uint32_t * table, uint8_t * dst)
+{
+    uint8_t mask = (1 << bpp) - 1;
+
+    /*Pixels until the first whole byte*/
+    while(len > 0 && pos != 8 - bpp) {
+        px_copy(dst, table[(*src >> pos) & mask]);
+        dst += LV_IMG_PX_SIZE_ALPHA_BYTE;
+        len--;
+        pos -= bpp;
         if(pos < 0) {
-            pos = 8 - px_size;
-            data_tmp++;
+            pos = 8 - bpp;
+            src++;
+        }
+    }
+
+    /*Whole 32 bit words. The constant `bpp` lets the compiler unroll the expansion*/
+    uint32_t px_per_word = 32 / bpp;
+    while(len >= (lv_coord_t)px_per_word) {
+        uint32_t word = ((uint32_t)src[0] << 24) | ((uint32_t)src[1] << 16) | ((uint32_t)src[2] << 8) | src[3];
+        switch(bpp) {
+            case 1:
+                expand_word(word, 1, table, dst);
+                break;
+            case 2:
+                expand_word(word, 2, table, dst);
+                break;
+            case 4:
+                expand_word(word, 4, table, dst);
+                break;
+            default:
+                expand_word(word, 8, table, dst);
+                break;
+        }
+        src += 4;
+        dst += px_per_word * LV_IMG_PX_SIZE_ALPHA_BYTE;
+        len -= px_per_word;
+    }
+
+    /*The remaining pixels*/
+    while(len > 0) {
+        px_copy(dst, table[(*src >> pos) & mask]);
+        dst += LV_IMG_PX_SIZE_ALPHA_BYTE;
+        len--;
+        pos -= bpp;
+        if(pos < 0) {
+            pos = 8 - bpp;
+            src++;
         }
     }
-#if LV_USE_FILESYSTEM
-    _lv_mem_buf_release(fs_buf);
-#endif
-    return LV_RES_OK;
-#else
-    LV_LOG_WARN("Image built-in indexed line reader failed because LV_IMG_CF_INDEXED is 0 in lv_conf.h");
-    return LV_RES_INV;
-#endif
 }
@@ -77,6 +77,23 @@ typedef lv_res_t (*lv_img_decoder_open_f_t)(struct _lv_img_decoder * decoder, st
 typedef lv_res_t (*lv_img_decoder_read_line_f_t)(struct _lv_img_decoder * decoder, struct _lv_img_decoder_dsc * dsc,
                                                  lv_coord_t x, lv_coord_t y, lv_coord_t len, uint8_t * buf);
 
+/**
+ * Decode `line_cnt` lines of `len` pixels starting from the given `x`, `y` coordinates and store them in `buf`
+ * after each other.
+ * Optional. If not set the lines are read one-by-one with the read line function.
+ * @param decoder pointer to the decoder the function associated with
+ * @param dsc pointer to decoder descriptor
+ * @param x start x coordinate
+ * @param y start y coordinate of the first line
+ * @param len number of pixels to decode in each line
+ * @param line_cnt number of lines to decode
+ * @param buf a buffer to store the decoded pixels
+ * @return LV_RES_OK: ok; LV_RES_INV: failed
+ */
+typedef lv_res_t (*lv_img_decoder_read_area_f_t)(struct _lv_img_decoder * decoder, struct _lv_img_decoder_dsc * dsc,
+                                                 lv_coord_t x, lv_coord_t y, lv_coord_t len, lv_coord_t line_cnt,
+                                                 uint8_t * buf);
+
 /**
  * Close the pending decoding. Free resources etc.
  * @param decoder pointer to the decoder the function associated with
@@ -93,6 +110,8 @@ typedef struct _lv_img_decoder {
 #if LV_USE_USER_DATA
     lv_img_decoder_user_data_t user_data;
 #endif
+
+    lv_img_decoder_read_area_f_t read_area_cb;
 } lv_img_decoder_t;
 
 /**Describe an image decoding session. Stores data about the decoding*/
@@ -128,6 +147,22 @@ typedef struct _lv_img_decoder_dsc {
     void * user_data;
 } lv_img_decoder_dsc_t;
 
+/**How the decoders of compressed file formats (e.g. PNG) provide the pixels*/
+enum {
+    LV_IMG_DECODER_MODE_STRIP,  /**< Decode the lines while drawing. Needs RAM only for a line and the decoder's state*/
+    LV_IMG_DECODER_MODE_FULL,   /**< Decode the whole image when opened and let the image cache keep it*/
+};
+
+typedef uint8_t lv_img_decoder_mode_t;
+
+/**Statistics of the decoders which support it (e.g. the PNG decoder)*/
+typedef struct {
+    uint32_t open_cnt;      /**< Number of opened images*/
+    uint32_t restart_cnt;   /**< Number of times the decoding restarted from the first line to read an earlier line*/
+    uint32_t px_cnt;        /**< Number of decoded pixels (including the lines decoded only to skip them)*/
+    uint32_t time;          /**< Time spent with decoding [ms]*/
+} lv_img_decoder_stats_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -175,6 +210,21 @@ lv_res_t lv_img_decoder_open(lv_img_decoder_dsc_t * dsc, const void * src, lv_co
 lv_res_t lv_img_decoder_read_line(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y, lv_coord_t len,
                                   uint8_t * buf);
 
+/**
+ * Read a strip of lines from an opened image.
+ * The lines are stored after each other in `buf`.
+ * A pixel takes `LV_IMG_PX_SIZE_ALPHA_BYTE` bytes if the color format has alpha, else `sizeof(lv_color_t)`
+ * @param dsc pointer to `lv_img_decoder_dsc_t` used in `lv_img_decoder_open`
+ * @param x start X coordinate (from left)
+ * @param y start Y coordinate (from top) of the first line
+ * @param len number of pixels to read in each line
+ * @param line_cnt number of lines to read
+ * @param buf store the data here
+ * @return LV_RES_OK: success; LV_RES_INV: an error occurred
+ */
+lv_res_t lv_img_decoder_read_area(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y, lv_coord_t len,
+                                  lv_coord_t line_cnt, uint8_t * buf);
+
 /**
  * Close a decoding session
  * @param dsc pointer to `lv_img_decoder_dsc_t` used in `lv_img_decoder_open`
@@ -214,6 +264,13 @@ void lv_img_decoder_set_open_cb(lv_img_decoder_t * decoder, lv_img_decoder_open_
  */
 void lv_img_decoder_set_read_line_cb(lv_img_decoder_t * decoder, lv_img_decoder_read_line_f_t read_line_cb);
 
+/**
+ * Set a callback to decode more lines of an image at once
+ * @param decoder pointer to an image decoder
+ * @param read_area_cb a function to read a strip of lines of an image
+ */
+void lv_img_decoder_set_read_area_cb(lv_img_decoder_t * decoder, lv_img_decoder_read_area_f_t read_area_cb);
+
 /**
  * Set a callback to close a decoding session. E.g. close files and free other resources.
  * @param decoder pointer to an image decoder
@@ -221,6 +278,17 @@ void lv_img_decoder_set_read_line_cb(lv_img_decoder_t * decoder, lv_img_decoder_
  */
 void lv_img_decoder_set_close_cb(lv_img_decoder_t * decoder, lv_img_decoder_close_f_t close_cb);
 
+/**
+ * Estimate the time of decoding pixels from the statistics of a decoder.
+ * Opening small images takes less than a tick so measuring them one-by-one gives 0 or 1 ms.
+ * The average speed of all the decoded pixels is more accurate.
+ * Decoders can use it to set `time_to_open` for the image cache.
+ * @param stats statistics of the decoder
+ * @param px_cnt number of pixels to decode
+ * @return the estimated time in milliseconds, at least 1
+ */
+uint32_t lv_img_decoder_estimate_time(const lv_img_decoder_stats_t * stats, uint32_t px_cnt);
+
 /**
  * Get info about a built-in image
  * @param decoder the decoder where this function belongs
@@ -252,6 +320,21 @@ lv_res_t lv_img_decoder_built_in_open(lv_img_decoder_t * decoder, lv_img_decoder
 lv_res_t lv_img_decoder_built_in_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x,
                                            lv_coord_t y, lv_coord_t len, uint8_t * buf);
 
+/**
+ * Decode `line_cnt` lines of `len` pixels starting from the given `x`, `y` coordinates and store them in `buf`.
+ * Files are read in blocks through a read ahead buffer.
+ * @param decoder pointer to the decoder the function associated with
+ * @param dsc pointer to decoder descriptor
+ * @param x start x coordinate
+ * @param y start y coordinate of the first line
+ * @param len number of pixels to decode in each line
+ * @param line_cnt number of lines to decode
+ * @param buf a buffer to store the decoded pixels
+ * @return LV_RES_OK: ok; LV_RES_INV: failed
+ */
+lv_res_t lv_img_decoder_built_in_read_area(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x,
+                                           lv_coord_t y, lv_coord_t len, lv_coord_t line_cnt, uint8_t * buf);
+
 /**
  * Close the pending decoding. Free resources etc.
  * @param decoder pointer to the decoder the function associated with
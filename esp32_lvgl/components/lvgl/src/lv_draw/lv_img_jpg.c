@@ -0,0 +1,650 @@
+/**
+ * @file lv_img_jpg.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_img_jpg.h"
+
+#if LV_USE_JPG
+
+#include <stdio.h>      /*`jpeglib.h` needs `FILE` and `size_t`*/
+#include <string.h>
+#include <setjmp.h>
+#include <jpeglib.h>
+#include "lv_draw_img.h"
+#include "../lv_misc/lv_debug.h"
+#include "../lv_misc/lv_log.h"
+#include "../lv_misc/lv_mem.h"
+#include "../lv_misc/lv_math.h"
+#include "../lv_hal/lv_hal_tick.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define JPG_READ_BUF_SIZE   512     /*Read files in blocks of this size*/
+#define JPG_MAX_SIZE        2047    /*Limited by `lv_img_header_t`*/
+#define JPG_SOI             0xD8    /*Start of image marker*/
+#define JPG_SOS             0xDA    /*Start of scan marker*/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/*A JPEG file from a file or a variable. It's also the data source of libjpeg.*/
+typedef struct {
+    struct jpeg_source_mgr pub;     /*Must be the first*/
+#if LV_USE_FILESYSTEM
+    lv_fs_file_t file;
+    uint8_t buf[JPG_READ_BUF_SIZE];
+#endif
+    const uint8_t * data;           /*The JPEG file stored in a variable*/
+    uint32_t data_size;
+    uint8_t is_file : 1;
+} jpg_src_t;
+
+typedef struct {
+    struct jpeg_error_mgr pub;      /*Must be the first*/
+    jmp_buf jmp;
+} jpg_err_t;
+
+/*Info from the beginning of a JPEG file*/
+typedef struct {
+    uint32_t w;
+    uint32_t h;
+} jpg_hdr_t;
+
+typedef struct {
+    struct jpeg_decompress_struct cinfo;
+    jpg_err_t err;
+    jpg_src_t src;
+    uint8_t * row;                  /*The last decoded line in 8 bit RGB or grayscale format*/
+    uint8_t * img_buf;              /*The whole decoded image in full mode*/
+    int32_t row_y;                  /*Y coordinate of the line in `row`. -1: no line is decoded yet*/
+    uint8_t decoding : 1;           /*`cinfo` is created*/
+    uint8_t gray : 1;               /*The image is decoded to grayscale*/
+} jpg_dsc_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static lv_res_t decoder_info(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header);
+static lv_res_t decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
+static lv_res_t decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
+                                  lv_coord_t len, uint8_t * buf);
+static void decoder_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
+static lv_res_t decode_full(jpg_dsc_t * j, const jpg_hdr_t * hdr);
+static lv_res_t decode_start(jpg_dsc_t * j, const jpg_hdr_t * hdr);
+static lv_res_t decode_to_line(jpg_dsc_t * j, int32_t y);
+static void decode_end(jpg_dsc_t * j);
+static void convert_line(const uint8_t * in, uint8_t * out, uint32_t px_cnt, bool gray);
+static lv_res_t read_header(jpg_src_t * s, jpg_hdr_t * hdr);
+static lv_res_t src_open(jpg_src_t * s, const void * src);
+static lv_res_t src_rewind(jpg_src_t * s);
+static bool src_fill(jpg_src_t * s);
+static lv_res_t src_read(jpg_src_t * s, uint8_t * buf, uint32_t btr);
+static lv_res_t src_skip(jpg_src_t * s, uint32_t n);
+static void src_close(jpg_src_t * s);
+static void init_source_cb(j_decompress_ptr cinfo);
+static boolean fill_input_buffer_cb(j_decompress_ptr cinfo);
+static void skip_input_data_cb(j_decompress_ptr cinfo, long num_bytes);
+static void term_source_cb(j_decompress_ptr cinfo);
+static void error_exit_cb(j_common_ptr cinfo);
+static void output_message_cb(j_common_ptr cinfo);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_img_decoder_t * jpg_decoder;
+static lv_img_decoder_mode_t decode_mode = LV_IMG_DECODER_MODE_STRIP;
+static lv_img_decoder_stats_t stats;
+static lv_img_decoder_stats_t speed;    /*Never reset to estimate the time to open*/
+
+static const JOCTET fake_eoi[2] = {0xFF, JPEG_EOI};
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Register the JPEG decoder. It uses libjpeg (or libjpeg-turbo).
+ * It opens
+ * - files with ".jpg" or ".jpeg" extension on any registered drive,
+ * - `lv_img_dsc_t` variables with `LV_IMG_CF_RAW` color format and a JPEG file in `data`.
+ * The images are decoded to `LV_IMG_CF_TRUE_COLOR`. Grayscale and RGB (YCbCr) images are supported.
+ */
+void lv_img_jpg_init(void)
+{
+    if(jpg_decoder) return;
+
+    jpg_decoder = lv_img_decoder_create();
+    LV_ASSERT_MEM(jpg_decoder);
+    if(jpg_decoder == NULL) return;
+
+    lv_img_decoder_set_info_cb(jpg_decoder, decoder_info);
+    lv_img_decoder_set_open_cb(jpg_decoder, decoder_open);
+    lv_img_decoder_set_read_line_cb(jpg_decoder, decoder_read_line);
+    lv_img_decoder_set_close_cb(jpg_decoder, decoder_close);
+}
+
+/**
+ * Set how the JPEG images are decoded. Applies to the images opened later.
+ * @param mode `LV_IMG_DECODER_MODE_STRIP` (default): decode the lines while drawing.
+ *             The RAM usage doesn't depend on the image's height (except for progressive JPEGs)
+ *             but the image is decoded on every redraw.
+ *             `LV_IMG_DECODER_MODE_FULL`: decode the image when opened and keep it while it's in the image cache
+ */
+void lv_img_jpg_set_mode(lv_img_decoder_mode_t mode)
+{
+    decode_mode = mode;
+}
+
+/**
+ * Get the statistics of the JPEG decoder
+ * @param stats_p store the statistics here
+ */
+void lv_img_jpg_get_stats(lv_img_decoder_stats_t * stats_p)
+{
+    *stats_p = stats;
+}
+
+/**
+ * Reset the statistics of the JPEG decoder
+ */
+void lv_img_jpg_reset_stats(void)
+{
+    _lv_memset_00(&stats, sizeof(stats));
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static lv_res_t decoder_info(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header)
+{
+    LV_UNUSED(decoder);
+
+    jpg_src_t s;
+    if(src_open(&s, src) != LV_RES_OK) return LV_RES_INV;
+
+    jpg_hdr_t hdr;
+    lv_res_t res = read_header(&s, &hdr);
+    src_close(&s);
+    if(res != LV_RES_OK) return LV_RES_INV;
+
+    header->always_zero = 0;
+    header->cf = LV_IMG_CF_TRUE_COLOR;
+    header->w = hdr.w;
+    header->h = hdr.h;
+
+    return LV_RES_OK;
+}
+
+static lv_res_t decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    jpg_dsc_t * j = lv_mem_alloc(sizeof(jpg_dsc_t));
+    LV_ASSERT_MEM(j);
+    if(j == NULL) return LV_RES_INV;
+    _lv_memset_00(j, sizeof(jpg_dsc_t));
+    dsc->user_data = j;
+
+    jpg_hdr_t hdr;
+    if(src_open(&j->src, dsc->src) != LV_RES_OK || read_header(&j->src, &hdr) != LV_RES_OK) {
+        decoder_close(decoder, dsc);
+        return LV_RES_INV;
+    }
+
+    dsc->header.always_zero = 0;
+    dsc->header.cf = LV_IMG_CF_TRUE_COLOR;
+    dsc->header.w = hdr.w;
+    dsc->header.h = hdr.h;
+    stats.open_cnt++;
+
+    if(decode_mode == LV_IMG_DECODER_MODE_FULL) {
+        uint32_t t = lv_tick_get();
+        lv_res_t res = decode_full(j, &hdr);
+        t = lv_tick_elaps(t);
+        if(res != LV_RES_OK) {
+            decoder_close(decoder, dsc);
+            return LV_RES_INV;
+        }
+
+        stats.px_cnt += hdr.w * hdr.h;
+        stats.time += t;
+        speed.px_cnt += hdr.w * hdr.h;
+        speed.time += t;
+
+        /*The decoder and the file are not required anymore*/
+        decode_end(j);
+        src_close(&j->src);
+
+        /*Let the image cache weight the image by the time of decoding*/
+        dsc->img_data = j->img_buf;
+        dsc->time_to_open = lv_img_decoder_estimate_time(&speed, hdr.w * hdr.h);
+        return LV_RES_OK;
+    }
+
+    /*Only the header is processed now, the lines are decoded in `jpg_read_line`*/
+    if(decode_start(j, &hdr) != LV_RES_OK) {
+        decoder_close(decoder, dsc);
+        return LV_RES_INV;
+    }
+
+    return LV_RES_OK;
+}
+
+static lv_res_t decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
+                                  lv_coord_t len, uint8_t * buf)
+{
+    LV_UNUSED(decoder);
+
+    jpg_dsc_t * j = dsc->user_data;
+
+    /*Already decoded in full mode*/
+    if(j->img_buf) {
+        _lv_memcpy(buf, j->img_buf + (y * dsc->header.w + x) * sizeof(lv_color_t), len * sizeof(lv_color_t));
+        return LV_RES_OK;
+    }
+
+    uint32_t t = lv_tick_get();
+
+    /*The lines can be decoded only forward. Start again for an earlier line.*/
+    if(j->decoding && y < j->row_y) {
+        decode_end(j);
+        stats.restart_cnt++;
+    }
+    if(!j->decoding) {
+        jpg_hdr_t hdr;
+        hdr.w = dsc->header.w;
+        hdr.h = dsc->header.h;
+        if(decode_start(j, &hdr) != LV_RES_OK) return LV_RES_INV;
+    }
+
+    uint32_t line_cnt = y - j->row_y;
+    if(decode_to_line(j, y) != LV_RES_OK) return LV_RES_INV;
+
+    convert_line(j->row + x * (j->gray ? 1 : 3), buf, len, j->gray);
+
+    t = lv_tick_elaps(t);
+    stats.px_cnt += line_cnt * dsc->header.w;
+    stats.time += t;
+    speed.px_cnt += line_cnt * dsc->header.w;
+    speed.time += t;
+
+    return LV_RES_OK;
+}
+
+static void decoder_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(decoder);
+
+    jpg_dsc_t * j = dsc->user_data;
+    if(j == NULL) return;
+
+    decode_end(j);
+    src_close(&j->src);
+    if(j->row) lv_mem_free(j->row);
+    if(j->img_buf) lv_mem_free(j->img_buf);
+    lv_mem_free(j);
+    dsc->user_data = NULL;
+}
+
+/**
+ * Decode the whole image into `j->img_buf`
+ * @param j pointer to a JPEG decoder descriptor
+ * @param hdr info about the image
+ * @return LV_RES_OK: ok; LV_RES_INV: invalid image or out of memory
+ */
+static lv_res_t decode_full(jpg_dsc_t * j, const jpg_hdr_t * hdr)
+{
+    j->img_buf = lv_mem_alloc(lv_img_buf_get_img_size(hdr->w, hdr->h, LV_IMG_CF_TRUE_COLOR));
+    LV_ASSERT_MEM(j->img_buf);
+    if(j->img_buf == NULL) return LV_RES_INV;
+
+    if(decode_start(j, hdr) != LV_RES_OK) return LV_RES_INV;
+
+    uint32_t y;
+    for(y = 0; y < hdr->h; y++) {
+        if(decode_to_line(j, y) != LV_RES_OK) return LV_RES_INV;
+        convert_line(j->row, j->img_buf + y * hdr->w * sizeof(lv_color_t), hdr->w, j->gray);
+    }
+
+    /*Only the decoded image is required*/
+    lv_mem_free(j->row);
+    j->row = NULL;
+
+    return LV_RES_OK;
+}
+
+/**
+ * Start decoding from the beginning of the file
+ * @param j pointer to a JPEG decoder descriptor
+ * @param hdr info about the image
+ * @return LV_RES_OK: ok; LV_RES_INV: invalid image or out of memory
+ */
+static lv_res_t decode_start(jpg_dsc_t * j, const jpg_hdr_t * hdr)
+{
+    if(src_rewind(&j->src) != LV_RES_OK) return LV_RES_INV;
+
+    j->cinfo.err = jpeg_std_error(&j->err.pub);
+    j->err.pub.error_exit = error_exit_cb;
+    j->err.pub.output_message = output_message_cb;
+
+    if(setjmp(j->err.jmp)) {
+        decode_end(j);
+        return LV_RES_INV;
+    }
+
+    jpeg_create_decompress(&j->cinfo);
+    j->decoding = 1;
+    j->cinfo.src = &j->src.pub;
+    jpeg_read_header(&j->cinfo, TRUE);
+
+    /*Decode everything to 8 bit RGB except the grayscale images*/
+    j->gray = j->cinfo.num_components == 1 ? 1 : 0;
+    j->cinfo.out_color_space = j->gray ? JCS_GRAYSCALE : JCS_RGB;
+    jpeg_start_decompress(&j->cinfo);
+
+    if(j->cinfo.output_width != hdr->w || j->cinfo.output_height != hdr->h ||
+       j->cinfo.output_components != (j->gray ? 1 : 3)) {
+        LV_LOG_WARN("JPEG decoder: unexpected image format");
+        decode_end(j);
+        return LV_RES_INV;
+    }
+
+    if(j->row == NULL) {
+        j->row = lv_mem_alloc(hdr->w * (j->gray ? 1 : 3));
+        LV_ASSERT_MEM(j->row);
+        if(j->row == NULL) {
+            decode_end(j);
+            return LV_RES_INV;
+        }
+    }
+
+    j->row_y = -1;
+    return LV_RES_OK;
+}
+
+/**
+ * Decode the lines until the given line to `j->row`
+ * @param j pointer to a JPEG decoder descriptor
+ * @param y the line to decode. Should be larger than or equal to `j->row_y`
+ * @return LV_RES_OK: ok; LV_RES_INV: invalid image
+ */
+static lv_res_t decode_to_line(jpg_dsc_t * j, int32_t y)
+{
+    if(setjmp(j->err.jmp)) {
+        decode_end(j);
+        return LV_RES_INV;
+    }
+
+    while(j->row_y < y) {
+        JSAMPROW row = j->row;
+        if(jpeg_read_scanlines(&j->cinfo, &row, 1) != 1) {
+            decode_end(j);
+            return LV_RES_INV;
+        }
+        j->row_y++;
+    }
+
+    return LV_RES_OK;
+}
+
+static void decode_end(jpg_dsc_t * j)
+{
+    /*Abort the decoding too and free the decoder's memory*/
+    if(j->decoding) jpeg_destroy_decompress(&j->cinfo);
+    j->decoding = 0;
+}
+
+/**
+ * Convert 8 bit RGB or grayscale pixels to `lv_color_t`
+ * @param in the 8 bit RGB or grayscale pixels
+ * @param out store the converted pixels here
+ * @param px_cnt number of pixels to convert
+ * @param gray true: `in` is grayscale
+ */
+static void convert_line(const uint8_t * in, uint8_t * out, uint32_t px_cnt, bool gray)
+{
+    uint32_t i;
+    for(i = 0; i < px_cnt; i++) {
+        lv_color_t c;
+        if(gray) {
+            c = lv_color_make(in[0], in[0], in[0]);
+            in++;
+        }
+        else {
+            c = lv_color_make(in[0], in[1], in[2]);
+            in += 3;
+        }
+        _lv_memcpy_small(out, &c, sizeof(lv_color_t));
+        out += sizeof(lv_color_t);
+    }
+}
+
+/**
+ * Read the size of a JPEG image from the start of frame marker without decoding it
+ * @param s pointer to an opened JPEG source
+ * @param hdr store the info here
+ * @return LV_RES_OK: ok; LV_RES_INV: not a JPEG image or not supported
+ */
+static lv_res_t read_header(jpg_src_t * s, jpg_hdr_t * hdr)
+{
+    uint8_t buf[6];
+    if(src_read(s, buf, 2) != LV_RES_OK || buf[0] != 0xFF || buf[1] != JPG_SOI) return LV_RES_INV;
+
+    while(1) {
+        if(src_read(s, buf, 2) != LV_RES_OK || buf[0] != 0xFF) return LV_RES_INV;
+
+        /*Skip the fill bytes*/
+        uint8_t marker = buf[1];
+        while(marker == 0xFF) {
+            if(src_read(s, &marker, 1) != LV_RES_OK) return LV_RES_INV;
+        }
+
+        /*The image data or the end before a frame*/
+        if(marker == JPEG_EOI || marker == JPG_SOS) return LV_RES_INV;
+
+        /*Markers without length: TEM and RSTn*/
+        if(marker == 0x01 || (marker >= JPEG_RST0 && marker <= JPEG_RST0 + 7)) continue;
+
+        if(src_read(s, buf, 2) != LV_RES_OK) return LV_RES_INV;
+        uint32_t len = ((uint32_t)buf[0] << 8) | buf[1];
+        if(len < 2) return LV_RES_INV;
+
+        /*Start of frame markers: 0xC0..0xCF except DHT (0xC4), JPG (0xC8) and DAC (0xCC)*/
+        if(marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+            if(len < 8 || src_read(s, buf, 6) != LV_RES_OK) return LV_RES_INV;
+            hdr->h = ((uint32_t)buf[1] << 8) | buf[2];
+            hdr->w = ((uint32_t)buf[3] << 8) | buf[4];
+            if(buf[5] != 1 && buf[5] != 3) {
+                LV_LOG_WARN("JPEG decoder: only grayscale and RGB images are supported");
+                return LV_RES_INV;
+            }
+            if(hdr->w == 0 || hdr->h == 0 || hdr->w > JPG_MAX_SIZE || hdr->h > JPG_MAX_SIZE) {
+                LV_LOG_WARN("JPEG decoder: the image is too large");
+                return LV_RES_INV;
+            }
+            return LV_RES_OK;
+        }
+
+        if(src_skip(s, len - 2) != LV_RES_OK) return LV_RES_INV;
+    }
+}
+
+static lv_res_t src_open(jpg_src_t * s, const void * src)
+{
+    s->data = NULL;
+    s->data_size = 0;
+    s->is_file = 0;
+    s->pub.init_source = init_source_cb;
+    s->pub.fill_input_buffer = fill_input_buffer_cb;
+    s->pub.skip_input_data = skip_input_data_cb;
+    s->pub.resync_to_restart = jpeg_resync_to_restart;
+    s->pub.term_source = term_source_cb;
+
+    lv_img_src_t src_type = lv_img_src_get_type(src);
+    if(src_type == LV_IMG_SRC_VARIABLE) {
+        const lv_img_dsc_t * img_dsc = src;
+        if(img_dsc->header.cf != LV_IMG_CF_RAW) return LV_RES_INV;
+        if(img_dsc->data_size < 2 || img_dsc->data[0] != 0xFF || img_dsc->data[1] != JPG_SOI) return LV_RES_INV;
+
+        s->data = img_dsc->data;
+        s->data_size = img_dsc->data_size;
+        return src_rewind(s);
+    }
+#if LV_USE_FILESYSTEM
+    else if(src_type == LV_IMG_SRC_FILE) {
+        const char * ext = lv_fs_get_ext(src);
+        if(strcmp(ext, "jpg") != 0 && strcmp(ext, "JPG") != 0 && strcmp(ext, "jpeg") != 0 &&
+           strcmp(ext, "JPEG") != 0) return LV_RES_INV;
+
+        if(lv_fs_open(&s->file, src, LV_FS_MODE_RD) != LV_FS_RES_OK) return LV_RES_INV;
+        s->is_file = 1;
+        return src_rewind(s);
+    }
+#endif
+
+    return LV_RES_INV;
+}
+
+static lv_res_t src_rewind(jpg_src_t * s)
+{
+    if(!s->is_file) {
+        /*All the data is available at once*/
+        s->pub.next_input_byte = s->data;
+        s->pub.bytes_in_buffer = s->data_size;
+        return LV_RES_OK;
+    }
+
+#if LV_USE_FILESYSTEM
+    s->pub.next_input_byte = s->buf;
+    s->pub.bytes_in_buffer = 0;
+    return lv_fs_seek(&s->file, 0) == LV_FS_RES_OK ? LV_RES_OK : LV_RES_INV;
+#else
+    return LV_RES_INV;
+#endif
+}
+
+/**
+ * Read the next block of a file
+ * @param s pointer to a JPEG source
+ * @return true: new data is available; false: end of the data
+ */
+static bool src_fill(jpg_src_t * s)
+{
+#if LV_USE_FILESYSTEM
+    if(s->is_file) {
+        uint32_t br = 0;
+        if(lv_fs_read(&s->file, s->buf, JPG_READ_BUF_SIZE, &br) != LV_FS_RES_OK) br = 0;
+        s->pub.next_input_byte = s->buf;
+        s->pub.bytes_in_buffer = br;
+        return br != 0;
+    }
+#else
+    LV_UNUSED(s);
+#endif
+
+    return false;
+}
+
+static lv_res_t src_read(jpg_src_t * s, uint8_t * buf, uint32_t btr)
+{
+    while(btr) {
+        if(s->pub.bytes_in_buffer == 0 && !src_fill(s)) return LV_RES_INV;
+
+        uint32_t n = LV_MATH_MIN(btr, s->pub.bytes_in_buffer);
+        _lv_memcpy(buf, s->pub.next_input_byte, n);
+        s->pub.next_input_byte += n;
+        s->pub.bytes_in_buffer -= n;
+        buf += n;
+        btr -= n;
+    }
+
+    return LV_RES_OK;
+}
+
+static lv_res_t src_skip(jpg_src_t * s, uint32_t n)
+{
+    while(n > s->pub.bytes_in_buffer) {
+        n -= s->pub.bytes_in_buffer;
+        s->pub.bytes_in_buffer = 0;
+        if(!src_fill(s)) return LV_RES_INV;
+    }
+
+    s->pub.next_input_byte += n;
+    s->pub.bytes_in_buffer -= n;
+    return LV_RES_OK;
+}
+
+static void src_close(jpg_src_t * s)
+{
+#if LV_USE_FILESYSTEM
+    if(s->is_file) lv_fs_close(&s->file);
+#endif
+    s->is_file = 0;
+    s->data = NULL;
+    s->data_size = 0;
+}
+
+static void init_source_cb(j_decompress_ptr cinfo)
+{
+    LV_UNUSED(cinfo);
+}
+
+static boolean fill_input_buffer_cb(j_decompress_ptr cinfo)
+{
+    jpg_src_t * s = (jpg_src_t *)cinfo->src;
+    if(!src_fill(s)) {
+        /*Insert an end marker to finish the truncated images like libjpeg's own sources*/
+        s->pub.next_input_byte = fake_eoi;
+        s->pub.bytes_in_buffer = sizeof(fake_eoi);
+    }
+
+    return TRUE;
+}
+
+static void skip_input_data_cb(j_decompress_ptr cinfo, long num_bytes)
+{
+    if(num_bytes <= 0) return;
+
+    jpg_src_t * s = (jpg_src_t *)cinfo->src;
+    while(num_bytes > (long)s->pub.bytes_in_buffer) {
+        num_bytes -= s->pub.bytes_in_buffer;
+        fill_input_buffer_cb(cinfo);
+    }
+
+    s->pub.next_input_byte += num_bytes;
+    s->pub.bytes_in_buffer -= num_bytes;
+}
+
+static void term_source_cb(j_decompress_ptr cinfo)
+{
+    LV_UNUSED(cinfo);
+}
+
+static void error_exit_cb(j_common_ptr cinfo)
+{
+#if LV_USE_LOG
+    char msg[JMSG_LENGTH_MAX];
+    cinfo->err->format_message(cinfo, msg);
+    LV_LOG_WARN("JPEG decoder: %s", msg);
+#endif
+
+    jpg_err_t * err = (jpg_err_t *)cinfo->err;
+    longjmp(err->jmp, 1);
+}
+
+static void output_message_cb(j_common_ptr cinfo)
+{
+    /*Don't print the warnings to `stderr`*/
+    LV_UNUSED(cinfo);
+}
+
+#endif /*LV_USE_JPG*/
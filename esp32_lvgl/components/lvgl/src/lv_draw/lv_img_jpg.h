@@ -0,0 +1,73 @@
+/**
+ * @file lv_img_jpg.h
+ *
+ */
+
+#ifndef LV_IMG_JPG_H
+#define LV_IMG_JPG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_conf_internal.h"
+
+#if LV_USE_JPG
+
+#include "lv_img_decoder.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Register the JPEG decoder. It uses libjpeg (or libjpeg-turbo).
+ * It opens
+ * - files with ".jpg" or ".jpeg" extension on any registered drive,
+ * - `lv_img_dsc_t` variables with `LV_IMG_CF_RAW` color format and a JPEG file in `data`.
+ * The images are decoded to `LV_IMG_CF_TRUE_COLOR`. Grayscale and RGB (YCbCr) images are supported.
+ */
+void lv_img_jpg_init(void);
+
+/**
+ * Set how the JPEG images are decoded. Applies to the images opened later.
+ * @param mode `LV_IMG_DECODER_MODE_STRIP` (default): decode the lines while drawing.
+ *             The RAM usage doesn't depend on the image's height (except for progressive JPEGs)
+ *             but the image is decoded on every redraw.
+ *             `LV_IMG_DECODER_MODE_FULL`: decode the image when opened and keep it while it's in the image cache
+ */
+void lv_img_jpg_set_mode(lv_img_decoder_mode_t mode);
+
+/**
+ * Get the statistics of the JPEG decoder
+ * @param stats store the statistics here
+ */
+void lv_img_jpg_get_stats(lv_img_decoder_stats_t * stats);
+
+/**
+ * Reset the statistics of the JPEG decoder
+ */
+void lv_img_jpg_reset_stats(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_JPG*/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_IMG_JPG_H*/
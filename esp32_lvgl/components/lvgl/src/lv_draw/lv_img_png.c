@@ -0,0 +1,656 @@
+/**
+ * @file lv_img_png.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_img_png.h"
+
+#if LV_USE_PNG
+
+#include <png.h>
+#include <string.h>
+#include "lv_draw_img.h"
+#include "../lv_misc/lv_debug.h"
+#include "../lv_misc/lv_log.h"
+#include "../lv_misc/lv_mem.h"
+#include "../lv_misc/lv_math.h"
+#include "../lv_hal/lv_hal_tick.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define PNG_SIG_SIZE        8
+#define PNG_IHDR_END        33      /*The signature and the IHDR chunk*/
+#define PNG_READ_BUF_SIZE   256     /*Read ahead buffer for the small reads from files*/
+#define PNG_MAX_SIZE        2047    /*Limited by `lv_img_header_t`*/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/*A PNG file from a file or a variable*/
+typedef struct {
+#if LV_USE_FILESYSTEM
+    lv_fs_file_t file;
+    uint8_t buf[PNG_READ_BUF_SIZE];
+    uint32_t buf_start;         /*Position of the buffer's first byte in the file*/
+    uint16_t buf_len;           /*Number of valid bytes in the buffer*/
+#endif
+    const uint8_t * data;       /*The PNG file stored in a variable*/
+    uint32_t data_size;
+    uint32_t pos;               /*Position of the next byte to read*/
+    uint8_t is_file : 1;
+} png_src_t;
+
+/*Info from the beginning of a PNG file*/
+typedef struct {
+    uint32_t w;
+    uint32_t h;
+    uint8_t alpha : 1;          /*It has alpha channel or transparent color*/
+    uint8_t interlaced : 1;
+} png_hdr_t;
+
+typedef struct {
+    png_src_t src;
+    png_structp png;            /*NULL if not decoding now*/
+    png_infop info;
+    uint8_t * row;              /*The last decoded line in 8 bit RGB or RGBA format*/
+    uint8_t * img_buf;          /*The whole decoded image in full mode*/
+    int32_t row_y;              /*Y coordinate of the line in `row`. -1: no line is decoded yet*/
+} png_dsc_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static lv_res_t decoder_info(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header);
+static lv_res_t decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
+static lv_res_t decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
+                                  lv_coord_t len, uint8_t * buf);
+static void decoder_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
+static lv_res_t decode_full(png_dsc_t * p, const png_hdr_t * hdr);
+static lv_res_t decode_start(png_dsc_t * p, bool alpha);
+static lv_res_t decode_to_line(png_dsc_t * p, int32_t y);
+static lv_res_t decode_interlaced(png_dsc_t * p, uint8_t ** row_pointers);
+static void decode_end(png_dsc_t * p);
+static void convert_line(const uint8_t * in, uint8_t * out, uint32_t px_cnt, bool alpha);
+static lv_res_t read_header(png_src_t * s, png_hdr_t * hdr);
+static lv_res_t src_open(png_src_t * s, const void * src);
+static lv_res_t src_read(png_src_t * s, uint8_t * buf, uint32_t btr);
+static lv_res_t src_seek(png_src_t * s, uint32_t pos);
+static void src_close(png_src_t * s);
+static void read_cb(png_structp png, png_bytep data, png_size_t length);
+static void error_cb(png_structp png, png_const_charp msg);
+static void warning_cb(png_structp png, png_const_charp msg);
+static png_voidp malloc_cb(png_structp png, png_alloc_size_t size);
+static void free_cb(png_structp png, png_voidp ptr);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_img_decoder_t * png_decoder;
+static lv_img_decoder_mode_t decode_mode = LV_IMG_DECODER_MODE_STRIP;
+static lv_img_decoder_stats_t stats;
+static lv_img_decoder_stats_t speed;    /*Never reset to estimate the time to open*/
+
+static const uint8_t png_sig[PNG_SIG_SIZE] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Register the PNG decoder. It uses libpng.
+ * It opens
+ * - files with ".png" extension on any registered drive,
+ * - `lv_img_dsc_t` variables with `LV_IMG_CF_RAW`/`LV_IMG_CF_RAW_ALPHA` color format and a PNG file in `data`.
+ * The images are decoded to `LV_IMG_CF_TRUE_COLOR_ALPHA` or `LV_IMG_CF_TRUE_COLOR` if they are opaque.
+ */
+void lv_img_png_init(void)
+{
+    if(png_decoder) return;
+
+    png_decoder = lv_img_decoder_create();
+    LV_ASSERT_MEM(png_decoder);
+    if(png_decoder == NULL) return;
+
+    lv_img_decoder_set_info_cb(png_decoder, decoder_info);
+    lv_img_decoder_set_open_cb(png_decoder, decoder_open);
+    lv_img_decoder_set_read_line_cb(png_decoder, decoder_read_line);
+    lv_img_decoder_set_close_cb(png_decoder, decoder_close);
+}
+
+/**
+ * Set how the PNG images are decoded. Applies to the images opened later.
+ * Interlaced images are always decoded as a whole.
+ * @param mode `LV_IMG_DECODER_MODE_STRIP` (default): decode the lines while drawing.
+ *             The RAM usage doesn't depend on the image's height but the image is decoded on every redraw.
+ *             `LV_IMG_DECODER_MODE_FULL`: decode the image when opened and keep it while it's in the image cache
+ */
+void lv_img_png_set_mode(lv_img_decoder_mode_t mode)
+{
+    decode_mode = mode;
+}
+
+/**
+ * Get the statistics of the PNG decoder
+ * @param stats_p store the statistics here
+ */
+void lv_img_png_get_stats(lv_img_decoder_stats_t * stats_p)
+{
+    *stats_p = stats;
+}
+
+/**
+ * Reset the statistics of the PNG decoder
+ */
+void lv_img_png_reset_stats(void)
+{
+    _lv_memset_00(&stats, sizeof(stats));
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static lv_res_t decoder_info(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header)
+{
+    LV_UNUSED(decoder);
+
+    png_src_t s;
+    if(src_open(&s, src) != LV_RES_OK) return LV_RES_INV;
+
+    png_hdr_t hdr;
+    lv_res_t res = read_header(&s, &hdr);
+    src_close(&s);
+    if(res != LV_RES_OK) return LV_RES_INV;
+
+    header->always_zero = 0;
+    header->cf = hdr.alpha ? LV_IMG_CF_TRUE_COLOR_ALPHA : LV_IMG_CF_TRUE_COLOR;
+    header->w = hdr.w;
+    header->h = hdr.h;
+
+    return LV_RES_OK;
+}
+
+static lv_res_t decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    png_dsc_t * p = lv_mem_alloc(sizeof(png_dsc_t));
+    LV_ASSERT_MEM(p);
+    if(p == NULL) return LV_RES_INV;
+    _lv_memset_00(p, sizeof(png_dsc_t));
+    dsc->user_data = p;
+
+    png_hdr_t hdr;
+    if(src_open(&p->src, dsc->src) != LV_RES_OK || read_header(&p->src, &hdr) != LV_RES_OK) {
+        decoder_close(decoder, dsc);
+        return LV_RES_INV;
+    }
+
+    dsc->header.always_zero = 0;
+    dsc->header.cf = hdr.alpha ? LV_IMG_CF_TRUE_COLOR_ALPHA : LV_IMG_CF_TRUE_COLOR;
+    dsc->header.w = hdr.w;
+    dsc->header.h = hdr.h;
+    stats.open_cnt++;
+
+    /*Interlaced images can't be decoded line-by-line*/
+    if(decode_mode == LV_IMG_DECODER_MODE_FULL || hdr.interlaced) {
+        uint32_t t = lv_tick_get();
+        lv_res_t res = decode_full(p, &hdr);
+        t = lv_tick_elaps(t);
+        if(res != LV_RES_OK) {
+            decoder_close(decoder, dsc);
+            return LV_RES_INV;
+        }
+
+        stats.px_cnt += hdr.w * hdr.h;
+        stats.time += t;
+        speed.px_cnt += hdr.w * hdr.h;
+        speed.time += t;
+
+        /*The decoder and the file are not required anymore*/
+        decode_end(p);
+        src_close(&p->src);
+
+        /*Let the image cache weight the image by the time of decoding*/
+        dsc->img_data = p->img_buf;
+        dsc->time_to_open = lv_img_decoder_estimate_time(&speed, hdr.w * hdr.h);
+        return LV_RES_OK;
+    }
+
+    /*Only the header is processed now, the lines are decoded in `png_read_line`*/
+    p->row = lv_mem_alloc(hdr.w * (hdr.alpha ? 4 : 3));
+    LV_ASSERT_MEM(p->row);
+    if(p->row == NULL || decode_start(p, hdr.alpha) != LV_RES_OK) {
+        decoder_close(decoder, dsc);
+        return LV_RES_INV;
+    }
+
+    return LV_RES_OK;
+}
+
+static lv_res_t decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
+                                  lv_coord_t len, uint8_t * buf)
+{
+    LV_UNUSED(decoder);
+
+    png_dsc_t * p = dsc->user_data;
+    bool alpha = dsc->header.cf == LV_IMG_CF_TRUE_COLOR_ALPHA;
+
+    /*Already decoded in full mode*/
+    if(p->img_buf) {
+        uint32_t px_size = alpha ? LV_IMG_PX_SIZE_ALPHA_BYTE : sizeof(lv_color_t);
+        _lv_memcpy(buf, p->img_buf + (y * dsc->header.w + x) * px_size, len * px_size);
+        return LV_RES_OK;
+    }
+
+    uint32_t t = lv_tick_get();
+
+    /*The lines can be decoded only forward. Start again for an earlier line.*/
+    if(p->png && y < p->row_y) {
+        decode_end(p);
+        stats.restart_cnt++;
+    }
+    if(p->png == NULL && decode_start(p, alpha) != LV_RES_OK) return LV_RES_INV;
+
+    uint32_t line_cnt = y - p->row_y;
+    if(decode_to_line(p, y) != LV_RES_OK) return LV_RES_INV;
+
+    convert_line(p->row + x * (alpha ? 4 : 3), buf, len, alpha);
+
+    t = lv_tick_elaps(t);
+    stats.px_cnt += line_cnt * dsc->header.w;
+    stats.time += t;
+    speed.px_cnt += line_cnt * dsc->header.w;
+    speed.time += t;
+
+    return LV_RES_OK;
+}
+
+static void decoder_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(decoder);
+
+    png_dsc_t * p = dsc->user_data;
+    if(p == NULL) return;
+
+    decode_end(p);
+    src_close(&p->src);
+    if(p->row) lv_mem_free(p->row);
+    if(p->img_buf) lv_mem_free(p->img_buf);
+    lv_mem_free(p);
+    dsc->user_data = NULL;
+}
+
+/**
+ * Decode the whole image into `p->img_buf`
+ * @param p pointer to a PNG decoder descriptor
+ * @param hdr info about the image
+ * @return LV_RES_OK: ok; LV_RES_INV: invalid image or out of memory
+ */
+static lv_res_t decode_full(png_dsc_t * p, const png_hdr_t * hdr)
+{
+    lv_img_cf_t cf = hdr->alpha ? LV_IMG_CF_TRUE_COLOR_ALPHA : LV_IMG_CF_TRUE_COLOR;
+    uint32_t px_bytes = hdr->alpha ? LV_IMG_PX_SIZE_ALPHA_BYTE : sizeof(lv_color_t);
+    uint32_t row_bytes = hdr->w * (hdr->alpha ? 4 : 3);
+
+    p->img_buf = lv_mem_alloc(lv_img_buf_get_img_size(hdr->w, hdr->h, cf));
+    LV_ASSERT_MEM(p->img_buf);
+    if(p->img_buf == NULL) return LV_RES_INV;
+
+    if(decode_start(p, hdr->alpha) != LV_RES_OK) return LV_RES_INV;
+
+    uint32_t y;
+    if(hdr->interlaced) {
+        /*All the passes need the whole image*/
+        uint8_t * rgb_buf = lv_mem_alloc(row_bytes * hdr->h);
+        uint8_t ** row_pointers = lv_mem_alloc(hdr->h * sizeof(uint8_t *));
+        lv_res_t res = LV_RES_INV;
+        if(rgb_buf && row_pointers) {
+            for(y = 0; y < hdr->h; y++) row_pointers[y] = rgb_buf + y * row_bytes;
+            res = decode_interlaced(p, row_pointers);
+        }
+
+        if(res == LV_RES_OK) {
+            for(y = 0; y < hdr->h; y++) {
+                convert_line(row_pointers[y], p->img_buf + y * hdr->w * px_bytes, hdr->w, hdr->alpha);
+            }
+        }
+        else {
+            LV_LOG_WARN("PNG decoder: can't decode the interlaced image");
+        }
+
+        if(rgb_buf) lv_mem_free(rgb_buf);
+        if(row_pointers) lv_mem_free(row_pointers);
+        return res;
+    }
+
+    p->row = lv_mem_alloc(row_bytes);
+    LV_ASSERT_MEM(p->row);
+    if(p->row == NULL) return LV_RES_INV;
+
+    for(y = 0; y < hdr->h; y++) {
+        if(decode_to_line(p, y) != LV_RES_OK) return LV_RES_INV;
+        convert_line(p->row, p->img_buf + y * hdr->w * px_bytes, hdr->w, hdr->alpha);
+    }
+
+    /*Only the decoded image is required*/
+    lv_mem_free(p->row);
+    p->row = NULL;
+
+    return LV_RES_OK;
+}
+
+/**
+ * Start decoding from the beginning of the file
+ * @param p pointer to a PNG decoder descriptor
+ * @param alpha true: the image should be decoded with alpha channel
+ * @return LV_RES_OK: ok; LV_RES_INV: invalid image or out of memory
+ */
+static lv_res_t decode_start(png_dsc_t * p, bool alpha)
+{
+    if(src_seek(&p->src, 0) != LV_RES_OK) return LV_RES_INV;
+
+    /*Allocate the decoder's memory with `lv_mem_alloc` too*/
+    p->png = png_create_read_struct_2(PNG_LIBPNG_VER_STRING, NULL, error_cb, warning_cb, NULL, malloc_cb, free_cb);
+    if(p->png == NULL) return LV_RES_INV;
+
+    p->info = png_create_info_struct(p->png);
+    if(p->info == NULL) {
+        decode_end(p);
+        return LV_RES_INV;
+    }
+
+    if(setjmp(png_jmpbuf(p->png))) {
+        decode_end(p);
+        return LV_RES_INV;
+    }
+
+    png_set_read_fn(p->png, &p->src, read_cb);
+    png_read_info(p->png, p->info);
+
+    /*Convert everything to 8 bit RGB or RGBA*/
+    png_set_expand(p->png);
+    png_set_strip_16(p->png);
+    png_set_gray_to_rgb(p->png);
+    png_set_interlace_handling(p->png);
+    png_read_update_info(p->png, p->info);
+
+    if(png_get_channels(p->png, p->info) != (alpha ? 4 : 3)) {
+        LV_LOG_WARN("PNG decoder: unexpected number of channels");
+        decode_end(p);
+        return LV_RES_INV;
+    }
+
+    p->row_y = -1;
+    return LV_RES_OK;
+}
+
+/**
+ * Decode the lines until the given line to `p->row`
+ * @param p pointer to a PNG decoder descriptor
+ * @param y the line to decode. Should be larger than or equal to `p->row_y`
+ * @return LV_RES_OK: ok; LV_RES_INV: invalid image
+ */
+static lv_res_t decode_to_line(png_dsc_t * p, int32_t y)
+{
+    if(setjmp(png_jmpbuf(p->png))) {
+        decode_end(p);
+        return LV_RES_INV;
+    }
+
+    while(p->row_y < y) {
+        png_read_row(p->png, p->row, NULL);
+        p->row_y++;
+    }
+
+    return LV_RES_OK;
+}
+
+/**
+ * Decode all the passes of an interlaced image
+ * @param p pointer to a PNG decoder descriptor
+ * @param row_pointers pointer to the lines of an 8 bit RGB or RGBA buffer
+ * @return LV_RES_OK: ok; LV_RES_INV: invalid image
+ */
+static lv_res_t decode_interlaced(png_dsc_t * p, uint8_t ** row_pointers)
+{
+    if(setjmp(png_jmpbuf(p->png))) {
+        decode_end(p);
+        return LV_RES_INV;
+    }
+
+    png_read_image(p->png, row_pointers);
+    return LV_RES_OK;
+}
+
+static void decode_end(png_dsc_t * p)
+{
+    if(p->png) png_destroy_read_struct(&p->png, p->info ? &p->info : NULL, NULL);
+    p->png = NULL;
+    p->info = NULL;
+}
+
+/**
+ * Convert 8 bit RGB or RGBA pixels to `lv_color_t` or `lv_color_t` + alpha byte
+ * @param in the 8 bit RGB or RGBA pixels
+ * @param out store the converted pixels here
+ * @param px_cnt number of pixels to convert
+ * @param alpha true: `in` is RGBA and `out` should have alpha too
+ */
+static void convert_line(const uint8_t * in, uint8_t * out, uint32_t px_cnt, bool alpha)
+{
+    uint32_t i;
+    if(alpha) {
+        for(i = 0; i < px_cnt; i++) {
+            lv_color_t c = lv_color_make(in[0], in[1], in[2]);
+            _lv_memcpy_small(out, &c, sizeof(lv_color_t));
+            out[LV_IMG_PX_SIZE_ALPHA_BYTE - 1] = in[3];
+            in += 4;
+            out += LV_IMG_PX_SIZE_ALPHA_BYTE;
+        }
+    }
+    else {
+        for(i = 0; i < px_cnt; i++) {
+            lv_color_t c = lv_color_make(in[0], in[1], in[2]);
+            _lv_memcpy_small(out, &c, sizeof(lv_color_t));
+            in += 3;
+            out += sizeof(lv_color_t);
+        }
+    }
+}
+
+/**
+ * Read the size and the type of a PNG image without decoding it
+ * @param s pointer to an opened PNG source
+ * @param hdr store the info here
+ * @return LV_RES_OK: ok; LV_RES_INV: not a PNG image or not supported
+ */
+static lv_res_t read_header(png_src_t * s, png_hdr_t * hdr)
+{
+    uint8_t buf[PNG_IHDR_END];
+    if(src_read(s, buf, PNG_IHDR_END) != LV_RES_OK) return LV_RES_INV;
+    if(memcmp(buf, png_sig, PNG_SIG_SIZE) != 0 || memcmp(&buf[12], "IHDR", 4) != 0) return LV_RES_INV;
+
+    hdr->w = ((uint32_t)buf[16] << 24) | ((uint32_t)buf[17] << 16) | ((uint32_t)buf[18] << 8) | buf[19];
+    hdr->h = ((uint32_t)buf[20] << 24) | ((uint32_t)buf[21] << 16) | ((uint32_t)buf[22] << 8) | buf[23];
+    if(hdr->w == 0 || hdr->h == 0 || hdr->w > PNG_MAX_SIZE || hdr->h > PNG_MAX_SIZE) {
+        LV_LOG_WARN("PNG decoder: the image is too large");
+        return LV_RES_INV;
+    }
+
+    uint8_t color_type = buf[25];
+    hdr->interlaced = buf[28] != 0;
+    hdr->alpha = (color_type & PNG_COLOR_MASK_ALPHA) ? 1 : 0;
+    if(hdr->alpha) return LV_RES_OK;
+
+    /*A transparent color or palette entries also mean alpha channel. It's before the image data.*/
+    while(1) {
+        uint8_t chunk[8];
+        if(src_read(s, chunk, sizeof(chunk)) != LV_RES_OK) return LV_RES_INV;
+        if(memcmp(&chunk[4], "tRNS", 4) == 0) {
+            hdr->alpha = 1;
+            break;
+        }
+        if(memcmp(&chunk[4], "IDAT", 4) == 0) break;
+
+        /*Skip the data and the CRC*/
+        uint32_t len = ((uint32_t)chunk[0] << 24) | ((uint32_t)chunk[1] << 16) | ((uint32_t)chunk[2] << 8) | chunk[3];
+        if(len > 0x7FFFFFFF || src_seek(s, s->pos + len + 4) != LV_RES_OK) return LV_RES_INV;
+    }
+
+    return LV_RES_OK;
+}
+
+static lv_res_t src_open(png_src_t * s, const void * src)
+{
+    s->data = NULL;
+    s->data_size = 0;
+    s->pos = 0;
+    s->is_file = 0;
+
+    lv_img_src_t src_type = lv_img_src_get_type(src);
+    if(src_type == LV_IMG_SRC_VARIABLE) {
+        const lv_img_dsc_t * img_dsc = src;
+        if(img_dsc->header.cf != LV_IMG_CF_RAW && img_dsc->header.cf != LV_IMG_CF_RAW_ALPHA) return LV_RES_INV;
+        if(img_dsc->data_size < PNG_SIG_SIZE || memcmp(img_dsc->data, png_sig, PNG_SIG_SIZE) != 0) return LV_RES_INV;
+
+        s->data = img_dsc->data;
+        s->data_size = img_dsc->data_size;
+        return LV_RES_OK;
+    }
+#if LV_USE_FILESYSTEM
+    else if(src_type == LV_IMG_SRC_FILE) {
+        const char * ext = lv_fs_get_ext(src);
+        if(strcmp(ext, "png") != 0 && strcmp(ext, "PNG") != 0) return LV_RES_INV;
+
+        if(lv_fs_open(&s->file, src, LV_FS_MODE_RD) != LV_FS_RES_OK) return LV_RES_INV;
+        s->is_file = 1;
+        s->buf_start = 0;
+        s->buf_len = 0;
+        return LV_RES_OK;
+    }
+#endif
+
+    return LV_RES_INV;
+}
+
+static lv_res_t src_read(png_src_t * s, uint8_t * buf, uint32_t btr)
+{
+    if(!s->is_file) {
+        if(btr > s->data_size - s->pos) return LV_RES_INV;
+        _lv_memcpy(buf, s->data + s->pos, btr);
+        s->pos += btr;
+        return LV_RES_OK;
+    }
+
+#if LV_USE_FILESYSTEM
+    /*Use the already read data*/
+    uint32_t buf_pos = s->pos - s->buf_start;
+    if(buf_pos < s->buf_len) {
+        uint32_t n = LV_MATH_MIN(btr, s->buf_len - buf_pos);
+        _lv_memcpy(buf, s->buf + buf_pos, n);
+        s->pos += n;
+        buf += n;
+        btr -= n;
+        if(btr == 0) return LV_RES_OK;
+    }
+
+    /*The file position is at the end of the buffer. Read the large chunks directly.*/
+    uint32_t br = 0;
+    if(btr >= PNG_READ_BUF_SIZE) {
+        lv_fs_res_t res = lv_fs_read(&s->file, buf, btr, &br);
+        s->buf_start = s->pos + br;
+        s->buf_len = 0;
+        s->pos += br;
+        return res == LV_FS_RES_OK && br == btr ? LV_RES_OK : LV_RES_INV;
+    }
+
+    lv_fs_res_t res = lv_fs_read(&s->file, s->buf, PNG_READ_BUF_SIZE, &br);
+    if(res != LV_FS_RES_OK) br = 0;
+    s->buf_start = s->pos;
+    s->buf_len = br;
+    if(br < btr) return LV_RES_INV;
+
+    _lv_memcpy(buf, s->buf, btr);
+    s->pos += btr;
+    return LV_RES_OK;
+#else
+    return LV_RES_INV;
+#endif
+}
+
+static lv_res_t src_seek(png_src_t * s, uint32_t pos)
+{
+    if(!s->is_file) {
+        if(pos > s->data_size) return LV_RES_INV;
+        s->pos = pos;
+        return LV_RES_OK;
+    }
+
+#if LV_USE_FILESYSTEM
+    /*Keep using the buffer if the position is in it*/
+    if(pos >= s->buf_start && pos <= s->buf_start + s->buf_len) {
+        s->pos = pos;
+        return LV_RES_OK;
+    }
+
+    if(lv_fs_seek(&s->file, pos) != LV_FS_RES_OK) return LV_RES_INV;
+    s->pos = pos;
+    s->buf_start = pos;
+    s->buf_len = 0;
+    return LV_RES_OK;
+#else
+    return LV_RES_INV;
+#endif
+}
+
+static void src_close(png_src_t * s)
+{
+#if LV_USE_FILESYSTEM
+    if(s->is_file) lv_fs_close(&s->file);
+#endif
+    s->is_file = 0;
+    s->data = NULL;
+    s->data_size = 0;
+}
+
+static void read_cb(png_structp png, png_bytep data, png_size_t length)
+{
+    png_src_t * s = png_get_io_ptr(png);
+    if(src_read(s, data, length) != LV_RES_OK) png_error(png, "unexpected end of the image");
+}
+
+static void error_cb(png_structp png, png_const_charp msg)
+{
+    LV_UNUSED(msg);
+    LV_LOG_WARN("PNG decoder: %s", msg);
+    png_longjmp(png, 1);
+}
+
+static void warning_cb(png_structp png, png_const_charp msg)
+{
+    LV_UNUSED(png);
+    LV_UNUSED(msg);
+    LV_LOG_TRACE("PNG decoder: %s", msg);
+}
+
+static png_voidp malloc_cb(png_structp png, png_alloc_size_t size)
+{
+    LV_UNUSED(png);
+    return lv_mem_alloc(size);
+}
+
+static void free_cb(png_structp png, png_voidp ptr)
+{
+    LV_UNUSED(png);
+    if(ptr) lv_mem_free(ptr);
+}
+
+#endif /*LV_USE_PNG*/
@@ -0,0 +1,73 @@
+/**
+ * @file lv_img_png.h
+ *
+ */
+
+#ifndef LV_IMG_PNG_H
+#define LV_IMG_PNG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_conf_internal.h"
+
+#if LV_USE_PNG
+
+#include "lv_img_decoder.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Register the PNG decoder. It uses libpng.
+ * It opens
+ * - files with ".png" extension on any registered drive,
+ * - `lv_img_dsc_t` variables with `LV_IMG_CF_RAW`/`LV_IMG_CF_RAW_ALPHA` color format and a PNG file in `data`.
+ * The images are decoded to `LV_IMG_CF_TRUE_COLOR_ALPHA` or `LV_IMG_CF_TRUE_COLOR` if they are opaque.
+ */
+void lv_img_png_init(void);
+
+/**
+ * Set how the PNG images are decoded. Applies to the images opened later.
+ * Interlaced images are always decoded as a whole.
+ * @param mode `LV_IMG_DECODER_MODE_STRIP` (default): decode the lines while drawing.
+ *             The RAM usage doesn't depend on the image's height but the image is decoded on every redraw.
+ *             `LV_IMG_DECODER_MODE_FULL`: decode the image when opened and keep it while it's in the image cache
+ */
+void lv_img_png_set_mode(lv_img_decoder_mode_t mode);
+
+/**
+ * Get the statistics of the PNG decoder
+ * @param stats store the statistics here
+ */
+void lv_img_png_get_stats(lv_img_decoder_stats_t * stats);
+
+/**
+ * Reset the statistics of the PNG decoder
+ */
+void lv_img_png_reset_stats(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_PNG*/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_IMG_PNG_H*/
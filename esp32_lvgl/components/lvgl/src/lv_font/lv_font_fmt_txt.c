@@ -28,6 +28,17 @@ typedef enum {
     RLE_STATE_COUNTER,
 } rle_state_t;
 
+/*State of the RLE decoder. It's on the stack of the decompressor to make it reentrant.*/
+typedef struct {
+    const uint8_t * in;     /*The next byte to load into `buf`*/
+    uint32_t buf;           /*Loaded but not consumed bits aligned to the MSB*/
+    uint32_t buf_bits;      /*Number of valid bits in `buf`*/
+    uint32_t bpp;
+    uint32_t prev_v;
+    uint32_t cnt;
+    rle_state_t state;
+} rle_dsc_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
@@ -38,24 +49,27 @@ static int32_t kern_pair_8_compare(const void * ref, const void * element);
 static int32_t kern_pair_16_compare(const void * ref, const void * element);
 
 #if LV_USE_FONT_COMPRESSED
-    static void decompress(const uint8_t * in, uint8_t * out, lv_coord_t w, lv_coord_t h, uint8_t bpp, bool prefilter);
-    static inline void decompress_line(uint8_t * out, lv_coord_t w);
-    static inline uint8_t get_bits(const uint8_t * in, uint32_t bit_pos, uint8_t len);
-    static inline void bits_write(uint8_t * out, uint32_t bit_pos, uint8_t val, uint8_t len);
-    static inline void rle_init(const uint8_t * in,  uint8_t bpp);
-    static inline uint8_t rle_next(void);
+    static inline void rle_load(rle_dsc_t * rle);
+    static inline uint32_t rle_get_bits(rle_dsc_t * rle, uint32_t len);
+    static void rle_decode_line(rle_dsc_t * rle_p, uint8_t * out, lv_coord_t w, bool xor_prev);
+    static inline void rle_fill(uint8_t * out, uint32_t len, uint8_t v, bool xor_prev);
 #endif /* LV_USE_FONT_COMPRESSED */
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 #if LV_USE_FONT_COMPRESSED
-    static uint32_t rle_rdp;
-    static const uint8_t * rle_in;
-    static uint8_t rle_bpp;
-    static uint8_t rle_prev_v;
-    static uint8_t rle_cnt;
-    static rle_state_t rle_state;
+/*Number of leading 1 bits in a byte*/
+static const uint8_t rle_lead_ones[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 7, 8
+};
 #endif /* LV_USE_FONT_COMPRESSED */
 
 /**********************
@@ -86,50 +100,7 @@ const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t unic
 
     const lv_font_fmt_txt_glyph_dsc_t * gdsc = &fdsc->glyph_dsc[gid];
 
-    if(fdsc->bitmap_format == LV_FONT_FMT_TXT_PLAIN) {
-        return &fdsc->glyph_bitmap[gdsc->bitmap_index];
-    }
-    /*Handle compressed bitmap*/
-    else {
-#if LV_USE_FONT_COMPRESSED
-        uint32_t gsize = gdsc->box_w * gdsc->box_h;
-        if(gsize == 0) return NULL;
-
-        uint32_t buf_size = gsize;
-        /*Compute memory size needed to hold decompressed glyph, rounding up*/
-        switch(fdsc->bpp) {
-            case 1:
-                buf_size = (gsize + 7) >> 3;
-                break;
-            case 2:
-                buf_size = (gsize + 3) >> 2;
-                break;
-            case 3:
-                buf_size = (gsize + 1) >> 1;
-                break;
-            case 4:
-                buf_size = (gsize + 1) >> 1;
-                break;
-        }
-
-        if(_lv_mem_get_size(LV_GC_ROOT(_lv_font_decompr_buf)) < buf_size) {
-            uint8_t * tmp = lv_mem_realloc(LV_GC_ROOT(_lv_font_decompr_buf), buf_size);
-            LV_ASSERT_MEM(tmp);
-            if(tmp == NULL) return NULL;
-            LV_GC_ROOT(_lv_font_decompr_buf) = tmp;
-        }
-
-        bool prefilter = fdsc->bitmap_format == LV_FONT_FMT_TXT_COMPRESSED ? true : false;
-        decompress(&fdsc->glyph_bitmap[gdsc->bitmap_index], LV_GC_ROOT(_lv_font_decompr_buf), gdsc->box_w, gdsc->box_h,
-                   (uint8_t)fdsc->bpp, prefilter);
-        return LV_GC_ROOT(_lv_font_decompr_buf);
-#else /* !LV_USE_FONT_COMPRESSED */
-        return NULL;
-#endif
-    }
-
-    /*If not returned earlier then the letter is not found in this font*/
-    return NULL;
+    return _lv_font_fmt_txt_decode_bitmap(fdsc, gdsc, &fdsc->glyph_bitmap[gdsc->bitmap_index]);
 }
 
 /**
@@ -183,6 +154,137 @@ bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t *
     return true;
 }
 
+/**
+ * Get the glyph ID of a letter in a font with LittlevGL's native format.
+ * @param font pointer to font
+ * @param letter an UNICODE letter code
+ * @return the glyph ID (index in `glyph_dsc`) or 0 if the letter was not found
+ */
+uint32_t _lv_font_fmt_txt_get_glyph_id(const lv_font_t * font, uint32_t letter)
+{
+    return get_glyph_dsc_id(font, letter);
+}
+
+/**
+ * Convert the stored bitmap of a glyph to a drawable one (i.e. decompress it if required)
+ * @param fdsc descriptor of the font
+ * @param gdsc descriptor of the glyph
+ * @param bitmap the stored bitmap of the glyph. Needs not to be in `fdsc->glyph_bitmap`.
+ * @return pointer to the drawable bitmap or NULL on error
+ */
+const uint8_t * _lv_font_fmt_txt_decode_bitmap(const lv_font_fmt_txt_dsc_t * fdsc,
+                                               const lv_font_fmt_txt_glyph_dsc_t * gdsc, const uint8_t * bitmap)
+{
+    if(fdsc->bitmap_format == LV_FONT_FMT_TXT_PLAIN) {
+        return bitmap;
+    }
+    /*Handle compressed bitmap*/
+    else {
+#if LV_USE_FONT_COMPRESSED
+        uint32_t gsize = gdsc->box_w * gdsc->box_h;
+        if(gsize == 0) return NULL;
+
+        uint32_t buf_size = gsize;
+        /*Compute memory size needed to hold decompressed glyph, rounding up*/
+        switch(fdsc->bpp) {
+            case 1:
+                buf_size = (gsize + 7) >> 3;
+                break;
+            case 2:
+                buf_size = (gsize + 3) >> 2;
+                break;
+            case 3:
+                buf_size = (gsize + 1) >> 1;
+                break;
+            case 4:
+                buf_size = (gsize + 1) >> 1;
+                break;
+        }
+
+        if(_lv_mem_get_size(LV_GC_ROOT(_lv_font_decompr_buf)) < buf_size) {
+            uint8_t * tmp = lv_mem_realloc(LV_GC_ROOT(_lv_font_decompr_buf), buf_size);
+            LV_ASSERT_MEM(tmp);
+            if(tmp == NULL) return NULL;
+            LV_GC_ROOT(_lv_font_decompr_buf) = tmp;
+        }
+
+        uint8_t * line_buf = _lv_mem_buf_get(gdsc->box_w);
+        if(line_buf == NULL) return NULL;
+
+        bool prefilter = fdsc->bitmap_format == LV_FONT_FMT_TXT_COMPRESSED ? true : false;
+        _lv_font_fmt_txt_decompress(bitmap, LV_GC_ROOT(_lv_font_decompr_buf), gdsc->box_w, gdsc->box_h,
+                                    (uint8_t)fdsc->bpp, prefilter, line_buf);
+        _lv_mem_buf_release(line_buf);
+        return LV_GC_ROOT(_lv_font_decompr_buf);
+#else /* !LV_USE_FONT_COMPRESSED */
+        LV_UNUSED(gdsc);
+        return NULL;
+#endif
+    }
+}
+
+#if LV_USE_FONT_COMPRESSED
+/**
+ * Decompress a glyph's bitmap. Reentrant as it uses only the given buffers.
+ * @param in the compressed bitmap
+ * @param out buffer to store the result. `(w * h * bpp + 7) / 8` bytes are written (bpp = 3 is written as bpp = 4)
+ * @param w width of the glyph
+ * @param h height of the glyph
+ * @param bpp bit per pixel (1, 2, 3 or 4)
+ * @param prefilter true: the lines are XORed
+ * @param line_buf buffer for one line of pixels with at least `w` bytes
+ */
+void _lv_font_fmt_txt_decompress(const uint8_t * in, uint8_t * out, lv_coord_t w, lv_coord_t h, uint8_t bpp,
+                                 bool prefilter, uint8_t * line_buf)
+{
+    /*Upscale 3 bpp values to 4 bpp*/
+    static const uint8_t bpp3_to_4[8] = {0, 2, 4, 6, 9, 11, 13, 15};
+
+    rle_dsc_t rle;
+    rle.in = in;
+    rle.buf = 0;
+    rle.buf_bits = 0;
+    rle.bpp = bpp;
+    rle.prev_v = 0xFF;      /*Differs from every pixel value so the first pixel won't start a repetition*/
+    rle.cnt = 0;
+    rle.state = RLE_STATE_SINGLE;
+
+    uint8_t wr_size = bpp == 3 ? 4 : bpp;
+    uint32_t wr_buf = 0;
+    uint8_t wr_bits = 0;
+
+    lv_coord_t y;
+    lv_coord_t x;
+    for(y = 0; y < h; y++) {
+        /*With prefilter the line is XORed to the previous line which is still in `line_buf`*/
+        rle_decode_line(&rle, line_buf, w, prefilter && y > 0);
+
+        x = 0;
+        /*Write 2 pixels at once if the line starts on a byte boundary*/
+        if(bpp == 4 && wr_bits == 0) {
+            for(; x + 1 < w; x += 2) {
+                *out = (uint8_t)((line_buf[x] << 4) | line_buf[x + 1]);
+                out++;
+            }
+        }
+
+        /*Collect the pixels in `wr_buf` and write them by bytes*/
+        for(; x < w; x++) {
+            uint8_t v = bpp == 3 ? bpp3_to_4[line_buf[x]] : line_buf[x];
+            wr_buf = (wr_buf << wr_size) | v;
+            wr_bits += wr_size;
+            if(wr_bits >= 8) {
+                wr_bits -= 8;
+                *out = (uint8_t)(wr_buf >> wr_bits);
+                out++;
+            }
+        }
+    }
+
+    if(wr_bits) *out = (uint8_t)(wr_buf << (8 - wr_bits));
+}
+#endif /* LV_USE_FONT_COMPRESSED */
+
 /**
  * Free the allocated memories.
  */
@@ -334,232 +436,139 @@ static int32_t kern_pair_16_compare(const void * ref, const void * element)
 
 #if LV_USE_FONT_COMPRESSED
 /**
- * The compress a glyph's bitmap
- * @param in the compressed bitmap
- * @param out buffer to store the result
- * @param px_num number of pixels in the glyph (width * height)
- * @param bpp bit per pixel (bpp = 3 will be converted to bpp = 4)
- * @param prefilter true: the lines are XORed
+ * Load the next byte of the compressed stream into the bit buffer.
+ * At most one byte is loaded which is not needed yet, like the former byte based reader did.
+ * @param rle pointer to the decoder. `buf_bits` must be less than 8.
  */
-static void decompress(const uint8_t * in, uint8_t * out, lv_coord_t w, lv_coord_t h, uint8_t bpp, bool prefilter)
+static inline void rle_load(rle_dsc_t * rle)
 {
-    uint32_t wrp = 0;
-    uint8_t wr_size = bpp;
-    if(bpp == 3) wr_size = 4;
-
-    rle_init(in, bpp);
-
-    uint8_t * line_buf1 = _lv_mem_buf_get(w);
-
-    uint8_t * line_buf2 = NULL;
-
-    if(prefilter) {
-        line_buf2 = _lv_mem_buf_get(w);
-    }
-
-    decompress_line(line_buf1, w);
-
-    lv_coord_t y;
-    lv_coord_t x;
-
-    for(x = 0; x < w; x++) {
-        bits_write(out, wrp, line_buf1[x], bpp);
-        wrp += wr_size;
-    }
-
-    for(y = 1; y < h; y++) {
-        if(prefilter) {
-            decompress_line(line_buf2, w);
-
-            for(x = 0; x < w; x++) {
-                line_buf1[x] = line_buf2[x] ^ line_buf1[x];
-                bits_write(out, wrp, line_buf1[x], bpp);
-                wrp += wr_size;
-            }
-        }
-        else {
-            decompress_line(line_buf1, w);
-
-            for(x = 0; x < w; x++) {
-                bits_write(out, wrp, line_buf1[x], bpp);
-                wrp += wr_size;
-            }
-        }
-    }
-
-    _lv_mem_buf_release(line_buf1);
-    _lv_mem_buf_release(line_buf2);
+    rle->buf |= (uint32_t)(*rle->in) << (24 - rle->buf_bits);
+    rle->in++;
+    rle->buf_bits += 8;
 }
 
 /**
- * Decompress one line. Store one pixel per byte
- * @param out output buffer
- * @param w width of the line in pixel count
+ * Read bits from the compressed stream.
+ * @param rle pointer to the decoder
+ * @param len number of bits to read (must be <= 8).
+ * @return the read bits
  */
-static inline void decompress_line(uint8_t * out, lv_coord_t w)
+static inline uint32_t rle_get_bits(rle_dsc_t * rle, uint32_t len)
 {
-    lv_coord_t i;
-    for(i = 0; i < w; i++) {
-        out[i] = rle_next();
-    }
+    if(rle->buf_bits < len) rle_load(rle);
+
+    uint32_t v = rle->buf >> (32 - len);
+    rle->buf <<= len;
+    rle->buf_bits -= len;
+    return v;
 }
 
 /**
- * Read bits from an input buffer. The read can cross byte boundary.
- * @param in the input buffer to read from.
- * @param bit_pos index of the first bit to read.
- * @param len number of bits to read (must be <= 8).
- * @return the read bits
+ * Write the same value to the pixels of a line
+ * @param out pointer to the first pixel
+ * @param len number of pixels
+ * @param v the value
+ * @param xor_prev true: XOR `v` to the pixels; false: overwrite the pixels
  */
-static inline uint8_t get_bits(const uint8_t * in, uint32_t bit_pos, uint8_t len)
+static inline void rle_fill(uint8_t * out, uint32_t len, uint8_t v, bool xor_prev)
 {
-    uint8_t bit_mask;
-    switch(len) {
-        case 1:
-            bit_mask = 0x1;
-            break;
-        case 2:
-            bit_mask = 0x3;
-            break;
-        case 3:
-            bit_mask = 0x7;
-            break;
-        case 4:
-            bit_mask = 0xF;
-            break;
-        case 8:
-            bit_mask = 0xFF;
-            break;
-        default:
-            bit_mask = (uint16_t)((uint16_t) 1 << len) - 1;
-    }
-
-    uint32_t byte_pos = bit_pos >> 3;
-    bit_pos = bit_pos & 0x7;
-
-    if(bit_pos + len >= 8) {
-        uint16_t in16 = (in[byte_pos] << 8) + in[byte_pos + 1];
-        return (in16 >> (16 - bit_pos - len)) & bit_mask;
+    uint32_t i;
+    if(xor_prev) {
+        /*XOR with 0 leaves the previous line as it is*/
+        if(v == 0) return;
+        for(i = 0; i < len; i++) out[i] ^= v;
     }
     else {
-        return (in[byte_pos] >> (8 - bit_pos - len)) & bit_mask;
+        for(i = 0; i < len; i++) out[i] = v;
     }
 }
 
 /**
- * Write `val` data to `bit_pos` position of `out`. The write can NOT cross byte boundary.
- * @param out buffer where to write
- * @param bit_pos bit index to write
- * @param val value to write
- * @param len length of bits to write from `val`. (Counted from the LSB).
- * @note `len == 3` will be converted to `len = 4` and `val` will be upscaled too
+ * Decompress one line. Store one pixel per byte.
+ * @param rle_p pointer to the decoder
+ * @param out output buffer
+ * @param w width of the line in pixel count
+ * @param xor_prev true: XOR the pixels to the content of `out` (the previous line); false: overwrite `out`
  */
-static inline void bits_write(uint8_t * out, uint32_t bit_pos, uint8_t val, uint8_t len)
-{
-    if(len == 3) {
-        len = 4;
-        switch(val) {
-            case 0:
-                val = 0;
-                break;
-            case 1:
-                val = 2;
-                break;
-            case 2:
-                val = 4;
-                break;
-            case 3:
-                val = 6;
-                break;
-            case 4:
-                val = 9;
-                break;
-            case 5:
-                val = 11;
-                break;
-            case 6:
-                val = 13;
-                break;
-            case 7:
-                val = 15;
-                break;
-        }
-    }
-
-    uint16_t byte_pos = bit_pos >> 3;
-    bit_pos = bit_pos & 0x7;
-    bit_pos = 8 - bit_pos - len;
-
-    uint8_t bit_mask = (uint16_t)((uint16_t) 1 << len) - 1;
-    out[byte_pos] &= ((~bit_mask) << bit_pos);
-    out[byte_pos] |= (val << bit_pos);
-}
-
-static inline void rle_init(const uint8_t * in,  uint8_t bpp)
-{
-    rle_in = in;
-    rle_bpp = bpp;
-    rle_state = RLE_STATE_SINGLE;
-    rle_rdp = 0;
-    rle_prev_v = 0;
-    rle_cnt = 0;
-}
-
-static inline uint8_t rle_next(void)
+static void rle_decode_line(rle_dsc_t * rle_p, uint8_t * out, lv_coord_t w, bool xor_prev)
 {
-    uint8_t v = 0;
-    uint8_t ret = 0;
-
-    if(rle_state == RLE_STATE_SINGLE) {
-        ret = get_bits(rle_in, rle_rdp, rle_bpp);
-        if(rle_rdp != 0 && rle_prev_v == ret) {
-            rle_cnt = 0;
-            rle_state = RLE_STATE_REPEATE;
+    /*Work on a local copy which can be kept in registers as `out` might alias with `rle_p`*/
+    rle_dsc_t rle_local = *rle_p;
+    rle_dsc_t * rle = &rle_local;
+
+    uint32_t len = (uint32_t)w;
+    uint32_t x = 0;
+    while(x < len) {
+        uint32_t v;
+        if(rle->state == RLE_STATE_SINGLE) {
+            v = rle_get_bits(rle, rle->bpp);
+            if(rle->prev_v == v) {
+                rle->cnt = 0;
+                rle->state = RLE_STATE_REPEATE;
+            }
         }
-
-        rle_prev_v = ret;
-        rle_rdp += rle_bpp;
-    }
-    else if(rle_state == RLE_STATE_REPEATE) {
-        v = get_bits(rle_in, rle_rdp, 1);
-        rle_cnt++;
-        rle_rdp += 1;
-        if(v == 1) {
-            ret = rle_prev_v;
-            if(rle_cnt == 11) {
-                rle_cnt = get_bits(rle_in, rle_rdp, 6);
-                rle_rdp += 6;
-                if(rle_cnt != 0) {
-                    rle_state = RLE_STATE_COUNTER;
-                }
-                else {
-                    ret = get_bits(rle_in, rle_rdp, rle_bpp);
-                    rle_prev_v = ret;
-                    rle_rdp += rle_bpp;
-                    rle_state = RLE_STATE_SINGLE;
+        else if(rle->state == RLE_STATE_REPEATE) {
+            /*Every 1 bit is a repetition till a 0 bit or the 11th bit. Process the 1 bits of the buffer at once.*/
+            if(rle->buf_bits < 8) rle_load(rle);
+
+            uint32_t max = 11 - rle->cnt;
+            if(max > len - x) max = len - x;
+            if(max > rle->buf_bits) max = rle->buf_bits;
+
+            uint32_t ones = rle_lead_ones[rle->buf >> 24];
+            if(ones == 8) ones += rle_lead_ones[(rle->buf >> 16) & 0xFF];
+            if(ones > max) ones = max;
+
+            rle->buf <<= ones;
+            rle->buf_bits -= ones;
+            rle->cnt += ones;
+            rle_fill(&out[x], ones, (uint8_t)rle->prev_v, xor_prev);
+            x += ones;
+
+            /*End of the line or the buffer*/
+            if(ones == max && rle->cnt < 11) continue;
+
+            if(ones == max) {
+                /*11 repetitions are followed by a counter*/
+                rle->cnt = rle_get_bits(rle, 6);
+                if(rle->cnt != 0) {
+                    rle->state = RLE_STATE_COUNTER;
+                    continue;
                 }
+
+                /*0 counter: the last repetition is replaced by a new value*/
+                x--;
+                if(xor_prev) out[x] ^= (uint8_t)rle->prev_v;
+            }
+            else {
+                /*Skip the 0 bit which marks the end of repetitions*/
+                rle->buf <<= 1;
+                rle->buf_bits--;
             }
+
+            v = rle_get_bits(rle, rle->bpp);
+            rle->state = RLE_STATE_SINGLE;
         }
         else {
-            ret = get_bits(rle_in, rle_rdp, rle_bpp);
-            rle_prev_v = ret;
-            rle_rdp += rle_bpp;
-            rle_state = RLE_STATE_SINGLE;
+            /*`cnt - 1` repetitions are followed by a new value*/
+            uint32_t rep = rle->cnt - 1;
+            if(rep > len - x) rep = len - x;
+            rle->cnt -= rep;
+            rle_fill(&out[x], rep, (uint8_t)rle->prev_v, xor_prev);
+            x += rep;
+            if(x == len) break;
+
+            v = rle_get_bits(rle, rle->bpp);
+            rle->state = RLE_STATE_SINGLE;
         }
 
-    }
-    else if(rle_state == RLE_STATE_COUNTER) {
-        ret = rle_prev_v;
-        rle_cnt--;
-        if(rle_cnt == 0) {
-            ret = get_bits(rle_in, rle_rdp, rle_bpp);
-            rle_prev_v = ret;
-            rle_rdp += rle_bpp;
-            rle_state = RLE_STATE_SINGLE;
-        }
+        rle->prev_v = v;
+        if(xor_prev) out[x] ^= (uint8_t)v;
+        else out[x] = (uint8_t)v;
+        x++;
     }
 
-    return ret;
+    *rle_p = rle_local;
 }
 #endif /* LV_USE_FONT_COMPRESSED */
 
@@ -215,6 +215,39 @@ const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t lett
 bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t * dsc_out, uint32_t unicode_letter,
                                    uint32_t unicode_letter_next);
 
+/**
+ * Get the glyph ID of a letter in a font with LittlevGL's native format.
+ * @param font pointer to font
+ * @param letter an UNICODE letter code
+ * @return the glyph ID (index in `glyph_dsc`) or 0 if the letter was not found
+ */
+uint32_t _lv_font_fmt_txt_get_glyph_id(const lv_font_t * font, uint32_t letter);
+
+/**
+ * Convert the stored bitmap of a glyph to a drawable one (i.e. decompress it if required)
+ * @param fdsc descriptor of the font
+ * @param gdsc descriptor of the glyph
+ * @param bitmap the stored bitmap of the glyph. Needs not to be in `fdsc->glyph_bitmap`.
+ * @return pointer to the drawable bitmap or NULL on error
+ */
+const uint8_t * _lv_font_fmt_txt_decode_bitmap(const lv_font_fmt_txt_dsc_t * fdsc,
+                                               const lv_font_fmt_txt_glyph_dsc_t * gdsc, const uint8_t * bitmap);
+
+#if LV_USE_FONT_COMPRESSED
+/**
+ * Decompress a glyph's bitmap. Reentrant as it uses only the given buffers.
+ * @param in the compressed bitmap
+ * @param out buffer to store the result. `(w * h * bpp + 7) / 8` bytes are written (bpp = 3 is written as bpp = 4)
+ * @param w width of the glyph
+ * @param h height of the glyph
+ * @param bpp bit per pixel (1, 2, 3 or 4)
+ * @param prefilter true: the lines are XORed
+ * @param line_buf buffer for one line of pixels with at least `w` bytes
+ */
+void _lv_font_fmt_txt_decompress(const uint8_t * in, uint8_t * out, lv_coord_t w, lv_coord_t h, uint8_t bpp,
+                                 bool prefilter, uint8_t * line_buf);
+#endif
+
 /**
  * Free the allocated memories.
  */
@@ -62,11 +62,37 @@ typedef struct cmap_table_bin {
     uint8_t padding;
 } cmap_table_bin_t;
 
+typedef struct {
+    uint32_t gid;       /*Glyph ID stored in the slot. 0: unused*/
+    uint32_t life;      /*Time stamp of the last usage*/
+} glyph_cache_entry_t;
+
+/*Descriptor of fonts loaded by `lv_font_load_paged`. `fmt` must be the first element
+ *because the `lv_font_fmt_txt` functions see this struct as `lv_font_fmt_txt_dsc_t`*/
+typedef struct {
+    lv_font_fmt_txt_dsc_t fmt;
+    lv_fs_file_t file;              /*The font file, kept open to read the bitmaps*/
+    const uint8_t * map;            /*Start of the file if the driver could map it*/
+    uint32_t * loca;                /*Offset of the glyphs in the "glyf" table, +1 element for the table's end*/
+    uint32_t glyph_start;           /*Start of the "glyf" table in the file*/
+    uint32_t glyph_cnt;             /*Number of glyphs (elements in `loca` - 1)*/
+    uint8_t dsc_bits;               /*Size of the glyph descriptor before the bitmaps in bits*/
+    uint8_t * cache_buf;            /*`cache_cnt` slots with `slot_size` bytes*/
+    glyph_cache_entry_t * cache;
+    uint32_t slot_size;
+    uint16_t cache_cnt;
+    uint32_t cache_life;
+    lv_font_paged_info_t info;
+} font_paged_dsc_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static bit_iterator_t init_bit_iterator(lv_fs_file_t * fp);
-static bool lvgl_load_font(lv_fs_file_t * fp, lv_font_t * font);
+static bool lvgl_load_font(lv_fs_file_t * fp, lv_font_t * font, font_paged_dsc_t * paged);
+static bool init_paged_cache(font_paged_dsc_t * paged, uint32_t cache_size);
+static const uint8_t * get_bitmap_paged(const lv_font_t * font, uint32_t unicode_letter);
+static uint32_t get_resident_size(const lv_font_t * font);
 int32_t load_kern(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc, uint8_t format, uint32_t start);
 
 static int read_bits_signed(bit_iterator_t * it, int n_bits, lv_fs_res_t * res);
@@ -96,7 +122,7 @@ lv_font_t * lv_font_load(const char * font_name)
     lv_fs_res_t res = lv_fs_open(&file, font_name, LV_FS_MODE_RD);
 
     if(res == LV_FS_RES_OK) {
-        success = lvgl_load_font(&file, font);
+        success = lvgl_load_font(&file, font, NULL);
 
         if(!success) {
             LV_LOG_WARN("Error loading font file: %s\n", font_name);
@@ -115,6 +141,76 @@ lv_font_t * lv_font_load(const char * font_name)
     return font;
 }
 
+/**
+ * Loads a `lv_font_t` object from a binary font file but keep only the header, the character maps,
+ * the glyph descriptors and the kerning in the memory. The bitmaps of the glyphs are read from the file
+ * when they are drawn and kept in a cache. If the file system driver can map the file
+ * (see `lv_fs_map`) the bitmaps are used directly from there.
+ * @param font_name filename where the font file is located. The file is kept open until `lv_font_free`
+ * @param cache_size size of the glyph bitmap cache in bytes. At least one glyph is cached.
+ * @return a pointer to the font or NULL in case of error
+ */
+lv_font_t * lv_font_load_paged(const char * font_name, uint32_t cache_size)
+{
+    uint32_t start = lv_tick_get();
+
+    lv_font_t * font = lv_mem_alloc(sizeof(lv_font_t));
+    LV_ASSERT_MEM(font);
+    if(font == NULL) return NULL;
+    _lv_memset_00(font, sizeof(lv_font_t));
+
+    font_paged_dsc_t * paged = lv_mem_alloc(sizeof(font_paged_dsc_t));
+    LV_ASSERT_MEM(paged);
+    if(paged == NULL) {
+        lv_mem_free(font);
+        return NULL;
+    }
+    _lv_memset_00(paged, sizeof(font_paged_dsc_t));
+    font->dsc = paged;
+    font->get_glyph_bitmap = get_bitmap_paged;
+
+    lv_fs_res_t res = lv_fs_open(&paged->file, font_name, LV_FS_MODE_RD);
+    if(res != LV_FS_RES_OK) {
+        lv_mem_free(paged);
+        lv_mem_free(font);
+        return NULL;
+    }
+
+    const void * map;
+    if(lv_fs_map(&paged->file, &map) == LV_FS_RES_OK) paged->map = map;
+
+    /*`lvgl_load_font` overwrites `get_glyph_bitmap`*/
+    bool success = lvgl_load_font(&paged->file, font, paged);
+    font->get_glyph_bitmap = get_bitmap_paged;
+    if(success) success = init_paged_cache(paged, cache_size);
+
+    if(!success) {
+        LV_LOG_WARN("Error loading font file: %s\n", font_name);
+        lv_font_free(font);
+        return NULL;
+    }
+
+    paged->info.mapped = paged->map ? 1 : 0;
+    paged->info.resident_size = get_resident_size(font);
+    paged->info.load_time = lv_tick_elaps(start);
+
+    return font;
+}
+
+/**
+ * Get the load time, memory usage and cache statistics of a font loaded by `lv_font_load_paged()`
+ * @param font lv_font_t object created by the lv_font_load_paged function
+ * @param info store the result here
+ */
+void lv_font_get_paged_info(const lv_font_t * font, lv_font_paged_info_t * info)
+{
+    _lv_memset_00(info, sizeof(lv_font_paged_info_t));
+    if(font == NULL || font->get_glyph_bitmap != get_bitmap_paged) return;
+
+    font_paged_dsc_t * paged = (font_paged_dsc_t *) font->dsc;
+    *info = paged->info;
+}
+
 /**
  * Frees the memory allocated by the `lv_font_load()` function
  * @param font lv_font_t object created by the lv_font_load function
@@ -177,6 +273,14 @@ void lv_font_free(lv_font_t * font)
             if(NULL != dsc->glyph_dsc) {
                 lv_mem_free((void *) dsc->glyph_dsc);
             }
+
+            if(font->get_glyph_bitmap == get_bitmap_paged) {
+                font_paged_dsc_t * paged = (font_paged_dsc_t *) dsc;
+                if(NULL != paged->loca) lv_mem_free(paged->loca);
+                if(NULL != paged->cache) lv_mem_free(paged->cache);
+                if(NULL != paged->cache_buf) lv_mem_free(paged->cache_buf);
+                if(NULL != paged->file.file_d) lv_fs_close(&paged->file);
+            }
             lv_mem_free(dsc);
         }
         lv_mem_free(font);
@@ -341,7 +445,8 @@ static int32_t load_cmaps(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc, u
 }
 
 static int32_t load_glyph(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc,
-                          uint32_t start, uint32_t * glyph_offset, uint32_t loca_count, font_header_bin_t * header)
+                          uint32_t start, uint32_t * glyph_offset, uint32_t loca_count, font_header_bin_t * header,
+                          font_paged_dsc_t * paged)
 {
     int32_t glyph_length = read_label(fp, start, "glyf");
     if(glyph_length < 0) {
@@ -419,6 +524,16 @@ static int32_t load_glyph(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc,
         }
     }
 
+    /*In paged mode only the offsets are stored. The bitmaps are read on demand*/
+    if(paged) {
+        glyph_offset[loca_count] = glyph_length;
+        paged->loca = glyph_offset;
+        paged->glyph_start = start;
+        paged->glyph_cnt = loca_count;
+        paged->dsc_bits = header->advance_width_bits + 2 * header->xy_bits + 2 * header->wh_bits;
+        return glyph_length;
+    }
+
     uint8_t * glyph_bmp = (uint8_t *) lv_mem_alloc(sizeof(uint8_t) * cur_bmp_size);
 
     font_dsc->glyph_bitmap = glyph_bmp;
@@ -481,14 +596,20 @@ static int32_t load_glyph(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc,
  * `lv_font_free` will assume that all non-null pointers are allocated and
  * should be freed.
  */
-static bool lvgl_load_font(lv_fs_file_t * fp, lv_font_t * font)
+static bool lvgl_load_font(lv_fs_file_t * fp, lv_font_t * font, font_paged_dsc_t * paged)
 {
-    lv_font_fmt_txt_dsc_t * font_dsc = (lv_font_fmt_txt_dsc_t *)
-                                       lv_mem_alloc(sizeof(lv_font_fmt_txt_dsc_t));
+    lv_font_fmt_txt_dsc_t * font_dsc;
+    if(paged) {
+        /*Already allocated and set by the caller*/
+        font_dsc = &paged->fmt;
+    }
+    else {
+        font_dsc = (lv_font_fmt_txt_dsc_t *) lv_mem_alloc(sizeof(lv_font_fmt_txt_dsc_t));
 
-    memset(font_dsc, 0, sizeof(lv_font_fmt_txt_dsc_t));
+        memset(font_dsc, 0, sizeof(lv_font_fmt_txt_dsc_t));
 
-    font->dsc = font_dsc;
+        font->dsc = font_dsc;
+    }
 
     /* header */
     int32_t header_length = read_label(fp, 0, "head");
@@ -563,9 +684,10 @@ static bool lvgl_load_font(lv_fs_file_t * fp, lv_font_t * font)
     /* glyph */
     uint32_t glyph_start = loca_start + loca_length;
     int32_t glyph_length = load_glyph(
-                               fp, font_dsc, glyph_start, glyph_offset, loca_count, &font_header);
+                               fp, font_dsc, glyph_start, glyph_offset, loca_count, &font_header, paged);
 
-    lv_mem_free(glyph_offset);
+    /*In paged mode `glyph_offset` is kept as `paged->loca`*/
+    if(paged == NULL || paged->loca != glyph_offset) lv_mem_free(glyph_offset);
 
     if(glyph_length < 0) {
         return false;
@@ -585,6 +707,172 @@ static bool lvgl_load_font(lv_fs_file_t * fp, lv_font_t * font)
     return kern_length >= 0;
 }
 
+/*
+ * Get the position and size of a glyph's stored bitmap in the file.
+ * If `dsc_bits` is not a multiple of 8 the bitmap starts in the middle of the first byte
+ * and `size` includes this partial byte too.
+ */
+static uint32_t get_paged_bitmap_pos(const font_paged_dsc_t * paged, uint32_t gid, uint32_t * size)
+{
+    uint32_t glyph_size = paged->loca[gid + 1] - paged->loca[gid];
+    uint32_t skip = paged->dsc_bits >> 3;
+    *size = glyph_size > skip ? glyph_size - skip : 0;
+    return paged->glyph_start + paged->loca[gid] + skip;
+}
+
+static bool init_paged_cache(font_paged_dsc_t * paged, uint32_t cache_size)
+{
+    /*Size the slots to the largest stored bitmap*/
+    uint32_t max_size = 1;
+    uint32_t i;
+    for(i = 1; i < paged->glyph_cnt; i++) {
+        uint32_t size;
+        get_paged_bitmap_pos(paged, i, &size);
+        if(size > max_size) max_size = size;
+    }
+
+    uint32_t cnt = cache_size / max_size;
+    if(cnt == 0) cnt = 1;
+    if(cnt > UINT16_MAX) cnt = UINT16_MAX;
+
+    paged->cache = lv_mem_alloc(cnt * sizeof(glyph_cache_entry_t));
+    LV_ASSERT_MEM(paged->cache);
+    if(paged->cache == NULL) return false;
+    _lv_memset_00(paged->cache, cnt * sizeof(glyph_cache_entry_t));
+
+    paged->cache_buf = lv_mem_alloc(cnt * max_size);
+    LV_ASSERT_MEM(paged->cache_buf);
+    if(paged->cache_buf == NULL) return false;
+
+    paged->cache_cnt = cnt;
+    paged->slot_size = max_size;
+    paged->info.cache_size = cnt * max_size;
+
+    return true;
+}
+
+/*
+ * Read the stored bitmap of a glyph from the file (or the mapped memory) to `buf`.
+ * Bitmaps not starting on a byte boundary are shifted to the first bit of `buf`.
+ */
+static bool read_paged_bitmap(font_paged_dsc_t * paged, uint32_t gid, uint8_t * buf)
+{
+    uint32_t size;
+    uint32_t pos = get_paged_bitmap_pos(paged, gid, &size);
+    if(size == 0) return false;
+
+    if(paged->map) {
+        _lv_memcpy(buf, &paged->map[pos], size);
+    }
+    else {
+        if(lv_fs_seek(&paged->file, pos) != LV_FS_RES_OK) return false;
+        if(lv_fs_read(&paged->file, buf, size, NULL) != LV_FS_RES_OK) return false;
+    }
+
+    uint8_t shift = paged->dsc_bits & 0x7;
+    if(shift) {
+        uint32_t k;
+        for(k = 0; k < size - 1; k++) {
+            buf[k] = (buf[k] << shift) | (buf[k + 1] >> (8 - shift));
+        }
+        buf[size - 1] = buf[size - 1] << shift;
+    }
+
+    return true;
+}
+
+/*
+ * Used as `get_glyph_bitmap` callback for fonts loaded by `lv_font_load_paged`
+ */
+static const uint8_t * get_bitmap_paged(const lv_font_t * font, uint32_t unicode_letter)
+{
+    if(unicode_letter == '\t') unicode_letter = ' ';
+
+    font_paged_dsc_t * paged = (font_paged_dsc_t *) font->dsc;
+    uint32_t gid = _lv_font_fmt_txt_get_glyph_id(font, unicode_letter);
+    if(!gid) return NULL;
+
+    const lv_font_fmt_txt_glyph_dsc_t * gdsc = &paged->fmt.glyph_dsc[gid];
+    if(gdsc->box_w * gdsc->box_h == 0) return NULL;
+
+    /*Zero copy if the file is mapped and the bitmap is byte aligned*/
+    if(paged->map && (paged->dsc_bits & 0x7) == 0) {
+        uint32_t size;
+        uint32_t pos = get_paged_bitmap_pos(paged, gid, &size);
+        paged->info.cache_hit++;
+        return _lv_font_fmt_txt_decode_bitmap(&paged->fmt, gdsc, &paged->map[pos]);
+    }
+
+    paged->cache_life++;
+
+    /*Search the glyph in the cache and find the least recently used slot too*/
+    uint16_t i;
+    uint16_t lru = 0;
+    for(i = 0; i < paged->cache_cnt; i++) {
+        if(paged->cache[i].gid == gid) {
+            paged->cache[i].life = paged->cache_life;
+            paged->info.cache_hit++;
+            return _lv_font_fmt_txt_decode_bitmap(&paged->fmt, gdsc, &paged->cache_buf[i * paged->slot_size]);
+        }
+
+        if(paged->cache[i].life < paged->cache[lru].life) lru = i;
+    }
+
+    paged->info.cache_miss++;
+
+    uint8_t * buf = &paged->cache_buf[lru * paged->slot_size];
+    if(!read_paged_bitmap(paged, gid, buf)) {
+        paged->cache[lru].gid = 0;
+        paged->cache[lru].life = 0;
+        return NULL;
+    }
+
+    paged->cache[lru].gid = gid;
+    paged->cache[lru].life = paged->cache_life;
+
+    return _lv_font_fmt_txt_decode_bitmap(&paged->fmt, gdsc, buf);
+}
+
+/*
+ * Sum the memory allocated for a font loaded by `lv_font_load_paged`.
+ * Follows the same structure as `lv_font_free`.
+ */
+static uint32_t get_resident_size(const lv_font_t * font)
+{
+    font_paged_dsc_t * paged = (font_paged_dsc_t *) font->dsc;
+    lv_font_fmt_txt_dsc_t * dsc = &paged->fmt;
+
+    uint32_t size = _lv_mem_get_size(font) + _lv_mem_get_size(paged);
+    size += _lv_mem_get_size(paged->file.file_d);
+
+    if(dsc->kern_classes == 0) {
+        const lv_font_fmt_txt_kern_pair_t * kern_dsc = dsc->kern_dsc;
+        if(kern_dsc) {
+            size += _lv_mem_get_size(kern_dsc) + _lv_mem_get_size(kern_dsc->glyph_ids) +
+                    _lv_mem_get_size(kern_dsc->values);
+        }
+    }
+    else {
+        const lv_font_fmt_txt_kern_classes_t * kern_dsc = dsc->kern_dsc;
+        if(kern_dsc) {
+            size += _lv_mem_get_size(kern_dsc) + _lv_mem_get_size(kern_dsc->class_pair_values) +
+                    _lv_mem_get_size(kern_dsc->left_class_mapping) + _lv_mem_get_size(kern_dsc->right_class_mapping);
+        }
+    }
+
+    int i;
+    for(i = 0; i < dsc->cmap_num; ++i) {
+        size += _lv_mem_get_size(dsc->cmaps[i].glyph_id_ofs_list) + _lv_mem_get_size(dsc->cmaps[i].unicode_list);
+    }
+    size += _lv_mem_get_size(dsc->cmaps);
+    size += _lv_mem_get_size(dsc->glyph_dsc);
+    size += _lv_mem_get_size(paged->loca);
+    size += _lv_mem_get_size(paged->cache);
+    size += _lv_mem_get_size(paged->cache_buf);
+
+    return size;
+}
+
 int32_t load_kern(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc, uint8_t format, uint32_t start)
 {
     int32_t kern_length = read_label(fp, start, "kern");
@@ -22,6 +22,16 @@ extern "C" {
  *      TYPEDEFS
  **********************/
 
+/** Load time, memory usage and cache statistics of a font loaded by `lv_font_load_paged`*/
+typedef struct {
+    uint32_t load_time;         /**< Time needed to load the font [ms]*/
+    uint32_t resident_size;     /**< Memory allocated while the font is loaded, glyph cache included [bytes]*/
+    uint32_t cache_size;        /**< Size of the glyph bitmap cache [bytes]*/
+    uint32_t cache_hit;         /**< Bitmaps served from the cache or from the mapped file*/
+    uint32_t cache_miss;        /**< Bitmaps read from the file*/
+    uint8_t mapped : 1;         /**< 1: the file is mapped by the driver and the bitmaps are not copied*/
+} lv_font_paged_info_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -29,6 +39,8 @@ extern "C" {
 #if LV_USE_FILESYSTEM
 
 lv_font_t * lv_font_load(const char * fontName);
+lv_font_t * lv_font_load_paged(const char * font_name, uint32_t cache_size);
+void lv_font_get_paged_info(const lv_font_t * font, lv_font_paged_info_t * info);
 void lv_font_free(lv_font_t * font);
 
 #endif
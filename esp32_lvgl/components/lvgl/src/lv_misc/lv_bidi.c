@@ -7,8 +7,10 @@
  *      INCLUDES
  *********************/
 #include <stddef.h>
+#include <string.h>
 #include "lv_bidi.h"
 #include "lv_txt.h"
+#include "lv_gc.h"
 #include "../lv_misc/lv_mem.h"
 
 #if LV_USE_BIDI
@@ -31,6 +33,15 @@ typedef struct {
     lv_bidi_dir_t dir;
 } bracket_stack_t;
 
+typedef struct {
+    const char * src;       /*The line was processed from here. Only compared, never dereferenced*/
+    uint8_t * data;         /*`pos_conv`, the processed line and a copy of the original line*/
+    uint32_t len;           /*Length of the line in bytes*/
+    uint32_t size;          /*Memory used by the entry in bytes*/
+    uint16_t pos_conv_len;
+    lv_bidi_dir_t base_dir;
+} bidi_cache_entry_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
@@ -50,6 +61,8 @@ static lv_bidi_dir_t bracket_process(const char * txt, uint32_t next_pos, uint32
                                      lv_bidi_dir_t base_dir);
 static void fill_pos_conv(uint16_t * out, uint16_t len, uint16_t index);
 static uint32_t get_txt_len(const char * txt, uint32_t max_len);
+static void cache_drop(bidi_cache_entry_t * e);
+static void cache_shrink(uint32_t size);
 
 /**********************
  *  STATIC VARIABLES
@@ -58,6 +71,8 @@ static const uint8_t bracket_left[] = {"<({["};
 static const uint8_t bracket_right[] = {">)}]"};
 static bracket_stack_t br_stack[LV_BIDI_BRACKLET_DEPTH];
 static uint8_t br_stack_p;
+static uint32_t cache_size;
+static uint32_t cache_used;
 
 /**********************
  *      MACROS
@@ -305,10 +320,147 @@ void _lv_bidi_process_paragraph(const char * str_in, char * str_out, uint32_t le
     }
 }
 
+/**
+ * Initialize the cache of the bidi processed lines
+ */
+void _lv_bidi_cache_init(void)
+{
+    _lv_ll_init(&LV_GC_ROOT(_lv_bidi_cache_ll), sizeof(bidi_cache_entry_t));
+    cache_size = LV_BIDI_CACHE_SIZE;
+    cache_used = 0;
+}
+
+/**
+ * Get a bidi processed line from the cache or process and cache it if not found.
+ * @param str_in the line to process. Its address is part of the key so pass the same pointer
+ * for the same line (e.g. `&label_text[line_start]`)
+ * @param len length of the line in bytes
+ * @param base_dir base direction of the line
+ * @param pos_conv store the logical position of the characters here (see `_lv_bidi_process_paragraph`).
+ * Can be `NULL` if unused
+ * @return the processed line or `NULL` if it can't be cached (e.g. too long or caching is disabled).
+ * The returned buffers are valid until the next call of a `_lv_bidi_cache_...` function.
+ */
+const char * _lv_bidi_cache_get(const char * str_in, uint32_t len, lv_bidi_dir_t base_dir, const uint16_t ** pos_conv)
+{
+    if(cache_size == 0) return NULL;
+
+    lv_ll_t * ll_p = &LV_GC_ROOT(_lv_bidi_cache_ll);
+    bidi_cache_entry_t * e;
+
+    /*The address only narrows the search. The content is compared too because
+     *static texts can be modified in place without invalidating the cache.*/
+    _LV_LL_READ(*ll_p, e) {
+        if(e->src != str_in || e->len != len || e->base_dir != base_dir) continue;
+
+        uint32_t pos_conv_size = e->pos_conv_len * sizeof(uint16_t);
+        if(memcmp(&e->data[pos_conv_size + len + 1], str_in, len) != 0) continue;
+
+        /*Keep the most recently used entries at the head*/
+        void * head = _lv_ll_get_head(ll_p);
+        if(e != head) _lv_ll_move_before(ll_p, e, head);
+
+        if(pos_conv) *pos_conv = (const uint16_t *)e->data;
+        return (const char *)&e->data[pos_conv_size];
+    }
+
+    /*Not cached yet. The position of a character is stored on 15 bits*/
+    uint32_t pos_conv_len = get_txt_len(str_in, len);
+    if(pos_conv_len > 0x7FFF) return NULL;
+
+    uint32_t pos_conv_size = pos_conv_len * sizeof(uint16_t);
+    uint32_t data_size = pos_conv_size + len + 1 + len;
+    uint32_t size = sizeof(bidi_cache_entry_t) + data_size;
+    if(size > cache_size) return NULL;
+
+    /*Make room before allocating to not fragment the heap with the entries to drop anyway*/
+    cache_shrink(cache_size - size);
+
+    uint8_t * data = lv_mem_alloc(data_size);
+    if(data == NULL) return NULL;
+
+    e = _lv_ll_ins_head(ll_p);
+    if(e == NULL) {
+        lv_mem_free(data);
+        return NULL;
+    }
+
+    e->src = str_in;
+    e->data = data;
+    e->len = len;
+    e->size = size;
+    e->pos_conv_len = pos_conv_len;
+    e->base_dir = base_dir;
+    cache_used += size;
+
+    char * str_out = (char *)&data[pos_conv_size];
+    _lv_bidi_process_paragraph(str_in, str_out, len, base_dir, (uint16_t *)data, pos_conv_len);
+    _lv_memcpy(&data[pos_conv_size + len + 1], str_in, len);
+
+    if(pos_conv) *pos_conv = (const uint16_t *)data;
+    return str_out;
+}
+
+/**
+ * Drop the cached lines of a text. Should be called when the text is modified or freed.
+ * @param txt pointer to the text. All lines processed from it are dropped.
+ * `NULL` to drop every cached line
+ */
+void _lv_bidi_cache_invalidate(const char * txt)
+{
+    if(cache_used == 0) return;
+
+    lv_ll_t * ll_p = &LV_GC_ROOT(_lv_bidi_cache_ll);
+    const char * txt_end = txt ? txt + strlen(txt) : NULL;
+
+    bidi_cache_entry_t * e = _lv_ll_get_head(ll_p);
+    while(e) {
+        bidi_cache_entry_t * e_next = _lv_ll_get_next(ll_p, e);
+        if(txt == NULL || (e->src >= txt && e->src <= txt_end)) cache_drop(e);
+        e = e_next;
+    }
+}
+
+/**
+ * Set the size of the bidi cache.
+ * @param size the new size in bytes. 0: to disable caching and free all cached lines
+ */
+void _lv_bidi_cache_set_size(uint32_t size)
+{
+    cache_size = size;
+    cache_shrink(size);
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
 
+/**
+ * Free a cache entry
+ * @param e pointer to the entry to drop
+ */
+static void cache_drop(bidi_cache_entry_t * e)
+{
+    cache_used -= e->size;
+    lv_mem_free(e->data);
+    _lv_ll_remove(&LV_GC_ROOT(_lv_bidi_cache_ll), e);
+    lv_mem_free(e);
+}
+
+/**
+ * Drop the least recently used entries until the cache fits into a given size
+ * @param size the cache should use at most this many bytes
+ */
+static void cache_shrink(uint32_t size)
+{
+    lv_ll_t * ll_p = &LV_GC_ROOT(_lv_bidi_cache_ll);
+    while(cache_used > size) {
+        bidi_cache_entry_t * e = _lv_ll_get_tail(ll_p);
+        if(e == NULL) break;
+        cache_drop(e);
+    }
+}
+
 /**
  * Get the next paragraph from a text
  * @param txt the text to process
@@ -106,6 +106,37 @@ uint16_t _lv_bidi_get_visual_pos(const char * str_in, char ** bidi_txt, uint16_t
 void _lv_bidi_process_paragraph(const char * str_in, char * str_out, uint32_t len, lv_bidi_dir_t base_dir,
                                 uint16_t * pos_conv_out, uint16_t pos_conv_len);
 
+/**
+ * Initialize the cache of the bidi processed lines
+ */
+void _lv_bidi_cache_init(void);
+
+/**
+ * Get a bidi processed line from the cache or process and cache it if not found.
+ * @param str_in the line to process. Its address is part of the key so pass the same pointer
+ * for the same line (e.g. `&label_text[line_start]`)
+ * @param len length of the line in bytes
+ * @param base_dir base direction of the line
+ * @param pos_conv store the logical position of the characters here (see `_lv_bidi_process_paragraph`).
+ * Can be `NULL` if unused
+ * @return the processed line or `NULL` if it can't be cached (e.g. too long or caching is disabled).
+ * The returned buffers are valid until the next call of a `_lv_bidi_cache_...` function.
+ */
+const char * _lv_bidi_cache_get(const char * str_in, uint32_t len, lv_bidi_dir_t base_dir, const uint16_t ** pos_conv);
+
+/**
+ * Drop the cached lines of a text. Should be called when the text is modified or freed.
+ * @param txt pointer to the text. All lines processed from it are dropped.
+ * `NULL` to drop every cached line
+ */
+void _lv_bidi_cache_invalidate(const char * txt);
+
+/**
+ * Set the size of the bidi cache.
+ * @param size the new size in bytes. 0: to disable caching and free all cached lines
+ */
+void _lv_bidi_cache_set_size(uint32_t size);
+
 /**********************
  *      MACROS
  **********************/
@@ -313,6 +313,29 @@ lv_fs_res_t lv_fs_size(lv_fs_file_t * file_p, uint32_t * size)
     return res;
 }
 
+/**
+ * Get a pointer to the whole content of a file if the driver can map it to the memory (e.g. files in flash).
+ * The pointer is valid until the file is closed.
+ * @param file_p pointer to a lv_fs_file_t variable
+ * @param buf_p pointer to a pointer to store the start of the mapped file
+ * @return LV_FS_RES_OK or any error from lv_fs_res_t enum. LV_FS_RES_NOT_IMP: the driver can't map files
+ */
+lv_fs_res_t lv_fs_map(lv_fs_file_t * file_p, const void ** buf_p)
+{
+    if(buf_p == NULL) return LV_FS_RES_INV_PARAM;
+    *buf_p = NULL;
+
+    if(file_p->drv == NULL) {
+        return LV_FS_RES_INV_PARAM;
+    }
+
+    if(file_p->drv->map_cb == NULL) return LV_FS_RES_NOT_IMP;
+
+    lv_fs_res_t res = file_p->drv->map_cb(file_p->drv, file_p->file_d, buf_p);
+
+    return res;
+}
+
 /**
  * Rename a file
  * @param oldname path to the file
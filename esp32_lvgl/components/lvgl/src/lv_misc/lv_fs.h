@@ -82,6 +82,8 @@ typedef struct _lv_fs_drv_t {
     lv_fs_res_t (*dir_read_cb)(struct _lv_fs_drv_t * drv, void * rddir_p, char * fn);
     lv_fs_res_t (*dir_close_cb)(struct _lv_fs_drv_t * drv, void * rddir_p);
 
+    lv_fs_res_t (*map_cb)(struct _lv_fs_drv_t * drv, void * file_p, const void ** buf_p);
+
 #if LV_USE_USER_DATA
     lv_fs_drv_user_data_t user_data; /**< Custom file user data */
 #endif
@@ -211,6 +213,15 @@ lv_fs_res_t lv_fs_trunc(lv_fs_file_t * file_p);
  */
 lv_fs_res_t lv_fs_size(lv_fs_file_t * file_p, uint32_t * size);
 
+/**
+ * Get a pointer to the whole content of a file if the driver can map it to the memory (e.g. files in flash).
+ * The pointer is valid until the file is closed.
+ * @param file_p pointer to a lv_fs_file_t variable
+ * @param buf_p pointer to a pointer to store the start of the mapped file
+ * @return LV_FS_RES_OK or any error from lv_fs_res_t enum. LV_FS_RES_NOT_IMP: the driver can't map files
+ */
+lv_fs_res_t lv_fs_map(lv_fs_file_t * file_p, const void ** buf_p);
+
 /**
  * Rename a file
  * @param oldname path to the file
@@ -17,6 +17,10 @@
     #include LV_MEM_CUSTOM_INCLUDE
 #endif
 
+/*The tracing versions are called via these macros. Here the real functions are defined*/
+#undef lv_mem_alloc
+#undef lv_mem_realloc
+
 /*********************
  *      DEFINES
  *********************/
@@ -35,6 +39,24 @@
     #define MEM_UNIT uint32_t
 #endif
 
+#if LV_MEM_CUSTOM == 0 && LV_MEM_TLSF
+    #define MEM_TLSF 1
+#else
+    #define MEM_TLSF 0
+#endif
+
+#if LV_MEM_SLAB_SIZE && LV_ENABLE_GC == 0
+    #define MEM_SLAB 1
+#else
+    #define MEM_SLAB 0
+#endif
+
+#if LV_MEM_TRACE && LV_ENABLE_GC == 0
+    #define MEM_TRACE 1
+#else
+    #define MEM_TRACE 0
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -45,7 +67,12 @@
 typedef union {
     struct {
         MEM_UNIT used : 1;    /* 1: if the entry is used*/
+#if MEM_TLSF
+        MEM_UNIT prev_free : 1; /* 1: if the previous entry is free. Its size is stored in its last word*/
+        MEM_UNIT d_size : 30; /* Size of the data*/
+#else
         MEM_UNIT d_size : 31; /* Size of the data*/
+#endif
     } s;
     MEM_UNIT header; /* The header (used + d_size)*/
 } lv_mem_header_t;
@@ -55,6 +82,51 @@ typedef struct {
     uint8_t first_data; /*First data byte in the allocated data (Just for easily create a pointer)*/
 } lv_mem_ent_t;
 
+#if MEM_TLSF
+/*A free entry is linked into the list of its size class*/
+typedef struct _lv_mem_free_t {
+    lv_mem_header_t header;
+    struct _lv_mem_free_t * next;
+    struct _lv_mem_free_t * prev;
+} lv_mem_free_t;
+#endif
+
+#if LV_MEM_BUF_ARENA_SIZE
+/*Header of the temporary buffers in the arena*/
+typedef struct {
+    uint32_t prev;  /*Offset of the header of the previous buffer*/
+    uint32_t used;
+} lv_mem_buf_hdr_t;
+#endif
+
+#if MEM_SLAB
+/*A free block of a slab is linked into the free list of its class*/
+typedef struct _lv_mem_slab_free_t {
+    lv_mem_header_t header;
+    struct _lv_mem_slab_free_t * next;
+} lv_mem_slab_free_t;
+
+typedef struct {
+    lv_mem_slab_free_t * free_head;
+    uint32_t block_cnt;
+    uint32_t used_cnt;
+    uint16_t size;
+    uint16_t page_cnt;
+} lv_mem_slab_t;
+#endif
+
+#if MEM_TRACE
+/*Record of a traced allocation. It's stored before the data of the allocation*/
+typedef struct _lv_mem_trace_t {
+    struct _lv_mem_trace_t * prev;
+    struct _lv_mem_trace_t * next;
+    const char * file;
+    uint32_t line;
+    uint32_t size;  /*Size of the data (without this record)*/
+    uint32_t id;    /*Counter of the allocations at the allocation*/
+} lv_mem_trace_t;
+#endif
+
 #endif /* LV_ENABLE_GC */
 
 #ifdef LV_ARCH_64
@@ -65,14 +137,95 @@ typedef struct {
 
 #define MEM_BUF_SMALL_SIZE 16
 
+#if MEM_SLAB
+/*The slab memory is given to the size classes in pages*/
+#ifndef LV_MEM_SLAB_PAGE_SIZE
+    #define LV_MEM_SLAB_PAGE_SIZE   1024
+#endif
+#define SLAB_PAGE_CNT       (LV_MEM_SLAB_SIZE / LV_MEM_SLAB_PAGE_SIZE)
+
+/*Larger memories are always allocated from the heap*/
+#define SLAB_SIZE_MAX       256
+
+#define SLAB_NONE           0xFF    /*No class in `slab_class_of_size`*/
+#endif
+
+#if MEM_TLSF
+/*Number of second level classes in a power of two size range*/
+#define TLSF_SL_LOG2        3
+#define TLSF_SL_CNT         (1U << TLSF_SL_LOG2)
+
+#ifdef LV_ARCH_64
+    #define TLSF_ALIGN_LOG2 3
+#else
+    #define TLSF_ALIGN_LOG2 2
+#endif
+
+/*The sizes below `TLSF_SMALL_SIZE` are in the first first level class with linear steps*/
+#define TLSF_FL_SHIFT       (TLSF_SL_LOG2 + TLSF_ALIGN_LOG2)
+#define TLSF_SMALL_SIZE     (1U << TLSF_FL_SHIFT)
+
+/*All the entries are smaller than `1 << TLSF_FL_MAX`*/
+#if LV_MEM_SIZE <= (1UL << 12)
+    #define TLSF_FL_MAX     12
+#elif LV_MEM_SIZE <= (1UL << 16)
+    #define TLSF_FL_MAX     16
+#elif LV_MEM_SIZE <= (1UL << 20)
+    #define TLSF_FL_MAX     20
+#elif LV_MEM_SIZE <= (1UL << 24)
+    #define TLSF_FL_MAX     24
+#else
+    #define TLSF_FL_MAX     30
+#endif
+
+#define TLSF_FL_CNT         (TLSF_FL_MAX - TLSF_FL_SHIFT + 1)
+
+/*A free entry needs space for the list pointers and for its size at the end*/
+#define TLSF_MIN_SIZE       (sizeof(lv_mem_free_t) - sizeof(lv_mem_header_t) + sizeof(MEM_UNIT))
+#endif
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static void * mem_alloc(size_t size);
+static void mem_free(const void * data);
+static void * mem_realloc(void * data_p, size_t new_size);
+static uint32_t mem_get_size(const void * data);
+
 #if LV_MEM_CUSTOM == 0
     static lv_mem_ent_t * ent_get_next(lv_mem_ent_t * act_e);
+#if MEM_TLSF
+    static void * tlsf_alloc(uint32_t size);
+    static void tlsf_release(lv_mem_ent_t * e);
+    static void tlsf_trunc(lv_mem_ent_t * e, uint32_t size);
+    static lv_mem_free_t * tlsf_find(uint32_t size);
+    static void tlsf_insert(lv_mem_free_t * b);
+    static void tlsf_remove(lv_mem_free_t * b);
+    static void tlsf_mapping(uint32_t size, uint32_t * fl, uint32_t * sl);
+    static uint32_t tlsf_fls(uint32_t x);
+    static uint32_t tlsf_ffs(uint32_t x);
+#else
     static void * ent_alloc(lv_mem_ent_t * e, size_t size);
     static void ent_trunc(lv_mem_ent_t * e, size_t size);
 #endif
+#endif
+
+#if LV_MEM_BUF_ARENA_SIZE
+    static void buf_arena_pop(uint32_t mark, bool all);
+#endif
+
+#if MEM_TRACE
+    static void trace_link(lv_mem_trace_t * rec, uint32_t size, const char * file, uint32_t line);
+    static void trace_unlink(lv_mem_trace_t * rec);
+#endif
+
+#if MEM_SLAB
+    static void slab_init(void);
+    static void * slab_alloc(uint32_t size);
+    static void slab_free(lv_mem_ent_t * e);
+    static bool slab_add_page(lv_mem_slab_t * slab);
+    static lv_mem_slab_t * slab_get(const void * data);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -87,6 +240,27 @@ static uint32_t zero_mem; /*Give the address of this variable if 0 byte should b
     static uint32_t mem_max_size; /*Tracks the maximum total size of memory ever used from the internal heap*/
 #endif
 
+#if MEM_SLAB
+    static MEM_UNIT slab_mem[LV_MEM_SLAB_SIZE / sizeof(MEM_UNIT)];
+    static lv_mem_slab_t slabs[LV_MEM_SLAB_CLASS_MAX];
+    static uint8_t slab_page_class[SLAB_PAGE_CNT];  /*Index of the class in `slabs` for each used page*/
+    static uint16_t slab_page_next;                 /*The first page not given to a class yet*/
+    static uint8_t slab_class_of_size[SLAB_SIZE_MAX / (ALIGN_MASK + 1) + 1]; /*Smallest class for each aligned size*/
+    static uint8_t slab_cnt;
+    static uint32_t slab_fallback_cnt;
+    static uint32_t slab_refused_cnt;
+    static bool slab_refused[SLAB_SIZE_MAX / (ALIGN_MASK + 1) + 1]; /*The sizes whose class was refused*/
+
+    /*Classes for the common sizes. The objects and `ext_attr`s add their own classes*/
+    static const uint16_t slab_sizes_def[] = {8, 16, 24, 32, 48, 64, 96, 128, 192, 256};
+#endif
+
+#if MEM_TLSF
+    static uint32_t tlsf_fl_map;                    /*Bit `fl` is set if `tlsf_sl_map[fl]` is not empty*/
+    static uint8_t tlsf_sl_map[TLSF_FL_CNT];        /*Bit `sl` is set if `tlsf_heads[fl][sl]` is not empty*/
+    static lv_mem_free_t * tlsf_heads[TLSF_FL_CNT][TLSF_SL_CNT];
+#endif
+
 static uint8_t mem_buf1_32[MEM_BUF_SMALL_SIZE];
 static uint8_t mem_buf2_32[MEM_BUF_SMALL_SIZE];
 
@@ -94,6 +268,19 @@ static lv_mem_buf_t mem_buf_small[] = {{.p = mem_buf1_32, .size = MEM_BUF_SMALL_
     {.p = mem_buf2_32, .size = MEM_BUF_SMALL_SIZE, .used = 0}
 };
 
+#if LV_MEM_BUF_ARENA_SIZE
+    static MEM_UNIT buf_arena[LV_MEM_BUF_ARENA_SIZE / sizeof(MEM_UNIT)];
+    static uint32_t buf_arena_top;      /*Offset of the first free byte*/
+    static uint32_t buf_arena_last;     /*Offset of the header of the topmost buffer*/
+    static uint32_t buf_arena_max;      /*The most memory used at once*/
+    static uint32_t buf_arena_overflow_cnt; /*Number of buffers which didn't fit into the arena*/
+#endif
+
+#if MEM_TRACE
+    static lv_mem_trace_t * trace_head;  /*The live allocations, the newest first*/
+    static uint32_t trace_id;
+#endif
+
 /**********************
  *      MACROS
  **********************/
@@ -113,6 +300,14 @@ static lv_mem_buf_t mem_buf_small[] = {{.p = mem_buf1_32, .size = MEM_BUF_SMALL_
  */
 void _lv_mem_init(void)
 {
+#if MEM_SLAB
+    slab_init();
+#endif
+
+#if MEM_TRACE
+    trace_head = NULL;
+#endif
+
 #if LV_MEM_CUSTOM == 0
 
 #if LV_MEM_ADR == 0
@@ -127,6 +322,14 @@ void _lv_mem_init(void)
     full->header.s.used = 0;
     /*The total mem size reduced by the first header and the close patterns */
     full->header.s.d_size = LV_MEM_SIZE - sizeof(lv_mem_header_t);
+
+#if MEM_TLSF
+    tlsf_fl_map = 0;
+    _lv_memset_00(tlsf_sl_map, sizeof(tlsf_sl_map));
+    _lv_memset_00(tlsf_heads, sizeof(tlsf_heads));
+    full->header.s.prev_free = 0;
+    tlsf_insert((lv_mem_free_t *)full);
+#endif
 #endif
 }
 
@@ -136,11 +339,27 @@ void _lv_mem_init(void)
  */
 void _lv_mem_deinit(void)
 {
+#if MEM_SLAB
+    slab_init();
+#endif
+
+#if MEM_TRACE
+    trace_head = NULL;
+#endif
+
 #if LV_MEM_CUSTOM == 0
     lv_mem_ent_t * full = (lv_mem_ent_t *)work_mem;
     full->header.s.used = 0;
     /*The total mem size reduced by the first header and the close patterns */
     full->header.s.d_size = LV_MEM_SIZE - sizeof(lv_mem_header_t);
+
+#if MEM_TLSF
+    tlsf_fl_map = 0;
+    _lv_memset_00(tlsf_sl_map, sizeof(tlsf_sl_map));
+    _lv_memset_00(tlsf_heads, sizeof(tlsf_heads));
+    full->header.s.prev_free = 0;
+    tlsf_insert((lv_mem_free_t *)full);
+#endif
 #endif
 }
 
@@ -151,65 +370,11 @@ void _lv_mem_deinit(void)
  */
 void * lv_mem_alloc(size_t size)
 {
-    if(size == 0) {
-        return &zero_mem;
-    }
-
-    /*Round the size up to ALIGN_MASK*/
-    size = (size + ALIGN_MASK) & (~ALIGN_MASK);
-    void * alloc = NULL;
-
-#if LV_MEM_CUSTOM == 0
-    /*Use the built-in allocators*/
-    lv_mem_ent_t * e = NULL;
-
-    /* Search for a appropriate entry*/
-    do {
-        /* Get the next entry*/
-        e = ent_get_next(e);
-
-        /*If there is next entry then try to allocate there*/
-        if(e != NULL) {
-            alloc = ent_alloc(e, size);
-        }
-        /* End if there is not next entry OR the alloc. is successful*/
-    } while(e != NULL && alloc == NULL);
-
+#if MEM_TRACE
+    return _lv_mem_alloc_trace(size, NULL, 0);
 #else
-    /*Use custom, user defined malloc function*/
-#if LV_ENABLE_GC == 1 /*gc must not include header*/
-    alloc = LV_MEM_CUSTOM_ALLOC(size);
-#else                 /* LV_ENABLE_GC */
-    /*Allocate a header too to store the size*/
-    alloc = LV_MEM_CUSTOM_ALLOC(size + sizeof(lv_mem_header_t));
-    if(alloc != NULL) {
-        ((lv_mem_ent_t *)alloc)->header.s.d_size = size;
-        ((lv_mem_ent_t *)alloc)->header.s.used   = 1;
-
-        alloc = &((lv_mem_ent_t *)alloc)->first_data;
-    }
-#endif                /* LV_ENABLE_GC */
-#endif                /* LV_MEM_CUSTOM */
-
-#if LV_MEM_ADD_JUNK
-    if(alloc != NULL) _lv_memset(alloc, 0xaa, size);
-#endif
-
-    if(alloc == NULL) {
-        LV_LOG_WARN("Couldn't allocate memory");
-    }
-    else {
-#if LV_MEM_CUSTOM == 0
-        /* just a safety check, should always be true */
-        if((uintptr_t) alloc > (uintptr_t) work_mem) {
-            if((((uintptr_t) alloc - (uintptr_t) work_mem) + size) > mem_max_size) {
-                mem_max_size = ((uintptr_t) alloc - (uintptr_t) work_mem) + size;
-            }
-        }
+    return mem_alloc(size);
 #endif
-    }
-
-    return alloc;
 }
 
 /**
@@ -218,51 +383,16 @@ void * lv_mem_alloc(size_t size)
  */
 void lv_mem_free(const void * data)
 {
+#if MEM_TRACE
     if(data == &zero_mem) return;
     if(data == NULL) return;
 
-#if LV_MEM_ADD_JUNK
-    _lv_memset((void *)data, 0xbb, _lv_mem_get_size(data));
-#endif
-
-#if LV_ENABLE_GC == 0
-    /*e points to the header*/
-    lv_mem_ent_t * e = (lv_mem_ent_t *)((uint8_t *)data - sizeof(lv_mem_header_t));
-    e->header.s.used = 0;
+    lv_mem_trace_t * rec = (lv_mem_trace_t *)data - 1;
+    trace_unlink(rec);
+    data = rec;
 #endif
 
-#if LV_MEM_CUSTOM == 0
-#if LV_MEM_AUTO_DEFRAG
-    static uint16_t full_defrag_cnt = 0;
-    full_defrag_cnt++;
-    if(full_defrag_cnt < LV_MEM_FULL_DEFRAG_CNT) {
-        /* Make a simple defrag.
-         * Join the following free entries after this*/
-        lv_mem_ent_t * e_next;
-        e_next = ent_get_next(e);
-        while(e_next != NULL) {
-            if(e_next->header.s.used == 0) {
-                e->header.s.d_size += e_next->header.s.d_size + sizeof(e->header);
-            }
-            else {
-                break;
-            }
-            e_next = ent_get_next(e_next);
-        }
-    }
-    else {
-        full_defrag_cnt = 0;
-        lv_mem_defrag();
-
-    }
-#endif /*LV_MEM_AUTO_DEFRAG*/
-#else /*Use custom, user defined free function*/
-#if LV_ENABLE_GC == 0
-    LV_MEM_CUSTOM_FREE(e);
-#else
-    LV_MEM_CUSTOM_FREE((void *)data);
-#endif /*LV_ENABLE_GC*/
-#endif
+    mem_free(data);
 }
 
 /**
@@ -272,69 +402,84 @@ void lv_mem_free(const void * data)
  * @param new_size the desired new size in byte
  * @return pointer to the new memory
  */
-
-#if LV_ENABLE_GC == 0
-
 void * lv_mem_realloc(void * data_p, size_t new_size)
 {
-    /*Round the size up to ALIGN_MASK*/
-    new_size = (new_size + ALIGN_MASK) & (~ALIGN_MASK);
+#if MEM_TRACE
+    return _lv_mem_realloc_trace(data_p, new_size, NULL, 0);
+#else
+    return mem_realloc(data_p, new_size);
+#endif
+}
 
-    /*data_p could be previously freed pointer (in this case it is invalid)*/
-    if(data_p != NULL) {
-        lv_mem_ent_t * e = (lv_mem_ent_t *)((uint8_t *)data_p - sizeof(lv_mem_header_t));
-        if(e->header.s.used == 0) {
-            data_p = NULL;
-        }
-    }
+#if MEM_TRACE
+/**
+ * Allocate a memory and tag it with the place of the allocation.
+ * Called by `lv_mem_alloc()` if `LV_MEM_TRACE` is enabled.
+ * @param size size of the memory to allocate in bytes
+ * @param file name of the source file of the allocation
+ * @param line line of the allocation
+ * @return pointer to the allocated memory
+ */
+void * _lv_mem_alloc_trace(size_t size, const char * file, uint32_t line)
+{
+    if(size == 0) return &zero_mem;
 
-    uint32_t old_size = _lv_mem_get_size(data_p);
-    if(old_size == new_size) return data_p; /*Also avoid reallocating the same memory*/
+    lv_mem_trace_t * rec = mem_alloc(size + sizeof(lv_mem_trace_t));
+    if(rec == NULL) return NULL;
 
-#if LV_MEM_CUSTOM == 0
-    /* Truncate the memory if the new size is smaller. */
-    if(new_size < old_size) {
-        lv_mem_ent_t * e = (lv_mem_ent_t *)((uint8_t *)data_p - sizeof(lv_mem_header_t));
-        ent_trunc(e, new_size);
-        return &e->first_data;
-    }
-#endif
+    rec->id = trace_id;
+    trace_id++;
+    trace_link(rec, size, file, line);
+    return rec + 1;
+}
 
-    void * new_p;
-    new_p = lv_mem_alloc(new_size);
-    if(new_p == NULL) {
-        LV_LOG_WARN("Couldn't allocate memory");
-        return NULL;
+/**
+ * Reallocate a memory and tag it with the place of the reallocation.
+ * Called by `lv_mem_realloc()` if `LV_MEM_TRACE` is enabled.
+ * @param data_p pointer to an allocated memory
+ * @param new_size the desired new size in byte
+ * @param file name of the source file of the reallocation
+ * @param line line of the reallocation
+ * @return pointer to the new memory
+ */
+void * _lv_mem_realloc_trace(void * data_p, size_t new_size, const char * file, uint32_t line)
+{
+    lv_mem_trace_t * rec = NULL;
+    if(data_p != NULL && data_p != &zero_mem) {
+        rec = (lv_mem_trace_t *)data_p - 1;
+        /*data_p could be previously freed pointer (in this case it is invalid)*/
+        lv_mem_ent_t * e = (lv_mem_ent_t *)((uint8_t *)rec - sizeof(lv_mem_header_t));
+        if(e->header.s.used == 0) rec = NULL;
+        else trace_unlink(rec);
     }
 
-    if(data_p != NULL) {
-        /*Copy the old data to the new. Use the smaller size*/
-        if(old_size != 0 && new_size != 0) {
-            _lv_memcpy(new_p, data_p, LV_MATH_MIN(new_size, old_size));
-        }
-        lv_mem_free(data_p);
-    }
+    if(rec == NULL) return _lv_mem_alloc_trace(new_size, file, line);
 
-    return new_p;
-}
+    if(new_size == 0) {
+        mem_free(rec);
+        return &zero_mem;
+    }
 
-#else /* LV_ENABLE_GC */
+    lv_mem_trace_t * new_rec = mem_realloc(rec, new_size + sizeof(lv_mem_trace_t));
+    if(new_rec == NULL) {
+        /*The old memory is kept*/
+        trace_link(rec, rec->size, rec->file, rec->line);
+        return NULL;
+    }
 
-void * lv_mem_realloc(void * data_p, size_t new_size)
-{
-    void * new_p = LV_MEM_CUSTOM_REALLOC(data_p, new_size);
-    if(new_p == NULL) LV_LOG_WARN("Couldn't allocate memory");
-    return new_p;
+    /*Keep the ID to not report the old memories as new ones*/
+    trace_link(new_rec, new_size, file, line);
+    return new_rec + 1;
 }
-
-#endif /* lv_enable_gc */
+#endif
 
 /**
  * Join the adjacent free memory blocks
+ * @note with `LV_MEM_TLSF` the free blocks are always joined so it does nothing
  */
 void lv_mem_defrag(void)
 {
-#if LV_MEM_CUSTOM == 0
+#if LV_MEM_CUSTOM == 0 && MEM_TLSF == 0
     lv_mem_ent_t * e_free;
     lv_mem_ent_t * e_next;
     e_free = ent_get_next(NULL);
@@ -386,7 +531,16 @@ lv_res_t lv_mem_test(void)
         if(e8 + e->header.s.d_size > work_mem + LV_MEM_SIZE) {
             return LV_RES_INV;
         }
+#if MEM_TLSF
+        /*The next entry should know if this one is free*/
+        lv_mem_ent_t * next = ent_get_next(e);
+        if(next && next->header.s.prev_free != !e->header.s.used) {
+            return LV_RES_INV;
+        }
+        e = next;
+#else
         e = ent_get_next(e);
+#endif
     }
 #endif
     return LV_RES_OK;
@@ -413,10 +567,14 @@ void lv_mem_monitor(lv_mem_monitor_t * mon_p)
             if(e->header.s.d_size > mon_p->free_biggest_size) {
                 mon_p->free_biggest_size = e->header.s.d_size;
             }
+            if(e->header.s.d_size < LV_MEM_FREE_SMALL_SIZE) {
+                mon_p->free_small_size += e->header.s.d_size;
+            }
         }
         else {
             mon_p->used_cnt++;
         }
+        mon_p->header_size += sizeof(lv_mem_header_t);
 
         e = ent_get_next(e);
     }
@@ -434,31 +592,230 @@ void lv_mem_monitor(lv_mem_monitor_t * mon_p)
 }
 
 /**
- * Give the size of an allocated memory
- * @param data pointer to an allocated memory
- * @return the size of data memory in bytes
+ * Give information about the slab memory and the occupancy of its size classes
+ * @param mon_p pointer to a `lv_mem_slab_monitor_t` variable,
+ *              the result of the analysis will be stored here
  */
+void lv_mem_slab_monitor(lv_mem_slab_monitor_t * mon_p)
+{
+    _lv_memset_00(mon_p, sizeof(lv_mem_slab_monitor_t));
+#if MEM_SLAB
+    mon_p->total_size = SLAB_PAGE_CNT * LV_MEM_SLAB_PAGE_SIZE;
+    mon_p->free_size = (SLAB_PAGE_CNT - slab_page_next) * LV_MEM_SLAB_PAGE_SIZE;
+    mon_p->fallback_cnt = slab_fallback_cnt;
+    mon_p->refused_cnt = slab_refused_cnt;
+    mon_p->class_cnt = slab_cnt;
+    uint32_t i;
+    for(i = 0; i < slab_cnt; i++) {
+        mon_p->classes[i].size = slabs[i].size;
+        mon_p->classes[i].page_cnt = slabs[i].page_cnt;
+        mon_p->classes[i].block_cnt = slabs[i].block_cnt;
+        mon_p->classes[i].used_cnt = slabs[i].used_cnt;
+    }
+#endif
+}
 
-#if LV_ENABLE_GC == 0
-
-uint32_t _lv_mem_get_size(const void * data)
+/**
+ * Add a slab size class for the memories of a given size, e.g. for the objects of a type.
+ * Does nothing if the class already exists, the size is too large or there are `LV_MEM_SLAB_CLASS_MAX` classes.
+ * It's cheap to call again for an existing or refused class.
+ * @param size size of the memories in bytes
+ */
+void _lv_mem_slab_add(uint32_t size)
 {
-    if(data == NULL) return 0;
-    if(data == &zero_mem) return 0;
+#if MEM_SLAB
+#if MEM_TRACE
+    size += sizeof(lv_mem_trace_t);     /*The trace record is allocated too*/
+#endif
+    size = (size + ALIGN_MASK) & (~ALIGN_MASK);
+    if(size == 0 || size > SLAB_SIZE_MAX) return;
+
+    /*An existing class of this size is the smallest class for it*/
+    uint32_t size_i = size / (ALIGN_MASK + 1);
+    uint8_t cur = slab_class_of_size[size_i];
+    if(cur != SLAB_NONE && slabs[cur].size == size) return;
+
+    if(slab_cnt >= LV_MEM_SLAB_CLASS_MAX) {
+        /*Count and log a size only once*/
+        if(slab_refused[size_i] == false) {
+            LV_LOG_WARN("_lv_mem_slab_add: no more slab size classes, increase `LV_MEM_SLAB_CLASS_MAX`");
+            slab_refused[size_i] = true;
+            slab_refused_cnt++;
+        }
+        return;
+    }
 
-    lv_mem_ent_t * e = (lv_mem_ent_t *)((uint8_t *)data - sizeof(lv_mem_header_t));
+    _lv_memset_00(&slabs[slab_cnt], sizeof(lv_mem_slab_t));
+    slabs[slab_cnt].size = size;
 
-    return e->header.s.d_size;
-}
+    /*The new class is the smallest one for its size and for the smaller sizes until a smaller class*/
+    uint32_t s;
+    for(s = size; s > 0; s -= ALIGN_MASK + 1) {
+        uint8_t * c = &slab_class_of_size[s / (ALIGN_MASK + 1)];
+        if(*c != SLAB_NONE && slabs[*c].size < size) break;
+        *c = slab_cnt;
+    }
 
-#else /* LV_ENABLE_GC */
+    slab_cnt++;
+#else
+    (void)size; /*Unused*/
+#endif
+}
 
+/**
+ * Give the size of an allocated memory
+ * @param data pointer to an allocated memory
+ * @return the size of data memory in bytes
+ */
 uint32_t _lv_mem_get_size(const void * data)
 {
-    return LV_MEM_CUSTOM_GET_SIZE(data);
+#if MEM_TRACE
+    if(data == NULL) return 0;
+    if(data == &zero_mem) return 0;
+
+    return mem_get_size((lv_mem_trace_t *)data - 1) - sizeof(lv_mem_trace_t);
+#else
+    return mem_get_size(data);
+#endif
 }
 
-#endif /*LV_ENABLE_GC*/
+/**
+ * Get a mark of the allocations.
+ * `lv_mem_trace_get_tags()` can report only the allocations done after the mark.
+ * @return the mark (0 if `LV_MEM_TRACE` is disabled)
+ */
+uint32_t lv_mem_trace_mark(void)
+{
+#if MEM_TRACE
+    return trace_id;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Collect the live allocations by the place of the allocation.
+ * @param mark report only the allocations done after this mark from `lv_mem_trace_mark()`. 0: report all
+ * @param tags store the places here, the place with the most memory first
+ * @param tag_max size of `tags`. The other places are not reported.
+ * @return number of places stored in `tags`
+ */
+uint32_t lv_mem_trace_get_tags(uint32_t mark, lv_mem_trace_tag_t * tags, uint32_t tag_max)
+{
+#if MEM_TRACE
+    uint32_t tag_cnt = 0;
+    lv_mem_trace_t * rec;
+    for(rec = trace_head; rec != NULL; rec = rec->next) {
+        if(rec->id < mark) continue;
+
+        uint32_t i;
+        for(i = 0; i < tag_cnt; i++) {
+            if(tags[i].line == rec->line && tags[i].file == rec->file) break;
+        }
+        if(i == tag_cnt) {
+            if(tag_cnt >= tag_max) continue;
+            _lv_memset_00(&tags[i], sizeof(lv_mem_trace_tag_t));
+            tags[i].file = rec->file;
+            tags[i].line = rec->line;
+            tag_cnt++;
+        }
+
+        tags[i].cnt++;
+        tags[i].size += rec->size;
+
+        /*Size class of the histogram: <= 8, 16, 32 ... bytes*/
+        uint32_t h = 0;
+        while(h < LV_MEM_TRACE_HIST_CNT - 1 && rec->size > (8U << h)) h++;
+        tags[i].size_hist[h]++;
+    }
+
+    /*Sort by the size (there are only a few tags)*/
+    uint32_t i;
+    for(i = 1; i < tag_cnt; i++) {
+        lv_mem_trace_tag_t tmp = tags[i];
+        uint32_t j = i;
+        while(j > 0 && tags[j - 1].size < tmp.size) {
+            tags[j] = tags[j - 1];
+            j--;
+        }
+        tags[j] = tmp;
+    }
+
+    return tag_cnt;
+#else
+    (void)mark;     /*Unused*/
+    (void)tags;     /*Unused*/
+    (void)tag_max;  /*Unused*/
+    return 0;
+#endif
+}
+
+/**
+ * Draw the map of the built-in heap as a string.
+ * Every character is a part of the heap: '#' used, '.' free, '+' both used and free memory.
+ * @param buf store the map here, it will be '\0' terminated
+ * @param buf_size size of `buf`
+ * @return number of characters in the map (0 if `LV_MEM_TRACE` is disabled or `LV_MEM_CUSTOM` is used)
+ */
+uint32_t lv_mem_trace_frag_map(char * buf, uint32_t buf_size)
+{
+    if(buf_size == 0) return 0;
+    buf[0] = '\0';
+
+#if MEM_TRACE && LV_MEM_CUSTOM == 0
+    uint32_t cell_cnt = LV_MATH_MIN(buf_size - 1, LV_MEM_SIZE);
+    uint32_t cell_size = (LV_MEM_SIZE + cell_cnt - 1) / cell_cnt;
+    _lv_memset_00(buf, cell_cnt);
+
+    /*Set bit 0 of the cells with used and bit 1 of the cells with free memory*/
+    lv_mem_ent_t * e = ent_get_next(NULL);
+    while(e != NULL) {
+        uint32_t start = (uint8_t *)e - work_mem;
+        uint32_t end = start + sizeof(lv_mem_header_t) + e->header.s.d_size - 1;
+        char flag = e->header.s.used ? 1 : 2;
+        uint32_t c;
+        for(c = start / cell_size; c <= end / cell_size && c < cell_cnt; c++) {
+            buf[c] |= flag;
+        }
+        e = ent_get_next(e);
+    }
+
+    uint32_t c;
+    for(c = 0; c < cell_cnt; c++) {
+        if(buf[c] == 1) buf[c] = '#';
+        else if(buf[c] == 2) buf[c] = '.';
+        else buf[c] = '+';
+    }
+    buf[cell_cnt] = '\0';
+    return cell_cnt;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Log the places of the live allocations and the map of the heap with `LV_LOG_USER`
+ * @param mark report only the allocations done after this mark from `lv_mem_trace_mark()`. 0: report all
+ */
+void lv_mem_trace_dump(uint32_t mark)
+{
+#if MEM_TRACE && LV_USE_LOG
+    lv_mem_trace_tag_t tags[16];
+    uint32_t tag_cnt = lv_mem_trace_get_tags(mark, tags, sizeof(tags) / sizeof(tags[0]));
+    uint32_t i;
+    for(i = 0; i < tag_cnt; i++) {
+        LV_LOG_USER("%s:%d: %d bytes in %d allocations", tags[i].file ? tags[i].file : "?", tags[i].line,
+                    tags[i].size, tags[i].cnt);
+    }
+
+    char map[65];
+    if(lv_mem_trace_frag_map(map, sizeof(map))) {
+        LV_LOG_USER("heap: %s", map);
+    }
+#else
+    (void)mark;     /*Unused*/
+#endif
+}
 
 /**
  * Get a temporal buffer with the given size.
@@ -468,6 +825,23 @@ void * _lv_mem_buf_get(uint32_t size)
 {
     if(size == 0) return NULL;
 
+#if LV_MEM_BUF_ARENA_SIZE
+    /*Take the buffer from the top of the arena*/
+    uint32_t need = sizeof(lv_mem_buf_hdr_t) + ((size + ALIGN_MASK) & (~ALIGN_MASK));
+    if(buf_arena_top + need <= sizeof(buf_arena)) {
+        lv_mem_buf_hdr_t * hdr = (lv_mem_buf_hdr_t *)((uint8_t *)buf_arena + buf_arena_top);
+        hdr->prev = buf_arena_last;
+        hdr->used = 1;
+        buf_arena_last = buf_arena_top;
+        buf_arena_top += need;
+        if(buf_arena_top > buf_arena_max) buf_arena_max = buf_arena_top;
+        return hdr + 1;
+    }
+
+    /*Doesn't fit, get it from the other buffers*/
+    buf_arena_overflow_cnt++;
+#endif
+
     /*Try small static buffers first*/
     uint8_t i;
     if(size <= MEM_BUF_SMALL_SIZE) {
@@ -528,6 +902,16 @@ void * _lv_mem_buf_get(uint32_t size)
  */
 void _lv_mem_buf_release(void * p)
 {
+#if LV_MEM_BUF_ARENA_SIZE
+    if((uint8_t *)p >= (uint8_t *)buf_arena && (uint8_t *)p < (uint8_t *)buf_arena + sizeof(buf_arena)) {
+        lv_mem_buf_hdr_t * hdr = (lv_mem_buf_hdr_t *)p - 1;
+        hdr->used = 0;
+        /*The buffers are usually released in reverse order so the arena shrinks right away*/
+        buf_arena_pop(0, false);
+        return;
+    }
+#endif
+
     uint8_t i;
 
     /*Try small static buffers first*/
@@ -553,6 +937,11 @@ void _lv_mem_buf_release(void * p)
  */
 void _lv_mem_buf_free_all(void)
 {
+#if LV_MEM_BUF_ARENA_SIZE
+    buf_arena_top = 0;
+    buf_arena_last = 0;
+#endif
+
     uint8_t i;
     for(i = 0; i < sizeof(mem_buf_small) / sizeof(mem_buf_small[0]); i++) {
         mem_buf_small[i].used = 0;
@@ -568,6 +957,62 @@ void _lv_mem_buf_free_all(void)
     }
 }
 
+/**
+ * Get a mark of the temporary buffers.
+ * The buffers got after the mark can be released at once with `_lv_mem_buf_release_to()`.
+ * @return the mark
+ */
+uint32_t _lv_mem_buf_mark(void)
+{
+#if LV_MEM_BUF_ARENA_SIZE
+    return buf_arena_top;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Release all the temporary buffers got after a mark.
+ * Only the buffers in the arena (`LV_MEM_BUF_ARENA_SIZE`) are released, the others need `_lv_mem_buf_release()`.
+ * @param mark a mark from `_lv_mem_buf_mark()`
+ */
+void _lv_mem_buf_release_to(uint32_t mark)
+{
+#if LV_MEM_BUF_ARENA_SIZE
+    buf_arena_pop(mark, true);
+#else
+    (void)mark; /*Unused*/
+#endif
+}
+
+/**
+ * Get the most memory that was used from the arena of the temporary buffers at once.
+ * It helps to set `LV_MEM_BUF_ARENA_SIZE`.
+ * @return the high water mark in bytes (0 if the arena is not used)
+ */
+uint32_t lv_mem_buf_get_max_used(void)
+{
+#if LV_MEM_BUF_ARENA_SIZE
+    return buf_arena_max;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Get the number of temporary buffers which didn't fit into the arena of the temporary buffers.
+ * If it's not zero `LV_MEM_BUF_ARENA_SIZE` might be too small.
+ * @return the number of buffers got from the heap instead of the arena (0 if the arena is not used)
+ */
+uint32_t lv_mem_buf_get_overflow_cnt(void)
+{
+#if LV_MEM_BUF_ARENA_SIZE
+    return buf_arena_overflow_cnt;
+#else
+    return 0;
+#endif
+}
+
 #if LV_MEMCPY_MEMSET_STD == 0
 /**
  * Same as `memcpy` but optimized for 4 byte operation.
@@ -757,6 +1202,251 @@ LV_ATTRIBUTE_FAST_MEM void _lv_memset_ff(void * dst, size_t len)
  *   STATIC FUNCTIONS
  **********************/
 
+/**
+ * Allocate a memory dynamically
+ * @param size size of the memory to allocate in bytes
+ * @return pointer to the allocated memory
+ */
+static void * mem_alloc(size_t size)
+{
+    if(size == 0) {
+        return &zero_mem;
+    }
+
+    /*Round the size up to ALIGN_MASK*/
+    size = (size + ALIGN_MASK) & (~ALIGN_MASK);
+    void * alloc = NULL;
+
+#if MEM_SLAB
+    alloc = slab_alloc(size);
+    if(alloc != NULL) {
+#if LV_MEM_ADD_JUNK
+        _lv_memset(alloc, 0xaa, size);
+#endif
+        return alloc;
+    }
+#endif
+
+#if MEM_TLSF
+    alloc = tlsf_alloc(size);
+#elif LV_MEM_CUSTOM == 0
+    /*Use the built-in allocators*/
+    lv_mem_ent_t * e = NULL;
+
+    /* Search for a appropriate entry*/
+    do {
+        /* Get the next entry*/
+        e = ent_get_next(e);
+
+        /*If there is next entry then try to allocate there*/
+        if(e != NULL) {
+            alloc = ent_alloc(e, size);
+        }
+        /* End if there is not next entry OR the alloc. is successful*/
+    } while(e != NULL && alloc == NULL);
+
+#else
+    /*Use custom, user defined malloc function*/
+#if LV_ENABLE_GC == 1 /*gc must not include header*/
+    alloc = LV_MEM_CUSTOM_ALLOC(size);
+#else                 /* LV_ENABLE_GC */
+    /*Allocate a header too to store the size*/
+    alloc = LV_MEM_CUSTOM_ALLOC(size + sizeof(lv_mem_header_t));
+    if(alloc != NULL) {
+        ((lv_mem_ent_t *)alloc)->header.s.d_size = size;
+        ((lv_mem_ent_t *)alloc)->header.s.used   = 1;
+
+        alloc = &((lv_mem_ent_t *)alloc)->first_data;
+    }
+#endif                /* LV_ENABLE_GC */
+#endif                /* LV_MEM_CUSTOM */
+
+#if LV_MEM_ADD_JUNK
+    if(alloc != NULL) _lv_memset(alloc, 0xaa, size);
+#endif
+
+    if(alloc == NULL) {
+        LV_LOG_WARN("Couldn't allocate memory");
+    }
+    else {
+#if LV_MEM_CUSTOM == 0
+        /* just a safety check, should always be true */
+        if((uintptr_t) alloc > (uintptr_t) work_mem) {
+            if((((uintptr_t) alloc - (uintptr_t) work_mem) + size) > mem_max_size) {
+                mem_max_size = ((uintptr_t) alloc - (uintptr_t) work_mem) + size;
+            }
+        }
+#endif
+    }
+
+    return alloc;
+}
+
+/**
+ * Free an allocated data
+ * @param data pointer to an allocated memory
+ */
+static void mem_free(const void * data)
+{
+    if(data == &zero_mem) return;
+    if(data == NULL) return;
+
+#if LV_MEM_ADD_JUNK
+    _lv_memset((void *)data, 0xbb, mem_get_size(data));
+#endif
+
+#if LV_ENABLE_GC == 0
+    /*e points to the header*/
+    lv_mem_ent_t * e = (lv_mem_ent_t *)((uint8_t *)data - sizeof(lv_mem_header_t));
+    e->header.s.used = 0;
+#endif
+
+#if MEM_SLAB
+    if(slab_get(data)) {
+        slab_free(e);
+        return;
+    }
+#endif
+
+#if MEM_TLSF
+    tlsf_release(e);
+#elif LV_MEM_CUSTOM == 0
+#if LV_MEM_AUTO_DEFRAG
+    static uint16_t full_defrag_cnt = 0;
+    full_defrag_cnt++;
+    if(full_defrag_cnt < LV_MEM_FULL_DEFRAG_CNT) {
+        /* Make a simple defrag.
+         * Join the following free entries after this*/
+        lv_mem_ent_t * e_next;
+        e_next = ent_get_next(e);
+        while(e_next != NULL) {
+            if(e_next->header.s.used == 0) {
+                e->header.s.d_size += e_next->header.s.d_size + sizeof(e->header);
+            }
+            else {
+                break;
+            }
+            e_next = ent_get_next(e_next);
+        }
+    }
+    else {
+        full_defrag_cnt = 0;
+        lv_mem_defrag();
+
+    }
+#endif /*LV_MEM_AUTO_DEFRAG*/
+#else /*Use custom, user defined free function*/
+#if LV_ENABLE_GC == 0
+    LV_MEM_CUSTOM_FREE(e);
+#else
+    LV_MEM_CUSTOM_FREE((void *)data);
+#endif /*LV_ENABLE_GC*/
+#endif
+}
+
+/**
+ * Reallocate a memory with a new size. The old content will be kept.
+ * @param data pointer to an allocated memory.
+ * Its content will be copied to the new memory block and freed
+ * @param new_size the desired new size in byte
+ * @return pointer to the new memory
+ */
+#if LV_ENABLE_GC == 0
+
+static void * mem_realloc(void * data_p, size_t new_size)
+{
+    /*Round the size up to ALIGN_MASK*/
+    new_size = (new_size + ALIGN_MASK) & (~ALIGN_MASK);
+
+    /*data_p could be previously freed pointer (in this case it is invalid)*/
+    if(data_p != NULL) {
+        lv_mem_ent_t * e = (lv_mem_ent_t *)((uint8_t *)data_p - sizeof(lv_mem_header_t));
+        if(e->header.s.used == 0) {
+            data_p = NULL;
+        }
+    }
+
+    uint32_t old_size = mem_get_size(data_p);
+    if(old_size == new_size) return data_p; /*Also avoid reallocating the same memory*/
+
+#if MEM_SLAB
+    /*Keep the slab block if the new size still fits. (Always true when shrinking)*/
+    lv_mem_slab_t * slab = slab_get(data_p);
+    if(slab && new_size <= slab->size) {
+        lv_mem_ent_t * e = (lv_mem_ent_t *)((uint8_t *)data_p - sizeof(lv_mem_header_t));
+        e->header.s.d_size = new_size;
+        return data_p;
+    }
+#endif
+
+#if LV_MEM_CUSTOM == 0
+    /* Truncate the memory if the new size is smaller. */
+    if(new_size < old_size) {
+        lv_mem_ent_t * e = (lv_mem_ent_t *)((uint8_t *)data_p - sizeof(lv_mem_header_t));
+#if MEM_TLSF
+        tlsf_trunc(e, new_size);
+#else
+        ent_trunc(e, new_size);
+#endif
+        return &e->first_data;
+    }
+#endif
+
+    void * new_p;
+    new_p = mem_alloc(new_size);
+    if(new_p == NULL) {
+        LV_LOG_WARN("Couldn't allocate memory");
+        return NULL;
+    }
+
+    if(data_p != NULL) {
+        /*Copy the old data to the new. Use the smaller size*/
+        if(old_size != 0 && new_size != 0) {
+            _lv_memcpy(new_p, data_p, LV_MATH_MIN(new_size, old_size));
+        }
+        mem_free(data_p);
+    }
+
+    return new_p;
+}
+
+#else /* LV_ENABLE_GC */
+
+static void * mem_realloc(void * data_p, size_t new_size)
+{
+    void * new_p = LV_MEM_CUSTOM_REALLOC(data_p, new_size);
+    if(new_p == NULL) LV_LOG_WARN("Couldn't allocate memory");
+    return new_p;
+}
+
+#endif /* lv_enable_gc */
+
+/**
+ * Give the size of an allocated memory
+ * @param data pointer to an allocated memory
+ * @return the size of data memory in bytes
+ */
+#if LV_ENABLE_GC == 0
+
+static uint32_t mem_get_size(const void * data)
+{
+    if(data == NULL) return 0;
+    if(data == &zero_mem) return 0;
+
+    lv_mem_ent_t * e = (lv_mem_ent_t *)((uint8_t *)data - sizeof(lv_mem_header_t));
+
+    return e->header.s.d_size;
+}
+
+#else /* LV_ENABLE_GC */
+
+static uint32_t mem_get_size(const void * data)
+{
+    return LV_MEM_CUSTOM_GET_SIZE(data);
+}
+
+#endif /*LV_ENABLE_GC*/
+
 #if LV_MEM_CUSTOM == 0
 /**
  * Give the next entry after 'act_e'
@@ -780,6 +1470,7 @@ static lv_mem_ent_t * ent_get_next(lv_mem_ent_t * act_e)
     return next_e;
 }
 
+#if MEM_TLSF == 0
 /**
  * Try to do the real allocation with a given size
  * @param e try to allocate to this entry
@@ -829,4 +1520,372 @@ static void ent_trunc(lv_mem_ent_t * e, size_t size)
     }
 }
 
+#else /*MEM_TLSF*/
+
+/**
+ * Allocate from the free entry of a suitable size class
+ * @param size size of the new memory in bytes (already aligned)
+ * @return pointer to the allocated memory or NULL if there is no enough free memory
+ */
+static void * tlsf_alloc(uint32_t size)
+{
+    if(size < TLSF_MIN_SIZE) size = TLSF_MIN_SIZE;
+
+    lv_mem_free_t * b = tlsf_find(size);
+    if(b == NULL) return NULL;
+
+    tlsf_remove(b);
+    lv_mem_ent_t * e = (lv_mem_ent_t *)b;
+    e->header.s.used = 1;
+    lv_mem_ent_t * next = ent_get_next(e);
+    if(next) next->header.s.prev_free = 0;
+
+    /*Give back the end of the entry if it's not required*/
+    tlsf_trunc(e, size);
+
+    return &e->first_data;
+}
+
+/**
+ * Free an entry, join it with the adjacent free entries and add it to its size class
+ * @param e pointer to an entry
+ */
+static void tlsf_release(lv_mem_ent_t * e)
+{
+    e->header.s.used = 0;
+
+    if(e->header.s.prev_free) {
+        /*The previous free entry stored its size right before this header*/
+        uint32_t prev_size = (uint32_t)((MEM_UNIT *)e)[-1];
+        lv_mem_ent_t * prev = (lv_mem_ent_t *)((uint8_t *)e - prev_size - sizeof(lv_mem_header_t));
+        tlsf_remove((lv_mem_free_t *)prev);
+        prev->header.s.d_size += sizeof(lv_mem_header_t) + e->header.s.d_size;
+        e = prev;
+    }
+
+    lv_mem_ent_t * next = ent_get_next(e);
+    if(next && next->header.s.used == 0) {
+        tlsf_remove((lv_mem_free_t *)next);
+        e->header.s.d_size += sizeof(lv_mem_header_t) + next->header.s.d_size;
+    }
+
+    tlsf_insert((lv_mem_free_t *)e);
+}
+
+/**
+ * Truncate the data of a used entry and free the rest if it's big enough for a new entry
+ * @param e pointer to a used entry
+ * @param size new size in bytes (already aligned)
+ */
+static void tlsf_trunc(lv_mem_ent_t * e, uint32_t size)
+{
+    if(size < TLSF_MIN_SIZE) size = TLSF_MIN_SIZE;
+    if(e->header.s.d_size < size + sizeof(lv_mem_header_t) + TLSF_MIN_SIZE) return;
+
+    uint8_t * e_data = &e->first_data;
+    lv_mem_ent_t * rest = (lv_mem_ent_t *)&e_data[size];
+    rest->header.s.used = 1;
+    rest->header.s.prev_free = 0;
+    rest->header.s.d_size = e->header.s.d_size - size - sizeof(lv_mem_header_t);
+    e->header.s.d_size = size;
+
+    tlsf_release(rest);
+}
+
+/**
+ * Find a free entry which is big enough for a given size
+ * @param size the required size in bytes
+ * @return pointer to a free entry or NULL if there is no enough free memory
+ */
+static lv_mem_free_t * tlsf_find(uint32_t size)
+{
+    /*Round the size up to the next class so that any entry of the found class is big enough*/
+    uint32_t size_up = size;
+    if(size_up >= TLSF_SMALL_SIZE) size_up += (1U << (tlsf_fls(size_up) - TLSF_SL_LOG2)) - 1;
+
+    uint32_t fl;
+    uint32_t sl;
+    tlsf_mapping(size_up, &fl, &sl);
+    if(fl < TLSF_FL_CNT) {
+        uint32_t sl_map = tlsf_sl_map[fl] & (~0U << sl);
+        if(sl_map == 0) {
+            /*Take the smallest non-empty bigger first level class*/
+            uint32_t fl_map = tlsf_fl_map & (~0U << (fl + 1));
+            if(fl_map != 0) {
+                fl = tlsf_ffs(fl_map);
+                sl_map = tlsf_sl_map[fl];
+            }
+        }
+
+        if(sl_map != 0) return tlsf_heads[fl][tlsf_ffs(sl_map)];
+    }
+
+    /*Almost out of memory: an entry of the own class still might be big enough*/
+    tlsf_mapping(size, &fl, &sl);
+    if(fl >= TLSF_FL_CNT) return NULL;     /*Bigger than any entry*/
+
+    lv_mem_free_t * b = tlsf_heads[fl][sl];
+    while(b && b->header.s.d_size < size) b = b->next;
+
+    return b;
+}
+
+/**
+ * Add a free entry to the list of its size class
+ * @param b pointer to a free entry
+ */
+static void tlsf_insert(lv_mem_free_t * b)
+{
+    uint32_t fl;
+    uint32_t sl;
+    tlsf_mapping(b->header.s.d_size, &fl, &sl);
+
+    b->prev = NULL;
+    b->next = tlsf_heads[fl][sl];
+    if(b->next) b->next->prev = b;
+    tlsf_heads[fl][sl] = b;
+    tlsf_fl_map |= 1U << fl;
+    tlsf_sl_map[fl] |= 1U << sl;
+
+    /*Save the size at the end to let the next entry find the beginning of this entry*/
+    lv_mem_ent_t * e = (lv_mem_ent_t *)b;
+    uint8_t * e_end = (uint8_t *)e + sizeof(lv_mem_header_t) + e->header.s.d_size;
+    ((MEM_UNIT *)e_end)[-1] = e->header.s.d_size;
+
+    lv_mem_ent_t * next = ent_get_next(e);
+    if(next) next->header.s.prev_free = 1;
+}
+
+/**
+ * Remove a free entry from the list of its size class
+ * @param b pointer to a free entry
+ */
+static void tlsf_remove(lv_mem_free_t * b)
+{
+    uint32_t fl;
+    uint32_t sl;
+    tlsf_mapping(b->header.s.d_size, &fl, &sl);
+
+    if(b->next) b->next->prev = b->prev;
+    if(b->prev) {
+        b->prev->next = b->next;
+    }
+    else {
+        tlsf_heads[fl][sl] = b->next;
+        if(b->next == NULL) {
+            tlsf_sl_map[fl] &= ~(1U << sl);
+            if(tlsf_sl_map[fl] == 0) tlsf_fl_map &= ~(1U << fl);
+        }
+    }
+}
+
+/**
+ * Get the first and second level class of a size
+ * @param size a size in bytes
+ * @param fl store the first level class here
+ * @param sl store the second level class here
+ */
+static void tlsf_mapping(uint32_t size, uint32_t * fl, uint32_t * sl)
+{
+    if(size < TLSF_SMALL_SIZE) {
+        *fl = 0;
+        *sl = size >> TLSF_ALIGN_LOG2;
+    }
+    else {
+        uint32_t t = tlsf_fls(size);
+        *fl = t - TLSF_FL_SHIFT + 1;
+        *sl = (size >> (t - TLSF_SL_LOG2)) ^ TLSF_SL_CNT;
+    }
+}
+
+/**
+ * Get the index of the highest set bit
+ * @param x a non-zero value
+ * @return index of the bit (0..31)
+ */
+static uint32_t tlsf_fls(uint32_t x)
+{
+#if defined(__GNUC__)
+    return 31 - __builtin_clz(x);
+#else
+    uint32_t i = 0;
+    while(x >>= 1) i++;
+    return i;
+#endif
+}
+
+/**
+ * Get the index of the lowest set bit
+ * @param x a non-zero value
+ * @return index of the bit (0..31)
+ */
+static uint32_t tlsf_ffs(uint32_t x)
+{
+#if defined(__GNUC__)
+    return __builtin_ctz(x);
+#else
+    uint32_t i = 0;
+    while((x & 1) == 0) {
+        x >>= 1;
+        i++;
+    }
+    return i;
+#endif
+}
+
+#endif /*MEM_TLSF*/
+
+#endif
+
+#if MEM_SLAB
+/**
+ * Remove all the classes and pages and add the default classes
+ */
+static void slab_init(void)
+{
+    slab_cnt = 0;
+    slab_page_next = 0;
+    slab_fallback_cnt = 0;
+    slab_refused_cnt = 0;
+    _lv_memset_00(slab_refused, sizeof(slab_refused));
+    _lv_memset(slab_class_of_size, SLAB_NONE, sizeof(slab_class_of_size));
+    uint32_t i;
+    for(i = 0; i < sizeof(slab_sizes_def) / sizeof(slab_sizes_def[0]); i++) {
+        _lv_mem_slab_add(slab_sizes_def[i]);
+    }
+}
+
+/**
+ * Allocate a block from the smallest size class which is large enough
+ * @param size size of the new memory in bytes (already aligned)
+ * @return pointer to the allocated memory or NULL if it should be allocated from the heap
+ */
+static void * slab_alloc(uint32_t size)
+{
+    if(size > SLAB_SIZE_MAX) return NULL;
+
+    uint8_t c = slab_class_of_size[size / (ALIGN_MASK + 1)];
+    if(c == SLAB_NONE) return NULL;
+    lv_mem_slab_t * slab = &slabs[c];
+
+    if(slab->free_head == NULL) {
+        if(slab_add_page(slab) == false) {
+            slab_fallback_cnt++;
+            return NULL;
+        }
+    }
+
+    lv_mem_slab_free_t * b = slab->free_head;
+    slab->free_head = b->next;
+    slab->used_cnt++;
+
+    lv_mem_ent_t * e = (lv_mem_ent_t *)b;
+    e->header.s.used = 1;
+    e->header.s.d_size = size;
+    return &e->first_data;
+}
+
+/**
+ * Give back a block to its size class
+ * @param e pointer to the header of the block
+ */
+static void slab_free(lv_mem_ent_t * e)
+{
+    lv_mem_slab_t * slab = slab_get(&e->first_data);
+    lv_mem_slab_free_t * b = (lv_mem_slab_free_t *)e;
+    b->next = slab->free_head;
+    slab->free_head = b;
+    slab->used_cnt--;
+}
+
+/**
+ * Give a new page to a size class and add its blocks to the free list of the class
+ * @param slab pointer to a size class
+ * @return true: success; false: the slab memory is full
+ */
+static bool slab_add_page(lv_mem_slab_t * slab)
+{
+    if(slab_page_next >= SLAB_PAGE_CNT) return false;
+
+    uint8_t * page = (uint8_t *)slab_mem + slab_page_next * LV_MEM_SLAB_PAGE_SIZE;
+    slab_page_class[slab_page_next] = slab - slabs;
+    slab_page_next++;
+
+    uint32_t block_size = sizeof(lv_mem_header_t) + slab->size;
+    uint32_t block_cnt = LV_MEM_SLAB_PAGE_SIZE / block_size;
+    uint32_t i;
+    for(i = 0; i < block_cnt; i++) {
+        lv_mem_slab_free_t * b = (lv_mem_slab_free_t *)(page + i * block_size);
+        b->header.header = 0;
+        b->next = slab->free_head;
+        slab->free_head = b;
+    }
+
+    slab->block_cnt += block_cnt;
+    slab->page_cnt++;
+    return true;
+}
+
+/**
+ * Get the size class of a memory if it's in the slab memory
+ * @param data pointer to an allocated memory
+ * @return pointer to the size class or NULL if the memory is not in the slab memory
+ */
+static lv_mem_slab_t * slab_get(const void * data)
+{
+    const uint8_t * data8 = data;
+    const uint8_t * slab_mem8 = (const uint8_t *)slab_mem;
+    if(data8 < slab_mem8 || data8 >= slab_mem8 + slab_page_next * LV_MEM_SLAB_PAGE_SIZE) return NULL;
+
+    return &slabs[slab_page_class[(data8 - slab_mem8) / LV_MEM_SLAB_PAGE_SIZE]];
+}
+#endif
+
+#if LV_MEM_BUF_ARENA_SIZE
+/**
+ * Give back the buffers from the top of the arena
+ * @param mark don't go below this offset
+ * @param all true: give back the used buffers too; false: stop at the first used buffer
+ */
+static void buf_arena_pop(uint32_t mark, bool all)
+{
+    while(buf_arena_top > mark) {
+        lv_mem_buf_hdr_t * hdr = (lv_mem_buf_hdr_t *)((uint8_t *)buf_arena + buf_arena_last);
+        if(hdr->used && all == false) break;
+
+        buf_arena_top = buf_arena_last;
+        buf_arena_last = hdr->prev;
+    }
+}
+#endif
+
+#if MEM_TRACE
+/**
+ * Add an allocation to the list of the live allocations
+ * @param rec the trace record of the allocation
+ * @param size size of the data
+ * @param file name of the source file of the allocation
+ * @param line line of the allocation
+ */
+static void trace_link(lv_mem_trace_t * rec, uint32_t size, const char * file, uint32_t line)
+{
+    rec->size = size;
+    rec->file = file;
+    rec->line = line;
+    rec->prev = NULL;
+    rec->next = trace_head;
+    if(trace_head) trace_head->prev = rec;
+    trace_head = rec;
+}
+
+/**
+ * Remove an allocation from the list of the live allocations
+ * @param rec the trace record of the allocation
+ */
+static void trace_unlink(lv_mem_trace_t * rec)
+{
+    if(rec->prev) rec->prev->next = rec->next;
+    else trace_head = rec->next;
+    if(rec->next) rec->next->prev = rec->prev;
+}
 #endif
@@ -32,6 +32,21 @@ extern "C" {
 #define LV_MEM_BUF_MAX_NUM    16
 #endif
 
+/*Free memory in entries smaller than this is reported in `free_small_size` of `lv_mem_monitor_t`*/
+#ifndef LV_MEM_FREE_SMALL_SIZE
+#define LV_MEM_FREE_SMALL_SIZE    64
+#endif
+
+/*Max. number of slab size classes: the default ones, one for the objects and one for each object type*/
+#ifndef LV_MEM_SLAB_CLASS_MAX
+#define LV_MEM_SLAB_CLASS_MAX     48
+#endif
+
+/*Number of size classes in the histogram of `lv_mem_trace_tag_t`: <= 8, 16, 32 ... bytes and the larger ones*/
+#ifndef LV_MEM_TRACE_HIST_CNT
+#define LV_MEM_TRACE_HIST_CNT     8
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -44,12 +59,42 @@ typedef struct {
     uint32_t free_cnt;
     uint32_t free_size; /**< Size of available memory */
     uint32_t free_biggest_size;
+    uint32_t free_small_size; /**< Free memory in entries smaller than `LV_MEM_FREE_SMALL_SIZE` */
+    uint32_t header_size; /**< Memory used by the headers of the entries */
     uint32_t used_cnt;
     uint32_t max_used; /**< Max size of Heap memory used */
     uint8_t used_pct; /**< Percentage used */
     uint8_t frag_pct; /**< Amount of fragmentation */
 } lv_mem_monitor_t;
 
+/**
+ * Slab information structure.
+ */
+typedef struct {
+    uint32_t total_size; /**< Size of the slab memory */
+    uint32_t free_size; /**< Size of the pages not given to a size class yet */
+    uint32_t fallback_cnt; /**< Number of allocations done in the heap because the slab memory was full */
+    uint32_t refused_cnt; /**< Number of size classes not added because there were `LV_MEM_SLAB_CLASS_MAX` classes */
+    uint8_t class_cnt;
+    struct {
+        uint16_t size; /**< Data size of the blocks */
+        uint16_t page_cnt;
+        uint32_t block_cnt; /**< Number of blocks in the pages of the class */
+        uint32_t used_cnt; /**< Number of used blocks */
+    } classes[LV_MEM_SLAB_CLASS_MAX];
+} lv_mem_slab_monitor_t;
+
+/**
+ * Live allocations of a place in the code
+ */
+typedef struct {
+    const char * file; /**< Source file of the allocation (NULL: not known) */
+    uint32_t line;
+    uint32_t cnt; /**< Number of live allocations */
+    uint32_t size; /**< Total size of the live allocations */
+    uint16_t size_hist[LV_MEM_TRACE_HIST_CNT]; /**< Number of allocations with <= 8, 16, 32 ... bytes */
+} lv_mem_trace_tag_t;
+
 typedef struct {
     void * p;
     uint16_t size;
@@ -98,6 +143,7 @@ void * lv_mem_realloc(void * data_p, size_t new_size);
 
 /**
  * Join the adjacent free memory blocks
+ * @note with `LV_MEM_TLSF` the free blocks are always joined so it does nothing
  */
 void lv_mem_defrag(void);
 
@@ -114,6 +160,21 @@ lv_res_t lv_mem_test(void);
  */
 void lv_mem_monitor(lv_mem_monitor_t * mon_p);
 
+/**
+ * Give information about the slab memory and the occupancy of its size classes
+ * @param mon_p pointer to a `lv_mem_slab_monitor_t` variable,
+ *              the result of the analysis will be stored here
+ */
+void lv_mem_slab_monitor(lv_mem_slab_monitor_t * mon_p);
+
+/**
+ * Add a slab size class for the memories of a given size, e.g. for the objects of a type.
+ * Does nothing if the class already exists, the size is too large or there are `LV_MEM_SLAB_CLASS_MAX` classes.
+ * It's cheap to call again for an existing or refused class.
+ * @param size size of the memories in bytes
+ */
+void _lv_mem_slab_add(uint32_t size);
+
 /**
  * Give the size of an allocated memory
  * @param data pointer to an allocated memory
@@ -121,6 +182,58 @@ void lv_mem_monitor(lv_mem_monitor_t * mon_p);
  */
 uint32_t _lv_mem_get_size(const void * data);
 
+/**
+ * Allocate a memory and tag it with the place of the allocation.
+ * Called by `lv_mem_alloc()` if `LV_MEM_TRACE` is enabled.
+ * @param size size of the memory to allocate in bytes
+ * @param file name of the source file of the allocation
+ * @param line line of the allocation
+ * @return pointer to the allocated memory
+ */
+void * _lv_mem_alloc_trace(size_t size, const char * file, uint32_t line);
+
+/**
+ * Reallocate a memory and tag it with the place of the reallocation.
+ * Called by `lv_mem_realloc()` if `LV_MEM_TRACE` is enabled.
+ * @param data_p pointer to an allocated memory
+ * @param new_size the desired new size in byte
+ * @param file name of the source file of the reallocation
+ * @param line line of the reallocation
+ * @return pointer to the new memory
+ */
+void * _lv_mem_realloc_trace(void * data_p, size_t new_size, const char * file, uint32_t line);
+
+/**
+ * Get a mark of the allocations.
+ * `lv_mem_trace_get_tags()` can report only the allocations done after the mark.
+ * @return the mark (0 if `LV_MEM_TRACE` is disabled)
+ */
+uint32_t lv_mem_trace_mark(void);
+
+/**
+ * Collect the live allocations by the place of the allocation.
+ * @param mark report only the allocations done after this mark from `lv_mem_trace_mark()`. 0: report all
+ * @param tags store the places here, the place with the most memory first
+ * @param tag_max size of `tags`. The other places are not reported.
+ * @return number of places stored in `tags`
+ */
+uint32_t lv_mem_trace_get_tags(uint32_t mark, lv_mem_trace_tag_t * tags, uint32_t tag_max);
+
+/**
+ * Draw the map of the built-in heap as a string.
+ * Every character is a part of the heap: '#' used, '.' free, '+' both used and free memory.
+ * @param buf store the map here, it will be '\0' terminated
+ * @param buf_size size of `buf`
+ * @return number of characters in the map (0 if `LV_MEM_TRACE` is disabled or `LV_MEM_CUSTOM` is used)
+ */
+uint32_t lv_mem_trace_frag_map(char * buf, uint32_t buf_size);
+
+/**
+ * Log the places of the live allocations and the map of the heap with `LV_LOG_USER`
+ * @param mark report only the allocations done after this mark from `lv_mem_trace_mark()`. 0: report all
+ */
+void lv_mem_trace_dump(uint32_t mark);
+
 /**
  * Get a temporal buffer with the given size.
  * @param size the required size
@@ -138,6 +251,34 @@ void _lv_mem_buf_release(void * p);
  */
 void _lv_mem_buf_free_all(void);
 
+/**
+ * Get a mark of the temporary buffers.
+ * The buffers got after the mark can be released at once with `_lv_mem_buf_release_to()`.
+ * @return the mark
+ */
+uint32_t _lv_mem_buf_mark(void);
+
+/**
+ * Release all the temporary buffers got after a mark.
+ * Only the buffers in the arena (`LV_MEM_BUF_ARENA_SIZE`) are released, the others need `_lv_mem_buf_release()`.
+ * @param mark a mark from `_lv_mem_buf_mark()`
+ */
+void _lv_mem_buf_release_to(uint32_t mark);
+
+/**
+ * Get the most memory that was used from the arena of the temporary buffers at once.
+ * It helps to set `LV_MEM_BUF_ARENA_SIZE`.
+ * @return the high water mark in bytes (0 if the arena is not used)
+ */
+uint32_t lv_mem_buf_get_max_used(void);
+
+/**
+ * Get the number of temporary buffers which didn't fit into the arena of the temporary buffers.
+ * If it's not zero `LV_MEM_BUF_ARENA_SIZE` might be too small.
+ * @return the number of buffers got from the heap instead of the arena (0 if the arena is not used)
+ */
+uint32_t lv_mem_buf_get_overflow_cnt(void);
+
 //! @cond Doxygen_Suppress
 
 #if LV_MEMCPY_MEMSET_STD
@@ -255,6 +396,12 @@ LV_ATTRIBUTE_FAST_MEM void _lv_memset_ff(void * dst, size_t len);
  *      MACROS
  **********************/
 
+#if LV_MEM_TRACE && LV_ENABLE_GC == 0
+/*Tag the allocations with the place of the call*/
+#define lv_mem_alloc(size)                  _lv_mem_alloc_trace(size, __FILE__, __LINE__)
+#define lv_mem_realloc(data_p, new_size)    _lv_mem_realloc_trace(data_p, new_size, __FILE__, __LINE__)
+#endif
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -11,6 +11,7 @@
 #include "../lv_misc/lv_debug.h"
 #include "../lv_misc/lv_math.h"
 #include "../lv_draw/lv_draw.h"
+#include "../lv_draw/lv_img_cache.h"
 #include "../lv_core/lv_refr.h"
 #include "../lv_themes/lv_theme.h"
 
@@ -30,6 +31,7 @@
  **********************/
 static lv_res_t lv_canvas_signal(lv_obj_t * canvas, lv_signal_t sign, void * param);
 static void set_set_px_cb(lv_disp_drv_t * disp_drv, lv_img_cf_t cf);
+static void invalidate_content(lv_obj_t * canvas);
 
 static void set_px_true_color_alpha(lv_disp_drv_t * disp_drv, uint8_t * buf, lv_coord_t buf_w, lv_coord_t x,
                                     lv_coord_t y,
@@ -164,7 +166,7 @@ void lv_canvas_set_px(lv_obj_t * canvas, lv_coord_t x, lv_coord_t y, lv_color_t
     lv_canvas_ext_t * ext = lv_obj_get_ext_attr(canvas);
 
     lv_img_buf_set_px_color(&ext->dsc, x, y, c);
-    lv_obj_invalidate(canvas);
+    invalidate_content(canvas);
 }
 
 /**
@@ -184,6 +186,9 @@ void lv_canvas_set_palette(lv_obj_t * canvas, uint8_t id, lv_color_t c)
     lv_canvas_ext_t * ext = lv_obj_get_ext_attr(canvas);
 
     lv_img_buf_set_palette(&ext->dsc, id, c);
+
+    /*The decoder copies the palette when the image is opened so open it again*/
+    lv_img_cache_invalidate_src(&ext->dsc);
     lv_obj_invalidate(canvas);
 }
 
@@ -256,6 +261,8 @@ void lv_canvas_copy_buf(lv_obj_t * canvas, const void * to_copy, lv_coord_t x, l
         px += ext->dsc.header.w * px_size;
         to_copy8 += w * px_size;
     }
+
+    invalidate_content(canvas);
 }
 
 /**
@@ -361,7 +368,7 @@ void lv_canvas_transform(lv_obj_t * canvas, lv_img_dsc_t * img, int16_t angle, u
         }
     }
 
-    lv_obj_invalidate(canvas);
+    invalidate_content(canvas);
 #else
     LV_UNUSED(canvas);
     LV_UNUSED(img);
@@ -505,7 +512,7 @@ void lv_canvas_blur_hor(lv_obj_t * canvas, const lv_area_t * area, uint16_t r)
             if(has_alpha) asum += opa;
         }
     }
-    lv_obj_invalidate(canvas);
+    invalidate_content(canvas);
 
     _lv_mem_buf_release(line_buf);
 }
@@ -644,7 +651,7 @@ void lv_canvas_blur_ver(lv_obj_t * canvas, const lv_area_t * area, uint16_t r)
         }
     }
 
-    lv_obj_invalidate(canvas);
+    invalidate_content(canvas);
 
     _lv_mem_buf_release(col_buf);
 }
@@ -681,7 +688,7 @@ void lv_canvas_fill_bg(lv_obj_t * canvas, lv_color_t color, lv_opa_t opa)
         }
     }
 
-    lv_obj_invalidate(canvas);
+    invalidate_content(canvas);
 }
 
 /**
@@ -751,7 +758,7 @@ void lv_canvas_draw_rect(lv_obj_t * canvas, lv_coord_t x, lv_coord_t y, lv_coord
 
     _lv_refr_set_disp_refreshing(refr_ori);
 
-    lv_obj_invalidate(canvas);
+    invalidate_content(canvas);
 }
 
 /**
@@ -831,7 +838,7 @@ void lv_canvas_draw_text(lv_obj_t * canvas, lv_coord_t x, lv_coord_t y, lv_coord
 
     _lv_refr_set_disp_refreshing(refr_ori);
 
-    lv_obj_invalidate(canvas);
+    invalidate_content(canvas);
 }
 
 /**
@@ -895,7 +902,7 @@ void lv_canvas_draw_img(lv_obj_t * canvas, lv_coord_t x, lv_coord_t y, const voi
 
     _lv_refr_set_disp_refreshing(refr_ori);
 
-    lv_obj_invalidate(canvas);
+    invalidate_content(canvas);
 }
 
 /**
@@ -958,7 +965,7 @@ void lv_canvas_draw_line(lv_obj_t * canvas, const lv_point_t points[], uint32_t
 
     _lv_refr_set_disp_refreshing(refr_ori);
 
-    lv_obj_invalidate(canvas);
+    invalidate_content(canvas);
 }
 
 /**
@@ -1019,7 +1026,7 @@ void lv_canvas_draw_polygon(lv_obj_t * canvas, const lv_point_t points[], uint32
 
     _lv_refr_set_disp_refreshing(refr_ori);
 
-    lv_obj_invalidate(canvas);
+    invalidate_content(canvas);
 }
 
 /**
@@ -1083,7 +1090,7 @@ void lv_canvas_draw_arc(lv_obj_t * canvas, lv_coord_t x, lv_coord_t y, lv_coord_
 
     _lv_refr_set_disp_refreshing(refr_ori);
 
-    lv_obj_invalidate(canvas);
+    invalidate_content(canvas);
 }
 
 /**********************
@@ -1113,6 +1120,21 @@ static lv_res_t lv_canvas_signal(lv_obj_t * canvas, lv_signal_t sign, void * par
     return res;
 }
 
+/**
+ * Redraw the canvas after its buffer was modified.
+ * Also free the transformed copies of the buffer in the image cache to not draw an outdated one.
+ * The buffer itself can stay in the cache as it's used in place.
+ * @param canvas pointer to a canvas object
+ */
+static void invalidate_content(lv_obj_t * canvas)
+{
+#if LV_IMG_CACHE_VARIANT_MEM_SIZE
+    lv_canvas_ext_t * ext = lv_obj_get_ext_attr(canvas);
+    lv_img_cache_invalidate_variants(&ext->dsc);
+#endif
+    lv_obj_invalidate(canvas);
+}
+
 static void set_set_px_cb(lv_disp_drv_t * disp_drv, lv_img_cf_t cf)
 {
     switch(cf) {
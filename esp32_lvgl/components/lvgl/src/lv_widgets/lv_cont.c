@@ -378,7 +378,7 @@ static void lv_cont_layout_col(lv_obj_t * cont)
     lv_obj_add_protect(cont, LV_PROTECT_CHILD_CHG);
     /* Align the children */
     lv_coord_t last_cord = top;
-    _LV_LL_READ_BACK(cont->child_ll, child) {
+    _LV_OBJ_CHILD_READ_BACK(cont, child) {
         if(lv_obj_get_hidden(child) != false || lv_obj_is_protected(child, LV_PROTECT_POS) != false) continue;
         lv_style_int_t mtop = lv_obj_get_style_margin_top(child, LV_OBJ_PART_MAIN);
         lv_style_int_t mbottom = lv_obj_get_style_margin_bottom(child, LV_OBJ_PART_MAIN);
@@ -434,7 +434,7 @@ static void lv_cont_layout_row(lv_obj_t * cont)
 
     lv_coord_t inner = lv_obj_get_style_pad_inner(cont, LV_CONT_PART_MAIN);
 
-    _LV_LL_READ_BACK(cont->child_ll, child) {
+    _LV_OBJ_CHILD_READ_BACK(cont, child) {
         if(lv_obj_get_hidden(child) != false || lv_obj_is_protected(child, LV_PROTECT_POS) != false) continue;
 
         if(base_dir == LV_BIDI_DIR_RTL) lv_obj_align(child, cont, align, -last_cord, vpad_corr);
@@ -457,7 +457,7 @@ static void lv_cont_layout_center(lv_obj_t * cont)
     lv_coord_t h_tot         = 0;
 
     lv_coord_t inner = lv_obj_get_style_pad_inner(cont, LV_CONT_PART_MAIN);
-    _LV_LL_READ(cont->child_ll, child) {
+    _LV_OBJ_CHILD_READ(cont, child) {
         if(lv_obj_get_hidden(child) != false || lv_obj_is_protected(child, LV_PROTECT_POS) != false) continue;
         h_tot += lv_obj_get_height(child) + inner;
         obj_num++;
@@ -473,7 +473,7 @@ static void lv_cont_layout_center(lv_obj_t * cont)
 
     /* Align the children */
     lv_coord_t last_cord = -(h_tot / 2);
-    _LV_LL_READ_BACK(cont->child_ll, child) {
+    _LV_OBJ_CHILD_READ_BACK(cont, child) {
         if(lv_obj_get_hidden(child) != false || lv_obj_is_protected(child, LV_PROTECT_POS) != false) continue;
 
         lv_obj_align(child, cont, LV_ALIGN_CENTER, 0, last_cord + lv_obj_get_height(child) / 2);
@@ -500,7 +500,7 @@ static void lv_cont_layout_pretty(lv_obj_t * cont)
     /* Disable child change action because the children will be moved a lot
      * an unnecessary child change signals could be sent*/
 
-    child_rs = _lv_ll_get_tail(&cont->child_ll); /*Set the row starter child*/
+    child_rs = _lv_obj_get_child_prev(cont, NULL); /*Set the row starter child*/
     if(child_rs == NULL) return;                /*Return if no child*/
 
     lv_obj_add_protect(cont, LV_PROTECT_CHILD_CHG);
@@ -525,7 +525,7 @@ static void lv_cont_layout_pretty(lv_obj_t * cont)
                     /*Step back one child because the last already not fit, so the previous is the
                      * closer*/
                     if(child_rc != NULL && obj_num != 0) {
-                        child_rc = _lv_ll_get_next(&cont->child_ll, child_rc);
+                        child_rc = _lv_obj_get_child_next(cont, child_rc);
                     }
                     break;
                 }
@@ -539,7 +539,7 @@ static void lv_cont_layout_pretty(lv_obj_t * cont)
                 if(lv_obj_is_protected(child_rc, LV_PROTECT_FOLLOW))
                     break; /*If can not be followed by an other object then break here*/
             }
-            child_rc = _lv_ll_get_prev(&cont->child_ll, child_rc); /*Load the next object*/
+            child_rc = _lv_obj_get_child_prev(cont, child_rc); /*Load the next object*/
             if(obj_num == 0)
                 child_rs = child_rc; /*If the first object was hidden (or too long) then set the
                                         next as first */
@@ -606,13 +606,13 @@ static void lv_cont_layout_pretty(lv_obj_t * cont)
                     act_x += lv_obj_get_width(child_tmp) + new_pinner + mleft + mright;
                 }
                 if(child_tmp == child_rc) break;
-                child_tmp = _lv_ll_get_prev(&cont->child_ll, child_tmp);
+                child_tmp = _lv_obj_get_child_prev(cont, child_tmp);
             }
         }
 
         if(child_rc == NULL) break;
         act_y += pinner + h_row;           /*y increment*/
-        child_rs = _lv_ll_get_prev(&cont->child_ll, child_rc); /*Go to the next object*/
+        child_rs = _lv_obj_get_child_prev(cont, child_rc); /*Go to the next object*/
         child_rc = child_rs;
     }
     lv_obj_clear_protect(cont, LV_PROTECT_CHILD_CHG);
@@ -637,7 +637,7 @@ static void lv_cont_layout_grid(lv_obj_t * cont)
     lv_coord_t act_x = left;
     lv_coord_t act_y = lv_obj_get_style_pad_top(cont, LV_CONT_PART_MAIN);
     lv_obj_t * child;
-    _LV_LL_READ_BACK(cont->child_ll, child) {
+    _LV_OBJ_CHILD_READ_BACK(cont, child) {
         if(lv_obj_get_hidden(child) != false || lv_obj_is_protected(child, LV_PROTECT_POS) != false) continue;
         lv_coord_t obj_w = lv_obj_get_width(child);
         if(act_x + obj_w > w_fit + left) {
@@ -686,7 +686,7 @@ static void lv_cont_refr_autofit(lv_obj_t * cont)
         lv_obj_get_coords(cont, &ori);
         lv_obj_get_coords(cont, &tight_area);
 
-        bool has_children = _lv_ll_is_empty(&cont->child_ll) ? false : true;
+        bool has_children = _lv_obj_get_child_next(cont, NULL) ? true : false;
 
         if(has_children) {
             tight_area.x1 = LV_COORD_MAX;
@@ -694,7 +694,7 @@ static void lv_cont_refr_autofit(lv_obj_t * cont)
             tight_area.x2 = LV_COORD_MIN;
             tight_area.y2 = LV_COORD_MIN;
 
-            _LV_LL_READ(cont->child_ll, child_i) {
+            _LV_OBJ_CHILD_READ(cont, child_i) {
                 if(lv_obj_get_hidden(child_i) != false) continue;
 
                 if(ext->fit_left != LV_FIT_PARENT) {
@@ -802,7 +802,7 @@ static void lv_cont_refr_autofit(lv_obj_t * cont)
             }
 
             /*Tell the children the parent's size has changed*/
-            _LV_LL_READ(cont->child_ll, child_i) {
+            _LV_OBJ_CHILD_READ(cont, child_i) {
                 child_i->signal_cb(child_i, LV_SIGNAL_PARENT_SIZE_CHG, &ori);
             }
         }
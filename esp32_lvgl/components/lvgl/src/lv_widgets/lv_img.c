@@ -17,6 +17,7 @@
 #include "../lv_misc/lv_debug.h"
 #include "../lv_themes/lv_theme.h"
 #include "../lv_draw/lv_img_decoder.h"
+#include "../lv_draw/lv_img_cache.h"
 #include "../lv_misc/lv_fs.h"
 #include "../lv_misc/lv_txt.h"
 #include "../lv_misc/lv_math.h"
@@ -37,6 +38,9 @@
 static lv_design_res_t lv_img_design(lv_obj_t * img, const lv_area_t * clip_area, lv_design_mode_t mode);
 static lv_res_t lv_img_signal(lv_obj_t * img, lv_signal_t sign, void * param);
 static lv_style_list_t * lv_img_get_style(lv_obj_t * img, uint8_t type);
+static bool is_loading(lv_obj_t * img, lv_color_t color);
+static void preload_ready_cb(const void * src);
+static void invalidate_src(lv_obj_t * obj, const void * src);
 
 /**********************
  *  STATIC VARIABLES
@@ -66,7 +70,10 @@ lv_obj_t * lv_img_create(lv_obj_t * par, const lv_obj_t * copy)
     LV_ASSERT_MEM(img);
     if(img == NULL) return NULL;
 
-    if(ancestor_signal == NULL) ancestor_signal = lv_obj_get_signal_cb(img);
+    if(ancestor_signal == NULL) {
+        ancestor_signal = lv_obj_get_signal_cb(img);
+        _lv_img_cache_set_preload_cb(preload_ready_cb);
+    }
 
     /*Extend the basic object to image object*/
     lv_img_ext_t * ext = lv_obj_allocate_ext_attr(img, sizeof(lv_img_ext_t));
@@ -78,12 +85,16 @@ lv_obj_t * lv_img_create(lv_obj_t * par, const lv_obj_t * copy)
 
     ext->src       = NULL;
     ext->src_type  = LV_IMG_SRC_UNKNOWN;
+    ext->atlas     = NULL;
+    ext->atlas_id  = 0;
     ext->cf        = LV_IMG_CF_UNKNOWN;
     ext->w         = lv_obj_get_width(img);
     ext->h         = lv_obj_get_height(img);
     ext->angle = 0;
     ext->zoom = LV_IMG_ZOOM_NONE;
     ext->antialias = LV_ANTIALIAS ? 1 : 0;
+    ext->async = 0;
+    ext->async_started = 0;
     ext->auto_size = 1;
     ext->offset.x  = 0;
     ext->offset.y  = 0;
@@ -114,11 +125,13 @@ lv_obj_t * lv_img_create(lv_obj_t * par, const lv_obj_t * copy)
         ext->zoom          = copy_ext->zoom;
         ext->angle         = copy_ext->angle;
         ext->antialias     = copy_ext->antialias;
+        ext->async         = copy_ext->async;
         ext->offset.x     = copy_ext->offset.x;
         ext->offset.y     = copy_ext->offset.y;
         ext->pivot.x     = copy_ext->pivot.x;
         ext->pivot.y     = copy_ext->pivot.y;
-        lv_img_set_src(img, copy_ext->src);
+        if(copy_ext->atlas) lv_img_set_src_atlas(img, copy_ext->atlas, copy_ext->atlas_id);
+        else lv_img_set_src(img, copy_ext->src);
 
         /*Refresh the style with new signal function*/
         lv_obj_refresh_style(img, LV_OBJ_PART_ALL, LV_STYLE_PROP_ALL);
@@ -145,6 +158,9 @@ void lv_img_set_src(lv_obj_t * img, const void * src_img)
     lv_img_src_t src_type = lv_img_src_get_type(src_img);
     lv_img_ext_t * ext    = lv_obj_get_ext_attr(img);
 
+    ext->atlas = NULL;
+    ext->async_started = 0;
+
 #if LV_USE_LOG && LV_LOG_LEVEL >= LV_LOG_LEVEL_INFO
     switch(src_type) {
         case LV_IMG_SRC_FILE:
@@ -234,6 +250,50 @@ void lv_img_set_src(lv_obj_t * img, const void * src_img)
     lv_obj_invalidate(img);
 }
 
+/**
+ * Set a sprite of an image atlas to display by the image.
+ * The sprites of an atlas share one image cache entry and are drawn directly from the atlas.
+ * @param img pointer to an image object
+ * @param atlas pointer to an image atlas. Only its pointer is saved so it should be static, global or dynamically allocated.
+ * @param id ID of the sprite in the atlas
+ */
+void lv_img_set_src_atlas(lv_obj_t * img, const lv_img_atlas_t * atlas, uint16_t id)
+{
+    LV_ASSERT_OBJ(img, LV_OBJX_NAME);
+    LV_ASSERT_NULL(atlas);
+
+    if(id >= atlas->rect_cnt) {
+        LV_LOG_WARN("lv_img_set_src_atlas: invalid sprite ID");
+        return;
+    }
+
+    lv_img_ext_t * ext = lv_obj_get_ext_attr(img);
+
+    /*Save the atlas image as source to get its color format (and keep the file name).
+     *Only the sprite changes when the same atlas is used (e.g. for animations).*/
+    lv_obj_invalidate(img);
+    if(ext->atlas != atlas) {
+        lv_img_set_src(img, atlas->src);
+        if(ext->src_type != LV_IMG_SRC_VARIABLE && ext->src_type != LV_IMG_SRC_FILE) return;
+    }
+
+    const lv_area_t * rect = &atlas->rects[id];
+    ext->atlas = atlas;
+    ext->atlas_id = id;
+    ext->w = lv_area_get_width(rect);
+    ext->h = lv_area_get_height(rect);
+    ext->pivot.x = ext->w / 2;
+    ext->pivot.y = ext->h / 2;
+
+    if(lv_img_get_auto_size(img) != false) {
+        lv_obj_set_size(img, ext->w, ext->h);
+    }
+
+    if(ext->angle || ext->zoom != LV_IMG_ZOOM_NONE) lv_obj_refresh_ext_draw_pad(img);
+
+    lv_obj_invalidate(img);
+}
+
 /**
  * Enable the auto size feature.
  * If enabled the object size will be same as the picture size.
@@ -421,6 +481,21 @@ void lv_img_set_antialias(lv_obj_t * img, bool antialias)
     lv_obj_invalidate(img);
 }
 
+/**
+ * Enable/disable loading the image in the background (`lv_img_cache_preload()`) when it's drawn first.
+ * Until the image is loaded only the background of the object is drawn.
+ * Useful for files and images of slow decoders.
+ * @param img pointer to an image object
+ * @param en true: load in the background; false: load when drawn
+ */
+void lv_img_set_async(lv_obj_t * img, bool en)
+{
+    LV_ASSERT_OBJ(img, LV_OBJX_NAME);
+
+    lv_img_ext_t * ext = lv_obj_get_ext_attr(img);
+    ext->async = en ? 1 : 0;
+}
+
 /*=====================
  * Getter functions
  *====================*/
@@ -439,6 +514,34 @@ const void * lv_img_get_src(lv_obj_t * img)
     return ext->src;
 }
 
+/**
+ * Get the atlas of the image's sprite
+ * @param img pointer to an image object
+ * @return the atlas set by `lv_img_set_src_atlas()` or NULL if the image is not a sprite
+ */
+const lv_img_atlas_t * lv_img_get_atlas(lv_obj_t * img)
+{
+    LV_ASSERT_OBJ(img, LV_OBJX_NAME);
+
+    lv_img_ext_t * ext = lv_obj_get_ext_attr(img);
+
+    return ext->atlas;
+}
+
+/**
+ * Get the ID of the image's sprite in its atlas
+ * @param img pointer to an image object
+ * @return ID of the sprite set by `lv_img_set_src_atlas()`
+ */
+uint16_t lv_img_get_atlas_id(lv_obj_t * img)
+{
+    LV_ASSERT_OBJ(img, LV_OBJX_NAME);
+
+    lv_img_ext_t * ext = lv_obj_get_ext_attr(img);
+
+    return ext->atlas_id;
+}
+
 /**
  * Get the name of the file set for an image
  * @param img pointer to an image
@@ -554,6 +657,46 @@ bool lv_img_get_antialias(lv_obj_t * img)
     return ext->antialias ? true : false;
 }
 
+/**
+ * Get whether the image is loaded in the background when it's drawn first
+ * @param img pointer to an image object
+ * @return true: loaded in the background; false: loaded when drawn
+ */
+bool lv_img_get_async(lv_obj_t * img)
+{
+    LV_ASSERT_OBJ(img, LV_OBJX_NAME);
+
+    lv_img_ext_t * ext = lv_obj_get_ext_attr(img);
+
+    return ext->async ? true : false;
+}
+
+/*=====================
+ * Other functions
+ *====================*/
+
+/**
+ * Start loading the images of an object and its children in the background (`lv_img_cache_preload()`),
+ * e.g. the images of the next screen, to show them without delay
+ * @param obj pointer to an object, e.g. a screen
+ */
+void lv_img_prefetch(lv_obj_t * obj)
+{
+    LV_ASSERT_OBJ(obj, "");
+
+    if(lv_obj_get_design_cb(obj) == lv_img_design) {
+        lv_img_ext_t * ext = lv_obj_get_ext_attr(obj);
+        if(ext->src_type == LV_IMG_SRC_FILE || ext->src_type == LV_IMG_SRC_VARIABLE) {
+            lv_img_cache_preload(ext->src, lv_obj_get_style_image_recolor(obj, LV_IMG_PART_MAIN));
+        }
+    }
+
+    lv_obj_t * child;
+    _LV_OBJ_CHILD_READ(obj, child) {
+        lv_img_prefetch(child);
+    }
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -577,6 +720,9 @@ static lv_design_res_t lv_img_design(lv_obj_t * img, const lv_area_t * clip_area
 
         if(ext->src_type == LV_IMG_SRC_UNKNOWN || ext->src_type == LV_IMG_SRC_SYMBOL) return LV_DESIGN_RES_NOT_COVER;
 
+        /*Only the background is drawn until the image is loaded*/
+        if(is_loading(img, lv_obj_get_style_image_recolor(img, LV_IMG_PART_MAIN))) return LV_DESIGN_RES_NOT_COVER;
+
         /*Non true color format might have "holes"*/
         if(ext->cf != LV_IMG_CF_TRUE_COLOR && ext->cf != LV_IMG_CF_RAW) return LV_DESIGN_RES_NOT_COVER;
 
@@ -670,6 +816,9 @@ static lv_design_res_t lv_img_design(lv_obj_t * img, const lv_area_t * clip_area
 
             if(img_dsc.zoom == 0) return LV_DESIGN_RES_OK;
 
+            /*Only the background is drawn as placeholder until the image is loaded*/
+            if(is_loading(img, img_dsc.recolor)) return LV_DESIGN_RES_OK;
+
             img_dsc.angle = angle_final;
 
             img_dsc.pivot.x = ext->pivot.x;
@@ -709,7 +858,8 @@ static lv_design_res_t lv_img_design(lv_obj_t * img, const lv_area_t * clip_area
                 coords_tmp.x1 = zoomed_coords.x1;
                 coords_tmp.x2 = zoomed_coords.x1 + ext->w - 1;
                 for(; coords_tmp.x1 < zoomed_coords.x2; coords_tmp.x1 += zoomed_src_w, coords_tmp.x2 += zoomed_src_w) {
-                    lv_draw_img(&coords_tmp, &clip_real, ext->src, &img_dsc);
+                    if(ext->atlas) lv_draw_img_atlas(&coords_tmp, &clip_real, ext->atlas, ext->atlas_id, &img_dsc);
+                    else lv_draw_img(&coords_tmp, &clip_real, ext->src, &img_dsc);
                 }
             }
         }
@@ -870,6 +1020,69 @@ static lv_res_t lv_img_signal(lv_obj_t * img, lv_signal_t sign, void * param)
     return res;
 }
 
+/**
+ * Tell whether an image is being loaded in the background.
+ * Start loading the image if it's asynchronous and it was not loaded yet.
+ * @param img pointer to an image object with file or variable source
+ * @param color the color of the image (recolor)
+ * @return true: the image is not available yet
+ */
+static bool is_loading(lv_obj_t * img, lv_color_t color)
+{
+    lv_img_ext_t * ext = lv_obj_get_ext_attr(img);
+    if(lv_img_cache_is_loading(ext->src, color)) return true;
+
+    /*Load only once in the background. If the image is closed by the cache later it's opened when drawn*/
+    if(ext->async == 0 || ext->async_started) return false;
+    ext->async_started = 1;
+    if(lv_img_cache_is_cached(ext->src, color)) return false;
+
+    return lv_img_cache_preload(ext->src, color) == LV_RES_OK;
+}
+
+/**
+ * Redraw the images of a source when its loading is finished
+ * @param src the source of the loaded image
+ */
+static void preload_ready_cb(const void * src)
+{
+    lv_disp_t * disp = lv_disp_get_next(NULL);
+    while(disp) {
+        lv_obj_t * scr;
+        _LV_LL_READ(disp->scr_ll, scr) {
+            invalidate_src(scr, src);
+        }
+        if(disp->top_layer) invalidate_src(disp->top_layer, src);
+        if(disp->sys_layer) invalidate_src(disp->sys_layer, src);
+
+        disp = lv_disp_get_next(disp);
+    }
+}
+
+/**
+ * Invalidate the image objects showing a source among an object and its children
+ * @param obj pointer to an object
+ * @param src an image source
+ */
+static void invalidate_src(lv_obj_t * obj, const void * src)
+{
+    if(lv_obj_get_design_cb(obj) == lv_img_design) {
+        lv_img_ext_t * ext = lv_obj_get_ext_attr(obj);
+        if(ext->src == src) {
+            lv_obj_invalidate(obj);
+        }
+        else if(ext->src_type == LV_IMG_SRC_FILE && lv_img_src_get_type(src) == LV_IMG_SRC_FILE &&
+                strcmp(ext->src, src) == 0) {
+            lv_obj_invalidate(obj);
+        }
+    }
+
+    lv_obj_t * child;
+    _LV_OBJ_CHILD_READ(obj, child) {
+        invalidate_src(child, src);
+    }
+}
+
 static lv_style_list_t * lv_img_get_style(lv_obj_t * img, uint8_t type)
 {
     lv_style_list_t * style_dsc_p;
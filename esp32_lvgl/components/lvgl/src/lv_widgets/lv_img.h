@@ -34,6 +34,7 @@ typedef struct {
     /*No inherited ext. because inherited from the base object*/ /*Ext. of ancestor*/
     /*New data for this type */
     const void * src; /*Image source: Pointer to an array or a file or a symbol*/
+    const lv_img_atlas_t * atlas; /*The atlas of the sprite set by `lv_img_set_src_atlas` or NULL*/
     lv_point_t offset;
     lv_coord_t w;          /*Width of the image (Handled by the library)*/
     lv_coord_t h;          /*Height of the image (Handled by the library)*/
@@ -44,6 +45,9 @@ typedef struct {
     uint8_t auto_size : 1; /*1: automatically set the object size to the image size*/
     uint8_t cf : 5;        /*Color format from `lv_img_color_format_t`*/
     uint8_t antialias : 1; /*Apply anti-aliasing in transformations (rotate, zoom)*/
+    uint8_t async : 1;     /*1: load the image in the background when it's drawn first*/
+    uint8_t async_started : 1; /*1: the background loading of the source was started (Handled by the library)*/
+    uint16_t atlas_id;     /*ID of the sprite in `atlas`*/
 } lv_img_ext_t;
 
 /*Image parts*/
@@ -75,6 +79,15 @@ lv_obj_t * lv_img_create(lv_obj_t * par, const lv_obj_t * copy);
  */
 void lv_img_set_src(lv_obj_t * img, const void * src_img);
 
+/**
+ * Set a sprite of an image atlas to display by the image.
+ * The sprites of an atlas share one image cache entry and are drawn directly from the atlas.
+ * @param img pointer to an image object
+ * @param atlas pointer to an image atlas. Only its pointer is saved so it should be static, global or dynamically allocated.
+ * @param id ID of the sprite in the atlas
+ */
+void lv_img_set_src_atlas(lv_obj_t * img, const lv_img_atlas_t * atlas, uint16_t id);
+
 /**
  * Enable the auto size feature.
  * If enabled the object size will be same as the picture size.
@@ -135,6 +148,15 @@ void lv_img_set_zoom(lv_obj_t * img, uint16_t zoom);
  */
 void lv_img_set_antialias(lv_obj_t * img, bool antialias);
 
+/**
+ * Enable/disable loading the image in the background (`lv_img_cache_preload()`) when it's drawn first.
+ * Until the image is loaded only the background of the object is drawn.
+ * Useful for files and images of slow decoders.
+ * @param img pointer to an image object
+ * @param en true: load in the background; false: load when drawn
+ */
+void lv_img_set_async(lv_obj_t * img, bool en);
+
 /*=====================
  * Getter functions
  *====================*/
@@ -146,6 +168,20 @@ void lv_img_set_antialias(lv_obj_t * img, bool antialias);
  */
 const void * lv_img_get_src(lv_obj_t * img);
 
+/**
+ * Get the atlas of the image's sprite
+ * @param img pointer to an image object
+ * @return the atlas set by `lv_img_set_src_atlas()` or NULL if the image is not a sprite
+ */
+const lv_img_atlas_t * lv_img_get_atlas(lv_obj_t * img);
+
+/**
+ * Get the ID of the image's sprite in its atlas
+ * @param img pointer to an image object
+ * @return ID of the sprite set by `lv_img_set_src_atlas()`
+ */
+uint16_t lv_img_get_atlas_id(lv_obj_t * img);
+
 /**
  * Get the name of the file set for an image
  * @param img pointer to an image
@@ -202,6 +238,24 @@ uint16_t lv_img_get_zoom(lv_obj_t * img);
  */
 bool lv_img_get_antialias(lv_obj_t * img);
 
+/**
+ * Get whether the image is loaded in the background when it's drawn first
+ * @param img pointer to an image object
+ * @return true: loaded in the background; false: loaded when drawn
+ */
+bool lv_img_get_async(lv_obj_t * img);
+
+/*=====================
+ * Other functions
+ *====================*/
+
+/**
+ * Start loading the images of an object and its children in the background (`lv_img_cache_preload()`),
+ * e.g. the images of the next screen, to show them without delay
+ * @param obj pointer to an object, e.g. a screen
+ */
+void lv_img_prefetch(lv_obj_t * obj);
+
 /**********************
  *      MACROS
  **********************/
@@ -209,6 +263,9 @@ bool lv_img_get_antialias(lv_obj_t * img);
 /*Use this macro to declare an image in a c file*/
 #define LV_IMG_DECLARE(var_name) extern const lv_img_dsc_t var_name;
 
+/*Use this macro to declare an image atlas in a c file*/
+#define LV_IMG_ATLAS_DECLARE(var_name) extern const lv_img_atlas_t var_name;
+
 #endif /*LV_USE_IMG*/
 
 #ifdef __cplusplus
@@ -184,6 +184,11 @@ void lv_label_set_text(lv_obj_t * label, const char * text)
 
     lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
 
+#if LV_USE_BIDI
+    /*The old text is reallocated or freed*/
+    if(ext->text) _lv_bidi_cache_invalidate(ext->text);
+#endif
+
     /*If text is NULL then just refresh with the current text */
     if(text == NULL) text = ext->text;
 
@@ -261,6 +266,9 @@ void lv_label_set_text_fmt(lv_obj_t * label, const char * fmt, ...)
         return;
     }
 
+#if LV_USE_BIDI
+    if(ext->text) _lv_bidi_cache_invalidate(ext->text);
+#endif
     if(ext->text != NULL && ext->static_txt == 0) {
         lv_mem_free(ext->text);
         ext->text = NULL;
@@ -286,6 +294,9 @@ void lv_label_set_text_static(lv_obj_t * label, const char * text)
     LV_ASSERT_OBJ(label, LV_OBJX_NAME);
 
     lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+#if LV_USE_BIDI
+    if(ext->text) _lv_bidi_cache_invalidate(ext->text);
+#endif
     if(ext->static_txt == 0 && ext->text != NULL) {
         lv_mem_free(ext->text);
         ext->text = NULL;
@@ -933,6 +944,10 @@ void lv_label_ins_text(lv_obj_t * label, uint32_t pos, const char * txt)
 
     lv_obj_invalidate(label);
 
+#if LV_USE_BIDI
+    _lv_bidi_cache_invalidate(ext->text);
+#endif
+
     /*Allocate space for the new text*/
     size_t old_len = strlen(ext->text);
     size_t ins_len = strlen(txt);
@@ -998,6 +1013,9 @@ void lv_label_refr_text(lv_obj_t * label)
 #if LV_LABEL_LONG_TXT_HINT
     ext->hint.line_start = -1; /*The hint is invalid if the text changes*/
 #endif
+#if LV_USE_BIDI
+    _lv_bidi_cache_invalidate(ext->text); /*The processed lines are invalid too*/
+#endif
 
     lv_area_t txt_coords;
     get_txt_coords(label, &txt_coords);
@@ -1359,6 +1377,9 @@ static lv_res_t lv_label_signal(lv_obj_t * label, lv_signal_t sign, void * param
 
     lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
     if(sign == LV_SIGNAL_CLEANUP) {
+#if LV_USE_BIDI
+        if(ext->text) _lv_bidi_cache_invalidate(ext->text);
+#endif
         if(ext->static_txt == 0) {
             lv_mem_free(ext->text);
             ext->text = NULL;
@@ -159,7 +159,10 @@ lv_obj_t * lv_list_add_btn(lv_obj_t * list, const void * img_src, const char * t
 
     /*Create a list element with the image an the text*/
     lv_obj_t * btn;
-    btn = lv_btn_create(list, NULL);
+    /*With suspended layout the page would move the button to the scrollable only on resume.
+     *Create it there directly to see it as the last button.*/
+    if(lv_obj_is_layout_suspended(list)) btn = lv_btn_create(scrl, NULL);
+    else btn = lv_btn_create(list, NULL);
 
     lv_obj_add_protect(btn, LV_PROTECT_CHILD_CHG);
 
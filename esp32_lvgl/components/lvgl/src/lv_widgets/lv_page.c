@@ -800,11 +800,15 @@ static lv_res_t lv_page_signal(lv_obj_t * page, lv_signal_t sign, void * param)
         lv_style_int_t scrl_right = lv_obj_get_style_pad_right(ext->scrl, LV_CONT_PART_MAIN);
         lv_style_int_t scrl_top = lv_obj_get_style_pad_top(ext->scrl, LV_CONT_PART_MAIN);
 
-        child = lv_obj_get_child(page, NULL);
+        /*Moving a child notifies the page again. Ignore it, the other children are moved here.*/
+        lv_obj_add_protect(page, LV_PROTECT_CHILD_CHG);
+
+        /*Move the oldest first to keep the order of the children added while the layout was suspended*/
+        child = lv_obj_get_child_back(page, NULL);
         while(child != NULL) {
             if(lv_obj_is_protected(child, LV_PROTECT_PARENT) == false) {
                 lv_obj_t * tmp = child;
-                child          = lv_obj_get_child(page, child); /*Get the next child before move this*/
+                child          = lv_obj_get_child_back(page, child); /*Get the next child before move this*/
 
                 /* Reposition the child to take padding into account
                  * It's required to keep new the object on the same coordinate if FIT is enabled.*/
@@ -827,9 +831,11 @@ static lv_res_t lv_page_signal(lv_obj_t * page, lv_signal_t sign, void * param)
                 lv_obj_set_parent(tmp, ext->scrl);
             }
             else {
-                child = lv_obj_get_child(page, child);
+                child = lv_obj_get_child_back(page, child);
             }
         }
+
+        lv_obj_clear_protect(page, LV_PROTECT_CHILD_CHG);
     }
     else if(sign == LV_SIGNAL_STYLE_CHG) {
         lv_style_int_t sb_width = lv_obj_get_style_size(page, LV_PAGE_PART_SCROLLBAR);
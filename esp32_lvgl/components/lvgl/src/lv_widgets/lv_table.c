@@ -303,6 +303,11 @@ void lv_table_set_row_cnt(lv_obj_t * table, uint16_t row_cnt)
         ext->row_h = lv_mem_realloc(ext->row_h, ext->row_cnt * sizeof(ext->row_h[0]));
         LV_ASSERT_MEM(ext->row_h);
         if(ext->row_h == NULL) return;
+
+        /*The new heights are set by `refr_size()`, possibly only when the layout is resumed*/
+        if(old_row_cnt < row_cnt) {
+            _lv_memset_00(&ext->row_h[old_row_cnt], (row_cnt - old_row_cnt) * sizeof(ext->row_h[0]));
+        }
     }
     else {
         lv_mem_free(ext->row_h);
@@ -1050,6 +1055,10 @@ static lv_res_t lv_table_signal(lv_obj_t * table, lv_signal_t sign, void * param
     else if(sign == LV_SIGNAL_STYLE_CHG) {
         refr_size(table);
     }
+    else if(sign == LV_SIGNAL_CHILD_CHG) {
+        /*Sent by `lv_obj_resume_layout()` if the size refresh was postponed*/
+        refr_size(table);
+    }
 
     return res;
 }
@@ -1080,6 +1089,9 @@ static lv_style_list_t * lv_table_get_style(lv_obj_t * table, uint8_t part)
 
 static void refr_size(lv_obj_t * table)
 {
+    /*Refresh only once when the layout is resumed*/
+    if(_lv_obj_postpone_layout(table)) return;
+
     lv_coord_t h = 0;
     lv_coord_t w = 0;
 
@@ -57,6 +57,7 @@ minimal_monochrome = {
   "LV_COLOR_DEPTH":1,
   "LV_USE_GROUP":0,
   "LV_USE_ANIMATION":0,
+  "LV_STYLE_CACHE_SIZE":0,
   "LV_ANTIALIAS":0,
   "LV_GPU":0,
   "LV_USE_FILESYSTEM":0,
@@ -207,6 +208,9 @@ all_obj_minimal_features = {
 all_obj_all_features = {
   "LV_DPI":100,
   "LV_MEM_SIZE":32*1024,
+  "LV_MEM_TLSF":1,
+  "LV_MEM_BUF_ARENA_SIZE":16*1024,
+  "LV_MEM_TRACE":1,
   "LV_HOR_RES_MAX":480,
   "LV_VER_RES_MAX":320,
   "LV_COLOR_DEPTH":32,
@@ -300,6 +304,16 @@ advanced_features = {
   "LV_USE_API_EXTENSION_V6":1,
   "LV_USE_USER_DATA":1,
   "LV_IMG_CACHE_DEF_SIZE":32,
+  "LV_STYLE_CACHE_SIZE":64,
+  "LV_STYLE_INDEX_PROP_CNT":8,
+  "LV_USE_OBJ_COMPACT":1,
+  "LV_MEM_SLAB_SIZE":256*1024,
+  "LV_MEM_TRACE":1,
+  "LV_IMG_DECODER_STRIP_SIZE":8*1024,
+  "LV_IMG_CACHE_VARIANT_MEM_SIZE":512*1024,
+  "LV_IMG_DECODER_COMPR_CACHE_SIZE":16*1024,
+  "LV_USE_PNG":1,
+  "LV_USE_JPG":1,
   "LV_USE_LOG":1,
   "LV_USE_THEME_MATERIAL":1,
   "LV_USE_THEME_EMPTY":1,
@@ -326,6 +340,7 @@ advanced_features = {
   "LV_FONT_MONTSERRAT_12_SUBPX":1,
   "LV_FONT_MONTSERRAT_28_COMPRESSED":1,
   "LV_FONT_UNSCII_8":1,
+  "LV_FONT_DEJAVU_16_PERSIAN_HEBREW":1,
   "LV_USE_BIDI": 1,
   "LV_USE_REVERSE_ARABIC_PERSIAN_CHARS":1,
   "LV_USE_OBJ_REALIGN": 1,
@@ -334,6 +349,7 @@ advanced_features = {
   "LV_USE_BIDI": 1,
   "LV_USE_OBJ_REALIGN": 1,
   "LV_USE_EXT_CLICK_AREA":"LV_EXT_CLICK_AREA_FULL",
+  "LV_LABEL_TEXT_SEL":1,
   "LV_USE_ARC":1,
   "LV_USE_BAR":1,
   "LV_USE_BTN":1,
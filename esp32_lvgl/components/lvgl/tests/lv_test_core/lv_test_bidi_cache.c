@@ -0,0 +1,201 @@
+/**
+ * @file lv_test_bidi_cache.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../lvgl.h"
+#if LV_BUILD_TEST
+#include "../lv_test_assert.h"
+
+#include "lv_test_bidi_cache.h"
+
+#if LV_USE_BIDI && LV_FONT_DEJAVU_16_PERSIAN_HEBREW
+#include <string.h>
+#include <time.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BENCH_ROUNDS    100
+#define BENCH_CACHE_SIZE    (16 * 1024)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void test_get(void);
+static void test_label(void);
+static void bench(void);
+static lv_obj_t * create_label(void);
+static void refr_obj(lv_obj_t * obj);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const char * mixed_txt =
+    "Hello שלום עולם (123) world, سلام دنیا 2021!\n"
+    "מזל טוב - LVGL: کتابخانه گرافیکی [v7.11] for MCUs\n"
+    "abc אבג def سلام 456 שלום, 789 دنیا xyz.\n"
+    "ספרייה גרפית קטנה עם widgets ו-אנימציות, نسخه ۷ کامل شده.";
+
+extern lv_color_t test_fb[];    /*Defined in lv_test_main.c*/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_bidi_cache(void)
+{
+    lv_test_print("");
+    lv_test_print("===================");
+    lv_test_print("Start lv_bidi_cache tests");
+    lv_test_print("===================");
+
+    test_get();
+    test_label();
+    bench();
+
+    _lv_bidi_cache_set_size(LV_BIDI_CACHE_SIZE);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_get(void)
+{
+    lv_test_print("");
+    lv_test_print("Get processed lines from the cache");
+    lv_test_print("---------------------------");
+
+    _lv_bidi_cache_set_size(1024);
+
+    static char line[64];
+    static char ref[64];
+    static uint16_t ref_pos_conv[64];
+    strcpy(line, "abc שלום (12) def");
+    uint32_t len = strlen(line);
+    uint32_t pos_conv_len = _lv_txt_get_encoded_length(line);
+
+    const uint16_t * pos_conv = NULL;
+    const char * act = _lv_bidi_cache_get(line, len, LV_BIDI_DIR_RTL, &pos_conv);
+    _lv_bidi_process_paragraph(line, ref, len, LV_BIDI_DIR_RTL, ref_pos_conv, pos_conv_len);
+    lv_test_assert_true(act != NULL, "Line cached");
+    lv_test_assert_str_eq(ref, act, "Cached line is processed");
+    lv_test_assert_array_eq((const uint8_t *)ref_pos_conv, (const uint8_t *)pos_conv, pos_conv_len * sizeof(uint16_t),
+                            "Cached position conversion");
+
+    lv_test_assert_ptr_eq(act, _lv_bidi_cache_get(line, len, LV_BIDI_DIR_RTL, NULL), "Cache hit");
+    lv_test_assert_true(act != _lv_bidi_cache_get(line, len, LV_BIDI_DIR_LTR, NULL), "Base dir is part of the key");
+
+    /*A static text modified in place shouldn't be served from the cache*/
+    memcpy(line, "xyz", 3);
+    act = _lv_bidi_cache_get(line, len, LV_BIDI_DIR_RTL, NULL);
+    _lv_bidi_process_paragraph(line, ref, len, LV_BIDI_DIR_RTL, NULL, 0);
+    lv_test_assert_str_eq(ref, act, "Modified line is processed again");
+
+    _lv_bidi_cache_invalidate(line);
+    act = _lv_bidi_cache_get(line, len, LV_BIDI_DIR_RTL, NULL);
+    lv_test_assert_str_eq(ref, act, "Invalidated line is processed again");
+
+    _lv_bidi_cache_set_size(len);
+    lv_test_assert_ptr_eq(NULL, _lv_bidi_cache_get(line, len, LV_BIDI_DIR_RTL, NULL), "Too long line is not cached");
+
+    _lv_bidi_cache_set_size(0);
+    lv_test_assert_ptr_eq(NULL, _lv_bidi_cache_get(line, len, LV_BIDI_DIR_RTL, NULL), "Disabled cache");
+}
+
+static void test_label(void)
+{
+    lv_test_print("");
+    lv_test_print("Draw a mixed direction label with and without cache");
+    lv_test_print("---------------------------");
+
+    static lv_color_t fb_ref[LV_HOR_RES_MAX * LV_VER_RES_MAX];
+    uint32_t fb_size = LV_HOR_RES_MAX * LV_VER_RES_MAX * sizeof(lv_color_t);
+
+    lv_obj_t * label = create_label();
+#if LV_LABEL_TEXT_SEL
+    lv_label_set_text_sel_start(label, 10);
+    lv_label_set_text_sel_end(label, 70);
+#endif
+
+    _lv_bidi_cache_set_size(0);
+    refr_obj(lv_scr_act());
+    memcpy(fb_ref, test_fb, fb_size);
+
+    _lv_bidi_cache_set_size(BENCH_CACHE_SIZE);
+    refr_obj(lv_scr_act());
+    lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, "Draw from empty cache");
+    refr_obj(lv_scr_act());
+    lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, "Draw from filled cache");
+
+    /*The new text has to be drawn, not the cached lines of the old one*/
+    lv_label_set_text(label, "abc שלום עולם def");
+    refr_obj(lv_scr_act());
+    memcpy(fb_ref, test_fb, fb_size);
+    _lv_bidi_cache_set_size(0);
+    refr_obj(lv_scr_act());
+    lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, "Draw after text change");
+
+    lv_obj_del(label);
+}
+
+static void bench(void)
+{
+    lv_obj_t * label = create_label();
+    uint32_t r;
+
+    _lv_bidi_cache_set_size(0);
+    clock_t t_ref = clock();
+    for(r = 0; r < BENCH_ROUNDS; r++) refr_obj(label);
+    t_ref = clock() - t_ref;
+
+    _lv_bidi_cache_set_size(BENCH_CACHE_SIZE);
+    clock_t t_act = clock();
+    for(r = 0; r < BENCH_ROUNDS; r++) refr_obj(label);
+    t_act = clock() - t_act;
+
+    lv_test_print("Redraw a mixed direction label %d times: uncached: %d us, cached: %d us", BENCH_ROUNDS,
+                  (int)((int64_t)t_ref * 1000000 / CLOCKS_PER_SEC), (int)((int64_t)t_act * 1000000 / CLOCKS_PER_SEC));
+
+    lv_obj_del(label);
+}
+
+static lv_obj_t * create_label(void)
+{
+    lv_obj_t * label = lv_label_create(lv_scr_act(), NULL);
+    lv_obj_set_style_local_text_font(label, LV_LABEL_PART_MAIN, LV_STATE_DEFAULT, &lv_font_dejavu_16_persian_hebrew);
+    lv_obj_set_base_dir(label, LV_BIDI_DIR_RTL);
+    lv_label_set_long_mode(label, LV_LABEL_LONG_BREAK);
+    lv_obj_set_width(label, LV_HOR_RES / 2);
+    lv_label_set_text_static(label, mixed_txt);
+
+    return label;
+}
+
+static void refr_obj(lv_obj_t * obj)
+{
+    lv_obj_invalidate(obj);
+    lv_refr_now(NULL);
+}
+
+#else
+
+void lv_test_bidi_cache(void)
+{
+}
+
+#endif /*LV_USE_BIDI && LV_FONT_DEJAVU_16_PERSIAN_HEBREW*/
+#endif /*LV_BUILD_TEST*/
@@ -13,6 +13,25 @@
 #include "lv_test_obj.h"
 #include "lv_test_style.h"
 #include "lv_test_font_loader.h"
+#include "lv_test_font_compr.h"
+#include "lv_test_bidi_cache.h"
+#include "lv_test_font_subpx.h"
+#include "lv_test_img_cache.h"
+#include "lv_test_img_strip.h"
+#include "lv_test_img_unpack.h"
+#include "lv_test_img_transform.h"
+#include "lv_test_img_variant.h"
+#include "lv_test_img_compr.h"
+#include "lv_test_img_png_jpg.h"
+#include "lv_test_img_atlas.h"
+#include "lv_test_img_recolor.h"
+#include "lv_test_img_preload.h"
+#include "lv_test_style_cache.h"
+#include "lv_test_style_index.h"
+#include "lv_test_style_const.h"
+#include "lv_test_style_trans.h"
+#include "lv_test_obj_tree.h"
+#include "lv_test_mem.h"
 
 /*********************
  *      DEFINES
@@ -48,6 +67,25 @@ void lv_test_core(void)
     lv_test_obj();
     lv_test_style();
     lv_test_font_loader();
+    lv_test_font_compr();
+    lv_test_bidi_cache();
+    lv_test_font_subpx();
+    lv_test_img_cache();
+    lv_test_img_strip();
+    lv_test_img_unpack();
+    lv_test_img_transform();
+    lv_test_img_variant();
+    lv_test_img_compr();
+    lv_test_img_png_jpg();
+    lv_test_img_atlas();
+    lv_test_img_recolor();
+    lv_test_img_preload();
+    lv_test_style_cache();
+    lv_test_style_index();
+    lv_test_style_const();
+    lv_test_style_trans();
+    lv_test_obj_tree();
+    lv_test_mem();
 }
 
 /**********************
@@ -0,0 +1,252 @@
+/**
+ * @file lv_test_font_compr.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../lvgl.h"
+#if LV_BUILD_TEST
+#include "../lv_test_assert.h"
+#include "../src/lv_font/lv_font_fmt_txt.h"
+
+#include "lv_test_font_compr.h"
+
+#if LV_USE_FONT_COMPRESSED && LV_FONT_MONTSERRAT_28_COMPRESSED
+#include <time.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BENCH_ROUNDS    100
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void ref_decompress(const uint8_t * in, uint8_t * out, lv_coord_t w, lv_coord_t h, uint8_t bpp, bool prefilter);
+static uint32_t get_glyph_cnt(const lv_font_fmt_txt_dsc_t * fdsc);
+static void test_identical(bool prefilter);
+static void bench(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static uint8_t buf_ref[64 * 64];
+static uint8_t buf_act[64 * 64];
+static uint8_t line_buf[256];
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_font_compr(void)
+{
+    lv_test_print("");
+    lv_test_print("===================");
+    lv_test_print("Start lv_font_compr tests");
+    lv_test_print("===================");
+
+    test_identical(true);
+    test_identical(false);
+    bench();
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static uint32_t get_glyph_cnt(const lv_font_fmt_txt_dsc_t * fdsc)
+{
+    uint32_t cnt = 0;
+    uint32_t i;
+    for(i = 0; i < fdsc->cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t * cmap = &fdsc->cmaps[i];
+        uint32_t len = cmap->type == LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY ? cmap->range_length : cmap->list_length;
+        if(cmap->glyph_id_start + len > cnt) cnt = cmap->glyph_id_start + len;
+    }
+    return cnt;
+}
+
+static void test_identical(bool prefilter)
+{
+    lv_test_print("Decompress all glyphs (prefilter: %d)", prefilter);
+
+    const lv_font_fmt_txt_dsc_t * fdsc = lv_font_montserrat_28_compressed.dsc;
+    uint32_t glyph_cnt = get_glyph_cnt(fdsc);
+    uint32_t gid;
+    for(gid = 1; gid < glyph_cnt; gid++) {
+        const lv_font_fmt_txt_glyph_dsc_t * gdsc = &fdsc->glyph_dsc[gid];
+        uint32_t size = (gdsc->box_w * gdsc->box_h * fdsc->bpp + 7) / 8;
+        if(size == 0) continue;
+
+        /*Check that nothing is written after the bitmap*/
+        _lv_memset(buf_act, 0xAA, sizeof(buf_act));
+        ref_decompress(&fdsc->glyph_bitmap[gdsc->bitmap_index], buf_ref, gdsc->box_w, gdsc->box_h, fdsc->bpp, prefilter);
+        _lv_font_fmt_txt_decompress(&fdsc->glyph_bitmap[gdsc->bitmap_index], buf_act, gdsc->box_w, gdsc->box_h,
+                                    fdsc->bpp, prefilter, line_buf);
+        lv_test_assert_array_eq(buf_ref, buf_act, size, "Decompressed glyph");
+        lv_test_assert_int_eq(0xAA, buf_act[size], "No write after the glyph");
+    }
+}
+
+static void bench(void)
+{
+    const lv_font_fmt_txt_dsc_t * fdsc = lv_font_montserrat_28_compressed.dsc;
+    uint32_t glyph_cnt = get_glyph_cnt(fdsc);
+    uint32_t r;
+    uint32_t gid;
+
+    clock_t t_ref = clock();
+    for(r = 0; r < BENCH_ROUNDS; r++) {
+        for(gid = 1; gid < glyph_cnt; gid++) {
+            const lv_font_fmt_txt_glyph_dsc_t * gdsc = &fdsc->glyph_dsc[gid];
+            ref_decompress(&fdsc->glyph_bitmap[gdsc->bitmap_index], buf_ref, gdsc->box_w, gdsc->box_h, fdsc->bpp, true);
+        }
+    }
+    t_ref = clock() - t_ref;
+
+    clock_t t_act = clock();
+    for(r = 0; r < BENCH_ROUNDS; r++) {
+        for(gid = 1; gid < glyph_cnt; gid++) {
+            const lv_font_fmt_txt_glyph_dsc_t * gdsc = &fdsc->glyph_dsc[gid];
+            _lv_font_fmt_txt_decompress(&fdsc->glyph_bitmap[gdsc->bitmap_index], buf_act, gdsc->box_w, gdsc->box_h,
+                                        fdsc->bpp, true, line_buf);
+        }
+    }
+    t_act = clock() - t_act;
+
+    lv_test_print("Decompress %d glyphs %d times: bitwise: %d us, buffered: %d us",
+                  glyph_cnt - 1, BENCH_ROUNDS,
+                  (int)((int64_t)t_ref * 1000000 / CLOCKS_PER_SEC), (int)((int64_t)t_act * 1000000 / CLOCKS_PER_SEC));
+}
+
+/*The former bit-by-bit decompressor with global state as reference*/
+static uint32_t ref_rdp;
+static const uint8_t * ref_in;
+static uint8_t ref_bpp;
+static uint8_t ref_prev_v;
+static uint8_t ref_cnt;
+static uint8_t ref_state;
+
+static uint8_t ref_get_bits(const uint8_t * in, uint32_t bit_pos, uint8_t len)
+{
+    uint8_t bit_mask = (uint16_t)((uint16_t) 1 << len) - 1;
+    uint32_t byte_pos = bit_pos >> 3;
+    bit_pos = bit_pos & 0x7;
+
+    if(bit_pos + len >= 8) {
+        uint16_t in16 = (in[byte_pos] << 8) + in[byte_pos + 1];
+        return (in16 >> (16 - bit_pos - len)) & bit_mask;
+    }
+    else {
+        return (in[byte_pos] >> (8 - bit_pos - len)) & bit_mask;
+    }
+}
+
+static uint8_t ref_rle_next(void)
+{
+    uint8_t ret = 0;
+    if(ref_state == 0) {
+        ret = ref_get_bits(ref_in, ref_rdp, ref_bpp);
+        if(ref_rdp != 0 && ref_prev_v == ret) {
+            ref_cnt = 0;
+            ref_state = 1;
+        }
+        ref_prev_v = ret;
+        ref_rdp += ref_bpp;
+    }
+    else if(ref_state == 1) {
+        uint8_t v = ref_get_bits(ref_in, ref_rdp, 1);
+        ref_cnt++;
+        ref_rdp += 1;
+        if(v == 1) {
+            ret = ref_prev_v;
+            if(ref_cnt == 11) {
+                ref_cnt = ref_get_bits(ref_in, ref_rdp, 6);
+                ref_rdp += 6;
+                if(ref_cnt != 0) {
+                    ref_state = 2;
+                }
+                else {
+                    ret = ref_get_bits(ref_in, ref_rdp, ref_bpp);
+                    ref_prev_v = ret;
+                    ref_rdp += ref_bpp;
+                    ref_state = 0;
+                }
+            }
+        }
+        else {
+            ret = ref_get_bits(ref_in, ref_rdp, ref_bpp);
+            ref_prev_v = ret;
+            ref_rdp += ref_bpp;
+            ref_state = 0;
+        }
+    }
+    else {
+        ret = ref_prev_v;
+        ref_cnt--;
+        if(ref_cnt == 0) {
+            ret = ref_get_bits(ref_in, ref_rdp, ref_bpp);
+            ref_prev_v = ret;
+            ref_rdp += ref_bpp;
+            ref_state = 0;
+        }
+    }
+
+    return ret;
+}
+
+static void ref_bits_write(uint8_t * out, uint32_t bit_pos, uint8_t val, uint8_t len)
+{
+    uint16_t byte_pos = bit_pos >> 3;
+    bit_pos = bit_pos & 0x7;
+    bit_pos = 8 - bit_pos - len;
+
+    uint8_t bit_mask = (uint16_t)((uint16_t) 1 << len) - 1;
+    out[byte_pos] &= ((~bit_mask) << bit_pos);
+    out[byte_pos] |= (val << bit_pos);
+}
+
+static void ref_decompress(const uint8_t * in, uint8_t * out, lv_coord_t w, lv_coord_t h, uint8_t bpp, bool prefilter)
+{
+    static uint8_t line1[256];
+    static uint8_t line2[256];
+    uint32_t wrp = 0;
+    lv_coord_t x;
+    lv_coord_t y;
+
+    ref_in = in;
+    ref_bpp = bpp;
+    ref_state = 0;
+    ref_rdp = 0;
+    ref_prev_v = 0;
+    ref_cnt = 0;
+
+    for(y = 0; y < h; y++) {
+        for(x = 0; x < w; x++) {
+            line2[x] = ref_rle_next();
+            line1[x] = (prefilter && y > 0) ? line1[x] ^ line2[x] : line2[x];
+            ref_bits_write(out, wrp, line1[x], bpp);
+            wrp += bpp;
+        }
+    }
+}
+
+#else
+
+void lv_test_font_compr(void)
+{
+}
+
+#endif /*LV_USE_FONT_COMPRESSED && LV_FONT_MONTSERRAT_28_COMPRESSED*/
+#endif /*LV_BUILD_TEST*/
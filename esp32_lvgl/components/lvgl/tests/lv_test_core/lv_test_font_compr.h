@@ -0,0 +1,38 @@
+/**
+ * @file lv_test_font_compr.h
+ *
+ */
+
+#ifndef LV_TEST_FONT_COMPR_H
+#define LV_TEST_FONT_COMPR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void lv_test_font_compr(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_TEST_FONT_COMPR_H*/
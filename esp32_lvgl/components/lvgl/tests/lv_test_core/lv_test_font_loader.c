@@ -16,6 +16,11 @@
 
 #include "lv_test_font_loader.h"
 
+#if LV_USE_FILESYSTEM
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpedantic"
 
@@ -33,6 +38,9 @@
 
 #if LV_USE_FILESYSTEM
 static int compare_fonts(lv_font_t * f1, lv_font_t * f2);
+static void compare_glyphs(lv_font_t * f_ref, lv_font_t * f_act);
+static void test_paged(lv_font_t * f_ref, const char * fn);
+static void map_drv_init(void);
 #endif
 
 /**********************
@@ -70,6 +78,12 @@ void lv_test_font_loader(void)
     lv_font_free(font_1_bin);
     lv_font_free(font_2_bin);
     lv_font_free(font_3_bin);
+
+    map_drv_init();
+
+    test_paged(&font_1, "font_1.fnt");
+    test_paged(&font_2, "font_2.fnt");
+    test_paged(&font_3, "font_3.fnt");
 #else
     lv_test_print("SKIP: font load test because it requires LV_USE_FILESYSTEM 1 and LV_FONT_FMT_TXT_LARGE 0");
 #endif
@@ -213,6 +227,180 @@ static int compare_fonts(lv_font_t * f1, lv_font_t * f2)
     LV_LOG_INFO("No differences found!");
     return 0;
 }
+
+/*Compare the descriptors and the drawable bitmaps of all glyphs through the font API*/
+static void compare_glyphs(lv_font_t * f_ref, lv_font_t * f_act)
+{
+    lv_font_fmt_txt_dsc_t * dsc = (lv_font_fmt_txt_dsc_t *) f_ref->dsc;
+
+    for(int i = 0; i < dsc->cmap_num; ++i) {
+        const lv_font_fmt_txt_cmap_t * cmap = &dsc->cmaps[i];
+        uint32_t cnt = cmap->unicode_list ? cmap->list_length : cmap->range_length;
+        for(uint32_t k = 0; k < cnt; k++) {
+            uint32_t letter = cmap->range_start + (cmap->unicode_list ? cmap->unicode_list[k] : k);
+
+            lv_font_glyph_dsc_t g_ref;
+            lv_font_glyph_dsc_t g_act;
+            bool ret_ref = lv_font_get_glyph_dsc(f_ref, &g_ref, letter, '\0');
+            bool ret_act = lv_font_get_glyph_dsc(f_act, &g_act, letter, '\0');
+            lv_test_assert_int_eq(ret_ref, ret_act, "glyph found");
+            if(!ret_ref) continue;
+
+            lv_test_assert_int_eq(g_ref.adv_w, g_act.adv_w, "adv_w");
+            lv_test_assert_int_eq(g_ref.box_w, g_act.box_w, "box_w");
+            lv_test_assert_int_eq(g_ref.box_h, g_act.box_h, "box_h");
+            lv_test_assert_int_eq(g_ref.ofs_x, g_act.ofs_x, "ofs_x");
+            lv_test_assert_int_eq(g_ref.ofs_y, g_act.ofs_y, "ofs_y");
+            if(g_ref.box_w * g_ref.box_h == 0) continue;
+
+            /*Compressed bitmaps share the decompress buffer so save the reference*/
+            uint32_t size = (g_ref.box_w * g_ref.box_h * g_ref.bpp + 7) >> 3;
+            uint8_t * bmp_ref = lv_mem_alloc(size);
+            _lv_memcpy(bmp_ref, lv_font_get_glyph_bitmap(f_ref, letter), size);
+
+            const uint8_t * bmp_act = lv_font_get_glyph_bitmap(f_act, letter);
+            lv_test_assert_true(bmp_act != NULL, "paged glyph_bitmap");
+            lv_test_assert_array_eq(bmp_ref, bmp_act, size, "paged glyph_bitmap");
+            lv_mem_free(bmp_ref);
+        }
+    }
+}
+
+static void test_paged(lv_font_t * f_ref, const char * fn)
+{
+    char path[32];
+    lv_font_paged_info_t info;
+
+    /*Load the fonts with a small cache to exercise the eviction too*/
+    lv_snprintf(path, sizeof(path), "f:%s", fn);
+
+#if LV_MEM_CUSTOM == 0
+    lv_mem_monitor_t mon_start;
+    lv_mem_monitor_t mon_end;
+    lv_mem_monitor(&mon_start);
+    lv_font_t * font_full = lv_font_load(path);
+    lv_mem_monitor(&mon_end);
+    lv_test_print("%s: full: %d bytes resident", fn, mon_start.free_size - mon_end.free_size);
+    lv_font_free(font_full);
+#endif
+
+    lv_font_t * font_paged = lv_font_load_paged(path, 256);
+    lv_test_assert_true(font_paged != NULL, "paged font loaded");
+
+    compare_glyphs(f_ref, font_paged);
+    compare_glyphs(f_ref, font_paged);
+
+    lv_font_get_paged_info(font_paged, &info);
+    uint32_t hit_prev = info.cache_hit;
+    lv_font_get_glyph_bitmap(font_paged, 'A');
+    lv_font_get_glyph_bitmap(font_paged, 'A');
+
+    lv_font_get_paged_info(font_paged, &info);
+    lv_test_assert_int_eq(0, info.mapped, "paged font not mapped");
+    lv_test_assert_true(info.cache_miss > 0, "paged font cache miss");
+    lv_test_assert_int_eq(hit_prev + 1, info.cache_hit, "paged font cache hit");
+    lv_test_assert_true(info.cache_size > 0, "paged font cache size");
+    lv_test_print("%s: paged: %d bytes resident, %d bytes cache, %d ms load, %d hit, %d miss",
+                  fn, info.resident_size, info.cache_size, info.load_time, info.cache_hit, info.cache_miss);
+    lv_font_free(font_paged);
+
+    /*The map driver's files are in the memory so the bitmaps are not copied*/
+    lv_snprintf(path, sizeof(path), "m:%s", fn);
+    font_paged = lv_font_load_paged(path, 4096);
+    lv_test_assert_true(font_paged != NULL, "mapped font loaded");
+
+    compare_glyphs(f_ref, font_paged);
+
+    lv_font_get_paged_info(font_paged, &info);
+    lv_test_assert_int_eq(1, info.mapped, "mapped font");
+    lv_test_print("%s: mapped: %d bytes resident, %d ms load, %d hit, %d miss",
+                  fn, info.resident_size, info.load_time, info.cache_hit, info.cache_miss);
+    lv_font_free(font_paged);
+}
+
+/*A driver which reads the whole file into the memory on open to test `map_cb`*/
+typedef struct {
+    uint8_t * data;
+    uint32_t size;
+    uint32_t pos;
+} map_file_t;
+
+static lv_fs_res_t map_open_cb(struct _lv_fs_drv_t * drv, void * file_p, const char * path, lv_fs_mode_t mode)
+{
+    (void) drv;
+    (void) mode;
+
+    map_file_t * f = file_p;
+    FILE * fp = fopen(path, "rb");
+    if(fp == NULL) return LV_FS_RES_NOT_EX;
+
+    fseek(fp, 0, SEEK_END);
+    f->size = ftell(fp);
+    f->pos = 0;
+    f->data = malloc(f->size);
+    fseek(fp, 0, SEEK_SET);
+    size_t br = fread(f->data, 1, f->size, fp);
+    fclose(fp);
+
+    return br == f->size ? LV_FS_RES_OK : LV_FS_RES_FS_ERR;
+}
+
+static lv_fs_res_t map_close_cb(struct _lv_fs_drv_t * drv, void * file_p)
+{
+    (void) drv;
+
+    map_file_t * f = file_p;
+    free(f->data);
+    return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t map_read_cb(struct _lv_fs_drv_t * drv, void * file_p, void * buf, uint32_t btr, uint32_t * br)
+{
+    (void) drv;
+
+    map_file_t * f = file_p;
+    if(f->pos + btr > f->size) btr = f->size - f->pos;
+    _lv_memcpy(buf, &f->data[f->pos], btr);
+    f->pos += btr;
+    *br = btr;
+    return btr == 0 ? LV_FS_RES_UNKNOWN : LV_FS_RES_OK;
+}
+
+static lv_fs_res_t map_seek_cb(struct _lv_fs_drv_t * drv, void * file_p, uint32_t pos)
+{
+    (void) drv;
+
+    map_file_t * f = file_p;
+    f->pos = pos;
+    return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t map_map_cb(struct _lv_fs_drv_t * drv, void * file_p, const void ** buf_p)
+{
+    (void) drv;
+
+    map_file_t * f = file_p;
+    *buf_p = f->data;
+    return LV_FS_RES_OK;
+}
+
+static void map_drv_init(void)
+{
+    if(lv_fs_get_drv('m')) return;
+
+    lv_fs_drv_t drv;
+    lv_fs_drv_init(&drv);
+
+    drv.letter = 'm';
+    drv.file_size = sizeof(map_file_t);
+    drv.open_cb = map_open_cb;
+    drv.close_cb = map_close_cb;
+    drv.read_cb = map_read_cb;
+    drv.seek_cb = map_seek_cb;
+    drv.map_cb = map_map_cb;
+
+    lv_fs_drv_register(&drv);
+}
 #endif
 
 #pragma GCC diagnostic pop
@@ -0,0 +1,251 @@
+/**
+ * @file lv_test_font_subpx.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../lvgl.h"
+#if LV_BUILD_TEST
+#include "../lv_test_assert.h"
+#include "../src/lv_font/lv_font_fmt_txt.h"
+
+#include "lv_test_font_subpx.h"
+
+#if LV_USE_FONT_SUBPX && LV_FONT_MONTSERRAT_12 && LV_FONT_MONTSERRAT_12_SUBPX
+#include <string.h>
+#include <time.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BENCH_ROUNDS    100
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool lcd_font_create(void);
+static void lcd_font_free(void);
+static uint8_t get_px(const uint8_t * bitmap, uint32_t bit_pos);
+static void set_px(uint8_t * bitmap, uint32_t bit_pos, uint8_t v);
+static void test_identical(lv_opa_t opa);
+static void bench(void);
+static lv_obj_t * create_label(const lv_font_t * font, lv_opa_t opa);
+static void refr_obj(lv_obj_t * obj);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_font_t lcd_font;
+static lv_font_fmt_txt_dsc_t lcd_dsc;
+static lv_font_fmt_txt_glyph_dsc_t * lcd_glyph_dsc;
+static uint8_t * lcd_bitmap;
+
+static const char * bench_txt =
+    "The quick brown fox jumps over the lazy dog. 0123456789\n"
+    "Sub-pixel rendering triples the horizontal resolution\n"
+    "of the text on LCD panels with RGB or BGR stripes.\n"
+    "THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG! (#%&@)";
+
+extern lv_color_t test_fb[];    /*Defined in lv_test_main.c*/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_font_subpx(void)
+{
+    lv_test_print("");
+    lv_test_print("===================");
+    lv_test_print("Start lv_font_subpx tests");
+    lv_test_print("===================");
+
+    if(!lcd_font_create()) {
+        lv_test_error("Couldn't create the sub-pixel font");
+        return;
+    }
+
+    test_identical(LV_OPA_COVER);
+    test_identical(LV_OPA_50);
+    bench();
+
+    lcd_font_free();
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * The shipped `lv_font_montserrat_12_subpx` has no LCD data.
+ * Create a horizontal sub-pixel font from it like `lv_font_conv --lcd` would:
+ * sample every glyph at 3x horizontal resolution and apply the usual 5-tap FIR filter.
+ */
+static bool lcd_font_create(void)
+{
+    static const uint8_t fir[5] = {8, 77, 86, 77, 8};
+    const lv_font_fmt_txt_dsc_t * src = lv_font_montserrat_12_subpx.dsc;
+
+    uint32_t glyph_cnt = 0;
+    uint32_t i;
+    for(i = 0; i < src->cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t * cmap = &src->cmaps[i];
+        uint32_t len = cmap->type == LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY ? cmap->range_length : cmap->list_length;
+        if(cmap->glyph_id_start + len > glyph_cnt) glyph_cnt = cmap->glyph_id_start + len;
+    }
+
+    uint32_t bitmap_size = 0;
+    for(i = 1; i < glyph_cnt; i++) {
+        bitmap_size += (src->glyph_dsc[i].box_w * 3 * src->glyph_dsc[i].box_h * 4 + 7) / 8;
+    }
+
+    lcd_glyph_dsc = lv_mem_alloc(glyph_cnt * sizeof(lv_font_fmt_txt_glyph_dsc_t));
+    lcd_bitmap = lv_mem_alloc(bitmap_size);
+    if(lcd_glyph_dsc == NULL || lcd_bitmap == NULL) return false;
+    _lv_memset_00(lcd_bitmap, bitmap_size);
+
+    uint32_t bitmap_index = 0;
+    lcd_glyph_dsc[0] = src->glyph_dsc[0];
+    for(i = 1; i < glyph_cnt; i++) {
+        const lv_font_fmt_txt_glyph_dsc_t * gsrc = &src->glyph_dsc[i];
+        const uint8_t * bmp_src = &src->glyph_bitmap[gsrc->bitmap_index];
+        int32_t w = gsrc->box_w;
+        int32_t x, y, k;
+
+        lcd_glyph_dsc[i] = *gsrc;
+        lcd_glyph_dsc[i].bitmap_index = bitmap_index;
+        lcd_glyph_dsc[i].box_w = w * 3;
+
+        for(y = 0; y < gsrc->box_h; y++) {
+            for(x = 0; x < w * 3; x++) {
+                uint32_t sum = 0;
+                for(k = -2; k <= 2; k++) {
+                    int32_t sx = (x + k) / 3;
+                    if(x + k < 0 || sx >= w) continue;
+                    sum += fir[k + 2] * get_px(bmp_src, (y * w + sx) * 4) * 17;
+                }
+                set_px(&lcd_bitmap[bitmap_index], (y * w * 3 + x) * 4, ((sum >> 8) + 8) / 17);
+            }
+        }
+        bitmap_index += (w * 3 * gsrc->box_h * 4 + 7) / 8;
+    }
+
+    lcd_dsc = *src;
+    lcd_dsc.glyph_bitmap = lcd_bitmap;
+    lcd_dsc.glyph_dsc = lcd_glyph_dsc;
+
+    lcd_font = lv_font_montserrat_12_subpx;
+    lcd_font.dsc = &lcd_dsc;
+    lcd_font.subpx = LV_FONT_SUBPX_HOR;
+
+    return true;
+}
+
+static void lcd_font_free(void)
+{
+    lv_mem_free(lcd_glyph_dsc);
+    lv_mem_free(lcd_bitmap);
+    lcd_glyph_dsc = NULL;
+    lcd_bitmap = NULL;
+}
+
+static uint8_t get_px(const uint8_t * bitmap, uint32_t bit_pos)
+{
+    return (bitmap[bit_pos >> 3] >> (4 - (bit_pos & 0x7))) & 0xF;
+}
+
+static void set_px(uint8_t * bitmap, uint32_t bit_pos, uint8_t v)
+{
+    if(v > 0xF) v = 0xF;
+    bitmap[bit_pos >> 3] |= v << (4 - (bit_pos & 0x7));
+}
+
+/**
+ * Draw the same text directly and through the general (masked) path and compare the results.
+ * A mask covering everything forces the general path without changing the result.
+ */
+static void test_identical(lv_opa_t opa)
+{
+    lv_test_print("");
+    lv_test_print("Draw sub-pixel text with opa %d", opa);
+    lv_test_print("---------------------------");
+
+    static lv_color_t fb_ref[LV_HOR_RES_MAX * LV_VER_RES_MAX];
+    uint32_t fb_size = LV_HOR_RES_MAX * LV_VER_RES_MAX * sizeof(lv_color_t);
+
+    lv_obj_t * label = create_label(&lcd_font, opa);
+    refr_obj(lv_scr_act());
+    memcpy(fb_ref, test_fb, fb_size);
+
+    lv_area_t a = {-LV_COORD_MAX / 2, -LV_COORD_MAX / 2, LV_COORD_MAX / 2, LV_COORD_MAX / 2};
+    lv_draw_mask_radius_param_t mask_param;
+    lv_draw_mask_radius_init(&mask_param, &a, 0, false);
+    int16_t mask_id = lv_draw_mask_add(&mask_param, NULL);
+    refr_obj(lv_scr_act());
+    lv_draw_mask_remove_id(mask_id);
+
+    lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, "Same result with and without masks");
+
+    lv_obj_set_hidden(label, true);
+    refr_obj(lv_scr_act());
+    lv_test_assert_true(memcmp(fb_ref, test_fb, fb_size) != 0, "The text is drawn");
+
+    lv_obj_del(label);
+}
+
+static void bench(void)
+{
+    lv_obj_t * label = create_label(&lv_font_montserrat_12, LV_OPA_COVER);
+    uint32_t r;
+
+    clock_t t_ref = clock();
+    for(r = 0; r < BENCH_ROUNDS; r++) refr_obj(label);
+    t_ref = clock() - t_ref;
+
+    lv_obj_set_style_local_text_font(label, LV_LABEL_PART_MAIN, LV_STATE_DEFAULT, &lcd_font);
+
+    clock_t t_act = clock();
+    for(r = 0; r < BENCH_ROUNDS; r++) refr_obj(label);
+    t_act = clock() - t_act;
+
+    lv_test_print("Draw a label %d times: normal: %d us, sub-pixel: %d us (%d.%02dx)", BENCH_ROUNDS,
+                  (int)((int64_t)t_ref * 1000000 / CLOCKS_PER_SEC), (int)((int64_t)t_act * 1000000 / CLOCKS_PER_SEC),
+                  (int)(t_act / t_ref), (int)((t_act * 100 / t_ref) % 100));
+
+    lv_obj_del(label);
+}
+
+static lv_obj_t * create_label(const lv_font_t * font, lv_opa_t opa)
+{
+    lv_obj_t * label = lv_label_create(lv_scr_act(), NULL);
+    lv_obj_set_style_local_text_font(label, LV_LABEL_PART_MAIN, LV_STATE_DEFAULT, font);
+    lv_obj_set_style_local_text_opa(label, LV_LABEL_PART_MAIN, LV_STATE_DEFAULT, opa);
+    lv_label_set_text_static(label, bench_txt);
+
+    return label;
+}
+
+static void refr_obj(lv_obj_t * obj)
+{
+    lv_obj_invalidate(obj);
+    lv_refr_now(NULL);
+}
+
+#else
+
+void lv_test_font_subpx(void)
+{
+}
+
+#endif /*LV_USE_FONT_SUBPX && LV_FONT_MONTSERRAT_12 && LV_FONT_MONTSERRAT_12_SUBPX*/
+#endif /*LV_BUILD_TEST*/
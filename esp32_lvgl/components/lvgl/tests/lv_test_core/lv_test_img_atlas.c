@@ -0,0 +1,435 @@
+/**
+ * @file lv_test_img_atlas.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../lvgl.h"
+#if LV_BUILD_TEST
+#include "../lv_test_assert.h"
+
+#include "lv_test_img_atlas.h"
+
+#if LV_USE_IMG && LV_USE_IMG_TRANSFORM && LV_COLOR_DEPTH == 32 && (LV_MEM_CUSTOM || LV_MEM_SIZE >= 64 * 1024)
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#if LV_USE_PNG && LV_USE_FILESYSTEM
+#include <png.h>
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define ICON_CNT        100
+#define ICON_SIZE       24
+#define ICON_COLS       10
+#define PADDING         1
+#define ATLAS_SIZE      (ICON_COLS * ICON_SIZE + (ICON_COLS - 1) * PADDING)
+#define GRID_STEP       30
+#define BENCH_ROUNDS    20
+
+#define ATLAS_PNG_FILE  "lv_test_img_atlas.png"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void create_imgs(void);
+static void test_same(lv_obj_t ** objs, lv_coord_t x_ofs, lv_coord_t y_ofs);
+static void test_mosaic(lv_obj_t * obj);
+static void test_transform(lv_obj_t * obj);
+static void test_api(lv_obj_t * obj);
+static void bench(lv_obj_t ** objs, const void ** srcs, const lv_img_atlas_t * atlas, const char * name);
+#if LV_USE_PNG && LV_USE_FILESYSTEM
+static void bench_png(lv_obj_t ** objs);
+static void write_png(const char * path, const uint8_t * rgba, uint32_t w, uint32_t h, uint32_t stride);
+#endif
+static void set_srcs(lv_obj_t ** objs, const void ** srcs, const lv_img_atlas_t * atlas);
+static void refr(void);
+static uint32_t count_px(lv_color_t c);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+extern lv_color_t test_fb[];    /*Defined in lv_test_main.c*/
+static lv_color_t fb_ref[LV_HOR_RES_MAX * LV_VER_RES_MAX];
+
+static uint8_t rgba_data[ATLAS_SIZE * ATLAS_SIZE * 4];
+static uint8_t icon_data[ICON_CNT][LV_IMG_BUF_SIZE_TRUE_COLOR_ALPHA(ICON_SIZE, ICON_SIZE)];
+static lv_img_dsc_t icon_imgs[ICON_CNT];
+static const void * icon_srcs[ICON_CNT];
+static uint8_t atlas_data[LV_IMG_BUF_SIZE_TRUE_COLOR_ALPHA(ATLAS_SIZE, ATLAS_SIZE)];
+static lv_img_dsc_t atlas_img;
+static lv_area_t atlas_rects[ICON_CNT];
+static lv_img_atlas_t atlas;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_img_atlas(void)
+{
+    lv_test_print("");
+    lv_test_print("===================");
+    lv_test_print("Start lv_img_atlas tests");
+    lv_test_print("===================");
+
+    create_imgs();
+
+    lv_obj_t * objs[ICON_CNT];
+    uint32_t i;
+    for(i = 0; i < ICON_CNT; i++) objs[i] = lv_img_create(lv_scr_act(), NULL);
+
+    test_same(objs, 5, 5);
+    test_same(objs, -13, -7);
+    test_same(objs, LV_HOR_RES - 5 * GRID_STEP - 11, LV_VER_RES - 5 * GRID_STEP - 3);
+
+    /*Use only one image for the single image tests*/
+    for(i = 1; i < ICON_CNT; i++) lv_obj_set_hidden(objs[i], true);
+    test_mosaic(objs[0]);
+    test_transform(objs[0]);
+    test_api(objs[0]);
+    for(i = 1; i < ICON_CNT; i++) lv_obj_set_hidden(objs[i], false);
+
+    set_srcs(objs, icon_srcs, NULL);
+    bench(objs, icon_srcs, NULL, "variables");
+    bench(objs, NULL, &atlas, "variables");
+#if LV_USE_PNG && LV_USE_FILESYSTEM
+    bench_png(objs);
+#endif
+
+    for(i = 0; i < ICON_CNT; i++) lv_obj_del(objs[i]);
+    lv_img_cache_invalidate_src(NULL);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Create `ICON_CNT` different icons in a grid of an RGBA buffer with red padding and
+ * create separate images and an atlas from them
+ */
+static void create_imgs(void)
+{
+    int32_t x;
+    int32_t y;
+    uint32_t i;
+
+    /*The padding is opaque red to see if it's drawn*/
+    for(i = 0; i < ATLAS_SIZE * ATLAS_SIZE; i++) {
+        rgba_data[i * 4 + 0] = 0xFF;
+        rgba_data[i * 4 + 1] = 0x00;
+        rgba_data[i * 4 + 2] = 0x00;
+        rgba_data[i * 4 + 3] = 0xFF;
+    }
+
+    /*Every icon is a circle with a different color, a gradient and an anti-aliased edge*/
+    for(i = 0; i < ICON_CNT; i++) {
+        lv_coord_t x1 = (i % ICON_COLS) * (ICON_SIZE + PADDING);
+        lv_coord_t y1 = (i / ICON_COLS) * (ICON_SIZE + PADDING);
+        atlas_rects[i].x1 = x1;
+        atlas_rects[i].y1 = y1;
+        atlas_rects[i].x2 = x1 + ICON_SIZE - 1;
+        atlas_rects[i].y2 = y1 + ICON_SIZE - 1;
+
+        int32_t r = ICON_SIZE / 2 - (i % 3);
+        for(y = 0; y < ICON_SIZE; y++) {
+            for(x = 0; x < ICON_SIZE; x++) {
+                int32_t d = (x - ICON_SIZE / 2) * (x - ICON_SIZE / 2) + (y - ICON_SIZE / 2) * (y - ICON_SIZE / 2);
+                uint8_t * px = &rgba_data[((y1 + y) * ATLAS_SIZE + x1 + x) * 4];
+                px[0] = i * 2;
+                px[1] = 255 - i * 2 - y * 2;
+                px[2] = (i * 37 + x * 5) & 0xFF;
+                px[3] = d < (r - 2) * (r - 2) ? LV_OPA_COVER : d < r * r ? LV_OPA_50 : x == y ? LV_OPA_COVER : LV_OPA_TRANSP;
+            }
+        }
+    }
+
+    /*Convert to LVGL's format*/
+    for(i = 0; i < ATLAS_SIZE * ATLAS_SIZE; i++) {
+        const uint8_t * in = &rgba_data[i * 4];
+        lv_color_t c = lv_color_make(in[0], in[1], in[2]);
+        memcpy(&atlas_data[i * LV_IMG_PX_SIZE_ALPHA_BYTE], &c, sizeof(c));
+        atlas_data[i * LV_IMG_PX_SIZE_ALPHA_BYTE + LV_IMG_PX_SIZE_ALPHA_BYTE - 1] = in[3];
+    }
+    atlas_img.header.always_zero = 0;
+    atlas_img.header.cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+    atlas_img.header.w = ATLAS_SIZE;
+    atlas_img.header.h = ATLAS_SIZE;
+    atlas_img.data_size = sizeof(atlas_data);
+    atlas_img.data = atlas_data;
+
+    atlas.src = &atlas_img;
+    atlas.rects = atlas_rects;
+    atlas.rect_cnt = ICON_CNT;
+    atlas.w = ATLAS_SIZE;
+    atlas.h = ATLAS_SIZE;
+
+    /*Cut the icons for the separate images*/
+    for(i = 0; i < ICON_CNT; i++) {
+        uint32_t line_size = ICON_SIZE * LV_IMG_PX_SIZE_ALPHA_BYTE;
+        for(y = 0; y < ICON_SIZE; y++) {
+            memcpy(&icon_data[i][y * line_size],
+                   &atlas_data[((atlas_rects[i].y1 + y) * ATLAS_SIZE + atlas_rects[i].x1) * LV_IMG_PX_SIZE_ALPHA_BYTE],
+                   line_size);
+        }
+        icon_imgs[i].header.always_zero = 0;
+        icon_imgs[i].header.cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+        icon_imgs[i].header.w = ICON_SIZE;
+        icon_imgs[i].header.h = ICON_SIZE;
+        icon_imgs[i].data_size = sizeof(icon_data[i]);
+        icon_imgs[i].data = icon_data[i];
+        icon_srcs[i] = &icon_imgs[i];
+    }
+}
+
+static void test_same(lv_obj_t ** objs, lv_coord_t x_ofs, lv_coord_t y_ofs)
+{
+    uint32_t fb_size = LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t);
+    char buf[128];
+
+    lv_snprintf(buf, sizeof(buf), "Draw %d sprites at %d;%d", ICON_CNT, x_ofs, y_ofs);
+    lv_test_print(buf);
+
+    uint32_t i;
+    for(i = 0; i < ICON_CNT; i++) {
+        lv_obj_set_pos(objs[i], x_ofs + (i % ICON_COLS) * GRID_STEP, y_ofs + (i / ICON_COLS) * GRID_STEP);
+    }
+
+    set_srcs(objs, icon_srcs, NULL);
+    refr();
+    memcpy(fb_ref, test_fb, fb_size);
+
+    set_srcs(objs, NULL, &atlas);
+    refr();
+    lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, "Same as separate images");
+    lv_test_assert_int_eq(0, count_px(LV_COLOR_RED), "No padding drawn");
+    lv_test_assert_int_eq(ICON_SIZE, lv_obj_get_width(objs[0]), "Auto size to the sprite");
+}
+
+static void test_mosaic(lv_obj_t * obj)
+{
+    uint32_t fb_size = LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t);
+
+    lv_test_print("Draw a sprite as mosaic with offset");
+
+    lv_obj_set_pos(obj, 20, 30);
+    lv_img_set_auto_size(obj, false);
+
+    lv_img_set_src(obj, icon_srcs[7]);
+    lv_obj_set_size(obj, ICON_SIZE * 3 + 5, ICON_SIZE * 2 - 3);
+    lv_img_set_offset_x(obj, 5);
+    lv_img_set_offset_y(obj, 9);
+    refr();
+    memcpy(fb_ref, test_fb, fb_size);
+
+    lv_img_set_src_atlas(obj, &atlas, 7);
+    refr();
+    lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, "Same mosaic as a separate image");
+
+    lv_img_set_offset_x(obj, 0);
+    lv_img_set_offset_y(obj, 0);
+    lv_img_set_auto_size(obj, true);
+    lv_img_set_src_atlas(obj, &atlas, 0);
+}
+
+static void test_transform(lv_obj_t * obj)
+{
+    uint32_t fb_size = LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t);
+
+    lv_test_print("Draw transformed sprites");
+
+    lv_obj_set_pos(obj, 100, 100);
+    lv_img_set_antialias(obj, false);
+
+    /*Zoomed without anti-aliasing: the same pixels are sampled*/
+    uint16_t zooms[] = {512, 384, 200};
+    uint32_t i;
+    for(i = 0; i < sizeof(zooms) / sizeof(zooms[0]); i++) {
+        lv_img_set_zoom(obj, zooms[i]);
+        lv_img_set_src(obj, icon_srcs[55]);
+        refr();
+        memcpy(fb_ref, test_fb, fb_size);
+
+        lv_img_set_src_atlas(obj, &atlas, 55);
+        refr();
+        lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, "Same zoomed image");
+        lv_test_assert_int_eq(0, count_px(LV_COLOR_RED), "No padding drawn when zoomed");
+    }
+
+    /*Rotated: the neighbor sprites are masked out*/
+    int16_t angles[] = {300, 450, 900, 1350, 2250};
+    for(i = 0; i < sizeof(angles) / sizeof(angles[0]); i++) {
+        lv_img_set_zoom(obj, i & 1 ? 384 : LV_IMG_ZOOM_NONE);
+        lv_img_set_angle(obj, angles[i]);
+        lv_img_set_src_atlas(obj, &atlas, 55);
+        refr();
+        lv_test_assert_int_eq(0, count_px(LV_COLOR_RED), "No padding drawn when rotated");
+
+        lv_color_t icon_color = lv_color_make(55 * 2, 255 - 55 * 2 - 12 * 2, (55 * 37 + 12 * 5) & 0xFF);
+        lv_test_assert_true(count_px(icon_color) > 0, "The center of the rotated sprite is drawn");
+    }
+    lv_test_assert_int_eq(0, lv_draw_mask_get_cnt(), "Masks removed");
+
+    /*Not enough free masks: the sprite is not drawn and the added masks are removed.
+     *The other masks keep everything.*/
+    static lv_draw_mask_line_param_t other_params[_LV_MASK_MAX_NUM - 2];
+    int16_t other_ids[_LV_MASK_MAX_NUM - 2];
+    for(i = 0; i < _LV_MASK_MAX_NUM - 2; i++) {
+        lv_draw_mask_line_points_init(&other_params[i], -1000, -1000, 1000, -1000, LV_DRAW_MASK_LINE_SIDE_BOTTOM);
+        other_ids[i] = lv_draw_mask_add(&other_params[i], NULL);
+    }
+    refr();
+    lv_test_assert_int_eq(0, count_px(LV_COLOR_RED), "No padding drawn without free masks");
+    lv_test_assert_int_eq(_LV_MASK_MAX_NUM - 2, lv_draw_mask_get_cnt(), "Partially added masks removed");
+    for(i = 0; i < _LV_MASK_MAX_NUM - 2; i++) lv_draw_mask_remove_id(other_ids[i]);
+
+    lv_img_set_angle(obj, 0);
+    lv_img_set_zoom(obj, LV_IMG_ZOOM_NONE);
+    lv_img_set_antialias(obj, LV_ANTIALIAS);
+}
+
+static void test_api(lv_obj_t * obj)
+{
+    lv_test_print("Set and get sprites");
+
+    lv_img_set_src_atlas(obj, &atlas, 12);
+    lv_test_assert_true(lv_img_get_atlas(obj) == &atlas, "Get the atlas");
+    lv_test_assert_int_eq(12, lv_img_get_atlas_id(obj), "Get the sprite ID");
+    lv_test_assert_true(lv_img_get_src(obj) == &atlas_img, "The atlas image is the source");
+
+    lv_img_set_src_atlas(obj, &atlas, ICON_CNT);
+    lv_test_assert_int_eq(12, lv_img_get_atlas_id(obj), "Invalid sprite ID is ignored");
+
+    lv_obj_t * copy = lv_img_create(lv_scr_act(), obj);
+    lv_test_assert_true(lv_img_get_atlas(copy) == &atlas, "Copy the atlas");
+    lv_test_assert_int_eq(12, lv_img_get_atlas_id(copy), "Copy the sprite ID");
+    lv_obj_del(copy);
+
+    lv_img_set_src(obj, icon_srcs[3]);
+    lv_test_assert_true(lv_img_get_atlas(obj) == NULL, "Normal source clears the atlas");
+}
+
+/**
+ * Draw all the icons as separate images or from an atlas and measure the time and image cache usage
+ */
+static void bench(lv_obj_t ** objs, const void ** srcs, const lv_img_atlas_t * a, const char * name)
+{
+    lv_img_cache_invalidate_src(NULL);
+    set_srcs(objs, srcs, a);
+
+    lv_img_cache_stats_t stats;
+    lv_img_cache_reset_stats();
+    uint32_t r;
+    clock_t t = clock();
+    for(r = 0; r < BENCH_ROUNDS; r++) refr();
+    t = clock() - t;
+    lv_img_cache_get_stats(&stats);
+
+    uint32_t us = (uint32_t)((uint64_t)t * 1000000 / CLOCKS_PER_SEC / BENCH_ROUNDS);
+    lv_test_print("%d icons from %s %s: %d us/frame, cache hit: %d, miss: %d, used entries: %d", ICON_CNT,
+                  a ? "an atlas of" : "separate", name, us, stats.hit_cnt, stats.miss_cnt, stats.entry_used);
+
+    if(a) lv_test_assert_int_eq(1, stats.entry_used, "One cache entry for the atlas");
+}
+
+#if LV_USE_PNG && LV_USE_FILESYSTEM
+/**
+ * Draw all the icons as separate PNG files or from one PNG atlas decoded into the image cache
+ */
+static void bench_png(lv_obj_t ** objs)
+{
+    static char paths[ICON_CNT][32];
+    static const void * png_srcs[ICON_CNT];
+    uint32_t i;
+    for(i = 0; i < ICON_CNT; i++) {
+        lv_snprintf(paths[i], sizeof(paths[i]), "lv_test_img_atlas_%d.png", i);
+        write_png(paths[i], &rgba_data[(atlas_rects[i].y1 * ATLAS_SIZE + atlas_rects[i].x1) * 4], ICON_SIZE, ICON_SIZE,
+                  ATLAS_SIZE * 4);
+        lv_snprintf(paths[i], sizeof(paths[i]), "f:lv_test_img_atlas_%d.png", i);
+        png_srcs[i] = paths[i];
+    }
+    write_png(ATLAS_PNG_FILE, rgba_data, ATLAS_SIZE, ATLAS_SIZE, ATLAS_SIZE * 4);
+
+    lv_img_atlas_t png_atlas = atlas;
+    png_atlas.src = "f:"ATLAS_PNG_FILE;
+
+    lv_img_png_init();
+    lv_img_png_set_mode(LV_IMG_DECODER_MODE_FULL);
+
+    bench(objs, png_srcs, NULL, "PNG files");
+    bench(objs, NULL, &png_atlas, "PNG file");
+
+    /*The decoded PNG atlas is drawn the same way as the atlas in a variable*/
+    uint32_t fb_size = LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t);
+    memcpy(fb_ref, test_fb, fb_size);
+    set_srcs(objs, NULL, &atlas);
+    refr();
+    lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, "Same sprites from PNG atlas");
+
+    set_srcs(objs, icon_srcs, NULL);
+    lv_img_png_set_mode(LV_IMG_DECODER_MODE_STRIP);
+    lv_img_cache_invalidate_src(NULL);
+    for(i = 0; i < ICON_CNT; i++) remove(paths[i] + 2);
+    remove(ATLAS_PNG_FILE);
+}
+
+static void write_png(const char * path, const uint8_t * rgba, uint32_t w, uint32_t h, uint32_t stride)
+{
+    png_image png;
+    memset(&png, 0, sizeof(png));
+    png.version = PNG_IMAGE_VERSION;
+    png.width = w;
+    png.height = h;
+    png.format = PNG_FORMAT_RGBA;
+    lv_test_assert_true(png_image_write_to_file(&png, path, 0, rgba, stride, NULL) != 0, "PNG file created");
+}
+#endif
+
+static void set_srcs(lv_obj_t ** objs, const void ** srcs, const lv_img_atlas_t * a)
+{
+    uint32_t i;
+    for(i = 0; i < ICON_CNT; i++) {
+        if(a) lv_img_set_src_atlas(objs[i], a, i);
+        else lv_img_set_src(objs[i], srcs[i]);
+    }
+}
+
+static void refr(void)
+{
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+}
+
+static uint32_t count_px(lv_color_t c)
+{
+    uint32_t cnt = 0;
+    uint32_t i;
+    uint32_t px_cnt = LV_HOR_RES * LV_VER_RES;
+    for(i = 0; i < px_cnt; i++) {
+        if(test_fb[i].full == c.full) cnt++;
+    }
+    return cnt;
+}
+
+#else
+
+void lv_test_img_atlas(void)
+{
+
+}
+
+#endif
+#endif
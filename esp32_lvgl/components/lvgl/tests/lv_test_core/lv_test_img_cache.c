@@ -0,0 +1,362 @@
+/**
+ * @file lv_test_img_cache.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../lvgl.h"
+#if LV_BUILD_TEST
+#include "../lv_test_assert.h"
+
+#include "lv_test_img_cache.h"
+
+/*Up to 64 images are cached in the test*/
+#if LV_IMG_CACHE_DEF_SIZE && (LV_MEM_CUSTOM || LV_MEM_SIZE >= 32 * 1024)
+#include <stdlib.h>
+#include <time.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TEST_IMG_W      8
+#define TEST_IMG_H      8
+#define TEST_IMG_SIZE   ((TEST_IMG_W * TEST_IMG_H * LV_COLOR_SIZE) / 8)
+
+#define ICON_CNT        50
+#define ENTRY_CNT       16
+#define SCREEN_ICON_CNT 10
+#define BENCH_CACHE_CNT 64
+#define BENCH_ROUNDS    200
+#define BENCH_REFR      4
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    lv_img_decoder_dsc_t dec_dsc;
+    int32_t life;
+} ref_entry_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static lv_res_t test_decoder_info(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header);
+static lv_res_t test_decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
+static void test_decoder_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
+static void test_open(const char * src, bool hit);
+static void test_mem_budget(void);
+static void test_entry_cnt(void);
+static void test_extreme_size(void);
+static void bench(void);
+static lv_img_decoder_dsc_t * ref_open(const void * src, lv_color_t color);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static uint32_t open_cnt;
+static uint32_t close_cnt;
+static lv_img_dsc_t icons[ICON_CNT];
+static uint8_t icon_data[16 * 16 * LV_COLOR_SIZE / 8];
+static ref_entry_t ref_cache[BENCH_CACHE_CNT];
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_img_cache(void)
+{
+    lv_test_print("");
+    lv_test_print("===================");
+    lv_test_print("Start lv_img_cache tests");
+    lv_test_print("===================");
+
+    lv_img_decoder_t * dec = lv_img_decoder_create();
+    lv_img_decoder_set_info_cb(dec, test_decoder_info);
+    lv_img_decoder_set_open_cb(dec, test_decoder_open);
+    lv_img_decoder_set_close_cb(dec, test_decoder_close);
+
+    test_mem_budget();
+    test_entry_cnt();
+    test_extreme_size();
+    bench();
+
+    lv_img_decoder_delete(dec);
+    lv_img_cache_set_size(LV_IMG_CACHE_DEF_SIZE);
+    lv_img_cache_set_mem_size(LV_IMG_CACHE_DEF_MEM_SIZE);
+    lv_img_cache_reset_stats();
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/*Decode "TEST:<time to open>:<name>" files to a buffer*/
+static lv_res_t test_decoder_info(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header)
+{
+    LV_UNUSED(decoder);
+    if(lv_img_src_get_type(src) != LV_IMG_SRC_FILE) return LV_RES_INV;
+    if(strncmp(src, "TEST:", 5) != 0) return LV_RES_INV;
+
+    header->always_zero = 0;
+    header->cf = LV_IMG_CF_TRUE_COLOR;
+    header->w = TEST_IMG_W;
+    header->h = TEST_IMG_H;
+    return LV_RES_OK;
+}
+
+static lv_res_t test_decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(decoder);
+    uint8_t * buf = lv_mem_alloc(TEST_IMG_SIZE);
+    if(buf == NULL) return LV_RES_INV;
+
+    dsc->img_data = buf;
+    dsc->time_to_open = atoi((const char *)dsc->src + 5);
+    open_cnt++;
+    return LV_RES_OK;
+}
+
+static void test_decoder_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(decoder);
+    lv_mem_free(dsc->img_data);
+    dsc->img_data = NULL;
+    close_cnt++;
+}
+
+static void test_open(const char * src, bool hit)
+{
+    lv_img_cache_stats_t s1;
+    lv_img_cache_stats_t s2;
+    lv_img_cache_get_stats(&s1);
+    lv_img_cache_entry_t * e = _lv_img_cache_open(src, LV_COLOR_BLACK);
+    lv_img_cache_get_stats(&s2);
+
+    lv_test_assert_true(e != NULL, "Image opened");
+    if(e) lv_test_assert_str_eq(src, e->dec_dsc.src, "Right image returned");
+    lv_test_assert_int_eq(hit ? 1 : 0, s2.hit_cnt - s1.hit_cnt, "Hit counted");
+    lv_test_assert_int_eq(hit ? 0 : 1, s2.miss_cnt - s1.miss_cnt, "Miss counted");
+}
+
+static void test_mem_budget(void)
+{
+    lv_test_print("Close the cheap images first if the memory budget is exceeded");
+
+    lv_img_cache_stats_t s;
+    lv_img_cache_set_size(8);
+    lv_img_cache_set_mem_size(3 * TEST_IMG_SIZE);
+    lv_img_cache_reset_stats();
+    open_cnt = 0;
+    close_cnt = 0;
+
+    test_open("TEST:50:A", false);
+    test_open("TEST:1:B", false);
+    test_open("TEST:1:C", false);
+    test_open("TEST:1:D", false);
+    test_open("TEST:1:E", false);
+
+    lv_img_cache_get_stats(&s);
+    lv_test_assert_int_eq(3, s.entry_used, "Entries kept in the budget");
+    lv_test_assert_int_eq(3 * TEST_IMG_SIZE, s.mem_used, "Memory used");
+    lv_test_assert_int_eq(2, s.evict_cnt, "Evicted images");
+    lv_test_assert_int_eq(open_cnt - close_cnt, s.entry_used, "Opened images are in the cache");
+
+    test_open("TEST:50:A", true);
+    test_open("TEST:1:E", true);
+    test_open("TEST:1:B", false);
+
+    lv_test_print("Invalidate an image");
+    lv_img_cache_invalidate_src("TEST:50:A");
+    lv_img_cache_get_stats(&s);
+    lv_test_assert_int_eq(2, s.entry_used, "Entries after invalidate");
+    lv_test_assert_int_eq(2 * TEST_IMG_SIZE, s.mem_used, "Memory used after invalidate");
+    test_open("TEST:50:A", false);
+
+    lv_test_print("Shrink the memory budget");
+    lv_img_cache_set_mem_size(TEST_IMG_SIZE);
+    lv_img_cache_get_stats(&s);
+    lv_test_assert_int_eq(1, s.entry_used, "Entries in the smaller budget");
+    test_open("TEST:50:A", true);
+
+    lv_img_cache_invalidate_src(NULL);
+    lv_img_cache_get_stats(&s);
+    lv_test_assert_int_eq(0, s.entry_used, "Entries after invalidating all");
+    lv_test_assert_int_eq(0, s.mem_used, "Memory used after invalidating all");
+    lv_test_assert_int_eq(open_cnt, close_cnt, "All images closed");
+}
+
+static void test_entry_cnt(void)
+{
+    lv_test_print("Limit only the number of entries");
+
+    lv_img_cache_stats_t s;
+    char name[16];
+    uint32_t i;
+
+    lv_img_cache_set_size(ENTRY_CNT);
+    lv_img_cache_set_mem_size(0);
+    lv_img_cache_reset_stats();
+
+    for(i = 0; i < ENTRY_CNT; i++) {
+        lv_snprintf(name, sizeof(name), "TEST:1:%d", i);
+        test_open(name, false);
+    }
+
+    for(i = 0; i < ENTRY_CNT; i++) {
+        lv_snprintf(name, sizeof(name), "TEST:1:%d", i);
+        test_open(name, true);
+    }
+
+    /*The same image with other color is an other entry*/
+    lv_img_cache_entry_t * e = _lv_img_cache_open("TEST:1:0", LV_COLOR_RED);
+    lv_test_assert_true(e != NULL && e->dec_dsc.color.full == LV_COLOR_RED.full, "Other color opened");
+
+    lv_img_cache_get_stats(&s);
+    lv_test_assert_int_eq(ENTRY_CNT, s.entry_used, "Entries used");
+    lv_test_assert_int_eq(1, s.evict_cnt, "Evicted images");
+    lv_test_assert_int_eq(ENTRY_CNT * TEST_IMG_SIZE, s.mem_used, "Memory used");
+
+    lv_img_cache_invalidate_src(NULL);
+    lv_test_assert_int_eq(open_cnt, close_cnt, "All images closed");
+}
+
+static void test_extreme_size(void)
+{
+    lv_test_print("Cache with too many and no entries");
+
+#if LV_MEM_CUSTOM
+    /*More hash indexes than 16 bits can count*/
+    char name[16];
+    uint32_t i;
+    lv_img_cache_set_size(40000);
+    lv_img_cache_set_mem_size(0);
+    for(i = 0; i < ENTRY_CNT; i++) {
+        lv_snprintf(name, sizeof(name), "TEST:1:%d", i);
+        test_open(name, false);
+    }
+    for(i = 0; i < ENTRY_CNT; i++) {
+        lv_snprintf(name, sizeof(name), "TEST:1:%d", i);
+        test_open(name, true);
+    }
+    lv_img_cache_invalidate_src(NULL);
+#endif
+
+    lv_img_cache_set_size(0);
+    lv_test_assert_true(_lv_img_cache_open("TEST:1:0", LV_COLOR_BLACK) == NULL, "Nothing opened without entries");
+    lv_test_assert_true(lv_img_cache_preload("TEST:1:0", LV_COLOR_BLACK) == LV_RES_INV, "Nothing preloaded");
+    lv_test_assert_int_eq(open_cnt, close_cnt, "All images closed");
+}
+
+static void bench(void)
+{
+    uint32_t i;
+    for(i = 0; i < ICON_CNT; i++) {
+        icons[i].header.always_zero = 0;
+        icons[i].header.cf = LV_IMG_CF_TRUE_COLOR;
+        icons[i].header.w = 16;
+        icons[i].header.h = 16;
+        icons[i].data_size = sizeof(icon_data);
+        icons[i].data = icon_data;
+    }
+
+    lv_img_cache_set_size(BENCH_CACHE_CNT);
+    lv_img_cache_set_mem_size(0);
+    lv_img_cache_reset_stats();
+    _lv_memset_00(ref_cache, sizeof(ref_cache));
+
+    /*Switch between screens with 10 icons. Every screen is refreshed a few times*/
+    uint32_t r;
+    uint32_t s;
+    uint32_t f;
+    clock_t t_ref = clock();
+    for(r = 0; r < BENCH_ROUNDS; r++) {
+        for(s = 0; s < ICON_CNT / SCREEN_ICON_CNT; s++) {
+            for(f = 0; f < BENCH_REFR; f++) {
+                for(i = 0; i < SCREEN_ICON_CNT; i++) {
+                    ref_open(&icons[s * SCREEN_ICON_CNT + i], LV_COLOR_BLACK);
+                }
+            }
+        }
+    }
+    t_ref = clock() - t_ref;
+
+    clock_t t_act = clock();
+    for(r = 0; r < BENCH_ROUNDS; r++) {
+        for(s = 0; s < ICON_CNT / SCREEN_ICON_CNT; s++) {
+            for(f = 0; f < BENCH_REFR; f++) {
+                for(i = 0; i < SCREEN_ICON_CNT; i++) {
+                    _lv_img_cache_open(&icons[s * SCREEN_ICON_CNT + i], LV_COLOR_BLACK);
+                }
+            }
+        }
+    }
+    t_act = clock() - t_act;
+
+    lv_img_cache_stats_t stats;
+    lv_img_cache_get_stats(&stats);
+    lv_test_assert_int_eq(ICON_CNT, stats.miss_cnt, "Icons opened only once");
+
+    for(i = 0; i < BENCH_CACHE_CNT; i++) {
+        if(ref_cache[i].dec_dsc.src) lv_img_decoder_close(&ref_cache[i].dec_dsc);
+    }
+    lv_img_cache_invalidate_src(NULL);
+
+    lv_test_print("Open %d icons %d times: linear: %d us, hashed: %d us",
+                  ICON_CNT, BENCH_ROUNDS * BENCH_REFR,
+                  (int)((int64_t)t_ref * 1000000 / CLOCKS_PER_SEC), (int)((int64_t)t_act * 1000000 / CLOCKS_PER_SEC));
+}
+
+/*The former linear cache with aging as reference*/
+static lv_img_decoder_dsc_t * ref_open(const void * src, lv_color_t color)
+{
+    ref_entry_t * cached_src = NULL;
+    uint16_t i;
+    for(i = 0; i < BENCH_CACHE_CNT; i++) {
+        if(ref_cache[i].life > INT32_MIN + 1) ref_cache[i].life -= 1;
+    }
+
+    for(i = 0; i < BENCH_CACHE_CNT; i++) {
+        if(color.full == ref_cache[i].dec_dsc.color.full &&
+           lv_img_src_get_type(src) == LV_IMG_SRC_VARIABLE && src == ref_cache[i].dec_dsc.src) {
+            cached_src = &ref_cache[i];
+            cached_src->life += cached_src->dec_dsc.time_to_open;
+            if(cached_src->life > 1000) cached_src->life = 1000;
+            break;
+        }
+    }
+
+    if(cached_src == NULL) {
+        cached_src = &ref_cache[0];
+        for(i = 1; i < BENCH_CACHE_CNT; i++) {
+            if(ref_cache[i].life < cached_src->life) cached_src = &ref_cache[i];
+        }
+
+        if(cached_src->dec_dsc.src) lv_img_decoder_close(&cached_src->dec_dsc);
+
+        if(lv_img_decoder_open(&cached_src->dec_dsc, src, color) != LV_RES_OK) {
+            _lv_memset_00(cached_src, sizeof(ref_entry_t));
+            cached_src->life = INT32_MIN;
+            return NULL;
+        }
+        cached_src->life = 0;
+        if(cached_src->dec_dsc.time_to_open == 0) cached_src->dec_dsc.time_to_open = 1;
+    }
+
+    return &cached_src->dec_dsc;
+}
+
+#else
+
+void lv_test_img_cache(void)
+{
+}
+
+#endif /*LV_IMG_CACHE_DEF_SIZE && (LV_MEM_CUSTOM || LV_MEM_SIZE >= 32 * 1024)*/
+#endif /*LV_BUILD_TEST*/
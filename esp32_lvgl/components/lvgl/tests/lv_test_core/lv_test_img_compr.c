@@ -0,0 +1,533 @@
+/**
+ * @file lv_test_img_compr.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../lvgl.h"
+#if LV_BUILD_TEST
+#include "../lv_test_assert.h"
+
+#include "lv_test_img_compr.h"
+
+#if LV_IMG_CF_COMPRESSED && LV_USE_FILESYSTEM && LV_USE_IMG && LV_IMG_CF_INDEXED && LV_IMG_CF_ALPHA && \
+    (LV_MEM_CUSTOM || LV_MEM_SIZE >= 32 * 1024)
+#include <stdio.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define ARGB_W          100
+#define ARGB_H          100
+#define TC_W            40
+#define TC_H            40
+#define INDEXED_W       100
+#define INDEXED_H       60
+#define ALPHA_W         100
+#define ALPHA_H         60
+#define BLOCK_SIZE      2048    /*Approximate size of the decompressed blocks*/
+#define COMPR_BUF_SIZE  (LV_IMG_BUF_SIZE_TRUE_COLOR_ALPHA(ARGB_W, ARGB_H) * 9 / 8 + 1024)
+#define BENCH_ROUNDS    100
+
+#define TEST_FILE       "lv_test_img_compr.bin"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void create_imgs(void);
+static void compress(const lv_img_dsc_t * src, lv_img_cf_t method, lv_img_dsc_t * dst, uint8_t * buf);
+static uint32_t rle_encode(const uint8_t * in, uint32_t size, uint32_t px_bytes, uint8_t * out);
+static uint32_t lz4_encode(const uint8_t * in, uint32_t size, uint8_t * out);
+static uint32_t lz4_write_len(uint8_t * out, uint32_t len);
+static void test_same(lv_obj_t * img, const lv_img_dsc_t * raw, lv_img_cf_t method, const char * name);
+static void test_invalid(lv_obj_t * img);
+static void bench(const lv_img_dsc_t * raw, lv_img_cf_t method, const char * name);
+static void draw(lv_obj_t * img, const void * src, lv_coord_t x, lv_coord_t y);
+static void write_file(const char * path, const lv_img_dsc_t * img);
+static void fs_init(void);
+static uint32_t rnd_next(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+extern lv_color_t test_fb[];    /*Defined in lv_test_main.c*/
+static lv_color_t fb_ref[LV_HOR_RES_MAX * LV_VER_RES_MAX];
+
+static uint8_t argb_data[LV_IMG_BUF_SIZE_TRUE_COLOR_ALPHA(ARGB_W, ARGB_H)];
+static uint8_t tc_data[LV_IMG_BUF_SIZE_TRUE_COLOR(TC_W, TC_H)];
+static uint8_t indexed_data[LV_IMG_BUF_SIZE_INDEXED_4BIT(INDEXED_W, INDEXED_H)];
+static uint8_t alpha_data[LV_IMG_BUF_SIZE_ALPHA_8BIT(ALPHA_W, ALPHA_H)];
+static lv_img_dsc_t argb_img;
+static lv_img_dsc_t tc_img;
+static lv_img_dsc_t indexed_img;
+static lv_img_dsc_t alpha_img;
+
+static uint32_t compr_buf[COMPR_BUF_SIZE / sizeof(uint32_t)];
+static lv_img_dsc_t compr_img;
+static uint8_t read_buf[ARGB_W * ARGB_H * LV_IMG_PX_SIZE_ALPHA_BYTE];
+static uint32_t rnd_seed;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_img_compr(void)
+{
+    lv_test_print("");
+    lv_test_print("===================");
+    lv_test_print("Start lv_img_compr tests");
+    lv_test_print("===================");
+
+    fs_init();
+    create_imgs();
+
+    lv_obj_t * img = lv_img_create(lv_scr_act(), NULL);
+
+    lv_img_cf_t methods[] = {LV_IMG_CF_RLE, LV_IMG_CF_LZ4};
+    const char * names[] = {"RLE", "LZ4"};
+    uint32_t i;
+    for(i = 0; i < sizeof(methods) / sizeof(methods[0]); i++) {
+        lv_test_print("Draw %s compressed images", names[i]);
+        test_same(img, &argb_img, methods[i], "ARGB");
+        test_same(img, &tc_img, methods[i], "true color");
+        test_same(img, &indexed_img, methods[i], "indexed");
+        test_same(img, &alpha_img, methods[i], "alpha");
+    }
+
+    test_invalid(img);
+
+    for(i = 0; i < sizeof(methods) / sizeof(methods[0]); i++) {
+        bench(&argb_img, methods[i], names[i]);
+        bench(&indexed_img, methods[i], names[i]);
+        bench(&alpha_img, methods[i], names[i]);
+    }
+
+    lv_obj_del(img);
+    lv_img_cache_invalidate_src(NULL);
+    remove(TEST_FILE);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void create_imgs(void)
+{
+    int32_t x;
+    int32_t y;
+
+    /*Photo like image with a noisy gradient in an anti-aliased transparent circle*/
+    rnd_seed = 1;
+    uint8_t * px = argb_data;
+    for(y = 0; y < ARGB_H; y++) {
+        for(x = 0; x < ARGB_W; x++) {
+            int32_t d = (x - ARGB_W / 2) * (x - ARGB_W / 2) + (y - ARGB_H / 2) * (y - ARGB_H / 2);
+            lv_color_t c = LV_COLOR_BLACK;
+            lv_opa_t a = LV_OPA_TRANSP;
+            if(d < 48 * 48) {
+                c = lv_color_make(x * 2 + (rnd_next() & 7), y * 2 + (rnd_next() & 7), 128 + ((x + y) & 31));
+                a = d < 40 * 40 ? LV_OPA_COVER : (48 * 48 - d) * 255 / (48 * 48 - 40 * 40);
+            }
+            memcpy(px, &c, sizeof(lv_color_t));
+            px[LV_IMG_PX_SIZE_ALPHA_BYTE - 1] = a;
+            px += LV_IMG_PX_SIZE_ALPHA_BYTE;
+        }
+    }
+    argb_img.header.always_zero = 0;
+    argb_img.header.cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+    argb_img.header.w = ARGB_W;
+    argb_img.header.h = ARGB_H;
+    argb_img.data_size = sizeof(argb_data);
+    argb_img.data = argb_data;
+
+    /*Flat colored bands*/
+    lv_color_t * c = (lv_color_t *)tc_data;
+    for(y = 0; y < TC_H; y++) {
+        for(x = 0; x < TC_W; x++) {
+            *c = lv_color_make((y / 8) * 50, 100, (x / 10) * 60);
+            c++;
+        }
+    }
+    tc_img.header.always_zero = 0;
+    tc_img.header.cf = LV_IMG_CF_TRUE_COLOR;
+    tc_img.header.w = TC_W;
+    tc_img.header.h = TC_H;
+    tc_img.data_size = sizeof(tc_data);
+    tc_img.data = tc_data;
+
+    lv_color32_t * palette = (lv_color32_t *)indexed_data;
+    for(x = 0; x < 16; x++) {
+        palette[x].ch.red = x * 16;
+        palette[x].ch.green = 255 - x * 16;
+        palette[x].ch.blue = x * 7;
+        palette[x].ch.alpha = x == 0 ? 0 : 255 - x;
+    }
+    px = &indexed_data[16 * sizeof(lv_color32_t)];
+    for(y = 0; y < INDEXED_H; y++) {
+        for(x = 0; x < INDEXED_W; x += 2) {
+            uint8_t v = y < INDEXED_H / 2 ? (x / 16) & 0xF : (x + y) & 0xF;
+            *px = (v << 4) | v;
+            px++;
+        }
+    }
+    indexed_img.header.always_zero = 0;
+    indexed_img.header.cf = LV_IMG_CF_INDEXED_4BIT;
+    indexed_img.header.w = INDEXED_W;
+    indexed_img.header.h = INDEXED_H;
+    indexed_img.data_size = sizeof(indexed_data);
+    indexed_img.data = indexed_data;
+
+    px = alpha_data;
+    for(y = 0; y < ALPHA_H; y++) {
+        for(x = 0; x < ALPHA_W; x++) {
+            int32_t d = (x - ALPHA_W / 2) * (x - ALPHA_W / 2) + (y - ALPHA_H / 2) * (y - ALPHA_H / 2);
+            *px = d < 20 * 20 ? LV_OPA_COVER : d < 28 * 28 ? (28 * 28 - d) * 255 / (28 * 28 - 20 * 20) : LV_OPA_TRANSP;
+            px++;
+        }
+    }
+    alpha_img.header.always_zero = 0;
+    alpha_img.header.cf = LV_IMG_CF_ALPHA_8BIT;
+    alpha_img.header.w = ALPHA_W;
+    alpha_img.header.h = ALPHA_H;
+    alpha_img.data_size = sizeof(alpha_data);
+    alpha_img.data = alpha_data;
+}
+
+/*Compress an image the same way as `scripts/img_compress.py`*/
+static void compress(const lv_img_dsc_t * src, lv_img_cf_t method, lv_img_dsc_t * dst, uint8_t * buf)
+{
+    lv_img_cf_t cf = src->header.cf;
+    uint8_t px_size = lv_img_cf_get_px_size(cf);
+    uint32_t line_bytes = (src->header.w * px_size + 7) >> 3;
+    uint32_t palette_bytes = cf >= LV_IMG_CF_INDEXED_1BIT && cf <= LV_IMG_CF_INDEXED_8BIT ? 4U << px_size : 0;
+    uint32_t block_h = LV_MATH_MAX(BLOCK_SIZE / line_bytes, 1);
+    uint32_t block_cnt = (src->header.h + block_h - 1) / block_h;
+
+    lv_img_compr_header_t header;
+    header.cf = cf;
+    header.reserved = 0;
+    header.block_h = block_h;
+    memcpy(buf, &header, sizeof(header));
+
+    uint32_t * ofs = (uint32_t *)(buf + sizeof(header));
+    uint8_t * blocks = buf + sizeof(header) + (block_cnt + 1) * sizeof(uint32_t) + palette_bytes;
+    memcpy(blocks - palette_bytes, src->data, palette_bytes);
+
+    uint32_t size = 0;
+    uint32_t i;
+    for(i = 0; i < block_cnt; i++) {
+        uint32_t line_cnt = LV_MATH_MIN(block_h, src->header.h - i * block_h);
+        const uint8_t * in = src->data + palette_bytes + i * block_h * line_bytes;
+        ofs[i] = size;
+        if(method == LV_IMG_CF_RLE) size += rle_encode(in, line_cnt * line_bytes, px_size >= 8 ? px_size >> 3 : 1,
+                                                          blocks + size);
+        else size += lz4_encode(in, line_cnt * line_bytes, blocks + size);
+    }
+    ofs[block_cnt] = size;
+
+    dst->header = src->header;
+    dst->header.cf = method;
+    dst->data_size = (blocks - buf) + size;
+    dst->data = buf;
+}
+
+static uint32_t rle_encode(const uint8_t * in, uint32_t size, uint32_t px_bytes, uint8_t * out)
+{
+    uint32_t px_cnt = size / px_bytes;
+    uint32_t i = 0;
+    uint8_t * out_start = out;
+    while(i < px_cnt) {
+        uint32_t run = 1;
+        while(i + run < px_cnt && run < 127 && memcmp(in + (i + run) * px_bytes, in + i * px_bytes, px_bytes) == 0) {
+            run++;
+        }
+
+        if(run >= 2) {
+            *out = run;
+            memcpy(out + 1, in + i * px_bytes, px_bytes);
+            out += 1 + px_bytes;
+            i += run;
+        }
+        else {
+            /*Collect the pixels until two equal pixels*/
+            uint32_t lit = 1;
+            while(i + lit < px_cnt && lit < 127) {
+                if(i + lit + 1 < px_cnt &&
+                   memcmp(in + (i + lit) * px_bytes, in + (i + lit + 1) * px_bytes, px_bytes) == 0) break;
+                lit++;
+            }
+            *out = 0x80 | lit;
+            memcpy(out + 1, in + i * px_bytes, lit * px_bytes);
+            out += 1 + lit * px_bytes;
+            i += lit;
+        }
+    }
+
+    return out - out_start;
+}
+
+/*A greedy LZ4 block compressor with a small hash table. The input is smaller than 64 kB.*/
+static uint32_t lz4_encode(const uint8_t * in, uint32_t size, uint8_t * out)
+{
+    static uint16_t table[4096];
+    memset(table, 0xFF, sizeof(table));
+
+    uint8_t * out_start = out;
+    uint32_t anchor = 0;
+    uint32_t i = 0;
+    /*The last match should start 12 bytes before the end and the last 5 bytes are literals*/
+    while(i + 12 <= size) {
+        uint32_t seq;
+        memcpy(&seq, in + i, 4);
+        uint32_t h = (seq * 2654435761U) >> 20;
+        uint32_t cand = table[h];
+        table[h] = i;
+        if(cand == 0xFFFF || memcmp(in + cand, in + i, 4) != 0) {
+            i++;
+            continue;
+        }
+
+        uint32_t len = 4;
+        while(i + len + 5 < size && in[cand + len] == in[i + len]) len++;
+
+        uint32_t lit = i - anchor;
+        uint8_t * token = out;
+        out++;
+        *token = (LV_MATH_MIN(lit, 15) << 4) | LV_MATH_MIN(len - 4, 15);
+        if(lit >= 15) out += lz4_write_len(out, lit - 15);
+        memcpy(out, in + anchor, lit);
+        out += lit;
+        out[0] = (i - cand) & 0xFF;
+        out[1] = (i - cand) >> 8;
+        out += 2;
+        if(len - 4 >= 15) out += lz4_write_len(out, len - 4 - 15);
+
+        i += len;
+        anchor = i;
+    }
+
+    uint32_t lit = size - anchor;
+    *out = LV_MATH_MIN(lit, 15) << 4;
+    out++;
+    if(lit >= 15) out += lz4_write_len(out, lit - 15);
+    memcpy(out, in + anchor, lit);
+    out += lit;
+
+    return out - out_start;
+}
+
+static uint32_t lz4_write_len(uint8_t * out, uint32_t len)
+{
+    uint32_t n = 0;
+    while(len >= 255) {
+        out[n] = 255;
+        n++;
+        len -= 255;
+    }
+    out[n] = len;
+    return n + 1;
+}
+
+static void test_same(lv_obj_t * img, const lv_img_dsc_t * raw, lv_img_cf_t method, const char * name)
+{
+    uint32_t fb_size = LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t);
+    char buf[128];
+
+    compress(raw, method, &compr_img, (uint8_t *)compr_buf);
+    write_file(TEST_FILE, &compr_img);
+    lv_test_assert_true(compr_img.data_size < raw->data_size, "Compressed image is smaller");
+
+    lv_point_t pos[] = {{0, 0}, {-30, 10}, {LV_HOR_RES - raw->header.w / 2, LV_VER_RES - raw->header.h / 3}};
+    uint32_t i;
+    for(i = 0; i < sizeof(pos) / sizeof(pos[0]); i++) {
+        /*The same descriptor is reused for every image*/
+        lv_img_cache_invalidate_src(NULL);
+
+        draw(img, raw, pos[i].x, pos[i].y);
+        memcpy(fb_ref, test_fb, fb_size);
+
+        draw(img, &compr_img, pos[i].x, pos[i].y);
+        lv_snprintf(buf, sizeof(buf), "Same %s image from compressed variable at %d;%d", name, pos[i].x, pos[i].y);
+        lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, buf);
+
+        draw(img, "Z:"TEST_FILE, pos[i].x, pos[i].y);
+        lv_snprintf(buf, sizeof(buf), "Same %s image from compressed file at %d;%d", name, pos[i].x, pos[i].y);
+        lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, buf);
+    }
+
+    lv_img_set_src(img, raw);
+}
+
+static void test_invalid(lv_obj_t * img)
+{
+    lv_test_print("Reject invalid compressed images");
+
+    lv_img_decoder_dsc_t dsc;
+    compress(&argb_img, LV_IMG_CF_LZ4, &compr_img, (uint8_t *)compr_buf);
+    lv_img_cache_invalidate_src(NULL);
+
+    compr_img.data_size--;
+    lv_test_assert_int_eq(LV_RES_INV, lv_img_decoder_open(&dsc, &compr_img, LV_COLOR_BLACK), "Truncated image");
+    compr_img.data_size++;
+
+    /*The file ends in the compressed header*/
+    uint32_t data_size = compr_img.data_size;
+    compr_img.data_size = sizeof(lv_img_compr_header_t) - 1;
+    write_file(TEST_FILE, &compr_img);
+    compr_img.data_size = data_size;
+    lv_img_header_t info;
+    lv_test_assert_int_eq(LV_RES_INV, lv_img_decoder_get_info("Z:"TEST_FILE, &info), "Truncated file header");
+
+    lv_img_compr_header_t * header = (lv_img_compr_header_t *)compr_buf;
+    header->block_h = 0;
+    lv_test_assert_int_eq(LV_RES_INV, lv_img_decoder_open(&dsc, &compr_img, LV_COLOR_BLACK), "Zero block height");
+    header->block_h = BLOCK_SIZE / (ARGB_W * LV_IMG_PX_SIZE_ALPHA_BYTE);
+
+    /*Overwrite the compressed blocks with garbage*/
+    uint32_t block_cnt = (ARGB_H + header->block_h - 1) / header->block_h;
+    uint32_t blocks_pos = sizeof(lv_img_compr_header_t) + (block_cnt + 1) * sizeof(uint32_t);
+    uint8_t * data = (uint8_t *)compr_buf;
+    uint32_t i;
+    for(i = blocks_pos; i < compr_img.data_size; i++) data[i] = i & 0x7;
+
+    lv_img_cf_t methods[] = {LV_IMG_CF_RLE, LV_IMG_CF_LZ4};
+    for(i = 0; i < sizeof(methods) / sizeof(methods[0]); i++) {
+        compr_img.header.cf = methods[i];
+        lv_res_t res = lv_img_decoder_open(&dsc, &compr_img, LV_COLOR_BLACK);
+        if(res == LV_RES_OK) {
+            res = lv_img_decoder_read_area(&dsc, 0, 0, ARGB_W, ARGB_H, read_buf);
+            lv_img_decoder_close(&dsc);
+        }
+        lv_test_assert_int_eq(LV_RES_INV, res, "Corrupted blocks");
+
+        /*Shouldn't crash*/
+        lv_img_cache_invalidate_src(NULL);
+        draw(img, &compr_img, 0, 0);
+    }
+
+    lv_img_set_src(img, &argb_img);
+    lv_img_cache_invalidate_src(NULL);
+}
+
+static void bench(const lv_img_dsc_t * raw, lv_img_cf_t method, const char * name)
+{
+    compress(raw, method, &compr_img, (uint8_t *)compr_buf);
+
+    /*Open and read the whole image in every round to decompress all the blocks*/
+    lv_img_decoder_dsc_t dsc;
+    lv_res_t res = LV_RES_OK;
+    uint32_t r;
+    clock_t t = clock();
+    for(r = 0; r < BENCH_ROUNDS && res == LV_RES_OK; r++) {
+        res = lv_img_decoder_open(&dsc, &compr_img, LV_COLOR_BLACK);
+        if(res != LV_RES_OK) break;
+        res = lv_img_decoder_read_area(&dsc, 0, 0, raw->header.w, raw->header.h, read_buf);
+        lv_img_decoder_close(&dsc);
+    }
+    t = clock() - t;
+    lv_test_assert_int_eq(LV_RES_OK, res, "Read compressed image");
+
+    uint64_t bytes = (uint64_t)raw->data_size * BENCH_ROUNDS;
+    uint32_t mbps = t ? (uint32_t)(bytes * CLOCKS_PER_SEC / t / 1000000) : 0;
+    lv_test_print("%s %d bit %dx%d image: %d -> %d bytes (%d%%), %d MB/s", name,
+                  lv_img_cf_get_px_size(raw->header.cf), raw->header.w, raw->header.h, raw->data_size,
+                  compr_img.data_size, compr_img.data_size * 100 / raw->data_size, mbps);
+}
+
+static void draw(lv_obj_t * img, const void * src, lv_coord_t x, lv_coord_t y)
+{
+    lv_img_set_src(img, src);
+    lv_obj_set_pos(img, x, y);
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+}
+
+static void write_file(const char * path, const lv_img_dsc_t * img)
+{
+    FILE * f = fopen(path, "wb");
+    lv_test_assert_true(f != NULL, "Image file created");
+    if(f == NULL) return;
+
+    fwrite(&img->header, sizeof(lv_img_header_t), 1, f);
+    fwrite(img->data, 1, img->data_size, f);
+    fclose(f);
+}
+
+static lv_fs_res_t fs_open_cb(struct _lv_fs_drv_t * drv, void * file_p, const char * path, lv_fs_mode_t mode)
+{
+    LV_UNUSED(drv);
+    LV_UNUSED(mode);
+    int fd = open(path, O_RDONLY);
+    *((int *)file_p) = fd;
+    return fd < 0 ? LV_FS_RES_NOT_EX : LV_FS_RES_OK;
+}
+
+static lv_fs_res_t fs_close_cb(struct _lv_fs_drv_t * drv, void * file_p)
+{
+    LV_UNUSED(drv);
+    close(*((int *)file_p));
+    return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t fs_read_cb(struct _lv_fs_drv_t * drv, void * file_p, void * buf, uint32_t btr, uint32_t * br)
+{
+    LV_UNUSED(drv);
+    ssize_t res = read(*((int *)file_p), buf, btr);
+    if(res < 0) return LV_FS_RES_UNKNOWN;
+    *br = res;
+    return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t fs_seek_cb(struct _lv_fs_drv_t * drv, void * file_p, uint32_t pos)
+{
+    LV_UNUSED(drv);
+    return lseek(*((int *)file_p), pos, SEEK_SET) < 0 ? LV_FS_RES_UNKNOWN : LV_FS_RES_OK;
+}
+
+static void fs_init(void)
+{
+    static bool inited = false;
+    if(inited) return;
+    inited = true;
+
+    lv_fs_drv_t drv;
+    lv_fs_drv_init(&drv);
+    drv.letter = 'Z';
+    drv.file_size = sizeof(int);
+    drv.open_cb = fs_open_cb;
+    drv.close_cb = fs_close_cb;
+    drv.read_cb = fs_read_cb;
+    drv.seek_cb = fs_seek_cb;
+    lv_fs_drv_register(&drv);
+}
+
+static uint32_t rnd_next(void)
+{
+    rnd_seed = (1103515245 * rnd_seed + 12345) & 0x7FFFFFFF;
+    return rnd_seed >> 8;
+}
+
+#else
+
+void lv_test_img_compr(void)
+{
+
+}
+
+#endif
+
+#endif
@@ -0,0 +1,505 @@
+/**
+ * @file lv_test_img_png_jpg.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../lvgl.h"
+#if LV_BUILD_TEST
+#include "../lv_test_assert.h"
+
+#include "lv_test_img_png_jpg.h"
+
+#if LV_USE_PNG && LV_USE_JPG && LV_USE_FILESYSTEM && LV_USE_IMG && LV_COLOR_DEPTH == 32
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <png.h>
+#include <jpeglib.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define ICON_W          50
+#define ICON_H          50
+#define BENCH_W         400
+#define BENCH_H         300
+#define FILE_BUF_SIZE   (16 * 1024)
+#define BENCH_ROUNDS    10
+
+#define JPG_FILE        "lv_test_img_png_jpg.jpg"
+#define JPG_GRAY_FILE   "lv_test_img_png_jpg_gray.jpg"
+#define BENCH_PNG_FILE  "lv_test_img_png_jpg_bench.png"
+#define BENCH_JPG_FILE  "lv_test_img_png_jpg_bench.jpg"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void test_png(lv_obj_t * img, const char * path);
+static void test_jpg(lv_obj_t * img, const char * path, bool gray);
+static void test_same(lv_obj_t * img, const lv_img_dsc_t * ref, const char * path, const lv_img_dsc_t * raw,
+                      const char * name);
+static void test_strip_mem(lv_obj_t * img);
+static void test_invalid(lv_obj_t * img);
+static void bench(const char * path, void (*set_mode_cb)(lv_img_decoder_mode_t), const char * name);
+static void set_mode(lv_img_decoder_mode_t mode);
+static void ref_png(const char * path, lv_img_dsc_t * dsc, uint8_t * buf);
+static void ref_jpg(const char * path, lv_img_dsc_t * dsc, uint8_t * buf);
+static void write_jpg(const char * path, const uint8_t * rgb, uint32_t w, uint32_t h, bool gray);
+static void write_bench_imgs(void);
+static void load_file(const char * path, lv_img_dsc_t * dsc, lv_img_cf_t cf, uint8_t * buf);
+static void draw(lv_obj_t * img, const void * src, lv_coord_t x, lv_coord_t y);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+extern lv_color_t test_fb[];    /*Defined in lv_test_main.c*/
+static lv_color_t fb_ref[LV_HOR_RES_MAX * LV_VER_RES_MAX];
+
+static uint8_t ref_data[LV_IMG_BUF_SIZE_TRUE_COLOR_ALPHA(ICON_W, ICON_H)];
+static lv_img_dsc_t ref_img;
+static uint8_t file_buf[FILE_BUF_SIZE];
+static lv_img_dsc_t raw_img;
+static uint8_t rgb_buf[BENCH_W * BENCH_H * 4];
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_img_png_jpg(void)
+{
+    lv_test_print("");
+    lv_test_print("===================");
+    lv_test_print("Start lv_img_png_jpg tests");
+    lv_test_print("===================");
+
+    lv_img_png_init();
+    lv_img_jpg_init();
+
+    lv_obj_t * img = lv_img_create(lv_scr_act(), NULL);
+
+    test_png(img, "icon.png");
+    test_png(img, "icon2.png");
+    test_jpg(img, JPG_FILE, false);
+    test_jpg(img, JPG_GRAY_FILE, true);
+    test_strip_mem(img);
+    test_invalid(img);
+
+    write_bench_imgs();
+    bench(BENCH_PNG_FILE, lv_img_png_set_mode, "PNG");
+    bench(BENCH_JPG_FILE, lv_img_jpg_set_mode, "JPEG");
+
+    lv_obj_del(img);
+    set_mode(LV_IMG_DECODER_MODE_STRIP);
+    lv_img_cache_invalidate_src(NULL);
+    remove(JPG_FILE);
+    remove(JPG_GRAY_FILE);
+    remove(BENCH_PNG_FILE);
+    remove(BENCH_JPG_FILE);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_png(lv_obj_t * img, const char * path)
+{
+    char buf[128];
+    lv_snprintf(buf, sizeof(buf), "Draw %s", path);
+    lv_test_print(buf);
+
+    ref_png(path, &ref_img, ref_data);
+    load_file(path, &raw_img, LV_IMG_CF_RAW_ALPHA, file_buf);
+    test_same(img, &ref_img, path, &raw_img, "PNG");
+}
+
+static void test_jpg(lv_obj_t * img, const char * path, bool gray)
+{
+    lv_test_print(gray ? "Draw grayscale JPEG" : "Draw RGB JPEG");
+
+    /*Convert an icon to JPEG and use libjpeg's output as reference*/
+    lv_img_dsc_t png_img;
+    ref_png("icon.png", &png_img, ref_data);
+    uint32_t i;
+    for(i = 0; i < ICON_W * ICON_H; i++) {
+        const uint8_t * px = &ref_data[i * LV_IMG_PX_SIZE_ALPHA_BYTE];
+        lv_color_t c;
+        memcpy(&c, px, sizeof(c));
+        rgb_buf[i * 3 + 0] = c.ch.red;
+        rgb_buf[i * 3 + 1] = c.ch.green;
+        rgb_buf[i * 3 + 2] = c.ch.blue;
+    }
+    write_jpg(path, rgb_buf, ICON_W, ICON_H, gray);
+
+    ref_jpg(path, &ref_img, ref_data);
+    load_file(path, &raw_img, LV_IMG_CF_RAW, file_buf);
+    test_same(img, &ref_img, path, &raw_img, "JPEG");
+}
+
+static void test_same(lv_obj_t * img, const lv_img_dsc_t * ref, const char * path, const lv_img_dsc_t * raw,
+                      const char * name)
+{
+    uint32_t fb_size = LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t);
+    char file_path[64];
+    char buf[128];
+    lv_snprintf(file_path, sizeof(file_path), "f:%s", path);
+
+    lv_img_decoder_mode_t modes[] = {LV_IMG_DECODER_MODE_STRIP, LV_IMG_DECODER_MODE_FULL};
+    const char * mode_names[] = {"strip", "full"};
+    lv_point_t pos[] = {{0, 0}, {-20, 15}, {LV_HOR_RES - ICON_W / 2, LV_VER_RES - ICON_H / 3}};
+    uint32_t m;
+    for(m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        set_mode(modes[m]);
+        lv_img_cache_invalidate_src(NULL);
+
+        uint32_t i;
+        for(i = 0; i < sizeof(pos) / sizeof(pos[0]); i++) {
+            draw(img, ref, pos[i].x, pos[i].y);
+            memcpy(fb_ref, test_fb, fb_size);
+
+            draw(img, file_path, pos[i].x, pos[i].y);
+            lv_snprintf(buf, sizeof(buf), "Same %s image from file in %s mode at %d;%d", name, mode_names[m],
+                        pos[i].x, pos[i].y);
+            lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, buf);
+
+            draw(img, raw, pos[i].x, pos[i].y);
+            lv_snprintf(buf, sizeof(buf), "Same %s image from variable in %s mode at %d;%d", name, mode_names[m],
+                        pos[i].x, pos[i].y);
+            lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, buf);
+        }
+    }
+
+    lv_img_set_src(img, ref);
+    lv_img_cache_invalidate_src(NULL);
+}
+
+static void test_strip_mem(lv_obj_t * img)
+{
+    lv_test_print("Memory usage of the decoding modes");
+
+    lv_img_cache_stats_t cache_stats;
+    lv_img_decoder_stats_t png_stats;
+
+    /*Only the decoder's state is kept in strip mode and the image is decoded again on every redraw*/
+    set_mode(LV_IMG_DECODER_MODE_STRIP);
+    lv_img_cache_invalidate_src(NULL);
+    lv_img_png_reset_stats();
+    draw(img, "f:icon.png", 0, 0);
+    draw(img, "f:icon.png", 0, 0);
+    lv_img_png_get_stats(&png_stats);
+    lv_img_cache_get_stats(&cache_stats);
+    lv_test_assert_int_eq(1, png_stats.open_cnt, "Opened once in strip mode");
+    lv_test_assert_true(png_stats.restart_cnt >= 1, "Decoded again on redraw in strip mode");
+    lv_test_assert_int_eq(2 * ICON_W * ICON_H, png_stats.px_cnt, "Decoded pixels in strip mode");
+    lv_test_assert_int_eq(0, cache_stats.mem_used, "No cached pixels in strip mode");
+
+    /*The decoded image is kept in the cache in full mode*/
+    set_mode(LV_IMG_DECODER_MODE_FULL);
+    lv_img_cache_invalidate_src(NULL);
+    lv_img_png_reset_stats();
+    draw(img, "f:icon.png", 0, 0);
+    draw(img, "f:icon.png", 0, 0);
+    lv_img_png_get_stats(&png_stats);
+    lv_img_cache_get_stats(&cache_stats);
+    lv_test_assert_int_eq(1, png_stats.open_cnt, "Opened once in full mode");
+    lv_test_assert_int_eq(0, png_stats.restart_cnt, "Decoded once in full mode");
+    lv_test_assert_int_eq(ICON_W * ICON_H, png_stats.px_cnt, "Decoded pixels in full mode");
+    lv_test_assert_int_eq(LV_IMG_BUF_SIZE_TRUE_COLOR_ALPHA(ICON_W, ICON_H), cache_stats.mem_used,
+                          "Cached pixels in full mode");
+
+    lv_img_set_src(img, &ref_img);
+    set_mode(LV_IMG_DECODER_MODE_STRIP);
+    lv_img_cache_invalidate_src(NULL);
+}
+
+static void test_invalid(lv_obj_t * img)
+{
+    lv_test_print("Reject invalid PNG and JPEG images");
+
+    lv_img_decoder_dsc_t dsc;
+    lv_img_header_t header;
+
+    load_file("icon.png", &raw_img, LV_IMG_CF_RAW_ALPHA, file_buf);
+    lv_test_assert_int_eq(LV_RES_OK, lv_img_decoder_get_info((const char *)&raw_img, &header), "PNG header");
+    lv_test_assert_int_eq(ICON_W, header.w, "PNG width");
+    lv_test_assert_int_eq(LV_IMG_CF_TRUE_COLOR_ALPHA, header.cf, "PNG color format");
+
+    /*Cut the image after the header*/
+    raw_img.data_size /= 2;
+    set_mode(LV_IMG_DECODER_MODE_FULL);
+    lv_test_assert_int_eq(LV_RES_INV, lv_img_decoder_open(&dsc, &raw_img, LV_COLOR_BLACK), "Truncated PNG in full mode");
+
+    set_mode(LV_IMG_DECODER_MODE_STRIP);
+    lv_res_t res = lv_img_decoder_open(&dsc, &raw_img, LV_COLOR_BLACK);
+    if(res == LV_RES_OK) {
+        res = lv_img_decoder_read_area(&dsc, 0, 0, ICON_W, ICON_H, (uint8_t *)rgb_buf);
+        lv_img_decoder_close(&dsc);
+    }
+    lv_test_assert_int_eq(LV_RES_INV, res, "Truncated PNG in strip mode");
+
+    /*Shouldn't crash*/
+    lv_img_cache_invalidate_src(NULL);
+    draw(img, &raw_img, 0, 0);
+
+    /*Corrupt the image data*/
+    raw_img.data_size *= 2;
+    uint32_t i;
+    for(i = raw_img.data_size / 2; i < raw_img.data_size; i++) file_buf[i] = i & 0x7;
+    set_mode(LV_IMG_DECODER_MODE_FULL);
+    lv_test_assert_int_eq(LV_RES_INV, lv_img_decoder_open(&dsc, &raw_img, LV_COLOR_BLACK), "Corrupted PNG");
+
+    /*A JPEG image without start of frame*/
+    const uint8_t no_sof[] = {0xFF, 0xD8, 0xFF, 0xFE, 0x00, 0x04, 'L', 'V', 0xFF, 0xD9};
+    memcpy(file_buf, no_sof, sizeof(no_sof));
+    raw_img.header.cf = LV_IMG_CF_RAW;
+    raw_img.data_size = sizeof(no_sof);
+    lv_test_assert_int_eq(LV_RES_INV, lv_img_decoder_get_info((const char *)&raw_img, &header), "JPEG without frame");
+
+    /*Truncated JPEG*/
+    load_file(JPG_FILE, &raw_img, LV_IMG_CF_RAW, file_buf);
+    raw_img.data_size /= 2;
+    for(i = 0; i < 2; i++) {
+        set_mode(i == 0 ? LV_IMG_DECODER_MODE_STRIP : LV_IMG_DECODER_MODE_FULL);
+        lv_img_cache_invalidate_src(NULL);
+        draw(img, &raw_img, 0, 0);
+    }
+
+    lv_img_set_src(img, &ref_img);
+    set_mode(LV_IMG_DECODER_MODE_STRIP);
+    lv_img_cache_invalidate_src(NULL);
+}
+
+static void bench(const char * path, void (*set_mode_cb)(lv_img_decoder_mode_t), const char * name)
+{
+    char file_path[64];
+    lv_snprintf(file_path, sizeof(file_path), "f:%s", path);
+
+    lv_img_decoder_mode_t modes[] = {LV_IMG_DECODER_MODE_STRIP, LV_IMG_DECODER_MODE_FULL};
+    const char * mode_names[] = {"strip", "full"};
+    uint32_t m;
+    for(m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        set_mode_cb(modes[m]);
+        lv_img_png_reset_stats();
+        lv_img_jpg_reset_stats();
+
+        /*Open and read the whole image in every round*/
+        lv_img_decoder_dsc_t dsc;
+        lv_res_t res = LV_RES_OK;
+        uint32_t time_to_open = 0;
+        uint32_t r;
+        clock_t t = clock();
+        for(r = 0; r < BENCH_ROUNDS; r++) {
+            res = lv_img_decoder_open(&dsc, file_path, LV_COLOR_BLACK);
+            if(res != LV_RES_OK) break;
+            time_to_open = dsc.time_to_open;
+            res = lv_img_decoder_read_area(&dsc, 0, 0, BENCH_W, BENCH_H, rgb_buf);
+            lv_img_decoder_close(&dsc);
+            if(res != LV_RES_OK) break;
+        }
+        t = clock() - t;
+        lv_test_assert_int_eq(LV_RES_OK, res, "Decode bench image");
+
+        lv_img_decoder_stats_t stats;
+        if(set_mode_cb == lv_img_png_set_mode) lv_img_png_get_stats(&stats);
+        else lv_img_jpg_get_stats(&stats);
+        lv_test_assert_int_eq(BENCH_ROUNDS, stats.open_cnt, "Bench image opened");
+        lv_test_assert_int_eq(BENCH_ROUNDS * BENCH_W * BENCH_H, stats.px_cnt, "Bench image decoded");
+
+        uint32_t us = (uint32_t)((uint64_t)t * 1000000 / CLOCKS_PER_SEC / BENCH_ROUNDS);
+        lv_test_print("%s %dx%d image in %s mode: %d us/image, time to open: %d ms", name, BENCH_W, BENCH_H,
+                      mode_names[m], us, time_to_open);
+    }
+
+    set_mode_cb(LV_IMG_DECODER_MODE_STRIP);
+}
+
+static void set_mode(lv_img_decoder_mode_t mode)
+{
+    lv_img_png_set_mode(mode);
+    lv_img_jpg_set_mode(mode);
+}
+
+/**
+ * Decode a PNG file with libpng into a `LV_IMG_CF_TRUE_COLOR_ALPHA` image
+ */
+static void ref_png(const char * path, lv_img_dsc_t * dsc, uint8_t * buf)
+{
+    png_image png;
+    memset(&png, 0, sizeof(png));
+    png.version = PNG_IMAGE_VERSION;
+    lv_test_assert_true(png_image_begin_read_from_file(&png, path) != 0, "Read reference PNG");
+    png.format = PNG_FORMAT_RGBA;
+    lv_test_assert_int_eq(ICON_W, png.width, "Reference PNG width");
+    lv_test_assert_int_eq(ICON_H, png.height, "Reference PNG height");
+    lv_test_assert_true(png_image_finish_read(&png, NULL, rgb_buf, 0, NULL) != 0, "Decode reference PNG");
+
+    uint32_t i;
+    for(i = 0; i < ICON_W * ICON_H; i++) {
+        const uint8_t * in = &rgb_buf[i * 4];
+        lv_color_t c = lv_color_make(in[0], in[1], in[2]);
+        memcpy(&buf[i * LV_IMG_PX_SIZE_ALPHA_BYTE], &c, sizeof(c));
+        buf[i * LV_IMG_PX_SIZE_ALPHA_BYTE + LV_IMG_PX_SIZE_ALPHA_BYTE - 1] = in[3];
+    }
+
+    memset(dsc, 0, sizeof(lv_img_dsc_t));
+    dsc->header.cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+    dsc->header.w = ICON_W;
+    dsc->header.h = ICON_H;
+    dsc->data_size = LV_IMG_BUF_SIZE_TRUE_COLOR_ALPHA(ICON_W, ICON_H);
+    dsc->data = buf;
+}
+
+/**
+ * Decode a JPEG file with libjpeg into a `LV_IMG_CF_TRUE_COLOR` image
+ */
+static void ref_jpg(const char * path, lv_img_dsc_t * dsc, uint8_t * buf)
+{
+    FILE * f = fopen(path, "rb");
+    lv_test_assert_true(f != NULL, "Open reference JPEG");
+    if(f == NULL) return;
+
+    struct jpeg_decompress_struct cinfo;
+    struct jpeg_error_mgr err;
+    cinfo.err = jpeg_std_error(&err);
+    jpeg_create_decompress(&cinfo);
+    jpeg_stdio_src(&cinfo, f);
+    jpeg_read_header(&cinfo, TRUE);
+    bool gray = cinfo.num_components == 1;
+    cinfo.out_color_space = gray ? JCS_GRAYSCALE : JCS_RGB;
+    jpeg_start_decompress(&cinfo);
+    lv_test_assert_int_eq(ICON_W, cinfo.output_width, "Reference JPEG width");
+    lv_test_assert_int_eq(ICON_H, cinfo.output_height, "Reference JPEG height");
+
+    while(cinfo.output_scanline < cinfo.output_height) {
+        JSAMPROW row = &rgb_buf[cinfo.output_scanline * ICON_W * 3];
+        jpeg_read_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    fclose(f);
+
+    uint32_t i;
+    for(i = 0; i < ICON_W * ICON_H; i++) {
+        const uint8_t * in = gray ? &rgb_buf[(i / ICON_W) * ICON_W * 3 + i % ICON_W] : &rgb_buf[i * 3];
+        lv_color_t c = gray ? lv_color_make(in[0], in[0], in[0]) : lv_color_make(in[0], in[1], in[2]);
+        memcpy(&buf[i * sizeof(lv_color_t)], &c, sizeof(c));
+    }
+
+    memset(dsc, 0, sizeof(lv_img_dsc_t));
+    dsc->header.cf = LV_IMG_CF_TRUE_COLOR;
+    dsc->header.w = ICON_W;
+    dsc->header.h = ICON_H;
+    dsc->data_size = LV_IMG_BUF_SIZE_TRUE_COLOR(ICON_W, ICON_H);
+    dsc->data = buf;
+}
+
+static void write_jpg(const char * path, const uint8_t * rgb, uint32_t w, uint32_t h, bool gray)
+{
+    FILE * f = fopen(path, "wb");
+    lv_test_assert_true(f != NULL, "JPEG file created");
+    if(f == NULL) return;
+
+    struct jpeg_compress_struct cinfo;
+    struct jpeg_error_mgr err;
+    cinfo.err = jpeg_std_error(&err);
+    jpeg_create_compress(&cinfo);
+    jpeg_stdio_dest(&cinfo, f);
+    cinfo.image_width = w;
+    cinfo.image_height = h;
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&cinfo);
+    if(gray) jpeg_set_colorspace(&cinfo, JCS_GRAYSCALE);
+    jpeg_set_quality(&cinfo, 90, TRUE);
+    jpeg_start_compress(&cinfo, TRUE);
+    while(cinfo.next_scanline < h) {
+        JSAMPROW row = (JSAMPROW)&rgb[cinfo.next_scanline * w * 3];
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+    fclose(f);
+}
+
+/**
+ * Write a larger PNG and JPEG image with gradients and some noise
+ */
+static void write_bench_imgs(void)
+{
+    uint32_t seed = 1;
+    uint32_t x, y;
+    for(y = 0; y < BENCH_H; y++) {
+        for(x = 0; x < BENCH_W; x++) {
+            seed = (1103515245 * seed + 12345) & 0x7FFFFFFF;
+            uint8_t * px = &rgb_buf[(y * BENCH_W + x) * 4];
+            px[0] = x * 255 / BENCH_W;
+            px[1] = y * 255 / BENCH_H;
+            px[2] = (seed >> 16) & 0x3F;
+            px[3] = 255 - (x + y) / 4;
+        }
+    }
+
+    png_image png;
+    memset(&png, 0, sizeof(png));
+    png.version = PNG_IMAGE_VERSION;
+    png.width = BENCH_W;
+    png.height = BENCH_H;
+    png.format = PNG_FORMAT_RGBA;
+    lv_test_assert_true(png_image_write_to_file(&png, BENCH_PNG_FILE, 0, rgb_buf, 0, NULL) != 0,
+                        "PNG bench image created");
+
+    /*Pack to RGB for the JPEG encoder*/
+    for(x = 0; x < BENCH_W * BENCH_H; x++) {
+        memmove(&rgb_buf[x * 3], &rgb_buf[x * 4], 3);
+    }
+    write_jpg(BENCH_JPG_FILE, rgb_buf, BENCH_W, BENCH_H, false);
+}
+
+/**
+ * Load a file into a `lv_img_dsc_t` variable as raw data
+ */
+static void load_file(const char * path, lv_img_dsc_t * dsc, lv_img_cf_t cf, uint8_t * buf)
+{
+    memset(dsc, 0, sizeof(lv_img_dsc_t));
+
+    FILE * f = fopen(path, "rb");
+    lv_test_assert_true(f != NULL, "Open image file");
+    if(f == NULL) return;
+
+    size_t size = fread(buf, 1, FILE_BUF_SIZE, f);
+    fclose(f);
+    lv_test_assert_true(size > 0 && size < FILE_BUF_SIZE, "Read image file");
+
+    dsc->header.cf = cf;
+    dsc->data_size = size;
+    dsc->data = buf;
+}
+
+static void draw(lv_obj_t * img, const void * src, lv_coord_t x, lv_coord_t y)
+{
+    lv_img_set_src(img, src);
+    lv_obj_set_pos(img, x, y);
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+}
+
+#else
+
+void lv_test_img_png_jpg(void)
+{
+
+}
+
+#endif
+#endif
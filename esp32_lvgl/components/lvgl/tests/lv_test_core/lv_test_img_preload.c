@@ -0,0 +1,214 @@
+/**
+ * @file lv_test_img_preload.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../lvgl.h"
+#if LV_BUILD_TEST
+#include "../lv_test_assert.h"
+
+#include "lv_test_img_preload.h"
+
+#if LV_USE_IMG && LV_IMG_CACHE_DEF_SIZE
+
+/*********************
+ *      DEFINES
+ *********************/
+#define SLOW_SRC        "slow.img"
+#define SLOW_W          16
+#define SLOW_H          24
+#define LINE_TIME       2       /*Time to decode a line [ms]*/
+
+/*A frame may take the budget of the preload task and the decoding of one more line*/
+#define FRAME_BUDGET    (LV_IMG_CACHE_PRELOAD_TIME + LINE_TIME)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t load(const char * name, lv_color_t color);
+static lv_res_t slow_info(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header);
+static lv_res_t slow_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
+static lv_res_t slow_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc,
+                               lv_coord_t x, lv_coord_t y, lv_coord_t len, uint8_t * buf);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+extern lv_color_t test_fb[];    /*Defined in lv_test_main.c*/
+static lv_color_t fb_ref[LV_HOR_RES_MAX * LV_VER_RES_MAX];
+static uint32_t read_cnt;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_img_preload(void)
+{
+    lv_test_print("");
+    lv_test_print("===================");
+    lv_test_print("Start lv_img_preload tests");
+    lv_test_print("===================");
+
+    lv_img_decoder_t * dec = lv_img_decoder_create();
+    lv_img_decoder_set_info_cb(dec, slow_info);
+    lv_img_decoder_set_open_cb(dec, slow_open);
+    lv_img_decoder_set_read_line_cb(dec, slow_read_line);
+
+    lv_obj_clean(lv_scr_act());
+    lv_obj_t * img = lv_img_create(lv_scr_act(), NULL);
+    lv_img_set_src(img, SLOW_SRC);
+    lv_obj_set_pos(img, 10, 10);
+    lv_color_t color = lv_obj_get_style_image_recolor(img, LV_IMG_PART_MAIN);
+    uint32_t fb_size = sizeof(lv_color_t) * LV_HOR_RES * LV_VER_RES;
+
+    /*Reference: the image is decoded while drawing*/
+    uint32_t t = lv_tick_get();
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    uint32_t sync_time = lv_tick_elaps(t);
+    memcpy(fb_ref, test_fb, fb_size);
+    lv_test_print("Frame with the image decoded while drawing: %d ms", sync_time);
+    lv_test_assert_int_gt(FRAME_BUDGET, sync_time, "The slow decoder exceeds the frame budget");
+
+    /*Asynchronous image: only the background is drawn first*/
+    lv_img_cache_invalidate_src(SLOW_SRC);
+    lv_img_set_async(img, true);
+    t = lv_tick_get();
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    lv_test_print("Frame with placeholder: %d ms", lv_tick_elaps(t));
+    lv_test_assert_int_lt(FRAME_BUDGET + 1, lv_tick_elaps(t), "Placeholder is drawn in time");
+    lv_test_assert_true(lv_img_cache_is_loading(SLOW_SRC, color), "Asynchronous image is loading");
+    lv_test_assert_true(memcmp(fb_ref, test_fb, fb_size) != 0, "Placeholder is drawn instead of the image");
+
+    uint32_t max_time = load("Asynchronous image", color);
+    lv_test_assert_int_lt(FRAME_BUDGET + 1, max_time, "No frame is over budget while loading");
+
+    /*The refresh task ran before the preload task so the invalidated area is not refreshed yet*/
+    lv_test_assert_true(lv_disp_get_default()->inv_p > 0, "Loaded image invalidated itself");
+
+    read_cnt = 0;
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, "Loaded asynchronous image");
+    lv_test_assert_int_eq(0, read_cnt, "Loaded image is drawn from the cache");
+
+    /*Prefetch the images of a screen*/
+    lv_img_cache_invalidate_src(SLOW_SRC);
+    lv_img_set_async(img, false);
+    lv_img_prefetch(lv_scr_act());
+    lv_test_assert_true(lv_img_cache_is_loading(SLOW_SRC, color), "Prefetched image is loading");
+
+    max_time = load("Prefetched image", color);
+    lv_test_assert_int_lt(FRAME_BUDGET + 1, max_time, "No frame is over budget while prefetching");
+    lv_test_assert_true(lv_img_cache_is_cached(SLOW_SRC, color), "Prefetched image is cached");
+
+    read_cnt = 0;
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, "Prefetched image");
+    lv_test_assert_int_eq(0, read_cnt, "Prefetched image is drawn from the cache");
+
+    /*Canceled loading*/
+    lv_img_cache_invalidate_src(SLOW_SRC);
+    lv_img_prefetch(lv_scr_act());
+    lv_img_cache_invalidate_src(SLOW_SRC);
+    lv_test_assert_true(lv_img_cache_is_loading(SLOW_SRC, color) == false, "Loading is canceled");
+
+    lv_obj_clean(lv_scr_act());
+    lv_img_cache_invalidate_src(SLOW_SRC);
+    lv_img_decoder_delete(dec);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Run the task handler until the slow image is loaded
+ * @param name name of the test case
+ * @param color the color of the image
+ * @return the longest run of the task handler [ms]
+ */
+static uint32_t load(const char * name, lv_color_t color)
+{
+    uint32_t max_time = 0;
+    uint32_t run_cnt = 0;
+    uint32_t t_start = lv_tick_get();
+    while(lv_img_cache_is_loading(SLOW_SRC, color) && run_cnt < 1000) {
+        uint32_t t = lv_tick_get();
+        lv_task_handler();
+        uint32_t elaps = lv_tick_elaps(t);
+        if(elaps > max_time) max_time = elaps;
+        run_cnt++;
+    }
+
+    lv_test_print("%s: loaded in %d ms with %d runs of the task handler, the longest run: %d ms", name,
+                  lv_tick_elaps(t_start), run_cnt, max_time);
+    lv_test_assert_true(lv_img_cache_is_loading(SLOW_SRC, color) == false, "Image is loaded");
+
+    return max_time;
+}
+
+static lv_res_t slow_info(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header)
+{
+    (void)decoder;
+    if(lv_img_src_get_type(src) != LV_IMG_SRC_FILE || strcmp(src, SLOW_SRC) != 0) return LV_RES_INV;
+
+    header->always_zero = 0;
+    header->w = SLOW_W;
+    header->h = SLOW_H;
+    header->cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+    return LV_RES_OK;
+}
+
+static lv_res_t slow_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    (void)decoder;
+    dsc->img_data = NULL;
+    return LV_RES_OK;
+}
+
+/**
+ * Decode a line of a gradient slowly.
+ * The tick of the tests is advanced only by `lv_tick_inc()` so simulate the time spent with decoding.
+ */
+static lv_res_t slow_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc,
+                               lv_coord_t x, lv_coord_t y, lv_coord_t len, uint8_t * buf)
+{
+    (void)decoder;
+    (void)dsc;
+    lv_tick_inc(LINE_TIME);
+
+    lv_coord_t i;
+    for(i = 0; i < len; i++) {
+        lv_color_t c = lv_color_make((x + i) * 255 / SLOW_W, y * 255 / SLOW_H, 0);
+        memcpy(&buf[i * LV_IMG_PX_SIZE_ALPHA_BYTE], &c, sizeof(lv_color_t));
+        buf[i * LV_IMG_PX_SIZE_ALPHA_BYTE + LV_IMG_PX_SIZE_ALPHA_BYTE - 1] = (x + i) < 2 ? LV_OPA_50 : LV_OPA_COVER;
+    }
+
+    read_cnt++;
+    return LV_RES_OK;
+}
+
+#else
+
+void lv_test_img_preload(void)
+{
+
+}
+
+#endif
+#endif
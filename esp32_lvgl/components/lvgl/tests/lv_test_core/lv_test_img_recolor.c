@@ -0,0 +1,181 @@
+/**
+ * @file lv_test_img_recolor.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../lvgl.h"
+#if LV_BUILD_TEST
+#include "../lv_test_assert.h"
+
+#include "lv_test_img_recolor.h"
+
+#if LV_USE_IMG
+#include <time.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BENCH_W         100
+#define BENCH_H         100
+#define BENCH_IMG_NUM   LV_MATH_MAX((LV_HOR_RES_MAX * LV_VER_RES_MAX) / 5 / BENCH_W / BENCH_H, 1)
+#define BENCH_ROUNDS    20
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void bench(const char * name, lv_img_cf_t cf, lv_opa_t recolor_opa, lv_opa_t opa);
+static uint32_t rnd_next(void);
+static void fill_img(lv_img_cf_t cf);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+extern lv_color_t test_fb[];    /*Defined in lv_test_main.c*/
+static lv_color_t fb_ref[LV_HOR_RES_MAX * LV_VER_RES_MAX];
+
+static uint8_t img_data[LV_IMG_BUF_SIZE_TRUE_COLOR_ALPHA(BENCH_W, BENCH_H)];
+static lv_img_dsc_t img;
+static uint32_t rnd_seed;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_img_recolor(void)
+{
+    lv_test_print("");
+    lv_test_print("===================");
+    lv_test_print("Start lv_img_recolor tests");
+    lv_test_print("===================");
+
+    /*As `img_ckey_cb`, `img_rgb_recolor_cb`, `img_argb_recolor_cb` and `img_ckey_recolor_cb` of the benchmark demo*/
+    bench("chroma keyed", LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED, LV_OPA_TRANSP, LV_OPA_COVER);
+    bench("chroma keyed", LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED, LV_OPA_TRANSP, LV_OPA_50);
+    bench("RGB recolor", LV_IMG_CF_TRUE_COLOR, LV_OPA_50, LV_OPA_COVER);
+    bench("RGB recolor", LV_IMG_CF_TRUE_COLOR, LV_OPA_50, LV_OPA_50);
+    bench("ARGB recolor", LV_IMG_CF_TRUE_COLOR_ALPHA, LV_OPA_50, LV_OPA_COVER);
+    bench("ARGB recolor", LV_IMG_CF_TRUE_COLOR_ALPHA, LV_OPA_50, LV_OPA_50);
+    bench("chroma keyed recolor", LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED, LV_OPA_50, LV_OPA_COVER);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Draw images with the span functions and with the generic pixel-by-pixel path.
+ * A mask which covers everything forces the generic path without changing the result.
+ */
+static void bench(const char * name, lv_img_cf_t cf, lv_opa_t recolor_opa, lv_opa_t opa)
+{
+    uint32_t fb_size = LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t);
+    lv_obj_t * objs[BENCH_IMG_NUM];
+    uint32_t i;
+    uint32_t r;
+
+    fill_img(cf);
+
+    rnd_seed = 1;
+    for(i = 0; i < BENCH_IMG_NUM; i++) {
+        objs[i] = lv_img_create(lv_scr_act(), NULL);
+        lv_img_set_src(objs[i], &img);
+        lv_obj_set_style_local_image_opa(objs[i], LV_IMG_PART_MAIN, LV_STATE_DEFAULT, opa);
+        lv_obj_set_style_local_image_recolor_opa(objs[i], LV_IMG_PART_MAIN, LV_STATE_DEFAULT, recolor_opa);
+        lv_obj_set_style_local_image_recolor(objs[i], LV_IMG_PART_MAIN, LV_STATE_DEFAULT,
+                                             lv_color_hex(rnd_next() % 0xFFFFF0));
+        lv_obj_set_pos(objs[i], rnd_next() % LV_HOR_RES - BENCH_W / 2, rnd_next() % LV_VER_RES - BENCH_H / 2);
+    }
+
+    lv_draw_mask_line_param_t mask_param;
+    lv_draw_mask_line_points_init(&mask_param, 0, -1, LV_HOR_RES, -1, LV_DRAW_MASK_LINE_SIDE_BOTTOM);
+
+    clock_t t[2];
+    uint32_t k;
+    for(k = 0; k < 2; k++) {
+        int16_t mask_id = LV_MASK_ID_INV;
+        if(k == 0) mask_id = lv_draw_mask_add(&mask_param, NULL);
+
+        t[k] = clock();
+        for(r = 0; r < BENCH_ROUNDS; r++) {
+            for(i = 0; i < BENCH_IMG_NUM; i++) lv_obj_invalidate(objs[i]);
+            lv_refr_now(NULL);
+        }
+        t[k] = clock() - t[k];
+
+        lv_obj_invalidate(lv_scr_act());
+        lv_refr_now(NULL);
+        if(k == 0) memcpy(fb_ref, test_fb, fb_size);
+
+        if(mask_id != LV_MASK_ID_INV) lv_draw_mask_remove_id(mask_id);
+    }
+
+    lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, "Same images drawn");
+
+    for(i = 0; i < BENCH_IMG_NUM; i++) lv_obj_del(objs[i]);
+    lv_img_cache_invalidate_src(&img);
+
+    lv_test_print("Draw %d %s images with opa %d %d times: pixel-by-pixel: %d us, span: %d us",
+                  BENCH_IMG_NUM, name, opa, BENCH_ROUNDS,
+                  (int)((int64_t)t[0] * 1000000 / CLOCKS_PER_SEC), (int)((int64_t)t[1] * 1000000 / CLOCKS_PER_SEC));
+}
+
+static uint32_t rnd_next(void)
+{
+    rnd_seed = rnd_seed * 1103515245 + 12345;
+    return rnd_seed >> 8;
+}
+
+/**
+ * Fill the image with runs of random colors and opacities like a drawn image.
+ * Chroma keyed images get runs of the chroma key color too.
+ */
+static void fill_img(lv_img_cf_t cf)
+{
+    uint32_t px_size = cf == LV_IMG_CF_TRUE_COLOR_ALPHA ? LV_IMG_PX_SIZE_ALPHA_BYTE : sizeof(lv_color_t);
+    uint32_t px_cnt = BENCH_W * BENCH_H;
+    uint32_t i = 0;
+    rnd_seed = cf;
+    while(i < px_cnt) {
+        lv_color_t c = lv_color_hex(rnd_next() & 0xFFFFFF);
+        lv_opa_t opa = LV_OPA_COVER;
+        uint32_t run = rnd_next() % 8 + 1;
+        uint32_t type = rnd_next() % 4;
+        if(cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED && type == 0) c = LV_COLOR_TRANSP;
+        if(type == 1) opa = LV_OPA_TRANSP;
+        else if(type == 2) opa = rnd_next();
+
+        for(; run > 0 && i < px_cnt; run--, i++) {
+            memcpy(&img_data[i * px_size], &c, sizeof(lv_color_t));
+            if(cf == LV_IMG_CF_TRUE_COLOR_ALPHA) img_data[i * px_size + px_size - 1] = opa;
+        }
+    }
+
+    img.header.always_zero = 0;
+    img.header.cf = cf;
+    img.header.w = BENCH_W;
+    img.header.h = BENCH_H;
+    img.data_size = px_cnt * px_size;
+    img.data = img_data;
+}
+
+#else
+
+void lv_test_img_recolor(void)
+{
+
+}
+
+#endif
+#endif
@@ -0,0 +1,354 @@
+/**
+ * @file lv_test_img_strip.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../lvgl.h"
+#if LV_BUILD_TEST
+#include "../lv_test_assert.h"
+
+#include "lv_test_img_strip.h"
+
+#if LV_USE_FILESYSTEM && LV_USE_IMG && LV_IMG_CF_INDEXED && LV_IMG_CF_ALPHA
+#include <stdio.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define IMG_W           240
+#define IMG_H           240
+#define ALPHA_W         100
+#define ALPHA_H         60
+#define BENCH_ROUNDS    10
+
+#define TC_FILE         "lv_test_img_strip_tc.bin"
+#define INDEXED_FILE    "lv_test_img_strip_indexed.bin"
+#define ALPHA_FILE      "lv_test_img_strip_alpha.bin"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void fs_init(void);
+static void create_imgs(void);
+static void write_file(const char * path, const lv_img_dsc_t * img);
+static void draw(lv_obj_t * img, const void * src, lv_coord_t x, lv_coord_t y);
+static void test_same(lv_obj_t * img, const lv_img_dsc_t * var_src, const char * file_src, lv_coord_t x, lv_coord_t y);
+static void bench(lv_obj_t * img);
+static lv_res_t ref_decoder_info(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header);
+static lv_res_t ref_decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
+static lv_res_t ref_decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x,
+                                      lv_coord_t y, lv_coord_t len, uint8_t * buf);
+static void ref_decoder_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+extern lv_color_t test_fb[];    /*Defined in lv_test_main.c*/
+static lv_color_t fb_ref[LV_HOR_RES_MAX * LV_VER_RES_MAX];
+
+static lv_color_t tc_data[IMG_W * IMG_H];
+static uint8_t indexed_data[LV_IMG_BUF_SIZE_INDEXED_4BIT(IMG_W, IMG_H)];
+static uint8_t alpha_data[LV_IMG_BUF_SIZE_ALPHA_4BIT(ALPHA_W, ALPHA_H)];
+static lv_img_dsc_t tc_img;
+static lv_img_dsc_t indexed_img;
+static lv_img_dsc_t alpha_img;
+
+static uint32_t fs_call_cnt;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_img_strip(void)
+{
+    lv_test_print("");
+    lv_test_print("===================");
+    lv_test_print("Start lv_img_strip tests");
+    lv_test_print("===================");
+
+    fs_init();
+    create_imgs();
+
+    lv_img_decoder_t * dec = lv_img_decoder_create();
+    lv_img_decoder_set_info_cb(dec, ref_decoder_info);
+    lv_img_decoder_set_open_cb(dec, ref_decoder_open);
+    lv_img_decoder_set_read_line_cb(dec, ref_decoder_read_line);
+    lv_img_decoder_set_close_cb(dec, ref_decoder_close);
+
+    lv_obj_t * img = lv_img_create(lv_scr_act(), NULL);
+
+    lv_test_print("Draw images from file in strips");
+    test_same(img, &tc_img, "C:"TC_FILE, 0, 0);
+    test_same(img, &tc_img, "C:"TC_FILE, -30, 10);
+    test_same(img, &indexed_img, "C:"INDEXED_FILE, 0, 0);
+    test_same(img, &indexed_img, "C:"INDEXED_FILE, -30, 10);
+    test_same(img, &alpha_img, "C:"ALPHA_FILE, -10, 5);
+
+    bench(img);
+
+    lv_obj_del(img);
+    lv_img_decoder_delete(dec);
+    lv_img_cache_invalidate_src(NULL);
+    remove(TC_FILE);
+    remove(INDEXED_FILE);
+    remove(ALPHA_FILE);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/*A POSIX file system counting the calls*/
+static lv_fs_res_t fs_open_cb(struct _lv_fs_drv_t * drv, void * file_p, const char * path, lv_fs_mode_t mode)
+{
+    LV_UNUSED(drv);
+    LV_UNUSED(mode);
+    fs_call_cnt++;
+    int fd = open(path, O_RDONLY);
+    *((int *)file_p) = fd;
+    return fd < 0 ? LV_FS_RES_NOT_EX : LV_FS_RES_OK;
+}
+
+static lv_fs_res_t fs_close_cb(struct _lv_fs_drv_t * drv, void * file_p)
+{
+    LV_UNUSED(drv);
+    fs_call_cnt++;
+    close(*((int *)file_p));
+    return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t fs_read_cb(struct _lv_fs_drv_t * drv, void * file_p, void * buf, uint32_t btr, uint32_t * br)
+{
+    LV_UNUSED(drv);
+    fs_call_cnt++;
+    ssize_t res = read(*((int *)file_p), buf, btr);
+    if(res < 0) return LV_FS_RES_UNKNOWN;
+    *br = res;
+    return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t fs_seek_cb(struct _lv_fs_drv_t * drv, void * file_p, uint32_t pos)
+{
+    LV_UNUSED(drv);
+    fs_call_cnt++;
+    return lseek(*((int *)file_p), pos, SEEK_SET) < 0 ? LV_FS_RES_UNKNOWN : LV_FS_RES_OK;
+}
+
+static void fs_init(void)
+{
+    static bool inited = false;
+    if(inited) return;
+    inited = true;
+
+    /*'C' for the built-in decoder, 'R' for the reference decoder*/
+    char letters[] = {'C', 'R'};
+    uint32_t i;
+    for(i = 0; i < sizeof(letters); i++) {
+        lv_fs_drv_t drv;
+        lv_fs_drv_init(&drv);
+        drv.letter = letters[i];
+        drv.file_size = sizeof(int);
+        drv.open_cb = fs_open_cb;
+        drv.close_cb = fs_close_cb;
+        drv.read_cb = fs_read_cb;
+        drv.seek_cb = fs_seek_cb;
+        lv_fs_drv_register(&drv);
+    }
+}
+
+static void create_imgs(void)
+{
+    uint32_t x;
+    uint32_t y;
+    for(y = 0; y < IMG_H; y++) {
+        for(x = 0; x < IMG_W; x++) {
+            tc_data[y * IMG_W + x] = lv_color_make(x, y, x ^ y);
+        }
+    }
+    tc_img.header.always_zero = 0;
+    tc_img.header.cf = LV_IMG_CF_TRUE_COLOR;
+    tc_img.header.w = IMG_W;
+    tc_img.header.h = IMG_H;
+    tc_img.data_size = sizeof(tc_data);
+    tc_img.data = (const uint8_t *)tc_data;
+    write_file(TC_FILE, &tc_img);
+
+    lv_color32_t * palette = (lv_color32_t *)indexed_data;
+    for(x = 0; x < 16; x++) {
+        palette[x].ch.red = x * 16;
+        palette[x].ch.green = 255 - x * 16;
+        palette[x].ch.blue = x * 7;
+        palette[x].ch.alpha = x == 5 ? 0 : 255 - x;
+    }
+    uint8_t * px = &indexed_data[16 * sizeof(lv_color32_t)];
+    for(y = 0; y < IMG_H; y++) {
+        for(x = 0; x < IMG_W; x += 2) {
+            *px = (((x + y) & 0xF) << 4) | ((x * y + 1) & 0xF);
+            px++;
+        }
+    }
+    indexed_img.header.always_zero = 0;
+    indexed_img.header.cf = LV_IMG_CF_INDEXED_4BIT;
+    indexed_img.header.w = IMG_W;
+    indexed_img.header.h = IMG_H;
+    indexed_img.data_size = sizeof(indexed_data);
+    indexed_img.data = indexed_data;
+    write_file(INDEXED_FILE, &indexed_img);
+
+    for(x = 0; x < sizeof(alpha_data); x++) {
+        alpha_data[x] = x * 37;
+    }
+    alpha_img.header.always_zero = 0;
+    alpha_img.header.cf = LV_IMG_CF_ALPHA_4BIT;
+    alpha_img.header.w = ALPHA_W;
+    alpha_img.header.h = ALPHA_H;
+    alpha_img.data_size = sizeof(alpha_data);
+    alpha_img.data = alpha_data;
+    write_file(ALPHA_FILE, &alpha_img);
+}
+
+static void write_file(const char * path, const lv_img_dsc_t * img)
+{
+    FILE * f = fopen(path, "wb");
+    lv_test_assert_true(f != NULL, "Image file created");
+    if(f == NULL) return;
+
+    fwrite(&img->header, sizeof(lv_img_header_t), 1, f);
+    fwrite(img->data, 1, img->data_size, f);
+    fclose(f);
+}
+
+static void draw(lv_obj_t * img, const void * src, lv_coord_t x, lv_coord_t y)
+{
+    lv_img_set_src(img, src);
+    lv_obj_set_pos(img, x, y);
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+}
+
+static void test_same(lv_obj_t * img, const lv_img_dsc_t * var_src, const char * file_src, lv_coord_t x, lv_coord_t y)
+{
+    uint32_t fb_size = LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t);
+
+    draw(img, var_src, x, y);
+    memcpy(fb_ref, test_fb, fb_size);
+    lv_obj_set_hidden(img, true);
+    draw(img, var_src, x, y);
+    lv_test_assert_true(memcmp(fb_ref, test_fb, fb_size) != 0, "The image is drawn");
+    lv_obj_set_hidden(img, false);
+
+    draw(img, file_src, x, y);
+    lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, "Same image from variable and file");
+}
+
+static void bench(lv_obj_t * img)
+{
+    uint32_t fb_size = LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t);
+    uint32_t r;
+
+    draw(img, "R:"TC_FILE, 0, 0);
+    memcpy(fb_ref, test_fb, fb_size);
+    draw(img, "C:"TC_FILE, 0, 0);
+    lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, "Same image line-by-line and in strips");
+
+    /*Keep the file open in the cache and count only the reads*/
+    lv_img_set_src(img, "R:"TC_FILE);
+    fs_call_cnt = 0;
+    clock_t t_ref = clock();
+    for(r = 0; r < BENCH_ROUNDS; r++) {
+        lv_obj_invalidate(img);
+        lv_refr_now(NULL);
+    }
+    t_ref = clock() - t_ref;
+    uint32_t call_ref = fs_call_cnt / BENCH_ROUNDS;
+
+    lv_img_set_src(img, "C:"TC_FILE);
+    lv_refr_now(NULL);
+    fs_call_cnt = 0;
+    clock_t t_act = clock();
+    for(r = 0; r < BENCH_ROUNDS; r++) {
+        lv_obj_invalidate(img);
+        lv_refr_now(NULL);
+    }
+    t_act = clock() - t_act;
+    uint32_t call_act = fs_call_cnt / BENCH_ROUNDS;
+
+#if LV_IMG_CACHE_DEF_SIZE
+    lv_test_assert_true(call_act < call_ref, "Less file system calls");
+#endif
+
+    lv_test_print("Draw a %dx%d image from file: line-by-line: %d fs calls, %d us; strips: %d fs calls, %d us",
+                  IMG_W, IMG_H, call_ref, (int)((int64_t)t_ref * 1000000 / CLOCKS_PER_SEC / BENCH_ROUNDS),
+                  call_act, (int)((int64_t)t_act * 1000000 / CLOCKS_PER_SEC / BENCH_ROUNDS));
+}
+
+/*The former built-in true color file decoder as reference: seek and read every line*/
+static lv_res_t ref_decoder_info(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header)
+{
+    if(lv_img_src_get_type(src) != LV_IMG_SRC_FILE) return LV_RES_INV;
+    if(((const char *)src)[0] != 'R') return LV_RES_INV;
+
+    return lv_img_decoder_built_in_info(decoder, src, header);
+}
+
+static lv_res_t ref_decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(decoder);
+    lv_fs_file_t * f = lv_mem_alloc(sizeof(lv_fs_file_t));
+    if(f == NULL) return LV_RES_INV;
+    if(lv_fs_open(f, dsc->src, LV_FS_MODE_RD) != LV_FS_RES_OK) {
+        lv_mem_free(f);
+        return LV_RES_INV;
+    }
+    dsc->user_data = f;
+    return LV_RES_OK;
+}
+
+static lv_res_t ref_decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x,
+                                      lv_coord_t y, lv_coord_t len, uint8_t * buf)
+{
+    LV_UNUSED(decoder);
+    uint8_t px_size = lv_img_cf_get_px_size(dsc->header.cf);
+    uint32_t pos = ((y * dsc->header.w + x) * px_size) >> 3;
+    pos += 4; /*Skip the header*/
+    if(lv_fs_seek(dsc->user_data, pos) != LV_FS_RES_OK) return LV_RES_INV;
+
+    uint32_t btr = len * (px_size >> 3);
+    uint32_t br  = 0;
+    lv_fs_res_t res = lv_fs_read(dsc->user_data, buf, btr, &br);
+    if(res != LV_FS_RES_OK || btr != br) return LV_RES_INV;
+
+    return LV_RES_OK;
+}
+
+static void ref_decoder_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(decoder);
+    lv_fs_close(dsc->user_data);
+    lv_mem_free(dsc->user_data);
+    dsc->user_data = NULL;
+}
+
+#else
+
+void lv_test_img_strip(void)
+{
+}
+
+#endif /*LV_USE_FILESYSTEM && LV_USE_IMG && LV_IMG_CF_INDEXED && LV_IMG_CF_ALPHA*/
+#endif /*LV_BUILD_TEST*/
@@ -0,0 +1,291 @@
+/**
+ * @file lv_test_img_transform.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../lvgl.h"
+#if LV_BUILD_TEST
+#include "../lv_test_assert.h"
+
+#include "lv_test_img_transform.h"
+
+#if LV_USE_IMG_TRANSFORM
+#include <time.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define IMG_W           100
+#define IMG_H           100
+#define BENCH_IMG_NUM   LV_MATH_MAX((LV_HOR_RES_MAX * LV_VER_RES_MAX) / 5 / IMG_W / IMG_H, 1)
+#define BENCH_ROUNDS    10
+#define BENCH_ZOOM_MIN  128
+#define BENCH_ZOOM_MAX  (256 + 64)
+#define LINE_MAX        512
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void fill_images(void);
+static void init_dsc(lv_img_transform_dsc_t * dsc, lv_img_cf_t cf, lv_coord_t w, lv_coord_t h, int16_t angle,
+                     uint16_t zoom, lv_coord_t pivot_x, lv_coord_t pivot_y, bool aa);
+static bool check_identical(lv_img_transform_dsc_t * dsc);
+static void test_identical(void);
+static void bench(const char * name, lv_img_cf_t cf, bool rotate, bool zoom, bool aa);
+static uint32_t rnd_next(uint32_t max);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static uint8_t img_rgb[IMG_W * IMG_H * sizeof(lv_color_t)];
+static uint8_t img_argb[IMG_W * IMG_H * LV_IMG_PX_SIZE_ALPHA_BYTE];
+static lv_color_t cbuf_ref[LINE_MAX];
+static lv_color_t cbuf_act[LINE_MAX];
+static lv_opa_t abuf_ref[LINE_MAX];
+static lv_opa_t abuf_act[LINE_MAX];
+static uint32_t rnd_seed;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_img_transform(void)
+{
+    lv_test_print("");
+    lv_test_print("===================");
+    lv_test_print("Start lv_img_transform tests");
+    lv_test_print("===================");
+
+    fill_images();
+    test_identical();
+
+    /*The same cases as in the benchmark demo*/
+    bench("RGB rotate", LV_IMG_CF_TRUE_COLOR, true, false, false);
+    bench("RGB rotate anti aliased", LV_IMG_CF_TRUE_COLOR, true, false, true);
+    bench("ARGB rotate", LV_IMG_CF_TRUE_COLOR_ALPHA, true, false, false);
+    bench("ARGB rotate anti aliased", LV_IMG_CF_TRUE_COLOR_ALPHA, true, false, true);
+    bench("RGB zoom", LV_IMG_CF_TRUE_COLOR, false, true, false);
+    bench("RGB zoom anti aliased", LV_IMG_CF_TRUE_COLOR, false, true, true);
+    bench("ARGB zoom", LV_IMG_CF_TRUE_COLOR_ALPHA, false, true, false);
+    bench("ARGB zoom anti aliased", LV_IMG_CF_TRUE_COLOR_ALPHA, false, true, true);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/*Something similar to the cogwheel of the benchmark demo: a colorful disc with holes*/
+static void fill_images(void)
+{
+    lv_coord_t x;
+    lv_coord_t y;
+    lv_color_t chroma_color = LV_COLOR_TRANSP;
+    for(y = 0; y < IMG_H; y++) {
+        for(x = 0; x < IMG_W; x++) {
+            int32_t dx = x - IMG_W / 2;
+            int32_t dy = y - IMG_H / 2;
+            int32_t r2 = dx * dx + dy * dy;
+            lv_color_t c = lv_color_make(x * 2, y * 2, ((x ^ y) * 4) & 0xFF);
+            lv_opa_t opa;
+            if(r2 > 48 * 48) opa = LV_OPA_TRANSP;
+            else if(r2 > 44 * 44) opa = 255 - (r2 - 44 * 44) * 255 / (48 * 48 - 44 * 44);
+            else if(r2 < 10 * 10) opa = LV_OPA_TRANSP;
+            else opa = ((x / 8 + y / 8) & 0x3) == 0 ? LV_OPA_50 : LV_OPA_COVER;
+
+            /*Make some pixels transparent for the chroma keyed tests too*/
+            if(r2 < 10 * 10) c = chroma_color;
+
+            uint32_t i = y * IMG_W + x;
+            _lv_memcpy_small(&img_rgb[i * sizeof(lv_color_t)], &c, sizeof(lv_color_t));
+            _lv_memcpy_small(&img_argb[i * LV_IMG_PX_SIZE_ALPHA_BYTE], &c, LV_IMG_PX_SIZE_ALPHA_BYTE - 1);
+            img_argb[i * LV_IMG_PX_SIZE_ALPHA_BYTE + LV_IMG_PX_SIZE_ALPHA_BYTE - 1] = opa;
+        }
+    }
+}
+
+static void init_dsc(lv_img_transform_dsc_t * dsc, lv_img_cf_t cf, lv_coord_t w, lv_coord_t h, int16_t angle,
+                     uint16_t zoom, lv_coord_t pivot_x, lv_coord_t pivot_y, bool aa)
+{
+    _lv_memset_00(dsc, sizeof(lv_img_transform_dsc_t));
+    dsc->cfg.angle = angle;
+    dsc->cfg.zoom = zoom;
+    dsc->cfg.src = cf == LV_IMG_CF_TRUE_COLOR_ALPHA ? img_argb : img_rgb;
+    dsc->cfg.src_w = w;
+    dsc->cfg.src_h = h;
+    dsc->cfg.cf = cf;
+    dsc->cfg.pivot_x = pivot_x;
+    dsc->cfg.pivot_y = pivot_y;
+    dsc->cfg.color = LV_COLOR_RED;
+    dsc->cfg.antialias = aa;
+    _lv_img_buf_transform_init(dsc);
+}
+
+/*Compare the line transformation with `_lv_img_buf_transform` on every line of the transformed area*/
+static bool check_identical(lv_img_transform_dsc_t * dsc)
+{
+    lv_point_t pivot = {dsc->cfg.pivot_x, dsc->cfg.pivot_y};
+    lv_area_t a;
+    _lv_img_buf_get_transformed_area(&a, dsc->cfg.src_w, dsc->cfg.src_h, dsc->cfg.angle, dsc->cfg.zoom, &pivot);
+
+    /*Start a little bit outside to see the lines on the edges too*/
+    a.x1 -= 3;
+    a.y1 -= 3;
+    a.x2 += 3;
+    a.y2 += 3;
+    lv_coord_t len = LV_MATH_MIN(lv_area_get_width(&a), LINE_MAX);
+
+    lv_coord_t x;
+    lv_coord_t y;
+    for(y = a.y1; y <= a.y2; y++) {
+        for(x = 0; x < len; x++) {
+            if(_lv_img_buf_transform(dsc, a.x1 + x, y)) {
+                cbuf_ref[x] = dsc->res.color;
+                abuf_ref[x] = dsc->res.opa;
+            }
+            else {
+                abuf_ref[x] = LV_OPA_TRANSP;
+            }
+        }
+
+        _lv_img_buf_transform_line(dsc, a.x1, y, len, cbuf_act, abuf_act);
+
+        for(x = 0; x < len; x++) {
+            if(abuf_ref[x] != abuf_act[x]) return false;
+            if(abuf_ref[x] == LV_OPA_TRANSP) continue;
+#if LV_COLOR_DEPTH == 32
+            /*The alpha byte of the colors is not used*/
+            cbuf_ref[x].ch.alpha = 0;
+            cbuf_act[x].ch.alpha = 0;
+#endif
+            if(cbuf_ref[x].full != cbuf_act[x].full) return false;
+        }
+    }
+
+    return true;
+}
+
+static void test_identical(void)
+{
+    static const lv_img_cf_t cfs[] = {LV_IMG_CF_TRUE_COLOR, LV_IMG_CF_TRUE_COLOR_ALPHA, LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED};
+    static const int16_t angles[] = {0, 1, 9, 450, 899, 900, 901, 1350, 1799, 1800, 2700, 3000, 3599};
+    static const uint16_t zooms[] = {LV_IMG_ZOOM_NONE, 64, 128, 200, 255, 257, 300, 512, 768};
+    static const lv_point_t sizes[] = {{IMG_W, IMG_H}, {37, 23}, {1, 5}};
+
+    lv_test_print("Transform lines like pixel-by-pixel");
+
+    uint32_t cf_i;
+    for(cf_i = 0; cf_i < sizeof(cfs) / sizeof(cfs[0]); cf_i++) {
+        uint32_t a_i;
+        for(a_i = 0; a_i < sizeof(angles) / sizeof(angles[0]); a_i++) {
+            uint32_t z_i;
+            for(z_i = 0; z_i < sizeof(zooms) / sizeof(zooms[0]); z_i++) {
+                uint32_t s_i;
+                for(s_i = 0; s_i < sizeof(sizes) / sizeof(sizes[0]); s_i++) {
+                    lv_coord_t w = sizes[s_i].x;
+                    lv_coord_t h = sizes[s_i].y;
+                    uint32_t aa;
+                    for(aa = 0; aa < 2; aa++) {
+                        lv_img_transform_dsc_t dsc;
+                        bool ok;
+                        init_dsc(&dsc, cfs[cf_i], w, h, angles[a_i], zooms[z_i], w / 2, h / 2, aa);
+                        ok = check_identical(&dsc);
+                        if(ok) {
+                            /*Rotate around an other pivot too*/
+                            init_dsc(&dsc, cfs[cf_i], w, h, angles[a_i], zooms[z_i], w / 5, h - 1, aa);
+                            ok = check_identical(&dsc);
+                        }
+
+                        if(!ok) {
+                            lv_test_print("cf: %d, angle: %d, zoom: %d, size: %dx%d, aa: %d",
+                                          cfs[cf_i], angles[a_i], zooms[z_i], w, h, aa);
+                            lv_test_assert_true(false, "Transformed line");
+                            return;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    lv_test_assert_true(true, "Transformed lines");
+}
+
+static void bench(const char * name, lv_img_cf_t cf, bool rotate, bool zoom, bool aa)
+{
+    lv_img_transform_dsc_t dsc[BENCH_IMG_NUM];
+    lv_area_t area[BENCH_IMG_NUM];
+    uint32_t i;
+    rnd_seed = 0x1234;
+    for(i = 0; i < BENCH_IMG_NUM; i++) {
+        int16_t angle = rotate ? rnd_next(3600) : 0;
+        uint16_t z = zoom ? BENCH_ZOOM_MIN + rnd_next(BENCH_ZOOM_MAX - BENCH_ZOOM_MIN) : LV_IMG_ZOOM_NONE;
+        lv_point_t pivot = {IMG_W / 2, IMG_H / 2};
+        init_dsc(&dsc[i], cf, IMG_W, IMG_H, angle, z, pivot.x, pivot.y, aa);
+        _lv_img_buf_get_transformed_area(&area[i], IMG_W, IMG_H, angle, z, &pivot);
+    }
+
+    uint32_t r;
+    lv_coord_t x;
+    lv_coord_t y;
+
+    /*Transform every pixel like the drawing did before*/
+    clock_t t_ref = clock();
+    for(r = 0; r < BENCH_ROUNDS; r++) {
+        for(i = 0; i < BENCH_IMG_NUM; i++) {
+            lv_coord_t len = LV_MATH_MIN(lv_area_get_width(&area[i]), LINE_MAX);
+            for(y = area[i].y1; y <= area[i].y2; y++) {
+                for(x = 0; x < len; x++) {
+                    if(_lv_img_buf_transform(&dsc[i], area[i].x1 + x, y)) {
+                        cbuf_ref[x] = dsc[i].res.color;
+                        abuf_ref[x] = dsc[i].res.opa;
+                    }
+                    else {
+                        abuf_ref[x] = LV_OPA_TRANSP;
+                    }
+                }
+            }
+        }
+    }
+    t_ref = clock() - t_ref;
+
+    clock_t t_act = clock();
+    for(r = 0; r < BENCH_ROUNDS; r++) {
+        for(i = 0; i < BENCH_IMG_NUM; i++) {
+            lv_coord_t len = LV_MATH_MIN(lv_area_get_width(&area[i]), LINE_MAX);
+            for(y = area[i].y1; y <= area[i].y2; y++) {
+                _lv_img_buf_transform_line(&dsc[i], area[i].x1, y, len, cbuf_act, abuf_act);
+            }
+        }
+    }
+    t_act = clock() - t_act;
+
+    lv_test_print("%s (%d images, %d times): pixel-by-pixel: %d us, line: %d us", name, BENCH_IMG_NUM, BENCH_ROUNDS,
+                  (int)((int64_t)t_ref * 1000000 / CLOCKS_PER_SEC), (int)((int64_t)t_act * 1000000 / CLOCKS_PER_SEC));
+}
+
+static uint32_t rnd_next(uint32_t max)
+{
+    rnd_seed = rnd_seed * 1103515245 + 12345;
+    return (rnd_seed >> 8) % max;
+}
+
+#else
+
+void lv_test_img_transform(void)
+{
+}
+
+#endif /*LV_USE_IMG_TRANSFORM*/
+#endif /*LV_BUILD_TEST*/
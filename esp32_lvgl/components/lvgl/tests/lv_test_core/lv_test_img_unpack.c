@@ -0,0 +1,358 @@
+/**
+ * @file lv_test_img_unpack.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../lvgl.h"
+#if LV_BUILD_TEST
+#include "../lv_test_assert.h"
+
+#include "lv_test_img_unpack.h"
+
+#if LV_USE_IMG && LV_IMG_CF_INDEXED && LV_IMG_CF_ALPHA
+#include <time.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TEST_W          37
+#define TEST_H          3
+#define BENCH_W         100
+#define BENCH_H         100
+#define BENCH_IMG_NUM   LV_MATH_MAX((LV_HOR_RES_MAX * LV_VER_RES_MAX) / 5 / BENCH_W / BENCH_H, 1)
+#define BENCH_ROUNDS    20
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    lv_color_t palette[256];
+    lv_opa_t opa[256];
+} ref_data_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void test_identical(lv_img_cf_t cf);
+static void bench(lv_img_cf_t cf, lv_opa_t opa);
+static uint32_t rnd_next(void);
+static void fill_img(lv_img_dsc_t * img, uint8_t * data, lv_img_cf_t cf, lv_coord_t w, lv_coord_t h);
+static lv_res_t ref_decoder_info(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header);
+static lv_res_t ref_decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
+static lv_res_t ref_decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x,
+                                      lv_coord_t y, lv_coord_t len, uint8_t * buf);
+static void ref_decoder_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+extern lv_color_t test_fb[];    /*Defined in lv_test_main.c*/
+static lv_color_t fb_ref[LV_HOR_RES_MAX * LV_VER_RES_MAX];
+
+static uint8_t img_data[LV_IMG_BUF_SIZE_INDEXED_8BIT(BENCH_W, BENCH_H)];
+static lv_img_dsc_t img;
+static lv_img_dsc_t ref_img;    /*Decoded by the reference decoder*/
+static uint8_t buf_ref[TEST_W * LV_IMG_PX_SIZE_ALPHA_BYTE];
+static uint8_t buf_act[TEST_W * LV_IMG_PX_SIZE_ALPHA_BYTE];
+static uint32_t rnd_seed;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_img_unpack(void)
+{
+    lv_test_print("");
+    lv_test_print("===================");
+    lv_test_print("Start lv_img_unpack tests");
+    lv_test_print("===================");
+
+    lv_img_decoder_t * dec = lv_img_decoder_create();
+    lv_img_decoder_set_info_cb(dec, ref_decoder_info);
+    lv_img_decoder_set_open_cb(dec, ref_decoder_open);
+    lv_img_decoder_set_read_line_cb(dec, ref_decoder_read_line);
+    lv_img_decoder_set_close_cb(dec, ref_decoder_close);
+
+    lv_img_cf_t cf;
+    for(cf = LV_IMG_CF_INDEXED_1BIT; cf <= LV_IMG_CF_ALPHA_8BIT; cf++) {
+        test_identical(cf);
+    }
+
+    /*As `img_index_cb` and `img_alpha_cb` of the benchmark demo*/
+    bench(LV_IMG_CF_INDEXED_4BIT, LV_OPA_COVER);
+    bench(LV_IMG_CF_INDEXED_4BIT, LV_OPA_50);
+    bench(LV_IMG_CF_ALPHA_4BIT, LV_OPA_COVER);
+    bench(LV_IMG_CF_ALPHA_4BIT, LV_OPA_50);
+
+    lv_img_decoder_delete(dec);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_identical(lv_img_cf_t cf)
+{
+    lv_test_print("Decode lines of color format %d", cf);
+
+    lv_img_decoder_dsc_t dsc_ref;
+    lv_img_decoder_dsc_t dsc_act;
+    lv_color_t color = LV_COLOR_MAKE(0x12, 0x34, 0x56);
+
+    fill_img(&img, img_data, cf, TEST_W, TEST_H);
+    ref_img = img;
+    lv_test_assert_int_eq(LV_RES_OK, lv_img_decoder_open(&dsc_ref, &ref_img, color), "Open with the reference decoder");
+    lv_test_assert_int_eq(LV_RES_OK, lv_img_decoder_open(&dsc_act, &img, color), "Open with the built-in decoder");
+
+    lv_coord_t x;
+    lv_coord_t y;
+    lv_coord_t len;
+    bool ok = true;
+    for(y = 0; y < TEST_H && ok; y++) {
+        for(x = 0; x < TEST_W && ok; x++) {
+            for(len = 1; x + len <= TEST_W && ok; len++) {
+                /*Check that nothing is written after the pixels*/
+                _lv_memset(buf_act, 0xAA, sizeof(buf_act));
+                lv_img_decoder_read_line(&dsc_ref, x, y, len, buf_ref);
+                lv_img_decoder_read_line(&dsc_act, x, y, len, buf_act);
+                uint32_t size = len * LV_IMG_PX_SIZE_ALPHA_BYTE;
+                if(memcmp(buf_ref, buf_act, size) != 0) ok = false;
+                if(size < sizeof(buf_act) && buf_act[size] != 0xAA) ok = false;
+            }
+        }
+    }
+    lv_test_assert_true(ok, "Same pixels from any position");
+
+    lv_img_decoder_close(&dsc_ref);
+    lv_img_decoder_close(&dsc_act);
+}
+
+static void bench(lv_img_cf_t cf, lv_opa_t opa)
+{
+    uint32_t fb_size = LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t);
+    lv_obj_t * objs[BENCH_IMG_NUM];
+    uint32_t i;
+    uint32_t r;
+
+    fill_img(&img, img_data, cf, BENCH_W, BENCH_H);
+    ref_img = img;
+
+    rnd_seed = 1;
+    for(i = 0; i < BENCH_IMG_NUM; i++) {
+        objs[i] = lv_img_create(lv_scr_act(), NULL);
+        lv_obj_set_style_local_image_opa(objs[i], LV_IMG_PART_MAIN, LV_STATE_DEFAULT, opa);
+        lv_obj_set_style_local_image_recolor(objs[i], LV_IMG_PART_MAIN, LV_STATE_DEFAULT,
+                                             lv_color_hex(rnd_next() % 0xFFFFF0));
+        lv_obj_set_pos(objs[i], rnd_next() % LV_HOR_RES, rnd_next() % LV_VER_RES);
+    }
+
+    clock_t t[2];
+    uint32_t k;
+    for(k = 0; k < 2; k++) {
+        for(i = 0; i < BENCH_IMG_NUM; i++) lv_img_set_src(objs[i], k == 0 ? &ref_img : &img);
+        t[k] = clock();
+        for(r = 0; r < BENCH_ROUNDS; r++) {
+            for(i = 0; i < BENCH_IMG_NUM; i++) lv_obj_invalidate(objs[i]);
+            lv_refr_now(NULL);
+        }
+        t[k] = clock() - t[k];
+
+        lv_obj_invalidate(lv_scr_act());
+        lv_refr_now(NULL);
+        if(k == 0) memcpy(fb_ref, test_fb, fb_size);
+    }
+
+    lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, "Same images drawn");
+
+    for(i = 0; i < BENCH_IMG_NUM; i++) lv_obj_del(objs[i]);
+    lv_img_cache_invalidate_src(&img);
+    lv_img_cache_invalidate_src(&ref_img);
+
+    lv_test_print("Draw %d %s images with opa %d %d times: pixel-by-pixel: %d us, word-by-word: %d us",
+                  BENCH_IMG_NUM, cf == LV_IMG_CF_INDEXED_4BIT ? "indexed" : "alpha", opa, BENCH_ROUNDS,
+                  (int)((int64_t)t[0] * 1000000 / CLOCKS_PER_SEC), (int)((int64_t)t[1] * 1000000 / CLOCKS_PER_SEC));
+
+    /*Only the decoding*/
+    if(opa != LV_OPA_COVER) return;
+
+    lv_img_decoder_dsc_t dsc[2];
+    lv_test_assert_int_eq(LV_RES_OK, lv_img_decoder_open(&dsc[0], &ref_img, LV_COLOR_RED), "Open with the reference decoder");
+    lv_test_assert_int_eq(LV_RES_OK, lv_img_decoder_open(&dsc[1], &img, LV_COLOR_RED), "Open with the built-in decoder");
+    uint8_t * buf = lv_mem_alloc(BENCH_W * LV_IMG_PX_SIZE_ALPHA_BYTE);
+    lv_test_assert_true(buf != NULL, "Line buffer allocated");
+    if(buf == NULL) return;
+
+    for(k = 0; k < 2; k++) {
+        t[k] = clock();
+        for(r = 0; r < BENCH_ROUNDS * 10; r++) {
+            lv_coord_t y;
+            for(y = 0; y < BENCH_H; y++) lv_img_decoder_read_line(&dsc[k], 0, y, BENCH_W, buf);
+        }
+        t[k] = clock() - t[k];
+        lv_img_decoder_close(&dsc[k]);
+    }
+    lv_mem_free(buf);
+
+    lv_test_print("Decode a %s image %d times: pixel-by-pixel: %d us, word-by-word: %d us",
+                  cf == LV_IMG_CF_INDEXED_4BIT ? "indexed" : "alpha", BENCH_ROUNDS * 10,
+                  (int)((int64_t)t[0] * 1000000 / CLOCKS_PER_SEC), (int)((int64_t)t[1] * 1000000 / CLOCKS_PER_SEC));
+}
+
+static uint32_t rnd_next(void)
+{
+    rnd_seed = rnd_seed * 1103515245 + 12345;
+    return rnd_seed >> 8;
+}
+
+static void fill_img(lv_img_dsc_t * dsc, uint8_t * data, lv_img_cf_t cf, lv_coord_t w, lv_coord_t h)
+{
+    uint32_t palette_size = 0;
+    if(cf >= LV_IMG_CF_INDEXED_1BIT && cf <= LV_IMG_CF_INDEXED_8BIT) palette_size = 1 << lv_img_cf_get_px_size(cf);
+
+    uint32_t size = lv_img_buf_get_img_size(w, h, cf);
+    uint32_t i;
+    rnd_seed = cf;
+    for(i = 0; i < size; i++) {
+        data[i] = rnd_next();
+    }
+
+    /*Some fully transparent and opaque colors in the palette*/
+    lv_color32_t * palette = (lv_color32_t *)data;
+    for(i = 0; i < palette_size; i++) {
+        if(i % 3 == 0) palette[i].ch.alpha = LV_OPA_COVER;
+        else if(i % 3 == 1) palette[i].ch.alpha = LV_OPA_TRANSP;
+    }
+
+    dsc->header.always_zero = 0;
+    dsc->header.cf = cf;
+    dsc->header.w = w;
+    dsc->header.h = h;
+    dsc->data_size = size;
+    dsc->data = data;
+}
+
+/*The former pixel-by-pixel alpha and indexed decoder as reference*/
+static lv_res_t ref_decoder_info(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header)
+{
+    LV_UNUSED(decoder);
+    if(src != &ref_img) return LV_RES_INV;
+
+    *header = ref_img.header;
+    return LV_RES_OK;
+}
+
+static lv_res_t ref_decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(decoder);
+    lv_img_cf_t cf = dsc->header.cf;
+    if(cf < LV_IMG_CF_INDEXED_1BIT || cf > LV_IMG_CF_INDEXED_8BIT) return LV_RES_OK;
+
+    ref_data_t * user_data = lv_mem_alloc(sizeof(ref_data_t));
+    if(user_data == NULL) return LV_RES_INV;
+
+    lv_color32_t * palette_p = (lv_color32_t *)ref_img.data;
+    uint32_t i;
+    for(i = 0; i < (1U << lv_img_cf_get_px_size(cf)); i++) {
+        user_data->palette[i] = lv_color_make(palette_p[i].ch.red, palette_p[i].ch.green, palette_p[i].ch.blue);
+        user_data->opa[i]     = palette_p[i].ch.alpha;
+    }
+    dsc->user_data = user_data;
+    return LV_RES_OK;
+}
+
+static lv_res_t ref_decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x,
+                                      lv_coord_t y, lv_coord_t len, uint8_t * buf)
+{
+    LV_UNUSED(decoder);
+    const lv_opa_t alpha1_opa_table[2]  = {0, 255};
+    const lv_opa_t alpha2_opa_table[4]  = {0, 85, 170, 255};
+    const lv_opa_t alpha4_opa_table[16] = {0, 17, 34, 51, 68, 85, 102, 119, 136, 153, 170, 187, 204, 221, 238, 255};
+
+    ref_data_t * user_data = dsc->user_data;
+    const lv_opa_t * opa_table = NULL;
+    uint8_t px_size = lv_img_cf_get_px_size(dsc->header.cf);
+    uint16_t mask   = (1 << px_size) - 1;
+    bool indexed = user_data != NULL;
+
+    lv_coord_t w = 0;
+    int8_t pos   = 0;
+    uint32_t ofs = 0;
+    switch(px_size) {
+        case 1:
+            w = (dsc->header.w + 7) >> 3;
+            ofs += w * y + (x >> 3);
+            pos = 7 - (x & 0x7);
+            opa_table = alpha1_opa_table;
+            break;
+        case 2:
+            w = (dsc->header.w + 3) >> 2;
+            ofs += w * y + (x >> 2);
+            pos = 6 - (x & 0x3) * 2;
+            opa_table = alpha2_opa_table;
+            break;
+        case 4:
+            w = (dsc->header.w + 1) >> 1;
+            ofs += w * y + (x >> 1);
+            pos = 4 - (x & 0x1) * 4;
+            opa_table = alpha4_opa_table;
+            break;
+        case 8:
+            w = dsc->header.w;
+            ofs += w * y + x;
+            pos = 0;
+            break;
+    }
+    if(indexed) ofs += (1 << px_size) * sizeof(lv_color32_t); /*Skip the palette*/
+
+    const uint8_t * data_tmp = ref_img.data + ofs;
+    lv_coord_t i;
+    for(i = 0; i < len; i++) {
+        uint8_t val_act = (*data_tmp >> pos) & mask;
+
+        lv_color_t color = indexed ? user_data->palette[val_act] : dsc->color;
+#if LV_COLOR_DEPTH == 8 || LV_COLOR_DEPTH == 1
+        buf[i * LV_IMG_PX_SIZE_ALPHA_BYTE] = color.full;
+#elif LV_COLOR_DEPTH == 16
+        buf[i * LV_IMG_PX_SIZE_ALPHA_BYTE] = color.full & 0xFF;
+        buf[i * LV_IMG_PX_SIZE_ALPHA_BYTE + 1] = (color.full >> 8) & 0xFF;
+#elif LV_COLOR_DEPTH == 32
+        *((uint32_t *)&buf[i * LV_IMG_PX_SIZE_ALPHA_BYTE]) = color.full;
+#endif
+        lv_opa_t opa;
+        if(indexed) opa = user_data->opa[val_act];
+        else opa = px_size == 8 ? val_act : opa_table[val_act];
+        buf[i * LV_IMG_PX_SIZE_ALPHA_BYTE + LV_IMG_PX_SIZE_ALPHA_BYTE - 1] = opa;
+
+        pos -= px_size;
+        if(pos < 0) {
+            pos = 8 - px_size;
+            data_tmp++;
+        }
+    }
+
+    return LV_RES_OK;
+}
+
+static void ref_decoder_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(decoder);
+    if(dsc->user_data) lv_mem_free(dsc->user_data);
+    dsc->user_data = NULL;
+}
+
+#else
+
+void lv_test_img_unpack(void)
+{
+}
+
+#endif /*LV_USE_IMG && LV_IMG_CF_INDEXED && LV_IMG_CF_ALPHA*/
+#endif /*LV_BUILD_TEST*/
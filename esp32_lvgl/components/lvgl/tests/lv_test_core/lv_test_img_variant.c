@@ -0,0 +1,365 @@
+/**
+ * @file lv_test_img_variant.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../lvgl.h"
+#if LV_BUILD_TEST
+#include "../lv_test_assert.h"
+
+#include "lv_test_img_variant.h"
+
+#if LV_USE_IMG_TRANSFORM && LV_IMG_CACHE_DEF_SIZE && LV_MEM_CUSTOM
+#include <time.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define IMG_W           100
+#define IMG_H           100
+#define BENCH_IMG_NUM   LV_MATH_MAX((LV_HOR_RES_MAX * LV_VER_RES_MAX) / 5 / IMG_W / IMG_H, 1)
+#define BENCH_ROUNDS    10
+#define BENCH_ZOOM_MIN  128
+#define BENCH_ZOOM_MAX  (256 + 64)
+#define VARIANT_MEM     (1024 * 1024)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void fill_images(void);
+static void refresh(void);
+static lv_obj_t * create_img(const lv_img_dsc_t * src, lv_coord_t x, lv_coord_t y, int16_t angle, uint16_t zoom,
+                             bool aa);
+static void create_imgs(void);
+static void test_same(void);
+static void test_budget(void);
+static void test_animated(void);
+static void test_canvas(void);
+static void bench(bool aa);
+static uint32_t rnd_next(uint32_t max);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+extern lv_color_t test_fb[];    /*Defined in lv_test_main.c*/
+static lv_color_t fb_ref[LV_HOR_RES_MAX * LV_VER_RES_MAX];
+
+static lv_color_t rgb_data[IMG_W * IMG_H];
+static uint8_t argb_data[IMG_W * IMG_H * LV_IMG_PX_SIZE_ALPHA_BYTE];
+static lv_color_t canvas_buf[LV_CANVAS_BUF_SIZE_TRUE_COLOR_ALPHA(IMG_W, IMG_H) / sizeof(lv_color_t) + 1];
+static lv_img_dsc_t rgb_img;
+static lv_img_dsc_t argb_img;
+static uint32_t rnd_seed;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_img_variant(void)
+{
+    lv_test_print("");
+    lv_test_print("===================");
+    lv_test_print("Start lv_img_variant tests");
+    lv_test_print("===================");
+
+    fill_images();
+
+    test_same();
+    test_budget();
+    test_animated();
+    test_canvas();
+
+    /*The same cases as in the benchmark demo but the images are not animated*/
+    bench(false);
+    bench(true);
+
+    lv_img_cache_invalidate_src(NULL);
+    lv_img_cache_set_variant_mem_size(LV_IMG_CACHE_VARIANT_MEM_SIZE);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/*A colorful disc with holes and an anti-aliased edge*/
+static void fill_images(void)
+{
+    lv_coord_t x;
+    lv_coord_t y;
+    for(y = 0; y < IMG_H; y++) {
+        for(x = 0; x < IMG_W; x++) {
+            int32_t dx = x - IMG_W / 2;
+            int32_t dy = y - IMG_H / 2;
+            int32_t r2 = dx * dx + dy * dy;
+            lv_color_t c = lv_color_make(x * 2, y * 2, ((x ^ y) * 4) & 0xFF);
+            lv_opa_t opa;
+            if(r2 > 48 * 48) opa = LV_OPA_TRANSP;
+            else if(r2 > 44 * 44) opa = 255 - (r2 - 44 * 44) * 255 / (48 * 48 - 44 * 44);
+            else if(r2 < 10 * 10) opa = LV_OPA_TRANSP;
+            else opa = ((x / 8 + y / 8) & 0x3) == 0 ? LV_OPA_50 : LV_OPA_COVER;
+
+            uint32_t i = y * IMG_W + x;
+            rgb_data[i] = c;
+            _lv_memcpy_small(&argb_data[i * LV_IMG_PX_SIZE_ALPHA_BYTE], &c, LV_IMG_PX_SIZE_ALPHA_BYTE - 1);
+            argb_data[i * LV_IMG_PX_SIZE_ALPHA_BYTE + LV_IMG_PX_SIZE_ALPHA_BYTE - 1] = opa;
+        }
+    }
+
+    rgb_img.header.always_zero = 0;
+    rgb_img.header.cf = LV_IMG_CF_TRUE_COLOR;
+    rgb_img.header.w = IMG_W;
+    rgb_img.header.h = IMG_H;
+    rgb_img.data_size = sizeof(rgb_data);
+    rgb_img.data = (const uint8_t *)rgb_data;
+
+    argb_img.header.always_zero = 0;
+    argb_img.header.cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+    argb_img.header.w = IMG_W;
+    argb_img.header.h = IMG_H;
+    argb_img.data_size = sizeof(argb_data);
+    argb_img.data = argb_data;
+}
+
+static void refresh(void)
+{
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+}
+
+static lv_obj_t * create_img(const lv_img_dsc_t * src, lv_coord_t x, lv_coord_t y, int16_t angle, uint16_t zoom,
+                             bool aa)
+{
+    lv_obj_t * img = lv_img_create(lv_scr_act(), NULL);
+    lv_img_set_src(img, src);
+    lv_obj_set_pos(img, x, y);
+    lv_img_set_angle(img, angle);
+    lv_img_set_zoom(img, zoom);
+    lv_img_set_antialias(img, aa);
+    return img;
+}
+
+static void create_imgs(void)
+{
+    create_img(&argb_img, 20, 20, 300, LV_IMG_ZOOM_NONE, true);
+    create_img(&argb_img, 180, 30, 1200, 300, false);
+    create_img(&argb_img, 360, -40, 2700, 200, true);
+    lv_obj_t * img = create_img(&rgb_img, 30, 200, 450, 200, true);
+    lv_obj_set_style_local_image_recolor(img, LV_IMG_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_RED);
+    lv_obj_set_style_local_image_recolor_opa(img, LV_IMG_PART_MAIN, LV_STATE_DEFAULT, LV_OPA_40);
+    create_img(&rgb_img, 200, 220, 0, 128, false);
+    img = create_img(&argb_img, 330, 250, 3300, 256 + 64, true);
+    lv_img_set_pivot(img, 0, 0);
+    lv_obj_set_style_local_image_opa(img, LV_IMG_PART_MAIN, LV_STATE_DEFAULT, LV_OPA_60);
+}
+
+static void test_same(void)
+{
+    lv_test_print("Draw transformed images from the cache like directly");
+
+    uint32_t fb_size = LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t);
+    lv_img_cache_invalidate_src(NULL);
+    create_imgs();
+
+    lv_img_cache_set_variant_mem_size(0);
+    refresh();
+    memcpy(fb_ref, test_fb, fb_size);
+
+    lv_img_cache_set_variant_mem_size(VARIANT_MEM);
+    lv_img_cache_reset_stats();
+    refresh();
+    lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, "Same image while caching the variants");
+
+    refresh();
+    lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, "Same image from the cached variants");
+
+    lv_img_cache_stats_t stats;
+    lv_img_cache_get_stats(&stats);
+    lv_test_assert_int_eq(6, stats.variant_miss_cnt, "A variant is created for every image");
+    lv_test_assert_int_eq(6, stats.variant_hit_cnt, "The variants are used in the next refresh");
+    lv_test_assert_true(stats.variant_mem_used > 0 && stats.variant_mem_used <= VARIANT_MEM, "Variant memory is used");
+
+    lv_obj_clean(lv_scr_act());
+}
+
+static void test_budget(void)
+{
+    lv_test_print("Keep the variants in the memory budget");
+
+    uint32_t fb_size = LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t);
+    lv_img_cache_invalidate_src(NULL);
+    create_imgs();
+
+    lv_img_cache_set_variant_mem_size(0);
+    refresh();
+    memcpy(fb_ref, test_fb, fb_size);
+
+    /*Not all of them fit*/
+    uint32_t budget = 100 * 1024;
+    lv_img_cache_set_variant_mem_size(budget);
+    refresh();
+    refresh();
+    lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, "Same image with a small budget");
+
+    lv_img_cache_stats_t stats;
+    lv_img_cache_get_stats(&stats);
+    lv_test_assert_true(stats.variant_mem_used > 0 && stats.variant_mem_used <= budget, "Variants fit into the budget");
+
+    lv_img_cache_set_variant_mem_size(budget / 4);
+    lv_img_cache_get_stats(&stats);
+    lv_test_assert_true(stats.variant_mem_used <= budget / 4, "Variants are freed when the budget is reduced");
+
+    lv_img_cache_invalidate_src(NULL);
+    lv_img_cache_get_stats(&stats);
+    lv_test_assert_int_eq(0, stats.variant_mem_used, "Variants are freed with the image");
+
+    lv_obj_clean(lv_scr_act());
+}
+
+static void test_animated(void)
+{
+    lv_test_print("Don't cache animated images");
+
+    lv_img_cache_invalidate_src(NULL);
+    lv_img_cache_set_variant_mem_size(VARIANT_MEM);
+    lv_obj_t * img = create_img(&argb_img, 100, 100, 0, LV_IMG_ZOOM_NONE, true);
+
+    lv_img_cache_stats_t stats;
+    uint32_t mem_used = 0;
+    uint32_t i;
+    for(i = 0; i < LV_IMG_CACHE_VARIANT_MAX_KEYS * 3; i++) {
+        lv_img_set_angle(img, 10 + i * 10);
+        refresh();
+        if(i == LV_IMG_CACHE_VARIANT_MAX_KEYS - 1) {
+            lv_img_cache_get_stats(&stats);
+            mem_used = stats.variant_mem_used;
+        }
+    }
+
+    lv_img_cache_get_stats(&stats);
+    lv_test_assert_true(mem_used > 0, "The first angles are cached");
+    lv_test_assert_int_eq(mem_used, stats.variant_mem_used, "No more variants are created for an animated image");
+
+    /*Going back to a cached angle means it's not animated but the cache is not ruined by the bypass*/
+    uint32_t hit_cnt = stats.variant_hit_cnt;
+    lv_img_set_angle(img, 10);
+    refresh();
+    lv_img_cache_get_stats(&stats);
+    lv_test_assert_int_eq(hit_cnt + 1, stats.variant_hit_cnt, "An older variant is used again");
+
+    lv_obj_del(img);
+}
+
+static void test_canvas(void)
+{
+    lv_test_print("Invalidate the variants of a changed canvas");
+
+    uint32_t fb_size = LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t);
+    lv_img_cache_invalidate_src(NULL);
+
+    lv_obj_t * canvas = lv_canvas_create(lv_scr_act(), NULL);
+    lv_canvas_set_buffer(canvas, canvas_buf, IMG_W, IMG_H, LV_IMG_CF_TRUE_COLOR_ALPHA);
+    lv_obj_set_pos(canvas, 50, 50);
+    lv_img_set_angle(canvas, 450);
+    lv_img_set_antialias(canvas, true);
+
+    lv_img_cache_set_variant_mem_size(VARIANT_MEM);
+    lv_canvas_fill_bg(canvas, LV_COLOR_RED, LV_OPA_COVER);
+    refresh();
+    refresh();
+
+    lv_img_cache_stats_t stats;
+    lv_img_cache_get_stats(&stats);
+    lv_test_assert_int_gt(0, stats.variant_mem_used, "The rotated canvas is cached");
+    uint32_t miss_cnt = stats.miss_cnt;
+
+    lv_canvas_fill_bg(canvas, LV_COLOR_BLUE, LV_OPA_70);
+    lv_img_cache_get_stats(&stats);
+    lv_test_assert_int_eq(0, stats.variant_mem_used, "The rotated copy of the changed canvas is freed");
+    refresh();
+    memcpy(fb_ref, test_fb, fb_size);
+    lv_img_cache_get_stats(&stats);
+    lv_test_assert_int_eq(miss_cnt, stats.miss_cnt, "The canvas buffer stays in the cache");
+
+    lv_img_cache_set_variant_mem_size(0);
+    refresh();
+    lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, "The new canvas content is drawn");
+
+    lv_obj_del(canvas);
+}
+
+static void bench(bool aa)
+{
+    lv_img_cache_invalidate_src(NULL);
+
+    uint32_t i;
+    rnd_seed = 0x1234;
+    for(i = 0; i < BENCH_IMG_NUM; i++) {
+        const lv_img_dsc_t * src = i & 1 ? &rgb_img : &argb_img;
+        lv_coord_t x = rnd_next(LV_HOR_RES - IMG_W);
+        lv_coord_t y = rnd_next(LV_VER_RES - IMG_H);
+        int16_t angle = rnd_next(3600);
+        uint16_t zoom = BENCH_ZOOM_MIN + rnd_next(BENCH_ZOOM_MAX - BENCH_ZOOM_MIN);
+        lv_obj_t * img = create_img(src, x, y, angle, zoom, aa);
+        if(rnd_next(2)) {
+            lv_obj_set_style_local_image_recolor(img, LV_IMG_PART_MAIN, LV_STATE_DEFAULT,
+                                                 lv_color_make(rnd_next(256), rnd_next(256), rnd_next(256)));
+            lv_obj_set_style_local_image_recolor_opa(img, LV_IMG_PART_MAIN, LV_STATE_DEFAULT, rnd_next(LV_OPA_COVER));
+        }
+    }
+
+    uint32_t r;
+    lv_img_cache_set_variant_mem_size(0);
+    refresh();
+    clock_t t_ref = clock();
+    for(r = 0; r < BENCH_ROUNDS; r++) {
+        refresh();
+    }
+    t_ref = clock() - t_ref;
+
+    lv_img_cache_set_variant_mem_size(VARIANT_MEM);
+    refresh();
+    lv_img_cache_reset_stats();
+    clock_t t_act = clock();
+    for(r = 0; r < BENCH_ROUNDS; r++) {
+        refresh();
+    }
+    t_act = clock() - t_act;
+
+    lv_img_cache_stats_t stats;
+    lv_img_cache_get_stats(&stats);
+    lv_test_assert_int_eq(BENCH_IMG_NUM * BENCH_ROUNDS, stats.variant_hit_cnt, "Every image is drawn from the cache");
+
+    lv_test_print("Refresh %d rotated and zoomed images%s: transform while drawing: %d us, cached: %d us (%d kB)",
+                  BENCH_IMG_NUM, aa ? " anti aliased" : "",
+                  (int)((int64_t)t_ref * 1000000 / CLOCKS_PER_SEC / BENCH_ROUNDS),
+                  (int)((int64_t)t_act * 1000000 / CLOCKS_PER_SEC / BENCH_ROUNDS), stats.variant_mem_used / 1024);
+
+    lv_obj_clean(lv_scr_act());
+}
+
+static uint32_t rnd_next(uint32_t max)
+{
+    rnd_seed = rnd_seed * 1103515245 + 12345;
+    return (rnd_seed >> 8) % max;
+}
+
+#else
+
+void lv_test_img_variant(void)
+{
+}
+
+#endif /*LV_USE_IMG_TRANSFORM && LV_IMG_CACHE_DEF_SIZE && LV_MEM_CUSTOM*/
+#endif /*LV_BUILD_TEST*/
@@ -0,0 +1,38 @@
+/**
+ * @file lv_test_img_variant.h
+ *
+ */
+
+#ifndef LV_TEST_IMG_VARIANT_H
+#define LV_TEST_IMG_VARIANT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void lv_test_img_variant(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_TEST_IMG_VARIANT_H*/
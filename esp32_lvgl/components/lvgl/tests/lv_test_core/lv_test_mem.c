@@ -0,0 +1,534 @@
+/**
+ * @file lv_test_mem.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../lvgl.h"
+#if LV_BUILD_TEST
+#include "../lv_test_assert.h"
+
+#include "lv_test_mem.h"
+#include <time.h>
+#include <string.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define CHURN_OPS       200000
+#define BATCH_OPS       1000
+#define SMALL_MAX       64
+#if LV_MEM_CUSTOM
+#  define SLOT_MAX      256
+#  define LARGE_MAX     1024
+#else
+#  define SLOT_MAX      128
+#  define LARGE_MAX     (LV_MEM_SIZE / 32)
+#endif
+
+#define SCR_CYCLES      10000
+#if LV_MEM_CUSTOM || LV_MEM_SIZE >= 16 * 1024
+#  define SCR_LABEL_CNT 10
+#else
+#  define SCR_LABEL_CNT 3       /*Fit into the small heap*/
+#endif
+
+#define USE_SLAB        (LV_MEM_SLAB_SIZE && LV_ENABLE_GC == 0)
+
+#define USE_TRACE       (LV_MEM_TRACE && LV_ENABLE_GC == 0)
+#define TRACE_TAG_MAX   8
+
+#define RENDER_FRAMES   20
+#if LV_MEM_CUSTOM || LV_MEM_SIZE >= 16 * 1024
+#  define RENDER_OBJ_CNT 20
+#else
+#  define RENDER_OBJ_CNT 4      /*Fit into the small heap*/
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void realloc_test(void);
+static void churn_bench(void);
+static void slab_test(void);
+static void screen_bench(void);
+static void arena_test(void);
+static void render_bench(void);
+static void trace_test(void);
+#if USE_TRACE
+static void screen_cycle(void);
+#endif
+#if USE_SLAB
+static uint32_t slab_used_cnt(void);
+static uint32_t slab_page_cnt(void);
+static int32_t slab_class_of_alloc(uint32_t size, uint8_t ** p);
+#endif
+static uint32_t rnd(void);
+static uint32_t rnd_size(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static uint8_t * slots[SLOT_MAX];
+static uint32_t sizes[SLOT_MAX];
+static uint32_t seed;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_mem(void)
+{
+    lv_test_print("");
+    lv_test_print("===================");
+    lv_test_print("Start lv_mem tests");
+    lv_test_print("===================");
+
+    realloc_test();
+    churn_bench();
+    slab_test();
+    screen_bench();
+    render_bench();
+    arena_test();
+    trace_test();
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void realloc_test(void)
+{
+    uint8_t * p = lv_mem_alloc(100);
+    lv_test_assert_true(p != NULL, "Allocate");
+    uint32_t i;
+    for(i = 0; i < 100; i++) p[i] = i;
+    bool kept;
+
+    p = lv_mem_realloc(p, 40);
+    lv_test_assert_true(p != NULL, "Shrink");
+    lv_test_assert_int_eq(40, _lv_mem_get_size(p), "Size after shrink");
+    kept = true;
+    for(i = 0; i < 40; i++) if(p[i] != i) kept = false;
+    lv_test_assert_true(kept, "Data is kept after shrink");
+
+    p = lv_mem_realloc(p, 200);
+    lv_test_assert_true(p != NULL, "Enlarge");
+    lv_test_assert_int_eq(200, _lv_mem_get_size(p), "Size after enlarge");
+    kept = true;
+    for(i = 0; i < 40; i++) if(p[i] != i) kept = false;
+    lv_test_assert_true(kept, "Data is kept after enlarge");
+
+    lv_mem_free(p);
+    lv_test_assert_int_eq(LV_RES_OK, lv_mem_test(), "Heap is consistent after realloc");
+
+#if LV_MEM_CUSTOM == 0
+    /*Bigger than any size class of the heap*/
+    lv_test_assert_true(lv_mem_alloc(LV_MEM_SIZE * 4) == NULL, "Too big allocation fails");
+    lv_test_assert_int_eq(LV_RES_OK, lv_mem_test(), "Heap is consistent after too big allocation");
+#endif
+}
+
+/**
+ * Allocate and free random sized memories for a long time and measure the speed of the allocator
+ * and the fragmentation of the heap
+ */
+static void churn_bench(void)
+{
+#if LV_MEM_CUSTOM == 0
+    /*Use about 1/4 of the free memory on average*/
+    uint32_t avg_size = (7 * (SMALL_MAX + 4) / 2 + (SMALL_MAX + LARGE_MAX) / 2) / 8 + 8;
+    lv_mem_defrag();
+    lv_mem_monitor_t mon_start;
+    lv_mem_monitor(&mon_start);
+    uint32_t slot_cnt = LV_MATH_MIN(SLOT_MAX, mon_start.free_size / 4 / avg_size);
+#else
+    uint32_t slot_cnt = SLOT_MAX;
+#endif
+
+    seed = 1;
+    _lv_memset_00(slots, sizeof(slots));
+    uint32_t fail_cnt = 0;
+    uint32_t corrupt_cnt = 0;
+    uint32_t worst_batch = 0;
+    clock_t t_start = clock();
+    uint32_t op;
+    for(op = 0; op < CHURN_OPS; op += BATCH_OPS) {
+        clock_t t = clock();
+        uint32_t i;
+        for(i = 0; i < BATCH_OPS; i++) {
+            uint32_t s = rnd() % slot_cnt;
+            if(slots[s]) {
+                uint8_t tag = s ^ sizes[s];
+                if(slots[s][0] != tag || slots[s][sizes[s] - 1] != tag) corrupt_cnt++;
+                lv_mem_free(slots[s]);
+                slots[s] = NULL;
+            }
+            else {
+                sizes[s] = rnd_size();
+                slots[s] = lv_mem_alloc(sizes[s]);
+                if(slots[s] == NULL) {
+                    fail_cnt++;
+                    continue;
+                }
+                uint8_t tag = s ^ sizes[s];
+                slots[s][0] = tag;
+                slots[s][sizes[s] - 1] = tag;
+            }
+        }
+        uint32_t batch = (clock() - t) * 1000000 / CLOCKS_PER_SEC;
+        if(batch > worst_batch) worst_batch = batch;
+    }
+    uint32_t sum_time = (clock() - t_start) * 1000000 / CLOCKS_PER_SEC;
+
+    lv_test_print("%d allocations and frees in %d slots: %d ns avg, worst %d ns avg in %d ops, %d failed",
+                  CHURN_OPS, slot_cnt, sum_time / (CHURN_OPS / 1000),
+                  worst_batch * 1000 / BATCH_OPS, BATCH_OPS, fail_cnt);
+    lv_test_assert_int_eq(0, corrupt_cnt, "Allocated memories are not overwritten");
+    lv_test_assert_int_eq(LV_RES_OK, lv_mem_test(), "Heap is consistent after the churn");
+
+#if LV_MEM_CUSTOM == 0
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    lv_test_print("Heap after the churn: %d free entries, biggest %d of %d free bytes, %d bytes in small entries, "
+                  "%d%% fragmentation, %d bytes of headers", mon.free_cnt, mon.free_biggest_size, mon.free_size,
+                  mon.free_small_size, mon.frag_pct, mon.header_size);
+#endif
+
+    uint32_t s;
+    for(s = 0; s < slot_cnt; s++) {
+        lv_mem_free(slots[s]);
+        slots[s] = NULL;
+    }
+
+#if LV_MEM_CUSTOM == 0
+    lv_mem_defrag();
+    lv_mem_monitor(&mon);
+    lv_test_assert_int_gt(mon_start.free_size - 1, mon.free_size, "All the memory is freed");
+    lv_test_assert_int_gt(mon_start.free_biggest_size - 1, mon.free_biggest_size, "The free memory is joined");
+#endif
+}
+
+static void slab_test(void)
+{
+#if USE_SLAB
+    uint32_t used_cnt = slab_used_cnt();
+    uint8_t * p1 = lv_mem_alloc(24);
+    lv_test_assert_int_eq(used_cnt + 1, slab_used_cnt(), "Small memory is allocated in a slab");
+    lv_test_assert_int_eq(24, _lv_mem_get_size(p1), "Size of a slab block");
+
+    lv_mem_free(p1);
+    lv_test_assert_int_eq(used_cnt, slab_used_cnt(), "Slab block is freed");
+    uint8_t * p2 = lv_mem_alloc(20);
+    lv_test_assert_true(p1 == p2, "Freed block is reused by the same size class");
+
+    p2 = lv_mem_realloc(p2, 16);
+    lv_test_assert_true(p1 == p2, "Shrinking keeps the slab block");
+    lv_test_assert_int_eq(16, _lv_mem_get_size(p2), "Size of a shrunk slab block");
+
+    p2 = lv_mem_realloc(p2, 400);
+    lv_test_assert_int_eq(used_cnt, slab_used_cnt(), "Large memory is allocated in the heap");
+    lv_mem_free(p2);
+
+    /*A class is added only once*/
+    lv_mem_slab_monitor_t mon;
+    _lv_mem_slab_add(100);
+    lv_mem_slab_monitor(&mon);
+    uint32_t class_cnt = mon.class_cnt;
+    _lv_mem_slab_add(100);
+    lv_mem_slab_monitor(&mon);
+    lv_test_assert_int_eq(class_cnt, mon.class_cnt, "Class is added only once");
+    lv_test_assert_int_eq(0, mon.refused_cnt, "No class is refused");
+
+    /*The class of an `ext_attr` is added when it's allocated*/
+    lv_obj_t * obj = lv_obj_create(lv_scr_act(), NULL);
+    lv_obj_allocate_ext_attr(obj, 140);
+    lv_mem_slab_monitor(&mon);
+    lv_test_assert_int_eq(class_cnt + 1, mon.class_cnt, "Class of the ext. attributes is added");
+    lv_obj_allocate_ext_attr(obj, 140);
+    lv_mem_slab_monitor(&mon);
+    lv_test_assert_int_eq(class_cnt + 1, mon.class_cnt, "Class of the ext. attributes is added only once");
+    lv_obj_del(obj);
+
+    /*The class of a size is used for it and the smaller sizes but not for the larger sizes.
+     *The pages of the classes are kept after the churn so use small sizes which have free blocks*/
+    int32_t c24 = slab_class_of_alloc(24, &p1);
+    int32_t c21 = slab_class_of_alloc(21, &p2);
+    uint8_t * p3;
+    int32_t c25 = slab_class_of_alloc(25, &p3);
+    lv_test_assert_true(c24 >= 0 && c25 >= 0, "Memories are in slabs");
+    lv_test_assert_int_eq(c24, c21, "Smaller size uses the same class");
+    lv_test_assert_int_lt(mon.classes[c25].size, mon.classes[c24].size, "Larger size uses a larger class");
+    lv_mem_free(p1);
+    lv_mem_free(p2);
+    lv_mem_free(p3);
+#endif
+}
+
+/**
+ * Create and delete a screen with labels many times
+ */
+static void screen_bench(void)
+{
+#if USE_SLAB
+    uint32_t page_cnt = 0;
+#endif
+    clock_t t = clock();
+    uint32_t i;
+    for(i = 0; i < SCR_CYCLES; i++) {
+        lv_obj_t * scr = lv_obj_create(NULL, NULL);
+        uint32_t j;
+        for(j = 0; j < SCR_LABEL_CNT; j++) {
+            lv_obj_t * label = lv_label_create(scr, NULL);
+            lv_label_set_text_fmt(label, "Value %d: %d", j, i);
+            lv_obj_align(label, NULL, LV_ALIGN_IN_TOP_LEFT, 10, j * 20);
+        }
+        lv_obj_del(scr);
+#if USE_SLAB
+        if(i == 0) page_cnt = slab_page_cnt();
+#endif
+    }
+    uint32_t time = (clock() - t) * 1000000 / CLOCKS_PER_SEC;
+    lv_test_print("Create and delete a screen with %d labels %d times: %d us per screen", SCR_LABEL_CNT, SCR_CYCLES,
+                  time / SCR_CYCLES);
+
+#if USE_SLAB
+    lv_mem_slab_monitor_t mon;
+    lv_mem_slab_monitor(&mon);
+    lv_test_print("Slab memory: %d of %d bytes given to the size classes, %d allocations in the heap as it was full, "
+                  "%d size classes (%d refused)", mon.total_size - mon.free_size, mon.total_size, mon.fallback_cnt,
+                  mon.class_cnt, mon.refused_cnt);
+    for(i = 0; i < mon.class_cnt; i++) {
+        if(mon.classes[i].page_cnt == 0) continue;
+        lv_test_print("  %d bytes: %d pages, %d of %d blocks are used", mon.classes[i].size, mon.classes[i].page_cnt,
+                      mon.classes[i].used_cnt, mon.classes[i].block_cnt);
+    }
+    lv_test_assert_int_eq(page_cnt, slab_page_cnt(), "The blocks of the deleted screens are reused");
+#endif
+}
+
+/**
+ * Stack, mark and release temporary buffers in the arena
+ */
+static void arena_test(void)
+{
+#if LV_MEM_BUF_ARENA_SIZE
+    _lv_mem_buf_free_all();
+    uint8_t * a = _lv_mem_buf_get(100);
+    uint8_t * b = _lv_mem_buf_get(200);
+    lv_test_assert_true(a != NULL && b > a, "Temporary buffers are stacked in the arena");
+    lv_test_assert_int_gt(300 - 1, lv_mem_buf_get_max_used(), "High water mark is updated");
+
+    /*Released out of order: the arena shrinks only when the top is released*/
+    _lv_mem_buf_release(a);
+    lv_test_assert_true((uint8_t *)_lv_mem_buf_get(8) > b, "Not the top buffer is released");
+    _lv_mem_buf_release_to(0);
+    lv_test_assert_true((uint8_t *)_lv_mem_buf_get(8) == a, "Arena is empty after releasing to the start");
+    _lv_mem_buf_release_to(0);
+
+    /*The buffers after the mark are released at once*/
+    a = _lv_mem_buf_get(100);
+    uint32_t mark = _lv_mem_buf_mark();
+    b = _lv_mem_buf_get(300);
+    _lv_mem_buf_get(50);
+    _lv_mem_buf_release_to(mark);
+    lv_test_assert_true((uint8_t *)_lv_mem_buf_get(300) == b, "Buffers after the mark are released");
+    _lv_mem_buf_release_to(0);
+    lv_test_assert_int_eq(0, _lv_mem_buf_mark(), "Arena is empty");
+
+    /*Buffers are still available when the arena is full*/
+    uint32_t overflow_cnt = lv_mem_buf_get_overflow_cnt();
+    a = _lv_mem_buf_get(LV_MEM_BUF_ARENA_SIZE - 64);
+    mark = _lv_mem_buf_mark();
+    b = _lv_mem_buf_get(256);
+    lv_test_assert_true(b != NULL, "Buffer when the arena is full");
+    lv_test_assert_int_eq(mark, _lv_mem_buf_mark(), "The buffer is not in the arena");
+    lv_test_assert_int_eq(overflow_cnt + 1, lv_mem_buf_get_overflow_cnt(), "Overflow is counted");
+    lv_test_assert_true(lv_mem_buf_get_max_used() <= LV_MEM_BUF_ARENA_SIZE, "High water mark is in the arena");
+    _lv_mem_buf_release(b);
+    _lv_mem_buf_release(a);
+    lv_test_assert_int_eq(0, _lv_mem_buf_mark(), "Arena is empty");
+#endif
+}
+
+/**
+ * Redraw a screen with rounded, bordered and shadowed objects many times
+ */
+static void render_bench(void)
+{
+    static lv_style_t style;
+    lv_style_init(&style);
+    lv_style_set_radius(&style, LV_STATE_DEFAULT, 10);
+    lv_style_set_border_width(&style, LV_STATE_DEFAULT, 3);
+    lv_style_set_shadow_width(&style, LV_STATE_DEFAULT, 10);
+    lv_style_set_shadow_color(&style, LV_STATE_DEFAULT, LV_COLOR_GRAY);
+
+    lv_obj_t * scr = lv_scr_act();
+    lv_obj_clean(scr);
+    uint32_t i;
+    for(i = 0; i < RENDER_OBJ_CNT; i++) {
+        lv_obj_t * obj = lv_obj_create(scr, NULL);
+        lv_obj_add_style(obj, LV_OBJ_PART_MAIN, &style);
+        lv_obj_set_size(obj, LV_HOR_RES / 6, LV_VER_RES / 6);
+        lv_obj_set_pos(obj, (i % 5) * LV_HOR_RES / 5 + 5, (i / 5) * LV_VER_RES / 5 + 5);
+        lv_obj_t * label = lv_label_create(obj, NULL);
+        lv_label_set_text_fmt(label, "%d", i);
+    }
+
+    clock_t t = clock();
+    for(i = 0; i < RENDER_FRAMES; i++) {
+        lv_obj_invalidate(scr);
+        lv_refr_now(NULL);
+    }
+    uint32_t time = (clock() - t) * 1000000 / CLOCKS_PER_SEC;
+    lv_test_print("Redraw a screen with %d objects %d times: %d us per frame, %d bytes of the arena are used at most, "
+                  "%d buffers didn't fit", RENDER_OBJ_CNT, RENDER_FRAMES, time / RENDER_FRAMES, lv_mem_buf_get_max_used(),
+                  lv_mem_buf_get_overflow_cnt());
+    lv_test_assert_int_eq(0, _lv_mem_buf_mark(), "Arena is empty after the redraw");
+
+    lv_obj_clean(scr);
+    lv_style_reset(&style);
+}
+
+/**
+ * Find leaks with the allocation tracing
+ */
+static void trace_test(void)
+{
+#if USE_TRACE
+    lv_mem_trace_tag_t tags[TRACE_TAG_MAX];
+
+    /*The first cycle might initialize things which are kept*/
+    screen_cycle();
+    uint32_t mark = lv_mem_trace_mark();
+    screen_cycle();
+    lv_test_assert_int_eq(0, lv_mem_trace_get_tags(mark, tags, TRACE_TAG_MAX), "No leak when a screen is created and deleted");
+
+    /*Leak a memory on purpose*/
+    uint8_t * leak = lv_mem_alloc(100); uint32_t leak_line = __LINE__;
+    screen_cycle();
+    uint32_t tag_cnt = lv_mem_trace_get_tags(mark, tags, TRACE_TAG_MAX);
+    lv_test_assert_int_eq(1, tag_cnt, "Leak is found");
+    lv_test_assert_str_eq(__FILE__, tags[0].file, "File of the leak");
+    lv_test_assert_int_eq(leak_line, tags[0].line, "Line of the leak");
+    lv_test_assert_int_eq(1, tags[0].cnt, "Count of the leak");
+    lv_test_assert_int_eq(100, tags[0].size, "Size of the leak");
+    lv_test_assert_int_eq(1, tags[0].size_hist[4], "Histogram of the leak (<= 128 bytes)");
+
+    /*The reallocated memories keep their age*/
+    uint32_t mark2 = lv_mem_trace_mark();
+    leak = lv_mem_realloc(leak, 200);
+    lv_test_assert_int_eq(0, lv_mem_trace_get_tags(mark2, tags, TRACE_TAG_MAX), "Reallocated memory is not new");
+    lv_test_assert_int_eq(200, _lv_mem_get_size(leak), "Size of the reallocated memory");
+    lv_mem_trace_get_tags(mark, tags, TRACE_TAG_MAX);
+    lv_test_assert_int_eq(200, tags[0].size, "Size of the reallocated leak");
+
+    /*Leak an object*/
+    lv_obj_t * obj = lv_obj_create(lv_layer_top(), NULL);
+    tag_cnt = lv_mem_trace_get_tags(mark, tags, TRACE_TAG_MAX);
+    lv_test_assert_int_gt(1, tag_cnt, "Leaked object is found");
+    uint32_t i;
+    for(i = 0; i < tag_cnt; i++) {
+        lv_test_print("Live allocation after the mark at %s:%d: %d bytes in %d allocations "
+                      "(<= 8, 16, 32, 64 bytes: %d, %d, %d, %d)", tags[i].file, tags[i].line, tags[i].size, tags[i].cnt,
+                      tags[i].size_hist[0], tags[i].size_hist[1], tags[i].size_hist[2], tags[i].size_hist[3]);
+    }
+
+    lv_obj_del(obj);
+    lv_mem_free(leak);
+    lv_test_assert_int_eq(0, lv_mem_trace_get_tags(mark, tags, TRACE_TAG_MAX), "No leak after freeing");
+
+#if LV_MEM_CUSTOM == 0
+    char map[65];
+    lv_test_assert_int_eq(64, lv_mem_trace_frag_map(map, sizeof(map)), "Length of the heap map");
+    lv_test_assert_true(strchr(map, '#') != NULL, "Used memory in the heap map");
+    lv_test_print("Heap: %s", map);
+#endif
+#endif
+}
+
+#if USE_TRACE
+/**
+ * Create a screen with labels and delete it
+ */
+static void screen_cycle(void)
+{
+    lv_obj_t * scr = lv_obj_create(NULL, NULL);
+    uint32_t i;
+    for(i = 0; i < SCR_LABEL_CNT; i++) {
+        lv_obj_t * label = lv_label_create(scr, NULL);
+        lv_label_set_text_fmt(label, "Value %d", i);
+    }
+    lv_obj_del(scr);
+}
+#endif
+
+#if USE_SLAB
+static uint32_t slab_used_cnt(void)
+{
+    lv_mem_slab_monitor_t mon;
+    lv_mem_slab_monitor(&mon);
+    uint32_t cnt = 0;
+    uint32_t i;
+    for(i = 0; i < mon.class_cnt; i++) cnt += mon.classes[i].used_cnt;
+    return cnt;
+}
+
+static uint32_t slab_page_cnt(void)
+{
+    lv_mem_slab_monitor_t mon;
+    lv_mem_slab_monitor(&mon);
+    uint32_t cnt = 0;
+    uint32_t i;
+    for(i = 0; i < mon.class_cnt; i++) cnt += mon.classes[i].page_cnt;
+    return cnt;
+}
+
+/**
+ * Allocate a memory and find its slab size class
+ * @param size size of the memory
+ * @param p store the allocated memory here
+ * @return index of the class or -1 if the memory is not in a slab
+ */
+static int32_t slab_class_of_alloc(uint32_t size, uint8_t ** p)
+{
+    lv_mem_slab_monitor_t mon_start;
+    lv_mem_slab_monitor(&mon_start);
+    *p = lv_mem_alloc(size);
+    lv_mem_slab_monitor_t mon_end;
+    lv_mem_slab_monitor(&mon_end);
+    uint32_t i;
+    for(i = 0; i < mon_end.class_cnt; i++) {
+        if(mon_end.classes[i].used_cnt != mon_start.classes[i].used_cnt) return i;
+    }
+    return -1;
+}
+#endif
+
+static uint32_t rnd(void)
+{
+    seed = seed * 1103515245 + 12345;
+    return seed >> 16;
+}
+
+/**
+ * Mostly small, sometimes large sizes
+ */
+static uint32_t rnd_size(void)
+{
+    if(rnd() % 8) return 4 + rnd() % (SMALL_MAX - 4);
+    else return SMALL_MAX + rnd() % (LARGE_MAX - SMALL_MAX);
+}
+
+#endif
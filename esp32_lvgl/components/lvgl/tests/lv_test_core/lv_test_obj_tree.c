@@ -0,0 +1,515 @@
+/**
+ * @file lv_test_obj_tree.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../lvgl.h"
+#if LV_BUILD_TEST
+#include "../lv_test_assert.h"
+
+#include "lv_test_obj_tree.h"
+#include <time.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define CHILD_CNT       5
+#define BENCH_ROUNDS    20
+#if LV_MEM_CUSTOM
+#  define OBJ_CNT       1000
+#else
+#  define OBJ_CNT       16      /*Fit into the small heap*/
+#endif
+#if LV_MEM_CUSTOM
+#  define ROW_CNT_1     100
+#  define ROW_CNT_2     1000
+#else
+#  define ROW_CNT_1     5       /*Fit into the small heap*/
+#  define ROW_CNT_2     10
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void check_children(lv_obj_t * parent, lv_obj_t ** exp, uint32_t cnt, const char * s);
+static void children_order(void);
+static void rare_attributes(void);
+static void heap_per_obj(void);
+static void traverse_bench(void);
+static void suspend_layout(void);
+static void bulk_bench(uint32_t row_cnt, bool compare);
+static lv_res_t count_signal(lv_obj_t * obj, lv_signal_t sign, void * param);
+static uint32_t obj_heap_size(lv_obj_t * obj);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_signal_cb_t ancestor_signal;
+static uint32_t child_chg_cnt;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_obj_tree(void)
+{
+    lv_test_print("");
+    lv_test_print("===================");
+    lv_test_print("Start lv_obj_tree tests");
+    lv_test_print("===================");
+
+    lv_test_print("sizeof(lv_obj_t): %d bytes (%s layout)", (int)sizeof(lv_obj_t),
+                  LV_USE_OBJ_COMPACT ? "compact" : "normal");
+
+    lv_obj_clean(lv_scr_act());
+    children_order();
+    rare_attributes();
+    heap_per_obj();
+    traverse_bench();
+    lv_obj_clean(lv_scr_act());
+    suspend_layout();
+    bulk_bench(ROW_CNT_1, true);
+    bulk_bench(ROW_CNT_2, false);   /*Adding and deleting many list buttons one by one is too slow*/
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Check the children of an object in both directions
+ * @param parent the parent object
+ * @param exp the expected children from the youngest to the oldest
+ * @param cnt number of elements in `exp`
+ * @param s description of the test case
+ */
+static void check_children(lv_obj_t * parent, lv_obj_t ** exp, uint32_t cnt, const char * s)
+{
+    lv_test_assert_int_eq(cnt, lv_obj_count_children(parent), s);
+
+    uint32_t i = 0;
+    lv_obj_t * child = lv_obj_get_child(parent, NULL);
+    while(child) {
+        lv_test_assert_true(i < cnt && child == exp[i], s);
+        i++;
+        child = lv_obj_get_child(parent, child);
+    }
+    lv_test_assert_int_eq(cnt, i, s);
+
+    child = lv_obj_get_child_back(parent, NULL);
+    while(child) {
+        lv_test_assert_true(i > 0 && child == exp[i - 1], s);
+        i--;
+        child = lv_obj_get_child_back(parent, child);
+    }
+    lv_test_assert_int_eq(0, i, s);
+}
+
+static void children_order(void)
+{
+    lv_obj_t * par = lv_obj_create(lv_scr_act(), NULL);
+    lv_obj_t * par2 = lv_obj_create(lv_scr_act(), NULL);
+    lv_obj_t * c[CHILD_CNT];
+    uint32_t i;
+    for(i = 0; i < CHILD_CNT; i++) {
+        c[i] = lv_obj_create(par, NULL);
+    }
+
+    lv_obj_t * exp1[] = {c[4], c[3], c[2], c[1], c[0]};
+    check_children(par, exp1, 5, "Children in creation order");
+
+    lv_obj_move_background(c[4]);
+    lv_obj_t * exp2[] = {c[3], c[2], c[1], c[0], c[4]};
+    check_children(par, exp2, 5, "Move the youngest to the background");
+
+    lv_obj_move_foreground(c[0]);
+    lv_obj_t * exp3[] = {c[0], c[3], c[2], c[1], c[4]};
+    check_children(par, exp3, 5, "Move a child to the foreground");
+
+    lv_obj_move_foreground(c[2]);
+    lv_obj_t * exp4[] = {c[2], c[0], c[3], c[1], c[4]};
+    check_children(par, exp4, 5, "Move a middle child to the foreground");
+
+    lv_obj_set_parent(c[2], par2);
+    lv_obj_t * exp5[] = {c[0], c[3], c[1], c[4]};
+    check_children(par, exp5, 4, "Remove the youngest child by changing its parent");
+    lv_obj_t * exp5b[] = {c[2]};
+    check_children(par2, exp5b, 1, "Child on the new parent");
+
+    lv_obj_del(c[3]);
+    lv_obj_t * exp6[] = {c[0], c[1], c[4]};
+    check_children(par, exp6, 3, "Delete a middle child");
+
+    lv_obj_del(c[4]);
+    lv_obj_t * exp7[] = {c[0], c[1]};
+    check_children(par, exp7, 2, "Delete the oldest child");
+
+    lv_obj_del(c[0]);
+    lv_obj_t * exp8[] = {c[1]};
+    check_children(par, exp8, 1, "Delete the youngest child");
+
+    lv_obj_del(c[1]);
+    check_children(par, NULL, 0, "Delete the last child");
+
+    lv_obj_del(par);
+    lv_obj_del(par2);
+}
+
+static void rare_attributes(void)
+{
+    lv_obj_t * obj = lv_obj_create(lv_scr_act(), NULL);
+    uint32_t size_ori = obj_heap_size(obj);
+
+    lv_test_assert_true(lv_obj_get_auto_realign(obj) == false, "No auto realign by default");
+    lv_test_assert_int_eq(0, lv_obj_get_ext_click_pad_left(obj), "No extended click area by default");
+    lv_test_assert_int_eq(0, lv_obj_get_ext_click_pad_bottom(obj), "No extended click area by default");
+#if LV_USE_GROUP
+    lv_test_assert_true(lv_obj_get_group(obj) == NULL, "No group by default");
+#endif
+#if LV_USE_USER_DATA
+    lv_test_assert_true(lv_obj_get_user_data(obj) == NULL, "No user data by default");
+#endif
+    lv_test_assert_int_eq(size_ori, obj_heap_size(obj), "Reading the rare attributes doesn't allocate");
+
+    lv_obj_set_ext_click_area(obj, 1, 2, 3, 4);
+#if LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_FULL
+    lv_test_assert_int_eq(1, lv_obj_get_ext_click_pad_left(obj), "Extended click area left");
+    lv_test_assert_int_eq(4, lv_obj_get_ext_click_pad_bottom(obj), "Extended click area bottom");
+#elif LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_TINY
+    lv_test_assert_int_eq(2, lv_obj_get_ext_click_pad_left(obj), "Extended click area left");
+    lv_test_assert_int_eq(4, lv_obj_get_ext_click_pad_bottom(obj), "Extended click area bottom");
+#endif
+
+#if LV_USE_USER_DATA
+    int user_data;
+    lv_obj_set_user_data(obj, &user_data);
+    lv_test_assert_true(lv_obj_get_user_data(obj) == &user_data, "User data is set");
+#endif
+
+#if LV_USE_GROUP
+    lv_group_t * g = lv_group_create();
+    lv_group_add_obj(g, obj);
+    lv_test_assert_true(lv_obj_get_group(obj) == g, "Object is added to a group");
+#endif
+
+#if LV_USE_OBJ_REALIGN
+    lv_obj_align(obj, NULL, LV_ALIGN_IN_TOP_LEFT, 5, 6);
+    lv_obj_set_auto_realign(obj, true);
+    lv_obj_set_width(obj, 30);
+    lv_test_assert_true(lv_obj_get_auto_realign(obj), "Auto realign is set");
+    lv_test_assert_int_eq(5, lv_obj_get_x(obj), "Realigned x");
+    lv_test_assert_int_eq(6, lv_obj_get_y(obj), "Realigned y");
+#endif
+
+    lv_test_print("Heap usage of an object: %d bytes, with all rare attributes set: %d bytes", size_ori,
+                  obj_heap_size(obj));
+
+    /*The copy gets the same attributes*/
+    lv_obj_t * copy = lv_obj_create(lv_scr_act(), obj);
+#if LV_USE_OBJ_REALIGN
+    lv_test_assert_true(lv_obj_get_auto_realign(copy), "Auto realign is copied");
+#endif
+    lv_test_assert_int_eq(lv_obj_get_ext_click_pad_left(obj), lv_obj_get_ext_click_pad_left(copy),
+                          "Extended click area is copied");
+#if LV_USE_USER_DATA
+    lv_test_assert_true(lv_obj_get_user_data(copy) == &user_data, "User data is copied");
+#endif
+#if LV_USE_GROUP
+    lv_test_assert_true(lv_obj_get_group(copy) == g, "Copy is added to the group");
+    lv_group_remove_obj(copy);
+    lv_test_assert_true(lv_obj_get_group(copy) == NULL, "Copy is removed from the group");
+    lv_test_assert_true(lv_obj_get_group(obj) == g, "Original object is still in the group");
+    lv_group_del(g);
+    lv_test_assert_true(lv_obj_get_group(obj) == NULL, "Group is deleted");
+#endif
+
+    lv_obj_del(copy);
+    lv_obj_del(obj);
+}
+
+/**
+ * Measure the heap used by plain objects
+ */
+static void heap_per_obj(void)
+{
+    lv_obj_t * cont = lv_obj_create(lv_scr_act(), NULL);
+
+#if LV_MEM_CUSTOM == 0
+    _lv_mem_buf_free_all();
+    lv_mem_monitor_t mon_start;
+    lv_mem_monitor(&mon_start);
+#endif
+
+    lv_obj_t * obj = NULL;
+    uint32_t i;
+    for(i = 0; i < OBJ_CNT; i++) {
+        obj = lv_obj_create(cont, NULL);
+    }
+
+#if LV_MEM_CUSTOM == 0
+    _lv_mem_buf_free_all();
+    lv_mem_monitor_t mon_end;
+    lv_mem_monitor(&mon_end);
+    lv_test_print("%d objects: %d bytes of heap per object (%d bytes allocation for lv_obj_t)", OBJ_CNT,
+                  (mon_start.free_size - mon_end.free_size) / OBJ_CNT, obj_heap_size(obj));
+#else
+    lv_test_print("%d objects: %d bytes allocation for lv_obj_t", OBJ_CNT, obj_heap_size(obj));
+#endif
+
+    lv_test_assert_int_eq(OBJ_CNT, lv_obj_count_children(cont), "Children are created");
+    lv_obj_del(cont);
+}
+
+/**
+ * Measure the redraw of the screen with many small children
+ */
+static void traverse_bench(void)
+{
+    lv_obj_t * scr = lv_scr_act();
+    uint32_t i;
+    for(i = 0; i < OBJ_CNT; i++) {
+        lv_obj_t * obj = lv_obj_create(scr, NULL);
+        lv_obj_set_pos(obj, (i % 40) * 6, (i / 40) * 6);
+        lv_obj_set_size(obj, 4, 4);
+    }
+
+    /*Redraw everything*/
+    lv_refr_now(NULL);
+    clock_t t = clock();
+    for(i = 0; i < BENCH_ROUNDS; i++) {
+        lv_obj_invalidate(scr);
+        lv_refr_now(NULL);
+    }
+    uint32_t full_time = (clock() - t) * 1000000 / CLOCKS_PER_SEC / BENCH_ROUNDS;
+
+    /*Redraw a pixel next to the objects: all the children are visited but nothing is drawn*/
+    lv_area_t a;
+    lv_area_set(&a, LV_HOR_RES - 1, LV_VER_RES - 1, LV_HOR_RES - 1, LV_VER_RES - 1);
+    t = clock();
+    for(i = 0; i < BENCH_ROUNDS; i++) {
+        _lv_inv_area(NULL, &a);
+        lv_refr_now(NULL);
+    }
+    uint32_t visit_time = (clock() - t) * 1000000 / CLOCKS_PER_SEC / BENCH_ROUNDS;
+
+    lv_test_print("Redraw %d objects: %d us, visit them: %d us", OBJ_CNT, full_time, visit_time);
+    lv_test_assert_int_eq(OBJ_CNT, lv_obj_count_children(scr), "Children are created");
+}
+
+static void suspend_layout(void)
+{
+    lv_disp_t * disp = lv_disp_get_default();
+    lv_obj_t * cont = lv_cont_create(lv_scr_act(), NULL);
+    lv_cont_set_layout(cont, LV_LAYOUT_COLUMN_LEFT);
+    lv_obj_set_size(cont, 100, 200);
+    ancestor_signal = lv_obj_get_signal_cb(cont);
+    lv_obj_set_signal_cb(cont, count_signal);
+    lv_refr_now(NULL);
+
+    /*Create children: no layout and no invalidation*/
+    lv_obj_suspend_layout(cont);
+    lv_test_assert_true(lv_obj_is_layout_suspended(cont), "Layout is suspended");
+    child_chg_cnt = 0;
+    lv_obj_t * children[CHILD_CNT];
+    uint32_t i;
+    for(i = 0; i < CHILD_CNT; i++) {
+        children[i] = lv_obj_create(cont, NULL);
+        lv_obj_set_size(children[i], 20, 10);
+    }
+    lv_test_assert_true(lv_obj_is_layout_suspended(children[0]), "Layout of the children is suspended");
+    lv_test_assert_int_eq(0, child_chg_cnt, "No child change signal while suspended");
+    lv_test_assert_int_eq(lv_obj_get_y(children[0]), lv_obj_get_y(children[CHILD_CNT - 1]), "No layout while suspended");
+    lv_test_assert_int_eq(0, disp->inv_p, "No invalidation while suspended");
+
+    lv_obj_resume_layout(cont);
+    lv_test_assert_true(lv_obj_is_layout_suspended(cont) == false, "Layout is resumed");
+    lv_test_assert_int_eq(1, child_chg_cnt, "One child change signal on resume");
+    lv_test_assert_int_gt(lv_obj_get_y(children[0]), lv_obj_get_y(children[CHILD_CNT - 1]), "Layout on resume");
+    lv_test_assert_int_eq(1, disp->inv_p, "Invalidated once on resume");
+
+    /*Nested: the outer resume sends the signals*/
+    lv_refr_now(NULL);
+    child_chg_cnt = 0;
+    lv_obj_suspend_layout(lv_scr_act());
+    lv_obj_suspend_layout(cont);
+    lv_obj_del(children[0]);
+    lv_obj_resume_layout(cont);
+    lv_test_assert_int_eq(0, child_chg_cnt, "No signal while the parent is suspended");
+    lv_obj_resume_layout(lv_scr_act());
+    lv_test_assert_int_eq(1, child_chg_cnt, "Signal when the parent is resumed");
+
+    /*Clean: invalidated and signaled once*/
+    lv_refr_now(NULL);
+    child_chg_cnt = 0;
+    lv_obj_clean(cont);
+    lv_test_assert_int_eq(0, lv_obj_count_children(cont), "Children are deleted");
+    lv_test_assert_int_eq(1, child_chg_cnt, "One child change signal on clean");
+    lv_test_assert_int_eq(1, disp->inv_p, "Invalidated once on clean");
+
+#if LV_USE_TABLE
+    /*The table's size is refreshed once*/
+    lv_obj_t * table = lv_table_create(lv_scr_act(), NULL);
+    lv_table_set_col_cnt(table, 1);
+    lv_coord_t h = lv_obj_get_height(table);
+    lv_obj_suspend_layout(table);
+    for(i = 0; i < CHILD_CNT; i++) {
+        lv_table_set_cell_value(table, i, 0, "cell");
+    }
+    lv_test_assert_int_eq(h, lv_obj_get_height(table), "Table size is not refreshed while suspended");
+    lv_obj_resume_layout(table);
+    lv_test_assert_int_gt(h, lv_obj_get_height(table), "Table size is refreshed on resume");
+    lv_obj_del(table);
+#endif
+
+    lv_obj_del(cont);
+}
+
+/**
+ * Create and delete a list and a table with many rows with and without suspended layout
+ * @param row_cnt number of rows
+ * @param compare true: measure the list without suspended layout too
+ */
+static void bulk_bench(uint32_t row_cnt, bool compare)
+{
+    uint32_t i;
+#if LV_USE_LIST
+    /*Small rows to keep the height of the scrollable in the range of `lv_coord_t`*/
+    static lv_style_t row_style;
+    lv_style_init(&row_style);
+    lv_style_set_pad_top(&row_style, LV_STATE_DEFAULT, 0);
+    lv_style_set_pad_bottom(&row_style, LV_STATE_DEFAULT, 0);
+    lv_style_set_pad_inner(&row_style, LV_STATE_DEFAULT, 0);
+
+    lv_obj_t * list_ref = NULL;
+    uint32_t add_time = 0;
+    uint32_t del_time = 0;
+    char txt[16];
+    clock_t t;
+
+    if(compare) {
+        list_ref = lv_list_create(lv_scr_act(), NULL);
+        lv_obj_add_style(list_ref, LV_LIST_PART_SCROLLABLE, &row_style);
+        t = clock();
+        for(i = 0; i < row_cnt; i++) {
+            lv_snprintf(txt, sizeof(txt), "Row %d", i);
+            lv_obj_add_style(lv_list_add_btn(list_ref, NULL, txt), LV_BTN_PART_MAIN, &row_style);
+        }
+        add_time = (clock() - t) * 1000000 / CLOCKS_PER_SEC;
+    }
+
+    lv_obj_t * list = lv_list_create(lv_scr_act(), NULL);
+    lv_obj_add_style(list, LV_LIST_PART_SCROLLABLE, &row_style);
+    lv_obj_t * scrl = lv_page_get_scrollable(list);
+
+    t = clock();
+    lv_obj_suspend_layout(list);
+    for(i = 0; i < row_cnt; i++) {
+        lv_snprintf(txt, sizeof(txt), "Row %d", i);
+        lv_obj_add_style(lv_list_add_btn(list, NULL, txt), LV_BTN_PART_MAIN, &row_style);
+    }
+    lv_obj_resume_layout(list);
+    uint32_t add_susp_time = (clock() - t) * 1000000 / CLOCKS_PER_SEC;
+
+    if(compare) {
+        lv_obj_t * scrl_ref = lv_page_get_scrollable(list_ref);
+        lv_test_assert_int_eq(lv_obj_get_height(scrl_ref), lv_obj_get_height(scrl), "Same list with suspended layout");
+
+        /*The buttons are in the same order at the same place*/
+        lv_obj_t * btn_ref = lv_list_get_next_btn(list_ref, NULL);
+        lv_obj_t * btn = lv_list_get_next_btn(list, NULL);
+        while(btn_ref && btn) {
+            lv_test_assert_str_eq(lv_list_get_btn_text(btn_ref), lv_list_get_btn_text(btn), "Same button order");
+            lv_test_assert_int_eq(lv_obj_get_y(btn_ref), lv_obj_get_y(btn), "Same button position");
+            btn_ref = lv_list_get_next_btn(list_ref, btn_ref);
+            btn = lv_list_get_next_btn(list, btn);
+        }
+        lv_test_assert_true(btn_ref == NULL && btn == NULL, "Same number of buttons");
+
+        /*Delete the buttons one by one*/
+        t = clock();
+        while(lv_obj_get_child(scrl_ref, NULL)) {
+            lv_obj_del(lv_obj_get_child(scrl_ref, NULL));
+        }
+        del_time = (clock() - t) * 1000000 / CLOCKS_PER_SEC;
+        lv_obj_del(list_ref);
+    }
+
+    t = clock();
+    lv_list_clean(list);
+    uint32_t clean_time = (clock() - t) * 1000000 / CLOCKS_PER_SEC;
+    lv_test_assert_int_eq(0, lv_obj_count_children(scrl), "List is cleaned");
+    lv_obj_del(list);
+    lv_style_reset(&row_style);
+
+    if(compare) {
+        lv_test_print("lv_list with %d rows: add: %d us, add suspended: %d us, delete one by one: %d us, clean: %d us",
+                      row_cnt, add_time, add_susp_time, del_time, clean_time);
+    }
+    else {
+        lv_test_print("lv_list with %d rows: add suspended: %d us, clean: %d us", row_cnt, add_susp_time, clean_time);
+    }
+#endif
+
+#if LV_USE_TABLE
+    uint32_t fill_time[2];
+    uint32_t j;
+    for(j = 0; j < 2; j++) {
+        clock_t t2 = clock();
+        lv_obj_t * table = lv_table_create(lv_scr_act(), NULL);
+        lv_table_set_col_cnt(table, 2);
+        if(j == 1) lv_obj_suspend_layout(table);
+        for(i = 0; i < row_cnt; i++) {
+            lv_table_set_cell_value(table, i, 0, "Row");
+            lv_table_set_cell_value_fmt(table, i, 1, "%d", i);
+        }
+        if(j == 1) lv_obj_resume_layout(table);
+        fill_time[j] = (clock() - t2) * 1000000 / CLOCKS_PER_SEC;
+        lv_obj_del(table);
+    }
+
+    lv_test_print("lv_table with %d rows: fill: %d us, fill suspended: %d us", row_cnt, fill_time[0], fill_time[1]);
+#endif
+
+    /*Unused if there are no lists and tables*/
+    (void)i;
+    (void)row_cnt;
+    (void)compare;
+}
+
+/**
+ * Count the child change signals which are not postponed
+ */
+static lv_res_t count_signal(lv_obj_t * obj, lv_signal_t sign, void * param)
+{
+    lv_res_t res = ancestor_signal(obj, sign, param);
+    if(res == LV_RES_OK && sign == LV_SIGNAL_CHILD_CHG) child_chg_cnt++;
+    return res;
+}
+
+/**
+ * Get the heap used by an object itself and by its rarely used attributes
+ * @param obj pointer to an object
+ * @return size of the allocations in bytes
+ */
+static uint32_t obj_heap_size(lv_obj_t * obj)
+{
+    uint32_t size = _lv_mem_get_size(obj);
+#if _LV_OBJ_SPEC_ATTR
+    if(obj->spec_attr) size += _lv_mem_get_size(obj->spec_attr);
+#endif
+    return size;
+}
+
+#endif
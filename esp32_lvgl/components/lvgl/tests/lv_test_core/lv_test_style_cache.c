@@ -0,0 +1,280 @@
+/**
+ * @file lv_test_style_cache.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../lvgl.h"
+#if LV_BUILD_TEST
+#include "../lv_test_assert.h"
+
+#include "lv_test_style_cache.h"
+
+#if LV_STYLE_CACHE_SIZE && LV_USE_BTN && LV_USE_LABEL && LV_USE_SLIDER && LV_USE_SWITCH && LV_USE_CHECKBOX
+
+/*********************
+ *      DEFINES
+ *********************/
+/*Number of cache entries needed to keep all object parts of the scene*/
+#define SCENE_PART_CNT      40
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void create_scene(lv_obj_t * scr);
+static void refr_frame(const char * name, lv_style_cache_stats_t * stats);
+static void disable_caching(lv_obj_t * obj, bool dis);
+static bool props_are_resolved(lv_obj_t * obj, uint8_t part);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+extern lv_color_t test_fb[];    /*Defined in lv_test_main.c*/
+static lv_color_t fb_ref[LV_HOR_RES_MAX * LV_VER_RES_MAX];
+
+static const lv_style_property_t int_props[] = {
+    LV_STYLE_RADIUS, LV_STYLE_PAD_TOP, LV_STYLE_PAD_INNER, LV_STYLE_MARGIN_LEFT, LV_STYLE_BG_GRAD_DIR,
+    LV_STYLE_BORDER_WIDTH, LV_STYLE_BORDER_SIDE, LV_STYLE_OUTLINE_WIDTH, LV_STYLE_SHADOW_WIDTH,
+    LV_STYLE_TEXT_LETTER_SPACE, LV_STYLE_TEXT_LINE_SPACE, LV_STYLE_LINE_WIDTH, LV_STYLE_TRANSITION_TIME,
+    LV_STYLE_TRANSFORM_ZOOM, LV_STYLE_SCALE_WIDTH
+};
+
+static const lv_style_property_t color_props[] = {
+    LV_STYLE_BG_COLOR, LV_STYLE_BG_GRAD_COLOR, LV_STYLE_BORDER_COLOR, LV_STYLE_TEXT_COLOR, LV_STYLE_TEXT_SEL_BG_COLOR,
+    LV_STYLE_LINE_COLOR, LV_STYLE_IMAGE_RECOLOR, LV_STYLE_SCALE_END_COLOR
+};
+
+static const lv_style_property_t opa_props[] = {
+    LV_STYLE_OPA_SCALE, LV_STYLE_BG_OPA, LV_STYLE_BORDER_OPA, LV_STYLE_TEXT_OPA, LV_STYLE_IMAGE_RECOLOR_OPA
+};
+
+static const lv_style_property_t ptr_props[] = {
+    LV_STYLE_TEXT_FONT, LV_STYLE_VALUE_STR, LV_STYLE_PATTERN_IMAGE, LV_STYLE_TRANSITION_PATH
+};
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_style_cache(void)
+{
+    lv_test_print("");
+    lv_test_print("===================");
+    lv_test_print("Start lv_style_cache tests");
+    lv_test_print("===================");
+
+    lv_obj_t * scr = lv_scr_act();
+    lv_obj_clean(scr);
+    create_scene(scr);
+    uint32_t fb_size = sizeof(lv_color_t) * LV_HOR_RES * LV_VER_RES;
+
+    /*Reference: draw without the style cache*/
+    disable_caching(scr, true);
+    disable_caching(lv_layer_top(), true);
+    disable_caching(lv_layer_sys(), true);
+    lv_style_cache_stats_t ref;
+    refr_frame("Frame without cache", &ref);
+    memcpy(fb_ref, test_fb, fb_size);
+    lv_test_assert_int_eq(ref.lookup_cnt, ref.resolve_cnt, "Every property is looked up without cache");
+    disable_caching(scr, false);
+    disable_caching(lv_layer_top(), false);
+    disable_caching(lv_layer_sys(), false);
+
+    /*The first frame fills the cache, the next ones read it*/
+    lv_obj_report_style_mod(NULL);
+    lv_style_cache_stats_t cold;
+    refr_frame("First frame with cache", &cold);
+    lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, "Same frame with filling the cache");
+
+    lv_style_cache_stats_t warm;
+    refr_frame("Next frame with cache", &warm);
+    lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, "Same frame from the cache");
+    lv_test_assert_int_lt(ref.resolve_cnt, cold.resolve_cnt, "Less lookups in the style lists while filling the cache");
+#if LV_STYLE_CACHE_SIZE >= SCENE_PART_CNT
+    lv_test_assert_int_lt(cold.resolve_cnt / 4, warm.resolve_cnt, "Most properties are read from the cache");
+
+    /*State change: only the object and its children are looked up again*/
+    lv_obj_t * pr_btn = lv_obj_get_child(lv_obj_get_child_back(scr, NULL), NULL);
+    lv_obj_add_state(pr_btn, LV_STATE_PRESSED);
+    lv_style_cache_stats_t state;
+    refr_frame("Frame after a state change", &state);
+    lv_test_assert_int_lt(cold.resolve_cnt / 2, state.resolve_cnt, "Other objects are kept in the cache");
+    lv_obj_clear_state(pr_btn, LV_STATE_PRESSED);
+    refr_frame("Frame after the state is cleared", &state);
+    lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, "Same frame after the state change");
+#else
+    /*The parts of the scene evict each other from a small cache*/
+    lv_test_assert_int_lt(cold.resolve_cnt + 1, warm.resolve_cnt, "Some properties are read from the cache");
+#endif
+    lv_test_assert_int_gt(0, warm.rect_copy_cnt, "Rectangle descriptors are copied from the cache");
+
+    /*Local style: the cached properties are refreshed*/
+    lv_obj_t * btn = lv_obj_get_child_back(lv_obj_get_child_back(scr, NULL), NULL);
+    lv_obj_t * label = lv_obj_get_child(btn, NULL);
+    lv_test_assert_true(props_are_resolved(btn, LV_BTN_PART_MAIN), "Button's properties from the cache");
+    lv_obj_set_style_local_bg_color(btn, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_LIME);
+    lv_test_assert_color_eq(LV_COLOR_LIME, lv_obj_get_style_bg_color(btn, LV_BTN_PART_MAIN), "New local style");
+    lv_test_assert_true(props_are_resolved(btn, LV_BTN_PART_MAIN), "Button's properties after new local style");
+
+    /*State change: the inherited properties of the children are refreshed too*/
+    lv_obj_set_style_local_text_color(btn, LV_BTN_PART_MAIN, LV_STATE_FOCUSED, LV_COLOR_RED);
+    lv_test_assert_true(lv_obj_get_style_text_color(label, LV_LABEL_PART_MAIN).full != LV_COLOR_RED.full,
+                        "Label's color before the state change");
+    lv_obj_add_state(btn, LV_STATE_FOCUSED);
+    lv_test_assert_color_eq(LV_COLOR_RED, lv_obj_get_style_text_color(label, LV_LABEL_PART_MAIN),
+                            "Label inherits from the new state");
+    lv_test_assert_true(props_are_resolved(btn, LV_BTN_PART_MAIN), "Button's properties in new state");
+    lv_test_assert_true(props_are_resolved(label, LV_LABEL_PART_MAIN), "Label's properties in new state");
+
+    /*Modified style*/
+    static lv_style_t style;
+    lv_style_init(&style);
+    lv_obj_add_style(label, LV_LABEL_PART_MAIN, &style);
+    lv_test_assert_int_eq(0, lv_obj_get_style_text_letter_space(label, LV_LABEL_PART_MAIN), "Letter space before");
+    lv_style_set_text_letter_space(&style, LV_STATE_DEFAULT, 3);
+    lv_obj_report_style_mod(&style);
+    lv_test_assert_int_eq(3, lv_obj_get_style_text_letter_space(label, LV_LABEL_PART_MAIN), "Modified style");
+
+    /*New parent: the inherited properties are refreshed*/
+    lv_obj_t * cont = lv_obj_create(scr, NULL);
+    lv_obj_set_style_local_text_color(cont, LV_OBJ_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_BLUE);
+    lv_obj_set_parent(label, cont);
+    lv_test_assert_color_eq(LV_COLOR_BLUE, lv_obj_get_style_text_color(label, LV_LABEL_PART_MAIN),
+                            "Label inherits from the new parent");
+
+    /*An object deleted and a new one created at the same place*/
+    lv_obj_del(label);
+    label = lv_label_create(scr, NULL);
+    lv_test_assert_true(props_are_resolved(label, LV_LABEL_PART_MAIN), "New object's properties");
+
+    lv_obj_clean(scr);
+    lv_style_reset(&style);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Create a few widgets like the widgets demo does
+ */
+static void create_scene(lv_obj_t * scr)
+{
+    lv_obj_t * cont = lv_cont_create(scr, NULL);
+    lv_obj_set_size(cont, LV_HOR_RES / 2, LV_VER_RES);
+    lv_cont_set_layout(cont, LV_LAYOUT_COLUMN_MID);
+
+    uint32_t i;
+    for(i = 0; i < 3; i++) {
+        lv_obj_t * btn = lv_btn_create(cont, NULL);
+        lv_obj_t * label = lv_label_create(btn, NULL);
+        lv_label_set_text_fmt(label, "Button %d", i);
+        if(i == 1) lv_btn_set_checkable(btn, true);
+        if(i == 2) lv_obj_add_state(btn, LV_STATE_CHECKED);
+    }
+
+    lv_obj_t * cont2 = lv_cont_create(scr, cont);
+    lv_obj_align(cont2, NULL, LV_ALIGN_IN_RIGHT_MID, 0, 0);
+
+    lv_obj_t * slider = lv_slider_create(cont2, NULL);
+    lv_slider_set_value(slider, 40, LV_ANIM_OFF);
+
+    lv_obj_t * sw = lv_switch_create(cont2, NULL);
+    lv_switch_on(sw, LV_ANIM_OFF);
+
+    lv_obj_t * cb = lv_checkbox_create(cont2, NULL);
+    lv_checkbox_set_text(cb, "Check");
+
+    lv_obj_t * label = lv_label_create(cont2, NULL);
+    lv_label_set_text(label, "The style properties are resolved once");
+}
+
+/**
+ * Redraw the screen and get the statistics of the frame
+ */
+static void refr_frame(const char * name, lv_style_cache_stats_t * stats)
+{
+    lv_obj_invalidate(lv_scr_act());
+    lv_obj_reset_style_cache_stats();
+    lv_refr_now(NULL);
+    lv_obj_get_style_cache_stats(stats);
+    lv_test_print("%s: %d properties asked, %d looked up in the style lists, %d rectangle descriptors copied", name,
+                  stats->lookup_cnt, stats->resolve_cnt, stats->rect_copy_cnt);
+}
+
+static void disable_caching(lv_obj_t * obj, bool dis)
+{
+    _lv_obj_disable_style_caching(obj, dis);
+
+    lv_obj_t * child = lv_obj_get_child(obj, NULL);
+    while(child) {
+        disable_caching(child, dis);
+        child = lv_obj_get_child(obj, child);
+    }
+}
+
+/**
+ * Tell whether the properties got with and without the style cache are the same.
+ * Get the properties twice to read them from the cache too.
+ */
+static bool props_are_resolved(lv_obj_t * obj, uint8_t part)
+{
+    uint32_t k;
+    for(k = 0; k < 2; k++) {
+        uint32_t i;
+        for(i = 0; i < sizeof(int_props) / sizeof(int_props[0]); i++) {
+            lv_style_int_t v = _lv_obj_get_style_int(obj, part, int_props[i]);
+            _lv_obj_disable_style_caching(obj, true);
+            lv_style_int_t ref = _lv_obj_get_style_int(obj, part, int_props[i]);
+            _lv_obj_disable_style_caching(obj, false);
+            if(v != ref) return false;
+        }
+
+        for(i = 0; i < sizeof(color_props) / sizeof(color_props[0]); i++) {
+            lv_color_t v = _lv_obj_get_style_color(obj, part, color_props[i]);
+            _lv_obj_disable_style_caching(obj, true);
+            lv_color_t ref = _lv_obj_get_style_color(obj, part, color_props[i]);
+            _lv_obj_disable_style_caching(obj, false);
+            if(v.full != ref.full) return false;
+        }
+
+        for(i = 0; i < sizeof(opa_props) / sizeof(opa_props[0]); i++) {
+            lv_opa_t v = _lv_obj_get_style_opa(obj, part, opa_props[i]);
+            _lv_obj_disable_style_caching(obj, true);
+            lv_opa_t ref = _lv_obj_get_style_opa(obj, part, opa_props[i]);
+            _lv_obj_disable_style_caching(obj, false);
+            if(v != ref) return false;
+        }
+
+        for(i = 0; i < sizeof(ptr_props) / sizeof(ptr_props[0]); i++) {
+            const void * v = _lv_obj_get_style_ptr(obj, part, ptr_props[i]);
+            _lv_obj_disable_style_caching(obj, true);
+            const void * ref = _lv_obj_get_style_ptr(obj, part, ptr_props[i]);
+            _lv_obj_disable_style_caching(obj, false);
+            if(v != ref) return false;
+        }
+    }
+
+    return true;
+}
+
+#else
+
+void lv_test_style_cache(void)
+{
+
+}
+
+#endif
+#endif
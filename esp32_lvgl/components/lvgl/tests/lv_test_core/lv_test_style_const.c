@@ -0,0 +1,255 @@
+/**
+ * @file lv_test_style_const.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../lvgl.h"
+#if LV_BUILD_TEST
+#include "../lv_test_assert.h"
+#include "../../src/lv_misc/lv_gc.h"
+
+#include "lv_test_style_const.h"
+#include <time.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define ID_NUM          0xD0    /*13 groups with 16 property IDs*/
+#define BENCH_ROUNDS    100
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void set_values(lv_style_t * style);
+static bool styles_are_same(const lv_style_t * style1, const lv_style_t * style2);
+static void draw(lv_obj_t * obj, const lv_style_t * style);
+#if LV_USE_THEME_MATERIAL
+static void theme_measure(void);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+extern lv_color_t test_fb[];    /*Defined in lv_test_main.c*/
+static lv_color_t fb_ref[LV_HOR_RES_MAX * LV_VER_RES_MAX];
+
+static const lv_style_value_t values[] = {
+    LV_STYLE_VALUE_INT(LV_STYLE_RADIUS, 5),
+    LV_STYLE_VALUE_INT(LV_STYLE_BORDER_WIDTH, 2),
+    LV_STYLE_VALUE_INT(LV_STYLE_BORDER_WIDTH | (LV_STATE_FOCUSED << LV_STYLE_STATE_POS), 4),
+    LV_STYLE_VALUE_INT(LV_STYLE_BORDER_WIDTH | ((LV_STATE_FOCUSED | LV_STATE_PRESSED) << LV_STYLE_STATE_POS), 6),
+    LV_STYLE_VALUE_COLOR(LV_STYLE_BORDER_COLOR, LV_COLOR_INIT(0x00, 0x80, 0x00)),
+    LV_STYLE_VALUE_COLOR(LV_STYLE_BG_COLOR, LV_COLOR_INIT(0xFF, 0x00, 0x00)),
+    LV_STYLE_VALUE_COLOR(LV_STYLE_BG_COLOR | (LV_STATE_PRESSED << LV_STYLE_STATE_POS), LV_COLOR_INIT(0x00, 0x00, 0xFF)),
+    LV_STYLE_VALUE_OPA(LV_STYLE_BG_OPA, LV_OPA_COVER),
+    LV_STYLE_VALUE_OPA(LV_STYLE_BG_OPA | (LV_STATE_CHECKED << LV_STYLE_STATE_POS), LV_OPA_50),
+    LV_STYLE_VALUE_INT(LV_STYLE_PAD_TOP, 10),
+    LV_STYLE_VALUE_PTR(LV_STYLE_VALUE_STR, "const"),
+    LV_STYLE_VALUE_COLOR(LV_STYLE_VALUE_COLOR, LV_COLOR_INIT(0xFF, 0xFF, 0xFF)),
+};
+
+static LV_STYLE_CONST_INIT(style_const, values);
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_style_const(void)
+{
+    lv_test_print("");
+    lv_test_print("===================");
+    lv_test_print("Start lv_style_const tests");
+    lv_test_print("===================");
+
+    /*Reference style with the same properties*/
+    static lv_style_t style_set;
+    lv_style_init(&style_set);
+
+    clock_t t = clock();
+    uint32_t i;
+    for(i = 0; i < BENCH_ROUNDS; i++) {
+        lv_style_reset(&style_set);
+        set_values(&style_set);
+    }
+    uint32_t set_time = (clock() - t) * 1000000 / CLOCKS_PER_SEC;
+    lv_test_print("Create a style with %d properties %d times: %d us, constant style: 0 us",
+                  (int)(sizeof(values) / sizeof(values[0])), BENCH_ROUNDS, set_time);
+
+    lv_test_assert_true(lv_style_is_const(&style_const), "Constant style is recognized");
+    lv_test_assert_true(lv_style_is_const(&style_set) == false, "Normal style is not constant");
+    lv_test_assert_int_eq(0, _lv_style_get_mem_size(&style_const), "Constant style uses no RAM");
+    lv_test_assert_true(styles_are_same(&style_set, &style_const), "Same properties in every state");
+
+    /*A copy of a constant style can be modified*/
+    static lv_style_t style_copy;
+    lv_style_init(&style_copy);
+    lv_style_copy(&style_copy, &style_const);
+    lv_test_assert_true(lv_style_is_const(&style_copy) == false, "Copy of a constant style is not constant");
+    lv_test_assert_true(styles_are_same(&style_set, &style_copy), "Same properties in the copy");
+    lv_style_set_radius(&style_copy, LV_STATE_DEFAULT, 7);
+    lv_style_int_t radius = 0;
+    _lv_style_get_int(&style_copy, LV_STYLE_RADIUS, &radius);
+    lv_test_assert_int_eq(7, radius, "Copy of a constant style is modified");
+    lv_style_reset(&style_copy);
+
+#if LV_USE_ASSERT_STYLE == 0
+    /*Without the assert the writes are ignored*/
+    lv_style_t * style_p = (lv_style_t *)&style_const;
+    lv_style_set_radius(style_p, LV_STATE_DEFAULT, 7);
+    lv_style_set_text_color(style_p, LV_STATE_DEFAULT, LV_COLOR_RED);
+    lv_test_assert_true(lv_style_remove_prop(style_p, LV_STYLE_BORDER_WIDTH) == false, "Can't remove a property");
+    lv_test_assert_true(lv_style_index(style_p) == false, "Can't index a constant style");
+    lv_style_reset(style_p);
+    lv_test_assert_true(lv_style_is_const(&style_const), "Reset is ignored");
+    lv_test_assert_true(styles_are_same(&style_set, &style_const), "Writes are ignored");
+#endif
+
+    /*Objects are drawn in the same way with the constant style*/
+    lv_obj_clean(lv_scr_act());
+    lv_obj_t * obj = lv_obj_create(lv_scr_act(), NULL);
+    lv_obj_set_pos(obj, 10, 10);
+    lv_obj_set_size(obj, 100, 50);
+    lv_obj_reset_style_list(obj, LV_OBJ_PART_MAIN);
+    uint32_t fb_size = sizeof(lv_color_t) * LV_HOR_RES * LV_VER_RES;
+
+    lv_state_t states[] = {LV_STATE_DEFAULT, LV_STATE_PRESSED, LV_STATE_FOCUSED | LV_STATE_PRESSED};
+    for(i = 0; i < sizeof(states) / sizeof(states[0]); i++) {
+        lv_obj_set_state(obj, states[i]);
+        draw(obj, &style_set);
+        memcpy(fb_ref, test_fb, fb_size);
+        draw(obj, &style_const);
+        lv_test_assert_array_eq((uint8_t *)fb_ref, (uint8_t *)test_fb, fb_size, "Drawn with constant style");
+    }
+
+    lv_obj_del(obj);
+    lv_style_reset(&style_set);
+
+#if LV_USE_THEME_MATERIAL
+    theme_measure();
+#endif
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void set_values(lv_style_t * style)
+{
+    uint32_t i;
+    for(i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        lv_style_property_t type = values[i].prop & 0xF;
+        if(type < LV_STYLE_ID_COLOR) _lv_style_set_int(style, values[i].prop, values[i].value.num);
+        else if(type < LV_STYLE_ID_OPA) _lv_style_set_color(style, values[i].prop, values[i].value.color);
+        else if(type < LV_STYLE_ID_PTR) _lv_style_set_opa(style, values[i].prop, values[i].value.opa);
+        else _lv_style_set_ptr(style, values[i].prop, values[i].value.ptr);
+    }
+}
+
+static bool styles_are_same(const lv_style_t * style1, const lv_style_t * style2)
+{
+    uint32_t id;
+    for(id = 0; id < ID_NUM; id++) {
+        uint32_t state;
+        for(state = 0; state <= LV_STYLE_STATE_MASK >> LV_STYLE_STATE_POS; state++) {
+            lv_style_property_t prop = id | (state << LV_STYLE_STATE_POS);
+            uint8_t type = id & 0xF;
+            int16_t w1;
+            int16_t w2;
+            bool same;
+            if(type < LV_STYLE_ID_COLOR) {
+                lv_style_int_t v1 = 0, v2 = 0;
+                w1 = _lv_style_get_int(style1, prop, &v1);
+                w2 = _lv_style_get_int(style2, prop, &v2);
+                same = v1 == v2;
+            }
+            else if(type < LV_STYLE_ID_OPA) {
+                lv_color_t v1 = LV_COLOR_BLACK, v2 = LV_COLOR_BLACK;
+                w1 = _lv_style_get_color(style1, prop, &v1);
+                w2 = _lv_style_get_color(style2, prop, &v2);
+                same = v1.full == v2.full;
+            }
+            else if(type < LV_STYLE_ID_PTR) {
+                lv_opa_t v1 = 0, v2 = 0;
+                w1 = _lv_style_get_opa(style1, prop, &v1);
+                w2 = _lv_style_get_opa(style2, prop, &v2);
+                same = v1 == v2;
+            }
+            else {
+                const void * v1 = NULL;
+                const void * v2 = NULL;
+                w1 = _lv_style_get_ptr(style1, prop, &v1);
+                w2 = _lv_style_get_ptr(style2, prop, &v2);
+                same = v1 == v2;
+            }
+
+            if(w1 != w2 || (w1 >= 0 && !same)) {
+                lv_test_print("Different property 0x%04x: weight %d, %d", prop, w1, w2);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Draw the screen with only one style on an object
+ * @param obj the object
+ * @param style the style to add to the object
+ */
+static void draw(lv_obj_t * obj, const lv_style_t * style)
+{
+    lv_obj_reset_style_list(obj, LV_OBJ_PART_MAIN);
+    lv_obj_add_style(obj, LV_OBJ_PART_MAIN, style);
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+}
+
+#if LV_USE_THEME_MATERIAL
+/**
+ * Measure what the material theme would save with constant styles.
+ * Its styles depend on the colors, flags and fonts of the theme and on the DPI and size of the display
+ * so they are created at runtime.
+ */
+static void theme_measure(void)
+{
+    lv_theme_material_init(LV_THEME_DEFAULT_COLOR_PRIMARY, LV_THEME_DEFAULT_COLOR_SECONDARY, LV_THEME_DEFAULT_FLAG,
+                           LV_THEME_DEFAULT_FONT_SMALL, LV_THEME_DEFAULT_FONT_NORMAL,
+                           LV_THEME_DEFAULT_FONT_SUBTITLE, LV_THEME_DEFAULT_FONT_TITLE);
+
+    /*The `theme_styles_t` of the theme contains only styles*/
+    const lv_style_t * styles = LV_GC_ROOT(_lv_theme_material_styles);
+    uint32_t style_cnt = _lv_mem_get_size(styles) / sizeof(lv_style_t);
+    uint32_t map_size = 0;
+    uint32_t i;
+    for(i = 0; i < style_cnt; i++) {
+        map_size += _lv_style_get_mem_size(&styles[i]);
+    }
+
+    clock_t t = clock();
+    for(i = 0; i < BENCH_ROUNDS; i++) {
+        lv_theme_material_init(LV_THEME_DEFAULT_COLOR_PRIMARY, LV_THEME_DEFAULT_COLOR_SECONDARY, LV_THEME_DEFAULT_FLAG,
+                               LV_THEME_DEFAULT_FONT_SMALL, LV_THEME_DEFAULT_FONT_NORMAL,
+                               LV_THEME_DEFAULT_FONT_SUBTITLE, LV_THEME_DEFAULT_FONT_TITLE);
+    }
+    uint32_t init_time = (clock() - t) * 1000000 / CLOCKS_PER_SEC / BENCH_ROUNDS;
+
+    lv_test_print("Material theme: %d styles, %d bytes of style maps + %d bytes of styles in the heap, init: %d us",
+                  style_cnt, map_size, (int)(style_cnt * sizeof(lv_style_t)), init_time);
+    lv_test_assert_int_gt(0, map_size, "Material theme styles are in the heap");
+}
+#endif
+
+#endif
@@ -0,0 +1,316 @@
+/**
+ * @file lv_test_style_index.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../lvgl.h"
+#if LV_BUILD_TEST
+#include "../lv_test_assert.h"
+
+#include "lv_test_style_index.h"
+#include <time.h>
+
+#if LV_MEM_CUSTOM || LV_MEM_SIZE >= 12 * 1024
+
+/*********************
+ *      DEFINES
+ *********************/
+#define ID_NUM          0xD0    /*13 groups with 16 property IDs*/
+#define BENCH_ROUNDS    20
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void fill_style(lv_style_t * style);
+static void set_prop(lv_style_t * style, lv_style_property_t prop, uint32_t v);
+static bool styles_are_same(const lv_style_t * style1, const lv_style_t * style2);
+#if LV_STYLE_INDEX_PROP_CNT == 0
+static uint32_t bench(const lv_style_t * style);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_style_index(void)
+{
+    lv_test_print("");
+    lv_test_print("===================");
+    lv_test_print("Start lv_style_index tests");
+    lv_test_print("===================");
+
+    /*Flat and indexed styles with the same properties*/
+    static lv_style_t style_flat;
+    static lv_style_t style_indexed;
+    lv_style_init(&style_flat);
+    lv_style_init(&style_indexed);
+    fill_style(&style_flat);
+    lv_style_copy(&style_indexed, &style_flat);
+    lv_test_assert_int_eq(_lv_style_get_mem_size(&style_flat), _lv_style_get_mem_size(&style_indexed), "Copy a style");
+    lv_test_assert_true(lv_style_index(&style_indexed), "Index a style");
+    lv_test_assert_true(styles_are_same(&style_flat, &style_indexed), "Same properties in every state after indexing");
+
+#if LV_STYLE_INDEX_PROP_CNT == 0
+    /*With `LV_STYLE_INDEX_PROP_CNT` the filled style would be indexed too*/
+    lv_test_assert_int_gt(_lv_style_get_mem_size(&style_flat), _lv_style_get_mem_size(&style_indexed),
+                          "Indexed style has a header");
+    lv_test_print("Get every property in 5 states %d times: byte map: %d us, indexed: %d us",
+                  BENCH_ROUNDS, bench(&style_flat), bench(&style_indexed));
+#endif
+
+    /*Changing the properties keeps the style indexed*/
+    uint16_t indexed_size = _lv_style_get_mem_size(&style_indexed);
+    set_prop(&style_flat, LV_STYLE_BORDER_WIDTH, 1234);
+    set_prop(&style_indexed, LV_STYLE_BORDER_WIDTH, 1234);
+    lv_test_assert_int_eq(indexed_size, _lv_style_get_mem_size(&style_indexed), "Existing property is set in place");
+
+    set_prop(&style_flat, LV_STYLE_TEXT_COLOR | (LV_STATE_EDITED << LV_STYLE_STATE_POS), 0x123456);
+    set_prop(&style_indexed, LV_STYLE_TEXT_COLOR | (LV_STATE_EDITED << LV_STYLE_STATE_POS), 0x123456);
+    set_prop(&style_flat, LV_STYLE_PAD_INNER | (LV_STATE_HOVERED << LV_STYLE_STATE_POS), 56);
+    set_prop(&style_indexed, LV_STYLE_PAD_INNER | (LV_STATE_HOVERED << LV_STYLE_STATE_POS), 56);
+    lv_test_assert_int_gt(indexed_size, _lv_style_get_mem_size(&style_indexed), "New properties are added");
+    lv_test_assert_true(styles_are_same(&style_flat, &style_indexed), "Same properties after setting");
+
+    lv_test_assert_true(lv_style_remove_prop(&style_indexed, LV_STYLE_BORDER_WIDTH), "Remove a property");
+    lv_test_assert_true(lv_style_remove_prop(&style_indexed, LV_STYLE_PAD_INNER | (LV_STATE_HOVERED << LV_STYLE_STATE_POS)),
+                        "Remove a property in a state");
+    lv_test_assert_true(lv_style_remove_prop(&style_indexed, LV_STYLE_VALUE_STR) == false, "Remove a missing property");
+    lv_style_remove_prop(&style_flat, LV_STYLE_BORDER_WIDTH);
+    lv_style_remove_prop(&style_flat, LV_STYLE_PAD_INNER | (LV_STATE_HOVERED << LV_STYLE_STATE_POS));
+    lv_test_assert_true(styles_are_same(&style_flat, &style_indexed), "Same properties after removing");
+
+    /*A copy of an indexed style is indexed too*/
+    static lv_style_t style_copy;
+    lv_style_init(&style_copy);
+    lv_style_copy(&style_copy, &style_indexed);
+    lv_test_assert_int_eq(_lv_style_get_mem_size(&style_indexed), _lv_style_get_mem_size(&style_copy), "Copy indexed style");
+    lv_test_assert_true(styles_are_same(&style_flat, &style_copy), "Same properties in the copy");
+    lv_style_reset(&style_copy);
+
+    /*Build a style at once*/
+    lv_style_value_t values[] = {
+        LV_STYLE_VALUE_INT(LV_STYLE_RADIUS, 5),
+        LV_STYLE_VALUE_INT(LV_STYLE_BORDER_WIDTH, 2),
+        LV_STYLE_VALUE_INT(LV_STYLE_BORDER_WIDTH | (LV_STATE_FOCUSED << LV_STYLE_STATE_POS), 4),
+        LV_STYLE_VALUE_COLOR(LV_STYLE_BG_COLOR, LV_COLOR_RED),
+        LV_STYLE_VALUE_COLOR(LV_STYLE_BG_COLOR | (LV_STATE_PRESSED << LV_STYLE_STATE_POS), LV_COLOR_BLUE),
+        LV_STYLE_VALUE_OPA(LV_STYLE_BG_OPA, LV_OPA_50),
+        LV_STYLE_VALUE_INT(LV_STYLE_PAD_TOP, 10),
+        LV_STYLE_VALUE_PTR(LV_STYLE_VALUE_STR, "text"),
+        LV_STYLE_VALUE_INT(LV_STYLE_PAD_BOTTOM, 10),
+    };
+    uint32_t value_cnt = sizeof(values) / sizeof(values[0]);
+
+    static lv_style_t style_built;
+    static lv_style_t style_set;
+    lv_style_init(&style_built);
+    lv_style_init(&style_set);
+    uint32_t i;
+    for(i = 0; i < value_cnt; i++) {
+        lv_style_property_t type = values[i].prop & 0xF;
+        if(type < LV_STYLE_ID_COLOR) _lv_style_set_int(&style_set, values[i].prop, values[i].value.num);
+        else if(type < LV_STYLE_ID_OPA) _lv_style_set_color(&style_set, values[i].prop, values[i].value.color);
+        else if(type < LV_STYLE_ID_PTR) _lv_style_set_opa(&style_set, values[i].prop, values[i].value.opa);
+        else _lv_style_set_ptr(&style_set, values[i].prop, values[i].value.ptr);
+    }
+
+#if LV_MEM_CUSTOM == 0
+    /*The properties are packed in a temporary buffer first: don't count it*/
+    _lv_mem_buf_free_all();
+    lv_mem_monitor_t mon_start;
+    lv_mem_monitor(&mon_start);
+#endif
+    lv_test_assert_true(lv_style_build(&style_built, values, value_cnt), "Build a style");
+#if LV_MEM_CUSTOM == 0
+    _lv_mem_buf_free_all();
+    lv_mem_monitor_t mon_end;
+    lv_mem_monitor(&mon_end);
+    lv_test_assert_int_eq(mon_start.used_cnt + 1, mon_end.used_cnt, "Style is built with one allocation");
+#endif
+    lv_test_assert_true(styles_are_same(&style_set, &style_built), "Built style has the same properties");
+
+    /*Building again replaces the properties*/
+    lv_style_set_text_letter_space(&style_built, LV_STATE_DEFAULT, 3);
+    lv_test_assert_true(lv_style_build(&style_built, values, value_cnt), "Build a style again");
+#if LV_MEM_CUSTOM == 0
+    _lv_mem_buf_free_all();
+    lv_mem_monitor(&mon_start);
+    lv_test_assert_int_eq(mon_end.used_cnt, mon_start.used_cnt, "Earlier map is freed");
+#endif
+    lv_test_assert_true(styles_are_same(&style_set, &style_built), "Earlier properties are removed");
+
+#if LV_STYLE_INDEX_PROP_CNT
+    /*The styles are indexed automatically when they get many properties*/
+    static lv_style_t style_auto;
+    lv_style_init(&style_auto);
+    for(i = 0; i < LV_STYLE_INDEX_PROP_CNT - 1; i++) {
+        _lv_style_set_int(&style_auto, LV_STYLE_PAD_TOP + i, i);
+    }
+    uint16_t flat_auto_size = _lv_style_get_mem_size(&style_auto);
+    lv_test_assert_int_eq((LV_STYLE_INDEX_PROP_CNT - 1) * (sizeof(lv_style_property_t) + sizeof(lv_style_int_t)) +
+                          sizeof(lv_style_property_t), flat_auto_size, "Few properties in byte map");
+    _lv_style_set_int(&style_auto, LV_STYLE_RADIUS, 1);
+    lv_test_assert_int_gt(flat_auto_size + sizeof(lv_style_property_t) + sizeof(lv_style_int_t),
+                          _lv_style_get_mem_size(&style_auto), "Style with many properties is indexed");
+    lv_style_int_t v = 0;
+    lv_test_assert_int_eq(0, _lv_style_get_int(&style_auto, LV_STYLE_PAD_TOP, &v), "Property of auto indexed style");
+    lv_test_assert_int_eq(0, v, "Value of auto indexed style");
+    lv_style_reset(&style_auto);
+#endif
+
+    lv_style_reset(&style_flat);
+    lv_style_reset(&style_indexed);
+    lv_style_reset(&style_built);
+    lv_style_reset(&style_set);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Set every third property, some of them in more states
+ */
+static void fill_style(lv_style_t * style)
+{
+    uint32_t id;
+    for(id = 0; id < ID_NUM; id += 3) {
+        set_prop(style, id, id * 11);
+        if(id % 2 == 0) set_prop(style, id | (LV_STATE_PRESSED << LV_STYLE_STATE_POS), id * 13);
+        if(id % 4 == 0) set_prop(style, id | ((LV_STATE_CHECKED | LV_STATE_FOCUSED) << LV_STYLE_STATE_POS), id * 17);
+    }
+}
+
+/**
+ * Set a property with the setter of its type
+ */
+static void set_prop(lv_style_t * style, lv_style_property_t prop, uint32_t v)
+{
+    uint8_t type = prop & 0xF;
+    if(type < LV_STYLE_ID_COLOR) _lv_style_set_int(style, prop, v);
+    else if(type < LV_STYLE_ID_OPA) _lv_style_set_color(style, prop, lv_color_hex(v));
+    else if(type < LV_STYLE_ID_PTR) _lv_style_set_opa(style, prop, v);
+    else _lv_style_set_ptr(style, prop, (const void *)((lv_uintptr_t)v + 1));
+}
+
+/**
+ * Compare every property of two styles in all states
+ */
+static bool styles_are_same(const lv_style_t * style1, const lv_style_t * style2)
+{
+    uint32_t id;
+    for(id = 0; id < ID_NUM; id++) {
+        uint32_t state;
+        for(state = 0; state <= LV_STYLE_STATE_MASK >> LV_STYLE_STATE_POS; state++) {
+            lv_style_property_t prop = id | (state << LV_STYLE_STATE_POS);
+            uint8_t type = id & 0xF;
+            int16_t w1;
+            int16_t w2;
+            bool same;
+            if(type < LV_STYLE_ID_COLOR) {
+                lv_style_int_t v1 = 0, v2 = 0;
+                w1 = _lv_style_get_int(style1, prop, &v1);
+                w2 = _lv_style_get_int(style2, prop, &v2);
+                same = v1 == v2;
+            }
+            else if(type < LV_STYLE_ID_OPA) {
+                lv_color_t v1 = LV_COLOR_BLACK, v2 = LV_COLOR_BLACK;
+                w1 = _lv_style_get_color(style1, prop, &v1);
+                w2 = _lv_style_get_color(style2, prop, &v2);
+                same = v1.full == v2.full;
+            }
+            else if(type < LV_STYLE_ID_PTR) {
+                lv_opa_t v1 = 0, v2 = 0;
+                w1 = _lv_style_get_opa(style1, prop, &v1);
+                w2 = _lv_style_get_opa(style2, prop, &v2);
+                same = v1 == v2;
+            }
+            else {
+                const void * v1 = NULL;
+                const void * v2 = NULL;
+                w1 = _lv_style_get_ptr(style1, prop, &v1);
+                w2 = _lv_style_get_ptr(style2, prop, &v2);
+                same = v1 == v2;
+            }
+
+            if(w1 != w2 || (w1 >= 0 && !same)) {
+                lv_test_print("Different property 0x%04x: weight %d, %d", prop, w1, w2);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+#if LV_STYLE_INDEX_PROP_CNT == 0
+/**
+ * Get every property of a style in a few states
+ * @return the elapsed time [us]
+ */
+static uint32_t bench(const lv_style_t * style)
+{
+    static const lv_state_t states[] = {
+        LV_STATE_DEFAULT, LV_STATE_FOCUSED, LV_STATE_PRESSED, LV_STATE_CHECKED | LV_STATE_PRESSED, LV_STATE_DISABLED
+    };
+
+    volatile int32_t sum = 0;
+    clock_t t = clock();
+    uint32_t r;
+    for(r = 0; r < BENCH_ROUNDS; r++) {
+        uint32_t id;
+        for(id = 0; id < ID_NUM; id++) {
+            uint32_t s;
+            for(s = 0; s < sizeof(states) / sizeof(states[0]); s++) {
+                lv_style_property_t prop = id | (states[s] << LV_STYLE_STATE_POS);
+                uint8_t type = id & 0xF;
+                if(type < LV_STYLE_ID_COLOR) {
+                    lv_style_int_t v = 0;
+                    sum += _lv_style_get_int(style, prop, &v) + v;
+                }
+                else if(type < LV_STYLE_ID_OPA) {
+                    lv_color_t v = LV_COLOR_BLACK;
+                    sum += _lv_style_get_color(style, prop, &v) + v.full;
+                }
+                else if(type < LV_STYLE_ID_PTR) {
+                    lv_opa_t v = 0;
+                    sum += _lv_style_get_opa(style, prop, &v) + v;
+                }
+                else {
+                    const void * v = NULL;
+                    sum += _lv_style_get_ptr(style, prop, &v) + (v != NULL);
+                }
+            }
+        }
+    }
+    t = clock() - t;
+
+    return (uint32_t)((int64_t)t * 1000000 / CLOCKS_PER_SEC);
+}
+#endif
+
+#else
+
+void lv_test_style_index(void)
+{
+
+}
+
+#endif
+#endif
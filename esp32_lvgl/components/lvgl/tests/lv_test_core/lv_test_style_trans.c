@@ -0,0 +1,270 @@
+/**
+ * @file lv_test_style_trans.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../lvgl.h"
+#if LV_BUILD_TEST
+#include "../lv_test_assert.h"
+
+#include "lv_test_style_trans.h"
+#include <time.h>
+
+#if LV_USE_ANIMATION
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TRANS_TIME      100
+#define TICK            10
+#if LV_MEM_CUSTOM
+#  define GRID_CNT      100
+#else
+#  define GRID_CNT      20      /*Fit into the small heap*/
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static lv_obj_t * obj_create(lv_coord_t x, lv_coord_t y);
+static void tick(uint32_t ms);
+static void inherited_trans(void);
+static void grid_bench(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_style_t style;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_style_trans(void)
+{
+    lv_test_print("");
+    lv_test_print("===================");
+    lv_test_print("Start lv_style_trans tests");
+    lv_test_print("===================");
+
+    /*6 properties with transition*/
+    lv_style_init(&style);
+    lv_style_set_bg_opa(&style, LV_STATE_DEFAULT, LV_OPA_COVER);
+    lv_style_set_bg_color(&style, LV_STATE_DEFAULT, LV_COLOR_RED);
+    lv_style_set_bg_color(&style, LV_STATE_PRESSED, LV_COLOR_BLUE);
+    lv_style_set_border_color(&style, LV_STATE_DEFAULT, LV_COLOR_BLACK);
+    lv_style_set_border_color(&style, LV_STATE_PRESSED, LV_COLOR_WHITE);
+    lv_style_set_border_width(&style, LV_STATE_DEFAULT, 2);
+    lv_style_set_border_width(&style, LV_STATE_PRESSED, 102);
+    lv_style_set_border_opa(&style, LV_STATE_DEFAULT, LV_OPA_50);
+    lv_style_set_border_opa(&style, LV_STATE_PRESSED, LV_OPA_COVER);
+    lv_style_set_radius(&style, LV_STATE_DEFAULT, 0);
+    lv_style_set_radius(&style, LV_STATE_PRESSED, 8);
+    lv_style_set_shadow_color(&style, LV_STATE_DEFAULT, LV_COLOR_GRAY);
+    lv_style_set_shadow_color(&style, LV_STATE_PRESSED, LV_COLOR_NAVY);
+    lv_style_set_transition_time(&style, LV_STATE_DEFAULT, TRANS_TIME);
+    lv_style_set_transition_prop_1(&style, LV_STATE_DEFAULT, LV_STYLE_BG_COLOR);
+    lv_style_set_transition_prop_2(&style, LV_STATE_DEFAULT, LV_STYLE_BORDER_COLOR);
+    lv_style_set_transition_prop_3(&style, LV_STATE_DEFAULT, LV_STYLE_BORDER_WIDTH);
+    lv_style_set_transition_prop_4(&style, LV_STATE_DEFAULT, LV_STYLE_BORDER_OPA);
+    lv_style_set_transition_prop_5(&style, LV_STATE_DEFAULT, LV_STYLE_RADIUS);
+    lv_style_set_transition_prop_6(&style, LV_STATE_DEFAULT, LV_STYLE_SHADOW_COLOR);
+
+    lv_obj_clean(lv_scr_act());
+    lv_obj_t * obj = obj_create(10, 10);
+
+    /*All properties are animated together*/
+    lv_obj_add_state(obj, LV_STATE_PRESSED);
+    lv_test_assert_int_eq(1, lv_anim_count_running(), "One animation for the transitioned properties");
+    tick(TRANS_TIME / 2);
+    lv_style_int_t border_w = lv_obj_get_style_border_width(obj, LV_OBJ_PART_MAIN);
+    lv_test_assert_int_gt(2, border_w, "Border width is animated");
+    lv_test_assert_int_lt(102, border_w, "Border width is not at the end yet");
+    lv_test_assert_int_gt(0, lv_obj_get_style_radius(obj, LV_OBJ_PART_MAIN), "Radius is animated");
+    lv_color_t c = lv_obj_get_style_bg_color(obj, LV_OBJ_PART_MAIN);
+    lv_test_assert_true(c.full != LV_COLOR_RED.full && c.full != LV_COLOR_BLUE.full, "Background color is animated");
+
+    /*The new transition continues from the current values*/
+    lv_obj_clear_state(obj, LV_STATE_PRESSED);
+    tick(TICK);
+    lv_test_assert_int_eq(1, lv_anim_count_running(), "Running transition is replaced when the new one starts");
+    lv_style_int_t border_w2 = lv_obj_get_style_border_width(obj, LV_OBJ_PART_MAIN);
+    lv_test_assert_int_lt(border_w, border_w2, "Border width goes back");
+    lv_test_assert_int_gt(border_w - 2 * 100 * TICK / TRANS_TIME, border_w2, "Border width doesn't jump");
+
+    tick(TRANS_TIME);
+    lv_test_assert_int_eq(0, lv_anim_count_running(), "Transition is ready");
+    lv_test_assert_int_eq(2, lv_obj_get_style_border_width(obj, LV_OBJ_PART_MAIN), "Border width at the end");
+    lv_test_assert_int_eq(0, lv_obj_get_style_radius(obj, LV_OBJ_PART_MAIN), "Radius at the end");
+    lv_test_assert_color_eq(LV_COLOR_RED, lv_obj_get_style_bg_color(obj, LV_OBJ_PART_MAIN), "Background color at the end");
+    lv_test_assert_color_eq(LV_COLOR_GRAY, lv_obj_get_style_shadow_color(obj, LV_OBJ_PART_MAIN), "Shadow color at the end");
+
+    /*Finishing the transitions sets the end values*/
+    lv_obj_add_state(obj, LV_STATE_PRESSED);
+    tick(TICK);
+    lv_obj_finish_transitions(obj, LV_OBJ_PART_ALL);
+    lv_test_assert_int_eq(0, lv_anim_count_running(), "Finished transition");
+    lv_test_assert_int_eq(102, lv_obj_get_style_border_width(obj, LV_OBJ_PART_MAIN), "Border width of finished transition");
+    lv_test_assert_color_eq(LV_COLOR_BLUE, lv_obj_get_style_bg_color(obj, LV_OBJ_PART_MAIN),
+                            "Background color of finished transition");
+
+    /*Deleting the object deletes its transition*/
+    lv_obj_clear_state(obj, LV_STATE_PRESSED);
+    lv_obj_del(obj);
+    lv_test_assert_int_eq(0, lv_anim_count_running(), "Transition of deleted object");
+
+    inherited_trans();
+    grid_bench();
+
+    lv_obj_clean(lv_scr_act());
+    lv_style_reset(&style);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static lv_obj_t * obj_create(lv_coord_t x, lv_coord_t y)
+{
+    lv_obj_t * obj = lv_obj_create(lv_scr_act(), NULL);
+    lv_obj_reset_style_list(obj, LV_OBJ_PART_MAIN);
+    lv_obj_add_style(obj, LV_OBJ_PART_MAIN, &style);
+    lv_obj_set_pos(obj, x, y);
+    lv_obj_set_size(obj, 10, 6);
+    return obj;
+}
+
+/**
+ * Advance the time and run the animations
+ * @param ms time to advance [ms]
+ */
+static void tick(uint32_t ms)
+{
+    uint32_t t;
+    for(t = 0; t < ms; t += TICK) {
+        lv_tick_inc(TICK);
+        lv_anim_refr_now();
+    }
+}
+
+/**
+ * The children follow the transition of a property they inherit
+ * even if other properties are in the same transition
+ */
+static void inherited_trans(void)
+{
+    static lv_style_t style_text;
+    lv_style_init(&style_text);
+    lv_style_set_text_color(&style_text, LV_STATE_DEFAULT, LV_COLOR_RED);
+    lv_style_set_text_color(&style_text, LV_STATE_PRESSED, LV_COLOR_BLUE);
+    lv_style_set_transition_time(&style_text, LV_STATE_DEFAULT, TRANS_TIME);
+    /*The inherit bit of the property doesn't fit in the positive range of `lv_style_int_t`*/
+    lv_style_set_transition_prop_1(&style_text, LV_STATE_DEFAULT, (lv_style_int_t)LV_STYLE_TEXT_COLOR);
+    lv_style_set_bg_opa(&style_text, LV_STATE_DEFAULT, LV_OPA_TRANSP);
+    lv_style_set_bg_opa(&style_text, LV_STATE_PRESSED, LV_OPA_COVER);
+    lv_style_set_transition_prop_2(&style_text, LV_STATE_DEFAULT, LV_STYLE_BG_OPA);
+
+    lv_obj_clean(lv_scr_act());
+    lv_obj_t * par = lv_obj_create(lv_scr_act(), NULL);
+    lv_obj_reset_style_list(par, LV_OBJ_PART_MAIN);
+    lv_obj_add_style(par, LV_OBJ_PART_MAIN, &style_text);
+    lv_obj_t * child = lv_obj_create(par, NULL);
+    lv_obj_reset_style_list(child, LV_OBJ_PART_MAIN);
+    lv_test_assert_color_eq(LV_COLOR_RED, lv_obj_get_style_text_color(child, LV_OBJ_PART_MAIN), "Inherited color");
+
+    lv_obj_add_state(par, LV_STATE_PRESSED);
+    tick(TRANS_TIME / 2);
+    lv_color_t c = lv_obj_get_style_text_color(child, LV_OBJ_PART_MAIN);
+    lv_test_assert_color_eq(lv_obj_get_style_text_color(par, LV_OBJ_PART_MAIN), c, "Inherited color is animated");
+    lv_test_assert_true(c.full != LV_COLOR_RED.full && c.full != LV_COLOR_BLUE.full, "Inherited color is on the way");
+    lv_opa_t opa = lv_obj_get_style_bg_opa(par, LV_OBJ_PART_MAIN);
+    lv_test_assert_true(opa != LV_OPA_TRANSP && opa != LV_OPA_COVER, "Other property is animated too");
+
+    tick(TRANS_TIME);
+    lv_test_assert_color_eq(LV_COLOR_BLUE, lv_obj_get_style_text_color(child, LV_OBJ_PART_MAIN),
+                            "Inherited color at the end");
+    lv_test_assert_int_eq(LV_OPA_COVER, lv_obj_get_style_bg_opa(par, LV_OBJ_PART_MAIN), "Other property at the end");
+
+    lv_obj_del(par);
+    lv_style_reset(&style_text);
+}
+
+/**
+ * Change the state of a grid of objects and measure the transitions
+ */
+static void grid_bench(void)
+{
+    lv_obj_clean(lv_scr_act());
+    lv_obj_t * objs[GRID_CNT];
+    uint32_t i;
+    for(i = 0; i < GRID_CNT; i++) {
+        objs[i] = obj_create((i % 10) * 12, (i / 10) * 8);
+    }
+
+    uint32_t round;
+    for(round = 0; round < 2; round++) {
+#if LV_MEM_CUSTOM == 0
+        _lv_mem_buf_free_all();
+        lv_mem_monitor_t mon_start;
+        lv_mem_monitor(&mon_start);
+#endif
+
+        for(i = 0; i < GRID_CNT; i++) {
+            lv_obj_add_state(objs[i], LV_STATE_PRESSED);
+        }
+        uint32_t anim_cnt = lv_anim_count_running();
+
+#if LV_MEM_CUSTOM == 0
+        _lv_mem_buf_free_all();
+        lv_mem_monitor_t mon_end;
+        lv_mem_monitor(&mon_end);
+        uint32_t alloc_cnt = mon_end.used_cnt - mon_start.used_cnt;
+#else
+        uint32_t alloc_cnt = 0;
+#endif
+
+        uint32_t max_time = 0;
+        uint32_t sum_time = 0;
+        uint32_t t;
+        for(t = 0; t <= TRANS_TIME; t += TICK) {
+            lv_tick_inc(TICK);
+            clock_t c = clock();
+            lv_anim_refr_now();
+            uint32_t elaps = (clock() - c) * 1000000 / CLOCKS_PER_SEC;
+            if(elaps > max_time) max_time = elaps;
+            sum_time += elaps;
+        }
+
+        lv_test_print("%d objects pressed (round %d): %d animations, %d new allocations, "
+                      "animation tick: %d us avg, %d us max", GRID_CNT, round + 1, anim_cnt, alloc_cnt,
+                      sum_time / (TRANS_TIME / TICK + 1), max_time);
+        lv_test_assert_int_eq(0, lv_anim_count_running(), "Transitions of the grid are ready");
+
+        for(i = 0; i < GRID_CNT; i++) {
+            lv_obj_clear_state(objs[i], LV_STATE_PRESSED);
+        }
+        tick(TRANS_TIME + TICK);
+    }
+}
+
+#else
+
+void lv_test_style_trans(void)
+{
+
+}
+
+#endif
+#endif
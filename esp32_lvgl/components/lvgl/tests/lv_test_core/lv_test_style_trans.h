@@ -0,0 +1,38 @@
+/**
+ * @file lv_test_style_trans.h
+ *
+ */
+
+#ifndef LV_TEST_STYLE_TRANS_H
+#define LV_TEST_STYLE_TRANS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void lv_test_style_trans(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_TEST_STYLE_TRANS_H*/
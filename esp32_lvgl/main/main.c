@@ -74,9 +74,23 @@ lv_obj_t *main_scr; //main screen
 lv_obj_t *data_scr; //display screen
 
 
-static lv_style_t header_style_label;
-static lv_style_t text_style_label;
-static lv_style_t footer_text_style;
+/* Label styles are constant: they are placed in flash and need no heap or initialization */
+static const lv_style_value_t header_style_values[] = {
+    LV_STYLE_VALUE_COLOR(LV_STYLE_TEXT_COLOR, LV_COLOR_INIT(0x00, 0x80, 0x00)), // LV_COLOR_GREEN
+    LV_STYLE_VALUE_PTR(LV_STYLE_TEXT_FONT, &lv_font_montserrat_20), // Use a larger font size
+};
+static const lv_style_value_t text_style_values[] = {
+    LV_STYLE_VALUE_COLOR(LV_STYLE_TEXT_COLOR, LV_COLOR_INIT(0x00, 0x00, 0x80)), // LV_COLOR_NAVY
+    LV_STYLE_VALUE_PTR(LV_STYLE_TEXT_FONT, &lv_font_montserrat_12),
+};
+static const lv_style_value_t footer_text_style_values[] = {
+    LV_STYLE_VALUE_COLOR(LV_STYLE_TEXT_COLOR, LV_COLOR_INIT(0x00, 0x00, 0x80)), // LV_COLOR_NAVY
+    LV_STYLE_VALUE_PTR(LV_STYLE_TEXT_FONT, &lv_font_montserrat_14),
+};
+
+static LV_STYLE_CONST_INIT(header_style_label, header_style_values);
+static LV_STYLE_CONST_INIT(text_style_label, text_style_values);
+static LV_STYLE_CONST_INIT(footer_text_style, footer_text_style_values);
 static lv_style_t led_style;
 
 /*********************
@@ -559,21 +573,9 @@ void openweather_api_http()
 void set_font_style()
 {
 
-    /* Create a style for the label */
+    /* The label styles are constant, only the LED style is created at runtime */
 
-    lv_style_init(&header_style_label);
-    lv_style_init(&text_style_label);
-    lv_style_init(&footer_text_style);
     lv_style_init(&led_style);
-
-    lv_style_set_text_color(&header_style_label, LV_STATE_DEFAULT, LV_COLOR_GREEN);
-    lv_style_set_text_font(&header_style_label, LV_STATE_DEFAULT, &lv_font_montserrat_20); // Use a larger font size
-
-    lv_style_set_text_color(&footer_text_style, LV_STATE_DEFAULT, LV_COLOR_NAVY);
-    lv_style_set_text_font(&footer_text_style, LV_STATE_DEFAULT, &lv_font_montserrat_14);
-
-    lv_style_set_text_color(&text_style_label, LV_STATE_DEFAULT, LV_COLOR_NAVY);
-    lv_style_set_text_font(&text_style_label, LV_STATE_DEFAULT, &lv_font_montserrat_12);
 }
 
 void set_main_screen()